@@ -2,6 +2,8 @@
 #include "gma/AtomicFunctions.hpp"
 #include "gma/AtomicStore.hpp"
 #include "gma/SymbolHistory.hpp"
+#include "gma/ta/IncrementalTA.hpp"
+#include "gma/util/Config.hpp"
 #include <cmath>
 
 static std::vector<gma::TickEntry> makeHistory(size_t n) {
@@ -32,4 +34,31 @@ BENCHMARK(BM_ComputeAllAtomicValues)
     ->Arg(1000)
     ->Unit(benchmark::kMicrosecond);
 
+// Per-tick cost of the incremental engine with a full window of n:
+// one push (evicting the oldest tick) plus materializing the results.
+static void BM_IncrementalTATick(benchmark::State& state) {
+    const size_t n = static_cast<size_t>(state.range(0));
+    auto hist = makeHistory(2 * n);
+    gma::util::Config cfg;
+    gma::ta::IncrementalTA engine(cfg, n);
+    for (size_t i = 0; i < n; ++i) engine.push(hist[i]);
+    gma::ta::IncrementalTA::Results out;
+
+    size_t i = n;
+    for (auto _ : state) {
+        engine.push(hist[i]);
+        engine.results(out);
+        benchmark::DoNotOptimize(out.data());
+        if (++i == hist.size()) i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_IncrementalTATick)
+    ->Arg(50)
+    ->Arg(200)
+    ->Arg(500)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_MAIN();
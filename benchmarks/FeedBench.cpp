@@ -0,0 +1,427 @@
+#include <benchmark/benchmark.h>
+#include "gma/feed/ItchAdapter.hpp"
+#include "gma/feed/ItchBinaryAdapter.hpp"
+#include "gma/market/MarketTickDecoder.hpp"
+#include "gma/server/TickArena.hpp"
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Decodes one ITCH-like session (stock directory, then adds, cancels,
+// deletes, replaces and executes over 64 symbols) per iteration: binary
+// ITCH 5.0 through ItchBinaryAdapter, and the same messages as JSON
+// through ItchAdapter. Items are messages.
+//
+// BM_TickDecode* pull the MarketFieldMap fields out of FeedServer-style
+// tick lines: alias-by-alias lookups on a DOM (the old
+// MarketTickComputer::parse), MarketTickDecoder's single pass over the
+// DOM, and its scan of the raw text, which FeedServer runs at ingress so
+// a tick nobody reads raw fields from skips the DOM. Items are ticks.
+//
+// BM_FeedPayload* turn the same lines into tick payloads the way
+// FeedServer does, 64 lines per read: an in-situ scratch parse deep-copied
+// into a document per tick (before), against parsing into a TickArena
+// that is recycled per read (after). Items are lines.
+
+using namespace gma::feed;
+
+namespace {
+
+constexpr int kSymbols  = 64;
+constexpr int kMessages = 1'000'000;
+
+struct Tape {
+    std::string              binary;   // length-prefixed, as in an ITCH file
+    std::vector<std::string> json;     // one message each
+    std::size_t              count = 0;
+};
+
+class Builder {
+public:
+    explicit Builder(Tape& t) : t_(t) {}
+
+    void put(const std::vector<uint8_t>& m, std::string json) {
+        t_.binary.push_back(static_cast<char>(m.size() >> 8));
+        t_.binary.push_back(static_cast<char>(m.size() & 0xFF));
+        t_.binary.append(m.begin(), m.end());
+        t_.json.push_back(std::move(json));
+        ++t_.count;
+    }
+
+private:
+    Tape& t_;
+};
+
+void be(std::vector<uint8_t>& m, std::size_t off, uint64_t v, int n) {
+    for (int i = n - 1; i >= 0; --i, v >>= 8) m[off + i] = static_cast<uint8_t>(v);
+}
+
+std::vector<uint8_t> header(char type, uint16_t locate, std::size_t len) {
+    std::vector<uint8_t> m(len, 0);
+    m[0] = static_cast<uint8_t>(type);
+    be(m, 1, locate, 2);
+    return m;
+}
+
+std::string ticker(int s) { return "SYM" + std::to_string(s); }
+
+template <class Fill>
+std::string json(Fill&& fill) {
+    rapidjson::StringBuffer sb;
+    rapidjson::Writer<rapidjson::StringBuffer> w(sb);
+    w.StartObject();
+    fill(w);
+    w.EndObject();
+    return sb.GetString();
+}
+
+const Tape& tape() {
+    static const Tape t = [] {
+        Tape t;
+        Builder b(t);
+        std::mt19937_64 rng(48);
+        for (int s = 0; s < kSymbols; ++s) {
+            auto m = header('R', uint16_t(s + 1), 39);
+            const std::string tk = ticker(s);
+            for (int i = 0; i < 8; ++i) m[11 + i] = i < int(tk.size()) ? tk[i] : ' ';
+            b.put(m, json([&](auto& w) {
+                w.Key("type"); w.String("stock_directory");
+                w.Key("stockLocate"); w.Int(s + 1);
+                w.Key("stock"); w.String(tk.c_str());
+            }));
+        }
+
+        struct Live { uint64_t ref; uint16_t locate; uint32_t shares; };
+        std::vector<Live> live;
+        uint64_t nextRef = 1;
+        while (t.count < std::size_t(kMessages)) {
+            const unsigned r = rng() % 100;
+            if (r < 50 || live.size() < 1000) {
+                const int s = int(rng() % kSymbols);
+                const uint16_t locate = uint16_t(s + 1);
+                const uint64_t ref = nextRef++;
+                const bool bid = rng() & 1;
+                const uint32_t shares = 100 * uint32_t(1 + rng() % 10);
+                const uint32_t price = 1'000'000 + uint32_t(rng() % 2000) * 100;
+                auto m = header('A', locate, 36);
+                be(m, 11, ref, 8);
+                m[19] = bid ? 'B' : 'S';
+                be(m, 20, shares, 4);
+                const std::string tk = ticker(s);
+                for (int i = 0; i < 8; ++i) m[24 + i] = i < int(tk.size()) ? tk[i] : ' ';
+                be(m, 32, price, 4);
+                b.put(m, json([&](auto& w) {
+                    w.Key("type"); w.String("add_order");
+                    w.Key("stock"); w.String(tk.c_str());
+                    w.Key("orderRef"); w.Uint64(ref);
+                    w.Key("side"); w.String(bid ? "B" : "S");
+                    w.Key("shares"); w.Uint(shares);
+                    w.Key("price"); w.Double(price / 1e4);
+                }));
+                live.push_back({ref, locate, shares});
+                continue;
+            }
+            // Most cancels hit recent orders; the rest sit deep and leave late.
+            const std::size_t i = (rng() % 100 < 80)
+                ? live.size() - 1 - rng() % 1000
+                : rng() % live.size();
+            Live& o = live[i];
+            if (r < 80) {                                   // delete
+                auto m = header('D', o.locate, 19);
+                be(m, 11, o.ref, 8);
+                b.put(m, json([&](auto& w) {
+                    w.Key("type"); w.String("order_delete");
+                    w.Key("orderRef"); w.Uint64(o.ref);
+                }));
+                live[i] = live.back();
+                live.pop_back();
+            } else if (r < 88) {                            // partial cancel
+                auto m = header('X', o.locate, 23);
+                be(m, 11, o.ref, 8);
+                be(m, 19, 1, 4);
+                b.put(m, json([&](auto& w) {
+                    w.Key("type"); w.String("order_cancel");
+                    w.Key("orderRef"); w.Uint64(o.ref);
+                    w.Key("shares"); w.Uint(1);
+                }));
+                o.shares -= 1;
+            } else if (r < 95) {                            // replace
+                const uint64_t ref = nextRef++;
+                const uint32_t price = 1'000'000 + uint32_t(rng() % 2000) * 100;
+                auto m = header('U', o.locate, 35);
+                be(m, 11, o.ref, 8);
+                be(m, 19, ref, 8);
+                be(m, 27, o.shares, 4);
+                be(m, 31, price, 4);
+                b.put(m, json([&](auto& w) {
+                    w.Key("type"); w.String("order_replace");
+                    w.Key("origOrderRef"); w.Uint64(o.ref);
+                    w.Key("orderRef"); w.Uint64(ref);
+                    w.Key("shares"); w.Uint(o.shares);
+                    w.Key("price"); w.Double(price / 1e4);
+                }));
+                o.ref = ref;
+            } else {                                        // full execute
+                auto m = header('E', o.locate, 31);
+                be(m, 11, o.ref, 8);
+                be(m, 19, o.shares, 4);
+                b.put(m, json([&](auto& w) {
+                    w.Key("type"); w.String("order_executed");
+                    w.Key("orderRef"); w.Uint64(o.ref);
+                    w.Key("shares"); w.Uint(o.shares);
+                }));
+                live[i] = live.back();
+                live.pop_back();
+            }
+        }
+        return t;
+    }();
+    return t;
+}
+
+} // namespace
+
+static void BM_ItchBinaryDecode(benchmark::State& state) {
+    const Tape& t = tape();
+    const auto* data = reinterpret_cast<const uint8_t*>(t.binary.data());
+    std::vector<FeedEvent> events;
+    events.reserve(8192);
+    for (auto _ : state) {
+        ItchBinaryAdapter adapter;
+        // In 64 KiB batches, as the replay ingress hands them on.
+        std::size_t pos = 0;
+        while (pos < t.binary.size()) {
+            pos += adapter.decode(data + pos, std::min<std::size_t>(64 * 1024, t.binary.size() - pos), events);
+            benchmark::DoNotOptimize(events.data());
+            events.clear();
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(t.count));
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(t.binary.size()));
+}
+BENCHMARK(BM_ItchBinaryDecode)->Unit(benchmark::kMillisecond);
+
+static void BM_ItchJsonTranslate(benchmark::State& state) {
+    const Tape& t = tape();
+    for (auto _ : state) {
+        ItchAdapter adapter;
+        for (const auto& msg : t.json) {
+            auto events = adapter.translate(msg);
+            benchmark::DoNotOptimize(events.data());
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(t.count));
+}
+BENCHMARK(BM_ItchJsonTranslate)->Unit(benchmark::kMillisecond);
+
+namespace {
+
+using gma::market::MarketFieldMap;
+using gma::market::MarketTickDecoder;
+
+MarketFieldMap tickFieldMap() {
+    MarketFieldMap fm;
+    fm.bidFields      = {"bid", "bidPrice"};
+    fm.askFields      = {"ask", "askPrice"};
+    fm.timestampField = "timestamp";
+    return fm;
+}
+
+const std::vector<std::string>& tickLines() {
+    static const std::vector<std::string> lines = [] {
+        std::vector<std::string> out;
+        std::mt19937_64 rng(50);
+        for (int i = 0; i < 4096; ++i) {
+            const double px = 100.0 + double(rng() % 10000) / 100.0;
+            out.push_back(json([&](auto& w) {
+                w.Key("symbol");     w.String(ticker(int(rng() % kSymbols)).c_str());
+                w.Key("exchange");   w.String("Q");
+                w.Key("timestamp");  w.Uint64(1'700'000'000'000'000'000ull + uint64_t(i) * 1000);
+                w.Key("lastPrice");  w.Double(px);
+                w.Key("volume");     w.Uint(100 * uint32_t(1 + rng() % 50));
+                w.Key("bid");        w.Double(px - 0.01);
+                w.Key("ask");        w.Double(px + 0.01);
+                w.Key("conditions"); w.StartArray(); w.String("@"); w.String("F"); w.EndArray();
+                w.Key("seq");        w.Uint64(uint64_t(i));
+            }));
+        }
+        return out;
+    }();
+    return lines;
+}
+
+std::vector<rapidjson::Document> tickDocs() {
+    std::vector<rapidjson::Document> docs(tickLines().size());
+    for (std::size_t i = 0; i < docs.size(); ++i) docs[i].Parse(tickLines()[i].c_str());
+    return docs;
+}
+
+// The per-alias probing MarketTickComputer::parse did before the decoder.
+bool probeAliases(const MarketFieldMap& fm, const rapidjson::Value& doc, gma::TickEntry& out) {
+    auto first = [&](const std::vector<std::string>& names, double& v) {
+        for (const auto& n : names) {
+            if (doc.HasMember(n.c_str()) && doc[n.c_str()].IsNumber()) {
+                v = doc[n.c_str()].GetDouble();
+                return true;
+            }
+        }
+        return false;
+    };
+    if (!first(fm.priceFields, out.price)) return false;
+    out.volume = out.bid = out.ask = 0.0;
+    first(fm.volumeFields, out.volume);
+    first(fm.bidFields, out.bid);
+    first(fm.askFields, out.ask);
+    out.timestampNs = 0;
+    if (doc.HasMember(fm.timestampField.c_str()) && doc[fm.timestampField.c_str()].IsUint64())
+        out.timestampNs = doc[fm.timestampField.c_str()].GetUint64();
+    return true;
+}
+
+} // namespace
+
+static void BM_TickDecodeProbeDom(benchmark::State& state) {
+    const MarketFieldMap fm = tickFieldMap();
+    const auto docs = tickDocs();
+    gma::TickEntry t{};
+    for (auto _ : state) {
+        for (const auto& d : docs) {
+            benchmark::DoNotOptimize(probeAliases(fm, d, t));
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(docs.size()));
+}
+BENCHMARK(BM_TickDecodeProbeDom);
+
+static void BM_TickDecodeDom(benchmark::State& state) {
+    const MarketTickDecoder decoder(tickFieldMap());
+    const auto docs = tickDocs();
+    gma::TickEntry t{};
+    for (auto _ : state) {
+        for (const auto& d : docs) {
+            benchmark::DoNotOptimize(decoder.decode(d, t));
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(docs.size()));
+}
+BENCHMARK(BM_TickDecodeDom);
+
+// Parse + probe against scan, both from the raw line.
+static void BM_TickParseAndProbe(benchmark::State& state) {
+    const MarketFieldMap fm = tickFieldMap();
+    const auto& lines = tickLines();
+    gma::TickEntry t{};
+    for (auto _ : state) {
+        for (const auto& l : lines) {
+            rapidjson::Document d;
+            d.Parse(l.c_str(), l.size());
+            benchmark::DoNotOptimize(probeAliases(fm, d, t));
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(lines.size()));
+}
+BENCHMARK(BM_TickParseAndProbe);
+
+static void BM_TickDecodeScan(benchmark::State& state) {
+    const MarketTickDecoder decoder(tickFieldMap());
+    const auto& lines = tickLines();
+    gma::TickEntry t{};
+    for (auto _ : state) {
+        for (const auto& l : lines) {
+            benchmark::DoNotOptimize(decoder.scan(l, t));
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(lines.size()));
+}
+BENCHMARK(BM_TickDecodeScan);
+
+namespace {
+
+constexpr std::size_t kLinesPerRead = 64;
+
+// FeedServer's copy of a scratch DOM into a payload of its own, from
+// before the arena.
+void copyOwned(rapidjson::Value& dst, const rapidjson::Value& src,
+               rapidjson::Document::AllocatorType& alloc) {
+    switch (src.GetType()) {
+        case rapidjson::kObjectType:
+            dst.SetObject();
+            for (auto m = src.MemberBegin(); m != src.MemberEnd(); ++m) {
+                rapidjson::Value name(m->name.GetString(), m->name.GetStringLength(), alloc);
+                rapidjson::Value value;
+                copyOwned(value, m->value, alloc);
+                dst.AddMember(name, value, alloc);
+            }
+            break;
+        case rapidjson::kArrayType:
+            dst.SetArray();
+            dst.Reserve(src.Size(), alloc);
+            for (const auto& e : src.GetArray()) {
+                rapidjson::Value value;
+                copyOwned(value, e, alloc);
+                dst.PushBack(value, alloc);
+            }
+            break;
+        case rapidjson::kStringType:
+            dst.SetString(src.GetString(), src.GetStringLength(), alloc);
+            break;
+        default:
+            dst.CopyFrom(src, alloc);
+            break;
+    }
+}
+
+} // namespace
+
+static void BM_FeedPayloadCopy(benchmark::State& state) {
+    using Pool = rapidjson::MemoryPoolAllocator<>;
+    using Scratch = rapidjson::GenericDocument<rapidjson::UTF8<>, Pool, Pool>;
+    static char valueBuf[16 * 1024], stackBuf[4 * 1024];
+    Pool values(valueBuf, sizeof(valueBuf)), stack(stackBuf, sizeof(stackBuf));
+    const auto& lines = tickLines();
+    std::vector<char> buf;
+    std::vector<std::shared_ptr<rapidjson::Document>> batch;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            buf.assign(lines[i].c_str(), lines[i].c_str() + lines[i].size() + 1);
+            values.Clear();
+            stack.Clear();
+            Scratch scratch(&values, sizeof(stackBuf) / 2, &stack);
+            scratch.ParseInsitu(buf.data());
+            auto doc = std::make_shared<rapidjson::Document>();
+            copyOwned(*doc, scratch, doc->GetAllocator());
+            batch.push_back(std::move(doc));
+            if (batch.size() == kLinesPerRead) batch.clear();
+        }
+        batch.clear();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(lines.size()));
+}
+BENCHMARK(BM_FeedPayloadCopy);
+
+static void BM_FeedPayloadArena(benchmark::State& state) {
+    auto arena = gma::TickArena::create();
+    const auto& lines = tickLines();
+    std::vector<std::shared_ptr<rapidjson::Document>> batch;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            arena->parse(lines[i]);
+            batch.push_back(arena->keep());
+            if (batch.size() == kLinesPerRead) {
+                batch.clear();
+                gma::TickArena::recycle(arena);
+            }
+        }
+        batch.clear();
+        gma::TickArena::recycle(arena);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(lines.size()));
+}
+BENCHMARK(BM_FeedPayloadArena);
+
+BENCHMARK_MAIN();
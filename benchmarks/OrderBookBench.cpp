@@ -0,0 +1,310 @@
+#include <benchmark/benchmark.h>
+#include "gma/book/OrderBook.hpp"
+#include "gma/book/OrderBookManager.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+// Replays an ITCH-like tape (add / delete / replace / execute near a
+// random-walking touch, with a tail of far-from-touch orders) against the
+// map-based and the tick-indexed ladders. Arg 0 = Map, 1 = Tick.
+// The add/cancel and live-order cases measure order storage; the manager
+// case adds delta detection and publication on top (the universe case
+// over many small books, full or depth-limited); the snapshot case
+// measures book recovery.
+
+using namespace gma;
+
+namespace {
+
+enum class Op : uint8_t { Add, Delete, Replace, Execute };
+
+struct Msg {
+    Op       op;
+    Side     side;
+    uint64_t id;
+    int64_t  ticks;
+    uint64_t size;
+};
+
+std::vector<Msg> makeTape(std::size_t n) {
+    std::mt19937_64 rng(42);
+    std::vector<Msg> tape;
+    tape.reserve(n);
+    std::vector<std::pair<uint64_t, Side>> live;
+    uint64_t nextId = 1;
+    int64_t mid = 1'000'000;
+
+    while (tape.size() < n) {
+        mid += static_cast<int64_t>(rng() % 3) - 1;
+        const unsigned r = rng() % 100;
+        if (r < 48 || live.size() < 1000) {
+            const Side s = (rng() & 1) ? Side::Bid : Side::Ask;
+            // Mostly within a few ticks of the touch; ~2% deep in the book.
+            const int64_t off = (rng() % 50 == 0) ? 200 + static_cast<int64_t>(rng() % 20'000)
+                                                  : static_cast<int64_t>(rng() % 8) + static_cast<int64_t>(rng() % 8);
+            const int64_t px = (s == Side::Bid) ? mid - 1 - off : mid + 1 + off;
+            tape.push_back(Msg{Op::Add, s, nextId, px, 100 * (1 + rng() % 10)});
+            live.emplace_back(nextId++, s);
+        } else {
+            const std::size_t i = rng() % live.size();
+            const auto [id, s] = live[i];
+            if (r < 88) {
+                tape.push_back(Msg{Op::Delete, s, id, 0, 0});
+                live[i] = live.back();
+                live.pop_back();
+            } else if (r < 94) {
+                const int64_t off = static_cast<int64_t>(rng() % 8);
+                tape.push_back(Msg{Op::Replace, s, id, s == Side::Bid ? mid - 1 - off : mid + 1 + off,
+                                   100 * (1 + rng() % 10)});
+            } else {
+                tape.push_back(Msg{Op::Execute, s, id, 0, 100});
+            }
+        }
+    }
+    return tape;
+}
+
+const std::vector<Msg>& tape() {
+    static const std::vector<Msg> t = makeTape(1'000'000);
+    return t;
+}
+
+LadderConfig ladderFor(const benchmark::State& state) {
+    return state.range(0) == 0 ? LadderConfig{} : LadderConfig{LadderKind::Tick, 4096};
+}
+
+inline void apply(OrderBook& ob, const Msg& m) {
+    switch (m.op) {
+    case Op::Add: {
+        Order o; o.id = m.id; o.side = m.side; o.price = Price{m.ticks}; o.size = m.size;
+        ob.applyAdd(o);
+        break;
+    }
+    case Op::Delete:  ob.applyDelete(m.id); break;
+    case Op::Replace: ob.applyUpdate(m.id, Price{m.ticks}, m.size); break;
+    case Op::Execute: {
+        // Aggressor hits the touch on the order's side.
+        auto best = (m.side == Side::Bid) ? ob.bestBid() : ob.bestAsk();
+        if (best) ob.applyTrade(*best, m.size, m.side == Side::Bid ? Aggressor::Sell : Aggressor::Buy);
+        break;
+    }
+    }
+}
+
+// Resident set size in bytes (0 where /proc is unavailable).
+std::size_t residentBytes() {
+#if defined(__linux__)
+    if (FILE* f = std::fopen("/proc/self/statm", "r")) {
+        unsigned long pages = 0, rss = 0;
+        const int got = std::fscanf(f, "%lu %lu", &pages, &rss);
+        std::fclose(f);
+        if (got == 2) return static_cast<std::size_t>(rss) * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+} // namespace
+
+static void BM_OrderBookItchFlow(benchmark::State& state) {
+    const auto& t = tape();
+    auto ob = std::make_unique<OrderBook>(ladderFor(state));
+    std::size_t i = 0;
+    for (auto _ : state) {
+        if (i == t.size()) {
+            state.PauseTiming();
+            ob = std::make_unique<OrderBook>(ladderFor(state));
+            i = 0;
+            state.ResumeTiming();
+        }
+        apply(*ob, t[i++]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_OrderBookItchFlow)->Arg(0)->Arg(1);
+
+// The same tape through OrderBookManager: sequencing, change detection and
+// top-of-book publication per message. Arg 0 = no delta subscribers,
+// 1 = one subscriber that touches every delta.
+static void BM_ManagerItchFlow(benchmark::State& state) {
+    const auto& t = tape();
+    uint64_t sink = 0;
+    auto fresh = [&] {
+        auto m = std::make_unique<OrderBookManager>();
+        m->setTickSize("S", 1.0);
+        if (state.range(0) == 1)
+            m->subscribeDeltas("S", [&sink](const BookDelta& d) { sink += d.seq + d.levels.size(); });
+        return m;
+    };
+    auto mgr = fresh();
+    const std::string sym = "S";
+    std::size_t i = 0;
+    for (auto _ : state) {
+        if (i == t.size()) {
+            state.PauseTiming();
+            mgr = fresh();
+            i = 0;
+            state.ResumeTiming();
+        }
+        const Msg& m = t[i++];
+        switch (m.op) {
+        case Op::Add:
+            mgr->onAdd(sym, m.id, m.side, static_cast<double>(m.ticks), m.size, 0);
+            break;
+        case Op::Delete:  mgr->onDelete(sym, m.id, FeedScope{}); break;
+        case Op::Replace: mgr->onUpdate(sym, m.id, FeedScope{}, static_cast<double>(m.ticks), m.size); break;
+        case Op::Execute: {
+            auto best = (m.side == Side::Bid) ? mgr->bestBid(sym) : mgr->bestAsk(sym);
+            if (best) mgr->onTrade(sym, *best, m.size, m.side == Side::Bid ? Aggressor::Sell : Aggressor::Buy);
+            break;
+        }
+        }
+    }
+    benchmark::DoNotOptimize(sink);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ManagerItchFlow)->Arg(0)->Arg(1);
+
+// The first 200k messages of the tape spread over an 8k-symbol universe
+// (an order's symbol follows its id), executes applied by id as the ITCH
+// adapter does. Arg 0 = full books, 1 = depth-limited to 10 levels.
+// Reports resident bytes per symbol at the end: in full books the tape's
+// far-from-touch orders widen every depth index.
+static void BM_ManagerUniverse(benchmark::State& state) {
+    constexpr std::size_t kSymbols = 8192;
+    const auto& t = tape();
+    std::vector<std::string> syms;
+    for (std::size_t k = 0; k < kSymbols; ++k) syms.push_back("S" + std::to_string(k));
+    const std::size_t base = residentBytes();
+    auto mgr = std::make_unique<OrderBookManager>();
+    if (state.range(0) == 1) {
+        LadderConfig limit;
+        limit.depthLimit = 10;
+        mgr->setDefaultLadder(limit);
+    }
+    for (const auto& sym : syms) mgr->setTickSize(sym, 1.0);
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const Msg& m = t[i++];
+        const std::string& sym = syms[m.id % kSymbols];
+        switch (m.op) {
+        case Op::Add:
+            mgr->onAdd(sym, m.id, m.side, static_cast<double>(m.ticks), m.size, 0);
+            break;
+        case Op::Delete:
+        case Op::Execute: mgr->onDelete(sym, m.id, FeedScope{}); break;
+        case Op::Replace: mgr->onUpdate(sym, m.id, FeedScope{}, static_cast<double>(m.ticks), m.size); break;
+        }
+    }
+    const std::size_t used = residentBytes();
+    state.counters["bytes_per_symbol"] = used > base ? double(used - base) / double(kSymbols) : 0.0;
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ManagerUniverse)->Arg(0)->Arg(1)->Iterations(200'000);
+
+// Top-of-book and top-10 depth reads on a book built from the tape.
+static void BM_OrderBookReads(benchmark::State& state) {
+    const auto& t = tape();
+    OrderBook ob(ladderFor(state));
+    for (std::size_t i = 0; i < t.size() / 2; ++i) apply(ob, t[i]);
+
+    uint64_t sink = 0;
+    for (auto _ : state) {
+        sink += ob.bestBidSize() + ob.bestAskSize();
+        ob.forEachLevel(Side::Bid, 10, [&](Price p, uint64_t sz) { sink += p.ticks + sz; });
+        ob.forEachLevel(Side::Ask, 10, [&](Price p, uint64_t sz) { sink += p.ticks + sz; });
+    }
+    benchmark::DoNotOptimize(sink);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_OrderBookReads)->Arg(0)->Arg(1);
+
+// Add then cancel one order near the touch of a book holding 100k orders:
+// pure order-storage churn.
+static void BM_OrderBookAddCancel(benchmark::State& state) {
+    OrderBook ob(ladderFor(state));
+    uint64_t id = 1;
+    for (; id <= 100'000; ++id) {
+        Order o; o.id = id; o.side = (id & 1) ? Side::Bid : Side::Ask;
+        o.price = Price{(id & 1) ? 999 - int64_t(id % 64) : 1001 + int64_t(id % 64)};
+        o.size = 100;
+        ob.applyAdd(o);
+    }
+    for (auto _ : state) {
+        Order o; o.id = id; o.side = Side::Bid; o.price = Price{999 - int64_t(id % 8)}; o.size = 100;
+        ob.applyAdd(o);
+        ob.applyDelete(id);
+        ++id;
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK(BM_OrderBookAddCancel)->Arg(0)->Arg(1);
+
+// Build a book of N live orders over ~2000 levels per side; reports add
+// throughput and resident bytes per order.
+static void BM_OrderBookLiveOrders(benchmark::State& state) {
+    const auto n = static_cast<uint64_t>(state.range(0));
+    double bytesPerOrder = 0;
+    for (auto _ : state) {
+        const std::size_t before = residentBytes();
+        auto ob = std::make_unique<OrderBook>();
+        for (uint64_t id = 1; id <= n; ++id) {
+            Order o; o.id = id; o.side = (id & 1) ? Side::Bid : Side::Ask;
+            const int64_t off = static_cast<int64_t>((id * 2654435761u) % 2000);
+            o.price = Price{(id & 1) ? 100'000 - off : 100'001 + off};
+            o.size = 100;
+            ob->applyAdd(o);
+        }
+        const std::size_t after = residentBytes();
+        bytesPerOrder = after > before ? double(after - before) / double(n) : 0.0;
+        state.PauseTiming();
+        ob.reset();
+        state.ResumeTiming();
+    }
+    state.counters["bytes_per_order"] = bytesPerOrder;
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+
+BENCHMARK(BM_OrderBookLiveOrders)->Arg(1'000'000)->Arg(10'000'000)
+    ->Iterations(1)->Unit(benchmark::kMillisecond);
+
+// Replace a live book with an N-order per-order snapshot (~2000 levels
+// per side, venue-ordered rather than price-ordered), as on recovery
+// after a gap.
+static void BM_OrderBookSnapshotLoad(benchmark::State& state) {
+    const auto n = static_cast<uint64_t>(state.range(0));
+    std::vector<Order> orders;
+    orders.reserve(n);
+    for (uint64_t id = 1; id <= n; ++id) {
+        Order o; o.id = id; o.side = (id & 1) ? Side::Bid : Side::Ask;
+        const int64_t off = static_cast<int64_t>((id * 2654435761u) % 2000);
+        o.price = Price{(id & 1) ? 100'000 - off : 100'001 + off};
+        o.size = 100;
+        orders.push_back(o);
+    }
+    OrderBook ob(state.range(1) == 0 ? LadderConfig{} : LadderConfig{LadderKind::Tick, 4096});
+    for (std::size_t i = 0; i < std::min<std::size_t>(orders.size(), 10'000); ++i) ob.applyAdd(orders[i]);
+    for (auto _ : state) {
+        ob.applySnapshotPerOrder(orders);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+
+BENCHMARK(BM_OrderBookSnapshotLoad)
+    ->ArgsProduct({{10'000, 100'000, 1'000'000}, {0, 1}})
+    ->ArgNames({"orders", "ladder"})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,6 +1,8 @@
 // Microbenchmarks for the two windowing nodes (Phase 2 / SPEC AC-5).
 // VectorReducer.onValue: vector<double> → scalar via a FunctionMap fn.
 // TumblingWindow.onValue: per-symbol scalar push into the accumulator.
+// BM_VectorReducer_Bucket: large-bucket reductions (1k–1M elements) per
+// SIMD dispatch level — see gma/util/VectorKernels.hpp.
 
 #include <benchmark/benchmark.h>
 #include "gma/FunctionMap.hpp"
@@ -10,9 +12,12 @@
 #include "gma/nodes/VectorReducer.hpp"
 #include "gma/rt/ThreadPool.hpp"
 #include "gma/StreamValue.hpp"
+#include "gma/util/VectorKernels.hpp"
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <random>
+#include <string>
 #include <vector>
 
 namespace {
@@ -74,6 +79,59 @@ static void BM_VectorReducer_Sum(benchmark::State& state) {
 }
 BENCHMARK(BM_VectorReducer_Sum);
 
+// Busy-symbol TumblingWindow buckets: one reduction over range(0) elements
+// with the kernels pinned to the ISA in range(1) (0=scalar, 1=avx2,
+// 2=avx512). The StreamValue is built once outside the timed loop — at
+// 1M elements the vector copy would otherwise swamp the reduction.
+static void runBucketBench(benchmark::State& state, const char* fnName) {
+  ensureBuiltins();
+  namespace simd = gma::util::simd;
+  const auto want = static_cast<simd::Isa>(state.range(1));
+  if (simd::forceIsa(want) != want) {
+    simd::forceIsa(simd::detectedIsa());
+    state.SkipWithError("ISA not supported on this host");
+    return;
+  }
+
+  auto sink = std::make_shared<CountingSink>();
+  auto fn   = gma::FunctionMap::instance().getFunction(fnName);
+  gma::VectorReducer vr(fn, sink);
+
+  std::mt19937_64 rng(17);
+  std::uniform_real_distribution<double> px(90.0, 110.0);
+  std::vector<double> bucket(static_cast<std::size_t>(state.range(0)));
+  for (auto& x : bucket) x = px(rng);
+  const gma::StreamValue sv{"NEXO", gma::ArgType{std::move(bucket)}};
+
+  for (auto _ : state) {
+    vr.onValue(sv);
+    benchmark::DoNotOptimize(sink->count.load());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0)
+                          * static_cast<int64_t>(sizeof(double)));
+  state.SetLabel(std::string(fnName) + "/" + simd::isaName(want));
+  simd::forceIsa(simd::detectedIsa());
+}
+
+#define GMA_BUCKET_BENCH(NAME, FN)                                        \
+  static void BM_VectorReducer_Bucket_##NAME(benchmark::State& state) {   \
+    runBucketBench(state, FN);                                            \
+  }                                                                       \
+  BENCHMARK(BM_VectorReducer_Bucket_##NAME)                               \
+    ->ArgsProduct({{1000, 10000, 100000, 1000000}, {0, 1, 2}})
+
+GMA_BUCKET_BENCH(Sum,      "sum");
+GMA_BUCKET_BENCH(Mean,     "mean");
+GMA_BUCKET_BENCH(Max,      "max");
+GMA_BUCKET_BENCH(Range,    "range");
+GMA_BUCKET_BENCH(Product,  "product");
+GMA_BUCKET_BENCH(Variance, "variance");
+GMA_BUCKET_BENCH(Stddev,   "stddev");
+GMA_BUCKET_BENCH(Zscore,   "zscore");
+
+#undef GMA_BUCKET_BENCH
+
 // ---------- TumblingWindow ----------
 
 // Steady-state onValue: after a warm-up phase that pre-grows the per-
@@ -6,15 +6,21 @@
 #include <utility>
 #include <vector>
 
+#include <condition_variable>
 #include <deque>
+#include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "gma/AtomicStore.hpp"
+#include "gma/HistoryStore.hpp"
 #include "gma/SymbolHistory.hpp"
 #include "gma/engine/IEventComputer.hpp"
 #include "gma/market/MarketFieldMap.hpp"
+#include "gma/market/MarketTickDecoder.hpp"
+#include "gma/ta/IncrementalTA.hpp"
 #include "gma/util/Config.hpp"
 
 namespace gma {
@@ -39,6 +45,24 @@ std::vector<std::pair<std::string, ArgType>> computeAllAtomicValues(
 // per dispatcher (state is not shared across dispatchers). The field-map
 // argument tells the computer which JSON keys to read for trade price /
 // volume / bid / ask / timestamp on each tick payload.
+//
+// Each symbol keeps a ta::IncrementalTA, so a tick costs O(log n) instead
+// of a computeAllAtomicValues() pass over the whole history; the values
+// are the same.
+//
+// Symbols are locked independently: ticks on unrelated symbols never wait
+// for each other, and the symbol table's own lock is only taken
+// exclusively when a new symbol appears. Each symbol's price / volume
+// window is its series in the dispatcher's HistoryStore
+// (ComputeContext::history), claimed as "lastPrice" / "volume", so a
+// direct lastPrice subscriber's FunctionMap values read the same columns.
+//
+// With cfg.taParallel and a thread pool in the ComputeContext, TA runs on
+// the pool instead of the calling feed thread: each symbol has at most one
+// task queued or running, which drains that symbol's pending ticks in
+// arrival order. Those columns would then lag the dispatcher's raw fan-out,
+// so in that mode nothing is claimed: the engine keeps private windows and
+// the dispatcher appends lastPrice / volume itself.
 class MarketTickComputer final : public engine::IEventComputer {
 public:
   // Default field-map (NASDAQ-style names) for callers that don't have a
@@ -49,17 +73,91 @@ public:
   // connector-owned MarketFieldMap into the EventComputerRegistry factory.
   MarketTickComputer(const util::Config& cfg, market::MarketFieldMap fieldMap);
 
+  // Waits for queued taParallel work that still refers to this computer.
+  ~MarketTickComputer() override;
+
   std::string_view eventType() const override { return "tick"; }
+  // Ticks carry their TickEntry in Event::decoded when the feed decoded
+  // them at ingress; the payload is only read when it is absent.
+  bool readsPayload() const override { return false; }
   void compute(const Event& e, engine::ComputeContext& ctx) override;
 
+  // Pushes every tick into its symbol's engine, taking each symbol's lock
+  // once for all of its ticks, writes every tick's values with one
+  // AtomicStore::setBatches and then notifies in arrival order. A symbol
+  // that ticks several times in the batch publishes each tick's values,
+  // the same as calling compute() once per tick.
+  void computeBatch(std::span<const Event> events, engine::ComputeContext& ctx) override;
+
 private:
-  util::Config                                       _cfg;
-  market::MarketFieldMap                             _fieldMap;
-  std::unordered_map<std::string, SymbolHistory>     _symbolHistories;
-  std::unordered_set<std::string>                    _skipFields;
-  mutable std::shared_mutex                          _histMutex;
-  std::size_t                                        _maxHistory;
-  std::size_t                                        _maxSymbols;
+  struct Sample {
+    const std::string* symbol = nullptr;
+    TickEntry          tick;
+  };
+
+  struct SymbolState {
+    SymbolState(HistoryStore::Series& s, ta::IncrementalTA engine)
+      : series(s), ta(std::move(engine)) {}
+
+    // The symbol's shared history. Its lock guards ta, whose price /
+    // volume windows are normally the series' lastPrice / volume columns.
+    HistoryStore::Series& series;
+    ta::IncrementalTA     ta;
+
+    // taParallel: ticks not yet taken by this symbol's task, and whether
+    // a task is queued or running. Guarded by queueMutex, which the feed
+    // thread holds only to append.
+    std::mutex             queueMutex;
+    std::vector<TickEntry> pending;
+    bool                   scheduled = false;
+  };
+
+  // The ingress-decoded TickEntry (Event::decoded, decoded with the same
+  // field map) if there is one, else price / volume / bid / ask /
+  // timestamp read through the field map's decoder. False when the
+  // payload has no price.
+  bool parse(const Event& tick, Sample& out) const;
+
+  // The symbol's state, created on first use with its series in
+  // `history` (claiming its lastPrice / volume columns if `claim`);
+  // nullptr once maxSymbols symbols are tracked or `history` is full.
+  SymbolState* stateFor(const std::string& symbol, HistoryStore& history, bool claim);
+
+  // Store fields for one symbol's run of ticks, oldest first: tick k's
+  // fields go to writes[slots[k]] — quote fields (bid / ask / spread /
+  // timestamp), then from taBegin[slots[k]] on the TA results right after
+  // pushing it into `st`. `st` may be null (symbol past the cap): quotes
+  // only.
+  void evaluate(SymbolState* st, std::span<const TickEntry> ticks,
+                std::span<const std::size_t> slots,
+                std::vector<std::pair<std::string, AtomicStore::FieldBatch>>& writes,
+                std::vector<std::size_t>& taBegin);
+
+  // Writes `writes` and notifies TA listeners for each entry's fields from
+  // taBegin[i] on.
+  void publish(const std::vector<std::pair<std::string, AtomicStore::FieldBatch>>& writes,
+               const std::vector<std::size_t>& taBegin,
+               engine::ComputeContext& ctx) const;
+
+  // taParallel task body: applies `st`'s pending ticks until none are left.
+  void drain(const std::string& symbol, SymbolState& st, engine::ComputeContext ctx);
+
+  util::Config                                                  _cfg;
+  market::MarketFieldMap                                        _fieldMap;
+  market::MarketTickDecoder                                     _decoder;    // from _fieldMap
+  std::unordered_map<std::string, std::unique_ptr<SymbolState>> _symbols;
+  std::unordered_set<std::string>                               _skipFields;
+  mutable std::shared_mutex                                     _symbolsMutex;   // guards _symbols
+  std::size_t                                                   _maxHistory;
+  std::size_t                                                   _maxSymbols;
+
+  // Series for calls whose ComputeContext has no shared history.
+  HistoryStore                                                  _ownHistory;
+
+  // taParallel tasks queued or running; the destructor waits for zero.
+  std::mutex              _drainMutex;
+  std::condition_variable _drainIdle;
+  std::size_t             _drainsInFlight = 0;
 };
 
 } // namespace gma
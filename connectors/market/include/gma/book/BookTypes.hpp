@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace gma {
+
+// --------- Sides / Trade aggressor ---------
+enum class Side : uint8_t { Bid = 0, Ask = 1 };
+enum class Aggressor : uint8_t { Unknown = 0, Buy = 1, Sell = 2 };
+
+// --------- Price (integer ticks) ---------
+struct Price {
+    int64_t ticks = 0;
+    friend bool operator<(const Price& a, const Price& b) noexcept { return a.ticks < b.ticks; }
+    friend bool operator>(const Price& a, const Price& b) noexcept { return a.ticks > b.ticks; }
+    friend bool operator==(const Price& a, const Price& b) noexcept { return a.ticks == b.ticks; }
+    friend bool operator!=(const Price& a, const Price& b) noexcept { return a.ticks != b.ticks; }
+};
+
+// --------- Feed scoping ---------
+struct FeedScope {
+    uint32_t feedId = 0;  // e.g., connection/venue id
+    uint32_t epoch  = 0;  // increments on session reset
+};
+
+struct OrderKey {
+    uint64_t id = 0;
+    uint32_t feedId = 0;
+    uint32_t epoch  = 0;
+    bool synthetic  = false;
+};
+struct OrderKeyHash {
+    size_t operator()(const OrderKey& k) const noexcept {
+        uint64_t a = k.id ^ (uint64_t(k.feedId) << 32) ^ uint64_t(k.epoch);
+        a ^= (k.synthetic ? 0x9E3779B97F4A7C15ULL : 0ULL);
+        a ^= a >> 33; a *= 0xff51afd7ed558ccdULL;
+        a ^= a >> 33; a *= 0xc4ceb9fe1a85ec53ULL;
+        a ^= a >> 33;
+        return size_t(a);
+    }
+};
+inline bool operator==(const OrderKey& a, const OrderKey& b) noexcept {
+    return a.id==b.id && a.feedId==b.feedId && a.epoch==b.epoch && a.synthetic==b.synthetic;
+}
+
+// --------- Per-order structures ---------
+struct Order {
+    uint64_t id = 0;
+    Side     side = Side::Bid;
+    Price    price{};
+    uint64_t size = 0;
+    uint64_t priority = 0;  // recv seq or venue ts
+
+    // D4 scope carried with the order
+    uint32_t feedId = 0;
+    uint32_t epoch  = 0;
+    bool synthetic  = false;
+};
+
+} // namespace gma
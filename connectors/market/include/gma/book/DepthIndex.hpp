@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace gma {
+
+// Totals over a set of price levels. Prices are in ticks: `ticks` sums
+// the level prices, `notional` sums price * size.
+struct DepthSums {
+    uint64_t levels = 0;
+    uint64_t orders = 0;
+    uint64_t size = 0;
+    int64_t  ticks = 0;
+    int64_t  notional = 0;
+};
+
+// --------- DepthIndex ---------
+// Fenwick tree over one side of a book, indexed by tick offset from a
+// base, holding level count, order count, size, price and notional per
+// occupied tick. The owner reports each level's state after it changes
+// (set()); cumulative depth, rank ranges and price bands then come back
+// in O(log window) without walking the ladder.
+//
+// The window grows (power of two, up to MAX_WINDOW) to cover the live
+// levels. Beyond that, a price on the better side of the window
+// re-centres it near the new best and the worst levels spill into a
+// sorted overflow map; a price on the worse side goes to the overflow
+// directly. Overflow levels are summed by walking the map, so queries
+// stay exact whatever the spread of prices.
+class DepthIndex {
+public:
+    // `descending`: the best level has the highest price (bids).
+    explicit DepthIndex(bool descending) : descending_(descending) {}
+
+    // State of the level at `ticks` after a mutation; orders == 0 removes it.
+    void set(int64_t ticks, uint64_t size, uint32_t orders);
+    void clear();
+
+    std::size_t levels() const noexcept { return levels_; }
+
+    // Levels ranked first..last best-first (1-based, inclusive, clamped).
+    DepthSums ranks(std::size_t first, std::size_t last) const;
+    // Best n levels.
+    DepthSums top(std::size_t n) const { return ranks(1, n); }
+    // Levels priced in [lo, hi] ticks, inclusive.
+    DepthSums band(int64_t lo, int64_t hi) const;
+
+    // Introspection (tests / diagnostics)
+    int64_t     base()         const noexcept { return base_; }
+    std::size_t window()       const noexcept { return raw_.size(); }
+    std::size_t overflowSize() const noexcept { return overflow_.size(); }
+
+    static constexpr std::size_t INITIAL_WINDOW = 256;
+    static constexpr std::size_t MAX_WINDOW     = std::size_t{1} << 16;
+
+private:
+    struct Level {
+        uint64_t size = 0;
+        uint32_t orders = 0;
+    };
+    // Fenwick node; modular uint64 so removals cancel exactly.
+    struct Node {
+        uint64_t levels = 0, orders = 0, size = 0, ticks = 0, notional = 0;
+    };
+
+    bool inWindow(int64_t t) const noexcept {
+        return !raw_.empty() && t >= base_ && t - base_ < static_cast<int64_t>(raw_.size());
+    }
+
+    void add(std::size_t slot, int64_t t, const Level& from, const Level& to);
+    void place(int64_t t, const Level& lvl);
+    void rebuild(int64_t base, std::size_t cap);
+
+    // Ascending (lowest price first) over window and overflow.
+    DepthSums lowest(std::size_t k) const;
+    DepthSums atOrBelow(int64_t t) const;
+    DepthSums windowLowest(std::size_t k, std::size_t* lastSlot = nullptr) const;
+    DepthSums windowAtOrBelow(std::size_t slots) const;
+
+    static void accumulate(DepthSums& s, const Node& n) noexcept;
+    static void accumulate(DepthSums& s, int64_t t, const Level& l) noexcept;
+    static void accumulate(DepthSums& s, const DepthSums& b) noexcept;
+    static DepthSums minus(const DepthSums& a, const DepthSums& b) noexcept;
+
+    std::vector<Node>  tree_;            // 1-based; tree_[0] unused
+    std::vector<Level> raw_;             // per slot
+    std::map<int64_t, Level> overflow_;  // levels outside the window
+    int64_t     base_ = 0;
+    std::size_t windowLevels_ = 0;
+    std::size_t levels_ = 0;
+    bool        descending_;
+};
+
+} // namespace gma
@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "gma/book/DepthTypes.hpp"
+
+namespace gma {
+
+class OrderBookManager;
+
+// --------- Wire frame ---------
+// One binary frame of a depth stream. A snapshot carries the client's
+// whole view (top N per side); a delta carries only levels whose size
+// changed since the previous frame, size 0 meaning the level left the
+// view. Levels are best-first per side, prices in ticks.
+//
+// Encoding (unsigned LEB128 varints, zigzag for signed):
+//   u8      type              1 = snapshot, 2 = delta
+//   varint  streamId
+//   varint  seq               book sequence this frame brings the client to
+//   varint  prevSeq           seq of the previous frame (0 on a snapshot)
+//   snapshot only:
+//     varint epoch
+//     f64     tick size (little-endian IEEE-754)
+//   varint  bid count, then per level: zigzag(price - previous price), size
+//   varint  ask count, same
+// A delta whose prevSeq is not the seq of the last frame received means the
+// client missed something and should cancel and resubscribe.
+struct DepthFrame {
+    enum class Type : uint8_t { Snapshot = 1, Delta = 2 };
+
+    Type     type = Type::Snapshot;
+    uint32_t streamId = 0;
+    uint64_t seq = 0;
+    uint64_t prevSeq = 0;
+    uint32_t epoch = 0;   // snapshot only
+    double   tick = 0.0;  // snapshot only
+    std::vector<std::pair<Price, uint64_t>> bids;
+    std::vector<std::pair<Price, uint64_t>> asks;
+};
+
+void encodeDepthFrame(const DepthFrame& f, std::string& out);
+std::string encodeDepthFrame(const DepthFrame& f);
+// nullopt on a truncated or malformed frame.
+std::optional<DepthFrame> decodeDepthFrame(std::string_view bytes);
+
+// --------- DepthStreamer ---------
+// Keeps one client's top-N ladder for a symbol in step with the book.
+// Book deltas only mark the stream dirty (when they touch the client's
+// view); flush() then diffs the current top N against what the client
+// last accepted and sends the changes as one frame, so any number of
+// book updates between flushes cost a single, bounded frame.
+//
+// A full snapshot is sent first, and again whenever the delta sequence
+// has a gap, the book was replaced by a feed snapshot, or the feed epoch
+// moved. If the sink refuses a frame nothing is committed: the next
+// flush diffs against the same baseline, so no change is ever lost.
+class DepthStreamer : public std::enable_shared_from_this<DepthStreamer> {
+public:
+    using Sink = std::function<bool(std::string frame)>;
+
+    // nullptr if `books` has no such symbol (see subscribeDeltas).
+    static std::shared_ptr<DepthStreamer> create(std::shared_ptr<OrderBookManager> books,
+                                                 std::string symbol,
+                                                 uint32_t streamId,
+                                                 std::size_t levels,
+                                                 Sink sink);
+    ~DepthStreamer();
+
+    DepthStreamer(const DepthStreamer&) = delete;
+    DepthStreamer& operator=(const DepthStreamer&) = delete;
+
+    // Send the pending change, if any. Returns true if a frame went out.
+    bool flush();
+    // Unsubscribe from the book; later flushes are no-ops.
+    void stop();
+
+    std::size_t levels() const noexcept { return levels_; }
+    uint64_t framesSent()  const noexcept { return framesSent_.load(std::memory_order_relaxed); }
+    uint64_t resnapshots() const noexcept { return resnapshots_.load(std::memory_order_relaxed); }
+
+private:
+    DepthStreamer(std::shared_ptr<OrderBookManager> books, std::string symbol,
+                  uint32_t streamId, std::size_t levels, Sink sink);
+
+    void onDelta(const BookDelta& d);
+    bool inView(Side side, Price p) const;   // mx_ held
+
+    using Ladder = std::vector<std::pair<Price, uint64_t>>;
+    static void diff(const Ladder& from, const Ladder& to, bool descending, Ladder& out);
+
+    std::shared_ptr<OrderBookManager> books_;
+    const std::string symbol_;
+    const uint32_t    streamId_;
+    const std::size_t levels_;
+    Sink              sink_;
+    uint64_t          subId_ = 0;
+
+    mutable std::mutex mx_;
+    bool     stopped_ = false;
+    bool     dirty_ = true;
+    bool     resync_ = true;
+    uint64_t deltaSeq_ = 0;   // highest book delta seq accounted for
+    uint64_t sentSeq_ = 0;
+    uint32_t sentEpoch_ = 0;
+    Ladder   sentBids_, sentAsks_;   // the client's view
+
+    std::atomic<uint64_t> framesSent_{0};
+    std::atomic<uint64_t> resnapshots_{0};
+};
+
+} // namespace gma
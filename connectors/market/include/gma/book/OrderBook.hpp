@@ -1,7 +1,6 @@
 #pragma once
 #include <cstdint>
 #include <map>
-#include <list>
 #include <optional>
 #include <unordered_map>
 #include <mutex>
@@ -9,64 +8,21 @@
 #include <vector>
 #include <functional>
 
-namespace gma {
-
-// --------- Sides / Trade aggressor ---------
-enum class Side : uint8_t { Bid = 0, Ask = 1 };
-enum class Aggressor : uint8_t { Unknown = 0, Buy = 1, Sell = 2 };
-
-// --------- Price (integer ticks) ---------
-struct Price {
-    int64_t ticks = 0;
-    friend bool operator<(const Price& a, const Price& b) noexcept { return a.ticks < b.ticks; }
-    friend bool operator>(const Price& a, const Price& b) noexcept { return a.ticks > b.ticks; }
-    friend bool operator==(const Price& a, const Price& b) noexcept { return a.ticks == b.ticks; }
-    friend bool operator!=(const Price& a, const Price& b) noexcept { return a.ticks != b.ticks; }
-};
+#include "gma/book/BookTypes.hpp"
+#include "gma/book/DepthIndex.hpp"
+#include "gma/book/OrderPool.hpp"
+#include "gma/book/PriceLadder.hpp"
 
-// --------- Feed scoping ---------
-struct FeedScope {
-    uint32_t feedId = 0;  // e.g., connection/venue id
-    uint32_t epoch  = 0;  // increments on session reset
-};
-
-struct OrderKey {
-    uint64_t id = 0;
-    uint32_t feedId = 0;
-    uint32_t epoch  = 0;
-    bool synthetic  = false;
-};
-struct OrderKeyHash {
-    size_t operator()(const OrderKey& k) const noexcept {
-        uint64_t a = k.id ^ (uint64_t(k.feedId) << 32) ^ uint64_t(k.epoch);
-        a ^= (k.synthetic ? 0x9E3779B97F4A7C15ULL : 0ULL);
-        a ^= a >> 33; a *= 0xff51afd7ed558ccdULL;
-        a ^= a >> 33; a *= 0xc4ceb9fe1a85ec53ULL;
-        a ^= a >> 33;
-        return size_t(a);
-    }
-};
-inline bool operator==(const OrderKey& a, const OrderKey& b) noexcept {
-    return a.id==b.id && a.feedId==b.feedId && a.epoch==b.epoch && a.synthetic==b.synthetic;
-}
-
-// --------- Per-order structures ---------
-struct Order {
-    uint64_t id = 0;
-    Side     side = Side::Bid;
-    Price    price{};
-    uint64_t size = 0;
-    uint64_t priority = 0;  // recv seq or venue ts
-
-    // D4 scope carried with the order
-    uint32_t feedId = 0;
-    uint32_t epoch  = 0;
-    bool synthetic  = false;
-};
+namespace gma {
 
+// Per-order level: FIFO of OrderPool records linked through prev/next.
 struct PriceLevel {
-    std::list<Order> orders;   // stable iterators
+    uint32_t head = kNoOrder;  // oldest (front of queue)
+    uint32_t tail = kNoOrder;
+    uint32_t count = 0;
     uint64_t totalSize = 0;    // sum of order sizes in this level
+
+    bool empty() const noexcept { return head == kNoOrder; }
 };
 
 // --------- Aggregated (level-only) structures ---------
@@ -82,9 +38,45 @@ struct LevelSnapshotEntry {
     std::optional<uint32_t> orderCount;
 };
 
+// One per-order level touched by a mutation: its total before the first
+// touch and after the last (0 = no level).
+struct LevelChange {
+    Side side;
+    int64_t ticks;
+    uint64_t before;
+    uint64_t after;
+};
+
+// Best level per side of the per-order ladders, read under one lock.
+struct BookTop {
+    std::optional<Price> bid, ask;
+    uint64_t bidSize = 0, askSize = 0;
+};
+
 // --------- OrderBook ---------
 class OrderBook {
 public:
+    // Ladder storage is fixed per book (see LadderConfig); both kinds
+    // behave identically.
+    // `hugePages` backs the order pool with huge-page slabs (OrderPool).
+    //
+    // With LadderConfig::depthLimit set the book is depth-limited: each
+    // side holds only its best levels in a TopLadder (at least depthLimit
+    // of them, exact), and orders keep just key, side, price and size so
+    // executes, cancels and replaces by id still apply. There is no queue
+    // position, so applyTrade (which fills the front of a level) does
+    // nothing, and level, depth and invariant queries see the held levels
+    // only. Aggregated (level-summary) input is unaffected.
+    explicit OrderBook(const LadderConfig& ladder = {}, bool hugePages = false);
+
+    LadderKind  ladderKind() const noexcept { return bids_.kind(); }
+    std::size_t depthLimit() const noexcept { return cfg_.depthLimit; }
+
+    // Live resting orders, and bytes held by the order pool and its index
+    // (slabs are kept after orders leave).
+    size_t orderCount() const;
+    size_t orderMemoryBytes() const;
+
     // Base API (tick-priced)
     bool applyAdd(const Order& o);
     bool applyUpdate(uint64_t id,
@@ -102,7 +94,11 @@ public:
     // Trades
     bool applyTrade(Price tradePrice, uint64_t size, Aggressor aggr = Aggressor::Unknown);
 
-    // Snapshots / summaries
+    // Snapshots / summaries. Snapshots are built off to the side in one
+    // pass over the input sorted best-first, then swapped in under the
+    // lock: readers see the old book or the new one, never a partial
+    // load. Within a level, orders keep their input order; a repeated
+    // key keeps its last occurrence, as repeated adds would.
     void applySnapshotPerOrder(const std::vector<Order>& orders);
     void applySnapshotAggregated(const std::vector<LevelSnapshotEntry>& levels);
     bool applyLevelSummary(Side side, Price price, uint64_t totalSize,
@@ -118,9 +114,18 @@ public:
     uint64_t bestBidSize() const;
     uint64_t bestAskSize() const;
 
+    BookTop top() const;
+
     // Level size (per-order)
     uint64_t levelSize(Side s, Price price) const;
 
+    // Change log: when set, every per-order level a mutation touches is
+    // recorded in `log` (one entry per level, merged across the
+    // mutation). The caller owns and clears it, and must serialize reads
+    // of it with mutations. Snapshot rebuilds are not logged. nullptr
+    // turns logging off.
+    void setChangeLog(std::vector<LevelChange>* log);
+
     // Aggregated queries
     std::optional<Price> bestBidAggregated() const;
     std::optional<Price> bestAskAggregated() const;
@@ -130,6 +135,13 @@ public:
     void forEachLevel(Side side, size_t n,
                       const std::function<void(Price, uint64_t)>& fn) const;
 
+    // Depth reductions (per-order ladder) from the side's DepthIndex:
+    // levels ranked first..last best-first (1-based, inclusive) or priced
+    // in [lo, hi]. No ladder walk.
+    size_t    levelCount(Side side) const;
+    DepthSums depthByRank(Side side, size_t first, size_t last) const;
+    DepthSums depthByPrice(Side side, Price lo, Price hi) const;
+
     // Invariants
     bool checkInvariants(std::string* whyNot = nullptr) const;
 
@@ -140,39 +152,74 @@ public:
     bool locate(const OrderKey& key, Side& outSide, Price& outPrice) const;
 
 private:
-    // Ladders keyed by Price (ticks)
-    struct GreaterP { bool operator()(const Price& a, const Price& b) const noexcept { return a.ticks > b.ticks; } };
-    struct LessP    { bool operator()(const Price& a, const Price& b) const noexcept { return a.ticks < b.ticks; } };
-    using BidLadder = std::map<Price, PriceLevel, GreaterP>;
-    using AskLadder = std::map<Price, PriceLevel, LessP>;
-    BidLadder bids_;
-    AskLadder asks_;
-
-    using BidAgg = std::map<Price, LevelAgg, GreaterP>;
-    using AskAgg = std::map<Price, LevelAgg, LessP>;
-    BidAgg bidsAgg_;
-    AskAgg asksAgg_;
-
-    struct Locator {
-        Side side;
-        Price price;
-        std::list<Order>::iterator it;
-    };
-    std::unordered_map<OrderKey, Locator, OrderKeyHash> byId_;
+    LadderConfig cfg_;
+
+    // Ladders keyed by Price (ticks); bids best-first descending
+    PriceLadder<PriceLevel> bids_;
+    PriceLadder<PriceLevel> asks_;
+
+    PriceLadder<LevelAgg> bidsAgg_;
+    PriceLadder<LevelAgg> asksAgg_;
+
+    PriceLadder<PriceLevel>&       ladder(Side s)       { return s == Side::Bid ? bids_ : asks_; }
+    const PriceLadder<PriceLevel>& ladder(Side s) const { return s == Side::Bid ? bids_ : asks_; }
+    // Running sums over bids_/asks_, kept in step by linkBack/unlink and
+    // in-place size changes.
+    DepthIndex bidDepth_;
+    DepthIndex askDepth_;
+    DepthIndex&       depth(Side s)       { return s == Side::Bid ? bidDepth_ : askDepth_; }
+    const DepthIndex& depth(Side s) const { return s == Side::Bid ? bidDepth_ : askDepth_; }
+
+    PriceLadder<LevelAgg>&         aggLadder(Side s)       { return s == Side::Bid ? bidsAgg_ : asksAgg_; }
+    const PriceLadder<LevelAgg>&   aggLadder(Side s) const { return s == Side::Bid ? bidsAgg_ : asksAgg_; }
+
+    // Depth-limited books keep their levels here instead of bids_/asks_
+    // and the depth indexes, which stay empty.
+    TopLadder bidBand_;
+    TopLadder askBand_;
+    TopLadder&       band(Side s)       { return s == Side::Bid ? bidBand_ : askBand_; }
+    const TopLadder& band(Side s) const { return s == Side::Bid ? bidBand_ : askBand_; }
+    bool limited() const noexcept { return cfg_.depthLimit > 0; }
+
+    // Resting orders and their id index
+    OrderPool  pool_;
+    OrderIndex byId_;
 
     mutable std::mutex m_;
 
+    std::vector<LevelChange>* log_ = nullptr;
+
 private:
     // Per-order helpers (expect m_ held)
     PriceLevel& getOrCreateLevel(Side s, Price price);
     PriceLevel* findLevel(Side s, Price price);
     void eraseLevelIfEmpty(Side s, Price price);
+    void syncDepth(Side s, int64_t ticks, uint64_t before, const PriceLevel& lvl) {
+        depth(s).set(ticks, lvl.totalSize, lvl.count);
+        if (log_) noteLevel(s, ticks, before, lvl.totalSize);
+    }
+    void noteLevel(Side s, int64_t ticks, uint64_t before, uint64_t after);
+
+    // Depth-limited helpers (expect m_ held)
+    void bandAdd(Side s, int64_t ticks, uint64_t size);
+    void bandRemove(Side s, int64_t ticks, uint64_t size);
+    void bandResize(Side s, int64_t ticks, uint64_t from, uint64_t to);
+    void bandRefill(Side s);
+    DepthSums bandSums(Side s, size_t first, size_t last, int64_t lo, int64_t hi) const;
 
     // Aggregated helpers (expect m_ held)
     LevelAgg& getOrCreateAggLevel(Side s, Price price);
     LevelAgg* findAggLevel(Side s, Price price);
     void eraseAggLevelIfEmpty(Side s, Price price);
 
+    // FIFO links (expect m_ held)
+    void linkBack(PriceLevel& lvl, uint32_t i);
+    void unlink(PriceLevel& lvl, uint32_t i);
+    // Same, without depth index or change log upkeep (bulk loads)
+    void linkQuiet(PriceLevel& lvl, uint32_t i);
+    void unlinkQuiet(PriceLevel& lvl, uint32_t i);
+    void releaseOrder(uint32_t i, const OrderKey& key);
+
     // Consume helper (expect m_ held)
     uint64_t consumeAtLevel(Side passive, Price price, uint64_t qty);
 
@@ -188,11 +235,14 @@ private:
                     std::optional<Price> newPrice,
                     std::optional<uint64_t> newSize);
     bool deleteImpl(const OrderKey& key);
+    bool updateBand(uint32_t i, const OrderKey& key,
+                    std::optional<Price> newPrice,
+                    std::optional<uint64_t> newSize);
     bool priorityImpl(const OrderKey& key, uint64_t newPriority);
 
-    // Clearers (expect m_ held)
-    void clearPerOrderUnlocked();
-    void clearAggregatedUnlocked();
+    // Bulk snapshot build into a book no one else sees yet (no lock).
+    void loadPerOrder(const std::vector<Order>& orders);
+    void loadAggregated(const std::vector<LevelSnapshotEntry>& levels);
 
     // Synthetic ID counters
     std::unordered_map<uint64_t, uint64_t> synthCounters_;
@@ -1,29 +1,48 @@
 #pragma once
 #include "gma/book/OrderBook.hpp"
 #include "gma/book/DepthTypes.hpp"
+#include "gma/book/RefTable.hpp"
 #include "gma/util/Metrics.hpp"
 #include <unordered_map>
 #include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <optional>
-#include <list>
 #include <functional>
 #include <mutex>
 #include <sstream>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 namespace gma {
 
 // Manager: sequencing, gap/stale control, tick quantization,
 // event bus for deltas, venue-key resolver, validation & admin.
+//
+// State is kept per symbol (book, feed state, resolver, subscribers) and
+// spread over hash shards, so feeds on different symbols apply in
+// parallel. Top-of-book queries read a published copy without locking.
 
 class OrderBookManager {
 public:
+    explicit OrderBookManager(size_t shards = 64);
+
     // ---- Tick-size configuration ----
     void   setTickSize(const std::string& symbol, double tickSize);
     double getTickSize(const std::string& symbol) const;
     Price  toTicks(const std::string& symbol, double px) const;
     double toDouble(const std::string& symbol, Price p) const;
 
+    // ---- Ladder storage (see LadderConfig) ----
+    // Applies to books created afterwards, i.e. set it before a symbol's
+    // first message. Symbols without an entry use the default.
+    void setLadder(const std::string& symbol, const LadderConfig& cfg);
+    void setDefaultLadder(const LadderConfig& cfg);
+    LadderKind ladderKind(const std::string& symbol) const;
+    // Back new books' order pools with huge-page slabs (see OrderPool).
+    void setHugePages(bool on);
+
     // ---- Feed state / epoch / sequencing ----
     struct FeedState {
         uint64_t lastSeq = 0;      // 0 means "unset"
@@ -87,11 +106,28 @@ public:
     void depthN(const std::string& symbol, size_t n,
                 std::vector<std::pair<double,uint64_t>>& bids,
                 std::vector<std::pair<double,uint64_t>>& asks) const;
+    // Depth reductions from the book's DepthIndex, without a snapshot:
+    // levels ranked first..last best-first (1-based, inclusive), or priced
+    // in [lo, hi] (inclusive; ends snap inward to the tick grid). Sums are
+    // in ticks (DepthSums).
+    DepthSums depthByRank(const std::string& symbol, Side side, size_t first, size_t last) const;
+    DepthSums depthByPrice(const std::string& symbol, Side side, double lo, double hi) const;
+    // Bumped on every change to the symbol's book or feed epoch/staleness
+    // (0 = never touched). Two equal reads bracket an unchanged book.
+    uint64_t bookVersion(const std::string& symbol) const;
 
     // ---------- D8: Event bus + builders ----------
     using DeltaHandler = std::function<void(const BookDelta&)>;
+    // Returns 0, subscribing nothing, for a symbol the manager has no
+    // state for yet.
     uint64_t subscribeDeltas(const std::string& symbol, DeltaHandler handler);
     void     unsubscribeDeltas(const std::string& symbol, uint64_t subId);
+    // Called with a symbol right after the manager first creates state for
+    // it, before the call that created it touches the book, and with no
+    // manager lock held, so a handler may subscribeDeltas from it.
+    using SymbolHandler = std::function<void(const std::string& symbol)>;
+    uint64_t subscribeSymbols(SymbolHandler handler);
+    void     unsubscribeSymbols(uint64_t subId);
     DepthSnapshot buildSnapshot(const std::string& symbol, size_t levels) const;
 
     // ---- Admin / Observability (D10) ----
@@ -100,70 +136,175 @@ public:
     std::string dumpLadder(const std::string& symbol, size_t maxLevelsPerSide = 50) const;
 
 private:
-    // Books & ticks
-    std::unordered_map<std::string, OrderBook> books_;
-    mutable std::shared_mutex booksMx_;
-    std::unordered_map<std::string, double> tickSize_;
     static constexpr double kDefaultTick = 1e-4;
-    OrderBook& getOrCreateBook_(const std::string& symbol);
-    const OrderBook* findBook_(const std::string& symbol) const;
-
-    // Feed state
-    mutable std::mutex feedMx_;
-    std::unordered_map<std::string, FeedState> feed_;
-    bool gate_(const std::string& symbol) const;
-
-    // Resolver (LRU per symbol)
-    struct Lru {
-        size_t cap = 4096;
-        std::list<std::pair<std::string, OrderKey>> dq; // MRU at front
-        std::unordered_map<std::string, std::list<std::pair<std::string, OrderKey>>::iterator> idx;
-        void setCap(size_t c) { cap = c ? c : 1; trim(); }
-        void put(const std::string& k, const OrderKey& v) {
-            auto it = idx.find(k);
-            if (it != idx.end()) { it->second->second = v; dq.splice(dq.begin(), dq, it->second); return; }
-            dq.emplace_front(k, v); idx[k] = dq.begin(); trim();
+
+    // Resolver (LRU per symbol). Entries sit in one arena, linked MRU
+    // first, and are found through a RefTable keyed by a 64-bit hash of
+    // the venue key. Key bytes share one buffer and every hit is checked
+    // against them, so a hash collision costs a miss, never a wrong order.
+    class Lru {
+    public:
+        void setCap(size_t c) { cap_ = c ? c : 1; trim(); }
+        void put(std::string_view k, const OrderKey& v);
+        std::optional<OrderKey> cget(std::string_view k) const;
+        size_t size() const noexcept { return idx_.size(); }
+
+    private:
+        struct Entry {
+            OrderKey key;
+            uint64_t hash = 0;
+            uint32_t off = 0, len = 0;          // bytes in keys_
+            uint32_t prev = kNoOrder, next = kNoOrder;
+        };
+        static uint64_t hashOf(std::string_view k) noexcept;
+        std::string_view keyOf(const Entry& e) const noexcept { return std::string_view(keys_).substr(e.off, e.len); }
+        void unlink(uint32_t i) noexcept;
+        void pushFront(uint32_t i) noexcept;
+        void drop(uint32_t i);
+        void trim();
+        void compactKeys();
+
+        size_t cap_ = 4096;
+        std::vector<Entry> arena_;
+        RefTable<uint32_t> idx_;               // hash -> arena index
+        std::string keys_;
+        size_t   garbage_ = 0;                 // bytes of dropped keys in keys_
+        uint32_t head_ = kNoOrder, tail_ = kNoOrder, free_ = kNoOrder;
+    };
+
+    // Top of book published after every mutation. Single writer (the
+    // thread holding the symbol's mx); readers retry while `seq` is odd
+    // or moved underneath them.
+    struct TopOfBook {
+        std::atomic<uint64_t> seq{0};
+        std::atomic<int64_t>  bid{0}, ask{0};
+        std::atomic<uint64_t> bidSize{0}, askSize{0};
+        std::atomic<bool>     hasBid{false}, hasAsk{false};
+
+        struct View {
+            bool     hasBid = false, hasAsk = false;
+            int64_t  bid = 0, ask = 0;
+            uint64_t bidSize = 0, askSize = 0;
+        };
+        void store(const View& v) {
+            const uint64_t s = seq.load(std::memory_order_relaxed);
+            seq.store(s + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            hasBid.store(v.hasBid, std::memory_order_relaxed);
+            hasAsk.store(v.hasAsk, std::memory_order_relaxed);
+            bid.store(v.bid, std::memory_order_relaxed);
+            ask.store(v.ask, std::memory_order_relaxed);
+            bidSize.store(v.bidSize, std::memory_order_relaxed);
+            askSize.store(v.askSize, std::memory_order_relaxed);
+            seq.store(s + 2, std::memory_order_release);
         }
-        std::optional<OrderKey> cget(const std::string& k) const {
-            auto it = idx.find(k); if (it == idx.end()) return std::nullopt; return it->second->second;
+        View load() const {
+            for (;;) {
+                const uint64_t s = seq.load(std::memory_order_acquire);
+                if (s & 1) continue;
+                View v;
+                v.hasBid  = hasBid.load(std::memory_order_relaxed);
+                v.hasAsk  = hasAsk.load(std::memory_order_relaxed);
+                v.bid     = bid.load(std::memory_order_relaxed);
+                v.ask     = ask.load(std::memory_order_relaxed);
+                v.bidSize = bidSize.load(std::memory_order_relaxed);
+                v.askSize = askSize.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq.load(std::memory_order_relaxed) == s) return v;
+            }
         }
-        void trim() { while (dq.size() > cap) { auto it = std::prev(dq.end()); idx.erase(it->first); dq.pop_back(); } }
     };
-    mutable std::mutex resolverMx_;
-    mutable std::unordered_map<std::string, Lru> resolver_;
 
-    // Event bus
-    std::unordered_map<std::string, std::unordered_map<uint64_t, DeltaHandler>> subs_; // symbol -> (id->handler)
-    mutable std::mutex subsMx_;
-    uint64_t nextSubId_ = 1;
-    std::unordered_map<std::string, uint64_t> pubSeq_; // per-symbol publication seq
-    OrderBook& book(const std::string& symbol); 
+    // Delta subscribers, replaced wholesale on (un)subscribe so a publish
+    // only takes a reference to the current list.
+    using SubList = std::vector<std::pair<uint64_t, DeltaHandler>>;
+
+    // Everything that belongs to one symbol. `mx` serializes mutations
+    // and guards feed, resolver, subs, pubSeq and changes; the book has
+    // its own lock for readers, and tickSize/tob/version are read
+    // lock-free. `tob` always matches the book while mx is held.
+    struct SymbolState {
+        std::mutex mx;
+        std::atomic<double> tickSize{kDefaultTick};
+        std::optional<LadderConfig> ladder;
+        std::unique_ptr<OrderBook> bookOwner;     // created on first use
+        std::atomic<OrderBook*> book{nullptr};
+        FeedState feed;
+        bool feedSeen = false;
+        Lru resolver;
+        std::shared_ptr<const SubList> subs;      // null = no subscribers
+        uint64_t pubSeq = 0;                      // per-symbol publication seq
+        std::vector<LevelChange> changes;         // the book's change log, reused
+        std::atomic<uint64_t> version{0};         // bumped on every book/feed change
+        TopOfBook tob;
+    };
+
+    // Symbols are spread over a fixed set of shards by hash; a shard's
+    // lock is taken exclusively only to add a symbol, so traffic on one
+    // symbol never blocks another.
+    struct Shard {
+        mutable std::shared_mutex mx;
+        std::unordered_map<std::string, std::unique_ptr<SymbolState>> symbols;
+    };
+    std::unique_ptr<Shard[]> shards_;
+    size_t shardCount_;
+
+    Shard& shardFor_(const std::string& symbol) const;
+    SymbolState* find_(const std::string& symbol) const;
+    SymbolState& getOrCreate_(const std::string& symbol);
+    OrderBook& bookOf_(SymbolState& st);                       // st.mx held
+    static void publishTob_(SymbolState& st, std::optional<Price> bid, uint64_t bidSz,
+                            std::optional<Price> ask, uint64_t askSz);
+
+    // Defaults for symbols created later
+    mutable std::mutex defaultsMx_;
+    LadderConfig defaultLadder_;
+    std::atomic<bool> hugePages_{false};
+    std::atomic<size_t> resolverCap_{4096};
+
+    std::atomic<uint64_t> nextSubId_{1};
+
+    // New-symbol subscribers, replaced wholesale like SubList.
+    using SymbolSubList = std::vector<std::pair<uint64_t, SymbolHandler>>;
+    mutable std::mutex symbolSubsMx_;
+    std::shared_ptr<const SymbolSubList> symbolSubs_;   // null = none
 
     // Metrics
     Metrics metrics_;
 
     // Helpers
     static int64_t quantizeTicks(double px, double tick);
+    static Price toTicks_(const SymbolState& st, double px) {
+        return Price{ quantizeTicks(px, st.tickSize.load(std::memory_order_relaxed)) };
+    }
 
-    // Build & publish a delta if anything changed
-    void maybePublishDelta_(const std::string& symbol,
-                            const std::vector<LevelDelta>& levels,
+    // Sequence and publish a delta if anything changed: the levels in
+    // `levels` whose total moved, plus the new TOB sides. Called with `lk`
+    // held on st.mx; releases it before invoking handlers. Without
+    // subscribers only the sequence advances.
+    void maybePublishDelta_(SymbolState& st, std::unique_lock<std::mutex>& lk,
+                            const std::string& symbol,
+                            const std::vector<LevelChange>& levels,
                             std::optional<std::pair<Price,uint64_t>> newBid,
                             std::optional<std::pair<Price,uint64_t>> newAsk);
 
-    // Wrap a mutation with before/after probes and auto-publish delta
+    // Run a mutation against the book, collecting the levels it touched
+    // from the book's change log, and publish the resulting delta.
     template <typename Fn>
-    bool mutateWithDelta_(const std::string& symbol,
-                          const std::vector<std::pair<Side,Price>>& candidates,
-                          Fn&& mutator);
+    bool mutateWithDelta_(SymbolState& st, std::unique_lock<std::mutex>& lk,
+                          const std::string& symbol, Fn&& mutator);
+
+    // Snapshot tail: clear stale, publish full TOB
+    void finishSnapshot_(SymbolState& st, std::unique_lock<std::mutex>& lk,
+                         const std::string& symbol, std::optional<uint64_t> snapshotSeq);
 
     // validation helpers
     inline bool validSide(Side s) const { return s == Side::Bid || s == Side::Ask; }
-    bool validatePrice_(const std::string& symbol, double px) const;
+    bool validatePrice_(const SymbolState& st, double px) const;
     static bool validateSize_(uint64_t sz) { return sz > 0; }
 
     // Allow negative prices for instruments like bonds with negative yields.
-    bool allowNegativePrices_ = false;
+    std::atomic<bool> allowNegativePrices_{false};
 
 public:
     void setAllowNegativePrices(bool allow) { allowNegativePrices_ = allow; }
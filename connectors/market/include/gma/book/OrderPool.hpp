@@ -0,0 +1,121 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gma/book/BookTypes.hpp"
+
+namespace gma {
+
+inline constexpr uint32_t kNoOrder = UINT32_MAX;
+
+// --------- Resting order record ---------
+// One per live order, addressed by a 32-bit pool index. The composite key
+// (id, feedId, epoch, synthetic) lives here and nowhere else; prev/next
+// link the order into its level's FIFO (`next` doubles as the free-list
+// link while the record is unused).
+struct OrderNode {
+    uint64_t id = 0;
+    uint64_t size = 0;
+    uint64_t priority = 0;
+    int64_t  price = 0;        // ticks
+    uint32_t feedId = 0;
+    uint32_t epoch  = 0;
+    uint32_t prev = kNoOrder;
+    uint32_t next = kNoOrder;
+    Side     side = Side::Bid;
+    bool     synthetic = false;
+
+    OrderKey key() const noexcept { return OrderKey{ id, feedId, epoch, synthetic }; }
+};
+
+// --------- OrderPool ---------
+// Slab allocator for OrderNode. Slabs are never returned to the heap
+// while the pool lives: freed records go on an intrusive free list and are
+// reused first, and clear() keeps every slab. With `hugePages` each slab
+// is a 2 MiB-aligned block advised for transparent huge pages (Linux; a
+// plain aligned block elsewhere), which keeps TLB misses down on books
+// with millions of resting orders.
+class OrderPool {
+public:
+    explicit OrderPool(bool hugePages = false) : hugePages_(hugePages) {}
+    ~OrderPool();
+
+    OrderPool(const OrderPool&)            = delete;
+    OrderPool& operator=(const OrderPool&) = delete;
+
+    // A default-initialized record.
+    uint32_t alloc();
+    void     release(uint32_t i) noexcept;
+
+    OrderNode&       operator[](uint32_t i)       noexcept { return slabs_[i >> SLAB_SHIFT][i & SLAB_MASK]; }
+    const OrderNode& operator[](uint32_t i) const noexcept { return slabs_[i >> SLAB_SHIFT][i & SLAB_MASK]; }
+
+    // Frees every record; slabs are kept for reuse.
+    void clear() noexcept;
+    void swap(OrderPool& other) noexcept;
+
+    std::size_t live()     const noexcept { return live_; }
+    std::size_t capacity() const noexcept { return slabs_.size() * SLAB_SIZE; }
+    std::size_t bytes()    const noexcept { return slabs_.size() * slabBytes(); }
+    bool        hugePages() const noexcept { return hugePages_; }
+
+    static constexpr uint32_t SLAB_SHIFT = 15;                 // 32768 records (~1.8 MiB)
+    static constexpr uint32_t SLAB_SIZE  = 1u << SLAB_SHIFT;
+    static constexpr uint32_t SLAB_MASK  = SLAB_SIZE - 1;
+
+private:
+    std::size_t slabBytes() const noexcept;
+    void        addSlab();
+
+    std::vector<OrderNode*> slabs_;
+    uint32_t    bump_ = 0;           // records below this were handed out at least once
+    uint32_t    freeHead_ = kNoOrder;
+    std::size_t live_ = 0;
+    bool        hugePages_;
+};
+
+// --------- OrderIndex ---------
+// Open-addressing (linear probing) map OrderKey -> pool index. Each slot
+// is the record index plus the low 32 bits of the key hash, so probes
+// compare tags before touching the pool and resizing never rehashes keys.
+// Deletion shifts the probe run back instead of leaving tombstones. Load
+// stays at or below one half.
+class OrderIndex {
+public:
+    uint32_t find(const OrderKey& k, const OrderPool& pool) const noexcept;
+
+    // `k` must not be present.
+    void insert(const OrderKey& k, uint32_t node);
+    // Replace the contents with pool records [0, n), which must be in the
+    // order their keys arrived: a repeated key maps to its last record and
+    // the records it displaced are returned. Inserts are grouped by table
+    // region, so the table fills near-sequentially instead of at random.
+    std::vector<uint32_t> bulkLoad(uint32_t n, const OrderPool& pool);
+    bool erase(const OrderKey& k, const OrderPool& pool) noexcept;
+    void clear() noexcept;
+
+    std::size_t size()  const noexcept { return size_; }
+    std::size_t bytes() const noexcept { return slots_.capacity() * sizeof(Slot); }
+
+    // Visit every indexed pool index.
+    template <class Fn>
+    void forEach(Fn&& fn) const {
+        for (const Slot& s : slots_) if (s.node != kNoOrder) fn(s.node);
+    }
+
+private:
+    struct Slot {
+        uint32_t node = kNoOrder;
+        uint32_t tag  = 0;
+    };
+
+    static uint32_t tagOf(const OrderKey& k) noexcept { return static_cast<uint32_t>(OrderKeyHash{}(k)); }
+    void grow();
+
+    std::vector<Slot> slots_;
+    std::size_t       mask_ = 0;
+    std::size_t       size_ = 0;
+};
+
+} // namespace gma
@@ -0,0 +1,480 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gma {
+
+// --------- Ladder selection ---------
+// Map  : one std::map node per price level (default; no fixed footprint).
+// Tick : flat array indexed by tick offset from a moving anchor, with an
+//        occupancy bitmap for best / next-level scans and a hash map for
+//        prices outside the window. Costs windowTicks slots per side up
+//        front, so it is meant for actively traded symbols.
+enum class LadderKind : uint8_t { Map = 0, Tick = 1 };
+
+struct LadderConfig {
+    LadderKind  kind = LadderKind::Map;
+    std::size_t windowTicks = 4096;   // Tick only; rounded up to a power of two >= 64
+    // > 0: depth-limited book. Only the best levels are kept, aggregated
+    // in a TopLadder holding at least depthLimit of them; orders keep no
+    // queue position. 0 = full per-order depth.
+    std::size_t depthLimit = 0;
+};
+
+// --------- TickLadder ---------
+// Levels keyed by integer tick. The window covers
+// [anchor, anchor + window) and always holds the best level; prices
+// outside it are always worse than every in-window price and live in
+// `overflow_`. A price that would become the new best outside the window,
+// or the window running empty while overflow is not, re-anchors the
+// window (moving levels by value, so std::list iterators inside T stay
+// valid). `descending` puts the best at the highest price (bids).
+//
+// Occupancy is two-level: one bit per slot, plus one summary bit per
+// non-zero 64-slot word, so best / next-level scans touch a handful of
+// words even in a sparse window.
+template <class T>
+class TickLadder {
+public:
+    TickLadder(bool descending, std::size_t windowTicks)
+        : window_(roundWindow(windowTicks)), descending_(descending) {}
+
+    bool        empty() const noexcept { return inWindow_ == 0 && overflow_.empty(); }
+    std::size_t size()  const noexcept { return inWindow_ + overflow_.size(); }
+
+    T* find(int64_t t) {
+        return const_cast<T*>(static_cast<const TickLadder*>(this)->find(t));
+    }
+    const T* find(int64_t t) const {
+        if (inWindow(t)) {
+            const std::size_t i = slotOf(t);
+            return test(i) ? &slots_[i] : nullptr;
+        }
+        auto it = overflow_.find(t);
+        return it == overflow_.end() ? nullptr : &it->second;
+    }
+
+    T& getOrCreate(int64_t t) {
+        if (slots_.empty()) allocate(t);
+        else if (!inWindow(t) && (inWindow_ == 0 || isBetterSide(t))) recenter(t);
+
+        if (inWindow(t)) {
+            const std::size_t i = slotOf(t);
+            if (!test(i)) { set(i); ++inWindow_; }
+            return slots_[i];
+        }
+        return overflow_.try_emplace(t).first->second;
+    }
+
+    void erase(int64_t t) {
+        if (inWindow(t)) {
+            const std::size_t i = slotOf(t);
+            if (!test(i)) return;
+            slots_[i] = T{};
+            reset(i);
+            --inWindow_;
+            if (inWindow_ == 0 && !overflow_.empty()) recenter(bestOverflow());
+            return;
+        }
+        overflow_.erase(t);
+    }
+
+    // Best level's tick and value; nullptr when empty.
+    const T* best(int64_t& outTicks) const {
+        if (inWindow_ == 0) return nullptr;
+        const std::size_t i = descending_ ? lastAtOrBelow(window_ - 1) : firstAtOrAbove(0);
+        outTicks = anchor_ + static_cast<int64_t>(i);
+        return &slots_[i];
+    }
+
+    // Visit up to n levels best -> worse as fn(ticks, const T&).
+    template <class Fn>
+    void forEach(std::size_t n, Fn&& fn) const {
+        std::size_t done = 0;
+        if (inWindow_ > 0) {
+            std::size_t i = descending_ ? lastAtOrBelow(window_ - 1) : firstAtOrAbove(0);
+            while (i != NPOS && done < n) {
+                fn(anchor_ + static_cast<int64_t>(i), slots_[i]);
+                ++done;
+                if (descending_) i = (i == 0) ? NPOS : lastAtOrBelow(i - 1);
+                else             i = (i + 1 == window_) ? NPOS : firstAtOrAbove(i + 1);
+            }
+        }
+        if (done >= n || overflow_.empty()) return;
+
+        // Far levels: rare, so sort on demand instead of keeping them ordered.
+        std::vector<int64_t> keys;
+        keys.reserve(overflow_.size());
+        for (const auto& kv : overflow_) keys.push_back(kv.first);
+        if (descending_) std::sort(keys.begin(), keys.end(), std::greater<>{});
+        else             std::sort(keys.begin(), keys.end());
+        for (std::size_t k = 0; k < keys.size() && done < n; ++k, ++done) {
+            fn(keys[k], overflow_.find(keys[k])->second);
+        }
+    }
+
+    void clear() {
+        if (inWindow_ > 0) {
+            for (std::size_t i = firstAtOrAbove(0); i != NPOS;
+                 i = (i + 1 == window_) ? NPOS : firstAtOrAbove(i + 1)) {
+                slots_[i] = T{};
+            }
+        }
+        std::fill(bits_.begin(), bits_.end(), 0);
+        std::fill(summary_.begin(), summary_.end(), 0);
+        inWindow_ = 0;
+        overflow_.clear();
+    }
+
+    // Introspection (tests / diagnostics)
+    int64_t     anchor()       const noexcept { return anchor_; }
+    std::size_t window()       const noexcept { return window_; }
+    std::size_t overflowSize() const noexcept { return overflow_.size(); }
+
+private:
+    static constexpr std::size_t NPOS = std::numeric_limits<std::size_t>::max();
+
+    static std::size_t roundWindow(std::size_t w) {
+        w = std::clamp<std::size_t>(w, 64, std::size_t{1} << 20);
+        return std::bit_ceil(w);
+    }
+
+    bool inWindow(int64_t t) const noexcept {
+        return !slots_.empty() && t >= anchor_ && t - anchor_ < static_cast<int64_t>(window_);
+    }
+    std::size_t slotOf(int64_t t) const noexcept { return static_cast<std::size_t>(t - anchor_); }
+
+    // Outside the window on the side where the best price lives.
+    bool isBetterSide(int64_t t) const noexcept { return descending_ ? t >= anchor_ : t < anchor_; }
+
+    // Anchor so the best sits a quarter window in from its edge, leaving
+    // room to improve before the next re-anchor.
+    int64_t anchorFor(int64_t best) const noexcept {
+        const int64_t w = static_cast<int64_t>(window_);
+        return descending_ ? best - (w - w / 4) : best - w / 4;
+    }
+
+    void allocate(int64_t t) {
+        slots_.resize(window_);
+        bits_.assign(window_ / 64, 0);
+        summary_.assign((window_ / 64 + 63) / 64, 0);
+        anchor_ = anchorFor(t);
+    }
+
+    int64_t bestOverflow() const {
+        auto it = overflow_.begin();
+        int64_t b = it->first;
+        for (++it; it != overflow_.end(); ++it) {
+            b = descending_ ? std::max(b, it->first) : std::min(b, it->first);
+        }
+        return b;
+    }
+
+    void recenter(int64_t best) {
+        std::vector<std::pair<int64_t, T>> moved;
+        moved.reserve(inWindow_);
+        if (inWindow_ > 0) {
+            for (std::size_t i = firstAtOrAbove(0); i != NPOS;
+                 i = (i + 1 == window_) ? NPOS : firstAtOrAbove(i + 1)) {
+                moved.emplace_back(anchor_ + static_cast<int64_t>(i), std::move(slots_[i]));
+                slots_[i] = T{};
+            }
+        }
+        std::fill(bits_.begin(), bits_.end(), 0);
+        std::fill(summary_.begin(), summary_.end(), 0);
+        inWindow_ = 0;
+        anchor_ = anchorFor(best);
+
+        for (auto it = overflow_.begin(); it != overflow_.end();) {
+            if (inWindow(it->first)) {
+                place(it->first, std::move(it->second));
+                it = overflow_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (auto& [t, lvl] : moved) {
+            if (inWindow(t)) place(t, std::move(lvl));
+            else             overflow_.try_emplace(t, std::move(lvl));
+        }
+    }
+
+    void place(int64_t t, T&& lvl) {
+        const std::size_t i = slotOf(t);
+        slots_[i] = std::move(lvl);
+        set(i);
+        ++inWindow_;
+    }
+
+    // ---- bitmap ----
+    bool test(std::size_t i) const noexcept { return (bits_[i >> 6] >> (i & 63)) & 1ULL; }
+    void set(std::size_t i) noexcept {
+        bits_[i >> 6] |= 1ULL << (i & 63);
+        summary_[i >> 12] |= 1ULL << ((i >> 6) & 63);
+    }
+    void reset(std::size_t i) noexcept {
+        uint64_t& w = bits_[i >> 6];
+        w &= ~(1ULL << (i & 63));
+        if (w == 0) summary_[i >> 12] &= ~(1ULL << ((i >> 6) & 63));
+    }
+
+    // First occupied slot >= i, or NPOS.
+    std::size_t firstAtOrAbove(std::size_t i) const noexcept {
+        std::size_t w = i >> 6;
+        if (uint64_t m = bits_[w] & (~0ULL << (i & 63))) return (w << 6) + std::countr_zero(m);
+        std::size_t nw = w + 1;                       // next candidate word
+        if (nw >= bits_.size()) return NPOS;
+        std::size_t s = nw >> 6;
+        uint64_t sm = summary_[s] & (~0ULL << (nw & 63));
+        while (sm == 0) {
+            if (++s >= summary_.size()) return NPOS;
+            sm = summary_[s];
+        }
+        w = (s << 6) + std::countr_zero(sm);
+        return (w << 6) + std::countr_zero(bits_[w]);
+    }
+
+    // Last occupied slot <= i, or NPOS.
+    std::size_t lastAtOrBelow(std::size_t i) const noexcept {
+        std::size_t w = i >> 6;
+        const unsigned b = i & 63;
+        const uint64_t keep = (b == 63) ? ~0ULL : ((1ULL << (b + 1)) - 1);
+        if (uint64_t m = bits_[w] & keep) return (w << 6) + 63 - std::countl_zero(m);
+        if (w == 0) return NPOS;
+        std::size_t pw = w - 1;                       // previous candidate word
+        std::size_t s = pw >> 6;
+        const unsigned sb = pw & 63;
+        uint64_t sm = summary_[s] & ((sb == 63) ? ~0ULL : ((1ULL << (sb + 1)) - 1));
+        while (sm == 0) {
+            if (s == 0) return NPOS;
+            sm = summary_[--s];
+        }
+        w = (s << 6) + 63 - std::countl_zero(sm);
+        return (w << 6) + 63 - std::countl_zero(bits_[w]);
+    }
+
+    std::vector<T>        slots_;      // allocated on first insert
+    std::vector<uint64_t> bits_;       // one bit per slot
+    std::vector<uint64_t> summary_;    // one bit per non-zero bits_ word
+    std::unordered_map<int64_t, T> overflow_;
+    int64_t     anchor_ = 0;
+    std::size_t inWindow_ = 0;
+    std::size_t window_;
+    bool        descending_;
+};
+
+// --------- PriceLadder ---------
+// One side of a book, keyed by tick, stored per LadderConfig::kind.
+// Callers see the same map-like interface either way; the kind is fixed
+// at construction so the branch predicts perfectly.
+template <class T>
+class PriceLadder {
+public:
+    PriceLadder(bool descending, const LadderConfig& cfg)
+        : kind_(cfg.kind), descending_(descending), tick_(descending, cfg.windowTicks) {}
+
+    LadderKind  kind()  const noexcept { return kind_; }
+    bool        empty() const noexcept { return kind_ == LadderKind::Tick ? tick_.empty() : map_.empty(); }
+    std::size_t size()  const noexcept { return kind_ == LadderKind::Tick ? tick_.size()  : map_.size(); }
+
+    T* find(int64_t t) {
+        return const_cast<T*>(static_cast<const PriceLadder*>(this)->find(t));
+    }
+    const T* find(int64_t t) const {
+        if (kind_ == LadderKind::Tick) return tick_.find(t);
+        auto it = map_.find(t);
+        return it == map_.end() ? nullptr : &it->second;
+    }
+
+    T& getOrCreate(int64_t t) {
+        if (kind_ == LadderKind::Tick) return tick_.getOrCreate(t);
+        return map_.try_emplace(t).first->second;
+    }
+
+    // Insert a level worse than every level present (bulk loads walk
+    // prices best-first, so neither kind searches or re-anchors).
+    T& appendWorse(int64_t t) {
+        if (kind_ == LadderKind::Tick) return tick_.getOrCreate(t);
+        return map_.emplace_hint(descending_ ? map_.begin() : map_.end(), t, T{})->second;
+    }
+
+    void erase(int64_t t) {
+        if (kind_ == LadderKind::Tick) tick_.erase(t);
+        else                           map_.erase(t);
+    }
+
+    const T* best(int64_t& outTicks) const {
+        if (kind_ == LadderKind::Tick) return tick_.best(outTicks);
+        if (map_.empty()) return nullptr;
+        const auto& kv = descending_ ? *map_.rbegin() : *map_.begin();
+        outTicks = kv.first;
+        return &kv.second;
+    }
+
+    template <class Fn>
+    void forEach(std::size_t n, Fn&& fn) const {
+        if (kind_ == LadderKind::Tick) { tick_.forEach(n, fn); return; }
+        std::size_t i = 0;
+        if (descending_) {
+            for (auto it = map_.rbegin(); it != map_.rend() && i < n; ++it, ++i) fn(it->first, it->second);
+        } else {
+            for (auto it = map_.begin(); it != map_.end() && i < n; ++it, ++i) fn(it->first, it->second);
+        }
+    }
+
+    void clear() {
+        if (kind_ == LadderKind::Tick) tick_.clear();
+        else                           map_.clear();
+    }
+
+    const TickLadder<T>& tickLadder() const noexcept { return tick_; }
+
+private:
+    LadderKind                 kind_;
+    bool                       descending_;
+    std::map<int64_t, T>       map_;
+    TickLadder<T>              tick_;
+};
+
+// --------- TopLadder ---------
+// One side of a depth-limited book: the best levels only, aggregated
+// (total size and order count) in a fixed array of 2 * keep slots, best
+// first. Orders priced worse than every held level are counted
+// (outside()) but not aggregated. A new level better than the worst held
+// one pushes that one out when the array is full; once departures leave
+// fewer than `keep` levels while orders are outside, the owner refills
+// from its resting orders (refill()), at most once per `keep`
+// departures. The best `keep` levels are therefore always exact.
+//
+// Mutators report each held level they change as
+// note(ticks, before, after), in total size (0 = not held).
+struct TopLevel {
+    int64_t  ticks = 0;
+    uint64_t totalSize = 0;
+    uint32_t count = 0;
+};
+
+class TopLadder {
+public:
+    // keep == 0 leaves the ladder unallocated (full-depth books).
+    TopLadder(bool descending, std::size_t keep)
+        : slots_(2 * keep), keep_(keep), descending_(descending) {}
+
+    std::size_t size()     const noexcept { return n_; }
+    std::size_t keep()     const noexcept { return keep_; }
+    std::size_t outside()  const noexcept { return outside_; }
+    bool        needsRefill() const noexcept { return outside_ > 0 && n_ < keep_; }
+
+    // Held level i, 0 = best.
+    const TopLevel& operator[](std::size_t i) const noexcept { return slots_[i]; }
+
+    const TopLevel* find(int64_t t) const noexcept {
+        const std::size_t p = seek(t);
+        return (p < n_ && slots_[p].ticks == t) ? &slots_[p] : nullptr;
+    }
+
+    // One order of `size` arrives at t.
+    template <class Note>
+    void add(int64_t t, uint64_t size, Note&& note) {
+        const std::size_t p = seek(t);
+        if (p < n_ && slots_[p].ticks == t) {
+            TopLevel& l = slots_[p];
+            note(t, l.totalSize, l.totalSize + size);
+            l.totalSize += size;
+            ++l.count;
+            return;
+        }
+        if (p == n_ && (outside_ > 0 || n_ == slots_.size())) { ++outside_; return; }
+        if (n_ == slots_.size()) {
+            const TopLevel& worst = slots_[--n_];
+            note(worst.ticks, worst.totalSize, 0);
+            outside_ += worst.count;
+        }
+        std::move_backward(slots_.begin() + p, slots_.begin() + n_, slots_.begin() + n_ + 1);
+        slots_[p] = TopLevel{ t, size, 1 };
+        ++n_;
+        note(t, 0, size);
+    }
+
+    // One order of `size` at t leaves.
+    template <class Note>
+    void remove(int64_t t, uint64_t size, Note&& note) {
+        const std::size_t p = seek(t);
+        if (p == n_ || slots_[p].ticks != t) { --outside_; return; }
+        TopLevel& l = slots_[p];
+        const uint64_t before = l.totalSize;
+        l.totalSize -= std::min(size, before);
+        if (--l.count == 0) {
+            std::move(slots_.begin() + p + 1, slots_.begin() + n_, slots_.begin() + p);
+            --n_;
+            note(t, before, 0);
+        } else {
+            note(t, before, l.totalSize);
+        }
+    }
+
+    // An order at t changes size in place.
+    template <class Note>
+    void resize(int64_t t, uint64_t from, uint64_t to, Note&& note) {
+        const std::size_t p = seek(t);
+        if (p == n_ || slots_[p].ticks != t) return;
+        TopLevel& l = slots_[p];
+        const uint64_t before = l.totalSize;
+        l.totalSize = before - std::min(from, before) + to;
+        note(t, before, l.totalSize);
+    }
+
+    // Pull the best outside levels back in. `orders(fn)` must call
+    // fn(ticks, size) for every resting order on this side.
+    template <class Orders, class Note>
+    void refill(Orders&& orders, Note&& note) {
+        std::vector<TopLevel> out;
+        out.reserve(outside_);
+        const bool all = n_ == 0;
+        const int64_t edge = all ? 0 : slots_[n_ - 1].ticks;
+        orders([&](int64_t t, uint64_t size) {
+            if (all || better(edge, t)) out.push_back(TopLevel{ t, size, 1 });
+        });
+        std::sort(out.begin(), out.end(), [this](const TopLevel& a, const TopLevel& b) {
+            return better(a.ticks, b.ticks);
+        });
+        const std::size_t first = n_;
+        for (const TopLevel& o : out) {
+            if (n_ > first && slots_[n_ - 1].ticks == o.ticks) {
+                slots_[n_ - 1].totalSize += o.totalSize;
+                ++slots_[n_ - 1].count;
+            } else if (n_ < slots_.size()) {
+                slots_[n_++] = o;
+            } else {
+                break;
+            }
+            --outside_;
+        }
+        for (std::size_t i = first; i < n_; ++i) note(slots_[i].ticks, 0, slots_[i].totalSize);
+    }
+
+private:
+    bool better(int64_t a, int64_t b) const noexcept { return descending_ ? a > b : a < b; }
+
+    // First held slot not better than t.
+    std::size_t seek(int64_t t) const noexcept {
+        return static_cast<std::size_t>(std::partition_point(slots_.begin(), slots_.begin() + n_,
+            [&](const TopLevel& l) { return better(l.ticks, t); }) - slots_.begin());
+    }
+
+    std::vector<TopLevel> slots_;      // fixed at 2 * keep
+    std::size_t n_ = 0;
+    std::size_t outside_ = 0;
+    std::size_t keep_;
+    bool        descending_;
+};
+
+} // namespace gma
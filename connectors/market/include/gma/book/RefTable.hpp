@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gma {
+
+// --------- RefTable ---------
+// Open-addressing (linear probing) map from a 64-bit reference (an order
+// ref, a key fingerprint) to a small value stored inline in the slot, so
+// a hit touches one cache line and an entry costs sizeof(Slot) / load
+// with no per-entry allocation. Deletion shifts the probe run back
+// instead of leaving tombstones; load stays at or below three quarters.
+// kNoRef marks empty slots and cannot be stored. Not thread-safe.
+template <class T>
+class RefTable {
+public:
+    static constexpr uint64_t kNoRef = ~0ULL;
+
+    T* find(uint64_t ref) noexcept {
+        return const_cast<T*>(static_cast<const RefTable*>(this)->find(ref));
+    }
+    const T* find(uint64_t ref) const noexcept {
+        if (size_ == 0) return nullptr;
+        for (std::size_t i = home(ref);; i = (i + 1) & mask_) {
+            const Slot& s = slots_[i];
+            if (s.ref == ref) return &s.value;
+            if (s.ref == kNoRef) return nullptr;
+        }
+    }
+
+    // Insert or overwrite; returns the stored value.
+    T& put(uint64_t ref, const T& value) {
+        if ((size_ + 1) * 4 > slots_.size() * 3) grow();
+        std::size_t i = home(ref);
+        while (slots_[i].ref != kNoRef && slots_[i].ref != ref) i = (i + 1) & mask_;
+        if (slots_[i].ref == kNoRef) ++size_;
+        slots_[i] = Slot{ ref, value };
+        return slots_[i].value;
+    }
+
+    bool erase(uint64_t ref) noexcept {
+        if (size_ == 0) return false;
+        std::size_t hole = home(ref);
+        for (;; hole = (hole + 1) & mask_) {
+            if (slots_[hole].ref == ref) break;
+            if (slots_[hole].ref == kNoRef) return false;
+        }
+        // Backward-shift: pull later entries of the run into the hole
+        // unless their home slot lies cyclically within (hole, j].
+        for (std::size_t j = (hole + 1) & mask_; slots_[j].ref != kNoRef; j = (j + 1) & mask_) {
+            const std::size_t h = home(slots_[j].ref);
+            const bool stays = (hole <= j) ? (hole < h && h <= j) : (hole < h || h <= j);
+            if (stays) continue;
+            slots_[hole] = slots_[j];
+            hole = j;
+        }
+        slots_[hole] = Slot{};
+        --size_;
+        return true;
+    }
+
+    void clear() noexcept {
+        for (Slot& s : slots_) s = Slot{};
+        size_ = 0;
+    }
+
+    std::size_t size()  const noexcept { return size_; }
+    std::size_t bytes() const noexcept { return slots_.capacity() * sizeof(Slot); }
+
+    // Visit every entry as fn(ref, value).
+    template <class Fn>
+    void forEach(Fn&& fn) const {
+        for (const Slot& s : slots_) if (s.ref != kNoRef) fn(s.ref, s.value);
+    }
+
+private:
+    struct Slot {
+        uint64_t ref = kNoRef;
+        T        value{};
+    };
+
+    // Refs are often sequential: mix before masking (murmur3 finalizer).
+    std::size_t home(uint64_t r) const noexcept {
+        r ^= r >> 33; r *= 0xff51afd7ed558ccdULL;
+        r ^= r >> 33; r *= 0xc4ceb9fe1a85ec53ULL;
+        r ^= r >> 33;
+        return static_cast<std::size_t>(r) & mask_;
+    }
+
+    void grow() {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        slots_.assign(old.empty() ? 16 : old.size() * 2, Slot{});
+        mask_ = slots_.size() - 1;
+        for (const Slot& s : old) {
+            if (s.ref == kNoRef) continue;
+            std::size_t i = home(s.ref);
+            while (slots_[i].ref != kNoRef) i = (i + 1) & mask_;
+            slots_[i] = s;
+        }
+    }
+
+    std::vector<Slot> slots_;
+    std::size_t       mask_ = 0;
+    std::size_t       size_ = 0;
+};
+
+} // namespace gma
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace gma {
+
+inline constexpr uint32_t kNoSymbol = UINT32_MAX;
+
+// --------- SymbolTable ---------
+// Interns symbol names as dense 32-bit ids, so per-order state can carry
+// a symbol in four bytes and resolve it back without hashing. Ids are
+// never reused and names stay at a stable address. Not thread-safe.
+class SymbolTable {
+public:
+    SymbolTable() = default;
+    SymbolTable(const SymbolTable&)            = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    // Id of `name`, assigned on first sight.
+    uint32_t intern(std::string_view name);
+    // Id of `name`, or kNoSymbol if never interned.
+    uint32_t find(std::string_view name) const noexcept;
+
+    const std::string& name(uint32_t id) const noexcept { return names_[id]; }
+    std::size_t        size() const noexcept { return names_.size(); }
+
+private:
+    std::deque<std::string> names_;                          // by id
+    std::unordered_map<std::string_view, uint32_t> ids_;      // views into names_
+};
+
+} // namespace gma
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+
+#include "gma/feed/FeedEvent.hpp"
+
+namespace gma {
+class Dispatcher;
+class OrderBookManager;
+} // namespace gma
+
+namespace gma::feed {
+
+/// Route adapter output in feed order:
+///   TickEvent  → Dispatcher (TA computation + raw-field listeners); runs of
+///                consecutive ticks go over as one onTickBatch.
+///   Ob* events → OrderBookManager (book mutations + trades).
+/// Events are moved from; either target may be null to drop its events.
+void routeFeedEvents(std::vector<FeedEvent>& events,
+                     Dispatcher* dispatcher,
+                     OrderBookManager* obManager);
+
+} // namespace gma::feed
@@ -2,10 +2,13 @@
 
 #include "gma/feed/IFeedAdapter.hpp"
 #include "gma/book/OrderBook.hpp"   // Side
+#include "gma/book/RefTable.hpp"
+#include "gma/book/SymbolTable.hpp"
 
 #include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 namespace gma::feed {
 
@@ -18,10 +21,24 @@ namespace gma::feed {
 /// Maintains internal state for:
 ///   - stockLocate → ticker mapping (ITCH pads to 8 chars)
 ///   - Live order tracking (needed to resolve partial fills / cancels)
+///
+/// Tickers are interned once, and only by the messages that create state
+/// (stock_directory, add_order); a live order is a 24-byte RefTable slot
+/// (symbol id, side, price, remaining shares), so executes, cancels and
+/// deletes find it by order ref without hashing or copying strings.
+/// Prices and shares are held at ITCH width (Price(4) and 32-bit shares);
+/// an add outside that range is dropped whole.
 class ItchAdapter : public IFeedAdapter {
 public:
     std::vector<FeedEvent> translate(const std::string& rawMessage) override;
 
+    /// Build a TickEvent with lastPrice + volume fields for TA computation.
+    static TickEvent makeTradeTickEvent(const std::string& symbol,
+                                        double price, uint64_t size);
+
+    /// Tickers interned so far.
+    std::size_t symbolCount() const noexcept { return symbols_.size(); }
+
 private:
     // ---- ITCH message handlers (each appends to `out`) ----
     void routeStockDirectory(const rapidjson::Value& doc, std::vector<FeedEvent>& out);
@@ -36,23 +53,37 @@ private:
     // ---- Helpers ----
     static double parsePrice(const rapidjson::Value& v);
 
-    /// Build a TickEvent with lastPrice + volume fields for TA computation.
-    static TickEvent makeTradeTickEvent(const std::string& symbol,
-                                        double price, uint64_t size);
+    /// "stock" with its space padding trimmed; empty if absent.
+    static std::string_view stockOf(const rapidjson::Value& doc);
+
+    /// Symbol id from "stock" (trimmed) or the stockLocate mapping;
+    /// kNoSymbol if neither resolves. Interns a new "stock" name, so only
+    /// messages that create state call it (stock_directory, add_order):
+    /// everything else reads the name or looks up the locate.
+    uint32_t resolveSymbol(const rapidjson::Value& doc);
+
+    /// Symbol id from the stockLocate mapping alone, or kNoSymbol.
+    uint32_t locateSymbol(const rapidjson::Value& doc) const;
 
     // ---- ITCH protocol state ----
 
-    /// stockLocate → ticker
-    std::unordered_map<int, std::string> locateToSymbol_;
+    SymbolTable symbols_;
+
+    /// stockLocate (ITCH: 16-bit) → symbol id
+    std::vector<uint32_t> locateToSymbol_;
 
-    /// Live order tracking for partial fill / cancel resolution.
+    /// Live order tracking for partial fill / cancel resolution, by order ref.
     struct OrderState {
-        std::string symbol;
-        uint64_t    remainingShares;
-        Side        side;
-        double      price;
+        uint32_t symbol;            // symbols_ id
+        uint32_t remainingShares;
+        uint32_t price;             // Price(4): 1/10000ths
+        Side     side;
     };
-    std::unordered_map<uint64_t, OrderState> orders_;
+    RefTable<OrderState> orders_;
+
+    /// Track a new order; false (nothing tracked) if the ref is reserved
+    /// or price / shares do not fit ITCH widths.
+    bool track(uint64_t orderRef, uint32_t symbol, Side side, double price, uint64_t shares);
 };
 
 } // namespace gma::feed
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "gma/feed/IFeedAdapter.hpp"
+#include "gma/book/OrderBook.hpp"   // Side
+#include "gma/book/RefTable.hpp"
+#include "gma/book/SymbolTable.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gma::feed {
+
+/// Feed adapter for binary NASDAQ TotalView-ITCH 5.0.
+///
+/// Input is the framing NASDAQ uses for its ITCH files and SoupBinTCP
+/// payloads: each message is a 2-byte big-endian length followed by the
+/// message itself. Fields are read at their fixed offsets straight from
+/// the buffer; nothing is copied or parsed into an intermediate form.
+///
+/// Emits the same FeedEvents as ItchAdapter for the same message:
+///   R stock directory    → ObTickSizeEvent (and registers the locate)
+///   A/F add order        → ObAddEvent
+///   E/C order executed   → ObUpdateEvent or ObDeleteEvent, + trade
+///   X order cancel       → ObUpdateEvent or ObDeleteEvent
+///   D order delete       → ObDeleteEvent
+///   U order replace      → ObDeleteEvent + ObAddEvent
+///   P/Q trade / cross    → ObTradeEvent + TickEvent
+/// where "trade" is an ObTradeEvent plus a TickEvent carrying lastPrice
+/// and volume. C executions marked non-printable update the book only.
+/// S system events are logged; other types are skipped.
+///
+/// Symbols are resolved by stock locate through a flat table; the ticker
+/// is read (and interned) only when a locate has not been seen in a
+/// stock directory message yet. Order state is kept as in ItchAdapter.
+class ItchBinaryAdapter : public IFeedAdapter {
+public:
+    /// Per-adapter message counts. Kept as plain counters so the hot path
+    /// takes no lock; callers publish them (e.g. to metrics) in batches.
+    struct Stats {
+        uint64_t messages   = 0;  // complete messages seen
+        uint64_t skipped    = 0;  // unhandled message types
+        uint64_t malformed  = 0;  // empty, short for their type, or reserved ref
+        uint64_t unknownRef = 0;  // execute / cancel / delete / replace of an untracked order
+    };
+
+    /// `rawMessage` holds one or more length-prefixed messages; a trailing
+    /// partial message is dropped.
+    std::vector<FeedEvent> translate(const std::string& rawMessage) override;
+
+    /// Decode every complete length-prefixed message in [data, data+len),
+    /// appending events to `out`. Returns the bytes consumed; anything
+    /// after that is a partial message to retry with more data.
+    std::size_t decode(const uint8_t* data, std::size_t len, std::vector<FeedEvent>& out);
+
+    /// Decode one message body (no length prefix).
+    void decodeMessage(const uint8_t* msg, std::size_t len, std::vector<FeedEvent>& out);
+
+    const Stats& stats() const noexcept { return stats_; }
+
+private:
+    // ---- Message handlers (`m` points at the type byte) ----
+    void onStockDirectory(const uint8_t* m, std::vector<FeedEvent>& out);
+    void onAddOrder      (const uint8_t* m, std::vector<FeedEvent>& out);
+    void onExecuted      (const uint8_t* m, bool withPrice, std::vector<FeedEvent>& out);
+    void onCancel        (const uint8_t* m, std::vector<FeedEvent>& out);
+    void onDelete        (const uint8_t* m, std::vector<FeedEvent>& out);
+    void onReplace       (const uint8_t* m, std::vector<FeedEvent>& out);
+    void onTrade         (const uint8_t* m, std::vector<FeedEvent>& out);
+    void onCross         (const uint8_t* m, std::vector<FeedEvent>& out);
+    void onSystemEvent   (const uint8_t* m);
+
+    /// Symbol id for the message's locate; if the locate is unregistered,
+    /// the 8-byte ticker at `stock` is interned and registered for it.
+    uint32_t symbolFor(uint16_t locate, const uint8_t* stock);
+
+    void emitTrade(uint32_t symbol, uint32_t price4, uint64_t shares,
+                   Aggressor aggr, std::vector<FeedEvent>& out);
+
+    // ---- ITCH protocol state ----
+
+    SymbolTable symbols_;
+
+    /// stockLocate → symbol id
+    std::vector<uint32_t> locateToSymbol_;
+
+    /// Live orders by order ref (as ItchAdapter).
+    struct OrderState {
+        uint32_t symbol;            // symbols_ id
+        uint32_t remainingShares;
+        uint32_t price;             // Price(4): 1/10000ths
+        Side     side;
+    };
+    RefTable<OrderState> orders_;
+
+    Stats stats_;
+};
+
+} // namespace gma::feed
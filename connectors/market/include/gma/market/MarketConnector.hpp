@@ -9,15 +9,15 @@
 
 namespace gma {
 class OrderBookManager;
-namespace ob       { class Provider; class FunctionalSnapshotSource; }
+namespace ob       { class Provider; class FunctionalSnapshotSource; class PushMaterializer; }
 } // namespace gma
 
 namespace gma::market {
 
 // The market connector owns everything market-specific: order book engine,
 // TA tick computer (registered with EventComputerRegistry), "ob.*" atomic
-// provider namespace, TCP FeedServer, and external WsFeedClients driven by
-// ItchAdapter.
+// provider namespace and its push materializer, TCP FeedServer, and
+// external WsFeedClients driven by ItchAdapter.
 //
 // Lifecycle (driven by the composition root):
 //   MarketConnector connector;
@@ -49,6 +49,8 @@ private:
   std::shared_ptr<OrderBookManager>                  _obManager;
   std::shared_ptr<ob::FunctionalSnapshotSource>      _snapSource;
   std::shared_ptr<ob::Provider>                      _obProvider;
+  // Pushes subscribed ob.* keys through Dispatcher::notifyListeners.
+  std::shared_ptr<ob::PushMaterializer>              _obPush;
 
   // Populated by ConfigNamespaceRegistry callbacks during
   // Config::dispatchPendingKeys(); shared with MarketTickComputer
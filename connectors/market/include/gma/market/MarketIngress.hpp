@@ -2,19 +2,30 @@
 
 // Thin IIngressSource adapters that wrap the existing FeedServer + WsFeedClient
 // types. Lets the engine drive their lifecycle uniformly through
-// IngressRegistry without changing those classes' public surfaces.
+// IngressRegistry without changing those classes' public surfaces. The
+// depth stream adapter does the same for client streams (StreamRegistry).
+// ItchReplayIngress is a source in its own right: a binary ITCH file.
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "gma/engine/IngressRegistry.hpp"
+#include "gma/engine/StreamRegistry.hpp"
+
+namespace boost::asio { class io_context; }
 
 namespace gma {
+class Dispatcher;
+class DepthStreamer;
 class FeedServer;
 class OrderBookManager;
 namespace ws { class WsFeedClient; }
 namespace feed { class IFeedAdapter; }
+namespace util { class MappedFile; }
 } // namespace gma
 
 namespace gma::market {
@@ -49,4 +60,56 @@ private:
   bool started_{false};
 };
 
+// Replays a binary ITCH 5.0 file (length-prefixed messages, as NASDAQ
+// publishes them) through an ItchBinaryAdapter into the Dispatcher and
+// OrderBookManager on its own thread, as fast as they take it. The file
+// is mapped at construction, so a bad path fails in the factory. start()
+// begins the run, which ends at end of file; stop() ends it at the next
+// batch boundary and joins. Decoder counts go to feed_itch.* metrics once
+// per batch.
+class ItchReplayIngress final : public engine::IIngressSource {
+public:
+  ItchReplayIngress(const std::string& path,
+                    Dispatcher* dispatcher,
+                    OrderBookManager* obManager);
+  ~ItchReplayIngress() override;
+
+  void start() override;
+  void stop() noexcept override;
+
+  // True once the whole file has been replayed.
+  bool finished() const noexcept { return finished_.load(); }
+
+private:
+  void run();
+
+  std::unique_ptr<util::MappedFile> file_;
+  Dispatcher*       dispatcher_;   // not owned
+  OrderBookManager* obManager_;    // not owned
+  std::thread       thread_;
+  std::atomic<bool> stopping_{false};
+  std::atomic<bool> finished_{false};
+};
+
+// Drives a DepthStreamer for one client: start() sends the initial
+// snapshot and arms a timer that flushes conflated changes every
+// `flushEvery`; stop() cancels the timer and unsubscribes from the book.
+// Constructed by the "depth" stream factory per client subscription.
+class DepthStreamSource final : public engine::IStream {
+public:
+  DepthStreamSource(boost::asio::io_context& io,
+                    std::shared_ptr<DepthStreamer> streamer,
+                    std::chrono::milliseconds flushEvery);
+  ~DepthStreamSource() override;
+
+  void start() override;
+  void stop() noexcept override;
+  // One work unit per book delta, plus a 2 x levels diff per flush.
+  tree::TreeCost cost() const override;
+
+private:
+  struct Loop;                  // timer + streamer, shared with pending waits
+  std::shared_ptr<Loop> loop_;
+};
+
 } // namespace gma::market
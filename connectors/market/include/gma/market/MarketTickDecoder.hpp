@@ -0,0 +1,101 @@
+#pragma once
+
+#include "gma/SymbolHistory.hpp"   // TickEntry
+#include "gma/market/MarketFieldMap.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <rapidjson/document.h>
+
+namespace gma::market {
+
+// Extracts a tick's canonical fields (price / volume / bid / ask /
+// timestamp) as laid out by a MarketFieldMap, in one pass over the
+// payload instead of one member lookup per alias.
+//
+// The field map's alias lists are compiled once into a key table; each
+// payload member name is then matched against that table and kept if it
+// beats the best alias seen so far for its field. The result is the same
+// as probing the aliases in order: the earliest alias present with a
+// number wins (an unsigned integer, for the timestamp), and a member name
+// that repeats counts at its first occurrence only.
+//
+// decode() walks a parsed DOM. scan() reads the raw JSON text of the
+// payload directly, skipping every member that is not in the table, so a
+// feed that owns the bytes can fill a TickEntry without building a DOM.
+// Skipped values are only delimited, not validated: on well-formed JSON
+// scan() and decode() agree.
+//
+// The pass tracks at most kMaxKeys aliases. A wider field map is decoded
+// by probing the aliases in order instead: same result, one lookup per
+// alias. scan() does not handle it.
+class MarketTickDecoder {
+public:
+  static constexpr std::size_t kMaxKeys = 64;   // bits in Pass::seen
+
+  explicit MarketTickDecoder(const MarketFieldMap& fm);
+
+  // Fills every field of `out` (0 where absent). False when no price
+  // alias holds a number; `out` is then unspecified.
+  bool decode(const rapidjson::Value& payload, TickEntry& out) const;
+
+  // False when the field map has more than kMaxKeys aliases.
+  bool singlePass() const noexcept { return probe_.empty(); }
+
+  enum class Scan {
+    Tick,         // `out` filled, as decode() would
+    NoPrice,      // a well-formed object without a usable price
+    Unsupported,  // not an object, malformed, escapes where a name or the
+                  // symbol is read, or a field map too wide to scan
+  };
+
+  // As decode(), from the text of a JSON object. With `symbol`, also
+  // returns the first top-level "symbol" member if it is a string (empty
+  // otherwise), pointing into `json`. Unsupported means the scanner cannot
+  // vouch for the answer: parse a DOM and decode() that. Numbers are
+  // converted with correct rounding, so a value with more digits than a
+  // double holds may differ in the last place from rapidjson's default
+  // (non full-precision) parse.
+  Scan scan(std::string_view json, TickEntry& out, std::string_view* symbol = nullptr) const;
+
+private:
+  enum Field : std::uint8_t { kPrice, kVolume, kBid, kAsk, kTimestamp, kFields };
+
+  // One alias of one field; `rank` is its position in that field's list.
+  struct Key {
+    std::string  name;
+    Field        field;
+    std::uint8_t rank;
+  };
+
+  // Best alias rank taken so far per field, and which keys have been seen.
+  struct Pass {
+    std::uint8_t  best[kFields];
+    std::uint64_t seen = 0;
+    double        value[kFields] = {};
+    std::uint64_t timestampNs = 0;
+    Pass() { for (auto& b : best) b = UINT8_MAX; }
+  };
+
+  // Calls `take(i)` for every key matching `name` not seen before.
+  template <class Take>
+  void match(std::string_view name, Pass& pass, Take&& take) const;
+
+  // Takes `v` for `field` if it has the field's type.
+  static bool take(Field field, const rapidjson::Value& v, Pass& pass);
+
+  // The wide-map path: aliases probed in order, field by field.
+  bool decodeByProbe(const rapidjson::Value& payload, TickEntry& out) const;
+
+  static bool finish(const Pass& pass, TickEntry& out);
+
+  // Sorted by name length, so a lookup stops at the first longer name.
+  std::vector<Key> keys_;
+  // Set instead of keys_ past kMaxKeys aliases: in field-map order.
+  std::vector<Key> probe_;
+};
+
+} // namespace gma::market
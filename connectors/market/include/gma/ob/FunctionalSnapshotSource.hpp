@@ -16,9 +16,14 @@ public:
                                            Mode mode,
                                            std::optional<std::pair<double,double>> priceBand)>;
   using TickFn    = std::function<double(const std::string& symbol)>;
+  using VersionFn = std::function<uint64_t(const std::string& symbol)>;
+  using LevelsFn  = std::function<SideSums(const std::string& symbol, Side side, Range levels)>;
+  using BandFn    = std::function<SideSums(const std::string& symbol, Side side, double p1, double p2)>;
 
-  FunctionalSnapshotSource(CaptureFn cap, TickFn tick)
-  : cap_(std::move(cap)), tick_(std::move(tick)) {}
+  FunctionalSnapshotSource(CaptureFn cap, TickFn tick, VersionFn ver = {},
+                           LevelsFn levels = {}, BandFn band = {})
+  : cap_(std::move(cap)), tick_(std::move(tick)), ver_(std::move(ver)),
+    levels_(std::move(levels)), band_(std::move(band)) {}
 
   Snapshot capture(const std::string& sym,
                    size_t n,
@@ -27,10 +32,25 @@ public:
     return cap_(sym, n, m, std::move(band));
   }
   double tickSize(const std::string& sym) const override { return tick_(sym); }
+  std::optional<uint64_t> version(const std::string& sym) const override {
+    if (!ver_) return std::nullopt;
+    return ver_(sym);
+  }
+  std::optional<SideSums> sumLevels(const std::string& sym, Side side, Range r) const override {
+    if (!levels_) return std::nullopt;
+    return levels_(sym, side, r);
+  }
+  std::optional<SideSums> sumBand(const std::string& sym, Side side, double p1, double p2) const override {
+    if (!band_) return std::nullopt;
+    return band_(sym, side, p1, p2);
+  }
 
 private:
   CaptureFn cap_;
   TickFn tick_;
+  VersionFn ver_;
+  LevelsFn levels_;
+  BandFn band_;
 };
 
 } // namespace gma::ob
@@ -1,7 +1,11 @@
 #pragma once
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <cstddef>
+#include <unordered_map>
 #include "gma/ob/FunctionalSnapshotSource.hpp"
 #include "gma/ob/ObKey.hpp" // for Mode
 
@@ -16,12 +20,39 @@ public:
   // Resolve a single ob.* key for symbol; returns NaN if unknown/unavailable.
   double get(const std::string& symbol, const std::string& fullKey) const;
 
+  // Parse once, evaluate many times: compile() returns nullopt for keys
+  // parseObKey rejects; eval() returns NaN if the book is unavailable.
+  std::optional<ObKey> compile(const std::string& fullKey) const { return parseObKey(fullKey); }
+  double eval(const std::string& symbol, const ObKey& key) const;
+
+  // Cumulative, range, band, VWAP and imbalance keys answered from the
+  // source's slice totals (sumLevels / sumBand) without a capture.
+  // nullopt when the key or the source needs a snapshot instead.
+  std::optional<double> evalFromSums(const std::string& symbol, const ObKey& key) const;
+
+  // Snapshot of at least `depth` levels, shared by every key read against
+  // the same source version.
+  std::shared_ptr<const Snapshot> snapshot(const std::string& symbol, std::size_t depth, Mode mode) const;
+
+  // Captures taken from the source (snapshot cache misses).
+  uint64_t captures() const { return captures_.load(std::memory_order_relaxed); }
+
 private:
-  double getImpl(const std::string& symbol, const std::string& fullKey) const;
+  // Levels a key needs from the capture; price-addressed keys take the full book.
+  std::size_t depthFor(const ObKey& key) const;
 
   std::shared_ptr<FunctionalSnapshotSource> src_;
   std::size_t defPer_;
   std::size_t defAgg_;
+
+  struct CacheEntry {
+    uint64_t version = 0;
+    std::size_t depth = 0;
+    std::shared_ptr<const Snapshot> snap;
+  };
+  mutable std::mutex cacheMx_;
+  mutable std::unordered_map<std::string, CacheEntry> cache_[2];   // by Mode
+  mutable std::atomic<uint64_t> captures_{0};
 };
 
 } // namespace gma::ob
@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "gma/book/OrderBookManager.hpp"
+#include "gma/ob/ObKey.hpp"
+#include "gma/ob/ObProvider.hpp"
+
+namespace gma::ob {
+
+// Push side of ob.*: keeps the set of subscribed keys per symbol, listens
+// to the book's delta stream and re-evaluates only the keys a delta can
+// have changed. Each key depends on the top N levels of a side or on a
+// price band; a level change deeper than every subscribed N, or outside
+// every band, touches nothing. Changed values go to `notify`, called with
+// the symbol's key lock held so a symbol's pushes arrive in evaluation
+// order; it must not call back into the materializer.
+class PushMaterializer : public std::enable_shared_from_this<PushMaterializer> {
+public:
+  using NotifyFn = std::function<void(const std::string& symbol, const std::string& key, double value)>;
+
+  static std::shared_ptr<PushMaterializer> create(std::shared_ptr<OrderBookManager> books,
+                                                  std::shared_ptr<Provider> provider,
+                                                  NotifyFn notify);
+  ~PushMaterializer();
+
+  // Start/stop pushing `fullKey` for `symbol`. Subscribing pushes the
+  // current value; keys parseObKey rejects are ignored. A symbol the book
+  // has no state for yet is kept pending and attaches when the book first
+  // creates it; at most kMaxPendingSymbols symbols wait at once, and keys
+  // for further unknown symbols are dropped.
+  static constexpr std::size_t kMaxPendingSymbols = 1024;
+  void subscribe(const std::string& symbol, const std::string& fullKey);
+  void unsubscribe(const std::string& symbol, const std::string& fullKey);
+
+  // Drop every subscription; later calls are no-ops.
+  void stop();
+
+  // Key evaluations so far.
+  uint64_t evaluations() const { return evals_.load(std::memory_order_relaxed); }
+
+  // Symbols with subscribed keys that the book does not know yet.
+  std::size_t pendingSymbols() const;
+
+private:
+  PushMaterializer(std::shared_ptr<OrderBookManager> books,
+                   std::shared_ptr<Provider> provider,
+                   NotifyFn notify);
+
+  // What part of the book a key reads, per side (0 = bid, 1 = ask).
+  struct Dep {
+    std::size_t depth[2] = {0, 0};          // top-N levels
+    bool   band[2] = {false, false};        // price band [lo, hi]
+    double lo[2] = {0, 0}, hi[2] = {0, 0};
+    bool   any = false;                     // meta: every delta
+  };
+  struct Entry {
+    std::string name;
+    ObKey key;
+    Dep dep;
+    double last;                            // last pushed (NaN = nothing yet)
+  };
+  struct SymbolKeys {
+    std::mutex mx;
+    uint64_t subId = 0;                     // 0 = pending: no book state yet
+    std::vector<Entry> keys;
+    std::shared_ptr<const Snapshot> last;   // book as of the last evaluation
+  };
+  using Push = std::pair<std::string, double>;
+
+  static Dep depFor(const ObKey& k);
+  static bool touches(const Dep& dep, const BookDelta& d, const Snapshot* last, double tick);
+  void onDelta(const std::string& symbol, const BookDelta& d);
+  // subscribeDeltas for `symbol` routed to onDelta; 0 if the book has no
+  // state for it yet.
+  uint64_t attach(const std::string& symbol);
+  // The book created `symbol`: attach its pending keys, if any.
+  void onSymbol(const std::string& symbol);
+  // Evaluate the flagged keys against one shared capture; sk.mx held.
+  void evaluate(const std::string& symbol, SymbolKeys& sk, const std::vector<bool>& which,
+                std::vector<Push>& out);
+
+  std::shared_ptr<OrderBookManager> books_;
+  std::shared_ptr<Provider> provider_;
+  NotifyFn notify_;
+
+  mutable std::mutex mx_;                   // symbols_, pending_, stopped_
+  std::unordered_map<std::string, std::shared_ptr<SymbolKeys>> symbols_;
+  std::size_t pending_ = 0;
+  uint64_t symbolSubId_ = 0;
+  bool stopped_ = false;
+  std::atomic<uint64_t> evals_{0};
+};
+
+} // namespace gma::ob
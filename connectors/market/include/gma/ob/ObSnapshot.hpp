@@ -34,6 +34,15 @@ struct Snapshot {
   Meta   meta;
 };
 
+// Totals over a slice of one side (prices scaled by tick).
+struct SideSums {
+  double levels = 0.0;
+  double size = 0.0;
+  double orders = std::numeric_limits<double>::quiet_NaN(); // NaN if unknown
+  double price = 0.0;     // sum of level prices
+  double notional = 0.0;  // sum of price*size
+};
+
 // Abstract source (you implement the glue to your order book once)
 struct SnapshotSource {
   virtual ~SnapshotSource() = default;
@@ -43,6 +52,17 @@ struct SnapshotSource {
                            Mode mode,
                            std::optional<std::pair<double,double>> priceBand = std::nullopt) const = 0;
   virtual double tickSize(const std::string& symbol) const = 0;
+  // Monotonic per-symbol version: two captures taken at the same version
+  // see the same book. nullopt means "unknown", i.e. never cache.
+  virtual std::optional<uint64_t> version(const std::string& /*symbol*/) const { return std::nullopt; }
+  // Slice totals straight from the book: levels r.a..r.b best-first, or
+  // priced in [p1, p2]. nullopt means "not supported", i.e. capture.
+  virtual std::optional<SideSums> sumLevels(const std::string& /*symbol*/, Side, Range) const {
+    return std::nullopt;
+  }
+  virtual std::optional<SideSums> sumBand(const std::string& /*symbol*/, Side, double /*p1*/, double /*p2*/) const {
+    return std::nullopt;
+  }
 };
 
 } // namespace gma::ob
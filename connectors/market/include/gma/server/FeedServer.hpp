@@ -11,10 +11,18 @@ namespace gma {
 
 class Dispatcher;   // fwd-declare to keep header light
 class OrderBookManager;   // fwd-declare for OB routing
+namespace market {
+struct MarketFieldMap;
+class MarketTickDecoder;
+}
 
 /// Minimal TCP feed server that accepts producer connections and forwards
 /// incoming messages to a Dispatcher. The actual deserialization is
 /// done inside the session implementation (cpp), not exposed here.
+///
+/// Given the field map the tick computers use, plain tick lines are decoded
+/// straight from the text into Event::decoded, and their DOM is built only
+/// when the dispatcher says something reads it (Dispatcher::wantsPayload).
 class FeedServer {
 public:
   using tcp = boost::asio::ip::tcp;
@@ -28,12 +36,22 @@ public:
              OrderBookManager* obManager,
              unsigned short port);
 
+  FeedServer(boost::asio::io_context& ioc,
+             Dispatcher* dispatcher,
+             OrderBookManager* obManager,
+             const market::MarketFieldMap& fieldMap,
+             unsigned short port);
+
   FeedServer(const FeedServer&) = delete;
   FeedServer& operator=(const FeedServer&) = delete;
 
   void run();
   void stop();
 
+  /// Bound port once run() has opened the acceptor (useful with port 0);
+  /// 0 before that.
+  unsigned short port() const;
+
 private:
   class FeedSession; // pimpl session
 
@@ -50,6 +68,7 @@ private:
 
   Dispatcher*        dispatcher_; // not owned
   OrderBookManager*        obManager_{nullptr}; // not owned
+  std::shared_ptr<const market::MarketTickDecoder> decoder_; // null: DOM for every line
 
   std::mutex                                  mu_;
   std::unordered_set<std::shared_ptr<FeedSession>> sessions_;
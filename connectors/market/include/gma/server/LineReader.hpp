@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+
+namespace gma {
+
+/// Fixed-capacity receive buffer that frames newline-delimited messages
+/// in place.
+///
+/// Reads land directly in the free tail (prepare / commit); next() finds
+/// the following '\n' with memchr, resuming where the last scan stopped,
+/// and returns the line as a span into the buffer, NUL-terminated where
+/// the '\n' (or a "\r\n") was — ready for in-situ parsing. Consumed bytes
+/// are never erased: once every complete line has been taken the cursors
+/// rewind to the start, and otherwise only the trailing partial line is
+/// moved down, when the free tail runs short.
+///
+/// A returned line stays valid until the next prepare(). Not thread-safe.
+class LineReader {
+public:
+  explicit LineReader(std::size_t capacity)
+    : buf_(std::make_unique<char[]>(capacity)), cap_(capacity) {}
+
+  LineReader(const LineReader&)            = delete;
+  LineReader& operator=(const LineReader&) = delete;
+
+  /// Writable tail for the next read. Empty only when full(): the buffer
+  /// holds one partial line as long as the whole capacity.
+  std::span<char> prepare() {
+    if (begin_ > 0 && cap_ - end_ < cap_ / kCompactRatio) compact();
+    return {buf_.get() + end_, cap_ - end_};
+  }
+
+  /// Mark `n` bytes of the span returned by prepare() as received.
+  void commit(std::size_t n) noexcept { end_ += n; }
+
+  /// Next complete line without its terminator, or nullopt once only a
+  /// partial line (or nothing) is left.
+  std::optional<std::span<char>> next() noexcept {
+    char* const base = buf_.get();
+    auto* nl = static_cast<char*>(std::memchr(base + scan_, '\n', end_ - scan_));
+    if (!nl) {
+      if (begin_ == end_) begin_ = end_ = 0;
+      scan_ = end_;
+      return std::nullopt;
+    }
+    char* const first = base + begin_;
+    char* last = nl;
+    begin_ = scan_ = static_cast<std::size_t>(nl - base) + 1;
+    if (last > first && last[-1] == '\r') --last;
+    *last = '\0';
+    return std::span<char>(first, last);
+  }
+
+  /// Bytes received but not yet returned as a line.
+  std::size_t pending()  const noexcept { return end_ - begin_; }
+  std::size_t capacity() const noexcept { return cap_; }
+  bool        full()     const noexcept { return pending() == cap_; }
+
+private:
+  // Move the partial line down once less than 1/kCompactRatio of the
+  // buffer is left to read into.
+  static constexpr std::size_t kCompactRatio = 16;
+
+  void compact() noexcept {
+    const std::size_t n = end_ - begin_;
+    std::memmove(buf_.get(), buf_.get() + begin_, n);
+    scan_ -= begin_;
+    end_   = n;
+    begin_ = 0;
+  }
+
+  std::unique_ptr<char[]> buf_;
+  std::size_t cap_;
+  std::size_t begin_ = 0;   // start of the first unreturned line
+  std::size_t scan_  = 0;   // memchr resumes here; [begin_, scan_) has no '\n'
+  std::size_t end_   = 0;   // end of received data
+};
+
+} // namespace gma
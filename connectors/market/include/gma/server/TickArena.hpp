@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include <rapidjson/document.h>
+
+#include "gma/SymbolHistory.hpp"
+
+namespace gma {
+
+/// Memory for the lines of one feed batch.
+///
+/// Every line is parsed straight into one value pool, with its strings
+/// copied so nothing points into the read buffer. A tick payload is a
+/// document that aliases the arena (keep()), rather than a document with an
+/// allocator of its own deep-copied from a scratch parse. A tick decoded
+/// from the raw line without a DOM is kept the same way (keep(TickEntry)).
+///
+/// recycle() once the batch has been dispatched. The pool's first block is
+/// kept, so a batch that fits in it allocates nothing. A payload still held
+/// at that point keeps its arena alive; the caller then moves to a fresh
+/// one.
+///
+/// Not thread-safe.
+class TickArena : public std::enable_shared_from_this<TickArena> {
+public:
+  using Pool   = rapidjson::MemoryPoolAllocator<>;
+  using Parser = rapidjson::GenericDocument<rapidjson::UTF8<>, Pool, Pool>;
+
+  static constexpr std::size_t VALUE_BYTES = 64 * 1024;
+  static constexpr std::size_t STACK_BYTES = 4 * 1024;
+
+  static std::shared_ptr<TickArena> create() { return std::shared_ptr<TickArena>(new TickArena()); }
+
+  TickArena(const TickArena&)            = delete;
+  TickArena& operator=(const TickArena&) = delete;
+
+  /// Parse `line` into the pool. The returned document is valid until the
+  /// next parse() or recycle(); check HasParseError().
+  Parser& parse(std::string_view line) {
+    parser_.reset();
+    stack_.Clear();
+    parser_.emplace(&values_, STACK_BYTES / 2, &stack_);
+    parser_->Parse(line.data(), line.size());
+    return *parser_;
+  }
+
+  /// Move the last parse()d root into a payload document that shares
+  /// ownership of the arena.
+  std::shared_ptr<rapidjson::Document> keep() {
+    rapidjson::Document& doc = docs_.emplace_back(&values_);
+    static_cast<rapidjson::Value&>(doc).Swap(static_cast<rapidjson::Value&>(*parser_));
+    return std::shared_ptr<rapidjson::Document>(shared_from_this(), &doc);
+  }
+
+  /// Hold a tick decoded straight from the line, sharing ownership of the
+  /// arena like a kept payload.
+  std::shared_ptr<const TickEntry> keep(const TickEntry& entry) {
+    return std::shared_ptr<const TickEntry>(shared_from_this(), &entries_.emplace_back(entry));
+  }
+
+  /// Reuse `arena` for the next batch, or replace it if a payload from
+  /// this one is still held elsewhere.
+  static void recycle(std::shared_ptr<TickArena>& arena) {
+    if (arena.use_count() != 1) { arena = create(); return; }
+    arena->parser_.reset();
+    arena->docs_.clear();
+    arena->entries_.clear();
+    arena->values_.Clear();
+  }
+
+  /// Payloads and decoded ticks kept since the last recycle().
+  std::size_t kept() const noexcept { return docs_.size() + entries_.size(); }
+
+private:
+  TickArena() = default;
+
+  alignas(std::max_align_t) char valueBuf_[VALUE_BYTES];
+  alignas(std::max_align_t) char stackBuf_[STACK_BYTES];
+  Pool values_{valueBuf_, sizeof(valueBuf_)};
+  Pool stack_{stackBuf_, sizeof(stackBuf_)};
+  std::optional<Parser> parser_;
+  std::deque<rapidjson::Document> docs_;
+  std::deque<TickEntry> entries_;
+};
+
+} // namespace gma
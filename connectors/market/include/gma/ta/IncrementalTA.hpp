@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <set>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gma/HistoryStore.hpp"
+#include "gma/StreamValue.hpp"
+#include "gma/SymbolHistory.hpp"
+#include "gma/util/Config.hpp"
+
+namespace gma::ta {
+
+// Stateful per-symbol form of computeAllAtomicValues().
+//
+// The batch function recomputes every indicator over the whole history on
+// each tick. This engine keeps the history window plus running state and
+// updates it per tick instead:
+//
+//   O(1)      mean, VWAP, SMA, EMA, MACD (line and signal), Bollinger,
+//             RSI, ATR, momentum/ROC, volume average, OBV,
+//             volatility rank; high/low amortized O(1)
+//   O(log n)  median (two balanced multisets over the window)
+//
+// Output keys, their order and the window semantics match the batch
+// function exactly — EMAs are still seeded at the oldest tick in the
+// window, which the sliding update corrects for in closed form — so the
+// two agree to rounding (see tests/core/IncrementalTATest.cpp).
+// Running sums are rebuilt from the window every `window` ticks to keep
+// add/subtract drift bounded; that costs O(1) amortized, and the rebuild
+// runs over the price / volume column spans through the util::simd kernels.
+//
+// The windows are HistoryStore columns, one aligned array per tick field:
+// price and volume are normally the symbol's shared "lastPrice" / "volume"
+// series, so the Dispatcher's FunctionMap path reads the same data instead
+// of keeping a copy. Bid, ask and timestamp are the engine's own columns,
+// evicted in step with price; no indicator reads them yet, but they are
+// exposed as spans for those that will.
+//
+// Not thread-safe; MarketTickComputer drives one per symbol under the
+// series lock.
+class IncrementalTA {
+public:
+  using Results = std::vector<std::pair<std::string, ArgType>>;
+
+  // `window` is the history cap (Config::taHistoryMax). With
+  // `indicators` false only the history, open/high/low are maintained —
+  // the MarketFieldMap::taEnabled = false path. Keeps its own columns.
+  IncrementalTA(const util::Config& cfg, std::size_t window, bool indicators = true);
+
+  // Uses `prices` / `volumes` as its windows and must be their only
+  // writer; both are cleared. They must outlive the engine.
+  IncrementalTA(const util::Config& cfg, std::size_t window, bool indicators,
+                HistoryStore::Column& prices, HistoryStore::Column& volumes);
+
+  // Append one tick, evicting the oldest past `window`.
+  void push(const TickEntry& e);
+
+  // Replace `out` with the current values, in computeAllAtomicValues()
+  // order. Empty before the first tick or when the TA config is invalid
+  // (a zero or negative period).
+  void results(Results& out) const;
+
+  std::span<const double> prices()  const noexcept { return px_->values(); }
+  std::span<const double> volumes() const noexcept { return vol_->values(); }
+  std::span<const double> bids()    const noexcept { return bid_.values(); }
+  std::span<const double> asks()    const noexcept { return ask_.values(); }
+  std::span<const std::uint64_t> timestamps() const noexcept { return ts_.values(); }
+  std::size_t size()  const noexcept { return px_->size(); }
+  double      open()  const noexcept;
+  double      high()  const noexcept;
+  double      low()   const noexcept;
+
+private:
+  struct Sma      { std::size_t period; double sum = 0; std::string key; };
+  struct Ema      { std::size_t period; double k, a, aWindow; double val = 0; std::string key; };
+  struct Extremum { std::uint64_t seq; double price; };
+
+  IncrementalTA(const util::Config& cfg, std::size_t window, bool indicators,
+                HistoryStore::Column* prices, HistoryStore::Column* volumes);
+
+  double price(std::size_t i)  const noexcept { return (*px_)[i]; }
+  double volume(std::size_t i) const noexcept { return (*vol_)[i]; }
+
+  void pushIndicators(const TickEntry& e);
+  void evictIndicators();
+  void resync();
+  double median() const;
+
+  const std::size_t window_;
+  const bool        indicators_;
+  bool              valid_ = true;
+
+  // Price / volume windows, plus transiently the tick being evicted.
+  // own* are set when no external columns were given.
+  std::unique_ptr<HistoryStore::Column> ownPx_, ownVol_;
+  HistoryStore::Column*                 px_;
+  HistoryStore::Column*                 vol_;
+  HistoryStore::Column                  bid_, ask_;
+  HistoryStore::StampColumn             ts_;
+
+  std::uint64_t seq_ = 0;               // ticks pushed so far
+  std::uint64_t sinceResync_ = 0;
+
+  // open / high / low
+  std::deque<Extremum> maxq_, minq_;     // monotonic, window-scoped
+
+  // Whole-window sums: mean, VWAP, OBV
+  double      sumPx_ = 0, sumPV_ = 0, sumVol_ = 0, obv_ = 0;
+  std::size_t volPos_ = 0;              // ticks with volume > 0 (VWAP defined)
+
+  // Median: lo_ holds the smaller half (and the extra element when odd)
+  std::multiset<double> lo_, hi_;
+
+  std::vector<Sma> sma_;
+  std::vector<Ema> ema_;
+
+  // Bollinger / volatility_rank over the last bbN prices, shifted by
+  // bbShift_ (reset on resync) so the sum of squares doesn't cancel.
+  std::size_t bbN_ = 0;
+  double      bbK_ = 0;
+  double      bbShift_ = 0, bbSum_ = 0, bbSumSq_ = 0;
+
+  // RSI and ATR over the last P close-to-close changes
+  std::size_t rsiP_ = 0, atrP_ = 0, momP_ = 0, volP_ = 0;
+  double      rsiGain_ = 0, rsiLoss_ = 0, atrSum_ = 0, volSum_ = 0;
+
+  // MACD. Window EMAs are expressed through unseeded running EMAs U
+  // (U_t = a U_{t-1} + k x_t, U_{-1} = 0): an EMA seeded at window start
+  // t0 is U_t + a^(t-t0) (x_t0 - U_t0). uHist_ keeps U per window tick;
+  // the signal is a sliding geometric sum over the unseeded MACD series
+  // (muRing_) plus the seed terms in closed form.
+  std::size_t macdFast_ = 0, macdSlow_ = 0, macdSig_ = 0;
+  double      kF_ = 0, aF_ = 0, kS_ = 0, aS_ = 0, kSig_ = 0, aSig_ = 0;
+  double      aSigPow_ = 0;             // aSig^(sig-1)
+  double      sigCF_ = 0, sigCS_ = 0;   // sum_j c_j aF^j, sum_j c_j aS^j
+  double      uF_ = 0, uS_ = 0, sigR_ = 0;
+  std::deque<std::pair<double, double>> uHist_;
+  std::deque<double>                    muRing_;   // newest macdSig unseeded MACD values
+
+  // Keys, built once
+  std::string rsiKey_, momKey_, rocKey_, atrKey_, volAvgKey_;
+};
+
+} // namespace gma::ta
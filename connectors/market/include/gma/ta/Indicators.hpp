@@ -5,6 +5,9 @@
 #include <cmath>
 #include <algorithm>
 #include <utility>
+#include <span>
+
+#include "gma/util/VectorKernels.hpp"
 
 namespace gma::ta {
 
@@ -55,6 +58,56 @@ inline double median_lastN(const std::deque<double>& xs, size_t N) {
   return 0.5 * (tmp[N/2 - 1] + tmp[N/2]);
 }
 
+// ------- Same aggregations on contiguous columns -------
+// For HistoryStore column spans (Column::values()): the window is contiguous,
+// so the scans go through the util::simd kernels. Results match the deque
+// versions within the kernels' reassociation tolerance (min/max exactly).
+
+inline std::span<const double> lastN(std::span<const double> xs, size_t N) {
+  return xs.subspan(xs.size() - N);
+}
+
+inline double sma_lastN(std::span<const double> xs, size_t N) {
+  if (N==0 || xs.size() < N) return NaN();
+  return util::simd::sum(lastN(xs, N).data(), N) / double(N);
+}
+
+inline double min_lastN(std::span<const double> xs, size_t N) {
+  if (N==0 || xs.size() < N) return NaN();
+  return util::simd::minMax(lastN(xs, N).data(), N).min;
+}
+
+inline double max_lastN(std::span<const double> xs, size_t N) {
+  if (N==0 || xs.size() < N) return NaN();
+  return util::simd::minMax(lastN(xs, N).data(), N).max;
+}
+
+inline double stddev_lastN(std::span<const double> xs, size_t N) {
+  double mean = sma_lastN(xs, N);
+  if (!isFinite(mean)) return NaN();
+  return std::sqrt(util::simd::sumSqDev(lastN(xs, N).data(), N, mean) / double(N));
+}
+
+inline double median_lastN(std::span<const double> xs, size_t N) {
+  if (N==0 || xs.size() < N) return NaN();
+  auto w = lastN(xs, N);
+  std::vector<double> tmp(w.begin(), w.end());
+  auto mid = tmp.begin() + static_cast<std::ptrdiff_t>(N / 2);
+  std::nth_element(tmp.begin(), mid, tmp.end());
+  if (N & 1) return *mid;
+  return 0.5 * (*std::max_element(tmp.begin(), mid) + *mid);
+}
+
+inline double vwap_lastN(std::span<const double> px, std::span<const double> vol, size_t N) {
+  if (N==0 || px.size() < N || vol.size() < N) return NaN();
+  auto p = lastN(px, N), v = lastN(vol, N);
+  double pv=0.0;
+  for (size_t i=0; i<N; ++i) pv += p[i] * v[i];
+  double vs = util::simd::sum(v.data(), N);
+  if (vs<=0.0) return NaN();
+  return pv / vs;
+}
+
 // ------- EMA (incremental) -------
 // If prevEMA is NaN, we initialize EMA with SMA of first N.
 inline double ema_next(double prevEMA, double newX, const std::deque<double>& xs, size_t N) {
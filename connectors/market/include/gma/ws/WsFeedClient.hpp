@@ -76,7 +76,6 @@ private:
 
   // ---- Message handling ----
   void handleMessage(const std::string& text);
-  void dispatchEvent(feed::FeedEvent& evt);
 
   // ---- ASIO plumbing ----
   boost::asio::io_context& ioc_;
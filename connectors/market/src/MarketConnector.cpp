@@ -1,5 +1,6 @@
 #include "gma/market/MarketConnector.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 #include <limits>
 #include <memory>
@@ -8,6 +9,8 @@
 #include <utility>
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -16,18 +19,22 @@
 #include "gma/Dispatcher.hpp"
 #include "gma/MarketTA.hpp"
 #include "gma/atomic/AtomicProviderRegistry.hpp"
+#include "gma/book/DepthStream.hpp"
 #include "gma/book/OrderBookManager.hpp"
 #include "gma/engine/ConfigNamespaceRegistry.hpp"
 #include "gma/engine/EngineRegistries.hpp"
 #include "gma/engine/EventComputerRegistry.hpp"
 #include "gma/engine/IEventComputer.hpp"
 #include "gma/engine/IngressRegistry.hpp"
+#include "gma/engine/StreamRegistry.hpp"
 #include "gma/market/MarketIngress.hpp"
 #include "gma/feed/IFeedAdapter.hpp"
 #include "gma/feed/ItchAdapter.hpp"
+#include "gma/feed/ItchBinaryAdapter.hpp"
 #include "gma/ob/FunctionalSnapshotSource.hpp"
 #include "gma/ob/ObMaterializer.hpp"
 #include "gma/ob/ObProvider.hpp"
+#include "gma/ob/ObPushMaterializer.hpp"
 #include "gma/server/FeedServer.hpp"
 #include "gma/util/Config.hpp"
 #include "gma/util/Logger.hpp"
@@ -37,6 +44,17 @@ namespace gma::market {
 
 namespace {
 
+// Book depth totals (ticks) as ob:: slice totals (prices).
+ob::SideSums toSideSums(const DepthSums& d, double tick) {
+  ob::SideSums out;
+  out.levels = static_cast<double>(d.levels);
+  out.size = static_cast<double>(d.size);
+  out.orders = static_cast<double>(d.orders);
+  out.price = static_cast<double>(d.ticks) * tick;
+  out.notional = static_cast<double>(d.notional) * tick;
+  return out;
+}
+
 // Parse a comma-separated list into a vector<string>, trimming whitespace and
 // dropping empty tokens.
 std::vector<std::string> splitCSV(std::string_view value) {
@@ -120,26 +138,50 @@ void MarketConnector::registerWith(engine::EngineRegistries& reg) {
   if (cfg.allowNegativePrices) {
     _obManager->setAllowNegativePrices(true);
   }
+  _obManager->setHugePages(cfg.bookHugePages);
+  for (const auto& sym : cfg.bookTickLadderSymbols) {
+    LadderConfig ladder{LadderKind::Tick, static_cast<std::size_t>(cfg.bookTickWindow)};
+    if (sym == "*") _obManager->setDefaultLadder(ladder);
+    else            _obManager->setLadder(sym, ladder);
+  }
+  // Depth-limited books ignore the ladder kind, so these win.
+  for (const auto& sym : cfg.bookDepthLimitSymbols) {
+    LadderConfig ladder;
+    ladder.depthLimit = static_cast<std::size_t>(cfg.bookDepthLimit);
+    if (sym == "*") _obManager->setDefaultLadder(ladder);
+    else            _obManager->setLadder(sym, ladder);
+  }
 
   auto obManager = _obManager;
   _snapSource = std::make_shared<ob::FunctionalSnapshotSource>(
     [obManager](const std::string& symbol,
                 std::size_t maxLevels,
                 ob::Mode /*mode*/,
-                std::optional<std::pair<double, double>> /*priceBand*/) -> ob::Snapshot {
+                std::optional<std::pair<double, double>> priceBand) -> ob::Snapshot {
       ob::Snapshot snap;
+      // A band capture reads down to the band's far edge on each side (the
+      // depth index gives that rank) and keeps only in-band levels.
+      constexpr double inf = std::numeric_limits<double>::infinity();
+      double lo = -inf, hi = inf;
+      if (priceBand) {
+        lo = std::min(priceBand->first, priceBand->second);
+        hi = std::max(priceBand->first, priceBand->second);
+        maxLevels = std::max(obManager->depthByPrice(symbol, Side::Bid, lo, inf).levels,
+                             obManager->depthByPrice(symbol, Side::Ask, -inf, hi).levels);
+      }
       auto ds = obManager->buildSnapshot(symbol, maxLevels);
       double tick = obManager->getTickSize(symbol);
-      for (const auto& [px, sz] : ds.bids) {
-        double dpx = static_cast<double>(px.ticks) * tick;
-        snap.bids.levels.push_back({dpx, static_cast<double>(sz),
-            std::numeric_limits<double>::quiet_NaN(), dpx * static_cast<double>(sz)});
-      }
-      for (const auto& [px, sz] : ds.asks) {
-        double dpx = static_cast<double>(px.ticks) * tick;
-        snap.asks.levels.push_back({dpx, static_cast<double>(sz),
-            std::numeric_limits<double>::quiet_NaN(), dpx * static_cast<double>(sz)});
-      }
+      const double eps = 0.5 * tick;
+      auto fill = [&](const auto& levels, ob::Ladder& out) {
+        for (const auto& [px, sz] : levels) {
+          double dpx = static_cast<double>(px.ticks) * tick;
+          if (dpx < lo - eps || dpx > hi + eps) continue;
+          out.levels.push_back({dpx, static_cast<double>(sz),
+              std::numeric_limits<double>::quiet_NaN(), dpx * static_cast<double>(sz)});
+        }
+      };
+      fill(ds.bids, snap.bids);
+      fill(ds.asks, snap.asks);
       snap.meta.seq = ds.seq;
       snap.meta.epoch = ds.epoch;
       snap.meta.bidLevels = snap.bids.levels.size();
@@ -148,6 +190,22 @@ void MarketConnector::registerWith(engine::EngineRegistries& reg) {
     },
     [obManager](const std::string& symbol) -> double {
       return obManager->getTickSize(symbol);
+    },
+    [obManager](const std::string& symbol) -> uint64_t {
+      return obManager->bookVersion(symbol);
+    },
+    // Cumulative / range / band keys read the book's depth index directly.
+    [obManager](const std::string& symbol, ob::Side side, ob::Range r) -> ob::SideSums {
+      const Side s = side == ob::Side::Bid ? Side::Bid : Side::Ask;
+      const auto d = obManager->depthByRank(symbol, s,
+                                            static_cast<std::size_t>(std::max(r.a, 0)),
+                                            static_cast<std::size_t>(std::max(r.b, 0)));
+      return toSideSums(d, obManager->getTickSize(symbol));
+    },
+    [obManager](const std::string& symbol, ob::Side side, double p1, double p2) -> ob::SideSums {
+      const Side s = side == ob::Side::Bid ? Side::Bid : Side::Ask;
+      const auto d = obManager->depthByPrice(symbol, s, std::min(p1, p2), std::max(p1, p2));
+      return toSideSums(d, obManager->getTickSize(symbol));
     });
 
   _obProvider = std::make_shared<ob::Provider>(_snapSource, 10, 10);
@@ -157,14 +215,42 @@ void MarketConnector::registerWith(engine::EngineRegistries& reg) {
     [obProvider](const std::string& symbol, const std::string& fullKey) -> double {
       return obProvider->get(symbol, fullKey);
     });
+  // AtomicAccessors compile their ob.* key once at construction.
+  AtomicProviderRegistry::registerCompiler("ob",
+    [obProvider](const std::string& fullKey) -> AtomicProviderRegistry::CompiledFn {
+      auto key = obProvider->compile(fullKey);
+      if (!key) return {};
+      return [obProvider, k = *key](const std::string& symbol) -> double {
+        return obProvider->eval(symbol, k);
+      };
+    });
 
-  // Register the two market ingress factories. Engine driver instantiates
+  // ob.* is subscribable: the dispatcher reports which keys have
+  // listeners, book deltas drive re-evaluation of just those keys.
+  auto* dispatcher = reg.dispatcher;
+  _obPush = ob::PushMaterializer::create(_obManager, _obProvider,
+    [dispatcher](const std::string& symbol, const std::string& key, double value) {
+      dispatcher->notifyListeners(symbol, key, value);
+    });
+  std::weak_ptr<ob::PushMaterializer> obPush = _obPush;
+  dispatcher->observeSubscriptions("ob.",
+    [obPush](const std::string& symbol, const std::string& field, bool subscribed) {
+      auto push = obPush.lock();
+      if (!push) return;
+      if (subscribed) push->subscribe(symbol, field);
+      else            push->unsubscribe(symbol, field);
+    },
+    [](const std::string& field) { return ob::parseObKey(field).has_value(); });
+
+  // Register the market ingress factories. Engine driver instantiates
   // each entry of cfg.ingress[] whose kind matches; factories close over
   // the connector-owned OrderBookManager so feed handlers can write into
-  // it directly. Per-entry params (port, url, adapter, symbols) come from
-  // the parsed ingress.N.* sub-keys.
+  // it directly. Per-entry params (port, url, adapter, symbols, path) come from
+  // the parsed ingress.N.* sub-keys. The feed server also gets the field
+  // map, read when the source is built (after dispatchPendingKeys), so it
+  // decodes ticks the way the tick computer would.
   reg.ingress->registerIngress("market.feedserver",
-    [obManager](engine::EngineRegistries& r,
+    [obManager, fieldMap](engine::EngineRegistries& r,
                 const engine::IngressParams& params) -> std::unique_ptr<engine::IIngressSource> {
       unsigned short port = 9001;
       auto pit = params.find("port");
@@ -172,7 +258,8 @@ void MarketConnector::registerWith(engine::EngineRegistries& reg) {
         try { port = static_cast<unsigned short>(std::stoi(pit->second)); }
         catch (...) {}
       }
-      auto fs = std::make_unique<FeedServer>(*r.io, r.dispatcher, obManager.get(), port);
+      auto fs = std::make_unique<FeedServer>(*r.io, r.dispatcher, obManager.get(),
+                                             *fieldMap, port);
       return std::make_unique<FeedServerIngress>(std::move(fs));
     });
 
@@ -197,8 +284,8 @@ void MarketConnector::registerWith(engine::EngineRegistries& reg) {
       if (symbols.empty()) symbols = {"*"};
 
       std::unique_ptr<feed::IFeedAdapter> ad;
-      if (adapter == "itch") ad = std::make_unique<feed::ItchAdapter>();
-      else                   ad = std::make_unique<feed::ItchAdapter>();  // default ITCH
+      if (adapter == "itch-binary") ad = std::make_unique<feed::ItchBinaryAdapter>();
+      else                          ad = std::make_unique<feed::ItchAdapter>();  // default ITCH (JSON)
 
       auto client = std::make_shared<ws::WsFeedClient>(
           *r.io, r.dispatcher, obManager.get(),
@@ -206,6 +293,45 @@ void MarketConnector::registerWith(engine::EngineRegistries& reg) {
       return std::make_unique<WsFeedClientIngress>(std::move(client));
     });
 
+  // Binary ITCH 5.0 file replay: ingress.N.path names the file.
+  reg.ingress->registerIngress("market.itchreplay",
+    [obManager](engine::EngineRegistries& r,
+                const engine::IngressParams& params) -> std::unique_ptr<engine::IIngressSource> {
+      auto pit = params.find("path");
+      if (pit == params.end() || pit->second.empty()) {
+        throw std::runtime_error("market.itchreplay: 'path' is required");
+      }
+      return std::make_unique<ItchReplayIngress>(pit->second, r.dispatcher, obManager.get());
+    });
+
+  // "depth" client streams: a binary top-N ladder per WS subscription,
+  // snapshot first, then conflated per-level changes every flushMs.
+  auto* io = reg.io;
+  reg.streams->registerStream("depth",
+    [obManager, io](const std::string& symbol, std::uint32_t streamId,
+                    const engine::StreamParams& params,
+                    engine::StreamSink sink) -> std::unique_ptr<engine::IStream> {
+      constexpr long MAX_LEVELS = 1000, MAX_FLUSH_MS = 10'000;
+      auto param = [&params](const char* name, long def, long lo, long hi) {
+        auto it = params.find(name);
+        if (it == params.end()) return def;
+        long v = 0;
+        try { v = std::stol(it->second); } catch (...) { v = lo - 1; }
+        if (v < lo || v > hi) {
+          throw std::runtime_error(std::string("depth: '") + name + "' must be "
+                                   + std::to_string(lo) + ".." + std::to_string(hi));
+        }
+        return v;
+      };
+      const long levels  = param("levels", 10, 1, MAX_LEVELS);
+      const long flushMs = param("flushMs", 50, 1, MAX_FLUSH_MS);
+      auto streamer = DepthStreamer::create(obManager, symbol, streamId,
+                                            static_cast<std::size_t>(levels), std::move(sink));
+      if (!streamer) throw std::runtime_error("depth: unknown symbol '" + symbol + "'");
+      return std::make_unique<DepthStreamSource>(*io, std::move(streamer),
+                                                 std::chrono::milliseconds(flushMs));
+    });
+
   // Register the "tick" computer factory through the engine registry. Each
   // Dispatcher's onTick lazily instantiates one MarketTickComputer per type
   // using the dispatcher's own cfg + this connector's configured field map.
@@ -239,6 +365,7 @@ void MarketConnector::stop() noexcept {
   // WsFeedClient — same temporal sequence as the pre-ENC-31 per-step
   // priorities (ob-provider-clear=50, feed-stop=55, feed-ws-stop=56).
   try { AtomicProviderRegistry::clear(); } catch (...) {}
+  if (_obPush) _obPush->stop();
 }
 
 } // namespace gma::market
@@ -1,7 +1,21 @@
 #include "gma/market/MarketIngress.hpp"
 
+#include <algorithm>
+#include <atomic>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+
+#include "gma/book/DepthStream.hpp"
+#include "gma/feed/FeedRouter.hpp"
 #include "gma/feed/IFeedAdapter.hpp"
+#include "gma/feed/ItchBinaryAdapter.hpp"
 #include "gma/server/FeedServer.hpp"
+#include "gma/util/Logger.hpp"
+#include "gma/util/MappedFile.hpp"
+#include "gma/util/Metrics.hpp"
 #include "gma/ws/WsFeedClient.hpp"
 
 namespace gma::market {
@@ -44,4 +58,132 @@ void WsFeedClientIngress::stop() noexcept {
   started_ = false;
 }
 
+// ---------- ItchReplayIngress ----------
+
+ItchReplayIngress::ItchReplayIngress(const std::string& path,
+                                     Dispatcher* dispatcher,
+                                     OrderBookManager* obManager)
+  : file_(std::make_unique<util::MappedFile>(path)),
+    dispatcher_(dispatcher), obManager_(obManager) {}
+
+ItchReplayIngress::~ItchReplayIngress() { stop(); }
+
+void ItchReplayIngress::start() {
+  if (thread_.joinable() || finished_.load()) return;
+  stopping_.store(false);
+  thread_ = std::thread([this] { run(); });
+}
+
+void ItchReplayIngress::stop() noexcept {
+  stopping_.store(true);
+  if (thread_.joinable()) {
+    try { thread_.join(); } catch (...) {}
+  }
+}
+
+void ItchReplayIngress::run() {
+  // Batches of whole messages (the longest ITCH message fits many times
+  // over); events are routed and metrics published once per batch.
+  constexpr std::size_t kBatchBytes = 256 * 1024;
+
+  feed::ItchBinaryAdapter adapter;
+  feed::ItchBinaryAdapter::Stats published;
+  std::vector<feed::FeedEvent> events;
+  const uint8_t* data = file_->data();
+  const std::size_t size = file_->size();
+  const auto t0 = std::chrono::steady_clock::now();
+
+  std::size_t pos = 0;
+  while (pos < size && !stopping_.load(std::memory_order_relaxed)) {
+    const std::size_t n = std::min(kBatchBytes, size - pos);
+    const std::size_t used = adapter.decode(data + pos, n, events);
+    if (used == 0) break;                   // truncated final message
+    pos += used;
+
+    try {
+      feed::routeFeedEvents(events, dispatcher_, obManager_);
+    } catch (const std::exception& ex) {
+      util::logger().log(util::LogLevel::Error, "itch_replay.route exception",
+                         {{"err", ex.what()}});
+    }
+    events.clear();
+
+    const auto& st = adapter.stats();
+    GMA_METRIC_INC("feed_itch.messages",    double(st.messages   - published.messages));
+    GMA_METRIC_INC("feed_itch.skipped",     double(st.skipped    - published.skipped));
+    GMA_METRIC_INC("feed_itch.malformed",   double(st.malformed  - published.malformed));
+    GMA_METRIC_INC("feed_itch.unknown_ref", double(st.unknownRef - published.unknownRef));
+    published = st;
+  }
+
+  const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  util::logger().log(util::LogLevel::Info, "itch_replay.done",
+    {{"messages", std::to_string(adapter.stats().messages)},
+     {"bytes", std::to_string(pos)},
+     {"trailing", std::to_string(size - pos)},
+     {"seconds", std::to_string(secs)}});
+  if (pos == size || !stopping_.load()) finished_.store(true);
+}
+
+// ---------- DepthStreamSource ----------
+
+// Timer and flushes run on one strand; pending waits keep the loop alive
+// past the owning source, and bail out once stopped.
+struct DepthStreamSource::Loop : std::enable_shared_from_this<DepthStreamSource::Loop> {
+  Loop(boost::asio::io_context& io, std::shared_ptr<DepthStreamer> s,
+       std::chrono::milliseconds every)
+    : strand(boost::asio::make_strand(io)), timer(strand),
+      streamer(std::move(s)), period(every) {}
+
+  void arm() {
+    timer.expires_after(period);
+    timer.async_wait([self = shared_from_this()](const boost::system::error_code& ec) {
+      if (ec || self->stopped.load()) return;
+      self->streamer->flush();
+      self->arm();
+    });
+  }
+
+  boost::asio::strand<boost::asio::io_context::executor_type> strand;
+  boost::asio::steady_timer  timer;
+  std::shared_ptr<DepthStreamer> streamer;
+  std::chrono::milliseconds  period;
+  std::atomic<bool>          started{false};
+  std::atomic<bool>          stopped{false};
+};
+
+DepthStreamSource::DepthStreamSource(boost::asio::io_context& io,
+                                     std::shared_ptr<DepthStreamer> streamer,
+                                     std::chrono::milliseconds flushEvery)
+  : loop_(std::make_shared<Loop>(io, std::move(streamer), flushEvery)) {}
+
+DepthStreamSource::~DepthStreamSource() { stop(); }
+
+void DepthStreamSource::start() {
+  if (loop_->started.exchange(true) || loop_->stopped.load()) return;
+  boost::asio::post(loop_->strand, [loop = loop_] {
+    if (loop->stopped.load()) return;
+    loop->streamer->flush();    // initial snapshot
+    loop->arm();
+  });
+}
+
+tree::TreeCost DepthStreamSource::cost() const {
+  const auto levels = static_cast<double>(loop_->streamer->levels());
+  const auto ms     = static_cast<double>(std::max<std::int64_t>(1, loop_->period.count()));
+  tree::TreeCost c;
+  c.tickWork   = 1;
+  c.timerWork  = 2 * levels * 1000.0 / ms;
+  c.stateBytes = 256 + static_cast<std::uint64_t>(2 * levels * 2 * sizeof(std::pair<Price, uint64_t>));
+  return c;
+}
+
+void DepthStreamSource::stop() noexcept {
+  if (loop_->stopped.exchange(true)) return;
+  try {
+    loop_->streamer->stop();
+    boost::asio::post(loop_->strand, [loop = loop_] { loop->timer.cancel(); });
+  } catch (...) {}
+}
+
 } // namespace gma::market
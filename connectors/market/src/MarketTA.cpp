@@ -12,6 +12,7 @@
 #include <limits>
 #include <numeric>
 #include <type_traits>
+#include <utility>
 
 namespace gma {
 
@@ -284,8 +285,10 @@ void initSkipFields(std::unordered_set<std::string>& dst) {
 MarketTickComputer::MarketTickComputer(const util::Config& cfg)
   : _cfg(cfg)
   , _fieldMap()  // default field-map (NASDAQ-style names)
+  , _decoder(_fieldMap)
   , _maxHistory(static_cast<std::size_t>(std::max(1, cfg.taHistoryMax)))
   , _maxSymbols(static_cast<std::size_t>(std::max(1, cfg.maxSymbols)))
+  , _ownHistory(_maxHistory, _maxSymbols, 2)
 {
   initSkipFields(_skipFields);
 }
@@ -294,111 +297,264 @@ MarketTickComputer::MarketTickComputer(const util::Config& cfg,
                                        market::MarketFieldMap fieldMap)
   : _cfg(cfg)
   , _fieldMap(std::move(fieldMap))
+  , _decoder(_fieldMap)
   , _maxHistory(static_cast<std::size_t>(std::max(1, cfg.taHistoryMax)))
   , _maxSymbols(static_cast<std::size_t>(std::max(1, cfg.maxSymbols)))
+  , _ownHistory(_maxHistory, _maxSymbols, 2)
 {
   initSkipFields(_skipFields);
 }
 
+MarketTickComputer::~MarketTickComputer() {
+  std::unique_lock<std::mutex> lock(_drainMutex);
+  _drainIdle.wait(lock, [this] { return _drainsInFlight == 0; });
+}
+
+bool MarketTickComputer::parse(const Event& tick, Sample& out) const {
+  if (tick.decoded) {
+    out.tick = *static_cast<const TickEntry*>(tick.decoded.get());
+  } else if (!tick.payload || !_decoder.decode(*tick.payload, out.tick)) {
+    return false;
+  }
+  out.symbol = &tick.symbol;
+  return true;
+}
+
+MarketTickComputer::SymbolState* MarketTickComputer::stateFor(const std::string& symbol,
+                                                              HistoryStore& history,
+                                                              bool claim) {
+  {
+    std::shared_lock<std::shared_mutex> lock(_symbolsMutex);
+    auto it = _symbols.find(symbol);
+    if (it != _symbols.end()) return it->second.get();
+    if (_symbols.size() >= _maxSymbols) return nullptr;
+  }
+  std::unique_lock<std::shared_mutex> lock(_symbolsMutex);
+  auto it = _symbols.find(symbol);
+  if (it != _symbols.end()) return it->second.get();
+  if (_symbols.size() >= _maxSymbols) return nullptr;
+
+  HistoryStore::Series* series = history.series(symbol);
+  if (!series) return nullptr;
+
+  // Feed the series' lastPrice / volume columns. If either is taken (a
+  // second computer on the same dispatcher), over the column cap, or not
+  // to be claimed, the engine keeps private columns instead.
+  std::unique_lock<std::shared_mutex> seriesLock(series->mutex());
+  HistoryStore::Column* px  = claim ? series->claim("lastPrice", this) : nullptr;
+  HistoryStore::Column* vol = px ? series->claim("volume", this) : nullptr;
+  std::unique_ptr<SymbolState> st;
+  if (px && vol) {
+    st = std::make_unique<SymbolState>(
+        *series, ta::IncrementalTA(_cfg, _maxHistory, _fieldMap.taEnabled, *px, *vol));
+  } else {
+    if (px) series->release("lastPrice", this);
+    st = std::make_unique<SymbolState>(
+        *series, ta::IncrementalTA(_cfg, _maxHistory, _fieldMap.taEnabled));
+  }
+  return _symbols.emplace(symbol, std::move(st)).first->second.get();
+}
+
 void MarketTickComputer::compute(const Event& tick, engine::ComputeContext& ctx) {
-  if (!ctx.store || !tick.payload) return;
-
-  const auto& doc = *tick.payload;
-
-  // Extract price via configured field aliases.
-  double price = 0.0;
-  bool hasPrice = false;
-  for (const auto& pf : _fieldMap.priceFields) {
-    if (doc.HasMember(pf.c_str()) && doc[pf.c_str()].IsNumber()) {
-      price = doc[pf.c_str()].GetDouble();
-      hasPrice = true;
-      break;
-    }
+  computeBatch(std::span<const Event>(&tick, 1), ctx);
+}
+
+void MarketTickComputer::computeBatch(std::span<const Event> ticks,
+                                      engine::ComputeContext& ctx) {
+  if (!ctx.store) return;
+
+  std::vector<Sample> samples;
+  samples.reserve(ticks.size());
+  for (const auto& t : ticks) {
+    Sample s;
+    if (parse(t, s)) samples.push_back(s);
   }
-  if (!hasPrice) return;
-
-  // Extract optional volume / bid / ask / timestamp.
-  double volume = 0.0;
-  for (const auto& vf : _fieldMap.volumeFields) {
-    if (doc.HasMember(vf.c_str()) && doc[vf.c_str()].IsNumber()) {
-      volume = doc[vf.c_str()].GetDouble();
-      break;
+  if (samples.empty()) return;
+
+  // Group by symbol in first-touch order; each symbol's samples are a
+  // chain head → next[] → tail, oldest first.
+  constexpr std::size_t NONE = static_cast<std::size_t>(-1);
+  struct Touched {
+    const std::string* symbol;   // into `ticks`, stable for the call
+    std::size_t        head;
+    std::size_t        tail;
+  };
+  std::vector<Touched> touched;
+  std::vector<std::size_t> next(samples.size(), NONE);
+
+  // Linear scan while the batch is small; index once it isn't.
+  constexpr std::size_t SCAN_LIMIT = 16;
+  std::unordered_map<std::string_view, std::size_t> index;
+  for (std::size_t i = 0; i < samples.size(); ++i) {
+    const std::string& symbol = *samples[i].symbol;
+    std::size_t slot = touched.size();
+    if (index.empty()) {
+      for (std::size_t k = 0; k < touched.size(); ++k)
+        if (*touched[k].symbol == symbol) { slot = k; break; }
+    } else if (auto it = index.find(symbol); it != index.end()) {
+      slot = it->second;
     }
-  }
-  double bid = 0.0, ask = 0.0;
-  std::uint64_t tsNs = 0;
-  for (const auto& bf : _fieldMap.bidFields) {
-    if (doc.HasMember(bf.c_str()) && doc[bf.c_str()].IsNumber()) {
-      bid = doc[bf.c_str()].GetDouble();
-      break;
+
+    if (slot < touched.size()) {
+      next[touched[slot].tail] = i;
+      touched[slot].tail = i;
+      continue;
     }
-  }
-  for (const auto& af : _fieldMap.askFields) {
-    if (doc.HasMember(af.c_str()) && doc[af.c_str()].IsNumber()) {
-      ask = doc[af.c_str()].GetDouble();
-      break;
+    touched.push_back(Touched{&symbol, i, i});
+    if (touched.size() > SCAN_LIMIT) {
+      if (index.empty())
+        for (std::size_t k = 0; k < touched.size(); ++k) index.emplace(*touched[k].symbol, k);
+      else
+        index.emplace(symbol, slot);
     }
   }
-  if (!_fieldMap.timestampField.empty() &&
-      doc.HasMember(_fieldMap.timestampField.c_str()) &&
-      doc[_fieldMap.timestampField.c_str()].IsUint64()) {
-    tsNs = doc[_fieldMap.timestampField.c_str()].GetUint64();
-  }
-
-  if (bid > 0.0) ctx.store->set(tick.symbol, "bid", bid);
-  if (ask > 0.0) ctx.store->set(tick.symbol, "ask", ask);
-  if (bid > 0.0 && ask > 0.0) ctx.store->set(tick.symbol, "spread", ask - bid);
-  if (tsNs > 0) ctx.store->set(tick.symbol, "timestamp", std::to_string(tsNs));
 
-  // Update symbol history under lock; snapshot into contiguous vec for TA.
-  std::vector<TickEntry> histVec;
-  {
-    std::unique_lock<std::shared_mutex> lock(_histMutex);
-    if (_symbolHistories.find(tick.symbol) == _symbolHistories.end() &&
-        _symbolHistories.size() >= _maxSymbols) {
-      return;
+  HistoryStore& history = ctx.history ? *ctx.history : _ownHistory;
+  const bool parallel = _cfg.taParallel && ctx.pool;
+  // One store write per tick, in arrival order, so every tick publishes
+  // its own values exactly as compute() would.
+  std::vector<std::pair<std::string, AtomicStore::FieldBatch>> writes(samples.size());
+  std::vector<std::size_t> taBegin(samples.size(), 0);
+  std::vector<TickEntry> run;
+  std::vector<std::size_t> slots;
+  bool any = false;
+  for (const auto& t : touched) {
+    run.clear();
+    slots.clear();
+    for (std::size_t i = t.head; i != NONE; i = next[i]) {
+      run.push_back(samples[i].tick);
+      slots.push_back(i);
+    }
+    // Queued TA would update claimed columns after the dispatcher has
+    // already fanned this tick out, so parallel mode leaves them raw.
+    SymbolState* st = stateFor(*t.symbol, history, !parallel);
+
+    if (parallel && st) {
+      bool post = false;
+      {
+        std::lock_guard<std::mutex> lock(st->queueMutex);
+        st->pending.insert(st->pending.end(), run.begin(), run.end());
+        post = !std::exchange(st->scheduled, true);
+      }
+      if (post) {
+        {
+          std::lock_guard<std::mutex> lock(_drainMutex);
+          ++_drainsInFlight;
+        }
+        ctx.pool->post([this, st, symbol = *t.symbol, ctx] { drain(symbol, *st, ctx); });
+      }
+      continue;
     }
-    auto& hist = _symbolHistories[tick.symbol];
-    hist.push_back(TickEntry{price, volume, bid, ask, tsNs});
-    if (hist.size() > _maxHistory) hist.pop_front();
-    histVec.assign(hist.begin(), hist.end());
+
+    // Quote fields are written even for symbols past the cap (st null).
+    for (std::size_t slot : slots) writes[slot].first = *t.symbol;
+    evaluate(st, run, slots, writes, taBegin);
+    any = true;
   }
 
-  // Run TA suite or fall back to lightweight base metrics.
-  std::vector<std::pair<std::string, ArgType>> taResults;
-  if (_fieldMap.taEnabled) {
-    taResults = computeAllAtomicValues(tick.symbol, histVec, *ctx.store, _cfg);
-  } else {
-    taResults.emplace_back("lastPrice", price);
-    taResults.emplace_back("volume", volume);
-    if (!histVec.empty()) {
-      taResults.emplace_back("openPrice", histVec.front().price);
-      double high = histVec.front().price, low = high;
-      for (const auto& e : histVec) {
-        high = std::max(high, e.price);
-        low  = std::min(low, e.price);
-      }
-      taResults.emplace_back("highPrice", high);
-      taResults.emplace_back("lowPrice", low);
+  if (any) publish(writes, taBegin, ctx);
+}
+
+void MarketTickComputer::evaluate(
+    SymbolState* st, std::span<const TickEntry> ticks, std::span<const std::size_t> slots,
+    std::vector<std::pair<std::string, AtomicStore::FieldBatch>>& writes,
+    std::vector<std::size_t>& taBegin) {
+  for (std::size_t k = 0; k < ticks.size(); ++k) {
+    const TickEntry& e = ticks[k];
+    auto& out = writes[slots[k]].second;
+    if (e.bid > 0.0) out.emplace_back("bid", e.bid);
+    if (e.ask > 0.0) out.emplace_back("ask", e.ask);
+    if (e.bid > 0.0 && e.ask > 0.0 && e.ask - e.bid > 0.0)
+      out.emplace_back("spread", e.ask - e.bid);
+    if (e.timestampNs > 0) out.emplace_back("timestamp", std::to_string(e.timestampNs));
+    taBegin[slots[k]] = out.size();
+  }
+  if (!st || ticks.empty()) return;
+
+  // One lock for the run; each tick's results are taken right after it
+  // is pushed, so none of the intermediate values are lost.
+  std::unique_lock<std::shared_mutex> lock(st->series.mutex());
+  ta::IncrementalTA::Results taResults;
+  for (std::size_t k = 0; k < ticks.size(); ++k) {
+    const TickEntry& e = ticks[k];
+    auto& out = writes[slots[k]].second;
+    st->ta.push(e);
+
+    // Run TA suite or fall back to lightweight base metrics.
+    if (_fieldMap.taEnabled) {
+      st->ta.results(taResults);
+      out.insert(out.end(), std::make_move_iterator(taResults.begin()),
+                 std::make_move_iterator(taResults.end()));
+    } else {
+      out.emplace_back("lastPrice", e.price);
+      out.emplace_back("volume", e.volume);
+      out.emplace_back("openPrice", st->ta.open());
+      out.emplace_back("highPrice", st->ta.high());
+      out.emplace_back("lowPrice", st->ta.low());
     }
-    ctx.store->setBatch(tick.symbol, taResults);
   }
+}
 
-  if (taResults.empty() || !ctx.dispatcher) return;
+void MarketTickComputer::publish(
+    const std::vector<std::pair<std::string, AtomicStore::FieldBatch>>& writes,
+    const std::vector<std::size_t>& taBegin,
+    engine::ComputeContext& ctx) const {
+  // Single store write for the whole batch.
+  ctx.store->setBatches(writes);
+  if (!ctx.dispatcher) return;
 
   // Notify TA-indicator listeners (sma_N, rsi_N, macd_*, bollinger_*, …).
   // When TA is enabled we skip raw/FunctionMap names to avoid double-notify;
   // when disabled the lightweight path IS the only source, so notify those.
-  for (const auto& [key, val] : taResults) {
-    if (_fieldMap.taEnabled && _skipFields.count(key)) continue;
-    double v = std::visit([](auto&& x) -> double {
-      using T = std::decay_t<decltype(x)>;
-      if constexpr (std::is_same_v<T, double>) return x;
-      else if constexpr (std::is_same_v<T, int>) return static_cast<double>(x);
-      else return 0.0;
-    }, val);
-    ctx.dispatcher->notifyListeners(tick.symbol, key, v);
+  for (std::size_t i = 0; i < writes.size(); ++i) {
+    const auto& [symbol, fields] = writes[i];
+    for (std::size_t k = taBegin[i]; k < fields.size(); ++k) {
+      const auto& [key, val] = fields[k];
+      if (_fieldMap.taEnabled && _skipFields.count(key)) continue;
+      double v = std::visit([](auto&& x) -> double {
+        using T = std::decay_t<decltype(x)>;
+        if constexpr (std::is_same_v<T, double>) return x;
+        else if constexpr (std::is_same_v<T, int>) return static_cast<double>(x);
+        else return 0.0;
+      }, val);
+      ctx.dispatcher->notifyListeners(symbol, key, v);
+    }
+  }
+}
+
+void MarketTickComputer::drain(const std::string& symbol, SymbolState& st,
+                               engine::ComputeContext ctx) {
+  std::vector<std::pair<std::string, AtomicStore::FieldBatch>> writes;
+  std::vector<std::size_t> taBegin;
+  std::vector<std::size_t> slots;
+  std::vector<TickEntry> run;
+  try {
+    for (;;) {
+      {
+        std::lock_guard<std::mutex> lock(st.queueMutex);
+        if (st.pending.empty()) { st.scheduled = false; break; }
+        run.swap(st.pending);
+      }
+      writes.assign(run.size(), {symbol, AtomicStore::FieldBatch{}});
+      taBegin.assign(run.size(), 0);
+      slots.resize(run.size());
+      for (std::size_t i = 0; i < slots.size(); ++i) slots[i] = i;
+      evaluate(&st, run, slots, writes, taBegin);
+      run.clear();
+      publish(writes, taBegin, ctx);
+    }
+  } catch (const std::exception& ex) {
+    // The run being applied is lost; ticks still pending wait for the
+    // next tick on this symbol to post a fresh task.
+    gma::util::logger().log(gma::util::LogLevel::Error,
+                            "MarketTickComputer: TA task exception",
+                            {{"symbol", symbol}, {"err", ex.what()}});
+    std::lock_guard<std::mutex> lock(st.queueMutex);
+    st.scheduled = false;
   }
+
+  std::lock_guard<std::mutex> lock(_drainMutex);
+  if (--_drainsInFlight == 0) _drainIdle.notify_all();
 }
 
 } // namespace gma
@@ -0,0 +1,236 @@
+#include "gma/market/MarketTickDecoder.hpp"
+
+#include "gma/util/Logger.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace gma::market {
+
+namespace {
+
+// Cursor over the raw text for scan(). Every read is bounds-checked;
+// values the caller does not want are delimited, not validated.
+struct Cursor {
+  const char* p;
+  const char* e;
+
+  void ws() {
+    while (p < e && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+  }
+  bool eat(char c) {
+    ws();
+    if (p < e && *p == c) { ++p; return true; }
+    return false;
+  }
+
+  // After an opening quote: up to and past the closing one. `escaped`
+  // reports a backslash in the body.
+  bool string(std::string_view& body, bool& escaped) {
+    const char* s = p;
+    auto* q = static_cast<const char*>(std::memchr(p, '"', static_cast<std::size_t>(e - p)));
+    if (!q) return false;
+    escaped = std::memchr(s, '\\', static_cast<std::size_t>(q - s)) != nullptr;
+    if (escaped) {
+      // The first quote found may be escaped; walk to the real end.
+      for (q = nullptr; p < e; ++p) {
+        if (*p == '"') { q = p; break; }
+        if (*p == '\\' && ++p == e) break;
+      }
+      if (!q) return false;
+    }
+    body = std::string_view(s, static_cast<std::size_t>(q - s));
+    p = q + 1;
+    return true;
+  }
+
+  bool literal(std::string_view word) {
+    if (static_cast<std::size_t>(e - p) < word.size() ||
+        std::string_view(p, word.size()) != word) return false;
+    p += word.size();
+    return true;
+  }
+
+  // Past one value of any type.
+  bool skipValue() {
+    if (p == e) return false;
+    std::string_view body;
+    bool escaped;
+    switch (*p) {
+      case '"': ++p; return string(body, escaped);
+      case '{': case '[': {
+        int depth = 0;
+        while (p < e) {
+          const char c = *p++;
+          if (c == '"') { if (!string(body, escaped)) return false; }
+          else if (c == '{' || c == '[') ++depth;
+          else if ((c == '}' || c == ']') && --depth == 0) return true;
+        }
+        return false;
+      }
+      case 't': return literal("true");
+      case 'f': return literal("false");
+      case 'n': return literal("null");
+      default: {
+        const char* s = p;
+        while (p < e && ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' ||
+                         *p == '.' || *p == 'e' || *p == 'E')) ++p;
+        return p != s;
+      }
+    }
+  }
+};
+
+bool isNumberToken(std::string_view t) {
+  return !t.empty() && (t[0] == '-' || (t[0] >= '0' && t[0] <= '9'));
+}
+
+bool parseDouble(std::string_view t, double& out) {
+  if (!isNumberToken(t)) return false;
+  double v;
+  auto [end, ec] = std::from_chars(t.data(), t.data() + t.size(), v);
+  if (ec != std::errc() || end != t.data() + t.size()) return false;
+  out = v;
+  return true;
+}
+
+// An unsigned integer literal (no sign, fraction or exponent) that fits:
+// what rapidjson reports as IsUint64.
+bool parseUint64(std::string_view t, std::uint64_t& out) {
+  if (t.empty() || t[0] < '0' || t[0] > '9') return false;
+  std::uint64_t v;
+  auto [end, ec] = std::from_chars(t.data(), t.data() + t.size(), v);
+  if (ec != std::errc() || end != t.data() + t.size()) return false;
+  out = v;
+  return true;
+}
+
+} // namespace
+
+MarketTickDecoder::MarketTickDecoder(const MarketFieldMap& fm) {
+  auto add = [this](const std::vector<std::string>& names, Field field) {
+    for (std::size_t i = 0; i < names.size(); ++i) {
+      keys_.push_back(Key{names[i], field, static_cast<std::uint8_t>(i)});
+    }
+  };
+  add(fm.priceFields,  kPrice);
+  add(fm.volumeFields, kVolume);
+  add(fm.bidFields,    kBid);
+  add(fm.askFields,    kAsk);
+  if (!fm.timestampField.empty()) add({fm.timestampField}, kTimestamp);
+
+  if (keys_.size() > kMaxKeys) {
+    gma::util::logger().log(gma::util::LogLevel::Warn,
+      "MarketTickDecoder: field map too wide for a single pass; probing aliases",
+      {{"aliases", std::to_string(keys_.size())}, {"max", std::to_string(kMaxKeys)}});
+    probe_.swap(keys_);
+    return;
+  }
+  std::stable_sort(keys_.begin(), keys_.end(), [](const Key& a, const Key& b) {
+    return a.name.size() < b.name.size();
+  });
+}
+
+template <class Take>
+void MarketTickDecoder::match(std::string_view name, Pass& pass, Take&& take) const {
+  for (std::size_t i = 0; i < keys_.size(); ++i) {
+    const Key& k = keys_[i];
+    if (k.name.size() < name.size()) continue;
+    if (k.name.size() > name.size()) break;
+    if (k.name != name) continue;
+
+    const std::uint64_t bit = std::uint64_t{1} << i;
+    if (pass.seen & bit) continue;
+    pass.seen |= bit;
+    if (k.rank < pass.best[k.field] && take(k)) pass.best[k.field] = k.rank;
+  }
+}
+
+bool MarketTickDecoder::take(Field field, const rapidjson::Value& v, Pass& pass) {
+  if (field == kTimestamp) {
+    if (!v.IsUint64()) return false;
+    pass.timestampNs = v.GetUint64();
+    return true;
+  }
+  if (!v.IsNumber()) return false;
+  pass.value[field] = v.GetDouble();
+  return true;
+}
+
+bool MarketTickDecoder::finish(const Pass& pass, TickEntry& out) {
+  if (pass.best[kPrice] == UINT8_MAX) return false;
+  out.price       = pass.value[kPrice];
+  out.volume      = pass.value[kVolume];
+  out.bid         = pass.value[kBid];
+  out.ask         = pass.value[kAsk];
+  out.timestampNs = pass.timestampNs;
+  return true;
+}
+
+bool MarketTickDecoder::decode(const rapidjson::Value& payload, TickEntry& out) const {
+  if (!payload.IsObject()) return false;
+  if (!probe_.empty()) return decodeByProbe(payload, out);
+
+  Pass pass;
+  for (auto m = payload.MemberBegin(); m != payload.MemberEnd(); ++m) {
+    const auto& v = m->value;
+    match(std::string_view(m->name.GetString(), m->name.GetStringLength()), pass,
+          [&](const Key& k) { return take(k.field, v, pass); });
+  }
+  return finish(pass, out);
+}
+
+bool MarketTickDecoder::decodeByProbe(const rapidjson::Value& payload, TickEntry& out) const {
+  Pass pass;
+  for (const Key& k : probe_) {
+    if (pass.best[k.field] != UINT8_MAX) continue;   // an earlier alias won
+    auto m = payload.FindMember(k.name.c_str());
+    if (m != payload.MemberEnd() && take(k.field, m->value, pass)) pass.best[k.field] = k.rank;
+  }
+  return finish(pass, out);
+}
+
+MarketTickDecoder::Scan MarketTickDecoder::scan(std::string_view json, TickEntry& out,
+                                                std::string_view* symbol) const {
+  if (!probe_.empty()) return Scan::Unsupported;
+  if (symbol) *symbol = {};
+  Cursor c{json.data(), json.data() + json.size()};
+  if (!c.eat('{')) return Scan::Unsupported;
+
+  Pass pass;
+  bool symbolSeen = false;
+  if (!c.eat('}')) {
+    for (;;) {
+      std::string_view name;
+      bool escaped;
+      if (!c.eat('"') || !c.string(name, escaped) || escaped) return Scan::Unsupported;
+      if (!c.eat(':')) return Scan::Unsupported;
+      c.ws();
+      const char* v = c.p;
+      if (!c.skipValue()) return Scan::Unsupported;
+      const std::string_view token(v, static_cast<std::size_t>(c.p - v));
+
+      if (symbol && !symbolSeen && name == "symbol") {
+        symbolSeen = true;
+        if (token.size() >= 2 && token.front() == '"') {
+          if (token.find('\\') != std::string_view::npos) return Scan::Unsupported;
+          *symbol = token.substr(1, token.size() - 2);
+        }
+      }
+      match(name, pass, [&](const Key& k) {
+        if (k.field == kTimestamp) return parseUint64(token, pass.timestampNs);
+        return parseDouble(token, pass.value[k.field]);
+      });
+
+      if (c.eat(',')) continue;
+      if (c.eat('}')) break;
+      return Scan::Unsupported;
+    }
+  }
+  c.ws();
+  if (c.p != c.e) return Scan::Unsupported;
+  return finish(pass, out) ? Scan::Tick : Scan::NoPrice;
+}
+
+} // namespace gma::market
@@ -0,0 +1,241 @@
+#include "gma/book/DepthIndex.hpp"
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <utility>
+
+namespace gma {
+
+namespace {
+
+inline int64_t wrapAdd(int64_t a, uint64_t b) noexcept {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) + b);
+}
+
+} // namespace
+
+// --------- Sums ---------
+void DepthIndex::accumulate(DepthSums& s, const Node& n) noexcept {
+    s.levels += n.levels;
+    s.orders += n.orders;
+    s.size   += n.size;
+    s.ticks    = wrapAdd(s.ticks, n.ticks);
+    s.notional = wrapAdd(s.notional, n.notional);
+}
+
+void DepthIndex::accumulate(DepthSums& s, int64_t t, const Level& l) noexcept {
+    s.levels += 1;
+    s.orders += l.orders;
+    s.size   += l.size;
+    s.ticks    = wrapAdd(s.ticks, static_cast<uint64_t>(t));
+    s.notional = wrapAdd(s.notional, static_cast<uint64_t>(t) * l.size);
+}
+
+void DepthIndex::accumulate(DepthSums& s, const DepthSums& b) noexcept {
+    s.levels += b.levels;
+    s.orders += b.orders;
+    s.size   += b.size;
+    s.ticks    = wrapAdd(s.ticks, static_cast<uint64_t>(b.ticks));
+    s.notional = wrapAdd(s.notional, static_cast<uint64_t>(b.notional));
+}
+
+DepthSums DepthIndex::minus(const DepthSums& a, const DepthSums& b) noexcept {
+    DepthSums d;
+    d.levels = a.levels - b.levels;
+    d.orders = a.orders - b.orders;
+    d.size   = a.size - b.size;
+    d.ticks    = wrapAdd(a.ticks, 0 - static_cast<uint64_t>(b.ticks));
+    d.notional = wrapAdd(a.notional, 0 - static_cast<uint64_t>(b.notional));
+    return d;
+}
+
+// --------- Updates ---------
+void DepthIndex::add(std::size_t slot, int64_t t, const Level& from, const Level& to) {
+    const uint64_t ut = static_cast<uint64_t>(t);
+    const uint64_t wasIn = from.orders > 0 ? 1 : 0;
+    const uint64_t isIn  = to.orders > 0 ? 1 : 0;
+    Node d;
+    d.levels   = isIn - wasIn;
+    d.orders   = uint64_t{to.orders} - uint64_t{from.orders};
+    d.size     = to.size - from.size;
+    d.ticks    = ut * isIn - ut * wasIn;
+    d.notional = ut * to.size - ut * from.size;
+    const std::size_t n = raw_.size();
+    for (std::size_t i = slot + 1; i <= n; i += i & (~i + 1)) {
+        Node& x = tree_[i];
+        x.levels += d.levels; x.orders += d.orders; x.size += d.size;
+        x.ticks += d.ticks;   x.notional += d.notional;
+    }
+}
+
+void DepthIndex::set(int64_t t, uint64_t size, uint32_t orders) {
+    const Level to = orders > 0 ? Level{ size, orders } : Level{};
+    if (inWindow(t)) {
+        const std::size_t i = static_cast<std::size_t>(t - base_);
+        Level& cur = raw_[i];
+        const bool was = cur.orders > 0;
+        if (was == (orders > 0) && cur.size == to.size && cur.orders == to.orders) return;
+        add(i, t, cur, to);
+        cur = to;
+        if (!was && orders > 0)      { ++windowLevels_; ++levels_; }
+        else if (was && orders == 0) { --windowLevels_; --levels_; }
+        return;
+    }
+    auto it = overflow_.find(t);
+    if (orders == 0) {
+        if (it != overflow_.end()) { overflow_.erase(it); --levels_; }
+        return;
+    }
+    if (it != overflow_.end()) { it->second = to; return; }
+    place(t, to);
+}
+
+// A new level outside the window: widen the window while the live levels
+// span at most half of MAX_WINDOW, re-centre it for a new best beyond
+// that, otherwise park the level in the overflow.
+void DepthIndex::place(int64_t t, const Level& lvl) {
+    if (windowLevels_ == 0) {
+        const std::size_t cap = std::max(raw_.size(), INITIAL_WINDOW);
+        rebuild(t - static_cast<int64_t>(cap / 2), cap);
+    } else {
+        std::size_t loSlot = 0, hiSlot = 0;
+        windowLowest(1, &loSlot);
+        windowLowest(windowLevels_, &hiSlot);
+        const int64_t loLive = base_ + static_cast<int64_t>(loSlot);
+        const int64_t hiLive = base_ + static_cast<int64_t>(hiSlot);
+        const int64_t lo = std::min(t, loLive);
+        const int64_t hi = std::max(t, hiLive);
+        const uint64_t width = static_cast<uint64_t>(hi - lo) + 1;
+        if (width <= MAX_WINDOW / 2) {
+            const std::size_t cap = std::max(raw_.size(), std::bit_ceil(static_cast<std::size_t>(width) * 2));
+            rebuild(lo - static_cast<int64_t>((cap - width) / 2), cap);
+        } else if (descending_ ? t > hiLive : t < loLive) {
+            const int64_t w = static_cast<int64_t>(MAX_WINDOW);
+            rebuild(descending_ ? t - (w - w / 4) : t - w / 4, MAX_WINDOW);
+        }
+    }
+
+    if (inWindow(t)) {
+        const std::size_t i = static_cast<std::size_t>(t - base_);
+        add(i, t, Level{}, lvl);
+        raw_[i] = lvl;
+        ++windowLevels_;
+    } else {
+        overflow_.emplace(t, lvl);
+    }
+    ++levels_;
+}
+
+void DepthIndex::rebuild(int64_t base, std::size_t cap) {
+    std::vector<std::pair<int64_t, Level>> all;
+    all.reserve(windowLevels_ + overflow_.size());
+    for (std::size_t i = 0; i < raw_.size(); ++i) {
+        if (raw_[i].orders > 0) all.emplace_back(base_ + static_cast<int64_t>(i), raw_[i]);
+    }
+    for (const auto& kv : overflow_) all.push_back(kv);
+
+    overflow_.clear();
+    raw_.assign(cap, Level{});
+    tree_.assign(cap + 1, Node{});
+    base_ = base;
+    windowLevels_ = 0;
+    for (const auto& [t, l] : all) {
+        if (inWindow(t)) { raw_[static_cast<std::size_t>(t - base_)] = l; ++windowLevels_; }
+        else             overflow_.emplace(t, l);
+    }
+
+    // Linear-time Fenwick build.
+    for (std::size_t i = 1; i <= cap; ++i) {
+        const Level& l = raw_[i - 1];
+        if (l.orders == 0) continue;
+        const uint64_t ut = static_cast<uint64_t>(base_ + static_cast<int64_t>(i - 1));
+        Node& x = tree_[i];
+        x.levels += 1; x.orders += l.orders; x.size += l.size;
+        x.ticks += ut; x.notional += ut * l.size;
+    }
+    for (std::size_t i = 1; i <= cap; ++i) {
+        const std::size_t j = i + (i & (~i + 1));
+        if (j > cap) continue;
+        Node& y = tree_[j];
+        const Node& x = tree_[i];
+        y.levels += x.levels; y.orders += x.orders; y.size += x.size;
+        y.ticks += x.ticks;   y.notional += x.notional;
+    }
+}
+
+void DepthIndex::clear() {
+    std::fill(raw_.begin(), raw_.end(), Level{});
+    std::fill(tree_.begin(), tree_.end(), Node{});
+    overflow_.clear();
+    windowLevels_ = 0;
+    levels_ = 0;
+}
+
+// --------- Queries ---------
+// Sum of the k lowest-priced window levels (Fenwick descent on the level
+// count); `lastSlot` receives the slot of the k-th.
+DepthSums DepthIndex::windowLowest(std::size_t k, std::size_t* lastSlot) const {
+    DepthSums s;
+    if (k == 0 || raw_.empty()) return s;
+    std::size_t pos = 0;
+    uint64_t left = k;
+    for (std::size_t step = std::bit_floor(raw_.size()); step > 0; step >>= 1) {
+        const std::size_t next = pos + step;
+        if (next <= raw_.size() && tree_[next].levels < left) {
+            pos = next;
+            left -= tree_[next].levels;
+            accumulate(s, tree_[next]);
+        }
+    }
+    // pos + 1 (1-based) is the k-th level itself.
+    if (pos < raw_.size()) {
+        accumulate(s, base_ + static_cast<int64_t>(pos), raw_[pos]);
+        if (lastSlot) *lastSlot = pos;
+    }
+    return s;
+}
+
+DepthSums DepthIndex::windowAtOrBelow(std::size_t slots) const {
+    DepthSums s;
+    for (std::size_t i = std::min(slots, raw_.size()); i > 0; i -= i & (~i + 1)) accumulate(s, tree_[i]);
+    return s;
+}
+
+DepthSums DepthIndex::lowest(std::size_t k) const {
+    DepthSums s;
+    std::size_t left = k;
+    auto it = overflow_.begin();
+    for (; it != overflow_.end() && it->first < base_ && left > 0; ++it, --left) accumulate(s, it->first, it->second);
+    if (left == 0) return s;
+    const std::size_t w = std::min(left, windowLevels_);
+    accumulate(s, windowLowest(w));
+    left -= w;
+    for (; it != overflow_.end() && left > 0; ++it, --left) accumulate(s, it->first, it->second);
+    return s;
+}
+
+DepthSums DepthIndex::atOrBelow(int64_t t) const {
+    DepthSums s;
+    for (auto it = overflow_.begin(); it != overflow_.end() && it->first <= t; ++it) accumulate(s, it->first, it->second);
+    if (raw_.empty() || t < base_) return s;
+    const uint64_t span = static_cast<uint64_t>(t - base_) + 1;
+    accumulate(s, windowAtOrBelow(static_cast<std::size_t>(std::min<uint64_t>(span, raw_.size()))));
+    return s;
+}
+
+DepthSums DepthIndex::ranks(std::size_t first, std::size_t last) const {
+    first = std::max<std::size_t>(first, 1);
+    last = std::min(last, levels_);
+    if (first > last) return {};
+    // Best-first rank r is ascending rank levels_ - r + 1 on the bid side.
+    if (descending_) return minus(lowest(levels_ - first + 1), lowest(levels_ - last));
+    return minus(lowest(last), lowest(first - 1));
+}
+
+DepthSums DepthIndex::band(int64_t lo, int64_t hi) const {
+    if (lo > hi) return {};
+    const DepthSums below = (lo == std::numeric_limits<int64_t>::min()) ? DepthSums{} : atOrBelow(lo - 1);
+    return minus(atOrBelow(hi), below);
+}
+
+} // namespace gma
@@ -0,0 +1,236 @@
+#include "gma/book/DepthStream.hpp"
+#include "gma/book/OrderBookManager.hpp"
+#include <bit>
+#include <cstring>
+
+namespace gma {
+
+namespace {
+
+void putVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+inline uint64_t zigzag(int64_t v) noexcept {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+inline int64_t unzigzag(uint64_t v) noexcept {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+void putLevels(std::string& out, const std::vector<std::pair<Price, uint64_t>>& levels) {
+    putVarint(out, levels.size());
+    int64_t prev = 0;
+    for (const auto& [p, sz] : levels) {
+        putVarint(out, zigzag(static_cast<int64_t>(static_cast<uint64_t>(p.ticks) - static_cast<uint64_t>(prev))));
+        putVarint(out, sz);
+        prev = p.ticks;
+    }
+}
+
+struct Reader {
+    std::string_view in;
+    std::size_t pos = 0;
+
+    bool varint(uint64_t& v) {
+        v = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (pos >= in.size()) return false;
+            const auto b = static_cast<uint8_t>(in[pos++]);
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return true;
+        }
+        return false;
+    }
+    bool f64(double& d) {
+        if (in.size() - pos < 8) return false;
+        uint64_t u = 0;
+        for (int i = 7; i >= 0; --i) u = (u << 8) | static_cast<uint8_t>(in[pos + i]);
+        pos += 8;
+        d = std::bit_cast<double>(u);
+        return true;
+    }
+    bool levels(std::vector<std::pair<Price, uint64_t>>& out) {
+        uint64_t n = 0;
+        if (!varint(n) || n > in.size() - pos) return false;   // >= 2 bytes per level
+        out.reserve(n);
+        int64_t prev = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            uint64_t dp = 0, sz = 0;
+            if (!varint(dp) || !varint(sz)) return false;
+            prev = static_cast<int64_t>(static_cast<uint64_t>(prev) + static_cast<uint64_t>(unzigzag(dp)));
+            out.emplace_back(Price{prev}, sz);
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+// --------- Codec ---------
+void encodeDepthFrame(const DepthFrame& f, std::string& out) {
+    out.clear();
+    out.reserve(32 + 6 * (f.bids.size() + f.asks.size()));
+    out.push_back(static_cast<char>(f.type));
+    putVarint(out, f.streamId);
+    putVarint(out, f.seq);
+    putVarint(out, f.prevSeq);
+    if (f.type == DepthFrame::Type::Snapshot) {
+        putVarint(out, f.epoch);
+        const uint64_t u = std::bit_cast<uint64_t>(f.tick);
+        for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>((u >> (8 * i)) & 0xFF));
+    }
+    putLevels(out, f.bids);
+    putLevels(out, f.asks);
+}
+
+std::string encodeDepthFrame(const DepthFrame& f) {
+    std::string out;
+    encodeDepthFrame(f, out);
+    return out;
+}
+
+std::optional<DepthFrame> decodeDepthFrame(std::string_view bytes) {
+    if (bytes.empty()) return std::nullopt;
+    DepthFrame f;
+    const auto type = static_cast<uint8_t>(bytes[0]);
+    if (type != static_cast<uint8_t>(DepthFrame::Type::Snapshot) &&
+        type != static_cast<uint8_t>(DepthFrame::Type::Delta)) return std::nullopt;
+    f.type = static_cast<DepthFrame::Type>(type);
+
+    Reader r{bytes, 1};
+    uint64_t id = 0, epoch = 0;
+    if (!r.varint(id) || id > UINT32_MAX) return std::nullopt;
+    f.streamId = static_cast<uint32_t>(id);
+    if (!r.varint(f.seq) || !r.varint(f.prevSeq)) return std::nullopt;
+    if (f.type == DepthFrame::Type::Snapshot) {
+        if (!r.varint(epoch) || epoch > UINT32_MAX || !r.f64(f.tick)) return std::nullopt;
+        f.epoch = static_cast<uint32_t>(epoch);
+    }
+    if (!r.levels(f.bids) || !r.levels(f.asks)) return std::nullopt;
+    if (r.pos != bytes.size()) return std::nullopt;
+    return f;
+}
+
+// --------- DepthStreamer ---------
+DepthStreamer::DepthStreamer(std::shared_ptr<OrderBookManager> books, std::string symbol,
+                             uint32_t streamId, std::size_t levels, Sink sink)
+    : books_(std::move(books)), symbol_(std::move(symbol)), streamId_(streamId),
+      levels_(levels), sink_(std::move(sink)) {}
+
+std::shared_ptr<DepthStreamer> DepthStreamer::create(std::shared_ptr<OrderBookManager> books,
+                                                     std::string symbol,
+                                                     uint32_t streamId,
+                                                     std::size_t levels,
+                                                     Sink sink) {
+    std::shared_ptr<DepthStreamer> s(new DepthStreamer(std::move(books), std::move(symbol),
+                                                       streamId, levels, std::move(sink)));
+    std::weak_ptr<DepthStreamer> weak = s;
+    s->subId_ = s->books_->subscribeDeltas(s->symbol_, [weak](const BookDelta& d) {
+        if (auto self = weak.lock()) self->onDelta(d);
+    });
+    if (s->subId_ == 0) {
+        s->stopped_ = true;       // nothing to unsubscribe
+        return nullptr;
+    }
+    return s;
+}
+
+DepthStreamer::~DepthStreamer() { stop(); }
+
+void DepthStreamer::stop() {
+    {
+        std::lock_guard<std::mutex> lk(mx_);
+        if (stopped_) return;
+        stopped_ = true;
+    }
+    books_->unsubscribeDeltas(symbol_, subId_);
+}
+
+bool DepthStreamer::inView(Side side, Price p) const {
+    const Ladder& view = side == Side::Bid ? sentBids_ : sentAsks_;
+    if (view.size() < levels_) return true;
+    const Price worst = view.back().first;
+    return side == Side::Bid ? !(p < worst) : !(p > worst);
+}
+
+void DepthStreamer::onDelta(const BookDelta& d) {
+    std::lock_guard<std::mutex> lk(mx_);
+    if (stopped_ || d.seq <= deltaSeq_) return;   // already covered by a frame
+    if (deltaSeq_ != 0 && d.seq != deltaSeq_ + 1) resync_ = true;
+    deltaSeq_ = d.seq;
+    if (resync_) { dirty_ = true; return; }
+
+    // A delta without level changes is a whole-book replacement.
+    if (d.levels.empty()) { resync_ = dirty_ = true; return; }
+    if (d.bid || d.ask) { dirty_ = true; return; }
+    for (const auto& l : d.levels) {
+        if (inView(l.side, l.price)) { dirty_ = true; return; }
+    }
+}
+
+// Merge two best-first ladders into the per-level changes that turn `from`
+// into `to`; levels only in `from` come out with size 0.
+void DepthStreamer::diff(const Ladder& from, const Ladder& to, bool descending, Ladder& out) {
+    auto better = [descending](Price a, Price b) { return descending ? a > b : a < b; };
+    std::size_t i = 0, j = 0;
+    while (i < from.size() || j < to.size()) {
+        if (j == to.size() || (i < from.size() && better(from[i].first, to[j].first))) {
+            out.emplace_back(from[i++].first, 0);
+        } else if (i == from.size() || better(to[j].first, from[i].first)) {
+            out.push_back(to[j++]);
+        } else {
+            if (from[i].second != to[j].second) out.push_back(to[j]);
+            ++i; ++j;
+        }
+    }
+}
+
+bool DepthStreamer::flush() {
+    std::lock_guard<std::mutex> lk(mx_);
+    if (stopped_ || !dirty_) return false;
+
+    DepthSnapshot snap = books_->buildSnapshot(symbol_, levels_);
+    if (snap.epoch != sentEpoch_) resync_ = true;
+
+    DepthFrame f;
+    f.streamId = streamId_;
+    f.seq = snap.seq;
+    if (resync_) {
+        f.type  = DepthFrame::Type::Snapshot;
+        f.epoch = snap.epoch;
+        f.tick  = books_->getTickSize(symbol_);
+        f.bids  = snap.bids;
+        f.asks  = snap.asks;
+    } else {
+        f.type    = DepthFrame::Type::Delta;
+        f.prevSeq = sentSeq_;
+        diff(sentBids_, snap.bids, true,  f.bids);
+        diff(sentAsks_, snap.asks, false, f.asks);
+        if (f.bids.empty() && f.asks.empty()) {
+            // Nothing the client can see moved.
+            dirty_ = false;
+            return false;
+        }
+    }
+
+    if (!sink_(encodeDepthFrame(f))) return false;   // retry against the same baseline
+
+    if (f.type == DepthFrame::Type::Snapshot && framesSent_.load(std::memory_order_relaxed) > 0)
+        resnapshots_.fetch_add(1, std::memory_order_relaxed);
+    framesSent_.fetch_add(1, std::memory_order_relaxed);
+    sentBids_  = std::move(snap.bids);
+    sentAsks_  = std::move(snap.asks);
+    sentSeq_   = snap.seq;
+    sentEpoch_ = snap.epoch;
+    if (snap.seq > deltaSeq_) deltaSeq_ = snap.seq;
+    resync_ = false;
+    dirty_  = false;
+    return true;
+}
+
+} // namespace gma
@@ -2,10 +2,30 @@
 #include "gma/util/Logger.hpp"
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
+#include <utility>
 
 namespace gma {
 
+OrderBook::OrderBook(const LadderConfig& ladder, bool hugePages)
+    : cfg_(ladder),
+      bids_(true, ladder), asks_(false, ladder),
+      bidsAgg_(true, ladder), asksAgg_(false, ladder),
+      bidDepth_(true), askDepth_(false),
+      bidBand_(true, ladder.depthLimit), askBand_(false, ladder.depthLimit),
+      pool_(hugePages) {}
+
+size_t OrderBook::orderCount() const {
+    std::scoped_lock lk(m_);
+    return pool_.live();
+}
+size_t OrderBook::orderMemoryBytes() const {
+    std::scoped_lock lk(m_);
+    return pool_.bytes() + byId_.bytes();
+}
+
 // --------- Synthetic ID generator (D4) ---------
 uint64_t OrderBook::nextSyntheticId(FeedScope s) {
     const uint64_t k = scopeKey(s);
@@ -61,7 +81,7 @@ bool OrderBook::applyDelete(const OrderKey& key) {
 
 // --------- Trade ---------
 bool OrderBook::applyTrade(Price tradePrice, uint64_t qty, Aggressor aggr) {
-    if (qty == 0) return false;
+    if (qty == 0 || limited()) return false;
 
     std::scoped_lock lk(m_);
     std::optional<Side> passive;
@@ -69,8 +89,9 @@ bool OrderBook::applyTrade(Price tradePrice, uint64_t qty, Aggressor aggr) {
     if (aggr == Aggressor::Buy)      passive = Side::Ask;
     else if (aggr == Aggressor::Sell) passive = Side::Bid;
     else {
-        if (!bids_.empty() && tradePrice.ticks <= bids_.begin()->first.ticks)      passive = Side::Bid;
-        else if (!asks_.empty() && tradePrice.ticks >= asks_.begin()->first.ticks) passive = Side::Ask;
+        int64_t bb = 0, ba = 0;
+        if (bids_.best(bb) && tradePrice.ticks <= bb)      passive = Side::Bid;
+        else if (asks_.best(ba) && tradePrice.ticks >= ba) passive = Side::Ask;
         else return false; // hidden/midpoint or empty book
     }
 
@@ -79,29 +100,37 @@ bool OrderBook::applyTrade(Price tradePrice, uint64_t qty, Aggressor aggr) {
 }
 
 // --------- Snapshots / Summaries ---------
+// The replaced contents are freed after the lock is released. A rebuild
+// is not a change list, so nothing goes to the change log.
 void OrderBook::applySnapshotPerOrder(const std::vector<Order>& orders) {
+    OrderBook next(cfg_, pool_.hugePages());
+    next.loadPerOrder(orders);
+
     std::scoped_lock lk(m_);
-    clearPerOrderUnlocked();
-    for (const auto& o : orders) addImpl(o);
+    std::swap(bids_, next.bids_);
+    std::swap(asks_, next.asks_);
+    std::swap(bidDepth_, next.bidDepth_);
+    std::swap(askDepth_, next.askDepth_);
+    std::swap(bidBand_, next.bidBand_);
+    std::swap(askBand_, next.askBand_);
+    std::swap(byId_, next.byId_);
+    pool_.swap(next.pool_);
 }
 
 void OrderBook::applySnapshotAggregated(const std::vector<LevelSnapshotEntry>& levels) {
+    OrderBook next(cfg_);
+    next.loadAggregated(levels);
+
     std::scoped_lock lk(m_);
-    clearAggregatedUnlocked();
-    for (const auto& e : levels) {
-        if (e.totalSize == 0) continue;
-        LevelAgg& lvl = getOrCreateAggLevel(e.side, e.price);
-        lvl.totalSize = e.totalSize;
-        lvl.orderCount = e.orderCount.value_or(0);
-    }
+    std::swap(bidsAgg_, next.bidsAgg_);
+    std::swap(asksAgg_, next.asksAgg_);
 }
 
 bool OrderBook::applyLevelSummary(Side side, Price price, uint64_t totalSize,
                                   std::optional<uint32_t> orderCount) {
     std::scoped_lock lk(m_);
     if (totalSize == 0) {
-        if (side == Side::Bid) { auto it = bidsAgg_.find(price); if (it != bidsAgg_.end()) bidsAgg_.erase(it); }
-        else                    { auto it = asksAgg_.find(price); if (it != asksAgg_.end()) asksAgg_.erase(it); }
+        aggLadder(side).erase(price.ticks);
         return true;
     }
     LevelAgg& lvl = getOrCreateAggLevel(side, price);
@@ -123,49 +152,56 @@ bool OrderBook::applyPriority(const OrderKey& key, uint64_t newPriority) {
 
 // --------- TOB / queries ---------
 std::optional<Price> OrderBook::bestBid() const {
-    std::scoped_lock lk(m_);
-    if (bids_.empty()) return std::nullopt;
-    return bids_.begin()->first;
+    return top().bid;
 }
 std::optional<Price> OrderBook::bestAsk() const {
-    std::scoped_lock lk(m_);
-    if (asks_.empty()) return std::nullopt;
-    return asks_.begin()->first;
+    return top().ask;
 }
 uint64_t OrderBook::bestBidSize() const {
-    std::scoped_lock lk(m_);
-    if (bids_.empty()) return 0ULL;
-    return bids_.begin()->second.totalSize;
+    return top().bidSize;
 }
 uint64_t OrderBook::bestAskSize() const {
+    return top().askSize;
+}
+BookTop OrderBook::top() const {
     std::scoped_lock lk(m_);
-    if (asks_.empty()) return 0ULL;
-    return asks_.begin()->second.totalSize;
+    BookTop t;
+    if (limited()) {
+        if (bidBand_.size()) { t.bid = Price{bidBand_[0].ticks}; t.bidSize = bidBand_[0].totalSize; }
+        if (askBand_.size()) { t.ask = Price{askBand_[0].ticks}; t.askSize = askBand_[0].totalSize; }
+        return t;
+    }
+    int64_t ticks = 0;
+    if (const PriceLevel* lvl = bids_.best(ticks)) { t.bid = Price{ticks}; t.bidSize = lvl->totalSize; }
+    if (const PriceLevel* lvl = asks_.best(ticks)) { t.ask = Price{ticks}; t.askSize = lvl->totalSize; }
+    return t;
 }
 uint64_t OrderBook::levelSize(Side s, Price price) const {
     std::scoped_lock lk(m_);
-    const PriceLevel* lvl = nullptr;
-    if (s == Side::Bid) { auto it = bids_.find(price); if (it != bids_.end()) lvl = &it->second; }
-    else                { auto it = asks_.find(price); if (it != asks_.end()) lvl = &it->second; }
+    if (limited()) {
+        const TopLevel* lvl = band(s).find(price.ticks);
+        return lvl ? lvl->totalSize : 0ULL;
+    }
+    const PriceLevel* lvl = ladder(s).find(price.ticks);
     return lvl ? lvl->totalSize : 0ULL;
 }
 
 // Aggregated queries
 std::optional<Price> OrderBook::bestBidAggregated() const {
     std::scoped_lock lk(m_);
-    if (bidsAgg_.empty()) return std::nullopt;
-    return bidsAgg_.begin()->first;
+    int64_t t = 0;
+    if (!bidsAgg_.best(t)) return std::nullopt;
+    return Price{t};
 }
 std::optional<Price> OrderBook::bestAskAggregated() const {
     std::scoped_lock lk(m_);
-    if (asksAgg_.empty()) return std::nullopt;
-    return asksAgg_.begin()->first;
+    int64_t t = 0;
+    if (!asksAgg_.best(t)) return std::nullopt;
+    return Price{t};
 }
 uint64_t OrderBook::levelSizeAggregated(Side s, Price price) const {
     std::scoped_lock lk(m_);
-    const LevelAgg* lvl = nullptr;
-    if (s == Side::Bid) { auto it = bidsAgg_.find(price); if (it != bidsAgg_.end()) lvl = &it->second; }
-    else                { auto it = asksAgg_.find(price); if (it != asksAgg_.end()) lvl = &it->second; }
+    const LevelAgg* lvl = aggLadder(s).find(price.ticks);
     return lvl ? lvl->totalSize : 0ULL;
 }
 
@@ -175,50 +211,150 @@ void OrderBook::forEachLevel(Side side, size_t n,
     std::vector<std::pair<Price, uint64_t>> out;
     {
         std::scoped_lock lk(m_);
-        if (side == Side::Bid) {
-            size_t i = 0;
-            for (auto it = bids_.begin(); it != bids_.end() && i < n; ++it, ++i) {
-                out.emplace_back(it->first, it->second.totalSize);
-            }
+        if (limited()) {
+            const TopLadder& b = band(side);
+            out.reserve(std::min(n, b.size()));
+            for (size_t i = 0; i < b.size() && i < n; ++i) out.emplace_back(Price{b[i].ticks}, b[i].totalSize);
         } else {
-            size_t i = 0;
-            for (auto it = asks_.begin(); it != asks_.end() && i < n; ++it, ++i) {
-                out.emplace_back(it->first, it->second.totalSize);
-            }
+            out.reserve(std::min(n, ladder(side).size()));
+            ladder(side).forEach(n, [&](int64_t t, const PriceLevel& lvl) {
+                out.emplace_back(Price{t}, lvl.totalSize);
+            });
         }
     }
     for (const auto& p : out) fn(p.first, p.second);
 }
 
+size_t OrderBook::levelCount(Side side) const {
+    std::scoped_lock lk(m_);
+    return limited() ? band(side).size() : depth(side).levels();
+}
+DepthSums OrderBook::depthByRank(Side side, size_t first, size_t last) const {
+    constexpr int64_t lim = std::numeric_limits<int64_t>::max();
+    std::scoped_lock lk(m_);
+    if (limited()) return bandSums(side, first, last, -lim, lim);
+    return depth(side).ranks(first, last);
+}
+DepthSums OrderBook::depthByPrice(Side side, Price lo, Price hi) const {
+    std::scoped_lock lk(m_);
+    if (limited()) return bandSums(side, 1, band(side).size(), lo.ticks, hi.ticks);
+    return depth(side).band(lo.ticks, hi.ticks);
+}
+
+// A held band is a few dozen levels at most: sum it directly.
+DepthSums OrderBook::bandSums(Side s, size_t first, size_t last, int64_t lo, int64_t hi) const {
+    DepthSums out;
+    const TopLadder& b = band(s);
+    for (size_t i = std::max<size_t>(first, 1) - 1; i < b.size() && i < last; ++i) {
+        const TopLevel& l = b[i];
+        if (l.ticks < lo || l.ticks > hi) continue;
+        ++out.levels; out.orders += l.count; out.size += l.totalSize;
+        out.ticks += l.ticks; out.notional += l.ticks * static_cast<int64_t>(l.totalSize);
+    }
+    return out;
+}
+
+// --------- Change log ---------
+void OrderBook::setChangeLog(std::vector<LevelChange>* log) {
+    std::scoped_lock lk(m_);
+    log_ = log;
+}
+
+// A mutation touches at most a few levels, so a linear merge is cheapest.
+void OrderBook::noteLevel(Side s, int64_t ticks, uint64_t before, uint64_t after) {
+    for (auto& c : *log_) {
+        if (c.ticks == ticks && c.side == s) { c.after = after; return; }
+    }
+    log_->push_back(LevelChange{ s, ticks, before, after });
+}
+
 // --------- Invariants ---------
 bool OrderBook::checkInvariants(std::string* whyNot) const {
     std::scoped_lock lk(m_);
-    auto checkSide = [&](const auto& ladder) {
-        for (const auto& kv : ladder) {
-            const auto& level = kv.second;
-            uint64_t sum = 0;
-            for (const auto& o : level.orders) sum += o.size;
-            if (sum != level.totalSize) return false;
+    if (limited()) {
+        // Held levels must be exactly the best levels rebuilt from the
+        // orders, and every other order counted outside.
+        for (const Side s : { Side::Bid, Side::Ask }) {
+            std::map<int64_t, TopLevel> all;
+            size_t orders = 0;
+            byId_.forEach([&](uint32_t i) {
+                const OrderNode& n = pool_[i];
+                if (n.side != s) return;
+                TopLevel& l = all[n.price];
+                l.ticks = n.price; l.totalSize += n.size; ++l.count;
+                ++orders;
+            });
+            std::vector<TopLevel> want;
+            for (const auto& kv : all) want.push_back(kv.second);
+            if (s == Side::Bid) std::reverse(want.begin(), want.end());
+
+            const TopLadder& b = band(s);
+            bool ok = b.size() <= want.size() && !b.needsRefill();
+            size_t held = 0;
+            for (size_t i = 0; ok && i < b.size(); ++i) {
+                ok = b[i].ticks == want[i].ticks && b[i].totalSize == want[i].totalSize
+                  && b[i].count == want[i].count;
+                held += b[i].count;
+            }
+            if (!ok || held + b.outside() != orders) {
+                if (whyNot) *whyNot = "depth-limited: held levels differ from the best order levels";
+                return false;
+            }
         }
-        return true;
+    }
+    auto checkSide = [&](const PriceLadder<PriceLevel>& side) {
+        bool ok = true;
+        side.forEach(side.size(), [&](int64_t, const PriceLevel& level) {
+            uint64_t sum = 0;
+            uint32_t n = 0;
+            for (uint32_t i = level.head; i != kNoOrder; i = pool_[i].next, ++n) sum += pool_[i].size;
+            if (sum != level.totalSize || n != level.count) ok = false;
+        });
+        return ok;
     };
     if (!checkSide(bids_) || !checkSide(asks_)) {
         if (whyNot) *whyNot = "per-order: level.totalSize mismatch with order sum";
         return false;
     }
-    for (const auto& kv : byId_) {
-        const auto& loc = kv.second;
-        const PriceLevel* lvl = (loc.side == Side::Bid)
-            ? (bids_.count(loc.price) ? &bids_.at(loc.price) : nullptr)
-            : (asks_.count(loc.price) ? &asks_.at(loc.price) : nullptr);
-        if (!lvl) { if (whyNot) *whyNot = "per-order: locator references missing level"; return false; }
-        const Order& o = *loc.it;
-        const OrderKey key = OrderKey{ o.id, o.feedId, o.epoch, o.synthetic };
-        if (!(key == kv.first)) { if (whyNot) *whyNot = "per-order: locator iterator does not match key"; return false; }
+    auto checkDepth = [&](Side s) {
+        const auto& side = ladder(s);
+        if (depth(s).levels() != side.size()) return false;
+        DepthSums want;
+        side.forEach(side.size(), [&](int64_t t, const PriceLevel& level) {
+            ++want.levels; want.orders += level.count; want.size += level.totalSize;
+            want.ticks += t; want.notional += t * static_cast<int64_t>(level.totalSize);
+        });
+        const DepthSums got = depth(s).top(side.size());
+        return got.levels == want.levels && got.orders == want.orders && got.size == want.size
+            && got.ticks == want.ticks && got.notional == want.notional;
+    };
+    if (!checkDepth(Side::Bid) || !checkDepth(Side::Ask)) {
+        if (whyNot) *whyNot = "per-order: depth index out of step with the ladder";
+        return false;
+    }
+    if (byId_.size() != pool_.live()) {
+        if (whyNot) *whyNot = "per-order: index size differs from live orders";
+        return false;
     }
-    auto checkAgg = [&](const auto& ladder) {
-        for (const auto& kv : ladder) if (kv.second.totalSize == 0) return false;
-        return true;
+    bool indexOk = true;
+    byId_.forEach([&](uint32_t i) {
+        if (!indexOk) return;
+        const OrderNode& n = pool_[i];
+        if (!limited() && !ladder(n.side).find(n.price)) {
+            if (whyNot) *whyNot = "per-order: order references missing level";
+            indexOk = false;
+        } else if (byId_.find(n.key(), pool_) != i) {
+            if (whyNot) *whyNot = "per-order: index entry does not match its order's key";
+            indexOk = false;
+        }
+    });
+    if (!indexOk) return false;
+    auto checkAgg = [&](const PriceLadder<LevelAgg>& side) {
+        bool ok = true;
+        side.forEach(side.size(), [&](int64_t, const LevelAgg& level) {
+            if (level.totalSize == 0) ok = false;
+        });
+        return ok;
     };
     if (!checkAgg(bidsAgg_) || !checkAgg(asksAgg_)) {
         if (whyNot) *whyNot = "aggregated: zero-size level present";
@@ -229,30 +365,112 @@ bool OrderBook::checkInvariants(std::string* whyNot) const {
 
 // --------- Private helpers (per-order) ---------
 PriceLevel& OrderBook::getOrCreateLevel(Side s, Price price) {
-    if (s == Side::Bid) { auto [it,_]=bids_.try_emplace(price); return it->second; }
-    else                { auto [it,_]=asks_.try_emplace(price); return it->second; }
+    return ladder(s).getOrCreate(price.ticks);
 }
 PriceLevel* OrderBook::findLevel(Side s, Price price) {
-    if (s == Side::Bid) { auto it=bids_.find(price); return (it==bids_.end())?nullptr:&it->second; }
-    else                { auto it=asks_.find(price); return (it==asks_.end())?nullptr:&it->second; }
+    return ladder(s).find(price.ticks);
 }
 void OrderBook::eraseLevelIfEmpty(Side s, Price price) {
-    if (s == Side::Bid) { auto it=bids_.find(price); if (it!=bids_.end() && it->second.orders.empty()) bids_.erase(it); }
-    else                { auto it=asks_.find(price); if (it!=asks_.end() && it->second.orders.empty()) asks_.erase(it); }
+    auto& side = ladder(s);
+    const PriceLevel* lvl = side.find(price.ticks);
+    if (lvl && lvl->empty()) side.erase(price.ticks);
 }
 
 // --------- Private helpers (aggregated) ---------
 LevelAgg& OrderBook::getOrCreateAggLevel(Side s, Price price) {
-    if (s == Side::Bid) { auto [it,_]=bidsAgg_.try_emplace(price); return it->second; }
-    else                { auto [it,_]=asksAgg_.try_emplace(price); return it->second; }
+    return aggLadder(s).getOrCreate(price.ticks);
 }
 LevelAgg* OrderBook::findAggLevel(Side s, Price price) {
-    if (s == Side::Bid) { auto it=bidsAgg_.find(price); return (it==bidsAgg_.end())?nullptr:&it->second; }
-    else                { auto it=asksAgg_.find(price); return (it==asksAgg_.end())?nullptr:&it->second; }
+    return aggLadder(s).find(price.ticks);
 }
 void OrderBook::eraseAggLevelIfEmpty(Side s, Price price) {
-    if (s == Side::Bid) { auto it=bidsAgg_.find(price); if (it!=bidsAgg_.end() && it->second.totalSize==0) bidsAgg_.erase(it); }
-    else                { auto it=asksAgg_.find(price); if (it!=asksAgg_.end() && it->second.totalSize==0) asksAgg_.erase(it); }
+    auto& side = aggLadder(s);
+    const LevelAgg* lvl = side.find(price.ticks);
+    if (lvl && lvl->totalSize == 0) side.erase(price.ticks);
+}
+
+// --------- FIFO links ---------
+void OrderBook::linkQuiet(PriceLevel& lvl, uint32_t i) {
+    OrderNode& n = pool_[i];
+    n.prev = lvl.tail;
+    n.next = kNoOrder;
+    if (lvl.tail != kNoOrder) pool_[lvl.tail].next = i;
+    else                      lvl.head = i;
+    lvl.tail = i;
+    ++lvl.count;
+    lvl.totalSize += n.size;
+}
+
+void OrderBook::unlinkQuiet(PriceLevel& lvl, uint32_t i) {
+    OrderNode& n = pool_[i];
+    if (n.prev != kNoOrder) pool_[n.prev].next = n.next; else lvl.head = n.next;
+    if (n.next != kNoOrder) pool_[n.next].prev = n.prev; else lvl.tail = n.prev;
+    n.prev = n.next = kNoOrder;
+    --lvl.count;
+    lvl.totalSize -= n.size;
+}
+
+void OrderBook::linkBack(PriceLevel& lvl, uint32_t i) {
+    const uint64_t before = lvl.totalSize;
+    linkQuiet(lvl, i);
+    syncDepth(pool_[i].side, pool_[i].price, before, lvl);
+}
+
+void OrderBook::unlink(PriceLevel& lvl, uint32_t i) {
+    OrderNode& n = pool_[i];
+    const uint64_t before = lvl.totalSize;
+    if (n.prev != kNoOrder) pool_[n.prev].next = n.next; else lvl.head = n.next;
+    if (n.next != kNoOrder) pool_[n.next].prev = n.prev; else lvl.tail = n.prev;
+    n.prev = n.next = kNoOrder;
+    --lvl.count;
+    if (lvl.totalSize >= n.size) lvl.totalSize -= n.size;
+    else {
+        gma::util::logger().log(gma::util::LogLevel::Error,
+            "OrderBook: totalSize underflow detected",
+            {{"oldSize", std::to_string(n.size)},
+             {"totalSize", std::to_string(lvl.totalSize)}});
+        lvl.totalSize = 0;
+    }
+    syncDepth(n.side, n.price, before, lvl);
+}
+
+void OrderBook::releaseOrder(uint32_t i, const OrderKey& key) {
+    byId_.erase(key, pool_);
+    pool_.release(i);
+}
+
+// --------- Depth-limited levels ---------
+void OrderBook::bandAdd(Side s, int64_t ticks, uint64_t size) {
+    band(s).add(ticks, size, [this, s](int64_t t, uint64_t before, uint64_t after) {
+        if (log_) noteLevel(s, t, before, after);
+    });
+}
+
+void OrderBook::bandRemove(Side s, int64_t ticks, uint64_t size) {
+    band(s).remove(ticks, size, [this, s](int64_t t, uint64_t before, uint64_t after) {
+        if (log_) noteLevel(s, t, before, after);
+    });
+}
+
+void OrderBook::bandResize(Side s, int64_t ticks, uint64_t from, uint64_t to) {
+    band(s).resize(ticks, from, to, [this, s](int64_t t, uint64_t before, uint64_t after) {
+        if (log_) noteLevel(s, t, before, after);
+    });
+}
+
+// Rebuilds from every resting order, so call it once the pool and index
+// are final for the mutation.
+void OrderBook::bandRefill(Side s) {
+    TopLadder& b = band(s);
+    if (!b.needsRefill()) return;
+    b.refill([&](auto&& fn) {
+        byId_.forEach([&](uint32_t i) {
+            const OrderNode& n = pool_[i];
+            if (n.side == s) fn(n.price, n.size);
+        });
+    }, [this, s](int64_t t, uint64_t before, uint64_t after) {
+        if (log_) noteLevel(s, t, before, after);
+    });
 }
 
 // --------- Core impls ---------
@@ -261,21 +479,20 @@ uint64_t OrderBook::consumeAtLevel(Side passive, Price price, uint64_t qty) {
     if (!lvl || qty == 0) return 0ULL;
 
     uint64_t remaining = qty;
-    while (remaining > 0 && !lvl->orders.empty()) {
-        auto itFront = lvl->orders.begin();
-        Order& top = *itFront;
-        const uint64_t take = (top.size <= remaining) ? top.size : remaining;
-        top.size -= take;
-        remaining -= take;
-        lvl->totalSize -= take;
-
-        if (top.size == 0) {
-            const OrderKey k{ top.id, top.feedId, top.epoch, top.synthetic };
-            auto byIt = byId_.find(k);
-            if (byIt != byId_.end()) byId_.erase(byIt);
-            lvl->orders.erase(itFront);
+    while (remaining > 0 && !lvl->empty()) {
+        const uint32_t front = lvl->head;
+        OrderNode& top = pool_[front];
+        if (top.size <= remaining) {
+            // Fully filled: unlink takes its whole size off the level.
+            remaining -= top.size;
+            unlink(*lvl, front);
+            releaseOrder(front, top.key());
         } else {
-            break;
+            const uint64_t before = lvl->totalSize;
+            top.size -= remaining;
+            lvl->totalSize -= remaining;
+            remaining = 0;
+            syncDepth(passive, price.ticks, before, *lvl);
         }
     }
     eraseLevelIfEmpty(passive, price);
@@ -285,132 +502,241 @@ uint64_t OrderBook::consumeAtLevel(Side passive, Price price, uint64_t qty) {
 bool OrderBook::addImpl(const Order& o) {
     const OrderKey key = makeKeyFromOrder(o);
 
-    auto locIt = byId_.find(key);
-    if (locIt != byId_.end()) {
+    if (byId_.find(key, pool_) != kNoOrder) {
         deleteImpl(key); // cancel+add semantics within same scope
     }
 
-    PriceLevel& lvl = getOrCreateLevel(o.side, o.price);
-    lvl.orders.push_back(o);
-    auto itInLevel = std::prev(lvl.orders.end());
-    lvl.totalSize += o.size;
+    const uint32_t i = pool_.alloc();
+    OrderNode& n = pool_[i];
+    n.id = o.id; n.size = o.size; n.priority = o.priority; n.price = o.price.ticks;
+    n.feedId = o.feedId; n.epoch = o.epoch; n.side = o.side; n.synthetic = o.synthetic;
 
-    byId_.emplace(key, Locator{ o.side, o.price, itInLevel });
+    if (limited()) bandAdd(o.side, o.price.ticks, o.size);
+    else           linkBack(getOrCreateLevel(o.side, o.price), i);
+    byId_.insert(key, i);
     return true;
 }
 
 bool OrderBook::updateImpl(const OrderKey& key,
                            std::optional<Price> newPrice,
                            std::optional<uint64_t> newSize) {
-    auto it = byId_.find(key);
-    if (it == byId_.end()) return false;
+    const uint32_t i = byId_.find(key, pool_);
+    if (i == kNoOrder) return false;
+    if (limited()) return updateBand(i, key, newPrice, newSize);
 
-    Locator& loc = it->second;
-    PriceLevel* lvl = findLevel(loc.side, loc.price);
-    if (!lvl) { byId_.erase(it); return false; }
+    OrderNode& ord = pool_[i];
+    const Price oldPrice{ ord.price };
+    PriceLevel* lvl = findLevel(ord.side, oldPrice);
+    if (!lvl) { releaseOrder(i, key); return false; }
 
-    Order& ord = *loc.it;
-    const Price    oldPrice = ord.price;
     const uint64_t oldSize  = ord.size;
-
     const Price    tgtPrice = newPrice.has_value() ? *newPrice : oldPrice;
     const uint64_t tgtSize  = newSize.has_value() ? *newSize  : oldSize;
 
     if (tgtSize == 0) {
-        if (lvl->totalSize >= oldSize) lvl->totalSize -= oldSize;
-        else {
-            gma::util::logger().log(gma::util::LogLevel::Error,
-                "OrderBook: totalSize underflow detected",
-                {{"oldSize", std::to_string(oldSize)},
-                 {"totalSize", std::to_string(lvl->totalSize)}});
-            lvl->totalSize = 0;
-        }
-        lvl->orders.erase(loc.it);
-        eraseLevelIfEmpty(loc.side, oldPrice);
-        byId_.erase(it);
+        unlink(*lvl, i);
+        eraseLevelIfEmpty(ord.side, oldPrice);
+        releaseOrder(i, key);
         return true;
     }
 
     if (tgtPrice == oldPrice) {
         if (tgtSize == oldSize) return false;
+        const uint64_t before = lvl->totalSize;
         if (tgtSize > oldSize) lvl->totalSize += (tgtSize - oldSize);
         else                   lvl->totalSize -= (oldSize - tgtSize);
         ord.size = tgtSize;
+        syncDepth(ord.side, ord.price, before, *lvl);
         return true;
     }
 
-    // migrate price level — copy the order BEFORE erasing, since `ord` is a
-    // reference into the list node that erase() destroys (use-after-free).
-    Order moved = ord;
-    moved.price = tgtPrice;
-    moved.size  = tgtSize;
-
-    if (lvl->totalSize >= oldSize) lvl->totalSize -= oldSize;
-    else {
-        gma::util::logger().log(gma::util::LogLevel::Error,
-            "OrderBook: totalSize underflow detected",
-            {{"oldSize", std::to_string(oldSize)},
-             {"totalSize", std::to_string(lvl->totalSize)}});
-        lvl->totalSize = 0;
-    }
-    lvl->orders.erase(loc.it);
-    eraseLevelIfEmpty(loc.side, oldPrice);
-
-    PriceLevel& newLvl = getOrCreateLevel(loc.side, tgtPrice);
-    newLvl.orders.push_back(moved);
-    auto newIt = std::prev(newLvl.orders.end());
-    newLvl.totalSize += tgtSize;
+    // migrate price level: the record stays put, only its links move
+    unlink(*lvl, i);
+    eraseLevelIfEmpty(ord.side, oldPrice);
+    ord.price = tgtPrice.ticks;
+    ord.size  = tgtSize;
+    linkBack(getOrCreateLevel(ord.side, tgtPrice), i);
+    return true;
+}
 
-    loc.price = tgtPrice;
-    loc.it    = newIt;
+bool OrderBook::updateBand(uint32_t i, const OrderKey& key,
+                           std::optional<Price> newPrice,
+                           std::optional<uint64_t> newSize) {
+    OrderNode& ord = pool_[i];
+    const Side     side     = ord.side;
+    const int64_t  oldTicks = ord.price;
+    const uint64_t oldSize  = ord.size;
+    const int64_t  tgtTicks = newPrice.has_value() ? newPrice->ticks : oldTicks;
+    const uint64_t tgtSize  = newSize.has_value() ? *newSize : oldSize;
 
+    if (tgtSize == 0) {
+        releaseOrder(i, key);
+        bandRemove(side, oldTicks, oldSize);
+        bandRefill(side);
+        return true;
+    }
+    if (tgtTicks == oldTicks) {
+        if (tgtSize == oldSize) return false;
+        ord.size = tgtSize;
+        bandResize(side, oldTicks, oldSize, tgtSize);
+        return true;
+    }
+    bandRemove(side, oldTicks, oldSize);
+    ord.price = tgtTicks;
+    ord.size  = tgtSize;
+    bandAdd(side, tgtTicks, tgtSize);
+    bandRefill(side);
     return true;
 }
 
 bool OrderBook::deleteImpl(const OrderKey& key) {
-    auto it = byId_.find(key);
-    if (it == byId_.end()) return false;
-
-    const Locator loc = it->second;
-    PriceLevel* lvl = findLevel(loc.side, loc.price);
-    if (!lvl) { byId_.erase(it); return false; }
-
-    const uint64_t sz = loc.it->size;
-    if (lvl->totalSize >= sz) lvl->totalSize -= sz; else lvl->totalSize = 0;
-    lvl->orders.erase(loc.it);
-    eraseLevelIfEmpty(loc.side, loc.price);
-    byId_.erase(it);
+    const uint32_t i = byId_.find(key, pool_);
+    if (i == kNoOrder) return false;
+
+    const OrderNode& ord = pool_[i];
+    const Side  side = ord.side;
+    const Price price{ ord.price };
+    if (limited()) {
+        const uint64_t size = ord.size;
+        releaseOrder(i, key);
+        bandRemove(side, price.ticks, size);
+        bandRefill(side);
+        return true;
+    }
+    PriceLevel* lvl = findLevel(side, price);
+    if (!lvl) { releaseOrder(i, key); return false; }
+
+    unlink(*lvl, i);
+    eraseLevelIfEmpty(side, price);
+    releaseOrder(i, key);
     return true;
 }
 
 // ----- Priority change: move-to-back -----
 bool OrderBook::priorityImpl(const OrderKey& key, uint64_t newPriority) {
-    auto it = byId_.find(key);
-    if (it == byId_.end()) return false;
+    const uint32_t i = byId_.find(key, pool_);
+    if (i == kNoOrder) return false;
 
-    Locator& loc = it->second;
-    PriceLevel* lvl = findLevel(loc.side, loc.price);
-    if (!lvl) { byId_.erase(it); return false; }
+    OrderNode& ord = pool_[i];
+    if (limited()) {                                          // no queue to move in
+        if (ord.priority == newPriority) return false;
+        ord.priority = newPriority;
+        return true;
+    }
+    PriceLevel* lvl = findLevel(ord.side, Price{ ord.price });
+    if (!lvl) { releaseOrder(i, key); return false; }
 
-    Order& ord = *loc.it;
     if (ord.priority == newPriority) return false;
     ord.priority = newPriority;
 
-    auto last = lvl->orders.end();
-    --last;
-    if (loc.it != last) {
-        lvl->orders.splice(lvl->orders.end(), lvl->orders, loc.it);
-        // iterator remains valid and still points to the same element
+    if (lvl->tail != i) {
+        unlink(*lvl, i);
+        linkBack(*lvl, i);
     }
     return true;
 }
 
-// --------- Clearers ---------
-void OrderBook::clearPerOrderUnlocked() {
-    bids_.clear(); asks_.clear(); byId_.clear();
+// --------- Bulk loads ---------
+namespace {
+
+// One input row, ordered best-first by price and then by input position.
+struct LoadEntry {
+    int64_t  ticks;
+    uint32_t pos;
+};
+
+void sortBestFirst(std::vector<LoadEntry>& v, bool descending) {
+    std::sort(v.begin(), v.end(), [descending](const LoadEntry& a, const LoadEntry& b) {
+        if (a.ticks != b.ticks) return descending ? a.ticks > b.ticks : a.ticks < b.ticks;
+        return a.pos < b.pos;
+    });
+}
+
+} // namespace
+
+// Orders are linked into per-price groups in input order as they arrive
+// (a hash lookup per order, no ordered insert) and indexed in one batch;
+// only the distinct prices are then sorted and appended to the ladders
+// best-first.
+void OrderBook::loadPerOrder(const std::vector<Order>& orders) {
+    if (orders.size() >= kNoOrder) throw std::runtime_error("OrderBook: snapshot too large");
+    std::vector<PriceLevel> groups;
+    std::vector<LoadEntry> prices[2];                         // ticks, group
+    std::unordered_map<int64_t, uint32_t> groupOf[2];
+
+    // Venue snapshots usually list a level's orders together: skip the
+    // lookup while the price repeats.
+    uint32_t g = kNoOrder;
+    Side lastSide = Side::Bid;
+    int64_t lastTicks = 0;
+    for (const Order& o : orders) {
+        // The pool is fresh, so records are numbered in input order.
+        const uint32_t i = pool_.alloc();
+        OrderNode& n = pool_[i];
+        n.id = o.id; n.size = o.size; n.priority = o.priority; n.price = o.price.ticks;
+        n.feedId = o.feedId; n.epoch = o.epoch; n.side = o.side; n.synthetic = o.synthetic;
+        if (limited()) continue;                              // no queues to build
+
+        if (g == kNoOrder || o.side != lastSide || o.price.ticks != lastTicks) {
+            const int side = o.side == Side::Bid ? 0 : 1;
+            auto [it, fresh] = groupOf[side].try_emplace(o.price.ticks, static_cast<uint32_t>(groups.size()));
+            if (fresh) {
+                groups.emplace_back();
+                prices[side].push_back(LoadEntry{ o.price.ticks, it->second });
+            }
+            g = it->second;
+            lastSide = o.side;
+            lastTicks = o.price.ticks;
+        }
+        linkQuiet(groups[g], i);
+    }
+
+    // A repeated key replaces the earlier order, as a repeated add would.
+    for (const uint32_t dup : byId_.bulkLoad(static_cast<uint32_t>(orders.size()), pool_)) {
+        const OrderNode& n = pool_[dup];
+        if (!limited()) unlinkQuiet(groups[groupOf[n.side == Side::Bid ? 0 : 1].at(n.price)], dup);
+        pool_.release(dup);
+    }
+
+    if (limited()) {
+        auto quiet = [](int64_t, uint64_t, uint64_t) {};
+        byId_.forEach([&](uint32_t i) {
+            const OrderNode& n = pool_[i];
+            band(n.side).add(n.price, n.size, quiet);
+        });
+        return;
+    }
+
+    for (const Side s : { Side::Bid, Side::Ask }) {
+        std::vector<LoadEntry>& v = prices[s == Side::Bid ? 0 : 1];
+        sortBestFirst(v, s == Side::Bid);
+        for (const LoadEntry& e : v) {
+            const PriceLevel& src = groups[e.pos];
+            if (src.empty()) continue;                        // emptied by replacements
+            ladder(s).appendWorse(e.ticks) = src;
+            depth(s).set(e.ticks, src.totalSize, src.count);
+        }
+    }
 }
-void OrderBook::clearAggregatedUnlocked() {
-    bidsAgg_.clear(); asksAgg_.clear();
+
+void OrderBook::loadAggregated(const std::vector<LevelSnapshotEntry>& levels) {
+    std::vector<LoadEntry> sides[2];
+    for (uint32_t i = 0; i < levels.size(); ++i) {
+        const LevelSnapshotEntry& e = levels[i];
+        if (e.totalSize == 0) continue;
+        sides[e.side == Side::Bid ? 0 : 1].push_back(LoadEntry{ e.price.ticks, i });
+    }
+    for (const Side s : { Side::Bid, Side::Ask }) {
+        std::vector<LoadEntry>& v = sides[s == Side::Bid ? 0 : 1];
+        sortBestFirst(v, s == Side::Bid);
+        for (std::size_t k = 0; k < v.size(); ++k) {
+            if (k + 1 < v.size() && v[k + 1].ticks == v[k].ticks) continue;   // last entry wins
+            const LevelSnapshotEntry& e = levels[v[k].pos];
+            LevelAgg& lvl = aggLadder(s).appendWorse(v[k].ticks);
+            lvl.totalSize = e.totalSize;
+            lvl.orderCount = e.orderCount.value_or(0);
+        }
+    }
 }
 
 // --------- D7/D8 helpers ---------
@@ -429,10 +755,10 @@ OrderKey OrderBook::applyAddGetKey(const Order& o, FeedScope scope, bool idMissi
 
 bool OrderBook::locate(const OrderKey& key, Side& outSide, Price& outPrice) const {
     std::scoped_lock lk(m_);
-    auto it = byId_.find(key);
-    if (it == byId_.end()) return false;
-    outSide = it->second.side;
-    outPrice = it->second.price;
+    const uint32_t i = byId_.find(key, pool_);
+    if (i == kNoOrder) return false;
+    outSide = pool_[i].side;
+    outPrice = Price{ pool_[i].price };
     return true;
 }
 
@@ -1,5 +1,7 @@
 #include "gma/book/OrderBookManager.hpp"
+#include <algorithm>
 #include <cmath>
+#include <deque>
 #include <limits>
 #include <unordered_set>
 #include <iomanip>
@@ -8,15 +10,98 @@ using std::string;
 
 namespace gma {
 
+namespace {
+
+// Deltas handed to subscribers are built in per-thread scratch so a
+// publish allocates nothing once warm. One slot per nesting level: a
+// handler may mutate a book and publish in turn before returning.
+struct DeltaScratch {
+    std::deque<BookDelta> slots;
+    size_t depth = 0;
+};
+thread_local DeltaScratch tlsDeltas;
+
+struct ScratchSlot {
+    BookDelta& d;
+    ScratchSlot() : d(acquire()) {}
+    ~ScratchSlot() { --tlsDeltas.depth; }
+    ScratchSlot(const ScratchSlot&) = delete;
+    ScratchSlot& operator=(const ScratchSlot&) = delete;
+private:
+    static BookDelta& acquire() {
+        if (tlsDeltas.depth == tlsDeltas.slots.size()) tlsDeltas.slots.emplace_back();
+        return tlsDeltas.slots[tlsDeltas.depth++];
+    }
+};
+
+} // namespace
+
+OrderBookManager::OrderBookManager(size_t shards)
+    : shards_(std::make_unique<Shard[]>(shards ? shards : 1))
+    , shardCount_(shards ? shards : 1) {}
+
+// ---------- Symbol state ----------
+OrderBookManager::Shard& OrderBookManager::shardFor_(const std::string& symbol) const {
+    return shards_[std::hash<std::string>{}(symbol) % shardCount_];
+}
+OrderBookManager::SymbolState* OrderBookManager::find_(const std::string& symbol) const {
+    Shard& sh = shardFor_(symbol);
+    std::shared_lock lk(sh.mx);
+    auto it = sh.symbols.find(symbol);
+    return (it == sh.symbols.end()) ? nullptr : it->second.get();
+}
+OrderBookManager::SymbolState& OrderBookManager::getOrCreate_(const std::string& symbol) {
+    Shard& sh = shardFor_(symbol);
+    {
+        std::shared_lock rlk(sh.mx);
+        auto it = sh.symbols.find(symbol);
+        if (it != sh.symbols.end()) return *it->second;
+    }
+    std::unique_lock wlk(sh.mx);
+    auto [it, inserted] = sh.symbols.try_emplace(symbol);
+    if (!inserted) return *it->second;
+    it->second = std::make_unique<SymbolState>();
+    it->second->resolver.setCap(resolverCap_.load(std::memory_order_relaxed));
+    SymbolState& st = *it->second;
+    wlk.unlock();
+
+    // Outside the shard lock: handlers may subscribe to the new symbol.
+
+    std::shared_ptr<const SymbolSubList> subs;
+    {
+        std::lock_guard<std::mutex> lk(symbolSubsMx_);
+        subs = symbolSubs_;
+    }
+    if (subs) for (const auto& [id, fn] : *subs) fn(symbol);
+    return st;
+}
+OrderBook& OrderBookManager::bookOf_(SymbolState& st) {
+    if (!st.bookOwner) {
+        LadderConfig cfg;
+        if (st.ladder) cfg = *st.ladder;
+        else { std::lock_guard<std::mutex> lk(defaultsMx_); cfg = defaultLadder_; }
+        st.bookOwner = std::make_unique<OrderBook>(cfg, hugePages_.load(std::memory_order_relaxed));
+        st.changes.reserve(8);
+        st.bookOwner->setChangeLog(&st.changes);
+        st.book.store(st.bookOwner.get(), std::memory_order_release);
+    }
+    return *st.bookOwner;
+}
+void OrderBookManager::publishTob_(SymbolState& st, std::optional<Price> bid, uint64_t bidSz,
+                                   std::optional<Price> ask, uint64_t askSz) {
+    TopOfBook::View v;
+    v.hasBid = bid.has_value(); v.bid = bid ? bid->ticks : 0; v.bidSize = bid ? bidSz : 0;
+    v.hasAsk = ask.has_value(); v.ask = ask ? ask->ticks : 0; v.askSize = ask ? askSz : 0;
+    st.tob.store(v);
+}
+
 // ---------- Tick-size ----------
 void OrderBookManager::setTickSize(const std::string& symbol, double tickSize) {
-    std::unique_lock lk(booksMx_);
-    tickSize_[symbol] = tickSize > 0 ? tickSize : kDefaultTick;
+    getOrCreate_(symbol).tickSize.store(tickSize > 0 ? tickSize : kDefaultTick, std::memory_order_relaxed);
 }
 double OrderBookManager::getTickSize(const std::string& symbol) const {
-    std::shared_lock lk(booksMx_);
-    auto it = tickSize_.find(symbol);
-    return (it == tickSize_.end()) ? kDefaultTick : it->second;
+    const SymbolState* st = find_(symbol);
+    return st ? st->tickSize.load(std::memory_order_relaxed) : kDefaultTick;
 }
 int64_t OrderBookManager::quantizeTicks(double px, double tick) {
     if (tick <= 0.0) return 0;
@@ -34,29 +119,35 @@ double OrderBookManager::toDouble(const std::string& symbol, Price p) const {
     return static_cast<double>(p.ticks) * t;
 }
 
-// ---------- Book access ----------
-OrderBook& OrderBookManager::getOrCreateBook_(const std::string& symbol) {
-    {
-        std::shared_lock rlk(booksMx_);
-        auto it = books_.find(symbol);
-        if (it != books_.end()) return it->second;
-    }
-    std::unique_lock wlk(booksMx_);
-    return books_.try_emplace(symbol).first->second;
+// ---------- Ladder storage ----------
+void OrderBookManager::setLadder(const std::string& symbol, const LadderConfig& cfg) {
+    SymbolState& st = getOrCreate_(symbol);
+    std::lock_guard<std::mutex> lk(st.mx);
+    st.ladder = cfg;
+}
+void OrderBookManager::setDefaultLadder(const LadderConfig& cfg) {
+    std::lock_guard<std::mutex> lk(defaultsMx_);
+    defaultLadder_ = cfg;
 }
-OrderBook& OrderBookManager::book(const std::string& symbol) { return getOrCreateBook_(symbol); }
-const OrderBook* OrderBookManager::findBook_(const std::string& symbol) const {
-    std::shared_lock rlk(booksMx_);
-    auto it = books_.find(symbol);
-    return (it != books_.end()) ? &it->second : nullptr;
+void OrderBookManager::setHugePages(bool on) {
+    hugePages_.store(on, std::memory_order_relaxed);
+}
+LadderKind OrderBookManager::ladderKind(const std::string& symbol) const {
+    if (SymbolState* st = find_(symbol)) {
+        if (const OrderBook* b = st->book.load(std::memory_order_acquire)) return b->ladderKind();
+        std::lock_guard<std::mutex> lk(st->mx);
+        if (st->ladder) return st->ladder->kind;
+    }
+    std::lock_guard<std::mutex> lk(defaultsMx_);
+    return defaultLadder_.kind;
 }
 
 // ---------- validation helpers ----------
-bool OrderBookManager::validatePrice_(const std::string& symbol, double px) const {
+bool OrderBookManager::validatePrice_(const SymbolState& st, double px) const {
     if (std::isnan(px) || std::isinf(px)) return false;
     if (px == 0.0) return false;  // zero price is never valid
-    if (!allowNegativePrices_ && px < 0.0) return false;
-    const double t = getTickSize(symbol);
+    if (!allowNegativePrices_.load(std::memory_order_relaxed) && px < 0.0) return false;
+    const double t = st.tickSize.load(std::memory_order_relaxed);
     double q = px / t;
     double r = std::fabs(q - std::round(q));
     return r < 1e-8;
@@ -64,164 +155,263 @@ bool OrderBookManager::validatePrice_(const std::string& symbol, double px) cons
 
 // ---------- Feed state / Sequencing ----------
 bool OrderBookManager::onSeq(const std::string& symbol, uint64_t seq) {
-    std::lock_guard<std::mutex> lk(feedMx_);
-    auto& st = feed_[symbol];
-    if (st.stale) { metrics_.incDroppedStale(); return false; }
-    if (st.lastSeq == 0) { st.lastSeq = seq; return true; }
-    if (seq == st.lastSeq + 1) { st.lastSeq = seq; return true; }
-    // GAP
-    st.stale = true;
-    metrics_.incSeqGap();
-    metrics_.incStaleTransition();
+    SymbolState& sym = getOrCreate_(symbol);
+    {
+        std::lock_guard<std::mutex> lk(sym.mx);
+        auto& st = sym.feed;
+        sym.feedSeen = true;
+        if (st.stale) { metrics_.incDroppedStale(); return false; }
+        if (st.lastSeq == 0) { st.lastSeq = seq; return true; }
+        if (seq == st.lastSeq + 1) { st.lastSeq = seq; return true; }
+        // GAP
+        st.stale = true;
+        sym.version.fetch_add(1, std::memory_order_release);
+        metrics_.incSeqGap();
+        metrics_.incStaleTransition();
+    }
     if (requestSnapshotFn) requestSnapshotFn(symbol);
     return false;
 }
 
 void OrderBookManager::onReset(const std::string& symbol, uint32_t newEpoch) {
-    std::lock_guard<std::mutex> lk(feedMx_);
-    auto& st = feed_[symbol];
-    st.epoch = newEpoch; st.stale = true; st.lastSeq = 0;
-    metrics_.incSeqReset();
-    metrics_.incStaleTransition();
+    SymbolState& sym = getOrCreate_(symbol);
+    {
+        std::lock_guard<std::mutex> lk(sym.mx);
+        auto& st = sym.feed;
+        sym.feedSeen = true;
+        st.epoch = newEpoch; st.stale = true; st.lastSeq = 0;
+        sym.version.fetch_add(1, std::memory_order_release);
+        metrics_.incSeqReset();
+        metrics_.incStaleTransition();
+    }
     if (requestSnapshotFn) requestSnapshotFn(symbol);
 }
 
 bool OrderBookManager::isStale(const std::string& symbol) const {
-    std::lock_guard<std::mutex> lk(feedMx_);
-    auto it = feed_.find(symbol); if (it == feed_.end()) return false;
-    return it->second.stale;
+    SymbolState* st = find_(symbol); if (!st) return false;
+    std::lock_guard<std::mutex> lk(st->mx);
+    return st->feed.stale;
 }
 OrderBookManager::FeedState OrderBookManager::getFeedState(const std::string& symbol) const {
-    std::lock_guard<std::mutex> lk(feedMx_);
-    auto it = feed_.find(symbol); if (it == feed_.end()) return FeedState{};
-    return it->second;
-}
-bool OrderBookManager::gate_(const std::string& symbol) const {
-    std::lock_guard<std::mutex> lk(feedMx_);
-    auto it = feed_.find(symbol); if (it == feed_.end()) return false;
-    return it->second.stale;
+    SymbolState* st = find_(symbol); if (!st) return FeedState{};
+    std::lock_guard<std::mutex> lk(st->mx);
+    return st->feed;
 }
 
 // ---------- Resolver ----------
 void OrderBookManager::resolverSetCapacity(size_t cap) {
-    std::lock_guard<std::mutex> lk(resolverMx_);
-    for (auto& kv : resolver_) kv.second.setCap(cap);
+    resolverCap_.store(cap, std::memory_order_relaxed);
+    for (size_t i = 0; i < shardCount_; ++i) {
+        std::shared_lock slk(shards_[i].mx);
+        for (auto& kv : shards_[i].symbols) {
+            std::lock_guard<std::mutex> lk(kv.second->mx);
+            kv.second->resolver.setCap(cap);
+        }
+    }
 }
 void OrderBookManager::resolverPut(const std::string& symbol, const std::string& venueKey, const OrderKey& key) {
-    std::lock_guard<std::mutex> lk(resolverMx_);
-    resolver_[symbol].put(venueKey, key);
+    SymbolState& st = getOrCreate_(symbol);
+    std::lock_guard<std::mutex> lk(st.mx);
+    st.resolver.put(venueKey, key);
 }
 std::optional<OrderKey> OrderBookManager::resolverGet(const std::string& symbol, const std::string& venueKey) const {
-    std::lock_guard<std::mutex> lk(resolverMx_);
-    auto it = resolver_.find(symbol); if (it == resolver_.end()) return std::nullopt;
-    return it->second.cget(venueKey);
+    SymbolState* st = find_(symbol); if (!st) return std::nullopt;
+    std::lock_guard<std::mutex> lk(st->mx);
+    return st->resolver.cget(venueKey);
+}
+
+uint64_t OrderBookManager::Lru::hashOf(std::string_view k) noexcept {
+    const uint64_t h = std::hash<std::string_view>{}(k);
+    return h == RefTable<uint32_t>::kNoRef ? h - 1 : h;
+}
+
+void OrderBookManager::Lru::put(std::string_view k, const OrderKey& v) {
+    const uint64_t h = hashOf(k);
+    if (const uint32_t* at = idx_.find(h)) {
+        const uint32_t i = *at;
+        if (keyOf(arena_[i]) == k) {
+            arena_[i].key = v;
+            unlink(i);
+            pushFront(i);
+            return;
+        }
+        drop(i);                                     // hash collision: the older key goes
+    }
+    if (garbage_ > keys_.size() / 2) compactKeys();
+
+    uint32_t i = free_;
+    if (i != kNoOrder) free_ = arena_[i].next;
+    else { i = static_cast<uint32_t>(arena_.size()); arena_.emplace_back(); }
+    Entry& e = arena_[i];
+    e.key = v;
+    e.hash = h;
+    e.off = static_cast<uint32_t>(keys_.size());
+    e.len = static_cast<uint32_t>(k.size());
+    keys_.append(k);
+    pushFront(i);
+    idx_.put(h, i);
+    trim();
+}
+
+std::optional<OrderKey> OrderBookManager::Lru::cget(std::string_view k) const {
+    const uint32_t* at = idx_.find(hashOf(k));
+    if (!at || keyOf(arena_[*at]) != k) return std::nullopt;
+    return arena_[*at].key;
+}
+
+void OrderBookManager::Lru::unlink(uint32_t i) noexcept {
+    Entry& e = arena_[i];
+    if (e.prev != kNoOrder) arena_[e.prev].next = e.next; else head_ = e.next;
+    if (e.next != kNoOrder) arena_[e.next].prev = e.prev; else tail_ = e.prev;
+    e.prev = e.next = kNoOrder;
+}
+
+void OrderBookManager::Lru::pushFront(uint32_t i) noexcept {
+    Entry& e = arena_[i];
+    e.prev = kNoOrder;
+    e.next = head_;
+    if (head_ != kNoOrder) arena_[head_].prev = i; else tail_ = i;
+    head_ = i;
+}
+
+void OrderBookManager::Lru::drop(uint32_t i) {
+    unlink(i);
+    idx_.erase(arena_[i].hash);
+    garbage_ += arena_[i].len;
+    arena_[i].next = free_;
+    free_ = i;
+}
+
+void OrderBookManager::Lru::trim() {
+    while (idx_.size() > cap_) drop(tail_);
+}
+
+// Rewrite keys_ with live entries only, MRU first.
+void OrderBookManager::Lru::compactKeys() {
+    std::string live;
+    live.reserve(keys_.size() - garbage_);
+    for (uint32_t i = head_; i != kNoOrder; i = arena_[i].next) {
+        Entry& e = arena_[i];
+        const auto off = static_cast<uint32_t>(live.size());
+        live.append(keys_, e.off, e.len);
+        e.off = off;
+    }
+    keys_.swap(live);
+    garbage_ = 0;
 }
 
 // ---------- Event bus ----------
 uint64_t OrderBookManager::subscribeDeltas(const std::string& symbol, DeltaHandler handler) {
-    std::lock_guard<std::mutex> lk(subsMx_);
-    uint64_t id = nextSubId_++;
-    subs_[symbol][id] = std::move(handler);
+    // Find-only: subscribers name symbols on behalf of clients, and must
+    // not leave permanent state for names the feed never sends.
+    SymbolState* st = find_(symbol); if (!st) return 0;
+    const uint64_t id = nextSubId_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lk(st->mx);
+    auto next = st->subs ? std::make_shared<SubList>(*st->subs) : std::make_shared<SubList>();
+    next->emplace_back(id, std::move(handler));
+    st->subs = std::move(next);
     return id;
 }
 void OrderBookManager::unsubscribeDeltas(const std::string& symbol, uint64_t subId) {
-    std::lock_guard<std::mutex> lk(subsMx_);
-    auto it = subs_.find(symbol);
-    if (it == subs_.end()) return;
-    it->second.erase(subId);
+    SymbolState* st = find_(symbol); if (!st) return;
+    std::lock_guard<std::mutex> lk(st->mx);
+    if (!st->subs) return;
+    auto next = std::make_shared<SubList>();
+    for (const auto& s : *st->subs) if (s.first != subId) next->push_back(s);
+    if (next->size() == st->subs->size()) return;
+    if (next->empty()) st->subs.reset();
+    else               st->subs = std::move(next);
+}
+
+uint64_t OrderBookManager::subscribeSymbols(SymbolHandler handler) {
+    const uint64_t id = nextSubId_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lk(symbolSubsMx_);
+    auto next = symbolSubs_ ? std::make_shared<SymbolSubList>(*symbolSubs_) : std::make_shared<SymbolSubList>();
+    next->emplace_back(id, std::move(handler));
+    symbolSubs_ = std::move(next);
+    return id;
+}
+void OrderBookManager::unsubscribeSymbols(uint64_t subId) {
+    std::lock_guard<std::mutex> lk(symbolSubsMx_);
+    if (!symbolSubs_) return;
+    auto next = std::make_shared<SymbolSubList>();
+    for (const auto& s : *symbolSubs_) if (s.first != subId) next->push_back(s);
+    if (next->size() == symbolSubs_->size()) return;
+    if (next->empty()) symbolSubs_.reset();
+    else               symbolSubs_ = std::move(next);
 }
 
-void OrderBookManager::maybePublishDelta_(const std::string& symbol,
-                                          const std::vector<LevelDelta>& levels,
+void OrderBookManager::maybePublishDelta_(SymbolState& st, std::unique_lock<std::mutex>& lk,
+                                          const std::string& symbol,
+                                          const std::vector<LevelChange>& levels,
                                           std::optional<std::pair<Price,uint64_t>> newBid,
                                           std::optional<std::pair<Price,uint64_t>> newAsk) {
-    if (levels.empty() && !newBid && !newAsk) return;
+    const bool anyLevel = std::any_of(levels.begin(), levels.end(),
+                                      [](const LevelChange& c) { return c.before != c.after; });
+    if (!anyLevel && !newBid && !newAsk) { lk.unlock(); return; }
 
-    BookDelta d;
-    d.symbol = symbol;
-    d.levels = levels;
+    metrics_.incDeltasPublished();
+    const uint64_t seq = ++st.pubSeq;
+    if (!st.subs) { lk.unlock(); return; }
+
+    ScratchSlot slot;
+    BookDelta& d = slot.d;
+    d.symbol.assign(symbol);
+    d.seq = seq;
+    d.levels.clear();
+    for (const auto& c : levels) {
+        if (c.before != c.after) d.levels.push_back(LevelDelta{ c.side, Price{c.ticks}, c.after });
+    }
     d.bid = newBid;
     d.ask = newAsk;
 
-    // metrics
-    metrics_.incDeltasPublished();
-
-    // fan-out (pubSeq_ and subs_ both under subsMx_)
-    std::unordered_map<uint64_t, DeltaHandler> handlersCopy;
-    {
-        std::lock_guard<std::mutex> lk(subsMx_);
-        d.seq = ++pubSeq_[symbol];
-        auto it = subs_.find(symbol);
-        if (it != subs_.end()) handlersCopy = it->second;
-    }
-    for (auto& kv : handlersCopy) kv.second(d);
+    // fan-out outside the symbol lock so handlers may call back in
+    std::shared_ptr<const SubList> subs = st.subs;
+    lk.unlock();
+    for (const auto& s : *subs) s.second(d);
 }
 
-// before/after wrapper that computes level & TOB changes
+// Level changes come from the book's change log; the previous top of book
+// is the published copy, which matches the book while st.mx is held.
 template <typename Fn>
-bool OrderBookManager::mutateWithDelta_(const std::string& symbol,
-                                        const std::vector<std::pair<Side,Price>>& candidates,
-                                        Fn&& mutator) {
-    OrderBook& b = book(symbol);
-
-    // Pre-TOB
-    auto preBid = b.bestBid();
-    uint64_t preBidSz = b.bestBidSize();
-    auto preAsk = b.bestAsk();
-    uint64_t preAskSz = b.bestAskSize();
-
-    // Probes
-    struct Probe { Side s; Price p; uint64_t before; };
-    std::vector<Probe> probes; probes.reserve(candidates.size());
-    auto addProbe = [&](Side s, Price p){
-        for (const auto& pr : probes) if (pr.s==s && pr.p.ticks==p.ticks) return;
-        probes.push_back(Probe{s,p,b.levelSize(s,p)});
-    };
-    for (auto& c : candidates) addProbe(c.first, c.second);
-
-    // Mutate
-    bool changed = mutator();
-    if (!changed) return false;
-
-    // Post-TOB
-    auto postBid = b.bestBid();
-    uint64_t postBidSz = b.bestBidSize();
-    auto postAsk = b.bestAsk();
-    uint64_t postAskSz = b.bestAskSize();
-
-    // Level deltas
-    std::vector<LevelDelta> levels;
-    levels.reserve(probes.size());
-    for (auto& pr : probes) {
-        uint64_t after = b.levelSize(pr.s, pr.p);
-        if (after != pr.before) levels.push_back(LevelDelta{ pr.s, pr.p, after });
-    }
+bool OrderBookManager::mutateWithDelta_(SymbolState& st, std::unique_lock<std::mutex>& lk,
+                                        const std::string& symbol, Fn&& mutator) {
+    OrderBook& b = bookOf_(st);
+    st.changes.clear();
+    if (!mutator(b)) return false;
+    st.version.fetch_add(1, std::memory_order_release);
+    // Nothing on the per-order ladders moved (priority, level summary).
+    if (st.changes.empty()) return true;
+
+    const TopOfBook::View pre = st.tob.load();
+    const BookTop post = b.top();
+    const bool bidChanged = pre.hasBid != post.bid.has_value() ||
+                            (post.bid && (pre.bid != post.bid->ticks || pre.bidSize != post.bidSize));
+    const bool askChanged = pre.hasAsk != post.ask.has_value() ||
+                            (post.ask && (pre.ask != post.ask->ticks || pre.askSize != post.askSize));
+    if (bidChanged || askChanged) publishTob_(st, post.bid, post.bidSize, post.ask, post.askSize);
 
-    // TOB deltas
     std::optional<std::pair<Price,uint64_t>> nbid, nask;
-    const bool bidChanged = (preBid.has_value() != postBid.has_value()) ||
-                            (preBid && postBid && (preBid->ticks != postBid->ticks || preBidSz != postBidSz));
-    const bool askChanged = (preAsk.has_value() != postAsk.has_value()) ||
-                            (preAsk && postAsk && (preAsk->ticks != postAsk->ticks || preAskSz != postAskSz));
-    if (postBid && bidChanged) nbid = std::make_pair(*postBid, postBidSz);
-    if (postAsk && askChanged) nask = std::make_pair(*postAsk, postAskSz);
-
-    maybePublishDelta_(symbol, levels, nbid, nask);
+    if (post.bid && bidChanged) nbid = std::make_pair(*post.bid, post.bidSize);
+    if (post.ask && askChanged) nask = std::make_pair(*post.ask, post.askSize);
+
+    maybePublishDelta_(st, lk, symbol, st.changes, nbid, nask);
     return true;
 }
 
 // ---------- Adds ----------
 OrderKey OrderBookManager::onAddGetKey(const std::string& symbol, uint64_t id, Side side, double price, uint64_t size,
                                        uint64_t priority, FeedScope scope, bool idMissing) {
-    if (gate_(symbol)) { metrics_.incDroppedStale(); return OrderKey{0,scope.feedId,scope.epoch,true}; }
-    if (!validSide(side) || !validatePrice_(symbol, price) || !validateSize_(size)) { metrics_.incDroppedMalformed(); return {}; }
+    SymbolState& st = getOrCreate_(symbol);
+    std::unique_lock<std::mutex> lk(st.mx);
+    if (st.feed.stale) { metrics_.incDroppedStale(); return OrderKey{0,scope.feedId,scope.epoch,true}; }
+    if (!validSide(side) || !validatePrice_(st, price) || !validateSize_(size)) { metrics_.incDroppedMalformed(); return {}; }
     metrics_.incAdds();
 
-    Order o; o.id=id; o.side=side; o.price=toTicks(symbol,price); o.size=size; o.priority=priority;
-    auto candidates = std::vector<std::pair<Side,Price>>{ {side, o.price} };
+    Order o; o.id=id; o.side=side; o.price=toTicks_(st,price); o.size=size; o.priority=priority;
     OrderKey outKey{};
-    mutateWithDelta_(symbol, candidates, [&]{
-        outKey = book(symbol).applyAddGetKey(o, scope, idMissing);
+    mutateWithDelta_(st, lk, symbol, [&](OrderBook& b){
+        outKey = b.applyAddGetKey(o, scope, idMissing);
         return true;
     });
     return outKey;
@@ -229,79 +419,57 @@ OrderKey OrderBookManager::onAddGetKey(const std::string& symbol, uint64_t id, S
 
 bool OrderBookManager::onAdd(const std::string& symbol, uint64_t id, Side side, double price, uint64_t size,
                              uint64_t priority, FeedScope scope, bool idMissing) {
-    if (gate_(symbol)) { metrics_.incDroppedStale(); return false; }
-    if (!validSide(side) || !validatePrice_(symbol, price) || !validateSize_(size)) { metrics_.incDroppedMalformed(); return false; }
+    SymbolState& st = getOrCreate_(symbol);
+    std::unique_lock<std::mutex> lk(st.mx);
+    if (st.feed.stale) { metrics_.incDroppedStale(); return false; }
+    if (!validSide(side) || !validatePrice_(st, price) || !validateSize_(size)) { metrics_.incDroppedMalformed(); return false; }
     metrics_.incAdds();
 
-    Order o; o.id=id; o.side=side; o.price=toTicks(symbol,price); o.size=size; o.priority=priority;
-    auto candidates = std::vector<std::pair<Side,Price>>{ {side, o.price} };
-    return mutateWithDelta_(symbol, candidates, [&]{ return book(symbol).applyAdd(o, scope, idMissing); });
+    Order o; o.id=id; o.side=side; o.price=toTicks_(st,price); o.size=size; o.priority=priority;
+    return mutateWithDelta_(st, lk, symbol, [&](OrderBook& b){ return b.applyAdd(o, scope, idMissing); });
 }
 
 // ---------- Update/Delete/Priority ----------
 bool OrderBookManager::onUpdate(const std::string& symbol, uint64_t id, FeedScope scope,
                                 std::optional<double> newPrice, std::optional<uint64_t> newSize,
                                 bool synthetic) {
-    if (gate_(symbol)) { metrics_.incDroppedStale(); return false; }
-    if (!newPrice && !newSize) { metrics_.incDroppedMalformed(); return false; }
-    if (newPrice && !validatePrice_(symbol, *newPrice)) { metrics_.incDroppedMalformed(); return false; }
-    if (newSize && !validateSize_(*newSize)) { metrics_.incDroppedMalformed(); return false; }
-    metrics_.incUpdates();
-
-    std::optional<Price> p; if (newPrice) p = toTicks(symbol, *newPrice);
-    OrderKey key{ id, scope.feedId, scope.epoch, synthetic };
-
-    Side oldSide; Price oldPrice;
-    std::vector<std::pair<Side,Price>> candidates;
-    if (book(symbol).locate(key, oldSide, oldPrice)) candidates.emplace_back(oldSide, oldPrice);
-    if (newPrice) candidates.emplace_back(oldSide, toTicks(symbol, *newPrice));
-    return mutateWithDelta_(symbol, candidates, [&]{ return book(symbol).applyUpdate(key, p, newSize); });
+    return onUpdate(symbol, OrderKey{ id, scope.feedId, scope.epoch, synthetic }, newPrice, newSize);
 }
 
 bool OrderBookManager::onUpdate(const std::string& symbol, const OrderKey& key,
                                 std::optional<double> newPrice, std::optional<uint64_t> newSize) {
-    if (gate_(symbol)) { metrics_.incDroppedStale(); return false; }
+    SymbolState& st = getOrCreate_(symbol);
+    std::unique_lock<std::mutex> lk(st.mx);
+    if (st.feed.stale) { metrics_.incDroppedStale(); return false; }
     if (!newPrice && !newSize) { metrics_.incDroppedMalformed(); return false; }
-    if (newPrice && !validatePrice_(symbol, *newPrice)) { metrics_.incDroppedMalformed(); return false; }
+    if (newPrice && !validatePrice_(st, *newPrice)) { metrics_.incDroppedMalformed(); return false; }
     if (newSize && !validateSize_(*newSize)) { metrics_.incDroppedMalformed(); return false; }
     metrics_.incUpdates();
 
-    Side oldSide; Price oldPrice;
-    std::vector<std::pair<Side,Price>> candidates;
-    if (book(symbol).locate(key, oldSide, oldPrice)) candidates.emplace_back(oldSide, oldPrice);
-    if (newPrice) candidates.emplace_back(oldSide, toTicks(symbol, *newPrice));
-
-    std::optional<Price> p; if (newPrice) p = toTicks(symbol, *newPrice);
-    return mutateWithDelta_(symbol, candidates, [&]{ return book(symbol).applyUpdate(key, p, newSize); });
+    std::optional<Price> p; if (newPrice) p = toTicks_(st, *newPrice);
+    return mutateWithDelta_(st, lk, symbol, [&](OrderBook& b){ return b.applyUpdate(key, p, newSize); });
 }
 
 bool OrderBookManager::onDelete(const std::string& symbol, uint64_t id, FeedScope scope, bool synthetic) {
-    if (gate_(symbol)) { metrics_.incDroppedStale(); return false; }
-    metrics_.incDeletes();
-    OrderKey key{ id, scope.feedId, scope.epoch, synthetic };
-
-    Side s; Price p; std::vector<std::pair<Side,Price>> candidates;
-    if (book(symbol).locate(key, s, p)) candidates.emplace_back(s, p);
-    return mutateWithDelta_(symbol, candidates, [&]{ return book(symbol).applyDelete(key); });
+    return onDelete(symbol, OrderKey{ id, scope.feedId, scope.epoch, synthetic });
 }
 bool OrderBookManager::onDelete(const std::string& symbol, const OrderKey& key) {
-    if (gate_(symbol)) { metrics_.incDroppedStale(); return false; }
+    SymbolState& st = getOrCreate_(symbol);
+    std::unique_lock<std::mutex> lk(st.mx);
+    if (st.feed.stale) { metrics_.incDroppedStale(); return false; }
     metrics_.incDeletes();
-    Side s; Price p; std::vector<std::pair<Side,Price>> candidates;
-    if (book(symbol).locate(key, s, p)) candidates.emplace_back(s, p);
-    return mutateWithDelta_(symbol, candidates, [&]{ return book(symbol).applyDelete(key); });
+    return mutateWithDelta_(st, lk, symbol, [&](OrderBook& b){ return b.applyDelete(key); });
 }
 
 bool OrderBookManager::onPriority(const std::string& symbol, uint64_t id, FeedScope scope, uint64_t newPriority, bool synthetic) {
-    if (gate_(symbol)) { metrics_.incDroppedStale(); return false; }
-    metrics_.incPriorities();
-    OrderKey key{ id, scope.feedId, scope.epoch, synthetic };
-    return mutateWithDelta_(symbol, {}, [&]{ return book(symbol).applyPriority(key, newPriority); });
+    return onPriority(symbol, OrderKey{ id, scope.feedId, scope.epoch, synthetic }, newPriority);
 }
 bool OrderBookManager::onPriority(const std::string& symbol, const OrderKey& key, uint64_t newPriority) {
-    if (gate_(symbol)) { metrics_.incDroppedStale(); return false; }
+    SymbolState& st = getOrCreate_(symbol);
+    std::unique_lock<std::mutex> lk(st.mx);
+    if (st.feed.stale) { metrics_.incDroppedStale(); return false; }
     metrics_.incPriorities();
-    return mutateWithDelta_(symbol, {}, [&]{ return book(symbol).applyPriority(key, newPriority); });
+    return mutateWithDelta_(st, lk, symbol, [&](OrderBook& b){ return b.applyPriority(key, newPriority); });
 }
 
 // ---------- Venue-key wrappers ----------
@@ -316,121 +484,141 @@ bool OrderBookManager::onAddWithVenueKey(const std::string& symbol, const std::s
 }
 bool OrderBookManager::onUpdateByVenueKey(const std::string& symbol, const std::string& venueKey,
                                           std::optional<double> newPrice, std::optional<uint64_t> newSize) {
-    if (gate_(symbol)) { metrics_.incDroppedStale(); return false; }
+    if (isStale(symbol)) { metrics_.incDroppedStale(); return false; }
     auto k = resolverGet(symbol, venueKey); if (!k) { metrics_.incDroppedMalformed(); return false; }
     return onUpdate(symbol, *k, newPrice, newSize);
 }
 bool OrderBookManager::onDeleteByVenueKey(const std::string& symbol, const std::string& venueKey) {
-    if (gate_(symbol)) { metrics_.incDroppedStale(); return false; }
+    if (isStale(symbol)) { metrics_.incDroppedStale(); return false; }
     auto k = resolverGet(symbol, venueKey); if (!k) { metrics_.incDroppedMalformed(); return false; }
     return onDelete(symbol, *k);
 }
 
 // ---------- Trades ----------
 bool OrderBookManager::onTrade(const std::string& symbol, double tradePrice, uint64_t size, Aggressor aggr) {
-    if (gate_(symbol)) { metrics_.incDroppedStale(); return false; }
-    if (!validatePrice_(symbol, tradePrice) || !validateSize_(size)) { metrics_.incDroppedMalformed(); return false; }
+    SymbolState& st = getOrCreate_(symbol);
+    std::unique_lock<std::mutex> lk(st.mx);
+    if (st.feed.stale) { metrics_.incDroppedStale(); return false; }
+    if (!validatePrice_(st, tradePrice) || !validateSize_(size)) { metrics_.incDroppedMalformed(); return false; }
     metrics_.incEvents();
 
-    Price tp = toTicks(symbol, tradePrice);
-    OrderBook& b = book(symbol);
-    std::vector<std::pair<Side,Price>> candidates;
-    if (b.levelSize(Side::Bid, tp) > 0) candidates.emplace_back(Side::Bid, tp);
-    if (b.levelSize(Side::Ask, tp) > 0) candidates.emplace_back(Side::Ask, tp);
-    return mutateWithDelta_(symbol, candidates, [&]{ return b.applyTrade(tp, size, aggr); });
+    Price tp = toTicks_(st, tradePrice);
+    return mutateWithDelta_(st, lk, symbol, [&](OrderBook& b){ return b.applyTrade(tp, size, aggr); });
 }
 
 // ---------- Snapshots / summaries ----------
-void OrderBookManager::onSnapshotPerOrder(const std::string& symbol, const std::vector<Order>& tickOrders,
-                                          std::optional<uint64_t> snapshotSeq) {
-    book(symbol).applySnapshotPerOrder(tickOrders);
-    {
-        std::lock_guard<std::mutex> lk(feedMx_);
-        auto& st = feed_[symbol];
-        st.stale = false;
-        if (snapshotSeq) st.lastSeq = *snapshotSeq;
-    }
+void OrderBookManager::finishSnapshot_(SymbolState& st, std::unique_lock<std::mutex>& lk,
+                                       const std::string& symbol, std::optional<uint64_t> snapshotSeq) {
+    st.feedSeen = true;
+    st.feed.stale = false;
+    if (snapshotSeq) st.feed.lastSeq = *snapshotSeq;
     metrics_.incSnapshots();
+    st.version.fetch_add(1, std::memory_order_release);
 
-    auto bb = book(symbol).bestBid(); uint64_t bbs = book(symbol).bestBidSize();
-    auto ba = book(symbol).bestAsk(); uint64_t bas = book(symbol).bestAskSize();
-    std::optional<std::pair<Price,uint64_t>> nbid = bb ? std::make_pair(*bb,bbs) : std::optional<std::pair<Price,uint64_t>>{};
-    std::optional<std::pair<Price,uint64_t>> nask = ba ? std::make_pair(*ba,bas) : std::optional<std::pair<Price,uint64_t>>{};
-    maybePublishDelta_(symbol, {}, nbid, nask);
+    const BookTop t = st.bookOwner->top();
+    publishTob_(st, t.bid, t.bidSize, t.ask, t.askSize);
+    std::optional<std::pair<Price,uint64_t>> nbid, nask;
+    if (t.bid) nbid = std::make_pair(*t.bid, t.bidSize);
+    if (t.ask) nask = std::make_pair(*t.ask, t.askSize);
+    st.changes.clear();
+    maybePublishDelta_(st, lk, symbol, st.changes, nbid, nask);
+}
+void OrderBookManager::onSnapshotPerOrder(const std::string& symbol, const std::vector<Order>& tickOrders,
+                                          std::optional<uint64_t> snapshotSeq) {
+    SymbolState& st = getOrCreate_(symbol);
+    std::unique_lock<std::mutex> lk(st.mx);
+    bookOf_(st).applySnapshotPerOrder(tickOrders);
+    finishSnapshot_(st, lk, symbol, snapshotSeq);
 }
 void OrderBookManager::onSnapshotAggregated(const std::string& symbol, const std::vector<LevelSnapshotEntryD>& levelsD,
                                             std::optional<uint64_t> snapshotSeq) {
+    SymbolState& st = getOrCreate_(symbol);
+    std::unique_lock<std::mutex> lk(st.mx);
     std::vector<LevelSnapshotEntry> levels; levels.reserve(levelsD.size());
-    for (const auto& e : levelsD) levels.push_back(LevelSnapshotEntry{ e.side, toTicks(symbol, e.price), e.totalSize, e.orderCount });
-    book(symbol).applySnapshotAggregated(levels);
-    {
-        std::lock_guard<std::mutex> lk(feedMx_);
-        auto& st = feed_[symbol]; st.stale = false; if (snapshotSeq) st.lastSeq = *snapshotSeq;
-    }
-    metrics_.incSnapshots();
-
-    auto bb = book(symbol).bestBid(); uint64_t bbs = book(symbol).bestBidSize();
-    auto ba = book(symbol).bestAsk(); uint64_t bas = book(symbol).bestAskSize();
-    std::optional<std::pair<Price,uint64_t>> nbid = bb ? std::make_pair(*bb,bbs) : std::optional<std::pair<Price,uint64_t>>{};
-    std::optional<std::pair<Price,uint64_t>> nask = ba ? std::make_pair(*ba,bas) : std::optional<std::pair<Price,uint64_t>>{};
-    maybePublishDelta_(symbol, {}, nbid, nask);
+    for (const auto& e : levelsD) levels.push_back(LevelSnapshotEntry{ e.side, toTicks_(st, e.price), e.totalSize, e.orderCount });
+    bookOf_(st).applySnapshotAggregated(levels);
+    finishSnapshot_(st, lk, symbol, snapshotSeq);
 }
 bool OrderBookManager::onLevelSummary(const std::string& symbol, Side side, double price, uint64_t totalSize,
                                       std::optional<uint32_t> orderCount) {
-    if (gate_(symbol)) { metrics_.incDroppedStale(); return false; }
-    if (!validSide(side) || !validatePrice_(symbol, price)) { metrics_.incDroppedMalformed(); return false; }
+    SymbolState& st = getOrCreate_(symbol);
+    std::unique_lock<std::mutex> lk(st.mx);
+    if (st.feed.stale) { metrics_.incDroppedStale(); return false; }
+    if (!validSide(side) || !validatePrice_(st, price)) { metrics_.incDroppedMalformed(); return false; }
     metrics_.incSummaries();
 
-    Price p = toTicks(symbol, price);
-    auto candidates = std::vector<std::pair<Side,Price>>{ {side,p} };
-    return mutateWithDelta_(symbol, candidates, [&]{ return book(symbol).applyLevelSummary(side, p, totalSize, orderCount); });
+    Price p = toTicks_(st, price);
+    return mutateWithDelta_(st, lk, symbol, [&](OrderBook& b){ return b.applyLevelSummary(side, p, totalSize, orderCount); });
 }
 
 // ---------- Queries ----------
+// Top of book comes from the published copy: no book or shard lock.
 std::optional<double> OrderBookManager::bestBid(const std::string& symbol) const {
-    const OrderBook* b = findBook_(symbol);
-    if (!b) return std::nullopt;
-    auto p = b->bestBid(); if (!p) return std::nullopt; return toDouble(symbol, *p);
+    const SymbolState* st = find_(symbol);
+    if (!st) return std::nullopt;
+    const auto v = st->tob.load();
+    if (!v.hasBid) return std::nullopt;
+    return static_cast<double>(v.bid) * st->tickSize.load(std::memory_order_relaxed);
 }
 std::optional<double> OrderBookManager::bestAsk(const std::string& symbol) const {
-    const OrderBook* b = findBook_(symbol);
-    if (!b) return std::nullopt;
-    auto p = b->bestAsk(); if (!p) return std::nullopt; return toDouble(symbol, *p);
+    const SymbolState* st = find_(symbol);
+    if (!st) return std::nullopt;
+    const auto v = st->tob.load();
+    if (!v.hasAsk) return std::nullopt;
+    return static_cast<double>(v.ask) * st->tickSize.load(std::memory_order_relaxed);
 }
 uint64_t OrderBookManager::bestBidSize(const std::string& symbol) const {
-    const OrderBook* b = findBook_(symbol);
-    return b ? b->bestBidSize() : 0;
+    const SymbolState* st = find_(symbol);
+    return st ? st->tob.load().bidSize : 0;
 }
 uint64_t OrderBookManager::bestAskSize(const std::string& symbol) const {
-    const OrderBook* b = findBook_(symbol);
-    return b ? b->bestAskSize() : 0;
+    const SymbolState* st = find_(symbol);
+    return st ? st->tob.load().askSize : 0;
 }
 void OrderBookManager::depthN(const std::string& symbol, size_t n,
                               std::vector<std::pair<double,uint64_t>>& bids,
                               std::vector<std::pair<double,uint64_t>>& asks) const {
     bids.clear(); asks.clear();
-    const OrderBook* b = findBook_(symbol);
+    const SymbolState* st = find_(symbol);
+    const OrderBook* b = st ? st->book.load(std::memory_order_acquire) : nullptr;
     if (!b) return;
-    b->forEachLevel(Side::Bid, n, [&](Price p, uint64_t sz){ bids.emplace_back(toDouble(symbol, p), sz); });
-    b->forEachLevel(Side::Ask, n, [&](Price p, uint64_t sz){ asks.emplace_back(toDouble(symbol, p), sz); });
+    const double t = st->tickSize.load(std::memory_order_relaxed);
+    b->forEachLevel(Side::Bid, n, [&](Price p, uint64_t sz){ bids.emplace_back(static_cast<double>(p.ticks) * t, sz); });
+    b->forEachLevel(Side::Ask, n, [&](Price p, uint64_t sz){ asks.emplace_back(static_cast<double>(p.ticks) * t, sz); });
+}
+DepthSums OrderBookManager::depthByRank(const std::string& symbol, Side side, size_t first, size_t last) const {
+    const SymbolState* st = find_(symbol);
+    const OrderBook* b = st ? st->book.load(std::memory_order_acquire) : nullptr;
+    return b ? b->depthByRank(side, first, last) : DepthSums{};
+}
+DepthSums OrderBookManager::depthByPrice(const std::string& symbol, Side side, double lo, double hi) const {
+    const SymbolState* st = find_(symbol);
+    const OrderBook* b = st ? st->book.load(std::memory_order_acquire) : nullptr;
+    if (!b || !(lo <= hi)) return DepthSums{};
+    const double t = st->tickSize.load(std::memory_order_relaxed);
+    constexpr double eps = 1e-9;
+    const double loT = std::ceil(lo / t - eps), hiT = std::floor(hi / t + eps);
+    constexpr double lim = 9.0e18;   // inside int64
+    return b->depthByPrice(side, Price{ static_cast<int64_t>(std::clamp(loT, -lim, lim)) },
+                                 Price{ static_cast<int64_t>(std::clamp(hiT, -lim, lim)) });
+}
+uint64_t OrderBookManager::bookVersion(const std::string& symbol) const {
+    const SymbolState* st = find_(symbol);
+    return st ? st->version.load(std::memory_order_acquire) : 0;
 }
 
 // ---------- Snapshot builder ----------
 DepthSnapshot OrderBookManager::buildSnapshot(const std::string& symbol, size_t levels) const {
     DepthSnapshot snap;
     snap.symbol = symbol;
-    {
-        std::lock_guard<std::mutex> lk(feedMx_);
-        auto it = feed_.find(symbol);
-        snap.epoch = (it == feed_.end()) ? 0 : it->second.epoch;
-    }
-    {
-        std::lock_guard<std::mutex> lk(subsMx_);
-        snap.seq = pubSeq_.count(symbol) ? pubSeq_.at(symbol) : 0;
-    }
-
-    const OrderBook* b = findBook_(symbol);
-    if (b) {
+    SymbolState* st = find_(symbol);
+    if (!st) return snap;
+
+    // Holding the symbol lock ties seq to exactly these levels.
+    std::lock_guard<std::mutex> lk(st->mx);
+    snap.epoch = st->feed.epoch;
+    snap.seq = st->pubSeq;
+    if (const OrderBook* b = st->bookOwner.get()) {
         b->forEachLevel(Side::Bid, levels, [&](Price p, uint64_t sz){ snap.bids.emplace_back(p, sz); });
         b->forEachLevel(Side::Ask, levels, [&](Price p, uint64_t sz){ snap.asks.emplace_back(p, sz); });
     }
@@ -441,7 +629,8 @@ DepthSnapshot OrderBookManager::buildSnapshot(const std::string& symbol, size_t
 MetricsSnapshot OrderBookManager::getStats() const { return metrics_.snapshot(); }
 
 bool OrderBookManager::assertInvariants(const std::string& symbol, std::string* whyNot) const {
-    const OrderBook* b = findBook_(symbol);
+    const SymbolState* st = find_(symbol);
+    const OrderBook* b = st ? st->book.load(std::memory_order_acquire) : nullptr;
     if (!b) { if (whyNot) *whyNot = "book not found"; return false; }
     return b->checkInvariants(whyNot);
 }
@@ -449,15 +638,15 @@ bool OrderBookManager::assertInvariants(const std::string& symbol, std::string*
 std::string OrderBookManager::dumpLadder(const std::string& symbol, size_t maxLevelsPerSide) const {
     std::ostringstream oss;
     oss << "=== DUMP " << symbol << " ===\n";
-    {
-        std::lock_guard<std::mutex> lk(feedMx_);
-        auto it = feed_.find(symbol);
-        if (it != feed_.end())
-            oss << "epoch=" << it->second.epoch << " stale=" << (it->second.stale ? "true":"false")
-                << " feedSeq=" << it->second.lastSeq << "\n";
+    SymbolState* st = find_(symbol);
+    if (st) {
+        std::lock_guard<std::mutex> lk(st->mx);
+        if (st->feedSeen)
+            oss << "epoch=" << st->feed.epoch << " stale=" << (st->feed.stale ? "true":"false")
+                << " feedSeq=" << st->feed.lastSeq << "\n";
     }
 
-    const OrderBook* b = findBook_(symbol);
+    const OrderBook* b = st ? st->book.load(std::memory_order_acquire) : nullptr;
 
     // Bids
     oss << "[BIDS]\n";
@@ -0,0 +1,191 @@
+#include "gma/book/OrderPool.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace gma {
+
+namespace {
+
+constexpr std::size_t HUGE_PAGE = std::size_t{2} << 20;
+
+} // namespace
+
+// --------- OrderPool ---------
+OrderPool::~OrderPool() {
+    for (OrderNode* s : slabs_) {
+        if (hugePages_) std::free(s);
+        else            ::operator delete(s);
+    }
+}
+
+std::size_t OrderPool::slabBytes() const noexcept {
+    const std::size_t raw = std::size_t{SLAB_SIZE} * sizeof(OrderNode);
+    return hugePages_ ? (raw + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE : raw;
+}
+
+void OrderPool::addSlab() {
+    if (slabs_.size() >= (std::size_t{kNoOrder} >> SLAB_SHIFT)) {
+        throw std::runtime_error("OrderPool: too many live orders");
+    }
+    void* mem = nullptr;
+    if (hugePages_) {
+        mem = std::aligned_alloc(HUGE_PAGE, slabBytes());
+        if (!mem) throw std::bad_alloc();
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        ::madvise(mem, slabBytes(), MADV_HUGEPAGE);   // advisory; failure is harmless
+#endif
+    } else {
+        mem = ::operator new(slabBytes());
+    }
+    slabs_.push_back(static_cast<OrderNode*>(mem));
+}
+
+uint32_t OrderPool::alloc() {
+    uint32_t i;
+    if (freeHead_ != kNoOrder) {
+        i = freeHead_;
+        freeHead_ = (*this)[i].next;
+    } else {
+        if (bump_ == capacity()) addSlab();
+        i = bump_++;
+    }
+    (*this)[i] = OrderNode{};
+    ++live_;
+    return i;
+}
+
+void OrderPool::release(uint32_t i) noexcept {
+    OrderNode& n = (*this)[i];
+    n.next = freeHead_;
+    freeHead_ = i;
+    --live_;
+}
+
+void OrderPool::clear() noexcept {
+    bump_ = 0;
+    freeHead_ = kNoOrder;
+    live_ = 0;
+}
+
+void OrderPool::swap(OrderPool& other) noexcept {
+    slabs_.swap(other.slabs_);
+    std::swap(bump_, other.bump_);
+    std::swap(freeHead_, other.freeHead_);
+    std::swap(live_, other.live_);
+    std::swap(hugePages_, other.hugePages_);
+}
+
+// --------- OrderIndex ---------
+uint32_t OrderIndex::find(const OrderKey& k, const OrderPool& pool) const noexcept {
+    if (size_ == 0) return kNoOrder;
+    const uint32_t tag = tagOf(k);
+    for (std::size_t i = tag & mask_;; i = (i + 1) & mask_) {
+        const Slot& s = slots_[i];
+        if (s.node == kNoOrder) return kNoOrder;
+        if (s.tag == tag && pool[s.node].key() == k) return s.node;
+    }
+}
+
+void OrderIndex::insert(const OrderKey& k, uint32_t node) {
+    if ((size_ + 1) * 2 > slots_.size()) grow();
+    const uint32_t tag = tagOf(k);
+    std::size_t i = tag & mask_;
+    while (slots_[i].node != kNoOrder) i = (i + 1) & mask_;
+    slots_[i] = Slot{ node, tag };
+    ++size_;
+}
+
+bool OrderIndex::erase(const OrderKey& k, const OrderPool& pool) noexcept {
+    if (size_ == 0) return false;
+    const uint32_t tag = tagOf(k);
+    std::size_t i = tag & mask_;
+    for (;; i = (i + 1) & mask_) {
+        const Slot& s = slots_[i];
+        if (s.node == kNoOrder) return false;
+        if (s.tag == tag && pool[s.node].key() == k) break;
+    }
+    // Backward-shift: pull later entries of the run into the hole unless
+    // their home slot lies cyclically within (hole, j].
+    std::size_t hole = i;
+    for (std::size_t j = (i + 1) & mask_; slots_[j].node != kNoOrder; j = (j + 1) & mask_) {
+        const std::size_t home = slots_[j].tag & mask_;
+        const bool stays = (hole <= j) ? (hole < home && home <= j)
+                                       : (hole < home || home <= j);
+        if (stays) continue;
+        slots_[hole] = slots_[j];
+        hole = j;
+    }
+    slots_[hole] = Slot{};
+    --size_;
+    return true;
+}
+
+void OrderIndex::clear() noexcept {
+    for (Slot& s : slots_) s = Slot{};
+    size_ = 0;
+}
+
+std::vector<uint32_t> OrderIndex::bulkLoad(uint32_t n, const OrderPool& pool) {
+    const std::size_t cap = std::bit_ceil(std::max<std::size_t>(64, std::size_t{n} * 2));
+    if (cap != slots_.size()) {
+        slots_.assign(cap, Slot{});
+        mask_ = cap - 1;
+    } else {
+        clear();
+    }
+    size_ = 0;
+
+    // Counting sort by home region (4 KiB of slots). Stable, so a repeated
+    // key (same tag, same region) is met in arrival order.
+    constexpr unsigned REGION_SHIFT = 9;
+    const std::size_t regions = std::max<std::size_t>(1, cap >> REGION_SHIFT);
+    std::vector<uint32_t> tags(n);
+    std::vector<uint32_t> start(regions + 1, 0);
+    for (uint32_t i = 0; i < n; ++i) {
+        tags[i] = tagOf(pool[i].key());
+        ++start[((tags[i] & mask_) >> REGION_SHIFT) + 1];
+    }
+    for (std::size_t r = 1; r <= regions; ++r) start[r] += start[r - 1];
+    std::vector<uint32_t> order(n);
+    for (uint32_t i = 0; i < n; ++i) order[start[(tags[i] & mask_) >> REGION_SHIFT]++] = i;
+
+    std::vector<uint32_t> replaced;
+    for (const uint32_t node : order) {
+        const uint32_t tag = tags[node];
+        std::size_t i = tag & mask_;
+        for (; slots_[i].node != kNoOrder; i = (i + 1) & mask_) {
+            if (slots_[i].tag == tag && pool[slots_[i].node].key() == pool[node].key()) break;
+        }
+        if (slots_[i].node != kNoOrder) {
+            replaced.push_back(slots_[i].node);
+            slots_[i].node = node;
+        } else {
+            slots_[i] = Slot{ node, tag };
+            ++size_;
+        }
+    }
+    return replaced;
+}
+
+void OrderIndex::grow() {
+    std::vector<Slot> old;
+    old.swap(slots_);
+    const std::size_t cap = old.empty() ? 64 : old.size() * 2;
+    slots_.assign(cap, Slot{});
+    mask_ = cap - 1;
+    for (const Slot& s : old) {
+        if (s.node == kNoOrder) continue;
+        std::size_t i = s.tag & mask_;
+        while (slots_[i].node != kNoOrder) i = (i + 1) & mask_;
+        slots_[i] = s;
+    }
+}
+
+} // namespace gma
@@ -0,0 +1,20 @@
+#include "gma/book/SymbolTable.hpp"
+#include <stdexcept>
+
+namespace gma {
+
+uint32_t SymbolTable::intern(std::string_view name) {
+    if (auto it = ids_.find(name); it != ids_.end()) return it->second;
+    if (names_.size() >= kNoSymbol) throw std::runtime_error("SymbolTable: too many symbols");
+    const auto id = static_cast<uint32_t>(names_.size());
+    names_.emplace_back(name);
+    ids_.emplace(names_.back(), id);
+    return id;
+}
+
+uint32_t SymbolTable::find(std::string_view name) const noexcept {
+    auto it = ids_.find(name);
+    return it == ids_.end() ? kNoSymbol : it->second;
+}
+
+} // namespace gma
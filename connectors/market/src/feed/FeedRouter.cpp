@@ -0,0 +1,66 @@
+#include "gma/feed/FeedRouter.hpp"
+
+#include "gma/Dispatcher.hpp"
+#include "gma/Event.hpp"
+#include "gma/book/OrderBookManager.hpp"
+
+#include <type_traits>
+
+namespace gma::feed {
+
+namespace {
+
+void routeBookEvent(FeedEvent& evt, OrderBookManager* obManager) {
+    if (!obManager) return;
+    std::visit([obManager](auto& e) {
+        using T = std::decay_t<decltype(e)>;
+
+        if constexpr (std::is_same_v<T, ObAddEvent>) {
+            obManager->onAdd(e.symbol, e.orderId, e.side, e.price, e.size, e.priority);
+        }
+        else if constexpr (std::is_same_v<T, ObUpdateEvent>) {
+            obManager->onUpdate(e.symbol, e.orderId, FeedScope{}, e.newPrice, e.newSize);
+        }
+        else if constexpr (std::is_same_v<T, ObDeleteEvent>) {
+            obManager->onDelete(e.symbol, e.orderId, FeedScope{});
+        }
+        else if constexpr (std::is_same_v<T, ObTradeEvent>) {
+            obManager->onTrade(e.symbol, e.price, e.size, e.aggressor);
+        }
+        else if constexpr (std::is_same_v<T, ObTickSizeEvent>) {
+            obManager->setTickSize(e.symbol, e.tickSize);
+        }
+        else if constexpr (std::is_same_v<T, ObResetEvent>) {
+            obManager->onReset(e.symbol, e.epoch);
+        }
+    }, evt);
+}
+
+} // namespace
+
+void routeFeedEvents(std::vector<FeedEvent>& events,
+                                          Dispatcher* dispatcher,
+                                          OrderBookManager* obManager) {
+    // Consecutive ticks go to the dispatcher as one batch; book events flush
+    // the pending run first so feed order is preserved.
+    std::vector<Event> ticks;
+    auto flush = [&] {
+        if (ticks.empty()) return;
+        if (dispatcher) dispatcher->onTickBatch(ticks);
+        ticks.clear();
+    };
+    for (auto& evt : events) {
+        if (auto* t = std::get_if<TickEvent>(&evt)) {
+            Event tick;
+            tick.symbol  = std::move(t->symbol);
+            tick.payload = std::move(t->payload);
+            ticks.push_back(std::move(tick));
+            continue;
+        }
+        flush();
+        routeBookEvent(evt, obManager);
+    }
+    flush();
+}
+
+} // namespace gma::feed
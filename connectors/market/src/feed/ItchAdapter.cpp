@@ -7,7 +7,9 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 
+#include <cmath>
 #include <cstdlib>
+#include <string_view>
 
 namespace gma::feed {
 
@@ -63,6 +65,47 @@ TickEvent ItchAdapter::makeTradeTickEvent(const std::string& symbol,
     return te;
 }
 
+// ---------------------------------------------------------------------------
+// Symbol resolution / order tracking
+// ---------------------------------------------------------------------------
+std::string_view ItchAdapter::stockOf(const rapidjson::Value& doc) {
+    if (!doc.HasMember("stock") || !doc["stock"].IsString()) return {};
+    std::string_view stock(doc["stock"].GetString(), doc["stock"].GetStringLength());
+    while (!stock.empty() && stock.back() == ' ') stock.remove_suffix(1);
+    return stock;
+}
+
+uint32_t ItchAdapter::resolveSymbol(const rapidjson::Value& doc) {
+    if (doc.HasMember("stock") && doc["stock"].IsString()) return symbols_.intern(stockOf(doc));
+    return locateSymbol(doc);
+}
+
+uint32_t ItchAdapter::locateSymbol(const rapidjson::Value& doc) const {
+    if (doc.HasMember("stockLocate") && doc["stockLocate"].IsNumber()) {
+        const int locate = doc["stockLocate"].GetInt();
+        if (locate >= 0 && static_cast<std::size_t>(locate) < locateToSymbol_.size())
+            return locateToSymbol_[locate];
+    }
+    return kNoSymbol;
+}
+
+bool ItchAdapter::track(uint64_t orderRef, uint32_t symbol, Side side,
+                        double price, uint64_t shares) {
+    const double p4 = std::round(price * 1e4);
+    if (orderRef == RefTable<OrderState>::kNoRef || !(p4 >= 0.0 && p4 <= double(UINT32_MAX))
+        || shares > UINT32_MAX) {
+        GMA_METRIC_HIT("feed_ws.order_out_of_range");
+        return false;
+    }
+    orders_.put(orderRef, OrderState{symbol, static_cast<uint32_t>(shares),
+                                     static_cast<uint32_t>(p4), side});
+    return true;
+}
+
+namespace {
+double fromPrice4(uint32_t p) { return static_cast<double>(p) / 1e4; }
+} // namespace
+
 // ---------------------------------------------------------------------------
 // stock_directory → tick-size + register symbol mapping
 // ---------------------------------------------------------------------------
@@ -72,12 +115,13 @@ void ItchAdapter::routeStockDirectory(const rapidjson::Value& doc,
         !doc.HasMember("stock") || !doc["stock"].IsString()) return;
 
     int locate = doc["stockLocate"].GetInt();
-    std::string stock = doc["stock"].GetString();
+    if (locate < 0 || locate > 0xFFFF) return;     // ITCH locates are 16-bit
+    const uint32_t id = resolveSymbol(doc);
+    const std::string& stock = symbols_.name(id);
 
-    // Trim trailing spaces (ITCH pads to 8 chars)
-    while (!stock.empty() && stock.back() == ' ') stock.pop_back();
-
-    locateToSymbol_[locate] = stock;
+    if (static_cast<std::size_t>(locate) >= locateToSymbol_.size())
+        locateToSymbol_.resize(static_cast<std::size_t>(locate) + 1, kNoSymbol);
+    locateToSymbol_[locate] = id;
 
     // NASDAQ uses $0.01 tick size for all equities
     out.push_back(ObTickSizeEvent{stock, 0.01});
@@ -100,17 +144,8 @@ void ItchAdapter::routeAddOrder(const rapidjson::Value& doc,
         !doc.HasMember("price")) return;
 
     // Resolve symbol: prefer "stock" field, fall back to stockLocate mapping
-    std::string stock;
-    if (doc.HasMember("stock") && doc["stock"].IsString()) {
-        stock = doc["stock"].GetString();
-        while (!stock.empty() && stock.back() == ' ') stock.pop_back();
-    } else if (doc.HasMember("stockLocate") && doc["stockLocate"].IsNumber()) {
-        auto it = locateToSymbol_.find(doc["stockLocate"].GetInt());
-        if (it == locateToSymbol_.end()) return;
-        stock = it->second;
-    } else {
-        return;
-    }
+    const uint32_t symbol = resolveSymbol(doc);
+    if (symbol == kNoSymbol) return;
 
     uint64_t orderRef = doc["orderRef"].GetUint64();
     uint64_t shares   = doc["shares"].GetUint64();
@@ -120,9 +155,9 @@ void ItchAdapter::routeAddOrder(const rapidjson::Value& doc,
     Side side = (sideStr[0] == 'B') ? Side::Bid : Side::Ask;
 
     // Track order state for executed/cancel messages
-    orders_[orderRef] = {stock, shares, side, price};
+    if (!track(orderRef, symbol, side, price, shares)) return;
 
-    out.push_back(ObAddEvent{stock, orderRef, side, price, shares, 0});
+    out.push_back(ObAddEvent{symbols_.name(symbol), orderRef, side, price, shares, 0});
 
     GMA_METRIC_HIT("feed_ws.add_order");
 }
@@ -138,27 +173,27 @@ void ItchAdapter::routeOrderExecuted(const rapidjson::Value& doc,
     uint64_t orderRef   = doc["orderRef"].GetUint64();
     uint64_t execShares = doc["shares"].GetUint64();
 
-    auto it = orders_.find(orderRef);
-    if (it == orders_.end()) return;
+    OrderState* os = orders_.find(orderRef);
+    if (!os) return;
 
-    auto& os = it->second;
-    const std::string& symbol = os.symbol;
+    const std::string& symbol = symbols_.name(os->symbol);
+    const double price = fromPrice4(os->price);
 
     // The resting order's side is passive; the aggressor is the opposite.
-    Aggressor aggr = (os.side == Side::Bid) ? Aggressor::Sell : Aggressor::Buy;
+    Aggressor aggr = (os->side == Side::Bid) ? Aggressor::Sell : Aggressor::Buy;
 
-    if (execShares >= os.remainingShares) {
+    if (execShares >= os->remainingShares) {
         // Fully filled — delete the order and erase tracking state
         out.push_back(ObDeleteEvent{symbol, orderRef});
-        out.push_back(ObTradeEvent{symbol, os.price, execShares, aggr});
-        out.push_back(makeTradeTickEvent(symbol, os.price, execShares));
-        orders_.erase(it);
+        out.push_back(ObTradeEvent{symbol, price, execShares, aggr});
+        out.push_back(makeTradeTickEvent(symbol, price, execShares));
+        orders_.erase(orderRef);
     } else {
         // Partial fill — reduce size, keep tracking
-        os.remainingShares -= execShares;
-        out.push_back(ObUpdateEvent{symbol, orderRef, std::nullopt, os.remainingShares});
-        out.push_back(ObTradeEvent{symbol, os.price, execShares, aggr});
-        out.push_back(makeTradeTickEvent(symbol, os.price, execShares));
+        os->remainingShares -= static_cast<uint32_t>(execShares);
+        out.push_back(ObUpdateEvent{symbol, orderRef, std::nullopt, os->remainingShares});
+        out.push_back(ObTradeEvent{symbol, price, execShares, aggr});
+        out.push_back(makeTradeTickEvent(symbol, price, execShares));
     }
 
     GMA_METRIC_HIT("feed_ws.order_executed");
@@ -175,18 +210,16 @@ void ItchAdapter::routeOrderCancel(const rapidjson::Value& doc,
     uint64_t orderRef    = doc["orderRef"].GetUint64();
     uint64_t cancelShares = doc["shares"].GetUint64();
 
-    auto it = orders_.find(orderRef);
-    if (it == orders_.end()) return;
+    OrderState* os = orders_.find(orderRef);
+    if (!os) return;
 
-    auto& os = it->second;
-
-    if (cancelShares >= os.remainingShares) {
-        out.push_back(ObDeleteEvent{os.symbol, orderRef});
-        orders_.erase(it);
+    if (cancelShares >= os->remainingShares) {
+        out.push_back(ObDeleteEvent{symbols_.name(os->symbol), orderRef});
+        orders_.erase(orderRef);
     } else {
-        os.remainingShares -= cancelShares;
-        out.push_back(ObUpdateEvent{os.symbol, orderRef,
-                                     std::nullopt, os.remainingShares});
+        os->remainingShares -= static_cast<uint32_t>(cancelShares);
+        out.push_back(ObUpdateEvent{symbols_.name(os->symbol), orderRef,
+                                     std::nullopt, os->remainingShares});
     }
 
     GMA_METRIC_HIT("feed_ws.order_cancel");
@@ -201,11 +234,11 @@ void ItchAdapter::routeOrderDelete(const rapidjson::Value& doc,
 
     uint64_t orderRef = doc["orderRef"].GetUint64();
 
-    auto it = orders_.find(orderRef);
-    if (it == orders_.end()) return;
+    const OrderState* os = orders_.find(orderRef);
+    if (!os) return;
 
-    out.push_back(ObDeleteEvent{it->second.symbol, orderRef});
-    orders_.erase(it);
+    out.push_back(ObDeleteEvent{symbols_.name(os->symbol), orderRef});
+    orders_.erase(orderRef);
 
     GMA_METRIC_HIT("feed_ws.order_delete");
 }
@@ -225,19 +258,19 @@ void ItchAdapter::routeOrderReplace(const rapidjson::Value& doc,
     uint64_t shares  = doc["shares"].GetUint64();
     double   price   = parsePrice(doc["price"]);
 
-    auto it = orders_.find(origRef);
-    if (it == orders_.end()) return;
+    const OrderState* os = orders_.find(origRef);
+    if (!os) return;
 
-    std::string symbol = it->second.symbol;
-    Side side = it->second.side;
+    const uint32_t symbol = os->symbol;
+    const Side     side   = os->side;
 
     // Delete old
-    out.push_back(ObDeleteEvent{symbol, origRef});
-    orders_.erase(it);
+    out.push_back(ObDeleteEvent{symbols_.name(symbol), origRef});
+    orders_.erase(origRef);
 
     // Add new
-    orders_[newRef] = {symbol, shares, side, price};
-    out.push_back(ObAddEvent{symbol, newRef, side, price, shares, 0});
+    if (track(newRef, symbol, side, price, shares))
+        out.push_back(ObAddEvent{symbols_.name(symbol), newRef, side, price, shares, 0});
 
     GMA_METRIC_HIT("feed_ws.order_replace");
 }
@@ -250,17 +283,15 @@ void ItchAdapter::routeTrade(const rapidjson::Value& doc,
     if (!doc.HasMember("price") ||
         !doc.HasMember("shares") || !doc["shares"].IsNumber()) return;
 
-    // Resolve symbol: prefer "stock" field, fall back to stockLocate mapping
+    // Prefer the "stock" field, fall back to the stockLocate mapping. A
+    // trade leaves no state behind, so its name is not interned.
     std::string stock;
     if (doc.HasMember("stock") && doc["stock"].IsString()) {
-        stock = doc["stock"].GetString();
-        while (!stock.empty() && stock.back() == ' ') stock.pop_back();
-    } else if (doc.HasMember("stockLocate") && doc["stockLocate"].IsNumber()) {
-        auto it = locateToSymbol_.find(doc["stockLocate"].GetInt());
-        if (it == locateToSymbol_.end()) return;
-        stock = it->second;
+        stock = stockOf(doc);
     } else {
-        return;
+        const uint32_t symbol = locateSymbol(doc);
+        if (symbol == kNoSymbol) return;
+        stock = symbols_.name(symbol);
     }
 
     double   price  = parsePrice(doc["price"]);
@@ -0,0 +1,275 @@
+#include "gma/feed/ItchBinaryAdapter.hpp"
+#include "gma/feed/ItchAdapter.hpp"
+
+#include "gma/util/Logger.hpp"
+
+#include <string_view>
+
+namespace gma::feed {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Big-endian field reads at fixed offsets (compilers fold these into a
+// load + byte swap)
+// ---------------------------------------------------------------------------
+inline uint16_t be16(const uint8_t* p) {
+    return static_cast<uint16_t>((uint16_t(p[0]) << 8) | p[1]);
+}
+inline uint32_t be32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+inline uint64_t be64(const uint8_t* p) {
+    return (uint64_t(be32(p)) << 32) | be32(p + 4);
+}
+
+double fromPrice4(uint32_t p) { return static_cast<double>(p) / 1e4; }
+
+// Alpha(8) ticker, right-padded with spaces.
+std::string_view ticker(const uint8_t* p) {
+    std::string_view s(reinterpret_cast<const char*>(p), 8);
+    while (!s.empty() && s.back() == ' ') s.remove_suffix(1);
+    return s;
+}
+
+// Message lengths (excluding the 2-byte length prefix) per ITCH 5.0.
+// A message shorter than its type's length is malformed; longer is fine.
+constexpr std::size_t kLenSystemEvent = 12;
+constexpr std::size_t kLenDirectory   = 39;
+constexpr std::size_t kLenAdd         = 36;
+constexpr std::size_t kLenAddMpid     = 40;
+constexpr std::size_t kLenExecuted    = 31;
+constexpr std::size_t kLenExecPrice   = 36;
+constexpr std::size_t kLenCancel      = 23;
+constexpr std::size_t kLenDelete      = 19;
+constexpr std::size_t kLenReplace     = 35;
+constexpr std::size_t kLenTrade       = 44;
+constexpr std::size_t kLenCross       = 40;
+
+// Offsets shared by every message: type 0, locate 1, tracking 3, timestamp 5.
+constexpr std::size_t kOffLocate = 1;
+constexpr std::size_t kOffBody   = 11;   // first type-specific field
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Framing
+// ---------------------------------------------------------------------------
+std::vector<FeedEvent> ItchBinaryAdapter::translate(const std::string& rawMessage) {
+    std::vector<FeedEvent> out;
+    decode(reinterpret_cast<const uint8_t*>(rawMessage.data()), rawMessage.size(), out);
+    return out;
+}
+
+std::size_t ItchBinaryAdapter::decode(const uint8_t* data, std::size_t len,
+                                      std::vector<FeedEvent>& out) {
+    std::size_t pos = 0;
+    while (len - pos >= 2) {
+        const std::size_t n = be16(data + pos);
+        if (len - pos - 2 < n) break;
+        decodeMessage(data + pos + 2, n, out);
+        pos += 2 + n;
+    }
+    return pos;
+}
+
+void ItchBinaryAdapter::decodeMessage(const uint8_t* m, std::size_t len,
+                                      std::vector<FeedEvent>& out) {
+    ++stats_.messages;
+    if (len == 0) { ++stats_.malformed; return; }
+
+    auto need = [&](std::size_t n) {
+        if (len >= n) return true;
+        ++stats_.malformed;
+        return false;
+    };
+
+    switch (m[0]) {
+        case 'A': if (need(kLenAdd))         onAddOrder(m, out);        break;
+        case 'F': if (need(kLenAddMpid))     onAddOrder(m, out);        break;
+        case 'E': if (need(kLenExecuted))    onExecuted(m, false, out); break;
+        case 'C': if (need(kLenExecPrice))   onExecuted(m, true, out);  break;
+        case 'X': if (need(kLenCancel))      onCancel(m, out);          break;
+        case 'D': if (need(kLenDelete))      onDelete(m, out);          break;
+        case 'U': if (need(kLenReplace))     onReplace(m, out);         break;
+        case 'P': if (need(kLenTrade))       onTrade(m, out);           break;
+        case 'Q': if (need(kLenCross))       onCross(m, out);           break;
+        case 'R': if (need(kLenDirectory))   onStockDirectory(m, out);  break;
+        case 'S': if (need(kLenSystemEvent)) onSystemEvent(m);          break;
+        // H trading action, Y Reg SHO, L participant, V/W MWCB, K IPO,
+        // J LULD, h halt, B broken trade, I NOII, N RPII — future
+        default:  ++stats_.skipped; break;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+uint32_t ItchBinaryAdapter::symbolFor(uint16_t locate, const uint8_t* stock) {
+    if (locate < locateToSymbol_.size() && locateToSymbol_[locate] != kNoSymbol)
+        return locateToSymbol_[locate];
+    // No directory entry yet (e.g. a capture joined mid-session).
+    const uint32_t id = symbols_.intern(ticker(stock));
+    if (locate >= locateToSymbol_.size()) locateToSymbol_.resize(std::size_t(locate) + 1, kNoSymbol);
+    locateToSymbol_[locate] = id;
+    return id;
+}
+
+void ItchBinaryAdapter::emitTrade(uint32_t symbol, uint32_t price4, uint64_t shares,
+                                  Aggressor aggr, std::vector<FeedEvent>& out) {
+    const std::string& stock = symbols_.name(symbol);
+    const double price = fromPrice4(price4);
+    out.push_back(ObTradeEvent{stock, price, shares, aggr});
+    out.push_back(ItchAdapter::makeTradeTickEvent(stock, price, shares));
+}
+
+// ---------------------------------------------------------------------------
+// R stock directory → tick-size + register locate
+//   11 stock(8)
+// ---------------------------------------------------------------------------
+void ItchBinaryAdapter::onStockDirectory(const uint8_t* m, std::vector<FeedEvent>& out) {
+    const uint16_t locate = be16(m + kOffLocate);
+    const uint32_t id = symbols_.intern(ticker(m + kOffBody));
+    if (locate >= locateToSymbol_.size()) locateToSymbol_.resize(std::size_t(locate) + 1, kNoSymbol);
+    locateToSymbol_[locate] = id;
+
+    // NASDAQ uses $0.01 tick size for all equities
+    out.push_back(ObTickSizeEvent{symbols_.name(id), 0.01});
+}
+
+// ---------------------------------------------------------------------------
+// A / F add order
+//   11 orderRef(8)  19 side(1)  20 shares(4)  24 stock(8)  32 price(4)
+// ---------------------------------------------------------------------------
+void ItchBinaryAdapter::onAddOrder(const uint8_t* m, std::vector<FeedEvent>& out) {
+    const uint64_t ref    = be64(m + 11);
+    const Side     side   = (m[19] == 'B') ? Side::Bid : Side::Ask;
+    const uint32_t shares = be32(m + 20);
+    const uint32_t price  = be32(m + 32);
+    if (ref == RefTable<OrderState>::kNoRef) { ++stats_.malformed; return; }
+
+    const uint32_t symbol = symbolFor(be16(m + kOffLocate), m + 24);
+    orders_.put(ref, OrderState{symbol, shares, price, side});
+    out.push_back(ObAddEvent{symbols_.name(symbol), ref, side, fromPrice4(price), shares, 0});
+}
+
+// ---------------------------------------------------------------------------
+// E order executed / C executed with price
+//   11 orderRef(8)  19 shares(4)  23 match(8)  [C: 31 printable(1)  32 price(4)]
+// ---------------------------------------------------------------------------
+void ItchBinaryAdapter::onExecuted(const uint8_t* m, bool withPrice,
+                                   std::vector<FeedEvent>& out) {
+    const uint64_t ref    = be64(m + 11);
+    const uint32_t shares = be32(m + 19);
+
+    OrderState* os = orders_.find(ref);
+    if (!os) { ++stats_.unknownRef; return; }
+
+    const uint32_t symbol = os->symbol;
+    const uint32_t price  = withPrice ? be32(m + 32) : os->price;
+    const bool     print  = !withPrice || m[31] == 'Y';
+    // The resting order's side is passive; the aggressor is the opposite.
+    const Aggressor aggr  = (os->side == Side::Bid) ? Aggressor::Sell : Aggressor::Buy;
+
+    if (shares >= os->remainingShares) {
+        out.push_back(ObDeleteEvent{symbols_.name(symbol), ref});
+        orders_.erase(ref);
+    } else {
+        os->remainingShares -= shares;
+        out.push_back(ObUpdateEvent{symbols_.name(symbol), ref, std::nullopt, os->remainingShares});
+    }
+    if (print) emitTrade(symbol, price, shares, aggr, out);
+}
+
+// ---------------------------------------------------------------------------
+// X order cancel
+//   11 orderRef(8)  19 cancelledShares(4)
+// ---------------------------------------------------------------------------
+void ItchBinaryAdapter::onCancel(const uint8_t* m, std::vector<FeedEvent>& out) {
+    const uint64_t ref    = be64(m + 11);
+    const uint32_t shares = be32(m + 19);
+
+    OrderState* os = orders_.find(ref);
+    if (!os) { ++stats_.unknownRef; return; }
+
+    if (shares >= os->remainingShares) {
+        out.push_back(ObDeleteEvent{symbols_.name(os->symbol), ref});
+        orders_.erase(ref);
+    } else {
+        os->remainingShares -= shares;
+        out.push_back(ObUpdateEvent{symbols_.name(os->symbol), ref,
+                                    std::nullopt, os->remainingShares});
+    }
+}
+
+// ---------------------------------------------------------------------------
+// D order delete
+//   11 orderRef(8)
+// ---------------------------------------------------------------------------
+void ItchBinaryAdapter::onDelete(const uint8_t* m, std::vector<FeedEvent>& out) {
+    const uint64_t ref = be64(m + 11);
+
+    const OrderState* os = orders_.find(ref);
+    if (!os) { ++stats_.unknownRef; return; }
+
+    out.push_back(ObDeleteEvent{symbols_.name(os->symbol), ref});
+    orders_.erase(ref);
+}
+
+// ---------------------------------------------------------------------------
+// U order replace → delete old + add new (same symbol and side)
+//   11 origRef(8)  19 newRef(8)  27 shares(4)  31 price(4)
+// ---------------------------------------------------------------------------
+void ItchBinaryAdapter::onReplace(const uint8_t* m, std::vector<FeedEvent>& out) {
+    const uint64_t origRef = be64(m + 11);
+    const uint64_t newRef  = be64(m + 19);
+    const uint32_t shares  = be32(m + 27);
+    const uint32_t price   = be32(m + 31);
+
+    const OrderState* os = orders_.find(origRef);
+    if (!os) { ++stats_.unknownRef; return; }
+
+    const uint32_t symbol = os->symbol;
+    const Side     side   = os->side;
+
+    out.push_back(ObDeleteEvent{symbols_.name(symbol), origRef});
+    orders_.erase(origRef);
+
+    if (newRef == RefTable<OrderState>::kNoRef) { ++stats_.malformed; return; }
+    orders_.put(newRef, OrderState{symbol, shares, price, side});
+    out.push_back(ObAddEvent{symbols_.name(symbol), newRef, side, fromPrice4(price), shares, 0});
+}
+
+// ---------------------------------------------------------------------------
+// P trade (non-displayed order) → OB trade + dispatcher tick
+//   11 orderRef(8)  19 side(1)  20 shares(4)  24 stock(8)  32 price(4)
+// The side names the resting non-displayed order and NASDAQ has sent 'B'
+// for every trade since 2014, so no aggressor is inferred from it.
+// ---------------------------------------------------------------------------
+void ItchBinaryAdapter::onTrade(const uint8_t* m, std::vector<FeedEvent>& out) {
+    const uint32_t symbol = symbolFor(be16(m + kOffLocate), m + 24);
+    emitTrade(symbol, be32(m + 32), be32(m + 20), Aggressor::Unknown, out);
+}
+
+// ---------------------------------------------------------------------------
+// Q cross trade (opening / closing / halt / IPO cross)
+//   11 shares(8)  19 stock(8)  27 crossPrice(4)
+// ---------------------------------------------------------------------------
+void ItchBinaryAdapter::onCross(const uint8_t* m, std::vector<FeedEvent>& out) {
+    const uint64_t shares = be64(m + 11);
+    if (shares == 0) return;    // cross with no volume
+    const uint32_t symbol = symbolFor(be16(m + kOffLocate), m + 19);
+    emitTrade(symbol, be32(m + 27), shares, Aggressor::Unknown, out);
+}
+
+// ---------------------------------------------------------------------------
+// S system event — log only
+//   11 eventCode(1)
+// ---------------------------------------------------------------------------
+void ItchBinaryAdapter::onSystemEvent(const uint8_t* m) {
+    gma::util::logger().log(gma::util::LogLevel::Info,
+        "ItchBinaryAdapter.systemEvent",
+        {{"eventCode", std::string(1, static_cast<char>(m[kOffBody]))}});
+}
+
+} // namespace gma::feed
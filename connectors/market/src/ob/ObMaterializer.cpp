@@ -112,6 +112,9 @@ double rangeIdxReduce(const Snapshot& s, const RangeIdxSpec& spec) {
   if (spec.reduce == Reduce::Avg && count > 0)
     return acc / count;
 
+  if (spec.reduce == Reduce::Count)
+    return static_cast<double>(hi - lo + 1);
+
   return acc;
 }
 
@@ -128,6 +131,10 @@ double rangePxReduce(const Snapshot& s, const RangePxSpec& spec, double /*tick*/
   for (const auto& lvl : L.levels) {
     if (lvl.price < spec.p1 || lvl.price > spec.p2)
       continue;
+    if (spec.reduce == Reduce::Count) {   // count keys carry no target
+      ++count;
+      continue;
+    }
 
     double v = 0.0;
     switch (spec.target) {
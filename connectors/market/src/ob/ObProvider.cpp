@@ -1,16 +1,39 @@
 #include "gma/ob/ObProvider.hpp"
-#include <vector>
-#include <string>
+#include "gma/ob/ObMaterializer.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <limits>
 
 namespace gma::ob {
 
-static inline std::vector<std::string> split(const std::string& s, char d='.') {
-  std::vector<std::string> out; std::string cur;
-  for (char c: s) { if (c==d){ out.push_back(cur); cur.clear(); } else cur.push_back(c); }
-  out.push_back(cur); return out;
+namespace {
+
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+double pick(const SideSums& s, Target t) {
+  switch (t) {
+    case Target::Price:    return s.price;
+    case Target::Size:     return s.size;
+    case Target::Orders:   return s.orders;
+    case Target::Notional: return s.notional;
+    default:               return NaN;
+  }
 }
-static inline int toInt(const std::string& s){ return std::stoi(s); }
+
+double reduce(const SideSums& s, Reduce r, Target t) {
+  if (r == Reduce::Count) return s.levels;
+  const double v = pick(s, t);
+  if (r == Reduce::Avg) return s.levels > 0 ? v / s.levels : 0.0;
+  return v;
+}
+
+double imbalance(const SideSums& bid, const SideSums& ask) {
+  const double sum = bid.size + ask.size;
+  return sum > 0.0 ? (bid.size - ask.size) / sum : 0.0;
+}
+
+} // namespace
 
 Provider::Provider(std::shared_ptr<FunctionalSnapshotSource> src,
                    std::size_t defPerLevels,
@@ -18,75 +41,110 @@ Provider::Provider(std::shared_ptr<FunctionalSnapshotSource> src,
 : src_(std::move(src)), defPer_(defPerLevels), defAgg_(defAggLevels) {}
 
 double Provider::get(const std::string& symbol, const std::string& fullKey) const {
+  auto key = compile(fullKey);
+  if (!key) return std::numeric_limits<double>::quiet_NaN();
+  return eval(symbol, *key);
+}
+
+double Provider::eval(const std::string& symbol, const ObKey& key) const {
   if (!src_) return std::numeric_limits<double>::quiet_NaN();
 
-  // Guard against malformed keys — stoi() throws on non-numeric tokens,
-  // and capture() could throw on degenerate inputs.
+  // capture() could throw on degenerate inputs.
   try {
-    return getImpl(symbol, fullKey);
+    if (auto v = evalFromSums(symbol, key)) return *v;
+    auto snap = snapshot(symbol, depthFor(key), key.mode);
+    return ob::eval(*snap, key);
   } catch (...) {
     return std::numeric_limits<double>::quiet_NaN();
   }
 }
 
-double Provider::getImpl(const std::string& symbol, const std::string& fullKey) const {
+std::optional<double> Provider::evalFromSums(const std::string& symbol, const ObKey& k) const {
+  if (!src_) return std::nullopt;
+  auto levels = [&](Side s, Range r) { return src_->sumLevels(symbol, s, Range{ std::max(1, r.a), r.b }); };
+  auto band   = [&](Side s, double p1, double p2) { return src_->sumBand(symbol, s, p1, p2); };
 
-  // Fast path
-  if (fullKey == "ob.spread") {
-    auto snap = src_->capture(symbol, 1, Mode::Per, std::nullopt);
-    if (snap.bids.levels.empty() || snap.asks.levels.empty())
-      return std::numeric_limits<double>::quiet_NaN();
-    return snap.asks.levels[0].price - snap.bids.levels[0].price;
+  switch (k.metric) {
+    case Metric::Cum: {
+      if (k.cumN <= 0) return 0.0;
+      auto s = levels(k.cumSide, Range{ 1, k.cumN });
+      if (!s) return std::nullopt;
+      return k.cumTarget == Target::None ? 0.0 : pick(*s, k.cumTarget);
+    }
+    case Metric::RangeIdx: {
+      const auto& r = k.rangeIdx;
+      if (r.reduce == Reduce::Min || r.reduce == Reduce::Max) return std::nullopt;
+      auto s = levels(r.side, r.lv);
+      if (!s) return std::nullopt;
+      return s->levels > 0 ? reduce(*s, r.reduce, r.target) : NaN;
+    }
+    case Metric::RangePx: {
+      const auto& r = k.rangePx;
+      if (r.reduce == Reduce::Min || r.reduce == Reduce::Max) return std::nullopt;
+      auto s = band(r.side, r.p1, r.p2);
+      if (!s) return std::nullopt;
+      return reduce(*s, r.reduce, r.target);
+    }
+    case Metric::LevelPx: {
+      auto s = band(k.levelPx.side, k.levelPx.px, k.levelPx.px);
+      if (!s) return std::nullopt;
+      return s->levels > 0 ? pick(*s, k.levelPx.attr) : NaN;
+    }
+    case Metric::VWAP: {
+      auto s = k.vwapByLevels ? levels(k.vwapSide, k.vwapLv) : band(k.vwapSide, k.vwapP1, k.vwapP2);
+      if (!s) return std::nullopt;
+      return s->size > 0.0 ? s->notional / s->size : NaN;
+    }
+    case Metric::Imbalance: {
+      auto b = k.imbByLevels ? levels(Side::Bid, k.imbLv) : band(Side::Bid, k.imbP1, k.imbP2);
+      auto a = k.imbByLevels ? levels(Side::Ask, k.imbLv) : band(Side::Ask, k.imbP1, k.imbP2);
+      if (!b || !a) return std::nullopt;
+      return imbalance(*b, *a);
+    }
+    default:
+      return std::nullopt;
   }
+}
 
-  auto parts = split(fullKey);
-
-  // ob.level.bid.N.metric
-  if (parts.size()==5 && parts[0]=="ob" && parts[1]=="level" && (parts[2]=="bid"||parts[2]=="ask")) {
-    int N = toInt(parts[3]); if (N<=0) return std::numeric_limits<double>::quiet_NaN();
-    const std::string& metric = parts[4];
-    auto snap = src_->capture(symbol, std::max<std::size_t>(defPer_, (std::size_t)N), Mode::Per, std::nullopt);
-    const auto& vec = (parts[2]=="bid") ? snap.bids.levels : snap.asks.levels;
-    if ((int)vec.size() < N) return std::numeric_limits<double>::quiet_NaN();
-    const auto& L = vec[N-1];
-    if (metric=="price")    return L.price;
-    if (metric=="size")     return L.size;
-    if (metric=="notional") return L.notional;
-    if (metric=="orders")   return L.orders;
-    return std::numeric_limits<double>::quiet_NaN();
+std::size_t Provider::depthFor(const ObKey& k) const {
+  std::size_t need = 1;
+  switch (k.metric) {
+    case Metric::Best:
+    case Metric::Spread:
+    case Metric::Mid:      need = 1; break;
+    case Metric::LevelIdx: need = static_cast<std::size_t>(k.levelIdx.n); break;
+    case Metric::RangeIdx: need = static_cast<std::size_t>(k.rangeIdx.lv.b); break;
+    case Metric::Cum:      need = static_cast<std::size_t>(k.cumN); break;
+    case Metric::VWAP:
+      need = k.vwapByLevels ? static_cast<std::size_t>(k.vwapLv.b) : SIZE_MAX; break;
+    case Metric::Imbalance:
+      need = k.imbByLevels ? static_cast<std::size_t>(k.imbLv.b) : SIZE_MAX; break;
+    case Metric::LevelPx:
+    case Metric::RangePx:  need = SIZE_MAX; break;
+    case Metric::Meta:     need = 0; break;
   }
+  return std::max(k.mode == Mode::Agg ? defAgg_ : defPer_, need);
+}
 
-  // ob.cum.bid.levels.K.metric
-  if (parts.size()==6 && parts[0]=="ob" && parts[1]=="cum" && (parts[2]=="bid"||parts[2]=="ask") && parts[3]=="levels") {
-    int K = toInt(parts[4]); if (K<=0) return std::numeric_limits<double>::quiet_NaN();
-    const std::string& metric = parts[5];
-    auto snap = src_->capture(symbol, std::max<std::size_t>(defPer_, (std::size_t)K), Mode::Per, std::nullopt);
-    const auto& vec = (parts[2]=="bid") ? snap.bids.levels : snap.asks.levels;
-    double acc=0.0; int n = std::min<int>(K, (int)vec.size());
-    for (int i=0;i<n;++i) {
-      if      (metric=="size")     acc += vec[i].size;
-      else if (metric=="notional") acc += vec[i].notional;
-      else if (metric=="orders")   acc += vec[i].orders;
-      else return std::numeric_limits<double>::quiet_NaN();
-    }
-    return acc;
+std::shared_ptr<const Snapshot> Provider::snapshot(const std::string& symbol, std::size_t depth, Mode mode) const {
+  if (!src_) return std::make_shared<const Snapshot>();
+  auto& cache = cache_[mode == Mode::Agg ? 1 : 0];
+  const auto ver = src_->version(symbol);   // read before capturing: never label a capture newer than it is
+  if (ver) {
+    std::lock_guard<std::mutex> lk(cacheMx_);
+    auto it = cache.find(symbol);
+    if (it != cache.end() && it->second.version == *ver && it->second.depth >= depth) return it->second.snap;
   }
 
-  // ob.imbalance.levels.M-N
-  if (parts.size()==4 && parts[0]=="ob" && parts[1]=="imbalance" && parts[2]=="levels") {
-    auto range = parts[3];
-    auto dash = range.find('-'); if (dash==std::string::npos) return std::numeric_limits<double>::quiet_NaN();
-    int M = toInt(range.substr(0,dash)), N = toInt(range.substr(dash+1));
-    if (M<=0 || N<M) return std::numeric_limits<double>::quiet_NaN();
-    auto snap = src_->capture(symbol, std::max<std::size_t>(defPer_, (std::size_t)N), Mode::Per, std::nullopt);
-    double b=0, a=0;
-    int hi = std::min<int>(N, (int)std::min(snap.bids.levels.size(), snap.asks.levels.size()));
-    for (int i=M-1;i<hi;++i) { b += snap.bids.levels[i].size; a += snap.asks.levels[i].size; }
-    double den = b+a; if (den<=0) return 0.0;
-    return (b-a)/den;
-  }
+  auto snap = std::make_shared<const Snapshot>(src_->capture(symbol, depth, mode, std::nullopt));
+  captures_.fetch_add(1, std::memory_order_relaxed);
 
-  return std::numeric_limits<double>::quiet_NaN();
+  if (ver) {
+    std::lock_guard<std::mutex> lk(cacheMx_);
+    auto& e = cache[symbol];
+    if (!e.snap || *ver > e.version || (*ver == e.version && depth > e.depth)) e = CacheEntry{ *ver, depth, snap };
+  }
+  return snap;
 }
 
 } // namespace gma::ob
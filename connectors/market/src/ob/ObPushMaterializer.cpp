@@ -0,0 +1,238 @@
+#include "gma/ob/ObPushMaterializer.hpp"
+#include "gma/ob/ObMaterializer.hpp"
+#include "gma/util/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+namespace gma::ob {
+
+std::shared_ptr<PushMaterializer> PushMaterializer::create(std::shared_ptr<OrderBookManager> books,
+                                                           std::shared_ptr<Provider> provider,
+                                                           NotifyFn notify) {
+  std::shared_ptr<PushMaterializer> self(
+    new PushMaterializer(std::move(books), std::move(provider), std::move(notify)));
+  std::weak_ptr<PushMaterializer> weak = self;
+  self->symbolSubId_ = self->books_->subscribeSymbols([weak](const std::string& symbol) {
+    if (auto p = weak.lock()) p->onSymbol(symbol);
+  });
+  return self;
+}
+
+PushMaterializer::PushMaterializer(std::shared_ptr<OrderBookManager> books,
+                                   std::shared_ptr<Provider> provider,
+                                   NotifyFn notify)
+: books_(std::move(books)), provider_(std::move(provider)), notify_(std::move(notify)) {}
+
+PushMaterializer::~PushMaterializer() { stop(); }
+
+PushMaterializer::Dep PushMaterializer::depFor(const ObKey& k) {
+  Dep d;
+  auto idx = [](Side s) { return s == Side::Bid ? 0 : 1; };
+  auto band = [&](int s, double lo, double hi) { d.band[s] = true; d.lo[s] = lo; d.hi[s] = hi; };
+  switch (k.metric) {
+    case Metric::Best:     d.depth[idx(k.bestSide)] = 1; break;
+    case Metric::Spread:
+    case Metric::Mid:      d.depth[0] = d.depth[1] = 1; break;
+    case Metric::LevelIdx: d.depth[idx(k.levelIdx.side)] = static_cast<std::size_t>(k.levelIdx.n); break;
+    case Metric::RangeIdx: d.depth[idx(k.rangeIdx.side)] = static_cast<std::size_t>(k.rangeIdx.lv.b); break;
+    case Metric::Cum:      d.depth[idx(k.cumSide)] = static_cast<std::size_t>(k.cumN); break;
+    case Metric::LevelPx:  band(idx(k.levelPx.side), k.levelPx.px, k.levelPx.px); break;
+    case Metric::RangePx:  band(idx(k.rangePx.side), k.rangePx.p1, k.rangePx.p2); break;
+    case Metric::VWAP:
+      if (k.vwapByLevels) d.depth[idx(k.vwapSide)] = static_cast<std::size_t>(k.vwapLv.b);
+      else                band(idx(k.vwapSide), k.vwapP1, k.vwapP2);
+      break;
+    case Metric::Imbalance:
+      if (k.imbByLevels) d.depth[0] = d.depth[1] = static_cast<std::size_t>(k.imbLv.b);
+      else { band(0, k.imbP1, k.imbP2); band(1, k.imbP1, k.imbP2); }
+      break;
+    case Metric::Meta:     d.any = true; break;
+  }
+  return d;
+}
+
+// A level change can move a top-N key only if it lands at or inside the
+// N-th level of the book as last evaluated (or that side had fewer than N
+// levels); a band key only if it falls in the band. Deltas without level
+// changes come from snapshots and touch everything.
+bool PushMaterializer::touches(const Dep& dep, const BookDelta& d, const Snapshot* last, double tick) {
+  if (dep.any || d.levels.empty() || !last) return true;
+  const double eps = 0.5 * tick;
+  for (const auto& lv : d.levels) {
+    const int s = (lv.side == gma::Side::Bid) ? 0 : 1;
+    const double px = static_cast<double>(lv.price.ticks) * tick;
+    if (dep.depth[s] > 0) {
+      const auto& L = (s == 0 ? last->bids : last->asks).levels;
+      if (L.size() < dep.depth[s]) return true;
+      const double edge = L[dep.depth[s] - 1].price;
+      if (s == 0 ? px >= edge - eps : px <= edge + eps) return true;
+    }
+    if (dep.band[s] && px >= dep.lo[s] - eps && px <= dep.hi[s] + eps) return true;
+  }
+  return false;
+}
+
+void PushMaterializer::evaluate(const std::string& symbol, SymbolKeys& sk, const std::vector<bool>& which,
+                                std::vector<Push>& out) {
+  // Keys the source can sum directly skip the capture. The capture is
+  // still taken deep enough for every subscribed top-N key, so the next
+  // delta's depth check has the N-th level; the full book only if a band
+  // key has to be read from it.
+  std::vector<std::optional<double>> summed(sk.keys.size());
+  std::size_t depth = 1;
+  bool full = false;
+  for (std::size_t i = 0; i < sk.keys.size(); ++i) {
+    const Dep& dep = sk.keys[i].dep;
+    depth = std::max({depth, dep.depth[0], dep.depth[1]});
+    if (!which[i]) continue;
+    summed[i] = provider_->evalFromSums(symbol, sk.keys[i].key);
+    if (!summed[i] && (dep.band[0] || dep.band[1])) full = true;
+  }
+  auto snap = provider_->snapshot(symbol, full ? SIZE_MAX : depth, Mode::Per);
+  sk.last = snap;
+
+  for (std::size_t i = 0; i < sk.keys.size(); ++i) {
+    if (!which[i]) continue;
+    Entry& e = sk.keys[i];
+    const double v = summed[i] ? *summed[i] : ob::eval(*snap, e.key);
+    evals_.fetch_add(1, std::memory_order_relaxed);
+    if (std::isnan(v)) { e.last = v; continue; }        // unavailable: nothing to push
+    if (v == e.last) continue;
+    e.last = v;
+    out.emplace_back(e.name, v);
+  }
+}
+
+void PushMaterializer::subscribe(const std::string& symbol, const std::string& fullKey) {
+  auto key = parseObKey(fullKey);
+  if (!key) return;
+
+  std::vector<Push> out;
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    if (stopped_) return;
+    auto it = symbols_.find(symbol);
+    if (it == symbols_.end()) {
+      const uint64_t subId = attach(symbol);
+      if (subId == 0) {
+        // Not in the book yet: wait for onSymbol, within the cap, since
+        // client-named symbols may never appear on the feed.
+        if (pending_ >= kMaxPendingSymbols) {
+          gma::util::logger().log(gma::util::LogLevel::Warn,
+                                  "PushMaterializer: pending symbol cap reached, dropping",
+                                  {{"symbol", symbol}, {"key", fullKey}});
+          return;
+        }
+        ++pending_;
+      }
+      it = symbols_.emplace(symbol, std::make_shared<SymbolKeys>()).first;
+      it->second->subId = subId;
+    }
+    SymbolKeys& sk = *it->second;
+
+    std::lock_guard<std::mutex> klk(sk.mx);
+    for (const auto& e : sk.keys) if (e.name == fullKey) return;
+    sk.keys.push_back(Entry{ fullKey, *key, depFor(*key), std::numeric_limits<double>::quiet_NaN() });
+    if (sk.subId == 0) return;              // nothing to read yet
+    std::vector<bool> which(sk.keys.size(), false);
+    which.back() = true;
+    evaluate(symbol, sk, which, out);
+    // Under sk.mx, so pushes for a symbol leave in evaluation order.
+    for (const auto& [k, v] : out) notify_(symbol, k, v);
+  }
+}
+
+void PushMaterializer::unsubscribe(const std::string& symbol, const std::string& fullKey) {
+  std::lock_guard<std::mutex> lk(mx_);
+  auto it = symbols_.find(symbol);
+  if (it == symbols_.end()) return;
+  SymbolKeys& sk = *it->second;
+  {
+    std::lock_guard<std::mutex> klk(sk.mx);
+    sk.keys.erase(std::remove_if(sk.keys.begin(), sk.keys.end(),
+                                 [&](const Entry& e) { return e.name == fullKey; }),
+                  sk.keys.end());
+    if (!sk.keys.empty()) return;
+    if (sk.subId) books_->unsubscribeDeltas(symbol, sk.subId);
+    else          --pending_;
+    sk.subId = 0;
+  }
+  symbols_.erase(it);
+}
+
+std::size_t PushMaterializer::pendingSymbols() const {
+  std::lock_guard<std::mutex> lk(mx_);
+  return pending_;
+}
+
+uint64_t PushMaterializer::attach(const std::string& symbol) {
+  std::weak_ptr<PushMaterializer> weak = weak_from_this();
+  return books_->subscribeDeltas(symbol, [weak](const BookDelta& d) {
+    if (auto self = weak.lock()) self->onDelta(d.symbol, d);
+  });
+}
+
+void PushMaterializer::onSymbol(const std::string& symbol) {
+  std::vector<Push> out;
+  std::lock_guard<std::mutex> lk(mx_);
+  if (stopped_) return;
+  auto it = symbols_.find(symbol);
+  if (it == symbols_.end()) return;
+  SymbolKeys& sk = *it->second;
+
+  std::lock_guard<std::mutex> klk(sk.mx);
+  if (sk.subId) return;
+  sk.subId = attach(symbol);
+  if (sk.subId == 0) return;
+  --pending_;
+  // The book is usually still empty here; the creating call's delta
+  // follows and pushes through onDelta.
+  evaluate(symbol, sk, std::vector<bool>(sk.keys.size(), true), out);
+  for (const auto& [k, v] : out) notify_(symbol, k, v);
+}
+
+void PushMaterializer::stop() {
+  std::lock_guard<std::mutex> lk(mx_);
+  if (stopped_) return;
+  stopped_ = true;
+  books_->unsubscribeSymbols(symbolSubId_);
+  pending_ = 0;
+  for (auto& [symbol, sk] : symbols_) {
+    std::lock_guard<std::mutex> klk(sk->mx);
+    if (sk->subId) books_->unsubscribeDeltas(symbol, sk->subId);
+    sk->subId = 0;
+    sk->keys.clear();
+  }
+  symbols_.clear();
+}
+
+void PushMaterializer::onDelta(const std::string& symbol, const BookDelta& d) {
+  std::shared_ptr<SymbolKeys> sk;
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    if (stopped_) return;
+    auto it = symbols_.find(symbol);
+    if (it == symbols_.end()) return;
+    sk = it->second;
+  }
+
+  std::vector<Push> out;
+  {
+    std::lock_guard<std::mutex> klk(sk->mx);
+    if (sk->keys.empty()) return;
+    const double tick = books_->getTickSize(symbol);
+    std::vector<bool> which(sk->keys.size(), false);
+    bool any = false;
+    for (std::size_t i = 0; i < sk->keys.size(); ++i) {
+      which[i] = touches(sk->keys[i].dep, d, sk->last.get(), tick);
+      any = any || which[i];
+    }
+    if (any) evaluate(symbol, *sk, which, out);
+    for (const auto& [k, v] : out) notify_(symbol, k, v);
+  }
+}
+
+} // namespace gma::ob
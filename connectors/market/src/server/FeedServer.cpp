@@ -5,13 +5,19 @@
 #include <boost/asio/steady_timer.hpp>
 #include <boost/beast/core.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <deque>
+#include <string_view>
 #include <utility>
 
 // Project headers (adjust paths if needed)
 #include "gma/Dispatcher.hpp"
 #include "gma/Event.hpp"
 #include "gma/book/OrderBookManager.hpp"
+#include "gma/market/MarketTickDecoder.hpp"
+#include "gma/server/LineReader.hpp"
+#include "gma/server/TickArena.hpp"
 #include "gma/util/Logger.hpp"
 #include "gma/util/Metrics.hpp"
 
@@ -27,10 +33,12 @@ public:
   FeedSession(tcp::socket socket,
               Dispatcher* dispatcher,
               OrderBookManager* obManager,
+              std::shared_ptr<const market::MarketTickDecoder> decoder,
               FeedServer* owner)
     : socket_(std::move(socket))
     , dispatcher_(dispatcher)
     , obManager_(obManager)
+    , decoder_(std::move(decoder))
     , owner_(owner)
     , idleTimer_(socket_.get_executor())
   {}
@@ -52,8 +60,9 @@ public:
 private:
   void doRead() {
     auto self = shared_from_this();
+    const auto space = reader_.prepare();
     socket_.async_read_some(
-      boost::asio::buffer(buf_),
+      boost::asio::buffer(space.data(), space.size()),
       [self](boost::system::error_code ec, std::size_t n) {
         self->onRead(ec, n);
       });
@@ -68,43 +77,37 @@ private:
 
     resetIdleTimer();
 
-    // Very simple framing: treat incoming as newline-delimited text messages
-    pending_.insert(pending_.end(), buf_.data(), buf_.data() + n);
-
-    // Guard against slow-send DoS: disconnect if pending data exceeds limit
-    // without producing a complete line.
-    if (pending_.size() > MAX_PENDING) {
+    // Newline-delimited text messages, framed and parsed in place in the
+    // read buffer.
+    reader_.commit(n);
+    while (auto line = reader_.next()) {
+      handleLine(*line);
+    }
+    // Ticks from every complete line in this read reach the dispatcher as
+    // one batch; then the lines' memory is reused for the next read.
+    flushTicks();
+    TickArena::recycle(arena_);
+
+    // Guard against slow-send DoS: disconnect once a partial line fills
+    // the whole read buffer.
+    if (reader_.full()) {
       GMA_METRIC_HIT("feed.pending_overflow");
       gma::util::logger().log(gma::util::LogLevel::Warn,
                               "feed.pending_overflow",
-                              {{"size", std::to_string(pending_.size())}});
+                              {{"size", std::to_string(reader_.pending())}});
       close();
       return;
     }
 
-    std::size_t start = 0;
-    for (std::size_t i = 0; i < pending_.size(); ++i) {
-      if (pending_[i] == '\n') {
-        std::size_t lineEnd = i;
-        if (lineEnd > start && pending_[lineEnd - 1] == '\r') {
-          --lineEnd;
-        }
-        const std::string line(pending_.data() + start, pending_.data() + lineEnd);
-        handleLine(line);
-        start = i + 1;
-      }
-    }
-    if (start > 0) {
-      pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(start));
-    }
-
     doRead(); // continue reading
   }
 
   static constexpr std::size_t MAX_LINE_SIZE = 64 * 1024;  // 64 KB
   static constexpr std::size_t MAX_PENDING  = 128 * 1024; // 128 KB
 
-  void handleLine(const std::string& line) {
+  // `line` is parsed into the read's arena, so tick payloads outlive the
+  // read buffer without a copy of their own.
+  void handleLine(std::span<char> line) {
     GMA_METRIC_HIT("feed.line_in");
 
     // Guard against oversized lines (DoS prevention).
@@ -117,24 +120,52 @@ private:
     }
 
     try {
-      rapidjson::Document doc;
-      doc.Parse(line.c_str());
+      const std::string_view text(line.data(), line.size());
+
+      // A plain tick line (no "type") is decoded straight from the text.
+      // Its DOM is only built when a raw-field listener or a computer
+      // reads the payload.
+      std::shared_ptr<const TickEntry> decoded;
+      TickEntry entry;
+      std::string_view symbol;
+      if (dispatcher_ && decoder_ && text.find("\"type\"") == std::string_view::npos
+          && decoder_->scan(text, entry, &symbol) == market::MarketTickDecoder::Scan::Tick
+          && !symbol.empty() && symbol.size() <= 64) {
+        decoded = arena_->keep(entry);
+        gma::Event t;
+        t.symbol.assign(symbol);
+        if (!dispatcher_->wantsPayload(t.symbol, t.type, text)) {
+          t.decoded = std::move(decoded);
+          queueTick(std::move(t));
+          return;
+        }
+      }
+
+      auto& doc = arena_->parse(text);
       if (doc.HasParseError() || !doc.IsObject()) {
         GMA_METRIC_HIT("feed.tick_bad");
+        const std::size_t at = std::min(doc.GetErrorOffset(), line.size());
         gma::util::logger().log(gma::util::LogLevel::Warn,
                                 "feed.line.bad_json",
-                                {{"line", line.substr(0, 200)}});
+                                {{"size", std::to_string(line.size())},
+                                 {"offset", std::to_string(at)},
+                                 {"near", std::string(line.data() + at,
+                                                      std::min<std::size_t>(line.size() - at, 200))}});
         return;
       }
 
       // Route by "type" field
-      if (doc.HasMember("type") && doc["type"].IsString()) {
-        const std::string type = doc["type"].GetString();
+      auto typeIt = doc.FindMember("type");
+      if (typeIt != doc.MemberEnd() && typeIt->value.IsString()) {
+        const std::string_view type(typeIt->value.GetString(),
+                                    typeIt->value.GetStringLength());
         if (type == "ob") {
+          flushTicks();
           handleObMessage(doc);
           return;
         }
         if (type == "control") {
+          flushTicks();
           handleControlMessage(doc);
           return;
         }
@@ -142,7 +173,7 @@ private:
       }
 
       // Default: market tick path
-      handleTickMessage(doc, line);
+      handleTickMessage(doc, line.size(), std::move(decoded));
 
     } catch (const std::exception& ex) {
       GMA_METRIC_HIT("feed.tick_bad");
@@ -156,19 +187,22 @@ private:
     }
   }
 
-  void handleTickMessage(rapidjson::Document& doc, const std::string& line) {
+  // `decoded` is the tick already decoded from the line, if any.
+  void handleTickMessage(const rapidjson::Value& doc, std::size_t lineSize,
+                         std::shared_ptr<const TickEntry> decoded) {
     if (!dispatcher_) return;
 
-    if (!doc.HasMember("symbol") || !doc["symbol"].IsString()) {
+    auto symIt = doc.FindMember("symbol");
+    if (symIt == doc.MemberEnd() || !symIt->value.IsString()) {
       GMA_METRIC_HIT("feed.tick_bad");
       gma::util::logger().log(gma::util::LogLevel::Warn,
                               "feed.line.missing_symbol",
-                              {{"line", line.substr(0, 200)}});
+                              {{"size", std::to_string(lineSize)}});
       return;
     }
 
     gma::Event t;
-    t.symbol = doc["symbol"].GetString();
+    t.symbol.assign(symIt->value.GetString(), symIt->value.GetStringLength());
 
     // Reject empty or absurdly long symbols.
     if (t.symbol.empty() || t.symbol.size() > 64) {
@@ -179,16 +213,34 @@ private:
       return;
     }
 
-    // Move doc onto heap for shared ownership in the tick
-    auto shared = std::make_shared<rapidjson::Document>(std::move(doc));
-    t.payload = std::move(shared);
+    // Already in the arena: the payload just takes a share of it.
+    t.payload = arena_->keep();
+    t.decoded = std::move(decoded);
+    queueTick(std::move(t));
+  }
 
+  void queueTick(gma::Event&& t) {
     GMA_METRIC_HIT("feed.tick_ok");
     GMA_METRIC_HIT("dispatch.tick");
-    dispatcher_->onTick(t);
+    tickBatch_.push_back(std::move(t));
   }
 
-  void handleObMessage(const rapidjson::Document& doc) {
+  // Hand buffered ticks to the dispatcher. Called at the end of each read
+  // and before any non-tick message so feed order is preserved.
+  void flushTicks() {
+    if (tickBatch_.empty()) return;
+    try {
+      dispatcher_->onTickBatch(tickBatch_);
+    } catch (const std::exception& ex) {
+      GMA_METRIC_HIT("feed.tick_bad");
+      gma::util::logger().log(gma::util::LogLevel::Error,
+                              "feed.dispatch exception",
+                              {{"err", ex.what()}, {"ticks", std::to_string(tickBatch_.size())}});
+    }
+    tickBatch_.clear();
+  }
+
+  void handleObMessage(const rapidjson::Value& doc) {
     if (!obManager_) {
       GMA_METRIC_HIT("feed.ob_no_manager");
       return;
@@ -275,7 +327,7 @@ private:
     }
   }
 
-  void handleControlMessage(const rapidjson::Document& doc) {
+  void handleControlMessage(const rapidjson::Value& doc) {
     if (!doc.HasMember("action") || !doc["action"].IsString()) {
       GMA_METRIC_HIT("feed.control_bad");
       return;
@@ -323,11 +375,16 @@ private:
   tcp::socket        socket_;
   Dispatcher*  dispatcher_{nullptr};  // not owned
   OrderBookManager*  obManager_{nullptr};   // not owned
+  std::shared_ptr<const market::MarketTickDecoder> decoder_;  // may be null
   FeedServer*        owner_{nullptr};       // not owned
   boost::asio::steady_timer idleTimer_;
 
-  std::array<char, 8 * 1024> buf_{};
-  std::vector<char>          pending_;
+  LineReader                 reader_{MAX_PENDING};
+  std::vector<gma::Event>    tickBatch_;
+
+  // DOMs of this read's lines, tick payloads and decoded ticks included;
+  // recycled once the read's ticks have been dispatched.
+  std::shared_ptr<TickArena> arena_ = TickArena::create();
 };
 
 // ---------------------- FeedServer ----------------------
@@ -353,6 +410,16 @@ FeedServer::FeedServer(boost::asio::io_context& ioc,
   // the IConnector lifecycle: registerWith allocates, start brings up).
 }
 
+FeedServer::FeedServer(boost::asio::io_context& ioc,
+                       Dispatcher* dispatcher,
+                       OrderBookManager* obManager,
+                       const market::MarketFieldMap& fieldMap,
+                       unsigned short port)
+  : FeedServer(ioc, dispatcher, obManager, port)
+{
+  decoder_ = std::make_shared<const market::MarketTickDecoder>(fieldMap);
+}
+
 void FeedServer::run() {
   bool expected = false;
   if (!accepting_.compare_exchange_strong(expected, true)) return;
@@ -375,6 +442,12 @@ void FeedServer::run() {
   doAccept();
 }
 
+unsigned short FeedServer::port() const {
+  boost::system::error_code ec;
+  auto ep = acceptor_.local_endpoint(ec);
+  return ec ? 0 : ep.port();
+}
+
 void FeedServer::stop() {
   accepting_.store(false);
 
@@ -421,7 +494,8 @@ void FeedServer::onAccept(boost::system::error_code ec, tcp::socket socket) {
       }
     }
 
-    auto sp = std::make_shared<FeedSession>(std::move(socket), dispatcher_, obManager_, this);
+    auto sp = std::make_shared<FeedSession>(std::move(socket), dispatcher_, obManager_,
+                                            decoder_, this);
     {
       std::lock_guard<std::mutex> lk(mu_);
       sessions_.insert(sp);
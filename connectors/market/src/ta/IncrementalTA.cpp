@@ -0,0 +1,379 @@
+#include "gma/ta/IncrementalTA.hpp"
+#include "gma/util/Logger.hpp"
+#include "gma/util/VectorKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace gma::ta {
+
+namespace {
+
+// Same floor as computeAllAtomicValues() uses for RSI / ROC denominators.
+constexpr double EPSILON = 1e-6;
+
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+double sign(double d) { return d > 0 ? 1.0 : (d < 0 ? -1.0 : 0.0); }
+
+} // namespace
+
+IncrementalTA::IncrementalTA(const util::Config& cfg, std::size_t window, bool indicators)
+  : IncrementalTA(cfg, window, indicators, nullptr, nullptr)
+{}
+
+IncrementalTA::IncrementalTA(const util::Config& cfg, std::size_t window, bool indicators,
+                             HistoryStore::Column& prices, HistoryStore::Column& volumes)
+  : IncrementalTA(cfg, window, indicators, &prices, &volumes)
+{}
+
+IncrementalTA::IncrementalTA(const util::Config& cfg, std::size_t window, bool indicators,
+                             HistoryStore::Column* prices, HistoryStore::Column* volumes)
+  : window_(std::max<std::size_t>(1, window))
+  , indicators_(indicators)
+  , ownPx_(prices ? nullptr : std::make_unique<HistoryStore::Column>(window_ + 1))
+  , ownVol_(volumes ? nullptr : std::make_unique<HistoryStore::Column>(window_ + 1))
+  , px_(prices ? prices : ownPx_.get())
+  , vol_(volumes ? volumes : ownVol_.get())
+  , bid_(window_ + 1)
+  , ask_(window_ + 1)
+  , ts_(window_ + 1)
+{
+  px_->clear();
+  vol_->clear();
+  if (!indicators_) return;
+
+  if (cfg.taBBands_n <= 0 || cfg.taRSI <= 0 ||
+      cfg.taMACD_fast <= 0 || cfg.taMACD_slow <= 0 || cfg.taMACD_signal <= 0 ||
+      cfg.taMomentum <= 0 || cfg.taATR <= 0 || cfg.taVolAvg <= 0) {
+    gma::util::logger().log(gma::util::LogLevel::Warn,
+      "IncrementalTA: indicators disabled — invalid TA config (zero or negative period)");
+    valid_ = false;
+    return;
+  }
+
+  for (int p : cfg.taSMA) {
+    if (p <= 0) continue;
+    sma_.push_back(Sma{static_cast<std::size_t>(p), 0.0, "sma_" + std::to_string(p)});
+  }
+  for (int p : cfg.taEMA) {
+    if (p <= 0) continue;
+    const double k = 2.0 / (p + 1);
+    ema_.push_back(Ema{static_cast<std::size_t>(p), k, 1.0 - k,
+                       std::pow(1.0 - k, static_cast<double>(window_)), 0.0,
+                       "ema_" + std::to_string(p)});
+  }
+
+  bbN_  = static_cast<std::size_t>(cfg.taBBands_n);
+  bbK_  = cfg.taBBands_stdK;
+  rsiP_ = static_cast<std::size_t>(cfg.taRSI);
+  atrP_ = static_cast<std::size_t>(cfg.taATR);
+  momP_ = static_cast<std::size_t>(cfg.taMomentum);
+  volP_ = static_cast<std::size_t>(cfg.taVolAvg);
+
+  macdFast_ = static_cast<std::size_t>(cfg.taMACD_fast);
+  macdSlow_ = static_cast<std::size_t>(cfg.taMACD_slow);
+  macdSig_  = static_cast<std::size_t>(cfg.taMACD_signal);
+  kF_   = 2.0 / (macdFast_ + 1); aF_   = 1.0 - kF_;
+  kS_   = 2.0 / (macdSlow_ + 1); aS_   = 1.0 - kS_;
+  kSig_ = 2.0 / (macdSig_ + 1);  aSig_ = 1.0 - kSig_;
+  aSigPow_ = std::pow(aSig_, static_cast<double>(macdSig_ - 1));
+
+  // Signal weights: seed c_0 = aSig^(sig-1), then c_r = kSig aSig^(sig-1-r).
+  for (std::size_t r = 0; r < macdSig_; ++r) {
+    const double c = r == 0 ? aSigPow_
+                            : kSig_ * std::pow(aSig_, static_cast<double>(macdSig_ - 1 - r));
+    sigCF_ += c * std::pow(aF_, static_cast<double>(r));
+    sigCS_ += c * std::pow(aS_, static_cast<double>(r));
+  }
+
+  rsiKey_    = "rsi_" + std::to_string(cfg.taRSI);
+  momKey_    = "momentum_" + std::to_string(cfg.taMomentum);
+  rocKey_    = "roc_" + std::to_string(cfg.taMomentum);
+  atrKey_    = "atr_" + std::to_string(cfg.taATR);
+  volAvgKey_ = "volume_avg_" + std::to_string(cfg.taVolAvg);
+}
+
+double IncrementalTA::open() const noexcept { return px_->empty() ? NaN : price(0); }
+double IncrementalTA::high() const noexcept { return maxq_.empty() ? NaN : maxq_.front().price; }
+double IncrementalTA::low()  const noexcept { return minq_.empty() ? NaN : minq_.front().price; }
+
+void IncrementalTA::push(const TickEntry& e) {
+  const double p = e.price;
+  px_->push_back(p);
+  vol_->push_back(e.volume);
+  bid_.push_back(e.bid);
+  ask_.push_back(e.ask);
+  ts_.push_back(e.timestampNs);
+
+  while (!maxq_.empty() && maxq_.back().price <= p) maxq_.pop_back();
+  while (!minq_.empty() && minq_.back().price >= p) minq_.pop_back();
+  maxq_.push_back(Extremum{seq_, p});
+  minq_.push_back(Extremum{seq_, p});
+  ++seq_;
+
+  const bool ta = indicators_ && valid_;
+  // Window-relative sums are updated while the evicted tick is still at
+  // the front, so "the value leaving the last P" is always addressable.
+  if (ta) pushIndicators(e);
+
+  if (px_->size() > window_) {
+    if (ta) {
+      evictIndicators();
+      uHist_.pop_front();
+    }
+    px_->pop_front();
+    vol_->pop_front();
+    bid_.pop_front();
+    ask_.pop_front();
+    ts_.pop_front();
+  }
+
+  const std::uint64_t first = seq_ - px_->size();
+  while (maxq_.front().seq < first) maxq_.pop_front();
+  while (minq_.front().seq < first) minq_.pop_front();
+
+  if (ta && ++sinceResync_ >= window_) resync();
+}
+
+void IncrementalTA::pushIndicators(const TickEntry& e) {
+  const double p = e.price;
+  const double v = e.volume;
+  const std::size_t m = px_->size();   // includes e, and a tick about to be evicted
+
+  sumPx_  += p;
+  sumPV_  += p * v;
+  sumVol_ += v;
+  if (v > 0) ++volPos_;
+
+  // Median: keep lo_ the (equal or one larger) lower half.
+  if (lo_.empty() || p <= *lo_.rbegin()) lo_.insert(p);
+  else                                   hi_.insert(p);
+  if (lo_.size() > hi_.size() + 1) {
+    hi_.insert(*lo_.rbegin());
+    lo_.erase(std::prev(lo_.end()));
+  } else if (hi_.size() > lo_.size()) {
+    lo_.insert(*hi_.begin());
+    hi_.erase(hi_.begin());
+  }
+
+  if (m >= 2) {
+    const double d = p - price(m - 2);
+    obv_ += sign(d) * v;
+    if (d > 0) rsiGain_ += d; else rsiLoss_ -= d;
+    atrSum_ += std::abs(d);
+  }
+  if (m >= rsiP_ + 2) {
+    const double d = price(m - 1 - rsiP_) - price(m - 2 - rsiP_);
+    if (d > 0) rsiGain_ -= d; else rsiLoss_ += d;
+  }
+  if (m >= atrP_ + 2)
+    atrSum_ -= std::abs(price(m - 1 - atrP_) - price(m - 2 - atrP_));
+
+  for (auto& s : sma_) {
+    s.sum += p;
+    if (m > s.period) s.sum -= price(m - 1 - s.period);
+  }
+
+  if (seq_ == 1) bbShift_ = p;
+  const double y = p - bbShift_;
+  bbSum_   += y;
+  bbSumSq_ += y * y;
+  if (m > bbN_) {
+    const double y0 = price(m - 1 - bbN_) - bbShift_;
+    bbSum_   -= y0;
+    bbSumSq_ -= y0 * y0;
+  }
+
+  volSum_ += v;
+  if (m > volP_) volSum_ -= volume(m - 1 - volP_);
+
+  // EMAs stay seeded at the window's first tick. Sliding the seed forward
+  // by one tick over a full window of W adds a^W (x1 - x0).
+  for (auto& em : ema_) {
+    if (m == 1)              em.val = p;
+    else if (m <= window_)   em.val = em.a * em.val + em.k * p;
+    else                     em.val = em.a * em.val + em.k * p
+                                    + em.aWindow * (price(1) - price(0));
+  }
+
+  uF_ = aF_ * uF_ + kF_ * p;
+  uS_ = aS_ * uS_ + kS_ * p;
+  uHist_.emplace_back(uF_, uS_);
+  const double mu = uF_ - uS_;
+  muRing_.push_back(mu);
+  if (muRing_.size() > macdSig_) muRing_.pop_front();
+  sigR_ = aSig_ * sigR_ + kSig_ * mu;
+  if (muRing_.size() == macdSig_) sigR_ -= kSig_ * aSigPow_ * muRing_.front();
+}
+
+void IncrementalTA::evictIndicators() {
+  const double p0 = price(0), v0 = volume(0);
+  sumPx_  -= p0;
+  sumPV_  -= p0 * v0;
+  sumVol_ -= v0;
+  if (v0 > 0) --volPos_;
+
+  if (!lo_.empty() && p0 <= *lo_.rbegin()) lo_.erase(lo_.find(p0));
+  else                                     hi_.erase(hi_.find(p0));
+  if (lo_.size() > hi_.size() + 1) {
+    hi_.insert(*lo_.rbegin());
+    lo_.erase(std::prev(lo_.end()));
+  } else if (hi_.size() > lo_.size()) {
+    lo_.insert(*hi_.begin());
+    hi_.erase(hi_.begin());
+  }
+
+  obv_ -= sign(price(1) - p0) * volume(1);
+}
+
+// Rebuild every add/subtract sum from the window so rounding can't
+// accumulate. The MACD running EMAs (uF_/uS_) are contractive and need none.
+void IncrementalTA::resync() {
+  namespace simd = util::simd;
+  sinceResync_ = 0;
+  const std::size_t n = px_->size();
+  const auto px  = px_->values();
+  const auto vol = vol_->values();
+  // Last k entries of a column.
+  auto tail = [n](std::span<const double> col, std::size_t k) {
+    return col.subspan(n - std::min(k, n));
+  };
+
+  sumPx_  = simd::sum(px.data(), n);
+  sumVol_ = simd::sum(vol.data(), n);
+  sumPV_ = obv_ = 0.0;
+  volPos_ = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    sumPV_ += px[i] * vol[i];
+    if (vol[i] > 0) ++volPos_;
+    if (i > 0) obv_ += sign(px[i] - px[i - 1]) * vol[i];
+  }
+
+  for (auto& s : sma_) {
+    const auto w = tail(px, s.period);
+    s.sum = simd::sum(w.data(), w.size());
+  }
+
+  // sum (x - c)^2 is sumSqDev with c as the "mean".
+  bbShift_ = sumPx_ / static_cast<double>(n);
+  const auto bb = tail(px, bbN_);
+  bbSum_   = simd::sum(bb.data(), bb.size()) - static_cast<double>(bb.size()) * bbShift_;
+  bbSumSq_ = simd::sumSqDev(bb.data(), bb.size(), bbShift_);
+
+  const auto va = tail(vol, volP_);
+  volSum_ = simd::sum(va.data(), va.size());
+
+  rsiGain_ = rsiLoss_ = atrSum_ = 0.0;
+  for (std::size_t i = n - std::min(rsiP_, n - 1); i < n; ++i) {
+    const double d = px[i] - px[i - 1];
+    if (d > 0) rsiGain_ += d; else rsiLoss_ -= d;
+  }
+  for (std::size_t i = n - std::min(atrP_, n - 1); i < n; ++i)
+    atrSum_ += std::abs(px[i] - px[i - 1]);
+
+  for (auto& em : ema_) {
+    em.val = px[0];
+    for (std::size_t i = 1; i < n; ++i) em.val = em.a * em.val + em.k * px[i];
+  }
+
+  // sigR_ = kSig * sum_q aSig^q MU_(t-q) over the newest sig-1 values.
+  sigR_ = 0.0;
+  const std::size_t r = std::min(macdSig_ - 1, muRing_.size());
+  double w = kSig_;
+  for (std::size_t q = 0; q < r; ++q) {
+    sigR_ += w * muRing_[muRing_.size() - 1 - q];
+    w *= aSig_;
+  }
+}
+
+double IncrementalTA::median() const {
+  if (lo_.size() > hi_.size()) return *lo_.rbegin();
+  return (*lo_.rbegin() + *hi_.begin()) * 0.5;
+}
+
+void IncrementalTA::results(Results& out) const {
+  out.clear();
+  const std::size_t n = px_->size();
+  if (n == 0 || !indicators_ || !valid_) return;
+
+  const double last = price(n - 1);
+  const double mean = sumPx_ / static_cast<double>(n);
+  out.emplace_back("lastPrice", last);
+  out.emplace_back("openPrice", open());
+  out.emplace_back("highPrice", high());
+  out.emplace_back("lowPrice",  low());
+  out.emplace_back("mean",      mean);
+  out.emplace_back("median",    median());
+  if (n == 1) return;
+
+  out.emplace_back("prevClose", price(n - 2));
+  out.emplace_back("vwap", volPos_ > 0 && sumVol_ > 0.0 ? sumPV_ / sumVol_ : NaN);
+
+  for (const auto& s : sma_)
+    out.emplace_back(s.key, n >= s.period ? s.sum / static_cast<double>(s.period) : NaN);
+  for (const auto& em : ema_)
+    out.emplace_back(em.key, n >= em.period ? em.val : NaN);
+
+  if (n >= rsiP_ + 1) {
+    const double avgGain = std::max(0.0, rsiGain_) / static_cast<double>(rsiP_);
+    const double avgLoss = std::max(0.0, rsiLoss_) / static_cast<double>(rsiP_);
+    const double rs = avgGain / (avgLoss > EPSILON ? avgLoss : EPSILON);
+    out.emplace_back(rsiKey_, 100.0 - (100.0 / (1.0 + rs)));
+  }
+
+  // MACD over EMAs seeded at the window's first tick: see the header.
+  if (n >= macdSlow_) {
+    const double dF = price(0) - uHist_.front().first;
+    const double dS = price(0) - uHist_.front().second;
+    const double line = (uF_ - uS_)
+                      + std::pow(aF_, static_cast<double>(n - 1)) * dF
+                      - std::pow(aS_, static_cast<double>(n - 1)) * dS;
+    double signal = NaN;
+    if (n - std::max<std::size_t>(1, macdSlow_ - 1) >= macdSig_) {
+      const double j = static_cast<double>(n - macdSig_);
+      signal = sigR_ + aSigPow_ * muRing_.front()
+             + std::pow(aF_, j) * dF * sigCF_
+             - std::pow(aS_, j) * dS * sigCS_;
+    }
+    out.emplace_back("macd_line", line);
+    out.emplace_back("macd_signal", signal);
+    out.emplace_back("macd_histogram", line - signal);
+  } else {
+    out.emplace_back("macd_line", NaN);
+    out.emplace_back("macd_signal", 0.0);
+    out.emplace_back("macd_histogram", 0.0);
+  }
+
+  const bool haveBB = n >= bbN_;
+  double smaBB = 0.0, stddevBB = 0.0;
+  if (haveBB) {
+    const double N  = static_cast<double>(bbN_);
+    const double mu = bbSum_ / N;
+    smaBB    = bbShift_ + mu;
+    stddevBB = std::sqrt(std::max(0.0, bbSumSq_ / N - mu * mu));
+    out.emplace_back("bollinger_upper", smaBB + bbK_ * stddevBB);
+    out.emplace_back("bollinger_lower", smaBB - bbK_ * stddevBB);
+  }
+
+  if (n >= momP_ + 1) {
+    const double prevM = price(n - momP_ - 1);
+    out.emplace_back(momKey_, last - prevM);
+    out.emplace_back(rocKey_, std::abs(prevM) > EPSILON ? 100.0 * (last - prevM) / prevM : NaN);
+  }
+
+  if (n >= atrP_ + 1)
+    out.emplace_back(atrKey_, std::max(0.0, atrSum_) / static_cast<double>(atrP_));
+
+  out.emplace_back("volume", volume(n - 1));
+  if (n >= volP_)
+    out.emplace_back(volAvgKey_, volSum_ / static_cast<double>(volP_));
+
+  out.emplace_back("obv", obv_);
+
+  if (mean != 0.0 && haveBB)
+    out.emplace_back("volatility_rank", std::min(stddevBB / std::abs(mean), 1.0));
+}
+
+} // namespace gma::ta
@@ -1,9 +1,7 @@
 #include "gma/ws/WsFeedClient.hpp"
 
+#include "gma/feed/FeedRouter.hpp"
 #include "gma/feed/IFeedAdapter.hpp"
-#include "gma/Dispatcher.hpp"
-#include "gma/book/OrderBookManager.hpp"
-#include "gma/Event.hpp"
 #include "gma/util/Logger.hpp"
 #include "gma/util/Metrics.hpp"
 
@@ -315,60 +313,12 @@ void WsFeedClient::fail(beast::error_code ec, const char* where) {
 }
 
 // ---------------------------------------------------------------------------
-// Message handling — delegate to adapter, dispatch resulting events.
-// Routing: TickEvent → Dispatcher (TA computation + raw-field listeners).
-//          Ob* events → OrderBookManager (book mutations + trades).
+// Message handling — delegate to adapter, route the resulting events
+// (ticks → Dispatcher, Ob* → OrderBookManager; see routeFeedEvents).
 // ---------------------------------------------------------------------------
 void WsFeedClient::handleMessage(const std::string& text) {
   auto events = adapter_->translate(text);
-  for (auto& evt : events) {
-    dispatchEvent(evt);
-  }
-}
-
-void WsFeedClient::dispatchEvent(feed::FeedEvent& evt) {
-  std::visit([this](auto& e) {
-    using T = std::decay_t<decltype(e)>;
-
-    if constexpr (std::is_same_v<T, feed::TickEvent>) {
-      if (dispatcher_) {
-        Event tick;
-        tick.symbol  = std::move(e.symbol);
-        tick.payload = std::move(e.payload);
-        dispatcher_->onTick(tick);
-      }
-    }
-    else if constexpr (std::is_same_v<T, feed::ObAddEvent>) {
-      if (obManager_) {
-        obManager_->onAdd(e.symbol, e.orderId, e.side, e.price, e.size, e.priority);
-      }
-    }
-    else if constexpr (std::is_same_v<T, feed::ObUpdateEvent>) {
-      if (obManager_) {
-        obManager_->onUpdate(e.symbol, e.orderId, FeedScope{}, e.newPrice, e.newSize);
-      }
-    }
-    else if constexpr (std::is_same_v<T, feed::ObDeleteEvent>) {
-      if (obManager_) {
-        obManager_->onDelete(e.symbol, e.orderId, FeedScope{});
-      }
-    }
-    else if constexpr (std::is_same_v<T, feed::ObTradeEvent>) {
-      if (obManager_) {
-        obManager_->onTrade(e.symbol, e.price, e.size, e.aggressor);
-      }
-    }
-    else if constexpr (std::is_same_v<T, feed::ObTickSizeEvent>) {
-      if (obManager_) {
-        obManager_->setTickSize(e.symbol, e.tickSize);
-      }
-    }
-    else if constexpr (std::is_same_v<T, feed::ObResetEvent>) {
-      if (obManager_) {
-        obManager_->onReset(e.symbol, e.epoch);
-      }
-    }
-  }, evt);
+  feed::routeFeedEvents(events, dispatcher_, obManager_);
 }
 
 } // namespace gma::ws
@@ -30,11 +30,18 @@ public:
   void setBatch(const std::string& streamKey,
                 const std::vector<std::pair<std::string, ArgType>>& fields);
 
+  /// setBatch() for several streamKeys under one lock acquisition — e.g.
+  /// every symbol touched by one feed burst. Empty field lists are skipped.
+  using FieldBatch = std::vector<std::pair<std::string, ArgType>>;
+  void setBatches(const std::vector<std::pair<std::string, FieldBatch>>& batches);
+
   std::optional<ArgType> get(const std::string& streamKey, const std::string& field) const;
 
 private:
   using FieldMap = std::unordered_map<std::string, ArgType>;
 
+  void setBatchLocked(const std::string& streamKey, const FieldBatch& fields);
+
   mutable std::shared_mutex _mutex;
   std::unordered_map<std::string, FieldMap> _data;
   std::size_t _maxStreamKeys{0};         // 0 = unlimited
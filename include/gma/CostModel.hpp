@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <rapidjson/document.h>
+
+namespace gma::tree {
+
+// Static estimate of what one subscription tree costs the engine, computed
+// from its JSON spec before anything is built. Admission control
+// (server::AdmissionController) charges it against the global and
+// per-session budgets.
+//
+// Units are deliberately coarse: one work unit is one node handling one
+// value (a Listener hop, an AtomicStore read, a scalar reducer); sort-based
+// reducers such as median count several. Nothing here is measured — the
+// point is to rank trees and stop the pathological ones, not to predict
+// CPU time.
+struct TreeCost {
+  double        tickWork   = 0;   // work units per input tick, all instances
+  double        timerWork  = 0;   // work units per second driven by timers
+  std::uint32_t timers     = 0;   // timer nodes (one thread each on the system clock)
+  std::uint64_t stateBytes = 0;   // estimated resident state, all instances
+  std::uint32_t fanout     = 1;   // widest GroupSplit multiplier in the tree
+
+  // Work units per second at ASSUMED_TICKS_PER_SEC.
+  double cpu() const noexcept { return tickWork * ASSUMED_TICKS_PER_SEC + timerWork; }
+
+  TreeCost& operator+=(const TreeCost& o) noexcept {
+    tickWork   += o.tickWork;
+    timerWork  += o.timerWork;
+    timers     += o.timers;
+    stateBytes += o.stateBytes;
+    if (o.fanout > fanout) fanout = o.fanout;
+    return *this;
+  }
+
+  // Input tick rate assumed per subscribed stream.
+  static constexpr double ASSUMED_TICKS_PER_SEC = 100.0;
+  // Keys a GroupSplit is assumed to fan out to (its child's timers and
+  // state are charged this many times).
+  static constexpr std::uint32_t SPLIT_FANOUT_ESTIMATE = 32;
+};
+
+// Cost of one node spec, including its children (child / inputs / stages).
+// Unknown types — typically connector registrations — get a conservative
+// default. Never throws; malformed specs are costed as far as they parse.
+TreeCost estimateNodeCost(const rapidjson::Value& spec);
+
+// Cost of a whole subscribe request: the request's Listener plus its
+// "node" and "pipeline"/"stages".
+TreeCost estimateRequestCost(const rapidjson::Value& request);
+
+} // namespace gma::tree
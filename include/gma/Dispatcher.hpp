@@ -1,18 +1,20 @@
 #pragma once
 
-#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include "gma/AtomicStore.hpp"
 #include "gma/FunctionMap.hpp"
 #include "gma/Event.hpp"
+#include "gma/HistoryStore.hpp"
 #include "gma/StreamValue.hpp"
 #include "gma/engine/EventComputerRegistry.hpp"
 #include "gma/engine/IEventComputer.hpp"
@@ -25,7 +27,10 @@ namespace gma {
 /**
  * Dispatcher routes incoming events to subscribed listeners and maintains
  * per-field raw-value history so FunctionMap builtins (mean, sum, stddev, …)
- * can be recomputed on each update.
+ * can be recomputed on each update. That history lives in a HistoryStore
+ * handed to computers through ComputeContext::history, so a series a
+ * computer already keeps (MarketTickComputer's lastPrice / volume) is read
+ * from there rather than stored twice.
  *
  * Domain-specific computations live in IEventComputer implementations sourced
  * from EventComputerRegistry. The dispatcher caches per-type computer
@@ -56,6 +61,23 @@ public:
   // raw payload fields out to direct-field subscribers.
   void onTick(const Event& tick);
 
+  // Events that arrived together (one feed read / adapter message), oldest
+  // first. Runs of same-type events are cut wherever a symbol repeats;
+  // each piece goes to the computers' computeBatch in one call, then its
+  // raw payload fields fan out per event as in onTick, so listeners see
+  // the same values as from one onTick per event. Events with an empty
+  // symbol, or with neither a payload nor a decoded record, are skipped.
+  void onTickBatch(std::span<const Event> ticks);
+
+  // Whether an event of `type` for `symbol` needs its payload DOM: some
+  // listener on the symbol may take a raw field, or a computer for the
+  // type reads the payload. Ingress that decoded the event itself
+  // (Event::decoded) can skip building the DOM when this is false. `raw`,
+  // if given, is the payload's JSON text; a listened field whose quoted
+  // name does not appear in it is not counted.
+  bool wantsPayload(const std::string& symbol, const std::string& type,
+                    std::string_view raw = {});
+
   // Public hook that IEventComputer implementations call to deliver a computed
   // value to listeners subscribed on (symbol, field). Snapshot semantics — the
   // listener lock is held only while copying subscriber shared_ptrs.
@@ -63,17 +85,43 @@ public:
                        const std::string& field,
                        double value);
 
+  // Subscription observers. `fn(symbol, field, true)` runs when a field
+  // starting with `fieldPrefix` gets its first listener for a symbol, and
+  // `(…, false)` when its last listener leaves; subscriptions that already
+  // exist are replayed on registration. `accepts` (optional) tells
+  // isObserved() which fields under the prefix the observer can serve.
+  // Lets providers push values for keys no computer emits (e.g. ob.*).
+  // Callbacks run without the listener lock held, but one at a time and
+  // in the order the transitions happened; they must not register or
+  // unregister listeners themselves.
+  using SubscriptionFn = std::function<void(const std::string& symbol,
+                                            const std::string& field,
+                                            bool subscribed)>;
+  void observeSubscriptions(const std::string& fieldPrefix,
+                            SubscriptionFn fn,
+                            std::function<bool(const std::string& field)> accepts = {});
+  bool isObserved(const std::string& field) const;
+
+  // Per-symbol history shared with event computers.
+  HistoryStore&       history()       noexcept { return _history; }
+  const HistoryStore& history() const noexcept { return _history; }
+
 private:
+  // Registry-cached computers for `type`, then addComputer() ones whose
+  // eventType() matches.
+  std::vector<engine::IEventComputer*> computersFor(const std::string& type);
+
+  // Second half of onTick: raw payload fields to direct-field subscribers.
+  void fanOutRawFields(const Event& tick);
+
   void computeAndStoreAtomics(const std::string& symbol,
                               const std::string& field,
                               const std::vector<double>& history);
 
 private:
-  // Per-field history buffers per (symbol, field)
-  std::unordered_map<
-      std::string,
-      std::unordered_map<std::string, std::deque<double>>
-  > _histories;
+  // Per-(symbol, field) history. Declared before the computers so it
+  // outlives them: they keep pointers to its columns.
+  HistoryStore _history;
 
   // Listener lists per (symbol, field)
   std::unordered_map<
@@ -96,14 +144,26 @@ private:
                                           _computersByType;
   mutable std::mutex                      _computerCacheMx;
 
-  mutable std::shared_mutex _histMutex;
+  struct SubscriptionObserver {
+    std::string prefix;
+    SubscriptionFn fn;
+    std::function<bool(const std::string&)> accepts;
+  };
+  // Observers whose prefix matches `field`; caller holds _listenerMutex.
+  std::vector<SubscriptionFn> observersFor(const std::string& field) const;
+
+  // Guarded by _listenerMutex.
+  std::vector<SubscriptionObserver> _subObservers;
+
+  // Serializes listener-set changes with their observer callbacks. Taken
+  // before _listenerMutex.
+  std::mutex _observerMutex;
+
   mutable std::shared_mutex _listenerMutex;
   gma::rt::ThreadPool* _threadPool;
   AtomicStore*         _store;
   util::Config         _cfg;
   std::size_t          _maxHistory;
-  std::size_t          _maxSymbols;
-  std::size_t          _maxFieldsPerSymbol;
 };
 
 } // namespace gma
@@ -13,9 +13,14 @@ namespace gma {
 //               IEventComputer implementations. Trails the legacy fields so
 //               existing `Event{sym, payload}` positional constructions keep
 //               working and implicitly pick up the default "tick" type.
+//   decoded   : optional connector-defined record for `type`, decoded at
+//               ingress so computers need not walk the DOM (the market
+//               connector puts a TickEntry here). When set, payload may be
+//               null: it is only built if something reads raw fields.
 struct Event {
   std::string                          symbol;
   std::shared_ptr<rapidjson::Document> payload;
   std::string                          type { "tick" };
+  std::shared_ptr<const void>          decoded {};
 };
 } // namespace gma
@@ -6,17 +6,23 @@
 
 namespace gma {
 
+namespace server { class AdmissionController; }
+
 class ExecutionContext {
 public:
-  ExecutionContext(AtomicStore* store, rt::ThreadPool* pool)
-    : _store(store), _pool(pool) {}
+  // `admission` is optional; without it subscriptions are not costed.
+  ExecutionContext(AtomicStore* store, rt::ThreadPool* pool,
+                   server::AdmissionController* admission = nullptr)
+    : _store(store), _pool(pool), _admission(admission) {}
 
   AtomicStore* store() const noexcept { return _store; }
   rt::ThreadPool* pool() const noexcept { return _pool; }
+  server::AdmissionController* admission() const noexcept { return _admission; }
 
 private:
   AtomicStore*    _store = nullptr;
   rt::ThreadPool* _pool  = nullptr;
+  server::AdmissionController* _admission = nullptr;
 };
 
 } // namespace gma
@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <functional>
 #include <map>
@@ -40,6 +42,12 @@ public:
     /// Returns a snapshot of all registered plain [name->Func] pairs.
     std::vector<std::pair<std::string, Func>> getAll() const;
 
+    /// Bumped by every registration. Consumers that cache resolved
+    /// functions (tree::PlanCache) compare it to detect stale entries.
+    std::uint64_t generation() const noexcept {
+        return _generation.load(std::memory_order_acquire);
+    }
+
     /// Iterate all registered plain reducers under shared_lock without copying.
     /// Callback signature: void(const std::string& name, const Func& fn)
     template <typename Callback>
@@ -54,5 +62,6 @@ private:
     std::unordered_map<std::string, Func>      _map;
     std::unordered_map<std::string, ParamFunc> _paramMap;
     mutable std::shared_mutex _mutex;
+    std::atomic<std::uint64_t> _generation{0};
 };
 }
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace gma {
+
+// Per-symbol rolling history, one named column of doubles per series
+// ("lastPrice", "volume", ...). Shared by the Dispatcher's raw-field /
+// FunctionMap path and event computers (ComputeContext::history), so a
+// series both of them need is kept once, under one lock.
+//
+// Each symbol's Series has its own shared_mutex; the symbol table's lock
+// is only taken exclusively when a new symbol appears. Column and Series
+// addresses are stable for the store's lifetime, so callers may keep
+// pointers to them.
+//
+// A column is either raw — appended by the Dispatcher from tick payload
+// fields — or claimed by an event computer, which then is its only
+// writer (MarketTickComputer's lastPrice / volume). The Dispatcher reads
+// claimed columns instead of keeping its own copy.
+class HistoryStore {
+public:
+  class Series;
+
+  // Contiguous sliding window of T in one 64-byte aligned buffer.
+  // push_back() appends, pop_front() advances the head; when the tail
+  // reaches the end the window is moved back to the start (amortized
+  // O(1) — the buffer keeps at least a quarter of slack). The buffer grows
+  // geometrically up to maxSize plus that slack, so short series stay
+  // small. Writers enforce their own window length with pop_front().
+  //
+  // Series hold Column (double); StampColumn keeps epoch-nanosecond
+  // timestamps exactly, for writers that window them alongside.
+  template <class T>
+  class BasicColumn {
+  public:
+    // `maxSize` is the most values the writer keeps live at once.
+    explicit BasicColumn(std::size_t maxSize);
+    ~BasicColumn();
+
+    BasicColumn(BasicColumn&& other) noexcept;
+    BasicColumn& operator=(BasicColumn&& other) noexcept;
+    BasicColumn(const BasicColumn&)            = delete;
+    BasicColumn& operator=(const BasicColumn&) = delete;
+
+    void push_back(T v);
+    void pop_front() noexcept { ++head_; --size_; }
+    void clear() noexcept { head_ = 0; size_ = 0; }
+
+    std::size_t size()     const noexcept { return size_; }
+    bool        empty()    const noexcept { return size_ == 0; }
+    std::size_t capacity() const noexcept { return cap_; }
+
+    // Element i of the window, oldest first.
+    T operator[](std::size_t i) const noexcept { return data_[head_ + i]; }
+    T back()                    const noexcept { return data_[head_ + size_ - 1]; }
+
+    std::span<const T> values() const noexcept { return {data_ + head_, size_}; }
+
+    // The event computer feeding this column (Series::claim), or nullptr
+    // for a raw column.
+    const void* owner() const noexcept { return owner_; }
+
+    static constexpr std::size_t ALIGNMENT = 64;
+
+  private:
+    friend class Series;
+
+    void makeRoom();
+    void relocate(std::size_t newCap);
+
+    std::size_t limit_;          // buffer growth stops here
+    std::size_t cap_  = 0;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    T*          data_ = nullptr;
+    const void* owner_ = nullptr;
+  };
+
+  using Column      = BasicColumn<double>;
+  using StampColumn = BasicColumn<std::uint64_t>;
+
+  // One symbol's columns. Callers hold mutex() — shared to read, exclusive
+  // to create, append or claim.
+  class Series {
+  public:
+    std::shared_mutex& mutex() const noexcept { return mutex_; }
+
+    // Column `name`, or nullptr if it doesn't exist.
+    Column*       find(std::string_view name);
+    const Column* find(std::string_view name) const;
+
+    // Column `name`, created empty on first use; nullptr once the symbol
+    // has maxColumnsPerSymbol columns.
+    Column* column(std::string_view name);
+
+    // Column `name` for `owner` to feed exclusively. A raw column of that
+    // name is cleared and taken over. nullptr if another owner already
+    // claimed it or the column cap is reached.
+    Column* claim(std::string_view name, const void* owner);
+
+    // Returns a column `owner` claimed to raw (and empty).
+    void release(std::string_view name, const void* owner);
+
+  private:
+    friend class HistoryStore;
+    Series(std::size_t maxLen, std::size_t maxColumns)
+      : maxLen_(maxLen), maxColumns_(maxColumns) {}
+
+    struct Entry {
+      std::string name;
+      Column      column;
+    };
+
+    mutable std::shared_mutex mutex_;
+    std::deque<Entry>         entries_;   // few per symbol; deque keeps addresses stable
+    std::size_t               maxLen_;
+    std::size_t               maxColumns_;
+  };
+
+  // `maxLen` is the window the writers keep (Config::taHistoryMax); it
+  // only sizes column buffers. Caps of 0 are treated as 1.
+  HistoryStore(std::size_t maxLen, std::size_t maxSymbols, std::size_t maxColumnsPerSymbol);
+
+  HistoryStore(const HistoryStore&)            = delete;
+  HistoryStore& operator=(const HistoryStore&) = delete;
+
+  // The symbol's Series, created on first use; nullptr once maxSymbols
+  // symbols exist.
+  Series* series(const std::string& symbol);
+
+  // The symbol's Series, or nullptr if it was never created.
+  Series* find(const std::string& symbol) const;
+
+  std::size_t symbolCount() const;
+  std::size_t maxLen() const noexcept { return _maxLen; }
+
+private:
+  std::unordered_map<std::string, std::unique_ptr<Series>> _series;
+  mutable std::shared_mutex                                _mutex;   // guards _series
+  std::size_t                                              _maxLen;
+  std::size_t                                              _maxSymbols;
+  std::size_t                                              _maxColumns;
+};
+
+} // namespace gma
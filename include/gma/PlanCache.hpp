@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <rapidjson/document.h>
+#include "gma/TreeBuilder.hpp"
+
+namespace gma::tree {
+
+// Process-wide LRU cache of compiled subscribe requests (RequestPlan).
+//
+// Reconnect storms replay thousands of identical subscriptions; with a hit
+// the session skips the request copy, JsonValidator's walk, registry
+// lookups, function resolution and expression compilation, and goes
+// straight to buildFromPlan().
+//
+// Keyed by the request's canonical form — the plan-relevant members
+// (streamKey, field, node, pipeline, stages) serialized compactly with
+// object members sorted by name — so clients that order members
+// differently share an entry. The key is compared in full, so a hash
+// collision can never return another request's plan.
+//
+// Plans hold resolved node builders and functions, so the cache drops
+// everything whenever NodeTypeRegistry or FunctionMap changes.
+//
+// Metrics: plan_cache.hit / .miss / .evict counters and plan_cache.size /
+// .hit_rate gauges.
+class PlanCache {
+public:
+  static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+  struct Stats {
+    std::uint64_t hits      = 0;
+    std::uint64_t misses    = 0;
+    std::uint64_t evictions = 0;
+    std::size_t   size      = 0;
+  };
+
+  static PlanCache& instance();
+
+  explicit PlanCache(std::size_t capacity = DEFAULT_CAPACITY);
+
+  PlanCache(const PlanCache&)            = delete;
+  PlanCache& operator=(const PlanCache&) = delete;
+
+  // Writes the canonical key of `request` into `out` (replacing its
+  // contents; pass the same string across calls to reuse its buffer).
+  static void canonicalKey(const rapidjson::Value& request, std::string& out);
+
+  // Null on miss. Counts the lookup.
+  std::shared_ptr<const RequestPlan> find(const std::string& key);
+
+  // Stores `plan` under `key` (most recently used), evicting the least
+  // recently used entry when full. Returns `plan`.
+  std::shared_ptr<const RequestPlan> insert(const std::string& key,
+                                            std::shared_ptr<const RequestPlan> plan);
+
+  void  clear();
+  Stats stats() const;
+
+private:
+  using Lru = std::list<std::pair<std::string, std::shared_ptr<const RequestPlan>>>;
+
+  void dropIfStaleLocked();
+  void publishLocked();
+
+  const std::size_t capacity_;
+
+  mutable std::mutex                               mx_;
+  Lru                                              lru_;   // front = most recent
+  std::unordered_map<std::string, Lru::iterator>   index_;
+  std::uint64_t                                    nodeGen_{0};
+  std::uint64_t                                    fnGen_{0};
+  Stats                                            stats_;
+};
+
+} // namespace gma::tree
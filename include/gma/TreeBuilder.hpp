@@ -5,9 +5,12 @@
 #include <string>
 #include <vector>
 
+#include "gma/CostModel.hpp"
 #include "gma/Span.hpp"
 #include "gma/StreamValue.hpp"
 #include "gma/nodes/INode.hpp"
+#include "gma/rt/Clock.hpp"
+#include "gma/rt/CreditGate.hpp"
 #include "gma/rt/ThreadPool.hpp"
 #include <rapidjson/document.h>
 
@@ -24,6 +27,8 @@ namespace tree {
     AtomicStore*      store      { nullptr };   // for AtomicAccessor
     rt::ThreadPool*       pool       { nullptr };   // for Listener queues
     Dispatcher* dispatcher { nullptr };   // for Listener wiring
+    std::shared_ptr<rt::CreditGate> credit;   // optional; shared by every Listener of a subscription
+    rt::Clock*        clock      { nullptr };   // timer nodes; nullptr = system clock
   };
 
   // Result of buildForRequest – head plus the downstream chain.
@@ -33,6 +38,26 @@ namespace tree {
     std::vector<std::shared_ptr<INode>> keepAlive;
   };
 
+  // A compiled node spec: everything parsed, validated and resolved; calling
+  // it only constructs (and starts) nodes. See
+  // engine::NodeTypeRegistry::registerNodeCompiler.
+  using NodeFactory = std::function<std::shared_ptr<INode>(
+    const std::string&     defaultStreamKey,
+    const Deps&            deps,
+    std::shared_ptr<INode> downstream)>;
+
+  // A subscribe request compiled once. Owns no JSON — every factory holds
+  // its parsed parameters — so one plan can be instantiated by any number
+  // of sessions concurrently.
+  struct RequestPlan {
+    std::string              streamKey;
+    std::string              field;
+    NodeFactory              node;          // "node", if present
+    std::vector<NodeFactory> pipeline;      // "pipeline" / "stages", head first
+    bool                     hasPipeline{false};
+    TreeCost                 cost;          // static estimate, for admission control
+  };
+
   // Convenience alias for Worker functions
   using Fn = std::function<ArgType(Span<const ArgType>)>;
 
@@ -82,5 +107,22 @@ namespace tree {
     std::shared_ptr<INode>  terminal
   );
 
+  // ---- Two-phase form (what buildForRequest is made of) ----
+
+  // Compile one node spec. Types registered with only a builder get a
+  // factory that replays the builder against a private copy of the spec.
+  NodeFactory compileOne(const rapidjson::Value& spec);
+
+  // Compile the plan-relevant members of a request (streamKey, field,
+  // node, pipeline/stages). Throws on the same errors buildForRequest
+  // would, except those that depend on Deps.
+  std::shared_ptr<const RequestPlan> compileRequest(const rapidjson::Value& requestJson);
+
+  BuiltChain buildFromPlan(
+    const RequestPlan&      plan,
+    const Deps&             deps,
+    std::shared_ptr<INode>  terminal
+  );
+
 } // namespace tree
 } // namespace gma
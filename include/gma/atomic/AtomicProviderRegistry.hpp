@@ -11,6 +11,10 @@ namespace gma {
 class AtomicProviderRegistry {
 public:
   using ProviderFn = std::function<double(const std::string& symbol, const std::string& fullKey)>;
+  // A key parsed once into a plan; called per read with the symbol only.
+  using CompiledFn = std::function<double(const std::string& symbol)>;
+  // Returns an empty CompiledFn when the key cannot be compiled.
+  using CompilerFn = std::function<CompiledFn(const std::string& fullKey)>;
 
   // Tag instance — registry methods are static, so this is purely a handle for
   // EngineRegistries to expose alongside the per-instance singletons.
@@ -25,9 +29,16 @@ public:
     map()[ns] = std::move(fn);
   }
 
+  // Optional: let a namespace compile keys ahead of time (see compile()).
+  static void registerCompiler(const std::string& ns, CompilerFn fn) {
+    std::lock_guard<std::mutex> lk(mx());
+    compilers()[ns] = std::move(fn);
+  }
+
   // Remove a namespace; returns true if something was erased
   static bool unregisterNamespace(const std::string& ns) {
     std::lock_guard<std::mutex> lk(mx());
+    compilers().erase(ns);
     return map().erase(ns) > 0;
   }
 
@@ -35,6 +46,27 @@ public:
   static void clear() {
     std::lock_guard<std::mutex> lk(mx());
     map().clear();
+    compilers().clear();
+  }
+
+  // Compile "<ns>.<rest>" with the namespace's compiler. Empty if the
+  // namespace has no compiler or rejects the key; callers then fall back
+  // to tryResolve().
+  static CompiledFn compile(const std::string& key) {
+    auto dot = key.find('.');
+    if (dot == std::string::npos) return {};
+    CompilerFn fn;
+    {
+      std::lock_guard<std::mutex> lk(mx());
+      auto it = compilers().find(key.substr(0, dot));
+      if (it == compilers().end()) return {};
+      fn = it->second;
+    }
+    try {
+      return fn(key);
+    } catch (...) {
+      return {};
+    }
   }
 
   // Try to resolve and evaluate a key of the form "<ns>.<rest>"
@@ -65,6 +97,10 @@ private:
     static std::unordered_map<std::string, ProviderFn> instance;
     return instance;
   }
+  static std::unordered_map<std::string, CompilerFn>& compilers() {
+    static std::unordered_map<std::string, CompilerFn> instance;
+    return instance;
+  }
   static std::mutex& mx() {
     static std::mutex m;
     return m;
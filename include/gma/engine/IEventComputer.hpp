@@ -1,10 +1,13 @@
 #pragma once
+#include <span>
 #include <string_view>
 
+#include "gma/Event.hpp"
+
 namespace gma {
-struct Event;         // gma/Event.hpp
 class AtomicStore;    // gma/AtomicStore.hpp
 class Dispatcher;     // gma/Dispatcher.hpp
+class HistoryStore;   // gma/HistoryStore.hpp
 namespace rt { class ThreadPool; }
 }
 
@@ -16,6 +19,7 @@ struct ComputeContext {
   AtomicStore*    store      { nullptr };
   Dispatcher*     dispatcher { nullptr };
   rt::ThreadPool* pool       { nullptr };
+  HistoryStore*   history    { nullptr };   // per-symbol series shared with the dispatcher
 };
 
 // Computers materialize derived values (TA, aggregates, etc.) from an inbound Event.
@@ -28,6 +32,21 @@ public:
   virtual std::string_view eventType() const = 0;
 
   virtual void compute(const Event& e, ComputeContext& ctx) = 0;
+
+  // Whether compute() reads Event::payload. Computers that work from the
+  // ingress-decoded record alone (Event::decoded) return false, so
+  // Dispatcher::wantsPayload() lets ingress skip building the DOM.
+  virtual bool readsPayload() const { return true; }
+
+  // A run of events of this computer's type that arrived together (one
+  // feed read, one adapter message), oldest first. The default computes
+  // them one by one. Overrides may amortize work across the run (locks,
+  // lookups, store writes), but each symbol must see the same writes and
+  // notifications, in the same order, as computing its events one at a
+  // time.
+  virtual void computeBatch(std::span<const Event> events, ComputeContext& ctx) {
+    for (const auto& e : events) compute(e, ctx);
+  }
 };
 
 } // namespace gma::engine
@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -20,6 +22,15 @@ using NodeBuilderFn = std::function<std::shared_ptr<INode>(
     const tree::Deps&       deps,
     std::shared_ptr<INode>  downstream)>;
 
+// Build-once form. A compiler parses and validates a spec and resolves
+// everything it names (functions, sub-specs, expressions) up front, and
+// returns a factory that only constructs nodes. TreeBuilder caches the
+// factories of a whole request (see tree::RequestPlan) so repeated
+// identical subscriptions skip the JSON entirely.
+using NodeFactoryFn = tree::NodeFactory;
+
+using NodeCompilerFn = std::function<NodeFactoryFn(const rapidjson::Value& spec)>;
+
 class NodeTypeRegistry {
 public:
   // Tag instance — see EventTypeRegistry::singleton() for rationale.
@@ -31,9 +42,35 @@ public:
   static bool registerNodeType(std::string name, NodeBuilderFn fn) {
     std::lock_guard lk(mx());
     auto [it, ok] = map().emplace(std::move(name), std::move(fn));
+    if (ok) bump();
     return ok;
   }
 
+  // Registers `fn` as the type's compiler and, derived from it, the
+  // one-shot builder find() returns — so both paths share one
+  // implementation. False (and nothing registered) if `name` is taken.
+  static bool registerNodeCompiler(std::string name, NodeCompilerFn fn) {
+    std::lock_guard lk(mx());
+    if (map().count(name)) return false;
+    map().emplace(name, [fn](const rapidjson::Value& spec,
+                             const std::string& defaultStreamKey,
+                             const tree::Deps& deps,
+                             std::shared_ptr<INode> downstream) {
+      return fn(spec)(defaultStreamKey, deps, std::move(downstream));
+    });
+    compilers().emplace(std::move(name), std::move(fn));
+    bump();
+    return true;
+  }
+
+  // Null for builder-only types (e.g. connector registrations that predate
+  // compilers); TreeBuilder falls back to the builder for those.
+  static const NodeCompilerFn* findCompiler(std::string_view name) {
+    std::lock_guard lk(mx());
+    auto it = compilers().find(std::string(name));
+    return it == compilers().end() ? nullptr : &it->second;
+  }
+
   static const NodeBuilderFn* find(std::string_view name) {
     std::lock_guard lk(mx());
     auto it = map().find(std::string(name));
@@ -56,6 +93,14 @@ public:
   static void clear() {
     std::lock_guard lk(mx());
     map().clear();
+    compilers().clear();
+    bump();
+  }
+
+  // Bumped on every successful registration and on clear(); see
+  // tree::PlanCache.
+  static std::uint64_t generation() noexcept {
+    return gen().load(std::memory_order_acquire);
   }
 
 private:
@@ -63,6 +108,15 @@ private:
     static std::unordered_map<std::string, NodeBuilderFn> m;
     return m;
   }
+  static std::unordered_map<std::string, NodeCompilerFn>& compilers() {
+    static std::unordered_map<std::string, NodeCompilerFn> m;
+    return m;
+  }
+  static std::atomic<std::uint64_t>& gen() {
+    static std::atomic<std::uint64_t> g{0};
+    return g;
+  }
+  static void bump() { gen().fetch_add(1, std::memory_order_acq_rel); }
   static std::mutex& mx() {
     static std::mutex m;
     return m;
@@ -12,4 +12,5 @@
 #include "gma/engine/EventComputerRegistry.hpp"
 #include "gma/engine/NodeTypeRegistry.hpp"
 #include "gma/engine/IngressRegistry.hpp"
+#include "gma/engine/StreamRegistry.hpp"
 #include "gma/engine/ConfigNamespaceRegistry.hpp"
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "gma/CostModel.hpp"
+
+namespace gma::engine {
+
+// Per-client outbound stream served by a connector directly (e.g. a
+// binary depth ladder) instead of by a node tree. The session owns it:
+// start() once the subscription is acknowledged, stop() on cancel /
+// replace / close. cost() is what the session charges to admission
+// control, in the units of tree::TreeCost, like a subscription tree.
+class IStream {
+public:
+  virtual ~IStream() = default;
+  virtual void start() = 0;
+  virtual void stop() noexcept = 0;
+  virtual tree::TreeCost cost() const { return {}; }
+};
+
+// Request parameters of one stream subscription, stringified, e.g.
+// {"levels":"10", "flushMs":"50"} for
+// {"stream":"depth", "streamKey":"AAPL", "levels":10, "flushMs":50}.
+using StreamParams = std::unordered_map<std::string, std::string>;
+
+// Hands one encoded binary frame to the client. Returns false when the
+// client cannot take it right now; the stream keeps its change pending
+// and tries again later instead of dropping state.
+using StreamSink = std::function<bool(std::string frame)>;
+
+// Factory wired up at connector-registration time; invoked once per
+// client subscription of this kind. `streamId` is unique within the
+// session and is meant to tag every frame of the stream. Throws
+// std::runtime_error on invalid parameters.
+using StreamFactory = std::function<std::unique_ptr<IStream>(
+    const std::string& symbol,
+    std::uint32_t streamId,
+    const StreamParams& params,
+    StreamSink sink)>;
+
+class StreamRegistry {
+public:
+  // Tag instance — see EventTypeRegistry::singleton() for rationale.
+  static StreamRegistry& singleton() {
+    static StreamRegistry s;
+    return s;
+  }
+
+  static bool registerStream(std::string kind, StreamFactory fn) {
+    std::lock_guard lk(mx());
+    auto [it, ok] = map().emplace(std::move(kind), std::move(fn));
+    return ok;
+  }
+
+  // Copy, so a caller may invoke it without holding the registry lock.
+  static StreamFactory find(std::string_view kind) {
+    std::lock_guard lk(mx());
+    auto it = map().find(std::string(kind));
+    return it == map().end() ? StreamFactory{} : it->second;
+  }
+
+  static bool contains(std::string_view kind) {
+    std::lock_guard lk(mx());
+    return map().count(std::string(kind)) > 0;
+  }
+
+  static std::vector<std::string> kinds() {
+    std::lock_guard lk(mx());
+    std::vector<std::string> out;
+    out.reserve(map().size());
+    for (auto& kv : map()) out.push_back(kv.first);
+    return out;
+  }
+
+  static bool unregisterStream(std::string_view kind) {
+    std::lock_guard lk(mx());
+    return map().erase(std::string(kind)) > 0;
+  }
+
+  static void clear() {
+    std::lock_guard lk(mx());
+    map().clear();
+  }
+
+private:
+  static std::unordered_map<std::string, StreamFactory>& map() {
+    static std::unordered_map<std::string, StreamFactory> m;
+    return m;
+  }
+  static std::mutex& mx() {
+    static std::mutex m;
+    return m;
+  }
+};
+
+} // namespace gma::engine
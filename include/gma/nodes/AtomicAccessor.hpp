@@ -5,6 +5,7 @@
 #include <string>
 #include "gma/nodes/INode.hpp"
 #include "gma/AtomicStore.hpp"
+#include "gma/atomic/AtomicProviderRegistry.hpp"
 
 namespace gma {
 
@@ -22,6 +23,7 @@ private:
   std::string symbol_;
   std::string field_;
   AtomicStore* store_;
+  AtomicProviderRegistry::CompiledFn plan_;   // empty: resolve by key per read
 
   std::atomic<bool> stopping_{false};
   mutable std::mutex mx_;
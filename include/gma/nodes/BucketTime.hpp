@@ -2,10 +2,12 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include "gma/nodes/INode.hpp"
+#include "gma/rt/Clock.hpp"
 #include "gma/rt/ThreadPool.hpp"
 
 namespace gma {
@@ -30,12 +32,17 @@ namespace gma {
 // Interval (see Interval.hpp). shutdown() is synchronous; the timer
 // thread is joined (or detached safely if shutdown is called from the
 // timer thread itself).
+//
+// Boundaries are computed from the injected rt::Clock. Under a simulated
+// clock there is no timer thread; each boundary is a timer on that clock,
+// so a replay emits exactly one tick per boundary crossed.
 class BucketTime final : public INode,
                          public std::enable_shared_from_this<BucketTime> {
 public:
   BucketTime(std::chrono::milliseconds period,
              std::shared_ptr<INode> child,
-             gma::rt::ThreadPool* pool);
+             gma::rt::ThreadPool* pool,
+             gma::rt::Clock* clock = nullptr);
 
   ~BucketTime();
 
@@ -55,10 +62,14 @@ public:
 
 private:
   void timerLoop();
+  void tick();
+  void armSimulated();
 
   const std::chrono::milliseconds period_;
   std::shared_ptr<INode> child_;
   gma::rt::ThreadPool* pool_;
+  gma::rt::Clock* clock_;
+  std::atomic<std::uint64_t> simTimer_{0};
 
   std::atomic<bool> stopping_{false};
   std::atomic<bool> started_{false};
@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "gma/nodes/INode.hpp"
+#include "gma/rt/Clock.hpp"
+#include "gma/util/ExprProgram.hpp"
+
+namespace gma {
+
+// Multi-input join: N upstream branches (Listener, AtomicAccessor, or any
+// sub-tree) each feed one named slot; a compiled ExprProgram over the slots
+// produces one scalar downstream under `streamKey`.
+//
+// Inputs come in two flavours:
+//  - push inputs (Listener heads) deliver on their own and may trigger an
+//    evaluation;
+//  - pull inputs (everything else, e.g. AtomicAccessor) are refreshed when
+//    the Expr node itself receives a value from its upstream pipeline, then
+//    evaluated once for that tick.
+//
+// Join modes:
+//  - Latest:  evaluate on every trigger once every slot has seen a value,
+//             using each slot's most recent value.
+//  - Aligned: evaluate only when every slot has a value newer than the
+//             previous emit and all arrivals lie within `tolerance` of each
+//             other (0 = no time bound, a pure barrier). Slots that fall
+//             outside the tolerance are discarded and must refresh.
+//             Arrival times are read from `clock` (the system clock when
+//             null), so a replay on a SimulatedClock aligns on recorded
+//             time.
+//
+// Slot storage and the evaluation stack are sized at construction; the
+// per-tick path allocates only the emitted StreamValue. Thread-safe —
+// inputs may deliver concurrently from pool threads.
+class Expr final : public INode, public std::enable_shared_from_this<Expr> {
+public:
+  enum class JoinMode { Latest, Aligned };
+
+  static constexpr std::size_t MAX_INPUTS = 16;
+
+  Expr(std::string streamKey,
+       util::ExprProgram program,
+       std::size_t slotCount,
+       JoinMode mode,
+       std::chrono::milliseconds tolerance,
+       std::shared_ptr<INode> downstream,
+       gma::rt::Clock* clock = nullptr);
+
+  // Node to wire as the downstream of input `slot`'s head. The returned sink
+  // is owned by this Expr (it holds only a weak_ptr back), so Listener heads
+  // that keep a weak_ptr to their downstream stay connected. Requires the
+  // Expr to be owned by a shared_ptr.
+  std::shared_ptr<INode> inputSink(std::size_t slot, bool pull);
+
+  // Register the built head of input `slot` so the Expr can refresh it (pull
+  // inputs) and shut it down with the node.
+  void attachInput(std::size_t slot, std::shared_ptr<INode> head);
+
+  // Clock from the upstream pipeline: refresh pull inputs, then evaluate.
+  void onValue(const StreamValue& sv) override;
+  void shutdown() noexcept override;
+
+  // Delivery from an input sink. `trigger` is false for pull inputs, whose
+  // refresh is followed by a single evaluation in onValue().
+  void onInput(std::size_t slot, const StreamValue& sv, bool trigger);
+
+private:
+  class Sink;
+
+  struct Slot {
+    gma::rt::Clock::time_point at{};
+    bool              seen{false};
+    bool              fresh{false};
+    bool              pull{false};
+    std::shared_ptr<INode> head;
+    std::shared_ptr<INode> sink;
+  };
+
+  // Caller holds mx_. Returns true and sets `out` if the join condition is
+  // met and the result is finite.
+  bool evaluateLocked(double& out);
+  void emit(double v);
+
+  const std::string               streamKey_;
+  const util::ExprProgram         program_;
+  const JoinMode                  mode_;
+  const std::chrono::milliseconds tolerance_;
+  gma::rt::Clock*                 clock_;
+
+  std::atomic<bool> stopping_{false};
+  mutable std::mutex mx_;
+  std::vector<Slot>   slots_;
+  std::vector<double> values_;   // slot values, contiguous for eval()
+  std::vector<double> stack_;
+  std::shared_ptr<INode> downstream_;
+};
+
+} // namespace gma
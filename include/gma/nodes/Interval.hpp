@@ -2,10 +2,12 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include "gma/nodes/INode.hpp"
+#include "gma/rt/Clock.hpp"
 #include "gma/rt/ThreadPool.hpp"
 
 namespace gma {
@@ -13,12 +15,17 @@ namespace gma {
 // Periodic tick source. Spawns a dedicated timer thread that sleeps for
 // `period` between ticks and posts each tick to the thread pool.
 // shutdown() is synchronous — the timer thread is joined before returning.
+//
+// With a simulated clock (see rt/Clock.hpp) no thread is spawned: each tick
+// is a timer on that clock, re-armed `period` after the previous one, and
+// fires when the replay advances time past it.
 class Interval final : public INode,
                        public std::enable_shared_from_this<Interval> {
 public:
   Interval(std::chrono::milliseconds period,
            std::shared_ptr<INode> child,
-           gma::rt::ThreadPool* pool);
+           gma::rt::ThreadPool* pool,
+           gma::rt::Clock* clock = nullptr);
 
   ~Interval();
 
@@ -30,10 +37,14 @@ public:
 
 private:
   void timerLoop();
+  void tick();
+  void armSimulated();
 
   const std::chrono::milliseconds period_;
   std::shared_ptr<INode> child_;
   gma::rt::ThreadPool* pool_;
+  gma::rt::Clock* clock_;
+  std::atomic<std::uint64_t> simTimer_{0};
 
   std::atomic<bool> stopping_{false};
   std::atomic<bool> started_{false};
@@ -3,10 +3,12 @@
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 
 #include "gma/Result.hpp"
 #include "gma/nodes/INode.hpp"
+#include "gma/rt/CreditGate.hpp"
 #include "gma/rt/ThreadPool.hpp"
 
 namespace gma {
@@ -37,13 +39,20 @@ public:
       std::string field,
       std::shared_ptr<INode> downstream,
       gma::rt::ThreadPool* pool,
-      gma::Dispatcher* dispatcher);
+      gma::Dispatcher* dispatcher,
+      std::shared_ptr<gma::rt::CreditGate> credit = nullptr);
 
+  // `credit` (optional) is the subscription's CreditGate. Each value posted
+  // downstream holds one credit until its pool task returns; while the
+  // window is exhausted, values are conflated (latest kept, delivered when
+  // credit returns) or dropped, per the gate's Overflow policy, and no
+  // downstream computation runs for them.
   Listener(std::string symbol,
            std::string field,
            std::shared_ptr<INode> downstream,
            gma::rt::ThreadPool* pool,
-           gma::Dispatcher* dispatcher);
+           gma::Dispatcher* dispatcher,
+           std::shared_ptr<gma::rt::CreditGate> credit = nullptr);
 
   // IMPORTANT:
   // Do NOT register with Dispatcher from the constructor.
@@ -59,6 +68,11 @@ public:
   const std::string& field()  const noexcept { return field_;  }
 
 private:
+  void deliver(std::shared_ptr<INode> down, const StreamValue& sv);
+  void flushPending();
+  // An inline pool runs the task inside post(), so it counts as synchronous.
+  bool postsAsync() const noexcept { return pool_ && !pool_->isInline(); }
+
   std::string symbol_;
   std::string field_;
 
@@ -67,6 +81,10 @@ private:
   gma::rt::ThreadPool* pool_;          // canonical type
   gma::Dispatcher* dispatcher_;
 
+  std::shared_ptr<gma::rt::CreditGate> credit_;
+  std::mutex pendingMx_;
+  std::optional<StreamValue> pending_;   // conflated value awaiting credit
+
   std::atomic<bool> started_{false};
   std::atomic<bool> stopping_{false};
 };
@@ -2,6 +2,7 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -9,6 +10,7 @@
 #include <unordered_map>
 #include <vector>
 #include "gma/nodes/INode.hpp"
+#include "gma/rt/Clock.hpp"
 #include "gma/rt/ThreadPool.hpp"
 
 namespace gma {
@@ -34,7 +36,9 @@ namespace gma {
 // (see BucketTime.hpp). `start()` must be called after construction when
 // owned by a `shared_ptr`; `shutdown()` is synchronous; the timer thread
 // is joined (or detached safely if shutdown is called from the timer
-// thread itself).
+// thread itself). Under a simulated rt::Clock the boundaries are timers on
+// that clock instead (same arrangement as BucketTime), so replayed values
+// land in the bucket their recorded timestamps belong to.
 //
 // Per-symbol buffer growth is capped by `MAX_SYMBOLS` (matches Worker's
 // constant) to refuse unbounded map growth from pathological inputs.
@@ -43,7 +47,8 @@ class TumblingWindow final : public INode,
 public:
   TumblingWindow(std::chrono::milliseconds period,
                  std::shared_ptr<INode> downstream,
-                 gma::rt::ThreadPool* pool);
+                 gma::rt::ThreadPool* pool,
+                 gma::rt::Clock* clock = nullptr);
 
   ~TumblingWindow();
 
@@ -55,12 +60,16 @@ public:
 
 private:
   void timerLoop();
+  void flush();
+  void armSimulated();
 
   static constexpr std::size_t MAX_SYMBOLS = 10000;
 
   const std::chrono::milliseconds period_;
   std::shared_ptr<INode> downstream_;
   gma::rt::ThreadPool* pool_;
+  gma::rt::Clock* clock_;
+  std::atomic<std::uint64_t> simTimer_{0};
 
   std::atomic<bool> stopping_{false};
   std::atomic<bool> started_{false};
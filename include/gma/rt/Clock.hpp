@@ -0,0 +1,80 @@
+// File: include/gma/rt/Clock.hpp
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace gma::rt {
+
+class SimulatedClock;
+
+// Engine time source. Timer nodes (Interval, BucketTime, TumblingWindow)
+// read "now" through this instead of std::chrono::system_clock so a replay
+// can drive them from recorded event timestamps.
+//
+// The real clock is the default everywhere; a node handed a clock whose
+// simulated() is non-null stops spawning a timer thread and schedules its
+// ticks on that clock instead.
+class Clock {
+public:
+  using time_point = std::chrono::system_clock::time_point;
+
+  virtual ~Clock() = default;
+
+  virtual time_point now() const noexcept = 0;
+
+  // Non-null when timers must be scheduled on this clock rather than slept.
+  virtual SimulatedClock* simulated() noexcept { return nullptr; }
+};
+
+// Process-wide wall clock.
+Clock& systemClock() noexcept;
+
+// Clock that only moves when told to. Timers are callbacks keyed by due
+// time; advanceTo() fires every timer due on the way, on the calling
+// thread, in (due, schedule order) — so the same input always produces the
+// same firing sequence. While a callback runs, now() reports its due time.
+//
+// Time never moves backwards: advanceTo() with an earlier instant is a
+// no-op, which keeps out-of-order recorded events harmless.
+class SimulatedClock final : public Clock {
+public:
+  using TimerId = std::uint64_t;
+
+  explicit SimulatedClock(time_point start = time_point{});
+
+  SimulatedClock(const SimulatedClock&)            = delete;
+  SimulatedClock& operator=(const SimulatedClock&) = delete;
+
+  time_point now() const noexcept override;
+  SimulatedClock* simulated() noexcept override { return this; }
+
+  // Callbacks may schedule or cancel timers (including re-arming
+  // themselves); a timer scheduled inside the current advance window fires
+  // in the same advanceTo() call.
+  TimerId schedule(time_point at, std::function<void()> fn);
+  void cancel(TimerId id) noexcept;
+
+  // Returns the number of timers fired.
+  std::size_t advanceTo(time_point t);
+  std::size_t advanceBy(std::chrono::milliseconds d) { return advanceTo(now() + d); }
+
+  std::size_t pending() const;
+
+private:
+  using Key = std::pair<time_point, TimerId>;
+
+  mutable std::mutex                     mx_;
+  time_point                             now_;
+  TimerId                                nextId_{1};
+  std::map<Key, std::function<void()>>   timers_;
+  std::unordered_map<TimerId, time_point> due_;   // id -> due, for cancel()
+};
+
+} // namespace gma::rt
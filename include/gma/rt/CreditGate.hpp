@@ -0,0 +1,61 @@
+// File: include/gma/rt/CreditGate.hpp
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace gma::rt {
+
+// Per-subscription credit window. Counts work that is in flight between a
+// subscription's source Listeners and the client socket — pool tasks not
+// yet run plus rendered frames not yet written — and lets sources hold back
+// once `window` units are outstanding.
+//
+//   Listener   tryAcquire() before posting; release() when the task returns
+//   Responder  acquire() per frame handed to the session
+//   Session    release() once that frame has been written (or discarded)
+//
+// When a release brings the count back under the window, every registered
+// replenish callback runs (on the releasing thread, outside the gate's
+// lock) so conflating sources can flush their latest value.
+class CreditGate {
+public:
+  enum class Overflow { Conflate, Drop };
+
+  explicit CreditGate(std::size_t window, Overflow overflow = Overflow::Conflate);
+
+  CreditGate(const CreditGate&)            = delete;
+  CreditGate& operator=(const CreditGate&) = delete;
+
+  // Take one credit if the window has room.
+  bool tryAcquire() noexcept;
+
+  // Take one credit unconditionally (frames already computed are never
+  // discarded here — the session's own outbox cap still applies).
+  void acquire() noexcept;
+
+  void release(std::size_t n = 1);
+
+  void onReplenish(std::function<void()> fn);
+
+  std::size_t window()   const noexcept { return window_; }
+  Overflow    overflow() const noexcept { return overflow_; }
+  std::size_t inFlight() const noexcept {
+    const auto v = inFlight_.load(std::memory_order_acquire);
+    return v > 0 ? static_cast<std::size_t>(v) : 0;
+  }
+  bool exhausted() const noexcept { return inFlight() >= window_; }
+
+private:
+  const std::size_t window_;
+  const Overflow    overflow_;
+  std::atomic<long> inFlight_{0};
+
+  std::mutex                         cbMx_;
+  std::vector<std::function<void()>> callbacks_;
+};
+
+} // namespace gma::rt
@@ -0,0 +1,68 @@
+// File: include/gma/rt/ReplayDriver.hpp
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+
+#include "gma/rt/Clock.hpp"
+
+namespace gma {
+class Dispatcher;
+struct Event;
+}
+
+namespace gma::rt {
+
+// Deterministic replay of a recorded event stream.
+//
+// Feeds a Dispatcher from timestamped events on the calling thread. Before
+// each event the SimulatedClock is advanced to the event's timestamp, so
+// every timer due by then (Interval ticks, BucketTime / TumblingWindow
+// boundaries) fires first, in a fixed order. Combined with an inline
+// ThreadPool (ThreadPool::Inline) for the Dispatcher and the trees, and
+// tree::Deps::clock pointing at the same clock, the run has no wall-time
+// dependency: output is a function of the recording alone and a day of data
+// processes as fast as the CPU allows.
+class ReplayDriver {
+public:
+  struct Stats {
+    std::size_t events   = 0;   // dispatched
+    std::size_t rejected = 0;   // malformed lines (replayJsonl only)
+    std::size_t timers   = 0;   // timer callbacks fired
+  };
+
+  ReplayDriver(Dispatcher& dispatcher, SimulatedClock& clock);
+
+  ReplayDriver(const ReplayDriver&)            = delete;
+  ReplayDriver& operator=(const ReplayDriver&) = delete;
+
+  // Advance to `ts`, then dispatch. A `ts` earlier than the clock (an
+  // out-of-order record) dispatches at the current time.
+  void feed(Clock::time_point ts, const Event& ev);
+
+  // One recorded Dispatcher event per line: a JSON object carrying "ts"
+  // (epoch milliseconds), "symbol" and the payload fields; "type" selects
+  // the event type (default "tick"). "ts" is stripped before dispatch so
+  // computers see the payload they saw live. Blank lines are skipped,
+  // malformed ones counted. Returns the events dispatched from `in`.
+  std::size_t replayJsonl(std::istream& in);
+
+  // Timestamp of the first well-formed record in `in`, which is then
+  // rewound to where it was. A replay starts its SimulatedClock there, so
+  // timers built before the first event do not fire from the epoch on.
+  static std::optional<Clock::time_point> firstTimestamp(std::istream& in);
+
+  // Fire the timers still due up to `until` — typically the session end,
+  // so the last partial bucket is flushed.
+  void finish(Clock::time_point until);
+
+  const Stats& stats() const noexcept { return stats_; }
+
+private:
+  Dispatcher&     dispatcher_;
+  SimulatedClock& clock_;
+  Stats           stats_;
+};
+
+} // namespace gma::rt
@@ -14,7 +14,14 @@ namespace gma::rt {
 
 class ThreadPool {
 public:
+  // Tag for a pool with no workers: post() runs tasks on the posting thread
+  // in FIFO order (a task posted from inside a running task is queued and
+  // runs after it returns). Used by replay so execution is deterministic.
+  struct InlineTag {};
+  static constexpr InlineTag Inline{};
+
   explicit ThreadPool(unsigned nThreads = std::thread::hardware_concurrency());
+  explicit ThreadPool(InlineTag);
   ~ThreadPool();
 
   ThreadPool(const ThreadPool&)            = delete;
@@ -32,8 +39,12 @@ public:
   // Safe to call multiple times. Destructor is a no-op after shutdown().
   void shutdown();
 
+  bool isInline() const noexcept { return inline_; }
+
 private:
   void workerLoop();
+  void runInline();
+  static void runTask(std::function<void()>& fn);
 
 private:
   std::vector<std::thread>           threads_;
@@ -43,6 +54,8 @@ private:
   std::queue<std::function<void()>> q_;
   std::atomic<bool>                 stopping_{false};
   std::atomic<int>                  inFlight_{0};
+  const bool                        inline_{false};
+  bool                              inlineRunning_{false}; // guarded by mx_
 };
 
 } // namespace gma::rt
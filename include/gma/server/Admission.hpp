@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "gma/CostModel.hpp"
+
+namespace gma::server {
+
+// Subscribe-time admission control against static tree costs
+// (tree::TreeCost).
+//
+// Two budgets, each with CPU (work units/s), memory (state bytes) and
+// timer limits; zero means unlimited:
+//   - global:      summed over every admitted subscription in the process;
+//   - per session: summed over one ClientSession's subscriptions.
+//
+// A tree that fits is admitted as is. A tree that only breaks a CPU limit
+// is admitted downgraded when its conflated cost fits: the session gives it
+// a credit window of one, so its Listeners conflate instead of queueing
+// every tick, and it is charged DOWNGRADE_CPU_FACTOR of its CPU. Anything
+// else — memory or timers over budget, or still too expensive conflated —
+// is rejected.
+//
+// Every admit must be paired with release() of the returned charge (on
+// cancel, replace and session close), and a closing session must call
+// forget() after its releases: CPU is a double, so a session's usage
+// rarely returns to exactly zero by subtraction.
+//
+// Metrics: admission.{cpu,memory_bytes,timers}.{used,budget} gauges,
+// admission.admit / .downgrade / .reject counters.
+class AdmissionController {
+public:
+  struct Budget {
+    double        cpu        = 0;   // work units per second
+    std::uint64_t stateBytes = 0;
+    std::uint32_t timers     = 0;
+  };
+
+  struct Usage {
+    double        cpu        = 0;
+    std::uint64_t stateBytes = 0;
+    std::uint32_t timers     = 0;
+  };
+
+  enum class Decision { Admit, Downgrade, Reject };
+
+  struct Result {
+    Decision    decision = Decision::Reject;
+    Usage       charged;        // what release() must give back
+    std::string reason;         // set when downgraded or rejected
+  };
+
+  static constexpr double DOWNGRADE_CPU_FACTOR = 0.25;
+
+  AdmissionController(Budget global, Budget perSession);
+
+  // Budget from config units (memory in MiB); negative values mean 0.
+  static Budget budget(double cpu, int memoryMB, int timers);
+
+  AdmissionController(const AdmissionController&)            = delete;
+  AdmissionController& operator=(const AdmissionController&) = delete;
+
+  Result admit(std::uint64_t session, const tree::TreeCost& cost);
+  void   release(std::uint64_t session, const Usage& charged);
+
+  // Drop `session`'s entry and whatever rounding residue it still holds.
+  // Once no session is left the global usage is reset to zero as well.
+  void   forget(std::uint64_t session);
+
+  Usage  used() const;
+  Usage  sessionUsed(std::uint64_t session) const;
+  std::size_t sessionCount() const;
+  const Budget& globalBudget()  const noexcept { return global_; }
+  const Budget& sessionBudget() const noexcept { return perSession_; }
+
+private:
+  void publishLocked() const;
+
+  const Budget global_;
+  const Budget perSession_;
+
+  mutable std::mutex                        mx_;
+  Usage                                     used_;
+  std::unordered_map<std::uint64_t, Usage>  sessions_;
+};
+
+} // namespace gma::server
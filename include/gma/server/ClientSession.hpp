@@ -17,6 +17,7 @@
 #include <string>
 #include <unordered_map>
 
+#include "gma/server/Admission.hpp"
 #include "gma/server/RequestKey.hpp"
 
 namespace gma {
@@ -25,6 +26,8 @@ class WebSocketServer;
 class ExecutionContext;
 class Dispatcher;
 class INode;
+namespace rt { class CreditGate; }
+namespace engine { class IStream; }
 
 class ClientSession : public std::enable_shared_from_this<ClientSession> {
 public:
@@ -40,7 +43,16 @@ public:
   void run();
 
   // Send a text frame to the client (no-op if the session is closed).
-  void sendText(const std::string& s);
+  // `credit`, when given, is a credit the caller already acquired on the
+  // subscription's gate; it is released once the frame has been written
+  // or discarded.
+  void sendText(const std::string& s,
+                std::shared_ptr<rt::CreditGate> credit = nullptr);
+
+  // Send a binary frame (connector streams); same queueing and credit
+  // rules as sendText.
+  void sendBinary(std::string bytes,
+                  std::shared_ptr<rt::CreditGate> credit = nullptr);
 
   // Gracefully close the WebSocket (idempotent).
   void close();
@@ -54,6 +66,7 @@ private:
 
   void handleMessage(const std::string& text);
   void handleSubscribe(const ::rapidjson::Document& doc);
+  void handleStreamSubscribe(const ::rapidjson::Value& r, gma::server::RequestKey key);
   void handleCancel(const ::rapidjson::Document& doc);
   void sendError(const std::string& where, const std::string& message);
 
@@ -71,8 +84,20 @@ private:
 
   // Outbound write serialization (Responder can call sendText from worker threads).
   static constexpr std::size_t MAX_OUTBOX_SIZE = 4096;
-  std::deque<std::string> outbox_;
+  struct Outgoing {
+    std::string text;
+    std::shared_ptr<rt::CreditGate> credit;
+    bool binary{false};
+  };
+  std::deque<Outgoing> outbox_;
   bool writing_{false};
+  void enqueue(Outgoing o);
+  void discardOutbox();
+
+  // Per-subscription credit window (frames + queued pipeline tasks in
+  // flight). A subscribe may override with "creditWindow" / "overflow".
+  static constexpr std::size_t DEFAULT_CREDIT_WINDOW = 64;
+  static constexpr std::size_t MAX_CREDIT_WINDOW     = 1024;
 
   // Active requests for this session. Variant key supports both
   // smoke.js's int-keyed wire and embassy's string-id wire.
@@ -80,6 +105,20 @@ private:
   std::unordered_map<gma::server::RequestKey, std::shared_ptr<INode>> active_;
   std::unordered_map<gma::server::RequestKey, std::vector<std::shared_ptr<INode>>> chains_; // keeps pipeline alive
 
+  // Connector streams ({"stream": kind} requests, see StreamRegistry). Each
+  // gets a per-session id that tags its binary frames. A stream holds at
+  // most STREAM_CREDIT_WINDOW unwritten frames; beyond that it keeps its
+  // changes pending and conflates them into its next frame.
+  static constexpr std::size_t STREAM_CREDIT_WINDOW = 4;
+  std::unordered_map<gma::server::RequestKey, std::shared_ptr<engine::IStream>> streams_;
+  std::uint32_t nextStreamId_{1};
+
+  // Admission charge per active request, released on cancel / replace /
+  // close. Empty when the ExecutionContext has no AdmissionController.
+  std::unordered_map<gma::server::RequestKey, gma::server::AdmissionController::Usage> charges_;
+  std::uint64_t admissionId() const noexcept;
+  void releaseChargeLocked(const gma::server::RequestKey& key);   // reqMu_ held
+
   // Rate limiting: token-bucket for subscribe requests
   static constexpr int    RATE_LIMIT_BURST    = 20;   // max burst of subscribes
   static constexpr double RATE_LIMIT_PER_SEC  = 5.0;  // sustained rate
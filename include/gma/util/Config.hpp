@@ -73,12 +73,30 @@ public:
   // History cap for Dispatcher (per symbol+field pair)
   int taHistoryMax = 1000;
 
+  // Run MarketTickComputer's TA on the thread pool instead of the feed
+  // thread. Ticks for one symbol are still applied in arrival order.
+  bool taParallel = false;
+
   // Maximum distinct symbols tracked before rejecting new ones.
   int maxSymbols = 10000;
 
   // Maximum distinct fields per symbol in per-field histories.
   int maxFieldsPerSymbol = 200;
 
+  // Subscribe-time admission control (server::AdmissionController).
+  // 0 = unlimited, the default for every cap: estimates are deliberately
+  // pessimistic (a GroupSplit is charged SPLIT_FANOUT_ESTIMATE children), so
+  // limits are opt-in and sized per deployment. CPU is in cost-model work
+  // units per second (see gma/CostModel.hpp); memory is estimated tree
+  // state in MiB; timers count timer nodes, each of which owns a thread on
+  // the system clock.
+  double admissionCpu             = 0;
+  int    admissionMemoryMB        = 0;
+  int    admissionTimers          = 0;
+  double admissionSessionCpu      = 0;
+  int    admissionSessionMemoryMB = 0;
+  int    admissionSessionTimers   = 0;
+
   // Metrics reporter
   bool metricsEnabled = false;
   int  metricsIntervalSec = 15;
@@ -96,6 +114,21 @@ public:
   // Allow negative prices in order book (for bonds with negative yields, spreads, etc.)
   bool allowNegativePrices = false;
 
+  // Symbols whose order books use the flat tick-indexed ladder instead of
+  // the map-based one (empty = none, ["*"] = all). Each such book
+  // preallocates bookTickWindow price slots per side.
+  std::vector<std::string> bookTickLadderSymbols;
+  int bookTickWindow = 4096;
+
+  // Allocate order-book order storage from huge-page backed slabs.
+  bool bookHugePages = false;
+
+  // Symbols whose order books keep only their best bookDepthLimit levels
+  // per side, without queue positions (empty = none, ["*"] = all). For
+  // symbols read through top-of-book and shallow depth only.
+  std::vector<std::string> bookDepthLimitSymbols;
+  int bookDepthLimit = 10;
+
   // Per-feed configuration for external WebSocket feeds.
   struct FeedConfig {
       std::string url;
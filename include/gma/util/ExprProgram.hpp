@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gma::util {
+
+// Arithmetic expression compiled once into a flat postfix program over a
+// fixed set of named input slots — the evaluator behind the Expr node.
+//
+// Grammar (whitespace-insensitive):
+//
+//   expr    := term   (('+' | '-') term)*
+//   term    := unary  (('*' | '/') unary)*
+//   unary   := '-' unary | power
+//   power   := primary ('^' unary)?          (right-associative)
+//   primary := number | name | name '(' expr (',' expr)* ')' | '(' expr ')'
+//
+// Functions: abs, sqrt, log, exp (one argument); min, max, pow (two).
+// Names resolve to slot indices at compile time; an unknown name, function,
+// arity mismatch or syntax error throws std::runtime_error with the
+// offending column. Constant sub-expressions are folded.
+//
+// Evaluation follows the FunctionMap builtins' guard conventions so a join
+// never puts inf/NaN on the wire for ordinary inputs: division by
+// |d| <= DIV_EPSILON yields 0.0, sqrt takes |x|, log of x <= 0 yields 0.0.
+// eval() allocates nothing — callers own the value stack (stackDepth()
+// doubles) and reuse it across ticks.
+class ExprProgram {
+public:
+  static constexpr std::size_t MAX_SOURCE_LEN = 1024;
+  static constexpr std::size_t MAX_CODE       = 256;
+  static constexpr double      DIV_EPSILON    = 1e-12;
+
+  enum class Op : std::uint8_t {
+    Const, Load,
+    Add, Sub, Mul, Div, Pow, Min, Max,
+    Neg, Abs, Sqrt, Log, Exp
+  };
+
+  struct Instr {
+    Op            op;
+    std::uint16_t slot;   // Load
+    double        k;      // Const
+  };
+
+  ExprProgram() = default;
+
+  static ExprProgram compile(std::string_view source,
+                             const std::vector<std::string>& slotNames);
+
+  // Evaluate against slots[0..slotCount). `stack` must hold stackDepth()
+  // doubles.
+  double eval(const double* slots, double* stack) const noexcept;
+
+  std::size_t stackDepth() const noexcept { return depth_; }
+  std::size_t size() const noexcept { return code_.size(); }
+  const std::vector<Instr>& code() const noexcept { return code_; }
+
+  // True when the program reads slot `i` (an input nobody references can be
+  // wired but never affects the result).
+  bool usesSlot(std::size_t i) const noexcept;
+
+private:
+  std::vector<Instr> code_;
+  std::size_t        depth_{0};
+};
+
+} // namespace gma::util
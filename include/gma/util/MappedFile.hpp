@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gma {
+namespace util {
+
+// Read-only view of a whole file, memory-mapped where the platform allows
+// (read into memory otherwise). The mapping is advised for sequential
+// access, so a front-to-back scan streams through the page cache.
+// Throws std::runtime_error if the file cannot be opened or mapped.
+class MappedFile {
+public:
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&)            = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const uint8_t* data() const noexcept { return data_; }
+  std::size_t    size() const noexcept { return size_; }
+
+private:
+  const uint8_t*       data_ = nullptr;
+  std::size_t          size_ = 0;
+  bool                 mapped_ = false;
+  std::vector<uint8_t> copy_;         // fallback storage when not mapped
+};
+
+} // namespace util
+} // namespace gma
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+
+namespace gma::util::simd {
+
+// Contiguous-double reduction kernels shared by the vector-consuming
+// FunctionMap builtins (sum, mean, min, max, range, product, variance,
+// stddev, zscore). Each entry point dispatches at runtime to the widest
+// implementation the host CPU supports — AVX-512F, AVX2, or a plain scalar
+// loop — resolved once on first use.
+//
+// Numerical contract. The vector paths reassociate additions and
+// multiplications (lane-parallel partial sums combined at the end), so
+// results may differ from the sequential scalar loop in the last bits:
+//
+//   - sum / sumSqDev:  |simd - scalar| <= 2 * n * eps * sum(|x_i|)
+//                      (eps = DBL_EPSILON; sumSqDev uses |x_i - mean|^2)
+//   - product:         relative error <= 2 * n * eps
+//   - minMax:          exact (comparisons don't round)
+//
+// NaN inputs propagate unspecified-ly through minMax (the SSE/AVX min/max
+// instructions are order-sensitive on NaN); sum/product/sumSqDev propagate
+// NaN as usual. The scalar path reproduces the pre-SIMD builtin loops
+// bit-for-bit, so forcing Isa::Scalar is the reference for tolerance tests.
+//
+// Builds that define GMA_NO_SIMD (CMake option GMA_SIMD=OFF) compile only
+// the scalar path.
+
+enum class Isa { Scalar = 0, Avx2 = 1, Avx512 = 2 };
+
+struct MinMax {
+  double min;
+  double max;
+};
+
+// Widest ISA the host CPU (and OS) supports. Stable for the process lifetime.
+Isa detectedIsa() noexcept;
+
+// ISA the kernels currently dispatch to (defaults to detectedIsa()).
+Isa activeIsa() noexcept;
+
+// Override dispatch — used by tests and benchmarks to compare paths.
+// Requests above detectedIsa() are clamped down. Returns the ISA actually
+// selected. Not intended for hot-path use; takes effect for all threads.
+Isa forceIsa(Isa isa) noexcept;
+
+const char* isaName(Isa isa) noexcept;
+
+// sum(p[0..n)). Returns 0.0 for n == 0.
+double sum(const double* p, std::size_t n) noexcept;
+
+// product(p[0..n)). Returns 1.0 for n == 0 (callers handle the empty case).
+double product(const double* p, std::size_t n) noexcept;
+
+// Smallest and largest element. Precondition: n > 0.
+MinMax minMax(const double* p, std::size_t n) noexcept;
+
+// sum((p[i] - mean)^2) — the second pass of a two-pass variance.
+double sumSqDev(const double* p, std::size_t n, double mean) noexcept;
+
+} // namespace gma::util::simd
@@ -34,7 +34,17 @@ void AtomicStore::set(const std::string& streamKey, const std::string& field, Ar
 void AtomicStore::setBatch(const std::string& streamKey,
                            const std::vector<std::pair<std::string, ArgType>>& fields) {
   std::unique_lock lock(_mutex);
+  setBatchLocked(streamKey, fields);
+}
+
+void AtomicStore::setBatches(const std::vector<std::pair<std::string, FieldBatch>>& batches) {
+  std::unique_lock lock(_mutex);
+  for (const auto& [streamKey, fields] : batches) {
+    if (!fields.empty()) setBatchLocked(streamKey, fields);
+  }
+}
 
+void AtomicStore::setBatchLocked(const std::string& streamKey, const FieldBatch& fields) {
   auto skIt = _data.find(streamKey);
   if (skIt == _data.end()) {
     if (_maxStreamKeys > 0 && _data.size() >= _maxStreamKeys) {
@@ -1,6 +1,7 @@
 // Generic, domain-free worker functions for FunctionMap. Stays in the engine.
 #include "gma/FunctionRegistry.hpp"
 #include "gma/FunctionMap.hpp"
+#include "gma/util/VectorKernels.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -11,6 +12,12 @@ namespace gma {
 // Minimum threshold for denominators to avoid division by near-zero values.
 static constexpr double EPSILON = 1e-6;
 
+// Full-vector reductions route through util::simd so large TumblingWindow
+// buckets (and the per-tick Dispatcher history recompute) get the AVX2 /
+// AVX-512 kernels. See VectorKernels.hpp for the tolerance contract versus
+// the scalar loops these replaced.
+namespace simd = gma::util::simd;
+
 void registerBuiltinFunctions() {
     auto& fm = FunctionMap::instance();
 
@@ -33,43 +40,31 @@ void registerBuiltinFunctions() {
 
     fm.registerFunction("mean", [](const std::vector<double>& v) -> double {
         if (v.empty()) return 0.0;
-        double s = 0.0;
-        for (double x : v) s += x;
-        return s / static_cast<double>(v.size());
+        return simd::sum(v.data(), v.size()) / static_cast<double>(v.size());
     });
 
     fm.registerFunction("avg", [](const std::vector<double>& v) -> double {
         if (v.empty()) return 0.0;
-        double s = 0.0;
-        for (double x : v) s += x;
-        return s / static_cast<double>(v.size());
+        return simd::sum(v.data(), v.size()) / static_cast<double>(v.size());
     });
 
     fm.registerFunction("sum", [](const std::vector<double>& v) -> double {
-        double s = 0.0;
-        for (double x : v) s += x;
-        return s;
+        return simd::sum(v.data(), v.size());
     });
 
     fm.registerFunction("product", [](const std::vector<double>& v) -> double {
         if (v.empty()) return 0.0;
-        double p = 1.0;
-        for (double x : v) p *= x;
-        return p;
+        return simd::product(v.data(), v.size());
     });
 
     fm.registerFunction("min", [](const std::vector<double>& v) -> double {
         if (v.empty()) return 0.0;
-        double m = v[0];
-        for (size_t i = 1; i < v.size(); ++i) m = std::min(m, v[i]);
-        return m;
+        return simd::minMax(v.data(), v.size()).min;
     });
 
     fm.registerFunction("max", [](const std::vector<double>& v) -> double {
         if (v.empty()) return 0.0;
-        double m = v[0];
-        for (size_t i = 1; i < v.size(); ++i) m = std::max(m, v[i]);
-        return m;
+        return simd::minMax(v.data(), v.size()).max;
     });
 
     fm.registerFunction("last", [](const std::vector<double>& v) -> double {
@@ -95,12 +90,8 @@ void registerBuiltinFunctions() {
 
     fm.registerFunction("range", [](const std::vector<double>& v) -> double {
         if (v.size() < 2) return 0.0;
-        double lo = v[0], hi = v[0];
-        for (size_t i = 1; i < v.size(); ++i) {
-            lo = std::min(lo, v[i]);
-            hi = std::max(hi, v[i]);
-        }
-        return hi - lo;
+        auto mm = simd::minMax(v.data(), v.size());
+        return mm.max - mm.min;
     });
 
     // Population standard deviation (divides by N, not N-1) — intentional for
@@ -108,23 +99,16 @@ void registerBuiltinFunctions() {
     fm.registerFunction("stddev", [](const std::vector<double>& v) -> double {
         if (v.size() < 2) return 0.0;
         double n = static_cast<double>(v.size());
-        double s = 0.0;
-        for (double x : v) s += x;
-        double mean = s / n;
-        double ss = 0.0;
-        for (double x : v) { double d = x - mean; ss += d * d; }
+        double mean = simd::sum(v.data(), v.size()) / n;
+        double ss = simd::sumSqDev(v.data(), v.size(), mean);
         return std::sqrt(ss / n);
     });
 
     fm.registerFunction("variance", [](const std::vector<double>& v) -> double {
         if (v.size() < 2) return 0.0;
         double n = static_cast<double>(v.size());
-        double s = 0.0;
-        for (double x : v) s += x;
-        double mean = s / n;
-        double ss = 0.0;
-        for (double x : v) { double d = x - mean; ss += d * d; }
-        return ss / n;
+        double mean = simd::sum(v.data(), v.size()) / n;
+        return simd::sumSqDev(v.data(), v.size(), mean) / n;
     });
 
     // ──── Binary ops (operate on first and last values) ────
@@ -135,12 +119,8 @@ void registerBuiltinFunctions() {
 
     fm.registerFunction("spread", [](const std::vector<double>& v) -> double {
         if (v.size() < 2) return 0.0;
-        double lo = v[0], hi = v[0];
-        for (size_t i = 1; i < v.size(); ++i) {
-            lo = std::min(lo, v[i]);
-            hi = std::max(hi, v[i]);
-        }
-        return hi - lo;
+        auto mm = simd::minMax(v.data(), v.size());
+        return mm.max - mm.min;
     });
 
     fm.registerFunction("div", [](const std::vector<double>& v) -> double {
@@ -325,12 +305,8 @@ void registerBuiltinFunctions() {
     fm.registerFunction("zscore", [](const std::vector<double>& v) -> double {
         if (v.size() < 3) return 0.0;
         double n = static_cast<double>(v.size());
-        double s = 0.0;
-        for (double x : v) s += x;
-        double mean = s / n;
-        double ss = 0.0;
-        for (double x : v) { double d = x - mean; ss += d * d; }
-        double sd = std::sqrt(ss / n);
+        double mean = simd::sum(v.data(), v.size()) / n;
+        double sd = std::sqrt(simd::sumSqDev(v.data(), v.size(), mean) / n);
         return std::abs(sd) > EPSILON ? (v.back() - mean) / sd : 0.0;
     });
 
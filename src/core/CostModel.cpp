@@ -0,0 +1,135 @@
+#include "gma/CostModel.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace gma::tree {
+
+namespace {
+
+constexpr int MAX_COST_DEPTH = 32;   // matches JsonValidator's tree depth cap
+
+// Reducers that sort or make several passes over their inputs.
+double fnWeight(const rapidjson::Value& v) {
+  if (!v.HasMember("fn") || !v["fn"].IsString()) return 1.0;
+  const std::string fn = v["fn"].GetString();
+  if (fn == "median" || fn == "range" || fn == "spread") return 8.0;
+  if (fn == "stddev" || fn == "variance" || fn == "zscore") return 3.0;
+  return 1.0;
+}
+
+int periodMs(const rapidjson::Value& v) {
+  for (const char* k : {"ms", "periodMs"}) {
+    if (v.HasMember(k) && v[k].IsInt() && v[k].GetInt() > 0) return v[k].GetInt();
+  }
+  return 1000;
+}
+
+TreeCost estimate(const rapidjson::Value& v, int depth);
+
+TreeCost childCost(const rapidjson::Value& v, const char* key, int depth) {
+  TreeCost c;
+  if (!v.HasMember(key)) return c;
+  const auto& child = v[key];
+  if (child.IsObject() && child.HasMember("type")) {
+    c += estimate(child, depth + 1);
+  } else if (child.IsArray()) {
+    for (const auto& e : child.GetArray()) c += estimate(e, depth + 1);
+  } else if (child.IsObject()) {
+    // Expr: name -> spec
+    for (auto it = child.MemberBegin(); it != child.MemberEnd(); ++it)
+      c += estimate(it->value, depth + 1);
+  }
+  return c;
+}
+
+// Everything under a timer runs per timer tick rather than per input tick.
+TreeCost underTimer(TreeCost c, int ms) {
+  c.timerWork += c.tickWork * (1000.0 / ms);
+  c.tickWork = 0;
+  return c;
+}
+
+// n instances of a subtree. Each input tick reaches only its key's
+// instance, so tickWork is not multiplied; timers and state are.
+TreeCost scaled(TreeCost c, std::uint32_t n) {
+  c.timerWork  *= n;
+  c.timers     *= n;
+  c.stateBytes *= n;
+  c.fanout      = std::max<std::uint32_t>(c.fanout * n, n);
+  return c;
+}
+
+TreeCost estimate(const rapidjson::Value& v, int depth) {
+  TreeCost c;
+  if (!v.IsObject() || depth > MAX_COST_DEPTH) return c;
+  const std::string type =
+    (v.HasMember("type") && v["type"].IsString()) ? v["type"].GetString() : "";
+
+  if (type == "Listener") {
+    c.tickWork = 1;  c.stateBytes = 512;            // queue + credit gate
+  } else if (type == "AtomicAccessor") {
+    c.tickWork = 1;  c.stateBytes = 64;
+  } else if (type == "Worker") {
+    c.tickWork = fnWeight(v);  c.stateBytes = 128;
+  } else if (type == "VectorReducer") {
+    c.tickWork = 4 * fnWeight(v);  c.stateBytes = 64;
+  } else if (type == "Interval" || type == "BucketTime") {
+    TreeCost inner = childCost(v, "child", depth);
+    inner.tickWork += 1;
+    c = underTimer(inner, periodMs(v));
+    c.timers += 1;
+    c.stateBytes += 256;                            // timer thread bookkeeping
+  } else if (type == "TumblingWindow") {
+    const int ms = periodMs(v);
+    c.tickWork  = 1;                                // append
+    c.timerWork = 1000.0 / ms;                      // flush
+    c.timers    = 1;
+    const double buffered = TreeCost::ASSUMED_TICKS_PER_SEC * ms / 1000.0;
+    c.stateBytes = 256 + static_cast<std::uint64_t>(buffered * sizeof(double));
+  } else if (type == "Aggregate") {
+    c = childCost(v, "inputs", depth);
+    c.tickWork   += 1;
+    const int arity = (v.HasMember("arity") && v["arity"].IsInt()) ? v["arity"].GetInt() : 1;
+    c.stateBytes += 16 * static_cast<std::uint64_t>(std::max(1, arity));
+  } else if (type == "Expr") {
+    c = childCost(v, "inputs", depth);
+    c.tickWork   += 2;
+    c.stateBytes += 256;
+  } else if (type == "GroupSplit" || type == "SymbolSplit") {
+    c = scaled(childCost(v, "child", depth), TreeCost::SPLIT_FANOUT_ESTIMATE);
+    c.tickWork   += 1;
+    c.stateBytes += 64 * TreeCost::SPLIT_FANOUT_ESTIMATE;   // key map
+  } else if (type == "Chain") {
+    c = childCost(v, "stages", depth);
+  } else {
+    c.tickWork = 4;  c.stateBytes = 1024;
+  }
+  return c;
+}
+
+} // namespace
+
+TreeCost estimateNodeCost(const rapidjson::Value& spec) {
+  return estimate(spec, 0);
+}
+
+TreeCost estimateRequestCost(const rapidjson::Value& request) {
+  TreeCost c;
+  if (!request.IsObject()) return c;
+
+  // The request's own Listener.
+  c.tickWork   = 1;
+  c.stateBytes = 512;
+
+  if (request.HasMember("node")) c += estimateNodeCost(request["node"]);
+  for (const char* k : {"pipeline", "stages"}) {
+    if (request.HasMember(k) && request[k].IsArray()) {
+      for (const auto& stage : request[k].GetArray()) c += estimateNodeCost(stage);
+      break;
+    }
+  }
+  return c;
+}
+
+} // namespace gma::tree
@@ -4,6 +4,8 @@
 #include <algorithm>
 #include <mutex>
 #include <shared_mutex>
+#include <string_view>
+#include <unordered_set>
 
 using namespace gma;
 
@@ -14,88 +16,204 @@ void Dispatcher::addComputer(std::unique_ptr<engine::IEventComputer> c) {
 Dispatcher::Dispatcher(rt::ThreadPool* threadPool,
                                    AtomicStore* store,
                                    const util::Config& cfg)
-  : _threadPool(threadPool)
+  : _history(static_cast<std::size_t>(std::max(1, cfg.taHistoryMax)),
+             static_cast<std::size_t>(std::max(1, cfg.maxSymbols)),
+             static_cast<std::size_t>(std::max(1, cfg.maxFieldsPerSymbol)))
+  , _threadPool(threadPool)
   , _store(store)
   , _cfg(cfg)
   , _maxHistory(static_cast<std::size_t>(std::max(1, cfg.taHistoryMax)))
-  , _maxSymbols(static_cast<std::size_t>(std::max(1, cfg.maxSymbols)))
-  , _maxFieldsPerSymbol(static_cast<std::size_t>(std::max(1, cfg.maxFieldsPerSymbol)))
 {}
 
 void Dispatcher::registerListener(const std::string& symbol,
                                         const std::string& field,
                                         std::shared_ptr<INode> listener)
 {
-  std::unique_lock<std::shared_mutex> lock(_listenerMutex);
-  _listeners[symbol][field].emplace_back(std::move(listener));
+  // Held through the callbacks so observers see a key's first-listener /
+  // last-listener transitions in the order they happened.
+  std::lock_guard<std::mutex> observing(_observerMutex);
+  std::vector<SubscriptionFn> notify;
+  {
+    std::unique_lock<std::shared_mutex> lock(_listenerMutex);
+    auto& vec = _listeners[symbol][field];
+    if (vec.empty()) notify = observersFor(field);
+    vec.emplace_back(std::move(listener));
+  }
+  for (auto& fn : notify) fn(symbol, field, true);
 }
 
 void Dispatcher::unregisterListener(const std::string& symbol,
                                           const std::string& field,
                                           std::shared_ptr<INode> listener)
 {
-  std::unique_lock<std::shared_mutex> lock(_listenerMutex);
-  auto symIt = _listeners.find(symbol);
-  if (symIt == _listeners.end()) return;
-  auto& fieldMap = symIt->second;
-  auto fldIt = fieldMap.find(field);
-  if (fldIt == fieldMap.end()) return;
-  auto& vec = fldIt->second;
-  vec.erase(std::remove(vec.begin(), vec.end(), listener), vec.end());
-  if (vec.empty()) fieldMap.erase(fldIt);
-  if (fieldMap.empty()) _listeners.erase(symIt);
+  std::lock_guard<std::mutex> observing(_observerMutex);
+  std::vector<SubscriptionFn> notify;
+  {
+    std::unique_lock<std::shared_mutex> lock(_listenerMutex);
+    auto symIt = _listeners.find(symbol);
+    if (symIt == _listeners.end()) return;
+    auto& fieldMap = symIt->second;
+    auto fldIt = fieldMap.find(field);
+    if (fldIt == fieldMap.end()) return;
+    auto& vec = fldIt->second;
+    vec.erase(std::remove(vec.begin(), vec.end(), listener), vec.end());
+    if (vec.empty()) {
+      fieldMap.erase(fldIt);
+      notify = observersFor(field);
+    }
+    if (fieldMap.empty()) _listeners.erase(symIt);
+  }
+  for (auto& fn : notify) fn(symbol, field, false);
 }
 
-void Dispatcher::onTick(const Event& tick) {
-  if (tick.symbol.empty() || !tick.payload) return;
+std::vector<Dispatcher::SubscriptionFn> Dispatcher::observersFor(const std::string& field) const {
+  std::vector<SubscriptionFn> out;
+  for (const auto& o : _subObservers) {
+    if (field.compare(0, o.prefix.size(), o.prefix) == 0) out.push_back(o.fn);
+  }
+  return out;
+}
 
-  engine::ComputeContext ctx{ _store, this, _threadPool };
+void Dispatcher::observeSubscriptions(const std::string& fieldPrefix,
+                                      SubscriptionFn fn,
+                                      std::function<bool(const std::string&)> accepts)
+{
+  if (!fn) return;
+  std::lock_guard<std::mutex> observing(_observerMutex);
+  std::vector<std::pair<std::string, std::string>> existing;
+  {
+    std::unique_lock<std::shared_mutex> lock(_listenerMutex);
+    _subObservers.push_back(SubscriptionObserver{ fieldPrefix, fn, std::move(accepts) });
+    for (const auto& [symbol, fields] : _listeners) {
+      for (const auto& [field, nodes] : fields) {
+        if (!nodes.empty() && field.compare(0, fieldPrefix.size(), fieldPrefix) == 0)
+          existing.emplace_back(symbol, field);
+      }
+    }
+  }
+  for (const auto& [symbol, field] : existing) fn(symbol, field, true);
+}
+
+bool Dispatcher::isObserved(const std::string& field) const {
+  std::shared_lock<std::shared_mutex> lock(_listenerMutex);
+  for (const auto& o : _subObservers) {
+    if (field.compare(0, o.prefix.size(), o.prefix) != 0) continue;
+    if (!o.accepts || o.accepts(field)) return true;
+  }
+  return false;
+}
 
+std::vector<engine::IEventComputer*> Dispatcher::computersFor(const std::string& type) {
   // Per-type cache fed from EventComputerRegistry. First event of a given
   // type instantiates the registered factories; subsequent events reuse the
   // cached instances. Late-registered factories are picked up the first time
   // an event of their type arrives.
-  std::vector<engine::IEventComputer*> typedComputers;
+  std::vector<engine::IEventComputer*> out;
   {
     std::lock_guard<std::mutex> lk(_computerCacheMx);
-    auto it = _computersByType.find(tick.type);
+    auto it = _computersByType.find(type);
     if (it == _computersByType.end()) {
-      auto fresh = engine::EventComputerRegistry::createAll(tick.type, _cfg);
-      it = _computersByType.emplace(tick.type, std::move(fresh)).first;
+      auto fresh = engine::EventComputerRegistry::createAll(type, _cfg);
+      it = _computersByType.emplace(type, std::move(fresh)).first;
     }
-    typedComputers.reserve(it->second.size());
-    for (auto& c : it->second) typedComputers.push_back(c.get());
-  }
-  for (auto* c : typedComputers) {
-    if (c) c->compute(tick, ctx);
+    out.reserve(it->second.size() + _computers.size());
+    for (auto& c : it->second) if (c) out.push_back(c.get());
   }
 
   // Computers added directly via addComputer() — kept for tests and code
   // paths that want to inject without the global registry.
   for (auto& c : _computers) {
-    if (!c) continue;
-    if (c->eventType() != tick.type) continue;
-    c->compute(tick, ctx);
+    if (c && c->eventType() == type) out.push_back(c.get());
   }
+  return out;
+}
 
-  // Collect (field, listener) pairs for this symbol under the listener lock.
-  std::vector<std::pair<std::string, std::shared_ptr<INode>>> toNotify;
+bool Dispatcher::wantsPayload(const std::string& symbol,
+                              const std::string& type,
+                              std::string_view raw) {
+  {
+    std::shared_lock<std::shared_mutex> lock(_listenerMutex);
+    auto lit = _listeners.find(symbol);
+    if (lit != _listeners.end()) {
+      for (const auto& [field, nodes] : lit->second) {
+        if (nodes.empty()) continue;
+        if (raw.empty()) return true;
+        // A member named `field` has its quoted name somewhere in the text.
+        for (auto pos = raw.find(field); pos != std::string_view::npos;
+             pos = raw.find(field, pos + 1)) {
+          const auto end = pos + field.size();
+          if (pos > 0 && raw[pos - 1] == '"' && end < raw.size() && raw[end] == '"') return true;
+        }
+      }
+    }
+  }
+  for (auto* c : computersFor(type)) if (c->readsPayload()) return true;
+  return false;
+}
+
+void Dispatcher::onTick(const Event& tick) {
+  if (tick.symbol.empty() || (!tick.payload && !tick.decoded)) return;
+
+  engine::ComputeContext ctx{ _store, this, _threadPool, &_history };
+  for (auto* c : computersFor(tick.type)) c->compute(tick, ctx);
+
+  fanOutRawFields(tick);
+}
+
+void Dispatcher::onTickBatch(std::span<const Event> ticks) {
+  auto valid = [](const Event& e) { return !e.symbol.empty() && (e.payload || e.decoded); };
+  engine::ComputeContext ctx{ _store, this, _threadPool, &_history };
+
+  // Each segment is a run of same-type events in which no symbol repeats.
+  // Computers see the whole segment at once, and its raw fields fan out
+  // before the next segment is computed, so a tick's FunctionMap values
+  // never read columns that already hold a later tick of its symbol.
+  constexpr std::size_t SCAN_LIMIT = 16;
+  std::vector<std::string_view> seen;
+  std::unordered_set<std::string_view> seenIndex;
+  for (std::size_t i = 0; i < ticks.size();) {
+    if (!valid(ticks[i])) { ++i; continue; }
+    seen.assign(1, ticks[i].symbol);
+    seenIndex.clear();
+    std::size_t j = i + 1;
+    for (; j < ticks.size() && valid(ticks[j]) && ticks[j].type == ticks[i].type; ++j) {
+      const std::string_view symbol = ticks[j].symbol;
+      if (seenIndex.empty()) {
+        if (std::find(seen.begin(), seen.end(), symbol) != seen.end()) break;
+        seen.push_back(symbol);
+        if (seen.size() > SCAN_LIMIT) seenIndex.insert(seen.begin(), seen.end());
+      } else if (!seenIndex.insert(symbol).second) {
+        break;
+      }
+    }
+    const auto segment = ticks.subspan(i, j - i);
+    for (auto* c : computersFor(ticks[i].type)) c->computeBatch(segment, ctx);
+    for (const auto& t : segment) fanOutRawFields(t);
+    i = j;
+  }
+}
+
+void Dispatcher::fanOutRawFields(const Event& tick) {
+  if (!tick.payload) return;              // decoded at ingress, no listener wanted the DOM
+  // Collect this symbol's subscribed fields present in the payload, with
+  // their listeners, under the listener lock.
+  std::vector<std::pair<std::string, std::vector<std::shared_ptr<INode>>>> toNotify;
   {
     std::shared_lock<std::shared_mutex> lock(_listenerMutex);
     auto lit = _listeners.find(tick.symbol);
     if (lit != _listeners.end()) {
-      for (auto& kv : lit->second) {
-        const std::string& field = kv.first;
-        for (auto& sp : kv.second) {
-          if (tick.payload->HasMember(field.c_str())) {
-            toNotify.emplace_back(field, sp);
-          }
+      for (auto& [field, nodes] : lit->second) {
+        if (!nodes.empty() && tick.payload->HasMember(field.c_str())) {
+          toNotify.emplace_back(field, nodes);
         }
       }
     }
   }
+  if (toNotify.empty()) return;
 
-  for (auto& [field, node] : toNotify) {
+  HistoryStore::Series* series = _history.series(tick.symbol);
+  std::vector<double> histVec;
+  for (auto& [field, nodes] : toNotify) {
     double raw = 0.0;
     try {
       const auto& v = (*tick.payload)[field.c_str()];
@@ -109,33 +227,36 @@ void Dispatcher::onTick(const Event& tick) {
       continue;
     }
 
-    std::vector<double> histVec;
+    if (!series) continue;                // symbol cap
     {
-      std::unique_lock<std::shared_mutex> lock(_histMutex);
-      if (_histories.find(tick.symbol) == _histories.end() &&
-          _histories.size() >= _maxSymbols) {
-        continue;
-      }
-      auto& symFields = _histories[tick.symbol];
-      if (symFields.find(field) == symFields.end() &&
-          symFields.size() >= _maxFieldsPerSymbol) {
-        continue;
+      std::unique_lock<std::shared_mutex> lock(series->mutex());
+      HistoryStore::Column* col = series->column(field);
+      if (!col) continue;                 // field cap
+      // A claimed column is fed by an event computer, which has already
+      // run inline for this tick (onTickBatch computes no later tick of
+      // this symbol before fanning this one out); only raw columns are
+      // appended here.
+      // (Computers that defer work to the pool, e.g. MarketTickComputer
+      // under taParallel, do not claim.)
+      if (!col->owner()) {
+        col->push_back(raw);
+        if (col->size() > _maxHistory) col->pop_front();
       }
-      auto& hist = symFields[field];
-      hist.push_back(raw);
-      if (hist.size() > _maxHistory) hist.pop_front();
-      histVec.assign(hist.begin(), hist.end());
+      const auto values = col->values();
+      histVec.assign(values.begin(), values.end());
     }
 
     computeAndStoreAtomics(tick.symbol, field, histVec);
 
     StreamValue out{ tick.symbol, raw };
-    if (_threadPool) {
-      _threadPool->post([node, out]() {
+    for (auto& node : nodes) {
+      if (_threadPool) {
+        _threadPool->post([node, out]() {
+          if (node) node->onValue(out);
+        });
+      } else {
         if (node) node->onValue(out);
-      });
-    } else {
-      if (node) node->onValue(out);
+      }
     }
   }
 }
@@ -12,11 +12,13 @@ FunctionMap& FunctionMap::instance() {
 void FunctionMap::registerFunction(const std::string& name, Func f) {
     std::unique_lock lock(_mutex);
     _map[name] = std::move(f);
+    _generation.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void FunctionMap::registerParamFunction(const std::string& name, ParamFunc f) {
     std::unique_lock lock(_mutex);
     _paramMap[name] = std::move(f);
+    _generation.fetch_add(1, std::memory_order_acq_rel);
 }
 
 Func FunctionMap::getFunction(const std::string& name) const {
@@ -0,0 +1,166 @@
+#include "gma/HistoryStore.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace gma {
+
+namespace {
+
+constexpr std::size_t MIN_CAPACITY = 16;
+
+} // namespace
+
+// ---------------------- Column ----------------------
+
+template <class T>
+HistoryStore::BasicColumn<T>::BasicColumn(std::size_t maxSize)
+  : limit_(std::max(maxSize, std::size_t{1}) + std::max(maxSize / 4, MIN_CAPACITY))
+{}
+
+template <class T>
+HistoryStore::BasicColumn<T>::~BasicColumn() {
+  if (data_) ::operator delete(data_, std::align_val_t{ALIGNMENT});
+}
+
+template <class T>
+HistoryStore::BasicColumn<T>::BasicColumn(BasicColumn&& o) noexcept
+  : limit_(o.limit_), cap_(o.cap_), head_(o.head_), size_(o.size_)
+  , data_(std::exchange(o.data_, nullptr)), owner_(o.owner_)
+{
+  o.cap_ = o.head_ = o.size_ = 0;
+}
+
+template <class T>
+HistoryStore::BasicColumn<T>& HistoryStore::BasicColumn<T>::operator=(BasicColumn&& o) noexcept {
+  if (this != &o) {
+    if (data_) ::operator delete(data_, std::align_val_t{ALIGNMENT});
+    limit_ = o.limit_; cap_ = o.cap_; head_ = o.head_; size_ = o.size_;
+    data_  = std::exchange(o.data_, nullptr);
+    owner_ = o.owner_;
+    o.cap_ = o.head_ = o.size_ = 0;
+  }
+  return *this;
+}
+
+template <class T>
+void HistoryStore::BasicColumn<T>::push_back(T v) {
+  if (head_ + size_ == cap_) makeRoom();
+  data_[head_ + size_] = v;
+  ++size_;
+}
+
+// Tail is at the end of the buffer. Grow while the window fills most of
+// it and there is headroom; otherwise slide the window back to the start,
+// which frees at least a quarter of the buffer.
+template <class T>
+void HistoryStore::BasicColumn<T>::makeRoom() {
+  if (cap_ < limit_ && size_ * 4 >= cap_ * 3) {
+    relocate(std::min(limit_, std::max(MIN_CAPACITY, cap_ * 2)));
+    return;
+  }
+  if (head_ == 0) {                     // writer exceeded maxSize
+    relocate(cap_ * 2);
+    limit_ = cap_;
+    return;
+  }
+  std::memmove(data_, data_ + head_, size_ * sizeof(T));
+  head_ = 0;
+}
+
+template <class T>
+void HistoryStore::BasicColumn<T>::relocate(std::size_t newCap) {
+  const std::size_t bytes = (newCap * sizeof(T) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  auto* data = static_cast<T*>(::operator new(bytes, std::align_val_t{ALIGNMENT}));
+  if (size_ > 0) std::memcpy(data, data_ + head_, size_ * sizeof(T));
+  if (data_) ::operator delete(data_, std::align_val_t{ALIGNMENT});
+  data_ = data;
+  cap_  = newCap;
+  head_ = 0;
+}
+
+template class HistoryStore::BasicColumn<double>;
+template class HistoryStore::BasicColumn<std::uint64_t>;
+
+// ---------------------- Series ----------------------
+
+HistoryStore::Column* HistoryStore::Series::find(std::string_view name) {
+  for (auto& e : entries_) {
+    if (e.name == name) return &e.column;
+  }
+  return nullptr;
+}
+
+const HistoryStore::Column* HistoryStore::Series::find(std::string_view name) const {
+  for (const auto& e : entries_) {
+    if (e.name == name) return &e.column;
+  }
+  return nullptr;
+}
+
+HistoryStore::Column* HistoryStore::Series::column(std::string_view name) {
+  if (auto* c = find(name)) return c;
+  if (entries_.size() >= maxColumns_) return nullptr;
+  entries_.push_back(Entry{std::string(name), Column(maxLen_)});
+  return &entries_.back().column;
+}
+
+HistoryStore::Column* HistoryStore::Series::claim(std::string_view name, const void* owner) {
+  Column* c = column(name);
+  if (!c) return nullptr;
+  if (c->owner_ == owner) return c;
+  if (c->owner_) return nullptr;
+  c->clear();                           // raw values predate the owner's state
+  c->owner_ = owner;
+  return c;
+}
+
+void HistoryStore::Series::release(std::string_view name, const void* owner) {
+  Column* c = find(name);
+  if (!c || c->owner_ != owner) return;
+  c->clear();
+  c->owner_ = nullptr;
+}
+
+// ---------------------- HistoryStore ----------------------
+
+HistoryStore::HistoryStore(std::size_t maxLen, std::size_t maxSymbols,
+                           std::size_t maxColumnsPerSymbol)
+  : _maxLen(std::max<std::size_t>(1, maxLen))
+  , _maxSymbols(std::max<std::size_t>(1, maxSymbols))
+  , _maxColumns(std::max<std::size_t>(1, maxColumnsPerSymbol))
+{}
+
+HistoryStore::Series* HistoryStore::series(const std::string& symbol) {
+  {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    auto it = _series.find(symbol);
+    if (it != _series.end()) return it->second.get();
+    if (_series.size() >= _maxSymbols) return nullptr;
+  }
+  std::unique_lock<std::shared_mutex> lock(_mutex);
+  auto it = _series.find(symbol);
+  if (it == _series.end()) {
+    if (_series.size() >= _maxSymbols) return nullptr;
+    // Columns get one slot of headroom: computers push before evicting.
+    it = _series.emplace(symbol,
+                         std::unique_ptr<Series>(new Series(_maxLen + 1, _maxColumns))).first;
+  }
+  return it->second.get();
+}
+
+HistoryStore::Series* HistoryStore::find(const std::string& symbol) const {
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  auto it = _series.find(symbol);
+  return it == _series.end() ? nullptr : it->second.get();
+}
+
+std::size_t HistoryStore::symbolCount() const {
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  return _series.size();
+}
+
+} // namespace gma
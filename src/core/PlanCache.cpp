@@ -0,0 +1,167 @@
+#include "gma/PlanCache.hpp"
+#include "gma/FunctionMap.hpp"
+#include "gma/engine/NodeTypeRegistry.hpp"
+#include "gma/util/Metrics.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace gma::tree {
+
+namespace {
+
+// Tagged, length-prefixed encoding — unambiguous without escaping, and
+// keeps the number kinds apart (1 and 1.0 compile differently: intOr()
+// only accepts the former).
+void putLen(std::string& out, std::size_t n) {
+  out += std::to_string(n);
+  out += ':';
+}
+
+void encode(const rapidjson::Value& v, std::string& out) {
+  if (v.IsObject()) {
+    std::vector<rapidjson::Value::ConstMemberIterator> members;
+    members.reserve(v.MemberCount());
+    for (auto it = v.MemberBegin(); it != v.MemberEnd(); ++it) members.push_back(it);
+    // Stable: duplicate names keep their relative order, which decides
+    // which one HasMember()/operator[] sees.
+    std::stable_sort(members.begin(), members.end(), [](auto a, auto b) {
+      return std::strcmp(a->name.GetString(), b->name.GetString()) < 0;
+    });
+    out += 'o';
+    putLen(out, members.size());
+    for (auto it : members) {
+      putLen(out, it->name.GetStringLength());
+      out.append(it->name.GetString(), it->name.GetStringLength());
+      encode(it->value, out);
+    }
+  } else if (v.IsArray()) {
+    out += 'a';
+    putLen(out, v.Size());
+    for (const auto& e : v.GetArray()) encode(e, out);
+  } else if (v.IsString()) {
+    out += 's';
+    putLen(out, v.GetStringLength());
+    out.append(v.GetString(), v.GetStringLength());
+  } else if (v.IsInt64()) {
+    out += 'i';
+    out += std::to_string(v.GetInt64());
+    out += ';';
+  } else if (v.IsUint64()) {
+    out += 'u';
+    out += std::to_string(v.GetUint64());
+    out += ';';
+  } else if (v.IsNumber()) {
+    const double d = v.GetDouble();
+    char bits[sizeof d];
+    std::memcpy(bits, &d, sizeof d);
+    out += 'd';
+    out.append(bits, sizeof bits);
+  } else if (v.IsBool()) {
+    out += v.GetBool() ? 'T' : 'F';
+  } else {
+    out += 'N';
+  }
+}
+
+} // namespace
+
+PlanCache& PlanCache::instance() {
+  static PlanCache inst;
+  return inst;
+}
+
+PlanCache::PlanCache(std::size_t capacity)
+  : capacity_(std::max<std::size_t>(capacity, 1))
+{
+}
+
+void PlanCache::canonicalKey(const rapidjson::Value& request, std::string& out) {
+  out.clear();
+  if (!request.IsObject()) return;
+  // Fixed member order; absent members are marked so {"node":X} and
+  // {"pipeline":X} can't collide.
+  static const char* kMembers[] = {"streamKey", "field", "node", "pipeline", "stages"};
+  for (const char* k : kMembers) {
+    auto it = request.FindMember(k);
+    if (it == request.MemberEnd()) { out += '-'; continue; }
+    out += '+';
+    encode(it->value, out);
+  }
+}
+
+std::shared_ptr<const RequestPlan> PlanCache::find(const std::string& key) {
+  std::lock_guard<std::mutex> lk(mx_);
+  dropIfStaleLocked();
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    ++stats_.misses;
+    GMA_METRIC_HIT("plan_cache.miss");
+    publishLocked();
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+  ++stats_.hits;
+  GMA_METRIC_HIT("plan_cache.hit");
+  publishLocked();
+  return it->second->second;
+}
+
+std::shared_ptr<const RequestPlan> PlanCache::insert(const std::string& key,
+                                                     std::shared_ptr<const RequestPlan> plan) {
+  if (!plan) return plan;
+  std::lock_guard<std::mutex> lk(mx_);
+  dropIfStaleLocked();
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    // Two sessions compiled the same request concurrently; keep one.
+    it->second->second = plan;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return plan;
+  }
+  lru_.emplace_front(key, plan);
+  index_.emplace(key, lru_.begin());
+  while (lru_.size() > capacity_) {
+    index_.erase(lru_.back().first);
+    lru_.pop_back();
+    ++stats_.evictions;
+    GMA_METRIC_HIT("plan_cache.evict");
+  }
+  publishLocked();
+  return plan;
+}
+
+void PlanCache::clear() {
+  std::lock_guard<std::mutex> lk(mx_);
+  lru_.clear();
+  index_.clear();
+  publishLocked();
+}
+
+PlanCache::Stats PlanCache::stats() const {
+  std::lock_guard<std::mutex> lk(mx_);
+  Stats s = stats_;
+  s.size = lru_.size();
+  return s;
+}
+
+void PlanCache::dropIfStaleLocked() {
+  const auto nodeGen = engine::NodeTypeRegistry::generation();
+  const auto fnGen   = FunctionMap::instance().generation();
+  if (nodeGen == nodeGen_ && fnGen == fnGen_) return;
+  nodeGen_ = nodeGen;
+  fnGen_   = fnGen;
+  lru_.clear();
+  index_.clear();
+}
+
+void PlanCache::publishLocked() {
+  GMA_METRIC_SET("plan_cache.size", static_cast<double>(lru_.size()));
+  const auto lookups = stats_.hits + stats_.misses;
+  if (lookups > 0)
+    GMA_METRIC_SET("plan_cache.hit_rate",
+                   static_cast<double>(stats_.hits) / static_cast<double>(lookups));
+}
+
+} // namespace gma::tree
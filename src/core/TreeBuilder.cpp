@@ -6,6 +6,7 @@
 #include <numeric>
 #include <cmath>
 #include <limits>
+#include <optional>
 
 // Node types
 #include "gma/nodes/Listener.hpp"
@@ -17,6 +18,7 @@
 #include "gma/nodes/BucketTime.hpp"
 #include "gma/nodes/TumblingWindow.hpp"
 #include "gma/nodes/VectorReducer.hpp"
+#include "gma/nodes/Expr.hpp"
 
 // Runtime deps
 #include "gma/AtomicStore.hpp"
@@ -221,7 +223,7 @@ std::shared_ptr<gma::INode> buildSimple(const std::string&      streamKey,
     if (!pool)
       throw std::runtime_error("buildSimple: no thread pool available");
     auto interval = std::make_shared<gma::Interval>(
-        std::chrono::milliseconds(pollMs), accessor, pool);
+        std::chrono::milliseconds(pollMs), accessor, pool, deps.clock);
     interval->start();
     return interval;
   }
@@ -229,10 +231,28 @@ std::shared_ptr<gma::INode> buildSimple(const std::string&      streamKey,
 
 }
 
-// High-level entry: request JSON -> Listener head wired into optional pipeline -> terminal
-BuiltChain buildForRequest(const rapidjson::Value&      requestJson,
-                           const Deps&                  deps,
-                           std::shared_ptr<gma::INode>  terminal) {
+NodeFactory compileOne(const rapidjson::Value& spec) {
+  const auto& v    = expectObj(spec, "node");
+  const std::string type = expectType(v);
+
+  if (const auto* compiler = gma::engine::NodeTypeRegistry::findCompiler(type))
+    return (*compiler)(v);
+
+  if (const auto* builder = gma::engine::NodeTypeRegistry::find(type)) {
+    // Builder-only type: no parse-once form, so keep a private copy of the
+    // spec (the caller's document may not outlive the plan) and replay it.
+    auto doc = std::make_shared<rapidjson::Document>();
+    doc->CopyFrom(v, doc->GetAllocator());
+    return [fn = *builder, doc](const std::string& defaultStreamKey,
+                                const Deps& deps,
+                                std::shared_ptr<gma::INode> downstream) {
+      return fn(*doc, defaultStreamKey, deps, std::move(downstream));
+    };
+  }
+  throw std::runtime_error("TreeBuilder: unknown node type '" + type + "'");
+}
+
+std::shared_ptr<const RequestPlan> compileRequest(const rapidjson::Value& requestJson) {
   const auto& rq = expectObj(requestJson, "request");
 
   if (!rq.HasMember("streamKey") || !rq["streamKey"].IsString())
@@ -240,14 +260,36 @@ BuiltChain buildForRequest(const rapidjson::Value&      requestJson,
   if (!rq.HasMember("field") || !rq["field"].IsString())
     throw std::runtime_error("buildForRequest: missing 'field'");
 
-  const std::string streamKey = rq["streamKey"].GetString();
-  const std::string field     = rq["field"].GetString();
+  auto plan = std::make_shared<RequestPlan>();
+  plan->streamKey = rq["streamKey"].GetString();
+  plan->field     = rq["field"].GetString();
 
-  if (streamKey.empty())
+  if (plan->streamKey.empty())
     throw std::runtime_error("buildForRequest: 'streamKey' must not be empty");
-  if (field.empty())
+  if (plan->field.empty())
     throw std::runtime_error("buildForRequest: 'field' must not be empty");
 
+  // Single node under "node"
+  if (rq.HasMember("node") && rq["node"].IsObject())
+    plan->node = compileOne(rq["node"]);
+
+  // Or an array pipeline under "pipeline" or "stages"
+  const char* pipeKeys[] = {"pipeline", "stages"};
+  for (const char* k : pipeKeys) {
+    if (rq.HasMember(k) && rq[k].IsArray()) {
+      for (const auto& stage : rq[k].GetArray())
+        plan->pipeline.push_back(compileOne(stage));
+      plan->hasPipeline = true;
+      break;
+    }
+  }
+  plan->cost = estimateRequestCost(rq);
+  return plan;
+}
+
+BuiltChain buildFromPlan(const RequestPlan&           plan,
+                         const Deps&                  deps,
+                         std::shared_ptr<gma::INode>  terminal) {
   if (!terminal)
     throw std::runtime_error("buildForRequest: terminal node cannot be null");
 
@@ -258,39 +300,30 @@ BuiltChain buildForRequest(const rapidjson::Value&      requestJson,
   // Optional mid-pipeline, ultimately forwarding into terminal
   std::shared_ptr<gma::INode> midHead = terminal;
 
-  // Single node under "node"
-  if (rq.HasMember("node") && rq["node"].IsObject()) {
-    midHead = buildOne(rq["node"], streamKey, deps, terminal);
+  if (plan.node) {
+    midHead = plan.node(plan.streamKey, deps, terminal);
     keepAlive.push_back(midHead);
   }
 
-  // Or an array pipeline under "pipeline" or "stages"
-  const char* pipeKeys[] = {"pipeline", "stages"};
-  for (const char* k : pipeKeys) {
-    if (rq.HasMember(k) && rq[k].IsArray()) {
-      auto curDown = terminal;
-      const auto& arr = rq[k];
-      for (size_t i = arr.Size(); i > 0; --i) {
-        curDown = buildOne(arr[static_cast<rapidjson::SizeType>(i - 1)],
-                           streamKey,
-                           deps,
-                           curDown);
-        keepAlive.push_back(curDown);
-      }
-      midHead = curDown;
-      break;
+  if (plan.hasPipeline) {
+    auto curDown = terminal;
+    for (auto it = plan.pipeline.rbegin(); it != plan.pipeline.rend(); ++it) {
+      curDown = (*it)(plan.streamKey, deps, curDown);
+      keepAlive.push_back(curDown);
     }
+    midHead = curDown;
   }
 
   if (!deps.dispatcher || !deps.pool)
     throw std::runtime_error("buildForRequest: missing dispatcher/pool");
 
   using gma::nodes::Listener;
-  auto headRes = Listener::Create(streamKey,
-                                  field,
+  auto headRes = Listener::Create(plan.streamKey,
+                                  plan.field,
                                   midHead,
                                   deps.pool,
-                                  deps.dispatcher);
+                                  deps.dispatcher,
+                                  deps.credit);
   if (!headRes) {
     // Propagate the ENC-101 reject (and any future Listener::Create
     // pre-flight errors) up through ClientSession's
@@ -308,95 +341,114 @@ BuiltChain buildForRequest(const rapidjson::Value&      requestJson,
   return out;
 }
 
+// High-level entry: request JSON -> Listener head wired into optional pipeline -> terminal
+BuiltChain buildForRequest(const rapidjson::Value&      requestJson,
+                           const Deps&                  deps,
+                           std::shared_ptr<gma::INode>  terminal) {
+  return buildFromPlan(*compileRequest(requestJson), deps, std::move(terminal));
+}
+
 } // namespace gma::tree
 
 // ---------- Builtin node-type registrations ----------
 //
-// Each entry below wraps the equivalent of the old buildOne if-branch in a
-// lambda and publishes it to NodeTypeRegistry. Registration is idempotent on
-// duplicates (registerNodeType returns false) so this function is safe to
-// call repeatedly.
+// Each entry is a compiler: it parses and checks the spec and resolves what
+// it names once, then returns the factory that constructs the node. The
+// registry derives the one-shot builder from it, so buildOne() and cached
+// plans share one implementation. Registration is idempotent on duplicates
+// (returns false) so this function is safe to call repeatedly.
 namespace gma {
 
+namespace {
+
+using tree::NodeFactory;
+
+// Explicit "streamKey" in the spec, else the caller's default at build time.
+std::optional<std::string> optStr(const rapidjson::Value& v, const char* k) {
+  if (v.HasMember(k) && v[k].IsString()) return std::string(v[k].GetString());
+  return std::nullopt;
+}
+
+rt::ThreadPool* poolOrGlobal(const tree::Deps& deps) {
+  rt::ThreadPool* pool = deps.pool;
+  if (!pool && gThreadPool) pool = gThreadPool.get();
+  return pool;
+}
+
+// Shared by Interval / BucketTime: period plus optional "child" sub-spec.
+template <typename TimerNode>
+NodeFactory compileTimerSource(const rapidjson::Value& v, const char* name) {
+  int ms = intOr(v, "ms", intOr(v, "periodMs", 0));
+  if (ms <= 0)
+    throw std::runtime_error(std::string(name) + ": positive 'ms' required");
+  static constexpr int MAX_TIMER_MS = 3600000;
+  if (ms > MAX_TIMER_MS)
+    throw std::runtime_error(std::string(name) + ": 'ms' exceeds maximum (3600000)");
+
+  NodeFactory child;
+  if (v.HasMember("child")) child = tree::compileOne(v["child"]);
+
+  return [ms, child, name = std::string(name)](const std::string& defaultStreamKey,
+                                               const tree::Deps& deps,
+                                               std::shared_ptr<INode> downstream)
+             -> std::shared_ptr<INode> {
+    rt::ThreadPool* pool = poolOrGlobal(deps);
+    if (!pool)
+      throw std::runtime_error(name + ": no thread pool available");
+
+    auto target = downstream;
+    if (child) target = child(defaultStreamKey, deps, downstream);
+
+    auto node = std::make_shared<TimerNode>(
+        std::chrono::milliseconds(ms), target, pool, deps.clock);
+    node->start();
+    return node;
+  };
+}
+
+} // namespace
+
 void registerBuiltinNodeTypes() {
   using gma::engine::NodeTypeRegistry;
-  using gma::engine::NodeBuilderFn;
-
-  NodeTypeRegistry::registerNodeType("Listener",
-    [](const rapidjson::Value& v, const std::string& defaultStreamKey,
-       const tree::Deps& deps, std::shared_ptr<INode> downstream)
-        -> std::shared_ptr<INode> {
-      if (!deps.dispatcher || !deps.pool)
-        throw std::runtime_error("Listener: missing dispatcher/pool");
-
-      const std::string streamKey = strOr(v, "streamKey", defaultStreamKey);
-      const std::string field     = strOr(v, "field",  "");
-      if (streamKey.empty())
-        throw std::runtime_error("Listener: missing 'streamKey'");
-      if (field.empty())
-        throw std::runtime_error("Listener: missing 'field'");
-
-      using gma::nodes::Listener;
-      auto sp = std::make_shared<Listener>(streamKey, field, downstream,
-                                           deps.pool, deps.dispatcher);
-      sp->start();
-      return sp;
-    });
 
-  NodeTypeRegistry::registerNodeType("Interval",
-    [](const rapidjson::Value& v, const std::string& defaultStreamKey,
-       const tree::Deps& deps, std::shared_ptr<INode> downstream)
-        -> std::shared_ptr<INode> {
-      rt::ThreadPool* pool = deps.pool;
-      if (!pool && gThreadPool) pool = gThreadPool.get();
-      if (!pool)
-        throw std::runtime_error("Interval: no thread pool available");
+  NodeTypeRegistry::registerNodeCompiler("Listener",
+    [](const rapidjson::Value& v) -> NodeFactory {
+      auto streamKey = optStr(v, "streamKey");
+      const std::string field = strOr(v, "field", "");
+      return [streamKey, field](const std::string& defaultStreamKey,
+                                const tree::Deps& deps,
+                                std::shared_ptr<INode> downstream)
+                 -> std::shared_ptr<INode> {
+        if (!deps.dispatcher || !deps.pool)
+          throw std::runtime_error("Listener: missing dispatcher/pool");
+
+        const std::string& sk = streamKey ? *streamKey : defaultStreamKey;
+        if (sk.empty())
+          throw std::runtime_error("Listener: missing 'streamKey'");
+        if (field.empty())
+          throw std::runtime_error("Listener: missing 'field'");
+
+        using gma::nodes::Listener;
+        auto sp = std::make_shared<Listener>(sk, field, downstream,
+                                             deps.pool, deps.dispatcher,
+                                             deps.credit);
+        sp->start();
+        return sp;
+      };
+    });
 
-      int ms = intOr(v, "ms", intOr(v, "periodMs", 0));
-      if (ms <= 0)
-        throw std::runtime_error("Interval: positive 'ms' required");
-      static constexpr int MAX_INTERVAL_MS = 3600000;
-      if (ms > MAX_INTERVAL_MS)
-        throw std::runtime_error("Interval: 'ms' exceeds maximum (3600000)");
-
-      auto child = downstream;
-      if (v.HasMember("child"))
-        child = tree::buildOne(v["child"], defaultStreamKey, deps, downstream);
-
-      auto interval = std::make_shared<Interval>(
-          std::chrono::milliseconds(ms), child, pool);
-      interval->start();
-      return interval;
+  NodeTypeRegistry::registerNodeCompiler("Interval",
+    [](const rapidjson::Value& v) {
+      return compileTimerSource<Interval>(v, "Interval");
     });
 
   // BucketTime emits ticks aligned to wall-clock period boundaries (e.g.
   // ms=60000 ticks at every minute boundary regardless of when the node
   // was constructed). Same JSON shape as Interval — pipelines that need
   // alignment swap "Interval" for "BucketTime" without other changes.
-  NodeTypeRegistry::registerNodeType("BucketTime",
-    [](const rapidjson::Value& v, const std::string& defaultStreamKey,
-       const tree::Deps& deps, std::shared_ptr<INode> downstream)
-        -> std::shared_ptr<INode> {
-      rt::ThreadPool* pool = deps.pool;
-      if (!pool && gThreadPool) pool = gThreadPool.get();
-      if (!pool)
-        throw std::runtime_error("BucketTime: no thread pool available");
-
-      int ms = intOr(v, "ms", intOr(v, "periodMs", 0));
-      if (ms <= 0)
-        throw std::runtime_error("BucketTime: positive 'ms' required");
-      static constexpr int MAX_BUCKET_MS = 3600000;
-      if (ms > MAX_BUCKET_MS)
-        throw std::runtime_error("BucketTime: 'ms' exceeds maximum (3600000)");
-
-      auto child = downstream;
-      if (v.HasMember("child"))
-        child = tree::buildOne(v["child"], defaultStreamKey, deps, downstream);
-
-      auto bucket = std::make_shared<BucketTime>(
-          std::chrono::milliseconds(ms), child, pool);
-      bucket->start();
-      return bucket;
+  NodeTypeRegistry::registerNodeCompiler("BucketTime",
+    [](const rapidjson::Value& v) {
+      return compileTimerSource<BucketTime>(v, "BucketTime");
     });
 
   // TumblingWindow taps an upstream scalar stream, buffers per (streamKey)
@@ -405,15 +457,8 @@ void registerBuiltinNodeTypes() {
   // stage shape (no "child" / no "input" key) — wired via the standard
   // pipeline-array reverse-iteration in buildForRequest; the OUTER caller
   // passes `downstream`.
-  NodeTypeRegistry::registerNodeType("TumblingWindow",
-    [](const rapidjson::Value& v, const std::string& /*defaultStreamKey*/,
-       const tree::Deps& deps, std::shared_ptr<INode> downstream)
-        -> std::shared_ptr<INode> {
-      rt::ThreadPool* pool = deps.pool;
-      if (!pool && gThreadPool) pool = gThreadPool.get();
-      if (!pool)
-        throw std::runtime_error("TumblingWindow: no thread pool available");
-
+  NodeTypeRegistry::registerNodeCompiler("TumblingWindow",
+    [](const rapidjson::Value& v) -> NodeFactory {
       int ms = intOr(v, "ms", intOr(v, "periodMs", 0));
       if (ms <= 0)
         throw std::runtime_error("TumblingWindow: positive 'periodMs' required");
@@ -421,10 +466,18 @@ void registerBuiltinNodeTypes() {
       if (ms > MAX_TUMBLING_MS)
         throw std::runtime_error("TumblingWindow: 'periodMs' exceeds maximum (3600000)");
 
-      auto tw = std::make_shared<TumblingWindow>(
-          std::chrono::milliseconds(ms), downstream, pool);
-      tw->start();
-      return tw;
+      return [ms](const std::string& /*defaultStreamKey*/,
+                  const tree::Deps& deps,
+                  std::shared_ptr<INode> downstream) -> std::shared_ptr<INode> {
+        rt::ThreadPool* pool = poolOrGlobal(deps);
+        if (!pool)
+          throw std::runtime_error("TumblingWindow: no thread pool available");
+
+        auto tw = std::make_shared<TumblingWindow>(
+            std::chrono::milliseconds(ms), downstream, pool, deps.clock);
+        tw->start();
+        return tw;
+      };
     });
 
   // VectorReducer consumes one StreamValue{vector<double>} per upstream
@@ -433,10 +486,8 @@ void registerBuiltinNodeTypes() {
   // stage shape; reuses the same registry Worker resolves through, but
   // consumes FunctionMap's native double(vector<double>) signature
   // directly — no variant-typed adapter needed.
-  NodeTypeRegistry::registerNodeType("VectorReducer",
-    [](const rapidjson::Value& v, const std::string& /*defaultStreamKey*/,
-       const tree::Deps& /*deps*/, std::shared_ptr<INode> downstream)
-        -> std::shared_ptr<INode> {
+  NodeTypeRegistry::registerNodeCompiler("VectorReducer",
+    [](const rapidjson::Value& v) -> NodeFactory {
       if (!v.HasMember("fn") || !v["fn"].IsString())
         throw std::runtime_error("VectorReducer: missing 'fn'");
       const std::string fn = v["fn"].GetString();
@@ -446,93 +497,183 @@ void registerBuiltinNodeTypes() {
       } catch (...) {
         throw std::runtime_error("VectorReducer: unknown fn '" + fn + "'");
       }
-      return std::make_shared<VectorReducer>(std::move(reducer), downstream);
+      return [reducer](const std::string&, const tree::Deps&,
+                       std::shared_ptr<INode> downstream) -> std::shared_ptr<INode> {
+        return std::make_shared<VectorReducer>(reducer, downstream);
+      };
     });
 
-  NodeTypeRegistry::registerNodeType("AtomicAccessor",
-    [](const rapidjson::Value& v, const std::string& defaultStreamKey,
-       const tree::Deps& deps, std::shared_ptr<INode> downstream)
-        -> std::shared_ptr<INode> {
-      if (!deps.store)
-        throw std::runtime_error("AtomicAccessor: missing store");
-
-      const std::string streamKey = strOr(v, "streamKey", defaultStreamKey);
-      const std::string field     = strOr(v, "field",  "");
-      if (field.empty())
-        throw std::runtime_error("AtomicAccessor: missing 'field'");
-
-      return std::make_shared<AtomicAccessor>(streamKey, field, deps.store, downstream);
+  NodeTypeRegistry::registerNodeCompiler("AtomicAccessor",
+    [](const rapidjson::Value& v) -> NodeFactory {
+      auto streamKey = optStr(v, "streamKey");
+      const std::string field = strOr(v, "field", "");
+      return [streamKey, field](const std::string& defaultStreamKey,
+                                const tree::Deps& deps,
+                                std::shared_ptr<INode> downstream)
+                 -> std::shared_ptr<INode> {
+        if (!deps.store)
+          throw std::runtime_error("AtomicAccessor: missing store");
+        if (field.empty())
+          throw std::runtime_error("AtomicAccessor: missing 'field'");
+
+        return std::make_shared<AtomicAccessor>(
+            streamKey ? *streamKey : defaultStreamKey, field, deps.store, downstream);
+      };
     });
 
-  NodeTypeRegistry::registerNodeType("Worker",
-    [](const rapidjson::Value& v, const std::string&,
-       const tree::Deps&, std::shared_ptr<INode> downstream)
-        -> std::shared_ptr<INode> {
+  NodeTypeRegistry::registerNodeCompiler("Worker",
+    [](const rapidjson::Value& v) -> NodeFactory {
       auto fn = fnFromName(v);
-      return std::make_shared<Worker>(std::move(fn), downstream);
+      return [fn](const std::string&, const tree::Deps&,
+                  std::shared_ptr<INode> downstream) -> std::shared_ptr<INode> {
+        return std::make_shared<Worker>(fn, downstream);
+      };
     });
 
-  NodeTypeRegistry::registerNodeType("Aggregate",
-    [](const rapidjson::Value& v, const std::string& defaultStreamKey,
-       const tree::Deps& deps, std::shared_ptr<INode> downstream)
-        -> std::shared_ptr<INode> {
+  NodeTypeRegistry::registerNodeCompiler("Aggregate",
+    [](const rapidjson::Value& v) -> NodeFactory {
       std::size_t arity = sizeOr(v, "arity", 0);
       if (arity == 0)
         throw std::runtime_error("Aggregate: positive 'arity' required");
 
-      auto agg = std::make_shared<Aggregate>(arity, downstream);
-
       if (!v.HasMember("inputs") || !v["inputs"].IsArray())
         throw std::runtime_error("Aggregate: 'inputs' must be an array");
 
-      const auto& inputArr = v["inputs"];
-      std::vector<std::shared_ptr<INode>> roots;
-      roots.reserve(inputArr.Size() + 1);
-      for (auto& it : inputArr.GetArray())
-        roots.push_back(tree::buildOne(it, defaultStreamKey, deps, agg));
-      if (roots.empty())
+      std::vector<NodeFactory> inputs;
+      for (auto& it : v["inputs"].GetArray())
+        inputs.push_back(tree::compileOne(it));
+      if (inputs.empty())
         throw std::runtime_error("Aggregate: empty 'inputs' array");
 
-      // Keep Aggregate alive alongside input heads — Listeners hold only a
-      // weak_ptr to their downstream, so without this the Aggregate would be
-      // destroyed when the local shared_ptr goes out of scope.
-      roots.push_back(agg);
+      return [arity, inputs](const std::string& defaultStreamKey,
+                             const tree::Deps& deps,
+                             std::shared_ptr<INode> downstream)
+                 -> std::shared_ptr<INode> {
+        auto agg = std::make_shared<Aggregate>(arity, downstream);
+
+        std::vector<std::shared_ptr<INode>> roots;
+        roots.reserve(inputs.size() + 1);
+        for (const auto& input : inputs)
+          roots.push_back(input(defaultStreamKey, deps, agg));
+
+        // Keep Aggregate alive alongside input heads — Listeners hold only a
+        // weak_ptr to their downstream, so without this the Aggregate would be
+        // destroyed when the local shared_ptr goes out of scope.
+        roots.push_back(agg);
+
+        if (roots.size() == 1) return roots.front();
+        return std::make_shared<CompositeRoot>(std::move(roots));
+      };
+    });
+
+  // Expr joins N named input branches into one scalar computed by an
+  // arithmetic expression compiled here, once, at build time:
+  //
+  //   {"type":"Expr", "expr":"(bid - ask) / mid",
+  //    "inputs":{"bid":{"type":"Listener","field":"bid"},
+  //              "ask":{"type":"Listener","field":"ask"},
+  //              "mid":{"type":"AtomicAccessor","field":"mid"}},
+  //    "join":"latest"}
+  //
+  // Listener inputs push; every other input is pulled when the Expr itself
+  // receives an upstream value. "join":"aligned" (+ optional "toleranceMs")
+  // waits for a fresh value on every input before each evaluation.
+  NodeTypeRegistry::registerNodeCompiler("Expr",
+    [](const rapidjson::Value& v) -> NodeFactory {
+      if (!v.HasMember("expr") || !v["expr"].IsString())
+        throw std::runtime_error("Expr: missing 'expr'");
+      if (!v.HasMember("inputs") || !v["inputs"].IsObject())
+        throw std::runtime_error("Expr: 'inputs' must be an object");
+
+      const auto& inputs = v["inputs"];
+      if (inputs.MemberCount() == 0)
+        throw std::runtime_error("Expr: empty 'inputs' object");
+      if (inputs.MemberCount() > Expr::MAX_INPUTS)
+        throw std::runtime_error("Expr: too many inputs (max 16)");
+
+      std::vector<std::string> names;
+      names.reserve(inputs.MemberCount());
+      for (auto it = inputs.MemberBegin(); it != inputs.MemberEnd(); ++it)
+        names.emplace_back(it->name.GetString());
+
+      util::ExprProgram program;
+      try {
+        program = util::ExprProgram::compile(v["expr"].GetString(), names);
+      } catch (const std::exception& ex) {
+        throw std::runtime_error(std::string("Expr: ") + ex.what());
+      }
 
-      if (roots.size() == 1) return roots.front();
-      return std::make_shared<CompositeRoot>(std::move(roots));
+      const std::string join = strOr(v, "join", "latest");
+      Expr::JoinMode mode;
+      if (join == "latest")       mode = Expr::JoinMode::Latest;
+      else if (join == "aligned") mode = Expr::JoinMode::Aligned;
+      else throw std::runtime_error("Expr: 'join' must be \"latest\" or \"aligned\"");
+
+      const int tolMs = intOr(v, "toleranceMs", 0);
+      static constexpr int MAX_TOLERANCE_MS = 3600000;
+      if (tolMs < 0 || tolMs > MAX_TOLERANCE_MS)
+        throw std::runtime_error("Expr: 'toleranceMs' must be in [0, 3600000]");
+
+      struct Input { NodeFactory build; bool pull; };
+      std::vector<Input> heads;
+      heads.reserve(names.size());
+      for (auto it = inputs.MemberBegin(); it != inputs.MemberEnd(); ++it) {
+        const bool pull = std::string(expectType(it->value)) != "Listener";
+        heads.push_back({tree::compileOne(it->value), pull});
+      }
+
+      return [streamKey = optStr(v, "streamKey"), program = std::move(program),
+              mode, tolMs, heads = std::move(heads)](
+                 const std::string& defaultStreamKey,
+                 const tree::Deps& deps,
+                 std::shared_ptr<INode> downstream) -> std::shared_ptr<INode> {
+        auto node = std::make_shared<Expr>(
+            streamKey ? *streamKey : defaultStreamKey, program,
+            heads.size(), mode, std::chrono::milliseconds(tolMs), downstream,
+            deps.clock);
+
+        // A failing input must not leave earlier Listener inputs registered
+        // with the dispatcher — shut down what was attached so far.
+        try {
+          for (std::size_t slot = 0; slot < heads.size(); ++slot) {
+            auto head = heads[slot].build(defaultStreamKey, deps,
+                                          node->inputSink(slot, heads[slot].pull));
+            node->attachInput(slot, std::move(head));
+          }
+        } catch (...) {
+          node->shutdown();
+          throw;
+        }
+        return node;
+      };
     });
 
   // Canonical name "GroupSplit"; "SymbolSplit" registered as a legacy alias
   // for back-compat with pre-rename request payloads (Q5 of the engine /
   // connector split decision matrix). Drop the alias when the deprecation
   // window closes.
-  auto groupSplitBuilder =
-    [](const rapidjson::Value& v, const std::string& defaultStreamKey,
-       const tree::Deps& deps, std::shared_ptr<INode> downstream)
-        -> std::shared_ptr<INode> {
-      if (!v.HasMember("child"))
-        throw std::runtime_error("GroupSplit: missing 'child'");
-
-      // Deep-copy so the factory lambda owns the JSON independently of the
-      // caller's stack-local Document.
-      auto childDoc = std::make_shared<rapidjson::Document>();
-      childDoc->CopyFrom(v["child"], childDoc->GetAllocator());
-
+  auto groupSplitCompiler = [](const rapidjson::Value& v) -> NodeFactory {
+    if (!v.HasMember("child"))
+      throw std::runtime_error("GroupSplit: missing 'child'");
+
+    // The child is compiled once here; every per-key instance the split
+    // creates later is built from the same factory, without touching JSON.
+    auto child = tree::compileOne(v["child"]);
+    return [child](const std::string& defaultStreamKey,
+                   const tree::Deps& deps,
+                   std::shared_ptr<INode> downstream) -> std::shared_ptr<INode> {
       GroupSplit::Factory f =
-        [childDoc, defaultStreamKey, deps, downstream](const std::string& sym) {
-          return tree::buildOne(*childDoc,
-                                sym.empty() ? defaultStreamKey : sym,
-                                deps, downstream);
+        [child, defaultStreamKey, deps, downstream](const std::string& sym) {
+          return child(sym.empty() ? defaultStreamKey : sym, deps, downstream);
         };
       return std::make_shared<GroupSplit>(std::move(f));
     };
-  NodeTypeRegistry::registerNodeType("GroupSplit", groupSplitBuilder);
-  NodeTypeRegistry::registerNodeType("SymbolSplit", groupSplitBuilder);
+  };
+  NodeTypeRegistry::registerNodeCompiler("GroupSplit", groupSplitCompiler);
+  NodeTypeRegistry::registerNodeCompiler("SymbolSplit", groupSplitCompiler);
 
-  NodeTypeRegistry::registerNodeType("Chain",
-    [](const rapidjson::Value& v, const std::string& defaultStreamKey,
-       const tree::Deps& deps, std::shared_ptr<INode> downstream)
-        -> std::shared_ptr<INode> {
+  NodeTypeRegistry::registerNodeCompiler("Chain",
+    [](const rapidjson::Value& v) -> NodeFactory {
       if (!v.HasMember("stages") || !v["stages"].IsArray())
         throw std::runtime_error("Chain: 'stages' must be an array");
 
@@ -540,12 +681,19 @@ void registerBuiltinNodeTypes() {
       if (stages.Size() == 0)
         throw std::runtime_error("Chain: 'stages' must not be empty");
 
-      auto curDown = downstream;
-      for (size_t i = stages.Size(); i > 0; --i) {
-        curDown = tree::buildOne(stages[static_cast<rapidjson::SizeType>(i - 1)],
-                                 defaultStreamKey, deps, curDown);
-      }
-      return curDown;
+      std::vector<NodeFactory> compiled;
+      compiled.reserve(stages.Size());
+      for (const auto& stage : stages.GetArray())
+        compiled.push_back(tree::compileOne(stage));
+
+      return [compiled](const std::string& defaultStreamKey,
+                        const tree::Deps& deps,
+                        std::shared_ptr<INode> downstream) -> std::shared_ptr<INode> {
+        auto curDown = downstream;
+        for (auto it = compiled.rbegin(); it != compiled.rend(); ++it)
+          curDown = (*it)(defaultStreamKey, deps, curDown);
+        return curDown;
+      };
     });
 }
 
@@ -1,7 +1,12 @@
 // File: src/main.cpp
+#include <chrono>
+#include <cmath>
 #include <csignal>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <vector>
@@ -15,12 +20,18 @@
 #include "gma/FunctionRegistry.hpp"
 #include "gma/Dispatcher.hpp"
 #include "gma/NodeRegistry.hpp"
+#include "gma/TreeBuilder.hpp"
 #include "gma/atomic/AtomicProviderRegistry.hpp"
 #include "gma/engine/Registries.hpp"
+#include "gma/nodes/Responder.hpp"
+#include "gma/rt/Clock.hpp"
+#include "gma/rt/ReplayDriver.hpp"
 #include "gma/rt/ThreadPool.hpp"
 #include "gma/runtime/ShutdownCoordinator.hpp"
+#include "gma/server/Admission.hpp"
 #include "gma/server/WebSocketServer.hpp"
 #include "gma/util/Config.hpp"
+#include "gma/util/JsonUtil.hpp"
 #include "gma/util/Logger.hpp"
 #include "gma/util/Metrics.hpp"
 
@@ -50,12 +61,143 @@ static unsigned short parsePort(const char* str, unsigned short fallback) {
   }
 }
 
+// ---------------------------
+// Replay mode
+// ---------------------------
+// gma_server --replay <recording.jsonl> <request.json> [--config <file>] [--until <epoch ms>]
+//
+// Runs one subscribe request (the object a client sends: streamKey, field,
+// node / pipeline) over a recording on a simulated clock and an inline
+// pool, and prints every value the tree emits as a JSON line
+// {"ts":<epoch ms>,"streamKey":...,"value":...}. No sockets are opened and
+// no connector is started; the run is as fast as the CPU allows and its
+// output depends on the recording alone (docs/replay.md). --until fires the
+// timers still due after the last event, flushing a trailing bucket.
+static int runReplay(int argc, char* argv[]) {
+  using namespace gma::util;
+
+  if (argc < 4) {
+    std::cerr << "usage: " << argv[0]
+              << " --replay <recording.jsonl> <request.json> [--config <file>] [--until <epoch ms>]\n";
+    return EXIT_FAILURE;
+  }
+  Config cfg;
+  long long untilMs = -1;
+  for (int i = 4; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--config") == 0) {
+      if (!cfg.loadFromFile(argv[i + 1])) {
+        std::cerr << "[config] warning: failed to load file: " << argv[i + 1] << "\n";
+      }
+    } else if (std::strcmp(argv[i], "--until") == 0) {
+      try { untilMs = std::stoll(argv[i + 1]); } catch (...) { untilMs = -1; }
+    }
+  }
+
+  std::ifstream recording(argv[2]);
+  if (!recording) {
+    std::cerr << "[replay] cannot open recording: " << argv[2] << "\n";
+    return EXIT_FAILURE;
+  }
+  std::ifstream requestFile(argv[3]);
+  const std::string requestText((std::istreambuf_iterator<char>(requestFile)),
+                                std::istreambuf_iterator<char>());
+  rapidjson::Document request;
+  request.Parse(requestText.c_str());
+  if (!requestFile || request.HasParseError() || !request.IsObject()) {
+    std::cerr << "[replay] request is not a JSON object: " << argv[3] << "\n";
+    return EXIT_FAILURE;
+  }
+
+  const auto start = gma::rt::ReplayDriver::firstTimestamp(recording);
+  if (!start) {
+    std::cerr << "[replay] no timestamped events in " << argv[2] << "\n";
+    return EXIT_FAILURE;
+  }
+
+  gma::registerBuiltinFunctions();
+  gma::registerBuiltinNodeTypes();
+
+  gma::rt::SimulatedClock clock(*start);
+  gma::gThreadPool = std::make_shared<gma::rt::ThreadPool>(gma::rt::ThreadPool::Inline);
+  gma::AtomicStore store;
+  gma::Dispatcher  dispatcher(gma::gThreadPool.get(), &store, cfg);
+
+  // The market connector supplies the tick computers; it is registered
+  // (so config keys and event computers match a live run) but never
+  // started.
+  gma::rt::ShutdownCoordinator shutdown;
+  boost::asio::io_context ioc;
+  gma::engine::EngineRegistries regs{
+    &cfg, gma::gThreadPool.get(), &store, &dispatcher, &shutdown, &ioc,
+    &gma::engine::EventTypeRegistry::singleton(),
+    &gma::engine::EventComputerRegistry::singleton(),
+    &gma::engine::NodeTypeRegistry::singleton(),
+    &gma::engine::IngressRegistry::singleton(),
+    &gma::engine::StreamRegistry::singleton(),
+    &gma::engine::ConfigNamespaceRegistry::singleton(),
+    &gma::AtomicProviderRegistry::singleton(),
+    &gma::FunctionMap::instance(),
+    &gma::util::logger(),
+  };
+  gma::market::MarketConnector marketConnector;
+  marketConnector.registerWith(regs);
+  cfg.dispatchPendingKeys();
+
+  auto print = [&clock](const gma::server::RequestKey&, const gma::StreamValue& sv) {
+    rapidjson::StringBuffer sb;
+    rapidjson::Writer<rapidjson::StringBuffer> w(sb);
+    w.StartObject();
+    w.Key("ts");
+    w.Int64(std::chrono::duration_cast<std::chrono::milliseconds>(
+                clock.now().time_since_epoch()).count());
+    w.Key("streamKey"); w.String(sv.symbol.c_str());
+    // Warming-up indicators are NaN, which JSON cannot carry; print null.
+    const double* d = std::get_if<double>(&sv.value);
+    w.Key("value");
+    if (d && !std::isfinite(*d)) w.Null();
+    else                         writeArgTypeJson(w, sv.value);
+    w.EndObject();
+    std::cout << sb.GetString() << '\n';
+  };
+
+  gma::tree::Deps deps;
+  deps.store      = &store;
+  deps.pool       = gma::gThreadPool.get();
+  deps.dispatcher = &dispatcher;
+  deps.clock      = &clock;
+
+  gma::tree::BuiltChain chain;
+  try {
+    chain = gma::tree::buildForRequest(
+        request, deps, std::make_shared<gma::nodes::Responder>(print, gma::server::requestKeyInt(0)));
+  } catch (const std::exception& ex) {
+    std::cerr << "[replay] invalid request: " << ex.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  gma::rt::ReplayDriver driver(dispatcher, clock);
+  driver.replayJsonl(recording);
+  if (untilMs >= 0)
+    driver.finish(gma::rt::Clock::time_point{std::chrono::milliseconds{untilMs}});
+  if (chain.head) chain.head->shutdown();
+  std::cout.flush();
+
+  const auto& stats = driver.stats();
+  logger().log(LogLevel::Info, "replay.done",
+               {{"events", std::to_string(stats.events)},
+                {"rejected", std::to_string(stats.rejected)},
+                {"timers", std::to_string(stats.timers)}});
+  return EXIT_SUCCESS;
+}
+
 // ---------------------------
 // main
 // ---------------------------
 int main(int argc, char* argv[]) {
   using namespace gma::util;
 
+  if (argc > 1 && std::strcmp(argv[1], "--replay") == 0) return runReplay(argc, argv);
+
   // Shutdown coordinator — declared early so it outlives servers.
   gma::rt::ShutdownCoordinator shutdown;
   g_shutdown.store(&shutdown, std::memory_order_release);
@@ -133,7 +275,12 @@ int main(int argc, char* argv[]) {
 
   // 7) ASIO + engine WebSocket server
   boost::asio::io_context ioc;
-  gma::ExecutionContext exec(store.get(), gma::gThreadPool.get());
+  using gma::server::AdmissionController;
+  AdmissionController admission(
+      AdmissionController::budget(cfg.admissionCpu, cfg.admissionMemoryMB, cfg.admissionTimers),
+      AdmissionController::budget(cfg.admissionSessionCpu, cfg.admissionSessionMemoryMB,
+                                  cfg.admissionSessionTimers));
+  gma::ExecutionContext exec(store.get(), gma::gThreadPool.get(), &admission);
 
   gma::WebSocketServer ws(ioc, &exec, dispatcher.get(), wsPort);
   ws.run();
@@ -151,6 +298,7 @@ int main(int argc, char* argv[]) {
     &gma::engine::EventComputerRegistry::singleton(),
     &gma::engine::NodeTypeRegistry::singleton(),
     &gma::engine::IngressRegistry::singleton(),
+    &gma::engine::StreamRegistry::singleton(),
     &gma::engine::ConfigNamespaceRegistry::singleton(),
     &gma::AtomicProviderRegistry::singleton(),
     &gma::FunctionMap::instance(),
@@ -11,7 +11,9 @@ AtomicAccessor::AtomicAccessor(std::string symbol,
   , field_(std::move(field))
   , store_(store)
   , downstream_(std::move(downstream))
-{}
+{
+  plan_ = AtomicProviderRegistry::compile(field_);
+}
 
 void AtomicAccessor::onValue(const StreamValue&) {
   // Early-out on stopping_ is an optimization; correctness is guaranteed by
@@ -24,9 +26,15 @@ void AtomicAccessor::onValue(const StreamValue&) {
 
   // If not found in the store, try connector-registered namespace providers
   if (!opt.has_value()) {
-    auto resolved = AtomicProviderRegistry::tryResolve(symbol_, field_);
-    if (resolved.has_value()) {
-      opt = resolved.value();
+    if (plan_) {
+      try {
+        opt = plan_(symbol_);
+      } catch (...) {}
+    } else {
+      auto resolved = AtomicProviderRegistry::tryResolve(symbol_, field_);
+      if (resolved.has_value()) {
+        opt = resolved.value();
+      }
     }
   }
 
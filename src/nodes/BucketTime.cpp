@@ -5,8 +5,10 @@ namespace gma {
 
 BucketTime::BucketTime(std::chrono::milliseconds period,
                        std::shared_ptr<INode> child,
-                       gma::rt::ThreadPool* pool)
+                       gma::rt::ThreadPool* pool,
+                       gma::rt::Clock* clock)
   : period_(period), child_(std::move(child)), pool_(pool)
+  , clock_(clock ? clock : &gma::rt::systemClock())
 {
 }
 
@@ -27,6 +29,11 @@ void BucketTime::start() {
   if (!started_.compare_exchange_strong(expected, true))
     return;
 
+  if (clock_->simulated()) {
+    armSimulated();
+    return;
+  }
+
   timerThread_ = std::thread([self = shared_from_this()] {
     self->timerLoop();
   });
@@ -55,7 +62,7 @@ void BucketTime::timerLoop() {
     if (stopping_.load(std::memory_order_acquire))
       break;
 
-    const auto now = std::chrono::system_clock::now();
+    const auto now = clock_->now();
     const auto target = nextAlignedAfter(now, period_);
     {
       std::unique_lock<std::mutex> lk(mx_);
@@ -70,21 +77,39 @@ void BucketTime::timerLoop() {
       break;
     if (!child_) break;
 
-    try {
-      if (pool_) {
-        auto c = child_;
-        pool_->post([c] { c->onValue(StreamValue{"", 0.0}); });
-      } else {
-        child_->onValue(StreamValue{"", 0.0});
-      }
-    } catch (const std::exception& ex) {
-      gma::util::logger().log(gma::util::LogLevel::Error,
-        "BucketTime::timerLoop: onValue exception",
-        {{"err", ex.what()}});
+    tick();
+  }
+}
+
+void BucketTime::tick() {
+  if (!child_) return;
+  try {
+    if (pool_) {
+      auto c = child_;
+      pool_->post([c] { c->onValue(StreamValue{"", 0.0}); });
+    } else {
+      child_->onValue(StreamValue{"", 0.0});
     }
+  } catch (const std::exception& ex) {
+    gma::util::logger().log(gma::util::LogLevel::Error,
+      "BucketTime::tick: onValue exception",
+      {{"err", ex.what()}});
   }
 }
 
+void BucketTime::armSimulated() {
+  auto* sim = clock_->simulated();
+  auto target = nextAlignedAfter(sim->now(), period_);
+  if (target <= sim->now()) target = sim->now() + std::chrono::milliseconds(1);
+  std::weak_ptr<BucketTime> weak = weak_from_this();
+  simTimer_.store(sim->schedule(target, [weak] {
+    auto self = weak.lock();
+    if (!self || self->stopping_.load(std::memory_order_acquire)) return;
+    self->tick();
+    if (!self->stopping_.load(std::memory_order_acquire)) self->armSimulated();
+  }), std::memory_order_release);
+}
+
 void BucketTime::onValue(const StreamValue&) {
   // source node: no upstream input
 }
@@ -92,6 +117,8 @@ void BucketTime::onValue(const StreamValue&) {
 void BucketTime::shutdown() noexcept {
   stopping_.store(true, std::memory_order_release);
   cv_.notify_all();
+  if (auto* sim = clock_->simulated())
+    sim->cancel(simTimer_.load(std::memory_order_acquire));
   if (timerThread_.joinable()) {
     if (timerThread_.get_id() == std::this_thread::get_id()) {
       timerThread_.detach();
@@ -0,0 +1,174 @@
+#include "gma/nodes/Expr.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace gma {
+
+// Per-slot adapter wired as an input head's downstream. Holds the Expr
+// weakly — the Expr owns its sinks, so a strong pointer would form a cycle.
+class Expr::Sink final : public INode {
+public:
+  Sink(std::weak_ptr<Expr> owner, std::size_t slot, bool pull)
+    : owner_(std::move(owner)), slot_(slot), pull_(pull) {}
+
+  void onValue(const StreamValue& sv) override {
+    if (auto e = owner_.lock()) e->onInput(slot_, sv, !pull_);
+  }
+  void shutdown() noexcept override {}
+
+private:
+  std::weak_ptr<Expr> owner_;
+  const std::size_t   slot_;
+  const bool          pull_;
+};
+
+namespace {
+
+// Numeric alternatives only; anything else is not joinable.
+bool numericValue(const ArgType& v, double& out) {
+  return std::visit([&out](auto&& x) -> bool {
+    using T = std::decay_t<decltype(x)>;
+    if constexpr (std::is_same_v<T, double>)    { out = x; return true; }
+    else if constexpr (std::is_same_v<T, int>)  { out = static_cast<double>(x); return true; }
+    else if constexpr (std::is_same_v<T, bool>) { out = x ? 1.0 : 0.0; return true; }
+    else return false;
+  }, v);
+}
+
+} // namespace
+
+Expr::Expr(std::string streamKey,
+           util::ExprProgram program,
+           std::size_t slotCount,
+           JoinMode mode,
+           std::chrono::milliseconds tolerance,
+           std::shared_ptr<INode> downstream,
+           gma::rt::Clock* clock)
+  : streamKey_(std::move(streamKey))
+  , program_(std::move(program))
+  , mode_(mode)
+  , tolerance_(tolerance)
+  , clock_(clock ? clock : &gma::rt::systemClock())
+  , slots_(slotCount)
+  , values_(slotCount, 0.0)
+  , stack_(std::max<std::size_t>(program_.stackDepth(), 1), 0.0)
+  , downstream_(std::move(downstream))
+{
+  if (slotCount == 0 || slotCount > MAX_INPUTS)
+    throw std::invalid_argument("Expr: input count must be in [1, 16]");
+}
+
+std::shared_ptr<INode> Expr::inputSink(std::size_t slot, bool pull) {
+  if (slot >= slots_.size())
+    throw std::out_of_range("Expr: input slot out of range");
+  auto sink = std::make_shared<Sink>(weak_from_this(), slot, pull);
+  std::lock_guard<std::mutex> lk(mx_);
+  slots_[slot].pull = pull;
+  slots_[slot].sink = sink;
+  return sink;
+}
+
+void Expr::attachInput(std::size_t slot, std::shared_ptr<INode> head) {
+  if (slot >= slots_.size())
+    throw std::out_of_range("Expr: input slot out of range");
+  std::lock_guard<std::mutex> lk(mx_);
+  slots_[slot].head = std::move(head);
+}
+
+void Expr::onInput(std::size_t slot, const StreamValue& sv, bool trigger) {
+  if (stopping_.load(std::memory_order_acquire)) return;
+  double v;
+  if (!numericValue(sv.value, v)) return;
+
+  double out;
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    if (slot >= slots_.size()) return;
+    auto& s   = slots_[slot];
+    values_[slot] = v;
+    s.at      = clock_->now();
+    s.seen    = true;
+    s.fresh   = true;
+    if (!trigger || !evaluateLocked(out)) return;
+  }
+  emit(out);
+}
+
+void Expr::onValue(const StreamValue& sv) {
+  if (stopping_.load(std::memory_order_acquire)) return;
+
+  // Refresh pull inputs outside the lock — their heads call back into
+  // onInput(), which takes it.
+  for (std::size_t i = 0; i < slots_.size(); ++i) {
+    std::shared_ptr<INode> head;
+    {
+      std::lock_guard<std::mutex> lk(mx_);
+      if (slots_[i].pull) head = slots_[i].head;
+    }
+    if (head) head->onValue(sv);
+  }
+
+  double out;
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    if (!evaluateLocked(out)) return;
+  }
+  emit(out);
+}
+
+bool Expr::evaluateLocked(double& out) {
+  if (mode_ == JoinMode::Latest) {
+    for (const auto& s : slots_)
+      if (!s.seen) return false;
+  } else {
+    gma::rt::Clock::time_point newest = gma::rt::Clock::time_point::min();
+    for (const auto& s : slots_) {
+      if (!s.fresh) return false;
+      newest = std::max(newest, s.at);
+    }
+    if (tolerance_.count() > 0) {
+      bool aligned = true;
+      for (auto& s : slots_) {
+        if (newest - s.at > tolerance_) {
+          s.fresh = false;
+          aligned = false;
+        }
+      }
+      if (!aligned) return false;
+    }
+    for (auto& s : slots_) s.fresh = false;
+  }
+
+  out = program_.eval(values_.data(), stack_.data());
+  return std::isfinite(out);
+}
+
+void Expr::emit(double v) {
+  std::shared_ptr<INode> ds;
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    ds = downstream_;
+  }
+  if (ds) ds->onValue(StreamValue{ streamKey_, ArgType{v} });
+}
+
+void Expr::shutdown() noexcept {
+  stopping_.store(true, std::memory_order_release);
+  std::vector<std::shared_ptr<INode>> heads;
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    for (auto& s : slots_) {
+      if (s.head) heads.push_back(std::move(s.head));
+      s.sink.reset();
+    }
+    downstream_.reset();
+  }
+  for (auto& h : heads) h->shutdown();
+}
+
+} // namespace gma
@@ -1,12 +1,16 @@
 #include "gma/nodes/Interval.hpp"
 #include "gma/util/Logger.hpp"
 
+#include <algorithm>
+
 namespace gma {
 
 Interval::Interval(std::chrono::milliseconds period,
                    std::shared_ptr<INode> child,
-                   gma::rt::ThreadPool* pool)
+                   gma::rt::ThreadPool* pool,
+                   gma::rt::Clock* clock)
   : period_(period), child_(std::move(child)), pool_(pool)
+  , clock_(clock ? clock : &gma::rt::systemClock())
 {
 }
 
@@ -30,6 +34,11 @@ void Interval::start() {
   if (!started_.compare_exchange_strong(expected, true))
     return; // already started
 
+  if (clock_->simulated()) {
+    armSimulated();
+    return;
+  }
+
   timerThread_ = std::thread([self = shared_from_this()] {
     self->timerLoop();
   });
@@ -51,21 +60,39 @@ void Interval::timerLoop() {
 
     if (!child_) break; // child gone, stop ticking
 
-    try {
-      if (pool_) {
-        auto c = child_;
-        pool_->post([c] { c->onValue(StreamValue{"", 0.0}); });
-      } else {
-        child_->onValue(StreamValue{"", 0.0});
-      }
-    } catch (const std::exception& ex) {
-      gma::util::logger().log(gma::util::LogLevel::Error,
-        "Interval::timerLoop: onValue exception",
-        {{"err", ex.what()}});
+    tick();
+  }
+}
+
+void Interval::tick() {
+  if (!child_) return;
+  try {
+    if (pool_) {
+      auto c = child_;
+      pool_->post([c] { c->onValue(StreamValue{"", 0.0}); });
+    } else {
+      child_->onValue(StreamValue{"", 0.0});
     }
+  } catch (const std::exception& ex) {
+    gma::util::logger().log(gma::util::LogLevel::Error,
+      "Interval::tick: onValue exception",
+      {{"err", ex.what()}});
   }
 }
 
+void Interval::armSimulated() {
+  auto* sim = clock_->simulated();
+  // A zero period would re-fire at the same instant forever; step >= 1ms.
+  const auto step = std::max(period_, std::chrono::milliseconds(1));
+  std::weak_ptr<Interval> weak = weak_from_this();
+  simTimer_.store(sim->schedule(sim->now() + step, [weak] {
+    auto self = weak.lock();
+    if (!self || self->stopping_.load(std::memory_order_acquire)) return;
+    self->tick();
+    if (!self->stopping_.load(std::memory_order_acquire)) self->armSimulated();
+  }), std::memory_order_release);
+}
+
 void Interval::onValue(const StreamValue&) {
   // source node: no upstream input
 }
@@ -73,6 +100,8 @@ void Interval::onValue(const StreamValue&) {
 void Interval::shutdown() noexcept {
   stopping_.store(true, std::memory_order_release);
   cv_.notify_all();
+  if (auto* sim = clock_->simulated())
+    sim->cancel(simTimer_.load(std::memory_order_acquire));
   if (timerThread_.joinable()) {
     // Mirror the destructor guard: if shutdown() is called from the timer
     // thread itself (e.g. via a downstream callback), join() would deadlock.
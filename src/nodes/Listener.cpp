@@ -2,15 +2,17 @@
 #include "gma/Dispatcher.hpp"
 #include "gma/rt/ThreadPool.hpp"
 #include "gma/util/Logger.hpp"
+#include "gma/util/Metrics.hpp"
 
 using namespace gma::nodes;
 
 namespace {
 
-// ENC-101: ob.* atomic keys are written by ob::Provider into the
-// AtomicStore but never push through Dispatcher::notifyListeners,
-// so a Listener bound to one of them registers and silently never
-// fires. Reject at construction time so the failure is loud.
+// ENC-101: ob.* atomic keys only push through
+// Dispatcher::notifyListeners when a subscription observer serves them
+// (the market connector's ob::PushMaterializer). Without one a Listener
+// bound to such a key registers and silently never fires, so reject at
+// construction time to make the failure loud.
 //
 // Literal 3-char prefix ('o','b','.') — not a starts_with("ob")
 // check, which would catch "obesity" or "obvious".
@@ -28,8 +30,9 @@ gma::Result<std::shared_ptr<Listener>> Listener::Create(
     std::string field,
     std::shared_ptr<INode> downstream,
     gma::rt::ThreadPool* pool,
-    gma::Dispatcher* dispatcher) {
-  if (isPipelineOnlyKey(field)) {
+    gma::Dispatcher* dispatcher,
+    std::shared_ptr<gma::rt::CreditGate> credit) {
+  if (isPipelineOnlyKey(field) && !(dispatcher && dispatcher->isObserved(field))) {
     return gma::Error{
       "listener: field '" + field +
         "' is pipeline-only — see docs/atomic-keys.md; bind via "
@@ -42,7 +45,8 @@ gma::Result<std::shared_ptr<Listener>> Listener::Create(
       std::move(field),
       std::move(downstream),
       pool,
-      dispatcher);
+      dispatcher,
+      std::move(credit));
   self->start();
   return self;
 }
@@ -51,12 +55,14 @@ Listener::Listener(std::string symbol,
                    std::string field,
                    std::shared_ptr<INode> downstream,
                    gma::rt::ThreadPool* pool,
-                   gma::Dispatcher* dispatcher)
+                   gma::Dispatcher* dispatcher,
+                   std::shared_ptr<gma::rt::CreditGate> credit)
   : symbol_(std::move(symbol))
   , field_(std::move(field))
   , downstream_(std::move(downstream))
   , pool_(pool)
   , dispatcher_(dispatcher)
+  , credit_(std::move(credit))
 {
 }
 
@@ -66,6 +72,13 @@ void Listener::start() {
   if (!started_.compare_exchange_strong(expected, true))
     return; // already started
 
+  if (credit_ && credit_->overflow() == gma::rt::CreditGate::Overflow::Conflate) {
+    std::weak_ptr<Listener> weak = weak_from_this();
+    credit_->onReplenish([weak]() {
+      if (auto self = weak.lock()) self->flushPending();
+    });
+  }
+
   if (dispatcher_) {
     dispatcher_->registerListener(symbol_, field_, shared_from_this());
   }
@@ -81,15 +94,93 @@ void Listener::onValue(const gma::StreamValue& sv) {
   }
   if (!down) return;
 
+  if (!credit_) {
+    deliver(std::move(down), sv);
+    return;
+  }
+
+  // Credit decision and pool post happen under pendingMx_ so a conflated
+  // value can never be flushed behind a newer one. The synchronous (no
+  // pool, or inline pool) path runs downstream unlocked: its release() may
+  // re-enter flushPending().
+  bool stashed = false;
+  {
+    std::lock_guard<std::mutex> lk(pendingMx_);
+    if (credit_->tryAcquire()) {
+      pending_.reset();                       // superseded by this value
+      if (postsAsync()) {
+        deliver(std::move(down), sv);
+        return;
+      }
+    } else if (credit_->overflow() == gma::rt::CreditGate::Overflow::Drop) {
+      GMA_METRIC_HIT("listener.credit_dropped");
+      return;
+    } else {
+      pending_ = sv;
+      stashed  = true;
+    }
+  }
+
+  if (!stashed) {
+    deliver(std::move(down), sv);
+    return;
+  }
+  GMA_METRIC_HIT("listener.credit_conflated");
+  // The window may have reopened between tryAcquire() and the stash; the
+  // replenish callback would then already have run and found nothing.
+  if (!credit_->exhausted()) flushPending();
+}
+
+void Listener::deliver(std::shared_ptr<INode> down, const gma::StreamValue& sv) {
   if (pool_) {
-    pool_->post([d = std::move(down), sym = sv.symbol, val = sv.value]() mutable {
-      d->onValue(gma::StreamValue{std::move(sym), std::move(val)});
+    pool_->post([d = std::move(down), sym = sv.symbol, val = sv.value,
+                 credit = credit_]() mutable {
+      // The credit is held for the task's lifetime, including the throw
+      // path — a leaked credit would shrink the window for good.
+      try {
+        d->onValue(gma::StreamValue{std::move(sym), std::move(val)});
+      } catch (...) {
+        if (credit) credit->release();
+        throw;
+      }
+      if (credit) credit->release();
     });
   } else {
-    down->onValue(sv);
+    try {
+      down->onValue(sv);
+    } catch (...) {
+      if (credit_) credit_->release();
+      throw;
+    }
+    if (credit_) credit_->release();
   }
 }
 
+void Listener::flushPending() {
+  if (stopping_.load(std::memory_order_acquire)) return;
+
+  std::shared_ptr<INode> down;
+  {
+    std::lock_guard<std::mutex> lk(downMx_);
+    down = downstream_.lock();
+  }
+  if (!down) return;
+
+  std::optional<gma::StreamValue> sv;
+  {
+    std::lock_guard<std::mutex> lk(pendingMx_);
+    if (!pending_) return;
+    if (!credit_->tryAcquire()) return;   // another source won the credit
+    if (postsAsync()) {
+      deliver(std::move(down), *pending_);
+      pending_.reset();
+      return;
+    }
+    sv.swap(pending_);
+  }
+  deliver(std::move(down), *sv);
+}
+
 void Listener::shutdown() noexcept {
   bool expected = false;
   if (!stopping_.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
@@ -112,4 +203,8 @@ void Listener::shutdown() noexcept {
     std::lock_guard<std::mutex> lk(downMx_);
     downstream_.reset();
   }
+  {
+    std::lock_guard<std::mutex> lk(pendingMx_);
+    pending_.reset();
+  }
 }
@@ -30,8 +30,10 @@ double toDouble(const ArgType& v) {
 
 TumblingWindow::TumblingWindow(std::chrono::milliseconds period,
                                std::shared_ptr<INode> downstream,
-                               gma::rt::ThreadPool* pool)
+                               gma::rt::ThreadPool* pool,
+                               gma::rt::Clock* clock)
   : period_(period), downstream_(std::move(downstream)), pool_(pool)
+  , clock_(clock ? clock : &gma::rt::systemClock())
 {
 }
 
@@ -52,6 +54,11 @@ void TumblingWindow::start() {
   if (!started_.compare_exchange_strong(expected, true))
     return;
 
+  if (clock_->simulated()) {
+    armSimulated();
+    return;
+  }
+
   timerThread_ = std::thread([self = shared_from_this()] {
     self->timerLoop();
   });
@@ -77,7 +84,7 @@ void TumblingWindow::timerLoop() {
     if (stopping_.load(std::memory_order_acquire))
       break;
 
-    const auto now = std::chrono::system_clock::now();
+    const auto now = clock_->now();
     const auto target = BucketTime::nextAlignedAfter(now, period_);
     {
       std::unique_lock<std::mutex> lk(mx_);
@@ -93,51 +100,72 @@ void TumblingWindow::timerLoop() {
       break;
     if (!downstream_) break;
 
-    // Snapshot non-empty buckets under the lock — move out the per-symbol
-    // vectors into a local list. `clear()` on the moved-from vector keeps
-    // its capacity for the next bucket (steady-state alloc-bounded). We
-    // release the lock before calling downstream so a re-entrant downstream
-    // (e.g. routed back into another TumblingWindow) can't deadlock.
-    std::vector<std::pair<std::string, std::vector<double>>> emits;
-    {
-      std::lock_guard<std::mutex> lk(mx_);
-      emits.reserve(acc_.size());
-      for (auto& kv : acc_) {
-        if (kv.second.empty()) continue; // empty bucket: no emit
-        std::vector<double> out;
-        out.swap(kv.second);             // move-out, leave kv.second empty + capacity-preserved
-        emits.emplace_back(kv.first, std::move(out));
-      }
+    flush();
+  }
+}
+
+void TumblingWindow::flush() {
+  // Snapshot non-empty buckets under the lock — move out the per-symbol
+  // vectors into a local list. `clear()` on the moved-from vector keeps
+  // its capacity for the next bucket (steady-state alloc-bounded). We
+  // release the lock before calling downstream so a re-entrant downstream
+  // (e.g. routed back into another TumblingWindow) can't deadlock.
+  std::vector<std::pair<std::string, std::vector<double>>> emits;
+  std::shared_ptr<INode> ds;
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    ds = downstream_;
+    if (!ds) return;
+    emits.reserve(acc_.size());
+    for (auto& kv : acc_) {
+      if (kv.second.empty()) continue; // empty bucket: no emit
+      std::vector<double> out;
+      out.swap(kv.second);             // move-out, leave kv.second empty + capacity-preserved
+      emits.emplace_back(kv.first, std::move(out));
     }
-    if (emits.empty()) continue;
-
-    auto ds = downstream_;
-    for (auto& [sym, vec] : emits) {
-      try {
-        if (pool_) {
-          // Wrap in a shared_ptr so the captured lambda can hold the vector
-          // by value without copying — same trick BucketTime uses for the
-          // tick payload. Move into the lambda capture to skip a copy.
-          auto sym_cap = sym;
-          auto vec_cap = std::make_shared<std::vector<double>>(std::move(vec));
-          pool_->post([ds, s = std::move(sym_cap), v = std::move(vec_cap)] {
-            ds->onValue(StreamValue{s, ArgType{*v}});
-          });
-        } else {
-          ds->onValue(StreamValue{sym, ArgType{std::move(vec)}});
-        }
-      } catch (const std::exception& ex) {
-        gma::util::logger().log(gma::util::LogLevel::Error,
-          "TumblingWindow::timerLoop: onValue exception",
-          {{"symbol", sym}, {"err", ex.what()}});
+  }
+  if (emits.empty()) return;
+
+  for (auto& [sym, vec] : emits) {
+    try {
+      if (pool_) {
+        // Wrap in a shared_ptr so the captured lambda can hold the vector
+        // by value without copying — same trick BucketTime uses for the
+        // tick payload. Move into the lambda capture to skip a copy.
+        auto sym_cap = sym;
+        auto vec_cap = std::make_shared<std::vector<double>>(std::move(vec));
+        pool_->post([ds, s = std::move(sym_cap), v = std::move(vec_cap)] {
+          ds->onValue(StreamValue{s, ArgType{*v}});
+        });
+      } else {
+        ds->onValue(StreamValue{sym, ArgType{std::move(vec)}});
       }
+    } catch (const std::exception& ex) {
+      gma::util::logger().log(gma::util::LogLevel::Error,
+        "TumblingWindow::flush: onValue exception",
+        {{"symbol", sym}, {"err", ex.what()}});
     }
   }
 }
 
+void TumblingWindow::armSimulated() {
+  auto* sim = clock_->simulated();
+  auto target = BucketTime::nextAlignedAfter(sim->now(), period_);
+  if (target <= sim->now()) target = sim->now() + std::chrono::milliseconds(1);
+  std::weak_ptr<TumblingWindow> weak = weak_from_this();
+  simTimer_.store(sim->schedule(target, [weak] {
+    auto self = weak.lock();
+    if (!self || self->stopping_.load(std::memory_order_acquire)) return;
+    self->flush();
+    if (!self->stopping_.load(std::memory_order_acquire)) self->armSimulated();
+  }), std::memory_order_release);
+}
+
 void TumblingWindow::shutdown() noexcept {
   stopping_.store(true, std::memory_order_release);
   cv_.notify_all();
+  if (auto* sim = clock_->simulated())
+    sim->cancel(simTimer_.load(std::memory_order_acquire));
   if (timerThread_.joinable()) {
     if (timerThread_.get_id() == std::this_thread::get_id()) {
       timerThread_.detach();
@@ -0,0 +1,79 @@
+// File: src/rt/Clock.cpp
+#include "gma/rt/Clock.hpp"
+#include "gma/util/Logger.hpp"
+
+namespace gma::rt {
+
+namespace {
+
+class SystemClock final : public Clock {
+public:
+  time_point now() const noexcept override { return std::chrono::system_clock::now(); }
+};
+
+} // namespace
+
+Clock& systemClock() noexcept {
+  static SystemClock c;
+  return c;
+}
+
+SimulatedClock::SimulatedClock(time_point start)
+  : now_(start)
+{
+}
+
+Clock::time_point SimulatedClock::now() const noexcept {
+  std::lock_guard<std::mutex> lk(mx_);
+  return now_;
+}
+
+SimulatedClock::TimerId SimulatedClock::schedule(time_point at, std::function<void()> fn) {
+  std::lock_guard<std::mutex> lk(mx_);
+  const TimerId id = nextId_++;
+  timers_.emplace(Key{at, id}, std::move(fn));
+  due_.emplace(id, at);
+  return id;
+}
+
+void SimulatedClock::cancel(TimerId id) noexcept {
+  std::lock_guard<std::mutex> lk(mx_);
+  auto it = due_.find(id);
+  if (it == due_.end()) return;
+  timers_.erase(Key{it->second, id});
+  due_.erase(it);
+}
+
+std::size_t SimulatedClock::advanceTo(time_point t) {
+  std::size_t fired = 0;
+  for (;;) {
+    std::function<void()> fn;
+    {
+      std::lock_guard<std::mutex> lk(mx_);
+      auto it = timers_.begin();
+      if (it == timers_.end() || it->first.first > t) {
+        if (t > now_) now_ = t;
+        return fired;
+      }
+      if (it->first.first > now_) now_ = it->first.first;
+      due_.erase(it->first.second);
+      fn = std::move(it->second);
+      timers_.erase(it);
+    }
+    // Run unlocked so the callback can read now() and re-arm itself.
+    try {
+      if (fn) fn();
+    } catch (const std::exception& ex) {
+      gma::util::logger().log(gma::util::LogLevel::Error,
+        "SimulatedClock: timer exception", {{"err", ex.what()}});
+    }
+    ++fired;
+  }
+}
+
+std::size_t SimulatedClock::pending() const {
+  std::lock_guard<std::mutex> lk(mx_);
+  return timers_.size();
+}
+
+} // namespace gma::rt
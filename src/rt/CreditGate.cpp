@@ -0,0 +1,56 @@
+// File: src/rt/CreditGate.cpp
+#include "gma/rt/CreditGate.hpp"
+
+#include <stdexcept>
+
+namespace gma::rt {
+
+CreditGate::CreditGate(std::size_t window, Overflow overflow)
+  : window_(window), overflow_(overflow)
+{
+  if (window_ == 0)
+    throw std::invalid_argument("CreditGate: window must be > 0");
+}
+
+bool CreditGate::tryAcquire() noexcept {
+  const long w = static_cast<long>(window_);
+  long cur = inFlight_.load(std::memory_order_relaxed);
+  while (cur < w) {
+    if (inFlight_.compare_exchange_weak(cur, cur + 1,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_relaxed))
+      return true;
+  }
+  return false;
+}
+
+void CreditGate::acquire() noexcept {
+  inFlight_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void CreditGate::release(std::size_t n) {
+  if (n == 0) return;
+  const long before = inFlight_.fetch_sub(static_cast<long>(n), std::memory_order_acq_rel);
+  const long after  = before - static_cast<long>(n);
+  const long w      = static_cast<long>(window_);
+
+  // Only the release that reopens the window wakes the sources; releases
+  // while still over the window (frames from a burst draining) stay cheap.
+  if (before < w || after >= w) return;
+
+  std::vector<std::function<void()>> cbs;
+  {
+    std::lock_guard<std::mutex> lk(cbMx_);
+    cbs = callbacks_;
+  }
+  for (auto& cb : cbs) {
+    if (cb) cb();
+  }
+}
+
+void CreditGate::onReplenish(std::function<void()> fn) {
+  std::lock_guard<std::mutex> lk(cbMx_);
+  callbacks_.push_back(std::move(fn));
+}
+
+} // namespace gma::rt
@@ -0,0 +1,113 @@
+// File: src/rt/ReplayDriver.cpp
+#include "gma/rt/ReplayDriver.hpp"
+#include "gma/Dispatcher.hpp"
+#include "gma/Event.hpp"
+#include "gma/util/Logger.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <istream>
+#include <memory>
+#include <string>
+
+#include <rapidjson/document.h>
+
+namespace gma::rt {
+
+namespace {
+
+// Same symbol bound the feed applies to live lines.
+constexpr std::size_t MAX_SYMBOL_LEN = 64;
+
+// Largest |ts| in milliseconds that still converts to a Clock::time_point.
+constexpr std::int64_t MAX_TS_MS =
+  std::chrono::duration_cast<std::chrono::milliseconds>(Clock::time_point::duration::max()).count();
+
+// Event timestamp in milliseconds; false when `ts` is not finite or does
+// not fit a Clock::time_point.
+bool timestampMs(const rapidjson::Value& tsv, std::int64_t& ms) {
+  if (tsv.IsInt64()) {
+    ms = tsv.GetInt64();
+  } else {
+    const double d = tsv.GetDouble();
+    if (!std::isfinite(d) || std::fabs(d) > static_cast<double>(MAX_TS_MS)) return false;
+    ms = static_cast<std::int64_t>(d);
+  }
+  return ms >= -MAX_TS_MS && ms <= MAX_TS_MS;
+}
+
+} // namespace
+
+ReplayDriver::ReplayDriver(Dispatcher& dispatcher, SimulatedClock& clock)
+  : dispatcher_(dispatcher), clock_(clock)
+{
+}
+
+void ReplayDriver::feed(Clock::time_point ts, const Event& ev) {
+  stats_.timers += clock_.advanceTo(ts);
+  dispatcher_.onTick(ev);
+  ++stats_.events;
+}
+
+std::size_t ReplayDriver::replayJsonl(std::istream& in) {
+  std::size_t dispatched = 0;
+  std::size_t lineNo = 0;
+  std::string line;
+  while (std::getline(in, line)) {
+    ++lineNo;
+    if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+    auto doc = std::make_shared<rapidjson::Document>();
+    doc->Parse(line.c_str());
+    std::int64_t ms = 0;
+    if (doc->HasParseError() || !doc->IsObject()
+        || !doc->HasMember("ts") || !(*doc)["ts"].IsNumber()
+        || !timestampMs((*doc)["ts"], ms)
+        || !doc->HasMember("symbol") || !(*doc)["symbol"].IsString()) {
+      ++stats_.rejected;
+      gma::util::logger().log(gma::util::LogLevel::Warn,
+        "ReplayDriver: malformed line skipped",
+        {{"line", std::to_string(lineNo)}});
+      continue;
+    }
+
+    Event ev;
+    ev.symbol = (*doc)["symbol"].GetString();
+    if (ev.symbol.empty() || ev.symbol.size() > MAX_SYMBOL_LEN) {
+      ++stats_.rejected;
+      continue;
+    }
+    if (doc->HasMember("type") && (*doc)["type"].IsString())
+      ev.type = (*doc)["type"].GetString();
+
+    doc->RemoveMember("ts");
+    ev.payload = std::move(doc);
+
+    feed(Clock::time_point{std::chrono::milliseconds{ms}}, ev);
+    ++dispatched;
+  }
+  return dispatched;
+}
+
+std::optional<Clock::time_point> ReplayDriver::firstTimestamp(std::istream& in) {
+  const auto start = in.tellg();
+  std::optional<Clock::time_point> first;
+  std::string line;
+  while (!first && std::getline(in, line)) {
+    rapidjson::Document doc;
+    doc.Parse(line.c_str());
+    std::int64_t ms = 0;
+    if (!doc.HasParseError() && doc.IsObject() && doc.HasMember("ts") && doc["ts"].IsNumber()
+        && timestampMs(doc["ts"], ms))
+      first = Clock::time_point{std::chrono::milliseconds{ms}};
+  }
+  in.clear();
+  in.seekg(start);
+  return first;
+}
+
+void ReplayDriver::finish(Clock::time_point until) {
+  stats_.timers += clock_.advanceTo(until);
+}
+
+} // namespace gma::rt
@@ -12,6 +12,11 @@ ThreadPool::ThreadPool(unsigned nThreads) {
   }
 }
 
+ThreadPool::ThreadPool(InlineTag)
+  : inline_(true)
+{
+}
+
 ThreadPool::~ThreadPool() {
   {
     std::lock_guard<std::mutex> lk(mx_);
@@ -26,8 +31,43 @@ void ThreadPool::post(std::function<void()> fn) {
     std::lock_guard<std::mutex> lk(mx_);
     if (stopping_) return;
     q_.push(std::move(fn));
+    if (inline_) {
+      if (inlineRunning_) return; // the outer runInline() picks it up
+      inlineRunning_ = true;
+    }
+  }
+  if (inline_) runInline();
+  else         cv_.notify_one();
+}
+
+void ThreadPool::runInline() {
+  for (;;) {
+    std::function<void()> fn;
+    {
+      std::lock_guard<std::mutex> lk(mx_);
+      if (q_.empty()) {
+        inlineRunning_ = false;
+        break;
+      }
+      fn = std::move(q_.front()); q_.pop();
+      inFlight_.fetch_add(1, std::memory_order_acq_rel);
+    }
+    runTask(fn);
+    inFlight_.fetch_sub(1, std::memory_order_release);
+  }
+  idleCv_.notify_all();
+}
+
+void ThreadPool::runTask(std::function<void()>& fn) {
+  try {
+    fn();
+  } catch (const std::exception& e) {
+    gma::util::logger().log(gma::util::LogLevel::Error,
+      "ThreadPool: task exception", {{"err", e.what()}});
+  } catch (...) {
+    gma::util::logger().log(gma::util::LogLevel::Error,
+      "ThreadPool: unknown task exception");
   }
-  cv_.notify_one();
 }
 
 void ThreadPool::drain() {
@@ -55,15 +95,7 @@ void ThreadPool::workerLoop() {
       fn = std::move(q_.front()); q_.pop();
       inFlight_.fetch_add(1, std::memory_order_acq_rel);
     }
-    try {
-      fn();
-    } catch (const std::exception& e) {
-      gma::util::logger().log(gma::util::LogLevel::Error,
-        "ThreadPool: task exception", {{"err", e.what()}});
-    } catch (...) {
-      gma::util::logger().log(gma::util::LogLevel::Error,
-        "ThreadPool: unknown task exception");
-    }
+    runTask(fn);
     inFlight_.fetch_sub(1, std::memory_order_release);
     idleCv_.notify_all();
   }
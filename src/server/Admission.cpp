@@ -0,0 +1,161 @@
+#include "gma/server/Admission.hpp"
+#include "gma/util/Metrics.hpp"
+
+#include <algorithm>
+
+namespace gma::server {
+
+namespace {
+
+enum class Limit { None, Cpu, Memory, Timers };
+
+// First limit `add` breaks on top of `cur` under `b`.
+Limit overBudget(const AdmissionController::Usage&  cur,
+                 const AdmissionController::Usage&  add,
+                 const AdmissionController::Budget& b) {
+  if (b.cpu > 0 && cur.cpu + add.cpu > b.cpu)                             return Limit::Cpu;
+  if (b.stateBytes > 0 && cur.stateBytes + add.stateBytes > b.stateBytes) return Limit::Memory;
+  if (b.timers > 0 && cur.timers + add.timers > b.timers)                 return Limit::Timers;
+  return Limit::None;
+}
+
+const char* limitName(Limit l) {
+  switch (l) {
+    case Limit::Cpu:    return "cpu";
+    case Limit::Memory: return "memory";
+    case Limit::Timers: return "timer";
+    default:            return "";
+  }
+}
+
+} // namespace
+
+AdmissionController::AdmissionController(Budget global, Budget perSession)
+  : global_(global), perSession_(perSession)
+{
+  std::lock_guard<std::mutex> lk(mx_);
+  publishLocked();
+}
+
+AdmissionController::Budget
+AdmissionController::budget(double cpu, int memoryMB, int timers) {
+  Budget b;
+  b.cpu        = std::max(0.0, cpu);
+  b.stateBytes = static_cast<std::uint64_t>(std::max(0, memoryMB)) << 20;
+  b.timers     = static_cast<std::uint32_t>(std::max(0, timers));
+  return b;
+}
+
+AdmissionController::Result
+AdmissionController::admit(std::uint64_t session, const tree::TreeCost& cost) {
+  Usage full;
+  full.cpu        = cost.cpu();
+  full.stateBytes = cost.stateBytes;
+  full.timers     = cost.timers;
+
+  std::lock_guard<std::mutex> lk(mx_);
+  const Usage noSession;
+  auto sit = sessions_.find(session);
+  const Usage& cur = sit != sessions_.end() ? sit->second : noSession;
+
+  // Global first, then this session's share.
+  const char* scope = "global";
+  auto check = [&](const Usage& u) {
+    scope = "global";
+    auto l = overBudget(used_, u, global_);
+    if (l == Limit::None) { scope = "session"; l = overBudget(cur, u, perSession_); }
+    return l;
+  };
+
+  Result r;
+  const Limit hit = check(full);
+  if (hit == Limit::None) {
+    r.decision = Decision::Admit;
+    r.charged  = full;
+    GMA_METRIC_HIT("admission.admit");
+  } else {
+    const std::string why = std::string(scope) + " " + limitName(hit) + " budget exceeded";
+    Usage conflated = full;
+    conflated.cpu *= DOWNGRADE_CPU_FACTOR;
+    // Conflation only bounds CPU; memory and timer overruns stay fatal.
+    if (hit == Limit::Cpu && check(conflated) == Limit::None) {
+      r.decision = Decision::Downgrade;
+      r.charged  = conflated;
+      r.reason   = why + "; downgraded to conflated delivery";
+      GMA_METRIC_HIT("admission.downgrade");
+    } else {
+      r.decision = Decision::Reject;
+      r.reason   = why;
+      GMA_METRIC_HIT("admission.reject");
+      return r;
+    }
+  }
+
+  used_.cpu        += r.charged.cpu;
+  used_.stateBytes += r.charged.stateBytes;
+  used_.timers     += r.charged.timers;
+  auto& s = sessions_[session];
+  s.cpu        += r.charged.cpu;
+  s.stateBytes += r.charged.stateBytes;
+  s.timers     += r.charged.timers;
+  publishLocked();
+  return r;
+}
+
+void AdmissionController::release(std::uint64_t session, const Usage& charged) {
+  auto sub = [&charged](Usage& u) {
+    u.cpu        = std::max(0.0, u.cpu - charged.cpu);
+    u.stateBytes -= std::min(u.stateBytes, charged.stateBytes);
+    u.timers     -= std::min(u.timers, charged.timers);
+  };
+
+  std::lock_guard<std::mutex> lk(mx_);
+  sub(used_);
+  auto it = sessions_.find(session);
+  if (it != sessions_.end()) {
+    sub(it->second);
+    if (it->second.cpu <= 0 && it->second.stateBytes == 0 && it->second.timers == 0)
+      sessions_.erase(it);
+  }
+  publishLocked();
+}
+
+void AdmissionController::forget(std::uint64_t session) {
+  std::lock_guard<std::mutex> lk(mx_);
+  auto it = sessions_.find(session);
+  if (it != sessions_.end()) {
+    used_.cpu        = std::max(0.0, used_.cpu - it->second.cpu);
+    used_.stateBytes -= std::min(used_.stateBytes, it->second.stateBytes);
+    used_.timers     -= std::min(used_.timers, it->second.timers);
+    sessions_.erase(it);
+  }
+  if (sessions_.empty()) used_ = Usage{};
+  publishLocked();
+}
+
+AdmissionController::Usage AdmissionController::used() const {
+  std::lock_guard<std::mutex> lk(mx_);
+  return used_;
+}
+
+AdmissionController::Usage AdmissionController::sessionUsed(std::uint64_t session) const {
+  std::lock_guard<std::mutex> lk(mx_);
+  auto it = sessions_.find(session);
+  return it != sessions_.end() ? it->second : Usage{};
+}
+
+std::size_t AdmissionController::sessionCount() const {
+  std::lock_guard<std::mutex> lk(mx_);
+  return sessions_.size();
+}
+
+void AdmissionController::publishLocked() const {
+  GMA_METRIC_SET("admission.cpu.used",            used_.cpu);
+  GMA_METRIC_SET("admission.cpu.budget",          global_.cpu);
+  GMA_METRIC_SET("admission.memory_bytes.used",   static_cast<double>(used_.stateBytes));
+  GMA_METRIC_SET("admission.memory_bytes.budget", static_cast<double>(global_.stateBytes));
+  GMA_METRIC_SET("admission.timers.used",         static_cast<double>(used_.timers));
+  GMA_METRIC_SET("admission.timers.budget",       static_cast<double>(global_.timers));
+}
+
+} // namespace gma::server
@@ -6,7 +6,11 @@
 #include "gma/Dispatcher.hpp"
 #include "gma/TreeBuilder.hpp"
 #include "gma/JsonValidator.hpp"
+#include "gma/PlanCache.hpp"
+#include "gma/engine/StreamRegistry.hpp"
 #include "gma/nodes/Responder.hpp"
+#include "gma/server/Admission.hpp"
+#include "gma/rt/CreditGate.hpp"
 #include "gma/util/Logger.hpp"
 #include "gma/util/Metrics.hpp"
 #include "gma/util/JsonUtil.hpp"
@@ -42,6 +46,12 @@ namespace websocket = boost::beast::websocket;
 namespace beast     = boost::beast;
 namespace http      = boost::beast::http;
 
+namespace {
+// Validate streamKey/field length to prevent absurdly large map keys.
+constexpr std::size_t MAX_STREAM_KEY_LEN = 64;
+constexpr std::size_t MAX_FIELD_LEN      = 128;
+} // namespace
+
 // ------------------------------
 // Construction / lifecycle
 // ------------------------------
@@ -156,6 +166,7 @@ void ClientSession::close() {
     if (!self->open_.exchange(false)) return;
 
     // Best-effort shutdown of active requests/trees
+    decltype(self->streams_) streams;
     {
       std::lock_guard<std::mutex> lk(self->reqMu_);
       for (auto& kv : self->active_) {
@@ -165,6 +176,14 @@ void ClientSession::close() {
       }
       self->active_.clear();
       self->chains_.clear();
+      streams.swap(self->streams_);
+      while (!self->charges_.empty())
+        self->releaseChargeLocked(self->charges_.begin()->first);
+      if (auto* adm = self->exec_ ? self->exec_->admission() : nullptr)
+        adm->forget(self->admissionId());
+    }
+    for (auto& kv : streams) {
+      if (kv.second) kv.second->stop();
     }
 
     websocket::close_reason cr;
@@ -197,25 +216,44 @@ void ClientSession::close() {
 // ------------------------------
 // Outbound sending (thread-safe)
 // ------------------------------
-void ClientSession::sendText(const std::string& s) {
-  if (!open_.load()) return;
+void ClientSession::sendText(const std::string& s,
+                             std::shared_ptr<rt::CreditGate> credit) {
+  enqueue(Outgoing{s, std::move(credit), false});
+}
+
+void ClientSession::sendBinary(std::string bytes,
+                               std::shared_ptr<rt::CreditGate> credit) {
+  enqueue(Outgoing{std::move(bytes), std::move(credit), true});
+}
+
+void ClientSession::enqueue(Outgoing o) {
+  if (!open_.load()) {
+    if (o.credit) o.credit->release();
+    return;
+  }
 
   auto self = shared_from_this();
-  boost::asio::dispatch(strand_, [self, s]() {
-    if (!self->open_.load()) return;
+  boost::asio::dispatch(strand_, [self, o = std::move(o)]() mutable {
+    if (!self->open_.load()) {
+      if (o.credit) o.credit->release();
+      return;
+    }
 
     // Backpressure: if a slow/dead client lets the queue grow too large,
-    // close the connection rather than exhausting server memory.
+    // close the connection rather than exhausting server memory. Per-
+    // subscription credit windows normally hold sources back long before
+    // this point.
     if (self->outbox_.size() >= MAX_OUTBOX_SIZE) {
       gma::util::logger().log(gma::util::LogLevel::Warn,
                               "ws.outbox_overflow",
                               {{"sessionId", std::to_string(self->sessionId_)},
                                {"queueSize", std::to_string(self->outbox_.size())}});
+      if (o.credit) o.credit->release();
       self->close();
       return;
     }
 
-    self->outbox_.push_back(s);
+    self->outbox_.push_back(std::move(o));
     if (!self->writing_) {
       self->writing_ = true;
       self->startWrite();
@@ -223,11 +261,19 @@ void ClientSession::sendText(const std::string& s) {
   });
 }
 
+void ClientSession::discardOutbox() {
+  // On-strand. Return the credits of frames that will never be written.
+  for (auto& o : outbox_) {
+    if (o.credit) o.credit->release();
+  }
+  outbox_.clear();
+}
+
 void ClientSession::startWrite() {
   // This function must be called on-strand.
   if (!open_.load()) {
     writing_ = false;
-    outbox_.clear();
+    discardOutbox();
     return;
   }
 
@@ -238,9 +284,9 @@ void ClientSession::startWrite() {
 
   auto self = shared_from_this();
 
-  ws_.text(true);
+  ws_.binary(outbox_.front().binary);
   ws_.async_write(
-    boost::asio::buffer(outbox_.front()),
+    boost::asio::buffer(outbox_.front().text),
     boost::asio::bind_executor(
       strand_,
       [self](beast::error_code ec, std::size_t bytes) {
@@ -261,7 +307,13 @@ void ClientSession::onWrite(beast::error_code ec, std::size_t) {
     return;
   }
 
-  if (!outbox_.empty()) outbox_.pop_front();
+  if (!outbox_.empty()) {
+    // Releasing the credit may wake conflating Listeners of that
+    // subscription; they post to the pool, so nothing re-enters here.
+    auto credit = std::move(outbox_.front().credit);
+    outbox_.pop_front();
+    if (credit) credit->release();
+  }
 
   // Continue draining queue.
   startWrite();
@@ -312,6 +364,18 @@ void ClientSession::handleMessage(const std::string& text) {
   sendError("type", "unknown type: " + type);
 }
 
+std::uint64_t ClientSession::admissionId() const noexcept {
+  // sessionId_ is zeroed on close; the address is stable for our lifetime.
+  return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(this));
+}
+
+void ClientSession::releaseChargeLocked(const gma::server::RequestKey& key) {
+  auto it = charges_.find(key);
+  if (it == charges_.end()) return;
+  if (exec_ && exec_->admission()) exec_->admission()->release(admissionId(), it->second);
+  charges_.erase(it);
+}
+
 bool ClientSession::rateLimitCheck() {
   auto now = std::chrono::steady_clock::now();
   double elapsed = std::chrono::duration<double>(now - rateLastRefill_).count();
@@ -340,6 +404,7 @@ void ClientSession::handleSubscribe(const ::rapidjson::Document& doc) {
   }
 
   const auto& arr = doc["requests"].GetArray();
+  std::string planKey;   // reused across requests
 
   for (auto& r : arr) {
     if (!r.IsObject()) {
@@ -360,6 +425,12 @@ void ClientSession::handleSubscribe(const ::rapidjson::Document& doc) {
     }
     gma::server::RequestKey key = std::move(*keyOpt);
 
+    // Connector stream (binary depth ladder, …) instead of a node tree.
+    if (r.HasMember("stream")) {
+      handleStreamSubscribe(r, std::move(key));
+      continue;
+    }
+
     if (!r.HasMember("streamKey") || !r["streamKey"].IsString()) {
       sendError("subscribe", "request missing 'streamKey' string");
       continue;
@@ -372,9 +443,6 @@ void ClientSession::handleSubscribe(const ::rapidjson::Document& doc) {
     const std::string streamKey = r["streamKey"].GetString();
     const std::string field     = r["field"].GetString();
 
-    // Validate streamKey/field length to prevent absurdly large map keys.
-    static constexpr std::size_t MAX_STREAM_KEY_LEN = 64;
-    static constexpr std::size_t MAX_FIELD_LEN      = 128;
     if (streamKey.empty() || streamKey.size() > MAX_STREAM_KEY_LEN) {
       sendError("subscribe", "invalid 'streamKey' (empty or too long, max "
                 + std::to_string(MAX_STREAM_KEY_LEN) + ")");
@@ -386,104 +454,147 @@ void ClientSession::handleSubscribe(const ::rapidjson::Document& doc) {
       continue;
     }
 
-    // Callback from Responder -> send update message over this WS session.
-    // Capture weak_ptr to avoid reference cycle:
-    //   ClientSession → chains_ → Responder → sendFn → ClientSession
-    auto weak = weak_from_this();
-    auto sendFn = [weak](const gma::server::RequestKey& reqKey,
-                         const gma::StreamValue& sv) {
-      try {
-        auto self = weak.lock();
-        if (!self) return;
-
-        ::rapidjson::StringBuffer sb;
-        ::rapidjson::Writer<::rapidjson::StringBuffer> w(sb);
-
-        w.StartObject();
-        w.Key("type");   w.String("update");
-        gma::server::writeRequestKeyJSON(w, reqKey);
-        w.Key("streamKey"); w.String(sv.symbol.c_str());
-        w.Key("value");  gma::util::writeArgTypeJson(w, sv.value);
-        w.EndObject();
-
-        GMA_METRIC_HIT("ws.msg_out");
-        self->sendText(sb.GetString());
-      } catch (const std::exception& ex) {
-        gma::util::logger().log(gma::util::LogLevel::Error,
-          "ws.sendFn exception",
-          {{"err", ex.what()}, {"reqKey", gma::server::keyDebugString(reqKey)}});
+    // Credit window: bounds how many values of this subscription may be
+    // queued in the pool or unwritten in the outbox. Once exhausted the
+    // subscription's Listeners conflate (default) or drop instead of
+    // computing values the client cannot keep up with.
+    std::size_t creditWindow = DEFAULT_CREDIT_WINDOW;
+    if (r.HasMember("creditWindow")) {
+      if (!r["creditWindow"].IsUint() || r["creditWindow"].GetUint() == 0 ||
+          r["creditWindow"].GetUint() > MAX_CREDIT_WINDOW) {
+        sendError("subscribe", "invalid 'creditWindow' (1.."
+                  + std::to_string(MAX_CREDIT_WINDOW) + ")");
+        continue;
       }
-    };
-
-    std::shared_ptr<gma::INode> terminal =
-      std::make_shared<gma::nodes::Responder>(sendFn, key);
-
-    // Build a validated request JSON object to pass to TreeBuilder.
-    ::rapidjson::Document rq;
-    rq.SetObject();
-    auto& a = rq.GetAllocator();
-
-    rq.AddMember("streamKey", ::rapidjson::Value(streamKey.c_str(), a), a);
-    rq.AddMember("field",  ::rapidjson::Value(field.c_str(),  a), a);
-
-    // Optional pass-through: pipeline/stages/node
-    if (r.HasMember("pipeline") && r["pipeline"].IsArray()) {
-      ::rapidjson::Value pipe(::rapidjson::kArrayType);
-      pipe.CopyFrom(r["pipeline"], a);
-      rq.AddMember("pipeline", pipe, a);
-    }
-    if (r.HasMember("stages") && r["stages"].IsArray()) {
-      ::rapidjson::Value stages(::rapidjson::kArrayType);
-      stages.CopyFrom(r["stages"], a);
-      rq.AddMember("stages", stages, a);
+      creditWindow = r["creditWindow"].GetUint();
     }
-    if (r.HasMember("node") && r["node"].IsObject()) {
-      ::rapidjson::Value node(::rapidjson::kObjectType);
-      node.CopyFrom(r["node"], a);
-      rq.AddMember("node", node, a);
+    auto overflow = rt::CreditGate::Overflow::Conflate;
+    if (r.HasMember("overflow")) {
+      const std::string mode = r["overflow"].IsString() ? r["overflow"].GetString() : "";
+      if (mode == "drop") {
+        overflow = rt::CreditGate::Overflow::Drop;
+      } else if (mode != "conflate") {
+        sendError("subscribe", "invalid 'overflow' (\"conflate\" or \"drop\")");
+        continue;
+      }
     }
 
-    // Validate pipeline/stages/node sub-trees before building
-    try {
-      if (r.HasMember("pipeline") && r["pipeline"].IsArray()) {
-        for (const auto& elem : r["pipeline"].GetArray()) {
-          if (elem.IsObject()) gma::JsonValidator::validateTree(elem);
+    // Compiled plan for this request shape. Reconnect storms replay the
+    // same subscriptions, so a hit skips validation, registry lookups and
+    // function/expression resolution; only node construction remains.
+    auto& plans = gma::tree::PlanCache::instance();
+    gma::tree::PlanCache::canonicalKey(r, planKey);
+    auto plan = plans.find(planKey);
+
+    // Validate pipeline/stages/node sub-trees before compiling
+    if (!plan) {
+      try {
+        if (r.HasMember("pipeline") && r["pipeline"].IsArray()) {
+          for (const auto& elem : r["pipeline"].GetArray()) {
+            if (elem.IsObject()) gma::JsonValidator::validateTree(elem);
+          }
         }
-      }
-      if (r.HasMember("stages") && r["stages"].IsArray()) {
-        for (const auto& elem : r["stages"].GetArray()) {
-          if (elem.IsObject()) gma::JsonValidator::validateTree(elem);
+        if (r.HasMember("stages") && r["stages"].IsArray()) {
+          for (const auto& elem : r["stages"].GetArray()) {
+            if (elem.IsObject()) gma::JsonValidator::validateTree(elem);
+          }
         }
+        if (r.HasMember("node") && r["node"].IsObject()) {
+          gma::JsonValidator::validateTree(r["node"]);
+        }
+      } catch (const std::exception& ex) {
+        sendError("validate", ex.what());
+        continue;
       }
-      if (r.HasMember("node") && r["node"].IsObject()) {
-        gma::JsonValidator::validateTree(r["node"]);
-      }
-    } catch (const std::exception& ex) {
-      sendError("validate", ex.what());
-      continue;
     }
 
-    gma::tree::Deps deps;
-    deps.store      = exec_->store();
-    deps.pool       = exec_->pool();
-    deps.dispatcher = dispatcher_;
-
     try {
       // Check subscription limit BEFORE building the pipeline to avoid
       // wasting resources and leaking registered listeners.
       {
         std::lock_guard<std::mutex> lk(reqMu_);
-        auto it = active_.find(key);
-        if (it == active_.end() && active_.size() >= MAX_SUBSCRIPTIONS) {
+        const bool replaces = active_.count(key) > 0 || streams_.count(key) > 0;
+        if (!replaces && active_.size() + streams_.size() >= MAX_SUBSCRIPTIONS) {
           sendError("subscribe", "max subscriptions reached");
           continue;
         }
       }
 
-      // Build pipeline OUTSIDE the lock — buildForRequest may be expensive
-      // and should not block other subscribe/cancel operations.
-      auto built = gma::tree::buildForRequest(rq, deps, terminal);
+      // Compile (on a miss) and build OUTSIDE the lock — both may be
+      // expensive and should not block other subscribe/cancel operations.
+      if (!plan) plan = plans.insert(planKey, gma::tree::compileRequest(r));
+
+      // Admission: charge the tree's static cost against the global and
+      // per-session budgets. A tree that only breaks a CPU budget may be
+      // admitted conflated (credit window of one).
+      gma::server::AdmissionController::Usage charged;
+      bool downgraded = false;
+      if (auto* adm = exec_->admission()) {
+        auto res = adm->admit(admissionId(), plan->cost);
+        if (res.decision == gma::server::AdmissionController::Decision::Reject) {
+          sendError("admission", res.reason);
+          continue;
+        }
+        if (res.decision == gma::server::AdmissionController::Decision::Downgrade) {
+          creditWindow = 1;
+          overflow     = rt::CreditGate::Overflow::Conflate;
+          downgraded   = true;
+          gma::util::logger().log(gma::util::LogLevel::Info, "ws.subscribe_downgraded",
+                                  {{"streamKey", streamKey}, {"reason", res.reason}});
+        }
+        charged = res.charged;
+      }
+
+      auto credit = std::make_shared<rt::CreditGate>(creditWindow, overflow);
+
+      // Callback from Responder -> send update message over this WS session.
+      // Capture weak_ptr to avoid reference cycle:
+      //   ClientSession → chains_ → Responder → sendFn → ClientSession
+      auto weak = weak_from_this();
+      auto sendFn = [weak, credit](const gma::server::RequestKey& reqKey,
+                                   const gma::StreamValue& sv) {
+        try {
+          auto self = weak.lock();
+          if (!self) return;
+
+          ::rapidjson::StringBuffer sb;
+          ::rapidjson::Writer<::rapidjson::StringBuffer> w(sb);
+
+          w.StartObject();
+          w.Key("type");   w.String("update");
+          gma::server::writeRequestKeyJSON(w, reqKey);
+          w.Key("streamKey"); w.String(sv.symbol.c_str());
+          w.Key("value");  gma::util::writeArgTypeJson(w, sv.value);
+          w.EndObject();
+
+          GMA_METRIC_HIT("ws.msg_out");
+          credit->acquire();
+          self->sendText(sb.GetString(), credit);
+        } catch (const std::exception& ex) {
+          gma::util::logger().log(gma::util::LogLevel::Error,
+            "ws.sendFn exception",
+            {{"err", ex.what()}, {"reqKey", gma::server::keyDebugString(reqKey)}});
+        }
+      };
 
+      std::shared_ptr<gma::INode> terminal =
+        std::make_shared<gma::nodes::Responder>(sendFn, key);
+
+      gma::tree::Deps deps;
+      deps.store      = exec_->store();
+      deps.pool       = exec_->pool();
+      deps.dispatcher = dispatcher_;
+      deps.credit     = credit;
+
+      gma::tree::BuiltChain built;
+      try {
+        built = gma::tree::buildFromPlan(*plan, deps, terminal);
+      } catch (...) {
+        if (auto* adm = exec_->admission()) adm->release(admissionId(), charged);
+        throw;
+      }
+
+      std::shared_ptr<engine::IStream> oldStream;
       {
         std::lock_guard<std::mutex> lk(reqMu_);
         // Replace any existing request with the same key.
@@ -491,9 +602,16 @@ void ClientSession::handleSubscribe(const ::rapidjson::Document& doc) {
         if (it != active_.end() && it->second) {
           it->second->shutdown();
         }
+        if (auto st = streams_.find(key); st != streams_.end()) {
+          oldStream = std::move(st->second);
+          streams_.erase(st);
+        }
         active_[key] = built.head;
         chains_[key] = std::move(built.keepAlive);
+        releaseChargeLocked(key);
+        if (exec_->admission()) charges_[key] = charged;
       }
+      if (oldStream) oldStream->stop();   // outside reqMu_, as in handleCancel
 
       // Ack
       ::rapidjson::StringBuffer sb;
@@ -501,6 +619,7 @@ void ClientSession::handleSubscribe(const ::rapidjson::Document& doc) {
       w.StartObject();
       w.Key("type"); w.String("subscribed");
       gma::server::writeRequestKeyJSON(w, key);
+      if (downgraded) { w.Key("downgraded"); w.Bool(true); }
       w.EndObject();
 
       GMA_METRIC_HIT("ws.subscribe");
@@ -524,6 +643,136 @@ void ClientSession::handleSubscribe(const ::rapidjson::Document& doc) {
   }
 }
 
+void ClientSession::handleStreamSubscribe(const ::rapidjson::Value& r,
+                                          gma::server::RequestKey key) {
+  if (!r["stream"].IsString()) {
+    sendError("subscribe", "'stream' must be a string");
+    return;
+  }
+  if (!r.HasMember("streamKey") || !r["streamKey"].IsString()) {
+    sendError("subscribe", "request missing 'streamKey' string");
+    return;
+  }
+  const std::string kind      = r["stream"].GetString();
+  const std::string streamKey = r["streamKey"].GetString();
+  if (streamKey.empty() || streamKey.size() > MAX_STREAM_KEY_LEN) {
+    sendError("subscribe", "invalid 'streamKey' (empty or too long, max "
+              + std::to_string(MAX_STREAM_KEY_LEN) + ")");
+    return;
+  }
+
+  auto factory = engine::StreamRegistry::find(kind);
+  if (!factory) {
+    sendError("subscribe", "unknown stream: " + kind);
+    return;
+  }
+
+  // Remaining scalar members are the stream's parameters.
+  engine::StreamParams params;
+  for (const auto& m : r.GetObject()) {
+    const std::string name = m.name.GetString();
+    if (name == "stream" || name == "streamKey" || name == "key" || name == "id") continue;
+    if (m.value.IsString())     params[name] = m.value.GetString();
+    else if (m.value.IsInt64()) params[name] = std::to_string(m.value.GetInt64());
+    else if (m.value.IsUint64()) params[name] = std::to_string(m.value.GetUint64());
+    else if (m.value.IsNumber()) params[name] = std::to_string(m.value.GetDouble());
+    else if (m.value.IsBool())   params[name] = m.value.GetBool() ? "true" : "false";
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(reqMu_);
+    const bool replaces = active_.count(key) > 0 || streams_.count(key) > 0;
+    if (!replaces && active_.size() + streams_.size() >= MAX_SUBSCRIPTIONS) {
+      sendError("subscribe", "max subscriptions reached");
+      return;
+    }
+  }
+
+  // Frames the client has not taken yet hold credits; an exhausted window
+  // makes the sink refuse, and the stream folds the change into a later
+  // frame instead of queueing more.
+  auto credit = std::make_shared<rt::CreditGate>(STREAM_CREDIT_WINDOW);
+  auto weak = weak_from_this();
+  engine::StreamSink sink = [weak, credit](std::string frame) -> bool {
+    auto self = weak.lock();
+    if (!self || !self->open_.load()) return false;
+    if (!credit->tryAcquire()) return false;
+    GMA_METRIC_HIT("ws.msg_out");
+    self->sendBinary(std::move(frame), credit);
+    return true;
+  };
+
+  const std::uint32_t streamId = nextStreamId_++;
+  std::shared_ptr<engine::IStream> stream;
+  try {
+    stream = factory(streamKey, streamId, params, std::move(sink));
+  } catch (const std::exception& ex) {
+    sendError("stream", ex.what());
+    return;
+  }
+  if (!stream) {
+    sendError("stream", "unknown stream: " + kind);
+    return;
+  }
+
+  // Charged like a subscription tree. Streams conflate by construction,
+  // so a CPU-only overrun admits them at the downgraded charge as is.
+  gma::server::AdmissionController::Usage charged;
+  if (auto* adm = exec_->admission()) {
+    auto res = adm->admit(admissionId(), stream->cost());
+    if (res.decision == gma::server::AdmissionController::Decision::Reject) {
+      stream->stop();
+      sendError("admission", res.reason);
+      return;
+    }
+    charged = res.charged;
+  }
+
+  // Replace any existing request with the same key; what it ran is
+  // stopped outside the lock.
+  std::shared_ptr<gma::INode> oldRoot;
+  std::shared_ptr<engine::IStream> oldStream;
+  {
+    std::lock_guard<std::mutex> lk(reqMu_);
+    if (auto it = active_.find(key); it != active_.end()) {
+      oldRoot = std::move(it->second);
+      active_.erase(it);
+    }
+    chains_.erase(key);
+    releaseChargeLocked(key);
+    if (exec_->admission()) charges_[key] = charged;
+    if (auto it = streams_.find(key); it != streams_.end()) oldStream = std::move(it->second);
+    streams_[key] = stream;
+  }
+  if (oldRoot) oldRoot->shutdown();
+  if (oldStream) oldStream->stop();
+
+  // Ack first; the stream's snapshot follows it on the wire.
+  ::rapidjson::StringBuffer sb;
+  ::rapidjson::Writer<::rapidjson::StringBuffer> w(sb);
+  w.StartObject();
+  w.Key("type"); w.String("subscribed");
+  gma::server::writeRequestKeyJSON(w, key);
+  w.Key("stream");   w.String(kind.c_str());
+  w.Key("streamId"); w.Uint(streamId);
+  w.EndObject();
+
+  GMA_METRIC_HIT("ws.subscribe");
+  GMA_METRIC_HIT("ws.msg_out");
+  sendText(sb.GetString());
+  stream->start();
+
+  gma::util::logger().log(gma::util::LogLevel::Info,
+                          "ws.subscribe",
+                          { {gma::server::isInt(key) ? "key" : "requestId",
+                             gma::server::isInt(key)
+                                 ? std::to_string(std::get<int>(key))
+                                 : std::get<std::string>(key)},
+                            {"streamKey", streamKey},
+                            {"stream", kind},
+                            {"streamId", std::to_string(streamId)} });
+}
+
 void ClientSession::handleCancel(const ::rapidjson::Document& doc) {
   // Accept legacy `keys: [int,...]` AND new `ids: ["...",...]` arrays.
   // Both present in the same payload is a protocol error — keep the
@@ -562,6 +811,7 @@ void ClientSession::handleCancel(const ::rapidjson::Document& doc) {
 
   for (auto& key : toCancel) {
     std::shared_ptr<gma::INode> root;
+    std::shared_ptr<engine::IStream> stream;
     {
       std::lock_guard<std::mutex> lk(reqMu_);
       auto it = active_.find(key);
@@ -570,9 +820,15 @@ void ClientSession::handleCancel(const ::rapidjson::Document& doc) {
         active_.erase(it);
       }
       chains_.erase(key);
+      releaseChargeLocked(key);
+      if (auto st = streams_.find(key); st != streams_.end()) {
+        stream = std::move(st->second);
+        streams_.erase(st);
+      }
     }
 
     if (root) root->shutdown();
+    if (stream) stream->stop();
 
     ::rapidjson::StringBuffer sb;
     ::rapidjson::Writer<::rapidjson::StringBuffer> w(sb);
@@ -100,9 +100,37 @@ bool Config::loadFromFile(const std::string& path) {
     else if (key == "feedPort")      { int p = std::atoi(val.c_str()); if (p > 0 && p <= 65535) feedPort = p; }
     else if (key == "threadPoolSize") { int v = std::atoi(val.c_str()); if (v >= 0) threadPoolSize = v; }
     else if (key == "taHistoryMax") { int v = std::atoi(val.c_str()); if (v > 0) taHistoryMax = v; }
+    else if (key == "taParallel") { taParallel = (val == "true" || val == "1" || val == "yes"); }
     else if (key == "maxSymbols") { int v = std::atoi(val.c_str()); if (v > 0) maxSymbols = v; }
     else if (key == "maxFieldsPerSymbol") { int v = std::atoi(val.c_str()); if (v > 0) maxFieldsPerSymbol = v; }
+    else if (key == "admissionCpu")             { double v = std::atof(val.c_str()); if (v >= 0) admissionCpu = v; }
+    else if (key == "admissionMemoryMB")        { int v = std::atoi(val.c_str()); if (v >= 0) admissionMemoryMB = v; }
+    else if (key == "admissionTimers")          { int v = std::atoi(val.c_str()); if (v >= 0) admissionTimers = v; }
+    else if (key == "admissionSessionCpu")      { double v = std::atof(val.c_str()); if (v >= 0) admissionSessionCpu = v; }
+    else if (key == "admissionSessionMemoryMB") { int v = std::atoi(val.c_str()); if (v >= 0) admissionSessionMemoryMB = v; }
+    else if (key == "admissionSessionTimers")   { int v = std::atoi(val.c_str()); if (v >= 0) admissionSessionTimers = v; }
     else if (key == "allowNegativePrices") { allowNegativePrices = (val == "true" || val == "1" || val == "yes"); }
+    else if (key == "bookTickLadderSymbols") {
+      bookTickLadderSymbols.clear();
+      std::istringstream ss(val);
+      std::string tok;
+      while (std::getline(ss, tok, ',')) {
+        auto t = trim(tok);
+        if (!t.empty()) bookTickLadderSymbols.push_back(t);
+      }
+    }
+    else if (key == "bookHugePages") { bookHugePages = (val == "true" || val == "1" || val == "yes"); }
+    else if (key == "bookTickWindow") { int v = std::atoi(val.c_str()); if (v > 0) bookTickWindow = v; }
+    else if (key == "bookDepthLimitSymbols") {
+      bookDepthLimitSymbols.clear();
+      std::istringstream ss(val);
+      std::string tok;
+      while (std::getline(ss, tok, ',')) {
+        auto t = trim(tok);
+        if (!t.empty()) bookDepthLimitSymbols.push_back(t);
+      }
+    }
+    else if (key == "bookDepthLimit") { int v = std::atoi(val.c_str()); if (v > 0) bookDepthLimit = v; }
     // Canonical ingress entries: ingress.N.kind = ..., ingress.N.<param> = ...
     else if (key.size() > 8 && key.substr(0, 8) == "ingress.") {
       auto dot2 = key.find('.', 8);
@@ -0,0 +1,255 @@
+#include "gma/util/ExprProgram.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace gma::util {
+
+namespace {
+
+using Op    = ExprProgram::Op;
+using Instr = ExprProgram::Instr;
+
+double apply1(Op op, double a) noexcept {
+  switch (op) {
+    case Op::Neg:  return -a;
+    case Op::Abs:  return std::abs(a);
+    case Op::Sqrt: return std::sqrt(std::abs(a));
+    case Op::Log:  return a > 0.0 ? std::log(a) : 0.0;
+    case Op::Exp:  return std::exp(a);
+    default:       return 0.0;
+  }
+}
+
+double apply2(Op op, double a, double b) noexcept {
+  switch (op) {
+    case Op::Add: return a + b;
+    case Op::Sub: return a - b;
+    case Op::Mul: return a * b;
+    case Op::Div: return std::abs(b) <= ExprProgram::DIV_EPSILON ? 0.0 : a / b;
+    case Op::Pow: return std::pow(a, b);
+    case Op::Min: return std::min(a, b);
+    case Op::Max: return std::max(a, b);
+    default:      return 0.0;
+  }
+}
+
+bool isUnary(Op op) noexcept {
+  return op == Op::Neg || op == Op::Abs || op == Op::Sqrt ||
+         op == Op::Log || op == Op::Exp;
+}
+
+// Recursive-descent parser emitting postfix code directly. Depth of
+// recursion is bounded by MAX_SOURCE_LEN.
+class Parser {
+public:
+  Parser(std::string_view src, const std::vector<std::string>& names)
+    : src_(src), names_(names) {}
+
+  std::vector<Instr> run() {
+    parseExpr();
+    skipWs();
+    if (pos_ != src_.size()) fail("unexpected '" + std::string(1, src_[pos_]) + "'");
+    return std::move(code_);
+  }
+
+private:
+  [[noreturn]] void fail(const std::string& msg) const {
+    throw std::runtime_error("ExprProgram: " + msg + " at column " +
+                             std::to_string(pos_ + 1));
+  }
+
+  void skipWs() {
+    while (pos_ < src_.size() && std::isspace(static_cast<unsigned char>(src_[pos_]))) ++pos_;
+  }
+
+  bool accept(char c) {
+    skipWs();
+    if (pos_ < src_.size() && src_[pos_] == c) { ++pos_; return true; }
+    return false;
+  }
+
+  void expect(char c) {
+    if (!accept(c)) fail(std::string("expected '") + c + "'");
+  }
+
+  void emit(Instr in) {
+    if (code_.size() >= ExprProgram::MAX_CODE) fail("expression too long");
+    code_.push_back(in);
+  }
+
+  void emitConst(double k) { emit({Op::Const, 0, k}); }
+
+  // Fold into the trailing constant(s) when every operand is known.
+  void emitOp(Op op) {
+    const std::size_t n = code_.size();
+    if (isUnary(op)) {
+      if (n >= 1 && code_[n - 1].op == Op::Const) {
+        code_[n - 1].k = apply1(op, code_[n - 1].k);
+        return;
+      }
+    } else if (n >= 2 && code_[n - 1].op == Op::Const && code_[n - 2].op == Op::Const) {
+      code_[n - 2].k = apply2(op, code_[n - 2].k, code_[n - 1].k);
+      code_.pop_back();
+      return;
+    }
+    emit({op, 0, 0.0});
+  }
+
+  void parseExpr() {
+    parseTerm();
+    for (;;) {
+      if (accept('+'))      { parseTerm(); emitOp(Op::Add); }
+      else if (accept('-')) { parseTerm(); emitOp(Op::Sub); }
+      else return;
+    }
+  }
+
+  void parseTerm() {
+    parseUnary();
+    for (;;) {
+      if (accept('*'))      { parseUnary(); emitOp(Op::Mul); }
+      else if (accept('/')) { parseUnary(); emitOp(Op::Div); }
+      else return;
+    }
+  }
+
+  void parseUnary() {
+    if (accept('-')) { parseUnary(); emitOp(Op::Neg); return; }
+    if (accept('+')) { parseUnary(); return; }
+    parsePower();
+  }
+
+  void parsePower() {
+    parsePrimary();
+    if (accept('^')) { parseUnary(); emitOp(Op::Pow); }
+  }
+
+  void parsePrimary() {
+    skipWs();
+    if (pos_ >= src_.size()) fail("unexpected end of expression");
+
+    if (accept('(')) {
+      parseExpr();
+      expect(')');
+      return;
+    }
+
+    const char c = src_[pos_];
+    if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+      // strtod needs a NUL-terminated buffer; numeric literals are short.
+      std::size_t end = pos_;
+      while (end < src_.size() &&
+             (std::isalnum(static_cast<unsigned char>(src_[end])) || src_[end] == '.' ||
+              ((src_[end] == '+' || src_[end] == '-') && end > pos_ &&
+               (src_[end - 1] == 'e' || src_[end - 1] == 'E'))))
+        ++end;
+      const std::string lit(src_.substr(pos_, end - pos_));
+      char* stop = nullptr;
+      const double k = std::strtod(lit.c_str(), &stop);
+      if (stop != lit.c_str() + lit.size() || !std::isfinite(k))
+        fail("bad number '" + lit + "'");
+      pos_ = end;
+      emitConst(k);
+      return;
+    }
+
+    if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+      std::size_t end = pos_;
+      while (end < src_.size() &&
+             (std::isalnum(static_cast<unsigned char>(src_[end])) || src_[end] == '_'))
+        ++end;
+      const std::string name(src_.substr(pos_, end - pos_));
+      pos_ = end;
+
+      if (accept('(')) {
+        parseCall(name);
+        return;
+      }
+      auto it = std::find(names_.begin(), names_.end(), name);
+      if (it == names_.end()) fail("unknown input '" + name + "'");
+      emit({Op::Load, static_cast<std::uint16_t>(it - names_.begin()), 0.0});
+      return;
+    }
+
+    fail("unexpected '" + std::string(1, c) + "'");
+  }
+
+  void parseCall(const std::string& fn) {
+    Op op;
+    int arity;
+    if      (fn == "abs")  { op = Op::Abs;  arity = 1; }
+    else if (fn == "sqrt") { op = Op::Sqrt; arity = 1; }
+    else if (fn == "log")  { op = Op::Log;  arity = 1; }
+    else if (fn == "exp")  { op = Op::Exp;  arity = 1; }
+    else if (fn == "min")  { op = Op::Min;  arity = 2; }
+    else if (fn == "max")  { op = Op::Max;  arity = 2; }
+    else if (fn == "pow")  { op = Op::Pow;  arity = 2; }
+    else fail("unknown function '" + fn + "'");
+
+    int argc = 0;
+    if (!accept(')')) {
+      do { parseExpr(); ++argc; } while (accept(','));
+      expect(')');
+    }
+    if (argc != arity)
+      fail(fn + "() takes " + std::to_string(arity) + " argument(s), got " +
+           std::to_string(argc));
+    emitOp(op);
+  }
+
+  std::string_view                src_;
+  const std::vector<std::string>& names_;
+  std::size_t                     pos_{0};
+  std::vector<Instr>              code_;
+};
+
+} // namespace
+
+ExprProgram ExprProgram::compile(std::string_view source,
+                                 const std::vector<std::string>& slotNames) {
+  if (source.size() > MAX_SOURCE_LEN)
+    throw std::runtime_error("ExprProgram: expression exceeds maximum length (1024)");
+  if (slotNames.size() > UINT16_MAX)
+    throw std::runtime_error("ExprProgram: too many inputs");
+
+  ExprProgram p;
+  p.code_ = Parser(source, slotNames).run();
+
+  std::size_t depth = 0;
+  for (const auto& in : p.code_) {
+    if (in.op == Op::Const || in.op == Op::Load) ++depth;
+    else if (!isUnary(in.op)) --depth;
+    p.depth_ = std::max(p.depth_, depth);
+  }
+  return p;
+}
+
+double ExprProgram::eval(const double* slots, double* stack) const noexcept {
+  std::size_t sp = 0;
+  for (const auto& in : code_) {
+    switch (in.op) {
+      case Op::Const: stack[sp++] = in.k;            break;
+      case Op::Load:  stack[sp++] = slots[in.slot];  break;
+      case Op::Neg: case Op::Abs: case Op::Sqrt: case Op::Log: case Op::Exp:
+        stack[sp - 1] = apply1(in.op, stack[sp - 1]);
+        break;
+      default:
+        --sp;
+        stack[sp - 1] = apply2(in.op, stack[sp - 1], stack[sp]);
+        break;
+    }
+  }
+  return sp ? stack[0] : 0.0;
+}
+
+bool ExprProgram::usesSlot(std::size_t i) const noexcept {
+  return std::any_of(code_.begin(), code_.end(), [i](const Instr& in) {
+    return in.op == Op::Load && in.slot == i;
+  });
+}
+
+} // namespace gma::util
@@ -0,0 +1,54 @@
+#include "gma/util/MappedFile.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GMA_MAPPED_FILE_MMAP 1
+#endif
+
+namespace gma {
+namespace util {
+
+MappedFile::MappedFile(const std::string& path) {
+#if defined(GMA_MAPPED_FILE_MMAP)
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("MappedFile: cannot open '" + path + "'");
+  struct stat st{};
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw std::runtime_error("MappedFile: cannot stat '" + path + "'");
+  }
+  size_ = static_cast<std::size_t>(st.st_size);
+  if (size_ > 0) {
+    void* mem = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mem == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("MappedFile: cannot map '" + path + "'");
+    }
+    ::madvise(mem, size_, MADV_SEQUENTIAL);   // advisory; failure is harmless
+    data_   = static_cast<const uint8_t*>(mem);
+    mapped_ = true;
+  }
+  ::close(fd);                                // the mapping outlives the fd
+#else
+  std::ifstream in(path, std::ios::binary);
+  if (!in) throw std::runtime_error("MappedFile: cannot open '" + path + "'");
+  copy_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  data_ = copy_.data();
+  size_ = copy_.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#if defined(GMA_MAPPED_FILE_MMAP)
+  if (mapped_) ::munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+}
+
+} // namespace util
+} // namespace gma
@@ -0,0 +1,351 @@
+#include "gma/util/VectorKernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+// x86 runtime dispatch is compiled only where we can both emit the
+// instructions (GCC/Clang target attributes, or MSVC which accepts the
+// intrinsics without /arch) and query CPUID. Everything else — ARM,
+// GMA_NO_SIMD builds — runs the scalar loops.
+#if !defined(GMA_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+  #define GMA_SIMD_X86 1
+  #include <immintrin.h>
+  #if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    #define GMA_TARGET_AVX2
+    #define GMA_TARGET_AVX512
+  #else
+    #define GMA_TARGET_AVX2   __attribute__((target("avx2")))
+    #define GMA_TARGET_AVX512 __attribute__((target("avx512f")))
+  #endif
+#endif
+
+namespace gma::util::simd {
+
+namespace {
+
+// Below this length the lane setup and horizontal reduce cost more than
+// they save; short vectors (Worker accumulators, the 2-3 element binary
+// ops) stay on the scalar path and keep bit-identical results.
+constexpr std::size_t MIN_VECTOR_LEN = 16;
+
+// ---------- Scalar reference (identical to the pre-SIMD builtin loops) ----------
+
+double sumScalar(const double* p, std::size_t n) noexcept {
+  double s = 0.0;
+  for (std::size_t i = 0; i < n; ++i) s += p[i];
+  return s;
+}
+
+double productScalar(const double* p, std::size_t n) noexcept {
+  double r = 1.0;
+  for (std::size_t i = 0; i < n; ++i) r *= p[i];
+  return r;
+}
+
+MinMax minMaxScalar(const double* p, std::size_t n) noexcept {
+  double lo = p[0], hi = p[0];
+  for (std::size_t i = 1; i < n; ++i) {
+    lo = std::min(lo, p[i]);
+    hi = std::max(hi, p[i]);
+  }
+  return {lo, hi};
+}
+
+double sumSqDevScalar(const double* p, std::size_t n, double mean) noexcept {
+  double ss = 0.0;
+  for (std::size_t i = 0; i < n; ++i) { double d = p[i] - mean; ss += d * d; }
+  return ss;
+}
+
+#if defined(GMA_SIMD_X86)
+
+// ---------- CPU feature detection ----------
+
+Isa probeIsa() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int r[4];
+  __cpuid(r, 0);
+  if (r[0] < 7) return Isa::Scalar;
+  __cpuid(r, 1);
+  const bool osxsave = (r[2] & (1 << 27)) != 0;
+  if (!osxsave) return Isa::Scalar;
+  const unsigned long long xcr0 = _xgetbv(0);
+  const bool ymmState = (xcr0 & 0x6) == 0x6;
+  const bool zmmState = (xcr0 & 0xE6) == 0xE6;
+  __cpuidex(r, 7, 0);
+  const bool avx2    = (r[1] & (1 << 5))  != 0;
+  const bool avx512f = (r[1] & (1 << 16)) != 0;
+  if (avx512f && zmmState) return Isa::Avx512;
+  if (avx2 && ymmState)    return Isa::Avx2;
+  return Isa::Scalar;
+#else
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return Isa::Avx512;
+  if (__builtin_cpu_supports("avx2"))    return Isa::Avx2;
+  return Isa::Scalar;
+#endif
+}
+
+// ---------- AVX2 (4 x double lanes, 4 accumulators) ----------
+
+GMA_TARGET_AVX2 inline double hsum256(__m256d v) {
+  __m128d lo = _mm256_castpd256_pd128(v);
+  __m128d hi = _mm256_extractf128_pd(v, 1);
+  lo = _mm_add_pd(lo, hi);
+  return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+GMA_TARGET_AVX2 double sumAvx2(const double* p, std::size_t n) {
+  __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    a0 = _mm256_add_pd(a0, _mm256_loadu_pd(p + i));
+    a1 = _mm256_add_pd(a1, _mm256_loadu_pd(p + i + 4));
+    a2 = _mm256_add_pd(a2, _mm256_loadu_pd(p + i + 8));
+    a3 = _mm256_add_pd(a3, _mm256_loadu_pd(p + i + 12));
+  }
+  for (; i + 4 <= n; i += 4) a0 = _mm256_add_pd(a0, _mm256_loadu_pd(p + i));
+  double s = hsum256(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+  for (; i < n; ++i) s += p[i];
+  return s;
+}
+
+GMA_TARGET_AVX2 double productAvx2(const double* p, std::size_t n) {
+  __m256d a0 = _mm256_set1_pd(1.0), a1 = a0, a2 = a0, a3 = a0;
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    a0 = _mm256_mul_pd(a0, _mm256_loadu_pd(p + i));
+    a1 = _mm256_mul_pd(a1, _mm256_loadu_pd(p + i + 4));
+    a2 = _mm256_mul_pd(a2, _mm256_loadu_pd(p + i + 8));
+    a3 = _mm256_mul_pd(a3, _mm256_loadu_pd(p + i + 12));
+  }
+  for (; i + 4 <= n; i += 4) a0 = _mm256_mul_pd(a0, _mm256_loadu_pd(p + i));
+  const __m256d v = _mm256_mul_pd(_mm256_mul_pd(a0, a1), _mm256_mul_pd(a2, a3));
+  alignas(32) double lanes[4];
+  _mm256_store_pd(lanes, v);
+  double r = (lanes[0] * lanes[1]) * (lanes[2] * lanes[3]);
+  for (; i < n; ++i) r *= p[i];
+  return r;
+}
+
+GMA_TARGET_AVX2 MinMax minMaxAvx2(const double* p, std::size_t n) {
+  __m256d lo0 = _mm256_loadu_pd(p), lo1 = lo0, hi0 = lo0, hi1 = lo0;
+  std::size_t i = 4;
+  for (; i + 8 <= n; i += 8) {
+    const __m256d x0 = _mm256_loadu_pd(p + i);
+    const __m256d x1 = _mm256_loadu_pd(p + i + 4);
+    lo0 = _mm256_min_pd(lo0, x0); hi0 = _mm256_max_pd(hi0, x0);
+    lo1 = _mm256_min_pd(lo1, x1); hi1 = _mm256_max_pd(hi1, x1);
+  }
+  lo0 = _mm256_min_pd(lo0, lo1);
+  hi0 = _mm256_max_pd(hi0, hi1);
+  alignas(32) double l[4], h[4];
+  _mm256_store_pd(l, lo0);
+  _mm256_store_pd(h, hi0);
+  double mn = std::min(std::min(l[0], l[1]), std::min(l[2], l[3]));
+  double mx = std::max(std::max(h[0], h[1]), std::max(h[2], h[3]));
+  for (; i < n; ++i) { mn = std::min(mn, p[i]); mx = std::max(mx, p[i]); }
+  return {mn, mx};
+}
+
+GMA_TARGET_AVX2 double sumSqDevAvx2(const double* p, std::size_t n, double mean) {
+  const __m256d m = _mm256_set1_pd(mean);
+  __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(p + i),      m);
+    const __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(p + i + 4),  m);
+    const __m256d d2 = _mm256_sub_pd(_mm256_loadu_pd(p + i + 8),  m);
+    const __m256d d3 = _mm256_sub_pd(_mm256_loadu_pd(p + i + 12), m);
+    a0 = _mm256_add_pd(a0, _mm256_mul_pd(d0, d0));
+    a1 = _mm256_add_pd(a1, _mm256_mul_pd(d1, d1));
+    a2 = _mm256_add_pd(a2, _mm256_mul_pd(d2, d2));
+    a3 = _mm256_add_pd(a3, _mm256_mul_pd(d3, d3));
+  }
+  for (; i + 4 <= n; i += 4) {
+    const __m256d d = _mm256_sub_pd(_mm256_loadu_pd(p + i), m);
+    a0 = _mm256_add_pd(a0, _mm256_mul_pd(d, d));
+  }
+  double ss = hsum256(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+  for (; i < n; ++i) { double d = p[i] - mean; ss += d * d; }
+  return ss;
+}
+
+// ---------- AVX-512F (8 x double lanes, 4 accumulators) ----------
+
+// GCC 12's avx512fintrin.h seeds masked builtins with _mm512_undefined_pd(),
+// which trips -Wuninitialized once inlined. The values are never read.
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wuninitialized"
+  #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+GMA_TARGET_AVX512 double sumAvx512(const double* p, std::size_t n) {
+  __m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    a0 = _mm512_add_pd(a0, _mm512_loadu_pd(p + i));
+    a1 = _mm512_add_pd(a1, _mm512_loadu_pd(p + i + 8));
+    a2 = _mm512_add_pd(a2, _mm512_loadu_pd(p + i + 16));
+    a3 = _mm512_add_pd(a3, _mm512_loadu_pd(p + i + 24));
+  }
+  for (; i + 8 <= n; i += 8) a0 = _mm512_add_pd(a0, _mm512_loadu_pd(p + i));
+  double s = _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+  for (; i < n; ++i) s += p[i];
+  return s;
+}
+
+GMA_TARGET_AVX512 double productAvx512(const double* p, std::size_t n) {
+  __m512d a0 = _mm512_set1_pd(1.0), a1 = a0, a2 = a0, a3 = a0;
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    a0 = _mm512_mul_pd(a0, _mm512_loadu_pd(p + i));
+    a1 = _mm512_mul_pd(a1, _mm512_loadu_pd(p + i + 8));
+    a2 = _mm512_mul_pd(a2, _mm512_loadu_pd(p + i + 16));
+    a3 = _mm512_mul_pd(a3, _mm512_loadu_pd(p + i + 24));
+  }
+  for (; i + 8 <= n; i += 8) a0 = _mm512_mul_pd(a0, _mm512_loadu_pd(p + i));
+  double r = _mm512_reduce_mul_pd(_mm512_mul_pd(_mm512_mul_pd(a0, a1), _mm512_mul_pd(a2, a3)));
+  for (; i < n; ++i) r *= p[i];
+  return r;
+}
+
+GMA_TARGET_AVX512 MinMax minMaxAvx512(const double* p, std::size_t n) {
+  // n >= MIN_VECTOR_LEN (16) is guaranteed by the dispatcher.
+  __m512d lo0 = _mm512_loadu_pd(p), lo1 = _mm512_loadu_pd(p + 8);
+  __m512d hi0 = lo0, hi1 = lo1;
+  std::size_t i = 16;
+  for (; i + 16 <= n; i += 16) {
+    const __m512d x0 = _mm512_loadu_pd(p + i);
+    const __m512d x1 = _mm512_loadu_pd(p + i + 8);
+    lo0 = _mm512_min_pd(lo0, x0); hi0 = _mm512_max_pd(hi0, x0);
+    lo1 = _mm512_min_pd(lo1, x1); hi1 = _mm512_max_pd(hi1, x1);
+  }
+  double mn = _mm512_reduce_min_pd(_mm512_min_pd(lo0, lo1));
+  double mx = _mm512_reduce_max_pd(_mm512_max_pd(hi0, hi1));
+  for (; i < n; ++i) { mn = std::min(mn, p[i]); mx = std::max(mx, p[i]); }
+  return {mn, mx};
+}
+
+GMA_TARGET_AVX512 double sumSqDevAvx512(const double* p, std::size_t n, double mean) {
+  const __m512d m = _mm512_set1_pd(mean);
+  __m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m512d d0 = _mm512_sub_pd(_mm512_loadu_pd(p + i),      m);
+    const __m512d d1 = _mm512_sub_pd(_mm512_loadu_pd(p + i + 8),  m);
+    const __m512d d2 = _mm512_sub_pd(_mm512_loadu_pd(p + i + 16), m);
+    const __m512d d3 = _mm512_sub_pd(_mm512_loadu_pd(p + i + 24), m);
+    a0 = _mm512_fmadd_pd(d0, d0, a0);
+    a1 = _mm512_fmadd_pd(d1, d1, a1);
+    a2 = _mm512_fmadd_pd(d2, d2, a2);
+    a3 = _mm512_fmadd_pd(d3, d3, a3);
+  }
+  for (; i + 8 <= n; i += 8) {
+    const __m512d d = _mm512_sub_pd(_mm512_loadu_pd(p + i), m);
+    a0 = _mm512_fmadd_pd(d, d, a0);
+  }
+  double ss = _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+  for (; i < n; ++i) { double d = p[i] - mean; ss += d * d; }
+  return ss;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC diagnostic pop
+#endif
+
+#else  // !GMA_SIMD_X86
+
+Isa probeIsa() noexcept { return Isa::Scalar; }
+
+#endif
+
+std::atomic<int>& activeSlot() noexcept {
+  static std::atomic<int> slot{static_cast<int>(detectedIsa())};
+  return slot;
+}
+
+inline Isa current() noexcept {
+  return static_cast<Isa>(activeSlot().load(std::memory_order_relaxed));
+}
+
+} // namespace
+
+Isa detectedIsa() noexcept {
+  static const Isa isa = probeIsa();
+  return isa;
+}
+
+Isa activeIsa() noexcept { return current(); }
+
+Isa forceIsa(Isa isa) noexcept {
+  const Isa chosen = static_cast<int>(isa) > static_cast<int>(detectedIsa())
+                       ? detectedIsa() : isa;
+  activeSlot().store(static_cast<int>(chosen), std::memory_order_relaxed);
+  return chosen;
+}
+
+const char* isaName(Isa isa) noexcept {
+  switch (isa) {
+    case Isa::Avx512: return "avx512";
+    case Isa::Avx2:   return "avx2";
+    case Isa::Scalar: return "scalar";
+  }
+  return "scalar";
+}
+
+double sum(const double* p, std::size_t n) noexcept {
+#if defined(GMA_SIMD_X86)
+  if (n >= MIN_VECTOR_LEN) {
+    switch (current()) {
+      case Isa::Avx512: return sumAvx512(p, n);
+      case Isa::Avx2:   return sumAvx2(p, n);
+      case Isa::Scalar: break;
+    }
+  }
+#endif
+  return sumScalar(p, n);
+}
+
+double product(const double* p, std::size_t n) noexcept {
+#if defined(GMA_SIMD_X86)
+  if (n >= MIN_VECTOR_LEN) {
+    switch (current()) {
+      case Isa::Avx512: return productAvx512(p, n);
+      case Isa::Avx2:   return productAvx2(p, n);
+      case Isa::Scalar: break;
+    }
+  }
+#endif
+  return productScalar(p, n);
+}
+
+MinMax minMax(const double* p, std::size_t n) noexcept {
+#if defined(GMA_SIMD_X86)
+  if (n >= MIN_VECTOR_LEN) {
+    switch (current()) {
+      case Isa::Avx512: return minMaxAvx512(p, n);
+      case Isa::Avx2:   return minMaxAvx2(p, n);
+      case Isa::Scalar: break;
+    }
+  }
+#endif
+  return minMaxScalar(p, n);
+}
+
+double sumSqDev(const double* p, std::size_t n, double mean) noexcept {
+#if defined(GMA_SIMD_X86)
+  if (n >= MIN_VECTOR_LEN) {
+    switch (current()) {
+      case Isa::Avx512: return sumSqDevAvx512(p, n, mean);
+      case Isa::Avx2:   return sumSqDevAvx2(p, n, mean);
+      case Isa::Scalar: break;
+    }
+  }
+#endif
+  return sumSqDevScalar(p, n, mean);
+}
+
+} // namespace gma::util::simd
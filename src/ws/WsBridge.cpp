@@ -1,6 +1,7 @@
 #include "gma/ws/WsBridge.hpp"
 #include "gma/TreeBuilder.hpp"
 #include "gma/JsonValidator.hpp"
+#include "gma/PlanCache.hpp"
 #include "gma/ws/WSResponder.hpp"
 #include "gma/util/Logger.hpp"
 
@@ -55,6 +56,8 @@ void WsBridge::handleSubscribe(const std::string& connId, const rapidjson::Docum
     return;
   }
 
+  std::string planKey;   // reused across requests
+
   for (const auto& r : doc["requests"].GetArray()) {
     if (!r.IsObject()) continue;
 
@@ -125,54 +128,38 @@ void WsBridge::handleSubscribe(const std::string& connId, const rapidjson::Docum
 
     auto terminal = std::make_shared<gma::ws::WSResponder>(reqId, sendCb);
 
-    // Build request JSON for TreeBuilder
-    rapidjson::Document rq;
-    rq.SetObject();
-    auto& a = rq.GetAllocator();
-    rq.AddMember("streamKey", rapidjson::Value(streamKey.c_str(), a), a);
-    rq.AddMember("field",  rapidjson::Value(field.c_str(), a), a);
-
-    // Pass through pipeline/stages/node so the full tree can be built.
-    if (r.HasMember("pipeline") && r["pipeline"].IsArray()) {
-      rapidjson::Value pipe(rapidjson::kArrayType);
-      pipe.CopyFrom(r["pipeline"], a);
-      rq.AddMember("pipeline", pipe, a);
-    }
-    if (r.HasMember("stages") && r["stages"].IsArray()) {
-      rapidjson::Value stages(rapidjson::kArrayType);
-      stages.CopyFrom(r["stages"], a);
-      rq.AddMember("stages", stages, a);
-    }
-    if (r.HasMember("node") && r["node"].IsObject()) {
-      rapidjson::Value node(rapidjson::kObjectType);
-      node.CopyFrom(r["node"], a);
-      rq.AddMember("node", node, a);
-    }
+    // Compiled plan for this request shape; a hit skips validation and
+    // compilation (see PlanCache).
+    auto& plans = gma::tree::PlanCache::instance();
+    gma::tree::PlanCache::canonicalKey(r, planKey);
+    auto plan = plans.find(planKey);
 
-    // Validate pipeline/stages/node sub-trees before building.
-    try {
-      if (r.HasMember("pipeline") && r["pipeline"].IsArray()) {
-        for (const auto& elem : r["pipeline"].GetArray()) {
-          if (elem.IsObject()) gma::JsonValidator::validateTree(elem);
+    // Validate pipeline/stages/node sub-trees before compiling.
+    if (!plan) {
+      try {
+        if (r.HasMember("pipeline") && r["pipeline"].IsArray()) {
+          for (const auto& elem : r["pipeline"].GetArray()) {
+            if (elem.IsObject()) gma::JsonValidator::validateTree(elem);
+          }
         }
-      }
-      if (r.HasMember("stages") && r["stages"].IsArray()) {
-        for (const auto& elem : r["stages"].GetArray()) {
-          if (elem.IsObject()) gma::JsonValidator::validateTree(elem);
+        if (r.HasMember("stages") && r["stages"].IsArray()) {
+          for (const auto& elem : r["stages"].GetArray()) {
+            if (elem.IsObject()) gma::JsonValidator::validateTree(elem);
+          }
         }
+        if (r.HasMember("node") && r["node"].IsObject()) {
+          gma::JsonValidator::validateTree(r["node"]);
+        }
+      } catch (const std::exception& ex) {
+        rapidjson::StringBuffer sb;
+        rapidjson::Writer<rapidjson::StringBuffer> w(sb);
+        w.StartObject();
+        w.Key("type");    w.String("error");
+        w.Key("message"); w.String(ex.what());
+        w.EndObject();
+        sendTo(connId, sb.GetString());
+        continue;
       }
-      if (r.HasMember("node") && r["node"].IsObject()) {
-        gma::JsonValidator::validateTree(r["node"]);
-      }
-    } catch (const std::exception& ex) {
-      rapidjson::StringBuffer sb;
-      rapidjson::Writer<rapidjson::StringBuffer> w(sb);
-      w.StartObject();
-      w.Key("type");    w.String("error");
-      w.Key("message"); w.String(ex.what());
-      w.EndObject();
-      sendTo(connId, sb.GetString());
-      continue;
     }
 
     gma::tree::Deps deps;
@@ -181,7 +168,8 @@ void WsBridge::handleSubscribe(const std::string& connId, const rapidjson::Docum
     deps.dispatcher = dispatcher_.get();
 
     try {
-      auto built = gma::tree::buildForRequest(rq, deps, terminal);
+      if (!plan) plan = plans.insert(planKey, gma::tree::compileRequest(r));
+      auto built = gma::tree::buildFromPlan(*plan, deps, terminal);
 
       {
         std::lock_guard<std::mutex> lk(mx_);
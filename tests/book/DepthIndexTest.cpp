@@ -0,0 +1,195 @@
+#include "gma/book/DepthIndex.hpp"
+#include "gma/book/OrderBook.hpp"
+#include "gma/book/OrderBookManager.hpp"
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+
+using namespace gma;
+
+namespace {
+
+struct Ref {
+    uint64_t size = 0;
+    uint32_t orders = 0;
+};
+
+// Reference sums by walking a sorted map best-first.
+DepthSums refRanks(const std::map<int64_t, Ref>& m, bool descending, size_t first, size_t last) {
+    DepthSums s;
+    size_t r = 0;
+    auto visit = [&](int64_t t, const Ref& l) {
+        ++r;
+        if (r < first || r > last) return;
+        ++s.levels; s.orders += l.orders; s.size += l.size;
+        s.ticks += t; s.notional += t * static_cast<int64_t>(l.size);
+    };
+    if (descending) for (auto it = m.rbegin(); it != m.rend(); ++it) visit(it->first, it->second);
+    else            for (const auto& [t, l] : m) visit(t, l);
+    return s;
+}
+
+DepthSums refBand(const std::map<int64_t, Ref>& m, int64_t lo, int64_t hi) {
+    DepthSums s;
+    for (auto it = m.lower_bound(lo); it != m.end() && it->first <= hi; ++it) {
+        ++s.levels; s.orders += it->second.orders; s.size += it->second.size;
+        s.ticks += it->first; s.notional += it->first * static_cast<int64_t>(it->second.size);
+    }
+    return s;
+}
+
+void expectSums(const DepthSums& got, const DepthSums& want) {
+    EXPECT_EQ(got.levels, want.levels);
+    EXPECT_EQ(got.orders, want.orders);
+    EXPECT_EQ(got.size, want.size);
+    EXPECT_EQ(got.ticks, want.ticks);
+    EXPECT_EQ(got.notional, want.notional);
+}
+
+} // namespace
+
+TEST(DepthIndexTest, TopRanksAndBandsOnBothSides) {
+    DepthIndex bids(true), asks(false);
+    bids.set(100, 10, 1); bids.set(99, 20, 2); bids.set(97, 30, 3);
+    asks.set(101, 15, 1); asks.set(103, 25, 1);
+
+    EXPECT_EQ(bids.levels(), 3u);
+    auto t2 = bids.top(2);
+    EXPECT_EQ(t2.levels, 2u);
+    EXPECT_EQ(t2.size, 30u);
+    EXPECT_EQ(t2.orders, 3u);
+    EXPECT_EQ(t2.notional, 100 * 10 + 99 * 20);
+    EXPECT_EQ(bids.ranks(2, 3).size, 50u);
+    EXPECT_EQ(bids.top(10).size, 60u);                  // clamped
+    EXPECT_EQ(bids.ranks(4, 9).levels, 0u);
+    EXPECT_EQ(asks.top(1).ticks, 101);
+    EXPECT_EQ(asks.band(102, 103).size, 25u);
+    EXPECT_EQ(bids.band(98, 99).size, 20u);
+
+    bids.set(99, 0, 0);                                 // level leaves
+    EXPECT_EQ(bids.levels(), 2u);
+    EXPECT_EQ(bids.ranks(2, 2).ticks, 97);
+    bids.set(100, 4, 1);                                // size change in place
+    EXPECT_EQ(bids.top(1).size, 4u);
+}
+
+TEST(DepthIndexTest, GrowsRecentresAndOverflows) {
+    DepthIndex bids(true);
+    bids.set(1'000, 1, 1);
+    EXPECT_EQ(bids.window(), DepthIndex::INITIAL_WINDOW);
+    bids.set(1'000 + 1'000, 2, 1);                      // wider: window grows
+    EXPECT_GT(bids.window(), DepthIndex::INITIAL_WINDOW);
+    EXPECT_EQ(bids.overflowSize(), 0u);
+
+    const int64_t far = static_cast<int64_t>(DepthIndex::MAX_WINDOW);
+    bids.set(1'000 - far, 3, 1);                        // far worse price: overflow
+    EXPECT_EQ(bids.overflowSize(), 1u);
+    bids.set(2'000 + far, 4, 1);                        // far better price: re-centre
+    EXPECT_EQ(bids.top(1).ticks, 2'000 + far);
+    EXPECT_EQ(bids.levels(), 4u);
+    EXPECT_EQ(bids.top(4).size, 10u);
+    EXPECT_EQ(bids.ranks(4, 4).ticks, 1'000 - far);
+    EXPECT_EQ(bids.band(0, 5'000).size, 3u);
+
+    bids.clear();
+    EXPECT_EQ(bids.levels(), 0u);
+    EXPECT_EQ(bids.top(5).levels, 0u);
+}
+
+TEST(DepthIndexTest, MatchesReferenceUnderRandomChurn) {
+    for (bool descending : {true, false}) {
+        DepthIndex idx(descending);
+        std::map<int64_t, Ref> ref;
+        std::mt19937_64 rng(descending ? 11 : 12);
+        int64_t mid = 50'000;
+        for (int step = 0; step < 40'000; ++step) {
+            mid += static_cast<int64_t>(rng() % 3) - 1;
+            // Mostly near the touch, sometimes very far away.
+            const int64_t off = (rng() % 200 == 0) ? static_cast<int64_t>(rng() % 300'000)
+                                                   : static_cast<int64_t>(rng() % 64);
+            const int64_t t = (rng() & 1) ? mid + off : mid - off;
+            if (rng() % 3 == 0 && ref.count(t)) {
+                idx.set(t, 0, 0);
+                ref.erase(t);
+            } else {
+                Ref l{ 1 + rng() % 1000, static_cast<uint32_t>(1 + rng() % 5) };
+                idx.set(t, l.size, l.orders);
+                ref[t] = l;
+            }
+            if (step % 500 == 0) {
+                ASSERT_EQ(idx.levels(), ref.size());
+                const size_t a = 1 + rng() % 20, b = a + rng() % 40;
+                expectSums(idx.ranks(a, b), refRanks(ref, descending, a, b));
+                expectSums(idx.top(ref.size()), refRanks(ref, descending, 1, ref.size()));
+                const int64_t lo = mid - static_cast<int64_t>(rng() % 100);
+                const int64_t hi = mid + static_cast<int64_t>(rng() % 100);
+                expectSums(idx.band(lo, hi), refBand(ref, lo, hi));
+            }
+        }
+    }
+}
+
+TEST(DepthIndexTest, OrderBookKeepsIndexInStep) {
+    for (auto kind : {LadderKind::Map, LadderKind::Tick}) {
+        OrderBook ob(LadderConfig{kind, 256});
+        std::mt19937_64 rng(5);
+        uint64_t nextId = 1;
+        std::vector<uint64_t> live;
+        for (int step = 0; step < 20'000; ++step) {
+            const unsigned r = rng() % 10;
+            if (r < 5 || live.empty()) {
+                Order o; o.id = nextId; o.side = (rng() & 1) ? Side::Bid : Side::Ask;
+                const int64_t off = static_cast<int64_t>(rng() % 40);
+                o.price = Price{o.side == Side::Bid ? 1'000 - off : 1'001 + off};
+                o.size = 1 + rng() % 100;
+                ob.applyAdd(o);
+                live.push_back(nextId++);
+            } else {
+                const size_t i = rng() % live.size();
+                if (r < 7) {
+                    ob.applyDelete(live[i]);
+                    live[i] = live.back(); live.pop_back();
+                } else if (r < 8) {
+                    ob.applyUpdate(live[i], std::nullopt, 1 + rng() % 100);
+                } else if (r < 9) {
+                    auto best = ob.bestBid();
+                    if (best) ob.applyTrade(*best, 1 + rng() % 50, Aggressor::Sell);
+                } else {
+                    Side s; Price p;
+                    if (ob.locate(OrderKey{live[i], 0, 0, false}, s, p)) {
+                        ob.applyUpdate(live[i], Price{s == Side::Bid ? p.ticks - 1 : p.ticks + 1}, std::nullopt);
+                    }
+                }
+            }
+            if (step % 1000 == 0) {
+                std::string why;
+                ASSERT_TRUE(ob.checkInvariants(&why)) << why;
+            }
+        }
+        std::string why;
+        EXPECT_TRUE(ob.checkInvariants(&why)) << why;
+
+        uint64_t want = 0;
+        ob.forEachLevel(Side::Ask, 5, [&](Price, uint64_t sz) { want += sz; });
+        EXPECT_EQ(ob.depthByRank(Side::Ask, 1, 5).size, want);
+        ob.applySnapshotPerOrder({});
+        EXPECT_EQ(ob.levelCount(Side::Bid), 0u);
+        EXPECT_EQ(ob.depthByRank(Side::Bid, 1, 100).size, 0u);
+    }
+}
+
+TEST(DepthIndexTest, ManagerBandSnapsToTickGrid) {
+    OrderBookManager mgr;
+    mgr.setTickSize("S", 0.5);
+    mgr.onAdd("S", 1, Side::Bid, 100.0, 10, 0);
+    mgr.onAdd("S", 2, Side::Bid,  99.5, 20, 0);
+    mgr.onAdd("S", 3, Side::Bid,  99.0, 30, 0);
+
+    EXPECT_EQ(mgr.depthByPrice("S", Side::Bid, 99.2, 100.0).size, 30u);   // 99.5 and 100
+    EXPECT_EQ(mgr.depthByPrice("S", Side::Bid, 99.0, 99.0).size, 30u);
+    EXPECT_EQ(mgr.depthByPrice("S", Side::Bid, 100.1, 100.4).size, 0u);
+    const auto top2 = mgr.depthByRank("S", Side::Bid, 1, 2);
+    EXPECT_EQ(top2.size, 30u);
+    EXPECT_EQ(top2.notional, 200 * 10 + 199 * 20);                        // ticks
+    EXPECT_EQ(mgr.depthByRank("nope", Side::Bid, 1, 2).levels, 0u);
+}
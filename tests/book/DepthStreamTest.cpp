@@ -0,0 +1,204 @@
+#include "gma/book/DepthStream.hpp"
+#include "gma/book/OrderBookManager.hpp"
+#include "gma/market/MarketIngress.hpp"
+#include <boost/asio/io_context.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace gma;
+
+namespace {
+
+using Ladder = std::vector<std::pair<Price, uint64_t>>;
+
+Ladder ladder(std::initializer_list<std::pair<int64_t, uint64_t>> l) {
+    Ladder out;
+    for (const auto& [t, sz] : l) out.emplace_back(Price{t}, sz);
+    return out;
+}
+
+// A book plus a 3-level stream whose frames are decoded as they arrive.
+struct StreamFixture {
+    std::shared_ptr<OrderBookManager> books = std::make_shared<OrderBookManager>();
+    std::vector<DepthFrame> frames;
+    bool accept = true;
+    std::shared_ptr<DepthStreamer> stream;
+
+    StreamFixture() {
+        books->setTickSize("S", 0.5);
+        books->onAdd("S", 1, Side::Bid, 100.0, 10, 0);
+        books->onAdd("S", 2, Side::Bid,  99.5, 20, 0);
+        books->onAdd("S", 3, Side::Bid,  99.0, 30, 0);
+        books->onAdd("S", 4, Side::Bid,  98.5, 40, 0);
+        books->onAdd("S", 5, Side::Ask, 100.5, 15, 0);
+        stream = DepthStreamer::create(books, "S", 7, 3, [this](std::string bytes) {
+            if (!accept) return false;
+            auto f = decodeDepthFrame(bytes);
+            EXPECT_TRUE(f.has_value());
+            if (f) frames.push_back(std::move(*f));
+            return true;
+        });
+    }
+};
+
+} // namespace
+
+TEST(DepthStreamTest, FrameRoundTripsAndRejectsTruncation) {
+    DepthFrame f;
+    f.type = DepthFrame::Type::Snapshot;
+    f.streamId = 300;
+    f.seq = 1'000'000'007;
+    f.epoch = 3;
+    f.tick = 0.01;
+    f.bids = ladder({{10'050, 100}, {10'049, 0}, {-5, 1}});
+    f.asks = ladder({{10'051, 7}});
+
+    const std::string bytes = encodeDepthFrame(f);
+    auto back = decodeDepthFrame(bytes);
+    ASSERT_TRUE(back.has_value());
+    EXPECT_EQ(back->type, DepthFrame::Type::Snapshot);
+    EXPECT_EQ(back->streamId, 300u);
+    EXPECT_EQ(back->seq, f.seq);
+    EXPECT_EQ(back->epoch, 3u);
+    EXPECT_DOUBLE_EQ(back->tick, 0.01);
+    EXPECT_EQ(back->bids, f.bids);
+    EXPECT_EQ(back->asks, f.asks);
+
+    // Neighbouring levels cost a couple of bytes each.
+    DepthFrame d;
+    d.type = DepthFrame::Type::Delta;
+    d.seq = 9; d.prevSeq = 8;
+    d.bids = ladder({{10'050, 5}, {10'049, 6}, {10'048, 0}});
+    const std::string small = encodeDepthFrame(d);
+    EXPECT_LE(small.size(), 16u);
+    auto db = decodeDepthFrame(small);
+    ASSERT_TRUE(db.has_value());
+    EXPECT_EQ(db->prevSeq, 8u);
+    EXPECT_EQ(db->bids, d.bids);
+
+    for (std::size_t n = 0; n < bytes.size(); ++n)
+        EXPECT_FALSE(decodeDepthFrame(std::string_view(bytes).substr(0, n)).has_value()) << n;
+    EXPECT_FALSE(decodeDepthFrame(bytes + "x").has_value());
+    EXPECT_FALSE(decodeDepthFrame("\x09").has_value());
+}
+
+TEST(DepthStreamTest, SnapshotThenConflatedDeltas) {
+    StreamFixture f;
+    ASSERT_TRUE(f.stream->flush());
+    ASSERT_EQ(f.frames.size(), 1u);
+    const DepthFrame snap = f.frames[0];
+    EXPECT_EQ(snap.type, DepthFrame::Type::Snapshot);
+    EXPECT_EQ(snap.streamId, 7u);
+    EXPECT_DOUBLE_EQ(snap.tick, 0.5);
+    EXPECT_EQ(snap.bids, ladder({{200, 10}, {199, 20}, {198, 30}}));
+    EXPECT_EQ(snap.asks, ladder({{201, 15}}));
+    EXPECT_FALSE(f.stream->flush());                    // nothing pending
+
+    // Three updates to one level between flushes: one entry, last value.
+    f.books->onUpdate("S", 2, FeedScope{}, std::nullopt, 21);
+    f.books->onUpdate("S", 2, FeedScope{}, std::nullopt, 22);
+    f.books->onUpdate("S", 2, FeedScope{}, std::nullopt, 23);
+    ASSERT_TRUE(f.stream->flush());
+    ASSERT_EQ(f.frames.size(), 2u);
+    const DepthFrame& d = f.frames[1];
+    EXPECT_EQ(d.type, DepthFrame::Type::Delta);
+    EXPECT_EQ(d.prevSeq, snap.seq);
+    EXPECT_GT(d.seq, snap.seq);
+    EXPECT_EQ(d.bids, ladder({{199, 23}}));
+    EXPECT_TRUE(d.asks.empty());
+}
+
+TEST(DepthStreamTest, ChangesOutsideTheViewSendNothing) {
+    StreamFixture f;
+    ASSERT_TRUE(f.stream->flush());
+    f.books->onUpdate("S", 4, FeedScope{}, std::nullopt, 41);   // 4th bid level
+    EXPECT_FALSE(f.stream->flush());
+    EXPECT_EQ(f.frames.size(), 1u);
+
+    // The best bid leaves: the old 4th level slides into view.
+    f.books->onDelete("S", 1, FeedScope{});
+    ASSERT_TRUE(f.stream->flush());
+    ASSERT_EQ(f.frames.size(), 2u);
+    EXPECT_EQ(f.frames[1].bids, ladder({{200, 0}, {197, 41}}));
+}
+
+TEST(DepthStreamTest, RefusedFrameIsRetriedWithLaterChanges) {
+    StreamFixture f;
+    ASSERT_TRUE(f.stream->flush());
+    f.accept = false;
+    f.books->onUpdate("S", 1, FeedScope{}, std::nullopt, 11);
+    EXPECT_FALSE(f.stream->flush());
+    f.books->onUpdate("S", 5, FeedScope{}, std::nullopt, 16);
+    EXPECT_FALSE(f.stream->flush());
+
+    f.accept = true;
+    ASSERT_TRUE(f.stream->flush());
+    ASSERT_EQ(f.frames.size(), 2u);
+    EXPECT_EQ(f.frames[1].prevSeq, f.frames[0].seq);   // chain unbroken
+    EXPECT_EQ(f.frames[1].bids, ladder({{200, 11}}));
+    EXPECT_EQ(f.frames[1].asks, ladder({{201, 16}}));
+}
+
+TEST(DepthStreamTest, BookReplacementTriggersResnapshot) {
+    StreamFixture f;
+    ASSERT_TRUE(f.stream->flush());
+    Order bid; bid.id = 10; bid.side = Side::Bid; bid.price = Price{198}; bid.size = 5;
+    Order ask; ask.id = 11; ask.side = Side::Ask; ask.price = Price{199}; ask.size = 6;
+    f.books->onReset("S", 2);
+    f.books->onSnapshotPerOrder("S", {bid, ask}, 100);
+    ASSERT_TRUE(f.stream->flush());
+    ASSERT_EQ(f.frames.size(), 2u);
+    const DepthFrame& s = f.frames[1];
+    EXPECT_EQ(s.type, DepthFrame::Type::Snapshot);
+    EXPECT_EQ(s.epoch, 2u);
+    EXPECT_EQ(s.prevSeq, 0u);
+    EXPECT_EQ(s.bids, ladder({{198, 5}}));
+    EXPECT_EQ(s.asks, ladder({{199, 6}}));
+    EXPECT_EQ(f.stream->resnapshots(), 1u);
+    EXPECT_EQ(f.stream->framesSent(), 2u);
+}
+
+TEST(DepthStreamTest, StopEndsTheStream) {
+    StreamFixture f;
+    ASSERT_TRUE(f.stream->flush());
+    f.stream->stop();
+    f.books->onUpdate("S", 1, FeedScope{}, std::nullopt, 12);
+    EXPECT_FALSE(f.stream->flush());
+    EXPECT_EQ(f.frames.size(), 1u);
+}
+
+TEST(DepthStreamTest, UnknownSymbolIsRefused) {
+    auto books = std::make_shared<OrderBookManager>();
+    EXPECT_EQ(DepthStreamer::create(books, "NOPE", 1, 5, [](std::string) { return true; }), nullptr);
+}
+
+TEST(DepthStreamTest, SourceFlushesOnItsTimer) {
+    auto books = std::make_shared<OrderBookManager>();
+    books->setTickSize("S", 1.0);
+    books->onAdd("S", 1, Side::Bid, 100, 10, 0);
+    std::vector<DepthFrame> frames;
+    auto streamer = DepthStreamer::create(books, "S", 1, 5, [&frames](std::string bytes) {
+        if (auto f = decodeDepthFrame(bytes)) frames.push_back(std::move(*f));
+        return true;
+    });
+
+    boost::asio::io_context io;
+    market::DepthStreamSource src(io, streamer, std::chrono::milliseconds(2));
+    src.start();
+    io.run_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].type, DepthFrame::Type::Snapshot);
+
+    books->onUpdate("S", 1, FeedScope{}, std::nullopt, 12);
+    io.run_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[1].bids, ladder({{100, 12}}));
+
+    src.stop();
+    books->onUpdate("S", 1, FeedScope{}, std::nullopt, 13);
+    io.run_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(frames.size(), 2u);
+}
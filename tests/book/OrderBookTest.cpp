@@ -4,9 +4,24 @@
 #include <gtest/gtest.h>
 #include <thread>
 #include <atomic>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
 
 using namespace gma;
 
+namespace {
+
+void expectSameSums(const DepthSums& a, const DepthSums& b) {
+    EXPECT_EQ(a.levels, b.levels);
+    EXPECT_EQ(a.orders, b.orders);
+    EXPECT_EQ(a.size, b.size);
+    EXPECT_EQ(a.notional, b.notional);
+}
+
+} // namespace
+
 // ===================== OrderBook unit tests =====================
 
 TEST(OrderBookTest, AddAndBestBidAsk) {
@@ -152,6 +167,96 @@ TEST(OrderBookTest, SnapshotAggregated) {
     EXPECT_EQ(ob.levelSizeAggregated(Side::Ask, Price{101}), 30u);
 }
 
+TEST(OrderBookTest, SnapshotMatchesRepeatedAdds) {
+    for (auto kind : {LadderKind::Map, LadderKind::Tick}) {
+        std::mt19937_64 rng(21);
+        std::vector<Order> snap;
+        for (uint64_t k = 0; k < 5'000; ++k) {
+            Order o;
+            o.id = 1 + rng() % 4'000;                          // some ids repeat
+            o.side = (rng() & 1) ? Side::Bid : Side::Ask;
+            const int64_t off = (rng() % 50 == 0) ? 10'000 + static_cast<int64_t>(rng() % 5'000)
+                                                  : static_cast<int64_t>(rng() % 30);
+            o.price = Price{o.side == Side::Bid ? 1'000 - off : 1'001 + off};
+            o.size = 1 + rng() % 100;
+            o.priority = k;
+            snap.push_back(o);
+        }
+        OrderBook bulk(LadderConfig{kind, 256}), ref(LadderConfig{kind, 256});
+        Order stale; stale.id = 99'999; stale.side = Side::Bid; stale.price = Price{5}; stale.size = 1;
+        bulk.applyAdd(stale);
+        bulk.applySnapshotPerOrder(snap);
+        for (const auto& o : snap) ref.applyAdd(o);
+
+        std::string why;
+        ASSERT_TRUE(bulk.checkInvariants(&why)) << why;
+        EXPECT_EQ(bulk.orderCount(), ref.orderCount());
+        for (Side s : {Side::Bid, Side::Ask}) {
+            std::vector<std::pair<Price, uint64_t>> a, b;
+            bulk.forEachLevel(s, 100'000, [&](Price p, uint64_t sz) { a.emplace_back(p, sz); });
+            ref.forEachLevel(s, 100'000, [&](Price p, uint64_t sz) { b.emplace_back(p, sz); });
+            EXPECT_EQ(a, b);
+            expectSameSums(bulk.depthByRank(s, 1, 100'000), ref.depthByRank(s, 1, 100'000));
+        }
+        // Same queue order: partial fills leave the same remainders.
+        for (int k = 0; k < 200; ++k) {
+            const Aggressor aggr = (k & 1) ? Aggressor::Buy : Aggressor::Sell;
+            auto best = (k & 1) ? ref.bestAsk() : ref.bestBid();
+            if (!best) break;
+            const uint64_t q = 1 + k % 37;
+            bulk.applyTrade(*best, q, aggr);
+            ref.applyTrade(*best, q, aggr);
+            ASSERT_EQ(bulk.levelSize((k & 1) ? Side::Ask : Side::Bid, *best),
+                      ref.levelSize((k & 1) ? Side::Ask : Side::Bid, *best));
+        }
+        EXPECT_TRUE(bulk.checkInvariants(&why)) << why;
+    }
+}
+
+TEST(OrderBookTest, SnapshotSwapsInWhole) {
+    auto book = [](uint64_t firstId, uint64_t n) {
+        std::vector<Order> v;
+        for (uint64_t id = firstId; id < firstId + n; ++id) {
+            Order o; o.id = id; o.side = Side::Bid; o.price = Price{100 - int64_t(id % 50)}; o.size = 1;
+            v.push_back(o);
+        }
+        return v;
+    };
+    const auto a = book(1, 1'000), b = book(5'000, 3'000);
+    OrderBook ob;
+    ob.applySnapshotPerOrder(a);
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+    std::thread reader([&] {
+        while (!done.load()) {
+            const uint64_t sz = ob.depthByRank(Side::Bid, 1, 1'000).size;
+            if (sz != 1'000 && sz != 3'000) ++bad;
+        }
+    });
+    for (int k = 0; k < 50; ++k) ob.applySnapshotPerOrder((k & 1) ? a : b);
+    done.store(true);
+    reader.join();
+    EXPECT_EQ(bad.load(), 0);
+}
+
+TEST(OrderBookTest, SnapshotAggregatedKeepsLastEntryPerLevel) {
+    OrderBook ob;
+    ob.applyLevelSummary(Side::Bid, Price{90}, 5);
+    ob.applySnapshotAggregated({
+        LevelSnapshotEntry{Side::Bid, Price{100}, 50, std::nullopt},
+        LevelSnapshotEntry{Side::Bid, Price{99}, 0, std::nullopt},     // skipped
+        LevelSnapshotEntry{Side::Bid, Price{100}, 70, 3},
+        LevelSnapshotEntry{Side::Ask, Price{102}, 30, 2},
+        LevelSnapshotEntry{Side::Ask, Price{101}, 10, 1},
+    });
+    EXPECT_EQ(ob.levelSizeAggregated(Side::Bid, Price{100}), 70u);
+    EXPECT_EQ(ob.levelSizeAggregated(Side::Bid, Price{99}), 0u);
+    EXPECT_EQ(ob.levelSizeAggregated(Side::Bid, Price{90}), 0u);
+    EXPECT_EQ(ob.bestAskAggregated()->ticks, 101);
+    std::string why;
+    EXPECT_TRUE(ob.checkInvariants(&why)) << why;
+}
+
 TEST(OrderBookTest, LevelSummary) {
     OrderBook ob;
     EXPECT_TRUE(ob.applyLevelSummary(Side::Bid, Price{100}, 50));
@@ -250,6 +355,154 @@ TEST(OrderBookTest, LocateNonExistent) {
     EXPECT_FALSE(ob.locate(key, s, p));
 }
 
+TEST(OrderBookTest, ChangeLogRecordsTouchedLevels) {
+    OrderBook ob;
+    std::vector<LevelChange> log;
+    ob.setChangeLog(&log);
+    Order a; a.id=1; a.side=Side::Bid; a.price=Price{100}; a.size=50;
+    Order b; b.id=2; b.side=Side::Bid; b.price=Price{100}; b.size=30;
+    ob.applyAdd(a);
+    ob.applyAdd(b);
+    ASSERT_EQ(log.size(), 1u);                          // merged per level
+    EXPECT_EQ(log[0].before, 0u);
+    EXPECT_EQ(log[0].after, 80u);
+
+    // A trade that fills one order and part of the next: one entry.
+    log.clear();
+    ob.applyTrade(Price{100}, 60, Aggressor::Sell);
+    ASSERT_EQ(log.size(), 1u);
+    EXPECT_EQ(log[0].before, 80u);
+    EXPECT_EQ(log[0].after, 20u);
+
+    // Re-adding an id elsewhere leaves the old level and joins the new one.
+    log.clear();
+    Order c = b; c.price = Price{99};
+    ob.applyAdd(c);
+    ASSERT_EQ(log.size(), 2u);
+    EXPECT_EQ(log[0].ticks, 100);
+    EXPECT_EQ(log[0].after, 0u);
+    EXPECT_EQ(log[1].ticks, 99);
+    EXPECT_EQ(log[1].after, 30u);
+
+    log.clear();
+    ob.applySnapshotPerOrder({a});                      // rebuilds are not logged
+    EXPECT_TRUE(log.empty());
+    ob.setChangeLog(nullptr);
+    ob.applyDelete(1);
+    EXPECT_TRUE(log.empty());
+}
+
+TEST(OrderBookTest, DepthLimitedMatchesFullBookAtTheTop) {
+    LadderConfig limit; limit.depthLimit = 3;
+    OrderBook top(limit), full;
+    std::mt19937_64 rng(46);
+    std::vector<std::pair<uint64_t, Side>> live;
+    uint64_t nextId = 1;
+    auto same = [&](int step) {
+        std::string why;
+        ASSERT_TRUE(top.checkInvariants(&why)) << step << ": " << why;
+        for (Side s : {Side::Bid, Side::Ask}) {
+            std::vector<std::pair<Price, uint64_t>> a, b;
+            top.forEachLevel(s, 3, [&](Price p, uint64_t sz) { a.emplace_back(p, sz); });
+            full.forEachLevel(s, 3, [&](Price p, uint64_t sz) { b.emplace_back(p, sz); });
+            ASSERT_EQ(a, b) << step;
+            expectSameSums(top.depthByRank(s, 1, 3), full.depthByRank(s, 1, 3));
+        }
+        ASSERT_EQ(top.bestBidSize(), full.bestBidSize()) << step;
+        ASSERT_EQ(top.bestAsk(), full.bestAsk()) << step;
+    };
+
+    // Adds fan out over ~20 levels a side, so the band keeps filling,
+    // spilling and refilling.
+    for (int step = 0; step < 4'000; ++step) {
+        const unsigned r = rng() % 100;
+        if (r < 45 || live.empty()) {
+            Order o; o.id = nextId++; o.side = (rng() & 1) ? Side::Bid : Side::Ask;
+            const int64_t off = static_cast<int64_t>(rng() % 20);
+            o.price = Price{o.side == Side::Bid ? 100 - off : 101 + off};
+            o.size = 1 + rng() % 50;
+            top.applyAdd(o);
+            full.applyAdd(o);
+            live.emplace_back(o.id, o.side);
+        } else {
+            const std::size_t i = rng() % live.size();
+            const auto [id, side] = live[i];
+            if (r < 75) {
+                ASSERT_TRUE(top.applyDelete(id));
+                full.applyDelete(id);
+                live[i] = live.back();
+                live.pop_back();
+            } else if (r < 90) {
+                const uint64_t sz = rng() % 40;                 // 0 removes
+                top.applyUpdate(id, std::nullopt, sz);
+                full.applyUpdate(id, std::nullopt, sz);
+                if (sz == 0) { live[i] = live.back(); live.pop_back(); }
+            } else {
+                const int64_t off = static_cast<int64_t>(rng() % 20);
+                const Price px{side == Side::Bid ? 100 - off : 101 + off};
+                const uint64_t sz = 1 + rng() % 50;
+                top.applyUpdate(id, px, sz);
+                full.applyUpdate(id, px, sz);
+            }
+        }
+        same(step);
+    }
+    EXPECT_EQ(top.orderCount(), full.orderCount());
+
+    // Anonymous trades need queue positions the limited book does not keep.
+    EXPECT_FALSE(top.applyTrade(*top.bestBid(), 1, Aggressor::Sell));
+
+    std::vector<Order> snap;
+    for (uint64_t id = 1; id <= 500; ++id) {
+        Order o; o.id = id; o.side = (id & 1) ? Side::Bid : Side::Ask;
+        o.price = Price{(id & 1) ? 100 - int64_t(id % 37) : 101 + int64_t(id % 41)};
+        o.size = id;
+        snap.push_back(o);
+    }
+    top.applySnapshotPerOrder(snap);
+    full.applySnapshotPerOrder(snap);
+    same(-1);
+    EXPECT_EQ(top.levelCount(Side::Bid), 6u);                  // 2 * depthLimit held
+}
+
+TEST(OrderBookTest, DepthLimitedLogsLevelsEnteringAndLeavingTheBand) {
+    LadderConfig limit; limit.depthLimit = 1;                   // holds 2 levels
+    OrderBook ob(limit);
+    std::vector<LevelChange> log;
+    ob.setChangeLog(&log);
+    auto add = [&](uint64_t id, int64_t px, uint64_t sz) {
+        Order o; o.id = id; o.side = Side::Bid; o.price = Price{px}; o.size = sz;
+        ob.applyAdd(o);
+    };
+    add(1, 100, 10);
+    add(2, 99, 20);
+    add(3, 98, 30);                                             // below the band
+    EXPECT_EQ(log.size(), 2u);
+    EXPECT_EQ(ob.levelSize(Side::Bid, Price{98}), 0u);
+
+    // A better level pushes the worst held one out.
+    log.clear();
+    add(4, 101, 5);
+    ASSERT_EQ(log.size(), 2u);
+    EXPECT_EQ(log[0].ticks, 99);
+    EXPECT_EQ(log[0].after, 0u);
+    EXPECT_EQ(log[1].ticks, 101);
+    EXPECT_EQ(log[1].after, 5u);
+
+    // Clearing the band pulls the best outside levels back in.
+    log.clear();
+    ob.applyDelete(4);
+    ob.applyDelete(1);
+    ASSERT_EQ(log.size(), 4u);
+    EXPECT_EQ(log[2].ticks, 99);
+    EXPECT_EQ(log[2].after, 20u);
+    EXPECT_EQ(log[3].ticks, 98);
+    EXPECT_EQ(log[3].after, 30u);
+    EXPECT_EQ(ob.bestBid()->ticks, 99);
+    std::string why;
+    EXPECT_TRUE(ob.checkInvariants(&why)) << why;
+}
+
 // ===================== OrderBookManager unit tests =====================
 
 TEST(OrderBookManagerTest, TickSizeDefaultAndCustom) {
@@ -372,6 +625,18 @@ TEST(OrderBookManagerTest, EventBusSubscribeAndReceive) {
     EXPECT_EQ(received.size(), 1u); // no more
 }
 
+TEST(OrderBookManagerTest, EventBusDoesNotCreateUnknownSymbols) {
+    OrderBookManager mgr;
+    int calls = 0;
+    EXPECT_EQ(mgr.subscribeDeltas("NOPE", [&](const BookDelta&) { ++calls; }), 0u);
+
+    // The symbol arriving later does not revive the refused subscription.
+    mgr.setTickSize("NOPE", 0.01);
+    mgr.onAdd("NOPE", 1, Side::Bid, 1.00, 50, 0);
+    EXPECT_EQ(calls, 0);
+    EXPECT_NE(mgr.subscribeDeltas("NOPE", [&](const BookDelta&) { ++calls; }), 0u);
+}
+
 TEST(OrderBookManagerTest, BuildSnapshot) {
     OrderBookManager mgr;
     mgr.setTickSize("S", 0.01);
@@ -399,6 +664,27 @@ TEST(OrderBookManagerTest, ResolverPutAndGet) {
     EXPECT_FALSE(mgr.resolverGet("OTHER", "venue-key-1").has_value());
 }
 
+TEST(OrderBookManagerTest, ResolverEvictsLeastRecentlyUsed) {
+    OrderBookManager mgr;
+    mgr.resolverSetCapacity(3);
+    auto key = [](uint64_t id) { return OrderKey{id, 1, 1, false}; };
+    for (uint64_t id = 1; id <= 3; ++id) mgr.resolverPut("S", "k" + std::to_string(id), key(id));
+    mgr.resolverPut("S", "k1", key(11));                // refresh: k2 is now oldest
+    mgr.resolverPut("S", "k4", key(4));
+    EXPECT_FALSE(mgr.resolverGet("S", "k2").has_value());
+    EXPECT_EQ(mgr.resolverGet("S", "k1")->id, 11u);
+    EXPECT_EQ(mgr.resolverGet("S", "k3")->id, 3u);
+
+    // Long churn keeps the newest keys and compacts dropped key bytes.
+    for (uint64_t id = 100; id < 20'000; ++id) {
+        mgr.resolverPut("S", "venue-key-" + std::to_string(id), key(id));
+    }
+    EXPECT_EQ(mgr.resolverGet("S", "venue-key-19999")->id, 19'999u);
+    EXPECT_EQ(mgr.resolverGet("S", "venue-key-19997")->id, 19'997u);
+    EXPECT_FALSE(mgr.resolverGet("S", "venue-key-19996").has_value());
+    EXPECT_FALSE(mgr.resolverGet("S", "k4").has_value());
+}
+
 TEST(OrderBookManagerTest, AssertInvariantsOnEmptySymbol) {
     OrderBookManager mgr;
     std::string why;
@@ -460,3 +746,107 @@ TEST(OrderBookManagerTest, ConcurrentAccess) {
     // Just verifying no crashes/races
     EXPECT_TRUE(mgr.assertInvariants("S"));
 }
+
+TEST(OrderBookManagerTest, ParallelSymbolsAcrossShards) {
+    OrderBookManager mgr(8);
+    constexpr int kThreads = 4, kSymbolsPerThread = 16, kOrders = 200;
+
+    auto feed = [&](int t) {
+        for (int s = 0; s < kSymbolsPerThread; ++s) {
+            const std::string sym = "S" + std::to_string(t * kSymbolsPerThread + s);
+            mgr.setTickSize(sym, 0.01);
+            for (uint64_t id = 1; id <= kOrders; ++id) {
+                mgr.onAdd(sym, id, (id & 1) ? Side::Bid : Side::Ask,
+                          (id & 1) ? 1.00 - 0.01 * (id % 10) : 1.01 + 0.01 * (id % 10), 10, id);
+            }
+            for (uint64_t id = 1; id <= kOrders; id += 4) mgr.onDelete(sym, id, FeedScope{});
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) threads.emplace_back(feed, t);
+    for (auto& th : threads) th.join();
+
+    for (int i = 0; i < kThreads * kSymbolsPerThread; ++i) {
+        const std::string sym = "S" + std::to_string(i);
+        EXPECT_TRUE(mgr.assertInvariants(sym)) << sym;
+        EXPECT_DOUBLE_EQ(*mgr.bestBid(sym), 0.99);        // odd ids: id % 10 >= 1
+        EXPECT_DOUBLE_EQ(*mgr.bestAsk(sym), 1.01);
+        EXPECT_EQ(mgr.bookVersion(sym), uint64_t(kOrders + kOrders / 4));
+    }
+    EXPECT_EQ(mgr.bookVersion("UNKNOWN"), 0u);
+}
+
+// Lock-free top-of-book reads while one thread rewrites the touch.
+TEST(OrderBookManagerTest, TopOfBookReadsDuringWrites) {
+    OrderBookManager mgr;
+    mgr.setTickSize("S", 1.0);
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+
+    std::thread reader([&] {
+        while (!done.load()) {
+            const auto px = mgr.bestBid("S");
+            const uint64_t sz = mgr.bestBidSize("S");
+            if (px && (*px < 1.0 || *px > 500.0 || *px != std::floor(*px))) ++bad;
+            if (sz > 500) ++bad;
+        }
+    });
+    for (uint64_t id = 1; id <= 20'000; ++id) {
+        mgr.onAdd("S", id, Side::Bid, static_cast<double>(1 + id % 500), 1 + id % 500, 0);
+        if (id > 1) mgr.onDelete("S", id - 1, FeedScope{});
+    }
+    done.store(true);
+    reader.join();
+    EXPECT_EQ(bad.load(), 0);
+    EXPECT_DOUBLE_EQ(*mgr.bestBid("S"), 1.0 + 20'000 % 500);
+    EXPECT_EQ(mgr.bestBidSize("S"), 1u + 20'000 % 500);
+}
+
+TEST(OrderBookManagerTest, HandlersMayReenterAndSeeTheirDelta) {
+    OrderBookManager mgr;
+    mgr.setTickSize("S", 0.01);
+    std::vector<std::pair<uint64_t, uint64_t>> seen;     // delta seq, snapshot seq
+    mgr.subscribeDeltas("S", [&](const BookDelta& d) {
+        seen.emplace_back(d.seq, mgr.buildSnapshot("S", 5).seq);
+        EXPECT_TRUE(mgr.bestBid("S").has_value());
+    });
+    mgr.onAdd("S", 1, Side::Bid, 1.00, 10, 1);
+    mgr.onAdd("S", 2, Side::Bid, 1.01, 10, 2);
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_EQ(seen[0], std::make_pair(uint64_t{1}, uint64_t{1}));
+    EXPECT_EQ(seen[1], std::make_pair(uint64_t{2}, uint64_t{2}));
+}
+
+TEST(OrderBookManagerTest, DeltasCarryEveryTouchedLevel) {
+    OrderBookManager mgr;
+    mgr.setTickSize("S", 1.0);
+    mgr.onAdd("S", 1, Side::Bid, 100, 10, 0);
+    mgr.onAdd("S", 2, Side::Bid,  99, 20, 0);
+    EXPECT_EQ(mgr.buildSnapshot("S", 5).seq, 2u);       // sequenced without subscribers
+
+    std::vector<BookDelta> got;
+    mgr.subscribeDeltas("S", [&](const BookDelta& d) { got.push_back(d); });
+
+    // Same id re-added at another price: the old level is reported too.
+    mgr.onAdd("S", 1, Side::Bid, 98, 5, 0);
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_EQ(got[0].seq, 3u);
+    ASSERT_EQ(got[0].levels.size(), 2u);
+    EXPECT_EQ(got[0].levels[0].price.ticks, 100);
+    EXPECT_EQ(got[0].levels[0].totalSize, 0u);
+    EXPECT_EQ(got[0].levels[1].price.ticks, 98);
+    EXPECT_EQ(got[0].levels[1].totalSize, 5u);
+    ASSERT_TRUE(got[0].bid.has_value());
+    EXPECT_EQ(got[0].bid->first.ticks, 99);
+    EXPECT_FALSE(got[0].ask.has_value());
+
+    // Queue position only: nothing to publish.
+    EXPECT_TRUE(mgr.onPriority("S", 2, FeedScope{}, 7));
+    EXPECT_EQ(got.size(), 1u);
+
+    mgr.onTrade("S", 99, 5, Aggressor::Sell);
+    ASSERT_EQ(got.size(), 2u);
+    ASSERT_EQ(got[1].levels.size(), 1u);
+    EXPECT_EQ(got[1].levels[0].totalSize, 15u);
+    EXPECT_EQ(got[1].bid, std::make_pair(Price{99}, uint64_t{15}));
+}
@@ -0,0 +1,115 @@
+#include "gma/book/OrderBook.hpp"
+#include "gma/book/OrderPool.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace gma;
+
+TEST(OrderPoolTest, FreedRecordsAreReusedWithoutNewSlabs) {
+    OrderPool pool;
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 1000; ++i) ids.push_back(pool.alloc());
+    EXPECT_EQ(pool.live(), 1000u);
+    const size_t bytes = pool.bytes();
+
+    for (uint32_t i : ids) pool.release(i);
+    EXPECT_EQ(pool.live(), 0u);
+    for (int i = 0; i < 1000; ++i) {
+        const uint32_t r = pool.alloc();
+        EXPECT_LT(r, 1000u);
+        EXPECT_EQ(pool[r].next, kNoOrder);            // handed out clean
+        EXPECT_EQ(pool[r].size, 0u);
+    }
+    EXPECT_EQ(pool.bytes(), bytes);
+
+    pool.clear();
+    EXPECT_EQ(pool.live(), 0u);
+    EXPECT_EQ(pool.bytes(), bytes);                   // slabs kept
+}
+
+TEST(OrderPoolTest, GrowsAcrossSlabs) {
+    OrderPool pool(true);                             // huge-page slabs
+    const uint32_t n = OrderPool::SLAB_SIZE + 10;
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint32_t r = pool.alloc();
+        pool[r].id = i;
+    }
+    EXPECT_EQ(pool.capacity(), 2u * OrderPool::SLAB_SIZE);
+    EXPECT_EQ(pool[n - 1].id, n - 1);
+    EXPECT_EQ(pool[0].id, 0u);
+}
+
+TEST(OrderPoolTest, IndexMatchesReferenceMapUnderChurn) {
+    OrderPool pool;
+    OrderIndex index;
+    std::unordered_map<OrderKey, uint32_t, OrderKeyHash> ref;
+    std::vector<OrderKey> live;
+    std::mt19937_64 rng(3);
+
+    for (int step = 0; step < 200'000; ++step) {
+        if (live.empty() || rng() % 3 != 0) {
+            OrderKey k{ rng() % 50'000, static_cast<uint32_t>(rng() % 3), 1, (rng() % 7) == 0 };
+            if (ref.count(k)) continue;
+            const uint32_t i = pool.alloc();
+            pool[i].id = k.id; pool[i].feedId = k.feedId; pool[i].epoch = k.epoch; pool[i].synthetic = k.synthetic;
+            index.insert(k, i);
+            ref.emplace(k, i);
+            live.push_back(k);
+        } else {
+            const size_t j = rng() % live.size();
+            const OrderKey k = live[j];
+            ASSERT_TRUE(index.erase(k, pool));
+            EXPECT_FALSE(index.erase(k, pool));
+            pool.release(ref.at(k));
+            ref.erase(k);
+            live[j] = live.back();
+            live.pop_back();
+        }
+        if (step % 1000 == 0) {
+            ASSERT_EQ(index.size(), ref.size());
+            for (const auto& [k, i] : ref) ASSERT_EQ(index.find(k, pool), i);
+        }
+    }
+    EXPECT_EQ(index.find(OrderKey{ 999'999, 0, 1, false }, pool), kNoOrder);
+}
+
+TEST(OrderPoolTest, BookMemoryIsReusedAfterDeletes) {
+    OrderBook ob;
+    size_t firstRoundBytes = 0;
+    for (int round = 0; round < 3; ++round) {
+        for (uint64_t id = 1; id <= 5000; ++id) {
+            Order o; o.id = id; o.side = (id & 1) ? Side::Bid : Side::Ask;
+            o.price = Price{ (id & 1) ? 1000 - int64_t(id % 50) : 1001 + int64_t(id % 50) };
+            o.size = 10;
+            ob.applyAdd(o);
+        }
+        EXPECT_EQ(ob.orderCount(), 5000u);
+        if (round == 0) firstRoundBytes = ob.orderMemoryBytes();
+        else            EXPECT_EQ(ob.orderMemoryBytes(), firstRoundBytes);
+        for (uint64_t id = 1; id <= 5000; ++id) ASSERT_TRUE(ob.applyDelete(id));
+        EXPECT_EQ(ob.orderCount(), 0u);
+        EXPECT_FALSE(ob.bestBid().has_value());
+    }
+    EXPECT_TRUE(ob.checkInvariants());
+}
+
+TEST(OrderPoolTest, LevelFifoSurvivesMovesAndPriority) {
+    OrderBook ob;
+    for (uint64_t id = 1; id <= 4; ++id) {
+        Order o; o.id = id; o.side = Side::Ask; o.price = Price{100}; o.size = id * 10;
+        ob.applyAdd(o);
+    }
+    ob.applyPriority(1, 99);                          // 1 goes to the back: 2,3,4,1
+    EXPECT_TRUE(ob.applyUpdate(3, Price{101}, std::nullopt));   // 2,4,1
+    // A 70-lot sweep fills 2 (20) and 4 (40), then 10 of order 1.
+    EXPECT_TRUE(ob.applyTrade(Price{100}, 70, Aggressor::Buy));
+    Side s; Price p;
+    EXPECT_FALSE(ob.locate(OrderKey{2, 0, 0, false}, s, p));
+    EXPECT_FALSE(ob.locate(OrderKey{4, 0, 0, false}, s, p));
+    EXPECT_EQ(ob.levelSize(Side::Ask, Price{100}), 0u);
+    EXPECT_EQ(ob.orderCount(), 1u);
+    EXPECT_EQ(ob.bestAsk()->ticks, 101);
+    EXPECT_TRUE(ob.checkInvariants());
+}
@@ -0,0 +1,64 @@
+#include "gma/book/RefTable.hpp"
+#include "gma/book/SymbolTable.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace gma;
+
+TEST(RefTableTest, MatchesReferenceMapUnderChurn) {
+    RefTable<uint32_t> table;
+    std::unordered_map<uint64_t, uint32_t> ref;
+    std::vector<uint64_t> live;
+    std::mt19937_64 rng(47);
+
+    for (uint32_t step = 0; step < 200'000; ++step) {
+        if (live.empty() || rng() % 3 != 0) {
+            // Mostly sequential refs, as venues assign them, plus strays.
+            const uint64_t k = (rng() % 8 == 0) ? rng() >> 1 : 1'000'000 + step;
+            if (!ref.count(k)) live.push_back(k);
+            table.put(k, step);
+            ref[k] = step;
+        } else {
+            const size_t i = rng() % live.size();
+            EXPECT_TRUE(table.erase(live[i]));
+            EXPECT_FALSE(table.erase(live[i]));
+            ref.erase(live[i]);
+            live[i] = live.back();
+            live.pop_back();
+        }
+    }
+    ASSERT_EQ(table.size(), ref.size());
+    for (const auto& [k, v] : ref) {
+        const uint32_t* got = table.find(k);
+        ASSERT_NE(got, nullptr) << k;
+        EXPECT_EQ(*got, v);
+    }
+    size_t seen = 0;
+    table.forEach([&](uint64_t k, uint32_t v) { ++seen; EXPECT_EQ(ref.at(k), v); });
+    EXPECT_EQ(seen, ref.size());
+    EXPECT_EQ(table.find(7), nullptr);
+
+    table.clear();
+    EXPECT_EQ(table.size(), 0u);
+    EXPECT_EQ(table.find(live.front()), nullptr);
+}
+
+TEST(RefTableTest, SymbolTableInternsOnce) {
+    SymbolTable syms;
+    EXPECT_EQ(syms.find("AAPL"), kNoSymbol);
+    const uint32_t a = syms.intern("AAPL");
+    const uint32_t m = syms.intern("MSFT");
+    EXPECT_NE(a, m);
+    EXPECT_EQ(syms.intern(std::string("AAPL")), a);
+    EXPECT_EQ(syms.find("MSFT"), m);
+    EXPECT_EQ(syms.name(a), "AAPL");
+
+    // Names stay put while the table grows.
+    const std::string* first = &syms.name(a);
+    for (int i = 0; i < 10'000; ++i) syms.intern("S" + std::to_string(i));
+    EXPECT_EQ(&syms.name(a), first);
+    EXPECT_EQ(syms.size(), 10'002u);
+}
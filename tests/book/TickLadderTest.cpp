@@ -0,0 +1,200 @@
+#include "gma/book/OrderBook.hpp"
+#include "gma/book/OrderBookManager.hpp"
+#include "gma/book/PriceLadder.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace gma;
+
+namespace {
+
+struct Lvl { uint64_t size = 0; };
+
+std::vector<int64_t> ticksOf(const TickLadder<Lvl>& l) {
+    std::vector<int64_t> out;
+    l.forEach(l.size(), [&](int64_t t, const Lvl&) { out.push_back(t); });
+    return out;
+}
+
+std::vector<std::pair<Price, uint64_t>> levels(const OrderBook& ob, Side s) {
+    std::vector<std::pair<Price, uint64_t>> out;
+    ob.forEachLevel(s, SIZE_MAX, [&](Price p, uint64_t sz) { out.emplace_back(p, sz); });
+    return out;
+}
+
+} // namespace
+
+// ===================== TickLadder =====================
+
+TEST(TickLadderTest, BestAndOrderedScanAcrossSparseWords) {
+    TickLadder<Lvl> bids(true, 8192), asks(false, 8192);
+    for (int64_t t : {10'000, 9'000, 10'001, 6'000, 9'999}) bids.getOrCreate(t).size = 1;
+    for (int64_t t : {10'002, 14'000, 10'500, 10'003})      asks.getOrCreate(t).size = 1;
+
+    int64_t bb = 0, ba = 0;
+    ASSERT_NE(bids.best(bb), nullptr);
+    ASSERT_NE(asks.best(ba), nullptr);
+    EXPECT_EQ(bb, 10'001);
+    EXPECT_EQ(ba, 10'002);
+    EXPECT_EQ(ticksOf(bids), (std::vector<int64_t>{10'001, 10'000, 9'999, 9'000, 6'000}));
+    EXPECT_EQ(ticksOf(asks), (std::vector<int64_t>{10'002, 10'003, 10'500, 14'000}));
+    EXPECT_EQ(bids.overflowSize(), 0u);
+
+    bids.erase(10'001);
+    bids.erase(10'000);
+    ASSERT_NE(bids.best(bb), nullptr);
+    EXPECT_EQ(bb, 9'999);
+    EXPECT_EQ(bids.find(10'000), nullptr);
+    EXPECT_EQ(bids.size(), 3u);
+}
+
+TEST(TickLadderTest, FarPricesOverflowAndBestReanchors) {
+    TickLadder<Lvl> bids(true, 64);
+    bids.getOrCreate(1'000).size = 5;
+    bids.getOrCreate(500).size = 7;                 // far below: overflow
+    EXPECT_EQ(bids.overflowSize(), 1u);
+    ASSERT_NE(bids.find(500), nullptr);
+    EXPECT_EQ(bids.find(500)->size, 7u);
+
+    bids.getOrCreate(2'000).size = 9;               // new best beyond the window
+    int64_t bb = 0;
+    ASSERT_NE(bids.best(bb), nullptr);
+    EXPECT_EQ(bb, 2'000);
+    EXPECT_EQ(bids.overflowSize(), 2u);             // 1'000 fell out of the window
+    EXPECT_EQ(bids.find(1'000)->size, 5u);
+    EXPECT_EQ(ticksOf(bids), (std::vector<int64_t>{2'000, 1'000, 500}));
+
+    // Emptying the window pulls the best far level back in.
+    bids.erase(2'000);
+    ASSERT_NE(bids.best(bb), nullptr);
+    EXPECT_EQ(bb, 1'000);
+    EXPECT_EQ(bids.overflowSize(), 1u);
+    bids.erase(1'000);
+    bids.erase(500);
+    EXPECT_TRUE(bids.empty());
+    EXPECT_EQ(bids.best(bb), nullptr);
+}
+
+TEST(TickLadderTest, ForEachStopsAtN) {
+    TickLadder<Lvl> asks(false, 64);
+    for (int64_t t = 100; t < 300; t += 3) asks.getOrCreate(t);
+    std::vector<int64_t> got;
+    asks.forEach(4, [&](int64_t t, const Lvl&) { got.push_back(t); });
+    EXPECT_EQ(got, (std::vector<int64_t>{100, 103, 106, 109}));
+    asks.clear();
+    EXPECT_TRUE(asks.empty());
+    EXPECT_EQ(asks.find(100), nullptr);
+}
+
+// ===================== OrderBook on a tick ladder =====================
+
+TEST(TickLadderTest, OrderBookBasics) {
+    OrderBook ob(LadderConfig{LadderKind::Tick, 256});
+    EXPECT_EQ(ob.ladderKind(), LadderKind::Tick);
+    Order bid; bid.id=1; bid.side=Side::Bid; bid.price=Price{100}; bid.size=50;
+    Order ask; ask.id=2; ask.side=Side::Ask; ask.price=Price{101}; ask.size=30;
+    ob.applyAdd(bid);
+    ob.applyAdd(ask);
+    EXPECT_EQ(ob.bestBid()->ticks, 100);
+    EXPECT_EQ(ob.bestAsk()->ticks, 101);
+
+    // Move the bid far away and back: the order survives re-anchoring.
+    EXPECT_TRUE(ob.applyUpdate(1, Price{50'000}, std::nullopt));
+    EXPECT_EQ(ob.bestBid()->ticks, 50'000);
+    EXPECT_TRUE(ob.applyUpdate(1, Price{99}, std::optional<uint64_t>(40)));
+    EXPECT_EQ(ob.bestBid()->ticks, 99);
+    EXPECT_EQ(ob.bestBidSize(), 40u);
+
+    EXPECT_TRUE(ob.applyTrade(Price{101}, 30, Aggressor::Buy));
+    EXPECT_FALSE(ob.bestAsk().has_value());
+
+    ob.applyLevelSummary(Side::Ask, Price{105}, 10);
+    EXPECT_EQ(ob.bestAskAggregated()->ticks, 105);
+    EXPECT_TRUE(ob.checkInvariants());
+}
+
+// Random walk of adds, cancels, replaces and executes with occasional
+// far-from-touch orders; the tick ladder (with a small window, so it
+// re-anchors and overflows often) must match the map ladder exactly.
+TEST(TickLadderTest, MatchesMapLadderOnRandomFlow) {
+    OrderBook mapBook;
+    OrderBook tickBook(LadderConfig{LadderKind::Tick, 64});
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> live;
+    uint64_t nextId = 1;
+    int64_t mid = 10'000;
+
+    for (int step = 0; step < 20'000; ++step) {
+        if (rng() % 50 == 0) mid += static_cast<int64_t>(rng() % 401) - 200;   // jump
+        else                 mid += static_cast<int64_t>(rng() % 3) - 1;
+        const int op = static_cast<int>(rng() % 10);
+
+        if (op < 5 || live.empty()) {
+            Order o; o.id = nextId++; o.size = 1 + rng() % 500;
+            o.side = (rng() & 1) ? Side::Bid : Side::Ask;
+            int64_t off = (rng() % 20 == 0) ? 100 + static_cast<int64_t>(rng() % 5000)
+                                            : static_cast<int64_t>(rng() % 20);
+            o.price = Price{o.side == Side::Bid ? mid - 1 - off : mid + 1 + off};
+            mapBook.applyAdd(o);
+            tickBook.applyAdd(o);
+            live.push_back(o.id);
+        } else if (op < 8) {
+            const std::size_t i = rng() % live.size();
+            EXPECT_EQ(mapBook.applyDelete(live[i]), tickBook.applyDelete(live[i]));
+            live[i] = live.back();
+            live.pop_back();
+        } else if (op < 9) {
+            const uint64_t id = live[rng() % live.size()];
+            const std::optional<Price> px = (rng() & 1) ? std::optional<Price>(Price{mid + static_cast<int64_t>(rng() % 41) - 20})
+                                                        : std::nullopt;
+            const std::optional<uint64_t> sz = 1 + rng() % 300;
+            EXPECT_EQ(mapBook.applyUpdate(id, px, sz), tickBook.applyUpdate(id, px, sz));
+        } else {
+            auto bb = mapBook.bestBid();
+            if (bb) {
+                const uint64_t qty = 1 + rng() % 400;
+                EXPECT_EQ(mapBook.applyTrade(*bb, qty, Aggressor::Sell),
+                          tickBook.applyTrade(*bb, qty, Aggressor::Sell));
+            }
+        }
+
+        ASSERT_EQ(mapBook.bestBid(), tickBook.bestBid()) << "step " << step;
+        ASSERT_EQ(mapBook.bestAsk(), tickBook.bestAsk()) << "step " << step;
+        ASSERT_EQ(mapBook.bestBidSize(), tickBook.bestBidSize()) << "step " << step;
+        ASSERT_EQ(mapBook.bestAskSize(), tickBook.bestAskSize()) << "step " << step;
+        if (step % 500 == 0) {
+            ASSERT_EQ(levels(mapBook, Side::Bid), levels(tickBook, Side::Bid)) << "step " << step;
+            ASSERT_EQ(levels(mapBook, Side::Ask), levels(tickBook, Side::Ask)) << "step " << step;
+            std::string why;
+            ASSERT_TRUE(tickBook.checkInvariants(&why)) << why;
+        }
+    }
+}
+
+// ===================== Manager selection =====================
+
+TEST(TickLadderTest, ManagerSelectsLadderPerSymbol) {
+    OrderBookManager mgr;
+    mgr.setTickSize("FAST", 0.01);
+    mgr.setTickSize("SLOW", 0.01);
+    mgr.setLadder("FAST", LadderConfig{LadderKind::Tick, 1024});
+    EXPECT_EQ(mgr.ladderKind("FAST"), LadderKind::Tick);
+    EXPECT_EQ(mgr.ladderKind("SLOW"), LadderKind::Map);
+
+    mgr.onAdd("FAST", 1, Side::Bid, 10.00, 100, 1);
+    mgr.onAdd("FAST", 2, Side::Bid, 10.05, 200, 2);
+    mgr.onAdd("SLOW", 1, Side::Bid, 10.00, 100, 1);
+    EXPECT_EQ(mgr.ladderKind("FAST"), LadderKind::Tick);
+    EXPECT_DOUBLE_EQ(*mgr.bestBid("FAST"), 10.05);
+    EXPECT_EQ(mgr.bestBidSize("FAST"), 200u);
+
+    std::vector<std::pair<double, uint64_t>> bids, asks;
+    mgr.depthN("FAST", 5, bids, asks);
+    ASSERT_EQ(bids.size(), 2u);
+    EXPECT_DOUBLE_EQ(bids[1].first, 10.00);
+
+    mgr.setDefaultLadder(LadderConfig{LadderKind::Tick, 64});
+    EXPECT_EQ(mgr.ladderKind("OTHER"), LadderKind::Tick);
+    EXPECT_EQ(mgr.ladderKind("SLOW"), LadderKind::Map);   // existing book keeps its ladder
+}
@@ -0,0 +1,282 @@
+// MarketTickComputer batched, concurrent and taParallel evaluation against
+// the sequential per-tick compute() path.
+
+#include "gma/AtomicStore.hpp"
+#include "gma/Dispatcher.hpp"
+#include "gma/Event.hpp"
+#include "gma/MarketTA.hpp"
+#include "gma/StreamValue.hpp"
+#include "gma/market/MarketFieldMap.hpp"
+#include "gma/nodes/INode.hpp"
+#include "gma/rt/ThreadPool.hpp"
+#include "gma/util/Config.hpp"
+
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gma;
+
+namespace {
+
+class TestNode : public INode {
+public:
+    std::vector<StreamValue> received;
+    void onValue(const StreamValue& sv) override { received.push_back(sv); }
+    void shutdown() noexcept override {}
+};
+
+Event makeTick(const std::string& symbol,
+               std::initializer_list<std::pair<const char*, double>> fields) {
+    auto doc = std::make_shared<rapidjson::Document>();
+    doc->SetObject();
+    auto& a = doc->GetAllocator();
+    for (auto& [k, v] : fields) {
+        doc->AddMember(rapidjson::Value(k, a), rapidjson::Value(v), a);
+    }
+    return Event{symbol, std::move(doc)};
+}
+
+// A market-open style burst: `symbols` names, each ticking `perSymbol`
+// times, interleaved round-robin.
+std::vector<Event> burst(int symbols, int perSymbol) {
+    std::vector<Event> out;
+    for (int k = 0; k < perSymbol; ++k) {
+        for (int s = 0; s < symbols; ++s) {
+            const double px = 100.0 + s + 0.25 * ((k * 7 + s) % 5);
+            out.push_back(makeTick("S" + std::to_string(s),
+                                   {{"lastPrice", px}, {"volume", 10.0 + k},
+                                    {"bid", px - 0.01}, {"ask", px + 0.01}}));
+        }
+    }
+    return out;
+}
+
+market::MarketFieldMap quoteFieldMap() {
+    market::MarketFieldMap fm;
+    fm.bidFields = {"bid"};
+    fm.askFields = {"ask"};
+    return fm;
+}
+
+double num(const AtomicStore& store, const std::string& sym, const char* key) {
+    auto v = store.get(sym, key);
+    if (!v) return std::nan("");
+    if (auto d = std::get_if<double>(&*v)) return *d;
+    return std::nan("");
+}
+
+// Every (symbol, key) the equivalence tests compare.
+void expectSameState(const AtomicStore& want, const AtomicStore& got, int symbols) {
+    for (int s = 0; s < symbols; ++s) {
+        const std::string sym = "S" + std::to_string(s);
+        for (const char* key : {"lastPrice", "sma_5", "ema_12", "macd_line", "macd_signal",
+                                "rsi_14", "bollinger_upper", "obv", "vwap", "median",
+                                "bid", "ask", "spread"}) {
+            const double a = num(want, sym, key), b = num(got, sym, key);
+            if (std::isnan(a)) EXPECT_TRUE(std::isnan(b)) << sym << " " << key;
+            else               EXPECT_DOUBLE_EQ(a, b) << sym << " " << key;
+        }
+    }
+}
+
+} // namespace
+
+TEST(MarketTickBatchTest, BatchEndsInSameStateAsPerTickCompute) {
+    util::Config cfg;
+    cfg.taSMA = {5};
+    const auto ticks = burst(40, 30);   // past the batch's linear-scan limit
+
+    AtomicStore seqStore, batchStore;
+    MarketTickComputer seq(cfg, quoteFieldMap()), batch(cfg, quoteFieldMap());
+    engine::ComputeContext seqCtx{&seqStore, nullptr, nullptr};
+    engine::ComputeContext batchCtx{&batchStore, nullptr, nullptr};
+
+    for (const auto& t : ticks) seq.compute(t, seqCtx);
+    // Two bursts, so the second continues from state the first left.
+    const std::span<const Event> all(ticks);
+    batch.computeBatch(all.first(ticks.size() / 2), batchCtx);
+    batch.computeBatch(all.subspan(ticks.size() / 2), batchCtx);
+
+    expectSameState(seqStore, batchStore, 40);
+}
+
+TEST(MarketTickBatchTest, SymbolThatTicksRepeatedlyNotifiesEveryValueInOrder) {
+    util::Config cfg;
+    cfg.taSMA = {2};
+    const std::vector<Event> ticks = {
+        makeTick("A", {{"lastPrice", 1.0}}),
+        makeTick("B", {{"lastPrice", 10.0}}),
+        makeTick("A", {{"lastPrice", 3.0}}),
+        makeTick("B", {{"lastPrice", 20.0}}),
+        makeTick("A", {{"lastPrice", 5.0}}),
+    };
+    auto run = [&](bool batched) {
+        AtomicStore store;
+        Dispatcher dispatcher(nullptr, &store, cfg);
+        auto a = std::make_shared<TestNode>();
+        auto b = std::make_shared<TestNode>();
+        dispatcher.registerListener("A", "sma_2", a);
+        dispatcher.registerListener("B", "sma_2", b);
+
+        MarketTickComputer computer(cfg);
+        engine::ComputeContext ctx{&store, &dispatcher, nullptr};
+        if (batched) computer.computeBatch(ticks, ctx);
+        else for (const auto& t : ticks) computer.compute(t, ctx);
+        EXPECT_DOUBLE_EQ(num(store, "A", "lastPrice"), 5.0);
+
+        std::vector<std::vector<double>> out(2);
+        for (const auto& sv : a->received) out[0].push_back(std::get<double>(sv.value));
+        for (const auto& sv : b->received) out[1].push_back(std::get<double>(sv.value));
+        return out;
+    };
+
+    const auto batched = run(true);
+    EXPECT_EQ(batched[0], (std::vector<double>{2.0, 4.0}));   // (1+3)/2, (3+5)/2
+    EXPECT_EQ(batched[1], (std::vector<double>{15.0}));
+    EXPECT_EQ(batched, run(false));
+}
+
+TEST(MarketTickBatchTest, SymbolCapStillWritesQuotes) {
+    util::Config cfg;
+    cfg.maxSymbols = 1;
+    AtomicStore store;
+    MarketTickComputer computer(cfg, quoteFieldMap());
+    engine::ComputeContext ctx{&store, nullptr, nullptr};
+
+    std::vector<Event> ticks = {
+        makeTick("IN",   {{"lastPrice", 1.0}}),
+        makeTick("OVER", {{"lastPrice", 2.0}, {"bid", 1.5}, {"ask", 2.5}}),
+        makeTick("junk", {{"notAPrice", 2.0}}),
+    };
+    computer.computeBatch(ticks, ctx);
+
+    EXPECT_TRUE(store.get("IN", "lastPrice").has_value());
+    EXPECT_FALSE(store.get("OVER", "lastPrice").has_value());
+    EXPECT_DOUBLE_EQ(num(store, "OVER", "spread"), 1.0);
+    EXPECT_FALSE(store.get("junk", "lastPrice").has_value());
+}
+
+TEST(MarketTickBatchTest, ParallelTAKeepsPerSymbolOrder) {
+    util::Config cfg;
+    cfg.taSMA = {5};
+    const auto ticks = burst(24, 60);
+
+    AtomicStore seqStore;
+    MarketTickComputer seq(cfg, quoteFieldMap());
+    engine::ComputeContext seqCtx{&seqStore, nullptr, nullptr};
+    for (const auto& t : ticks) seq.compute(t, seqCtx);
+
+    cfg.taParallel = true;
+    rt::ThreadPool pool(4);
+    AtomicStore parStore;
+    {
+        MarketTickComputer par(cfg, quoteFieldMap());
+        engine::ComputeContext parCtx{&parStore, nullptr, &pool};
+        // Mix single ticks and bursts so tasks see both.
+        const std::span<const Event> all(ticks);
+        for (std::size_t i = 0; i < all.size();) {
+            const std::size_t n = std::min<std::size_t>(1 + i % 37, all.size() - i);
+            par.computeBatch(all.subspan(i, n), parCtx);
+            i += n;
+        }
+        pool.drain();
+    }
+    expectSameState(seqStore, parStore, 24);
+}
+
+TEST(MarketTickBatchTest, FeedThreadsOnDisjointSymbolsDontInterfere) {
+    util::Config cfg;
+    cfg.taSMA = {5};
+    const auto ticks = burst(16, 80);
+
+    AtomicStore seqStore;
+    MarketTickComputer seq(cfg, quoteFieldMap());
+    engine::ComputeContext seqCtx{&seqStore, nullptr, nullptr};
+    for (const auto& t : ticks) seq.compute(t, seqCtx);
+
+    // Four feed threads, each owning the symbols S{k}, S{k+4}, ...
+    AtomicStore store;
+    MarketTickComputer shared(cfg, quoteFieldMap());
+    std::vector<std::thread> feeders;
+    for (int k = 0; k < 4; ++k) {
+        feeders.emplace_back([&, k] {
+            engine::ComputeContext ctx{&store, nullptr, nullptr};
+            for (std::size_t i = 0; i < ticks.size(); ++i) {
+                if (static_cast<int>(i % 16) % 4 == k) shared.compute(ticks[i], ctx);
+            }
+        });
+    }
+    for (auto& f : feeders) f.join();
+    expectSameState(seqStore, store, 16);
+}
+
+TEST(MarketTickBatchTest, ParallelWithoutPoolRunsInline) {
+    util::Config cfg;
+    cfg.taParallel = true;
+    AtomicStore store;
+    MarketTickComputer computer(cfg);
+    engine::ComputeContext ctx{&store, nullptr, nullptr};
+    computer.compute(makeTick("A", {{"lastPrice", 7.0}}), ctx);
+    EXPECT_DOUBLE_EQ(num(store, "A", "lastPrice"), 7.0);
+}
+
+// With taParallel, TA is queued on the pool, so the dispatcher — not the
+// computer — must append lastPrice before a direct subscriber is notified.
+TEST(MarketTickBatchTest, ParallelTALeavesLastPriceWindowCurrentForSubscribers) {
+    util::Config cfg;
+    cfg.taParallel = true;
+    cfg.taSMA = {5};
+    rt::ThreadPool pool(4);
+    AtomicStore store;
+    Dispatcher dispatcher(&pool, &store, cfg);
+    dispatcher.addComputer(std::make_unique<MarketTickComputer>(cfg));
+
+    // On each lastPrice value, records the window the subscriber reads.
+    struct WindowNode : INode {
+        HistoryStore* history = nullptr;
+        std::mutex mu;
+        std::vector<std::pair<double, std::size_t>> seen;   // value, window size
+        void onValue(const StreamValue& sv) override {
+            auto* series = history->series(sv.symbol);
+            ASSERT_NE(series, nullptr);
+            std::shared_lock<std::shared_mutex> lock(series->mutex());
+            auto* col = series->column("lastPrice");
+            ASSERT_NE(col, nullptr);
+            std::lock_guard<std::mutex> lk(mu);
+            seen.emplace_back(std::get<double>(sv.value), col->size());
+        }
+        void shutdown() noexcept override {}
+    };
+    auto node = std::make_shared<WindowNode>();
+    node->history = &dispatcher.history();
+    dispatcher.registerListener("A", "lastPrice", node);
+
+    constexpr int N = 40;
+    for (int k = 1; k <= N; ++k) {
+        dispatcher.onTick(makeTick("A", {{"lastPrice", double(k)}, {"volume", 1.0}}));
+    }
+    pool.drain();
+
+    std::lock_guard<std::mutex> lk(node->mu);
+    ASSERT_EQ(node->seen.size(), std::size_t(N));
+    for (const auto& [value, size] : node->seen) {
+        EXPECT_GE(size, static_cast<std::size_t>(value)) << value;   // tick k is in the window
+    }
+    auto* series = dispatcher.history().series("A");
+    std::shared_lock<std::shared_mutex> lock(series->mutex());
+    auto* col = series->column("lastPrice");
+    ASSERT_EQ(col->size(), std::size_t(N));
+    EXPECT_DOUBLE_EQ(col->back(), double(N));
+    EXPECT_EQ(col->owner(), nullptr);
+    EXPECT_DOUBLE_EQ(num(store, "A", "sma_5"), (N + N - 1 + N - 2 + N - 3 + N - 4) / 5.0);
+}
@@ -0,0 +1,186 @@
+// MarketTickDecoder: single-pass extraction against the per-alias lookup
+// rules MarketTickComputer has always used, the per-alias fallback for
+// field maps too wide for the single pass, and the raw-text scan against
+// the DOM decode.
+
+#include "gma/market/MarketTickDecoder.hpp"
+
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using gma::TickEntry;
+using gma::market::MarketFieldMap;
+using gma::market::MarketTickDecoder;
+
+namespace {
+
+MarketFieldMap quoteMap() {
+    MarketFieldMap fm;
+    fm.bidFields      = {"bid", "b"};
+    fm.askFields      = {"ask", "a"};
+    fm.timestampField = "ts";
+    return fm;
+}
+
+bool decodeJson(const MarketTickDecoder& d, const std::string& json, TickEntry& out) {
+    rapidjson::Document doc;
+    doc.Parse(json.c_str());
+    EXPECT_FALSE(doc.HasParseError()) << json;
+    return d.decode(doc, out);
+}
+
+} // namespace
+
+TEST(MarketTickDecoderTest, EarliestAliasWinsWhateverTheMemberOrder) {
+    MarketTickDecoder d(quoteMap());
+    TickEntry t;
+    ASSERT_TRUE(decodeJson(d, R"({"px":1,"last":2,"qty":7,"lastPrice":3,"b":4,"bid":5,"volume":9})", t));
+    EXPECT_DOUBLE_EQ(t.price, 3.0);
+    EXPECT_DOUBLE_EQ(t.volume, 9.0);
+    EXPECT_DOUBLE_EQ(t.bid, 5.0);
+    EXPECT_DOUBLE_EQ(t.ask, 0.0);
+    EXPECT_EQ(t.timestampNs, 0u);
+}
+
+TEST(MarketTickDecoderTest, NonNumericAliasFallsThroughToTheNext) {
+    MarketTickDecoder d(quoteMap());
+    TickEntry t;
+    ASSERT_TRUE(decodeJson(d, R"({"lastPrice":"n/a","price":10.5,"ts":-5,"a":null,"ask":11})", t));
+    EXPECT_DOUBLE_EQ(t.price, 10.5);
+    EXPECT_DOUBLE_EQ(t.ask, 11.0);
+    EXPECT_EQ(t.timestampNs, 0u);   // signed: not a timestamp
+
+    ASSERT_TRUE(decodeJson(d, R"({"price":1,"ts":1700000000000000000})", t));
+    EXPECT_EQ(t.timestampNs, 1700000000000000000u);
+
+    EXPECT_FALSE(decodeJson(d, R"({"lastPrice":"1","volume":5})", t));
+}
+
+TEST(MarketTickDecoderTest, RepeatedMemberCountsAtFirstOccurrence) {
+    MarketTickDecoder d(MarketFieldMap{});
+    TickEntry t;
+    // The first "lastPrice" is not a number, so lastPrice is skipped (as
+    // FindMember would) and "price" wins over the later numeric repeat.
+    ASSERT_TRUE(decodeJson(d, R"({"lastPrice":true,"price":4,"lastPrice":5})", t));
+    EXPECT_DOUBLE_EQ(t.price, 4.0);
+}
+
+TEST(MarketTickDecoderTest, WideFieldMapProbesAliasesWithTheSameResult) {
+    const MarketFieldMap fm = quoteMap();
+    MarketFieldMap wide = fm;
+    for (int i = 0; i < int(MarketTickDecoder::kMaxKeys); ++i)
+        wide.volumeFields.push_back("vol" + std::to_string(i));   // never present
+    const MarketTickDecoder narrow(fm), probing(wide);
+    EXPECT_TRUE(narrow.singlePass());
+    EXPECT_FALSE(probing.singlePass());
+
+    std::vector<std::string> names;
+    for (const auto* list : {&fm.priceFields, &fm.volumeFields, &fm.bidFields, &fm.askFields})
+        names.insert(names.end(), list->begin(), list->end());
+    names.insert(names.end(), {"ts", "symbol", "venue", "seq", "pricey", "x"});
+    const std::vector<std::string> values = {
+        "1", "0", "-3", "12.75", "1e3", "2.5E-2", "18446744073709551615", "1700000000000000001",
+        "99999999999999999999", "\"str\"", "true", "null", "[1,2]", "{\"bid\":1}"};
+
+    std::mt19937 rng(50);
+    for (int iter = 0; iter < 2000; ++iter) {
+        std::string json = "{";
+        const int members = int(rng() % 9);
+        for (int m = 0; m < members; ++m) {
+            if (m) json += ",";
+            json += "\"" + names[rng() % names.size()] + "\":" + values[rng() % values.size()];
+        }
+        json += "}";
+
+        TickEntry want{}, got{};
+        const bool ok = decodeJson(narrow, json, want);
+        ASSERT_EQ(decodeJson(probing, json, got), ok) << json;
+        if (!ok) continue;
+        EXPECT_DOUBLE_EQ(got.price, want.price) << json;
+        EXPECT_DOUBLE_EQ(got.volume, want.volume) << json;
+        EXPECT_DOUBLE_EQ(got.bid, want.bid) << json;
+        EXPECT_DOUBLE_EQ(got.ask, want.ask) << json;
+        EXPECT_EQ(got.timestampNs, want.timestampNs) << json;
+    }
+}
+
+TEST(MarketTickDecoderTest, ScanAgreesWithDecode) {
+    const MarketFieldMap fm = quoteMap();
+    MarketTickDecoder d(fm);
+
+    std::vector<std::string> names;
+    for (const auto* list : {&fm.priceFields, &fm.volumeFields, &fm.bidFields, &fm.askFields})
+        names.insert(names.end(), list->begin(), list->end());
+    names.insert(names.end(), {"ts", "symbol", "venue", "seq", "pricey", "x"});
+    const std::vector<std::string> values = {
+        "1", "0", "-3", "12.75", "1e3", "2.5E-2", "18446744073709551615", "1700000000000000001",
+        "99999999999999999999", "\"str\"", "\"es\\\"c\\\\\"", "true", "false", "null",
+        "[1,[2,{\"a\":\"]\"}]]", "{\"bid\":1,\"n\":{\"m\":[]}}", "[]", "{}"};
+
+    std::mt19937 rng(50);
+    for (int iter = 0; iter < 5000; ++iter) {
+        std::string json = "{";
+        const int members = int(rng() % 9);
+        for (int m = 0; m < members; ++m) {
+            if (m) json += rng() % 2 ? "," : " ,\n ";
+            json += "\"" + names[rng() % names.size()] + "\"" + (rng() % 2 ? ":" : " : ");
+            json += values[rng() % values.size()];
+        }
+        json += rng() % 2 ? "}" : " }\r\n";
+
+        TickEntry want{}, got{};
+        const bool ok = decodeJson(d, json, want);
+        const auto r = d.scan(json, got);
+        ASSERT_EQ(r, ok ? MarketTickDecoder::Scan::Tick : MarketTickDecoder::Scan::NoPrice) << json;
+        if (!ok) continue;
+        EXPECT_DOUBLE_EQ(got.price, want.price) << json;
+        EXPECT_DOUBLE_EQ(got.volume, want.volume) << json;
+        EXPECT_DOUBLE_EQ(got.bid, want.bid) << json;
+        EXPECT_DOUBLE_EQ(got.ask, want.ask) << json;
+        EXPECT_EQ(got.timestampNs, want.timestampNs) << json;
+    }
+}
+
+TEST(MarketTickDecoderTest, ScanDefersWhatItCannotVouchFor) {
+    MarketTickDecoder d(MarketFieldMap{});
+    TickEntry t;
+    using Scan = MarketTickDecoder::Scan;
+    EXPECT_EQ(d.scan(R"({"last\u0050rice":1})", t), Scan::Unsupported);   // escaped name
+    EXPECT_EQ(d.scan(R"([1,2])", t), Scan::Unsupported);
+    EXPECT_EQ(d.scan(R"({"price":1)", t), Scan::Unsupported);
+    EXPECT_EQ(d.scan(R"({"price":1}{})", t), Scan::Unsupported);
+    EXPECT_EQ(d.scan(R"({"price" 1})", t), Scan::Unsupported);
+    EXPECT_EQ(d.scan(R"({"note":"unterminated})", t), Scan::Unsupported);
+    EXPECT_EQ(d.scan(R"({})", t), Scan::NoPrice);
+    EXPECT_EQ(d.scan(R"({"note":"x"})", t), Scan::NoPrice);
+    ASSERT_EQ(d.scan(R"( { "px" : 7 } )", t), Scan::Tick);
+    EXPECT_DOUBLE_EQ(t.price, 7.0);
+}
+
+TEST(MarketTickDecoderTest, ScanReturnsTheSymbol) {
+    MarketTickDecoder d(MarketFieldMap{});
+    TickEntry t;
+    std::string_view sym;
+    using Scan = MarketTickDecoder::Scan;
+    ASSERT_EQ(d.scan(R"({"symbol":"AAPL","price":1,"symbol":"X"})", t, &sym), Scan::Tick);
+    EXPECT_EQ(sym, "AAPL");
+    ASSERT_EQ(d.scan(R"({"symbol":7,"price":1})", t, &sym), Scan::Tick);
+    EXPECT_TRUE(sym.empty());
+    EXPECT_EQ(d.scan(R"({"symbol":"A\u0042","price":1})", t, &sym), Scan::Unsupported);
+    // The symbol's escapes only matter when it is asked for.
+    EXPECT_EQ(d.scan(R"({"symbol":"A\u0042","price":1})", t), Scan::Tick);
+}
+
+TEST(MarketTickDecoderTest, WideFieldMapIsNotScanned) {
+    MarketFieldMap wide;
+    for (int i = 0; i < int(MarketTickDecoder::kMaxKeys); ++i)
+        wide.volumeFields.push_back("vol" + std::to_string(i));
+    TickEntry t;
+    EXPECT_EQ(MarketTickDecoder(wide).scan(R"({"price":1})", t),
+              MarketTickDecoder::Scan::Unsupported);
+}
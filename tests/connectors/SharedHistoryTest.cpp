@@ -0,0 +1,152 @@
+// The Dispatcher's raw-field history and MarketTickComputer share one
+// HistoryStore: a lastPrice subscriber's FunctionMap values come from the
+// computer's price column rather than a second copy.
+
+#include "gma/AtomicStore.hpp"
+#include "gma/Dispatcher.hpp"
+#include "gma/Event.hpp"
+#include "gma/FunctionRegistry.hpp"
+#include "gma/HistoryStore.hpp"
+#include "gma/MarketTA.hpp"
+#include "gma/StreamValue.hpp"
+#include "gma/nodes/INode.hpp"
+#include "gma/util/Config.hpp"
+
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+using namespace gma;
+
+namespace {
+
+class TestNode : public INode {
+public:
+    std::vector<StreamValue> received;
+    void onValue(const StreamValue& sv) override { received.push_back(sv); }
+    void shutdown() noexcept override {}
+};
+
+Event makeTick(const std::string& symbol,
+               std::initializer_list<std::pair<const char*, double>> fields) {
+    auto doc = std::make_shared<rapidjson::Document>();
+    doc->SetObject();
+    auto& a = doc->GetAllocator();
+    for (auto& [k, v] : fields) {
+        doc->AddMember(rapidjson::Value(k, a), rapidjson::Value(v), a);
+    }
+    return Event{symbol, std::move(doc)};
+}
+
+std::vector<double> column(const Dispatcher& d, const std::string& sym, const char* name,
+                           const void** owner = nullptr) {
+    auto* s = d.history().find(sym);
+    if (!s) return {};
+    std::shared_lock<std::shared_mutex> lock(s->mutex());
+    const auto* c = static_cast<const HistoryStore::Series*>(s)->find(name);
+    if (!c) return {};
+    if (owner) *owner = c->owner();
+    return {c->values().begin(), c->values().end()};
+}
+
+} // namespace
+
+TEST(SharedHistoryTest, LastPriceSubscriberReadsComputerColumn) {
+    util::Config cfg;
+    AtomicStore store;
+    Dispatcher dispatcher(nullptr, &store, cfg);   // registry supplies the tick computer
+    auto node = std::make_shared<TestNode>();
+    dispatcher.registerListener("A", "lastPrice", node);
+
+    for (double p : {1.0, 2.0, 3.0, 4.0, 5.0}) {
+        dispatcher.onTick(makeTick("A", {{"lastPrice", p}, {"volume", 10.0}}));
+    }
+
+    const void* owner = nullptr;
+    EXPECT_EQ(column(dispatcher, "A", "lastPrice", &owner),
+              (std::vector<double>{1, 2, 3, 4, 5}));
+    EXPECT_NE(owner, nullptr);                     // fed by the computer, not appended twice
+    EXPECT_EQ(column(dispatcher, "A", "volume").size(), 5u);
+
+    ASSERT_EQ(node->received.size(), 5u);
+    auto sum = store.get("A", "sum");              // FunctionMap over the shared column
+    ASSERT_TRUE(sum.has_value());
+    EXPECT_DOUBLE_EQ(std::get<double>(*sum), 15.0);
+}
+
+TEST(SharedHistoryTest, BatchWithRepeatedSymbolPushesLikePerTickCalls) {
+    registerBuiltinFunctions();
+    util::Config cfg;
+    auto run = [&](bool batched) {
+        AtomicStore store;
+        Dispatcher dispatcher(nullptr, &store, cfg);
+        auto price = std::make_shared<TestNode>();
+        auto mean  = std::make_shared<TestNode>();
+        dispatcher.registerListener("A", "lastPrice", price);
+        dispatcher.registerListener("A", "mean", mean);
+
+        std::vector<Event> ticks = {
+            makeTick("A", {{"lastPrice", 2.0}, {"volume", 10.0}}),
+            makeTick("A", {{"lastPrice", 4.0}, {"volume", 10.0}}),
+        };
+        if (batched) dispatcher.onTickBatch(ticks);
+        else for (const auto& t : ticks) dispatcher.onTick(t);
+
+        std::vector<double> out;
+        for (const auto* n : {price.get(), mean.get()})
+            for (const auto& sv : n->received) out.push_back(std::get<double>(sv.value));
+        return out;
+    };
+
+    const auto perTick = run(false);
+    EXPECT_EQ(perTick, (std::vector<double>{2, 4, 2, 3}));
+    EXPECT_EQ(run(true), perTick);
+}
+
+TEST(SharedHistoryTest, RawFieldHistoryAppendsOncePerTick) {
+    util::Config cfg;
+    AtomicStore store;
+    Dispatcher dispatcher(nullptr, &store, cfg);
+    auto a = std::make_shared<TestNode>();
+    auto b = std::make_shared<TestNode>();
+    dispatcher.registerListener("X", "foo", a);
+    dispatcher.registerListener("X", "foo", b);
+
+    for (double v : {1.0, 2.0, 3.0}) dispatcher.onTick(makeTick("X", {{"foo", v}}));
+
+    const void* owner = &cfg;
+    EXPECT_EQ(column(dispatcher, "X", "foo", &owner), (std::vector<double>{1, 2, 3}));
+    EXPECT_EQ(owner, nullptr);
+    EXPECT_EQ(a->received.size(), 3u);
+    EXPECT_EQ(b->received.size(), 3u);
+}
+
+TEST(SharedHistoryTest, SecondComputerKeepsPrivateColumns) {
+    util::Config cfg;
+    cfg.taSMA = {2};
+    AtomicStore store;
+    HistoryStore history(100, 10, 10);
+    MarketTickComputer first(cfg), second(cfg);
+    engine::ComputeContext ctx{&store, nullptr, nullptr, &history};
+
+    for (double p : {1.0, 3.0, 5.0}) {
+        const Event t = makeTick("A", {{"lastPrice", p}});
+        first.compute(t, ctx);
+        second.compute(t, ctx);
+    }
+    // The shared column holds each tick once, and both engines still see
+    // the whole tape.
+    auto* s = history.find("A");
+    ASSERT_NE(s, nullptr);
+    std::shared_lock<std::shared_mutex> lock(s->mutex());
+    EXPECT_EQ(s->find("lastPrice")->size(), 3u);
+    EXPECT_EQ(s->find("lastPrice")->owner(), &first);
+    auto sma = store.get("A", "sma_2");
+    ASSERT_TRUE(sma.has_value());
+    EXPECT_DOUBLE_EQ(std::get<double>(*sma), 4.0);
+}
@@ -106,6 +106,7 @@ engine::EngineRegistries buildRegs(util::Config& cfg,
     &engine::EventComputerRegistry::singleton(),
     &engine::NodeTypeRegistry::singleton(),
     &engine::IngressRegistry::singleton(),
+    &engine::StreamRegistry::singleton(),
     &engine::ConfigNamespaceRegistry::singleton(),
     &AtomicProviderRegistry::singleton(),
     &FunctionMap::instance(),
@@ -196,3 +196,19 @@ TEST(AtomicStoreTest, SetBatchConcurrentWithGet) {
     EXPECT_DOUBLE_EQ(getValue<double>(store, "CON", "a"), 499.0);
     EXPECT_DOUBLE_EQ(getValue<double>(store, "CON", "b"), 998.0);
 }
+
+TEST(AtomicStoreTest, SetBatchesWritesEveryStreamKey) {
+    AtomicStore store;
+    store.set("B", "keep", 1);
+    std::vector<std::pair<std::string, AtomicStore::FieldBatch>> batches = {
+        {"A", {{"price", ArgType{1.0}}, {"volume", ArgType{10.0}}}},
+        {"B", {{"price", ArgType{2.0}}}},
+        {"C", {}},
+    };
+    store.setBatches(batches);
+    EXPECT_DOUBLE_EQ(getValue<double>(store, "A", "price"), 1.0);
+    EXPECT_DOUBLE_EQ(getValue<double>(store, "A", "volume"), 10.0);
+    EXPECT_DOUBLE_EQ(getValue<double>(store, "B", "price"), 2.0);
+    EXPECT_EQ(getValue<int>(store, "B", "keep"), 1);
+    EXPECT_FALSE(store.get("C", "price").has_value());
+}
@@ -91,7 +91,8 @@ TEST(ConfigTest, NewTAFieldsParsing) {
           << "taATR=10\n"
           << "taMomentum=5\n"
           << "taMACD_signal=7\n"
-          << "taVolAvg=10\n";
+          << "taVolAvg=10\n"
+          << "taParallel=true\n";
     }
     Config cfg;
     EXPECT_TRUE(cfg.loadFromFile(path));
@@ -102,6 +103,7 @@ TEST(ConfigTest, NewTAFieldsParsing) {
     EXPECT_EQ(cfg.taMomentum, 5);
     EXPECT_EQ(cfg.taMACD_signal, 7);
     EXPECT_EQ(cfg.taVolAvg, 10);
+    EXPECT_TRUE(cfg.taParallel);
     std::remove(path);
 }
 
@@ -114,4 +116,32 @@ TEST(ConfigTest, DefaultNewTAFields) {
     EXPECT_EQ(cfg.taMomentum, 10);
     EXPECT_EQ(cfg.taMACD_signal, 9);
     EXPECT_EQ(cfg.taVolAvg, 20);
+    EXPECT_FALSE(cfg.taParallel);
+}
+
+TEST(ConfigTest, BookTickLadderParsing) {
+    Config defaults;
+    EXPECT_TRUE(defaults.bookTickLadderSymbols.empty());
+    EXPECT_EQ(defaults.bookTickWindow, 4096);
+    EXPECT_FALSE(defaults.bookHugePages);
+    EXPECT_TRUE(defaults.bookDepthLimitSymbols.empty());
+    EXPECT_EQ(defaults.bookDepthLimit, 10);
+
+    const char* path = "test_config_book.ini";
+    {
+        std::ofstream f(path);
+        f << "bookTickLadderSymbols = AAPL, MSFT\n"
+          << "bookTickWindow=1024\n"
+          << "bookHugePages=true\n"
+          << "bookDepthLimitSymbols = *\n"
+          << "bookDepthLimit = 5\n";
+    }
+    Config cfg;
+    EXPECT_TRUE(cfg.loadFromFile(path));
+    EXPECT_EQ(cfg.bookTickLadderSymbols, (std::vector<std::string>{"AAPL", "MSFT"}));
+    EXPECT_EQ(cfg.bookTickWindow, 1024);
+    EXPECT_TRUE(cfg.bookHugePages);
+    EXPECT_EQ(cfg.bookDepthLimitSymbols, (std::vector<std::string>{"*"}));
+    EXPECT_EQ(cfg.bookDepthLimit, 5);
+    std::remove(path);
 }
@@ -0,0 +1,171 @@
+#include "gma/HistoryStore.hpp"
+#include "gma/ta/Indicators.hpp"
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <thread>
+#include <vector>
+
+using gma::HistoryStore;
+using Column = gma::HistoryStore::Column;
+
+namespace {
+
+bool aligned(const void* p) {
+    return reinterpret_cast<std::uintptr_t>(p) % Column::ALIGNMENT == 0;
+}
+
+} // namespace
+
+TEST(HistoryStoreTest, ColumnPushAndRead) {
+    Column c(8);
+    EXPECT_TRUE(c.empty());
+    for (int i = 0; i < 3; ++i) c.push_back(100.0 + i);
+
+    ASSERT_EQ(c.size(), 3u);
+    EXPECT_DOUBLE_EQ(c[0], 100.0);
+    EXPECT_DOUBLE_EQ(c.back(), 102.0);
+    EXPECT_EQ(c.values().size(), 3u);
+    EXPECT_DOUBLE_EQ(c.values()[1], 101.0);
+}
+
+TEST(HistoryStoreTest, ColumnSlidingWindowStaysContiguousAndOrdered) {
+    // Window of 50 over 10k values: many compactions and no growth past the
+    // limit once the window is full.
+    const std::size_t W = 50;
+    Column c(W);
+    std::deque<double> ref;
+    std::size_t maxCap = 0;
+
+    for (int i = 0; i < 10000; ++i) {
+        c.push_back(i);
+        ref.push_back(i);
+        if (c.size() > W) { c.pop_front(); ref.pop_front(); }
+        maxCap = std::max(maxCap, c.capacity());
+
+        ASSERT_EQ(c.size(), ref.size());
+        auto v = c.values();
+        for (std::size_t j = 0; j < ref.size(); ++j) {
+            ASSERT_DOUBLE_EQ(v[j], ref[j]) << "value " << i << " slot " << j;
+        }
+    }
+    EXPECT_LE(maxCap, W + W / 4 + 16);
+}
+
+TEST(HistoryStoreTest, ColumnIsAlignedAndShortSeriesStaySmall) {
+    Column big(1000);
+    for (int i = 0; i < 700; ++i) big.push_back(i);
+    big.clear();
+    big.push_back(0);
+    EXPECT_TRUE(aligned(big.values().data()));
+
+    Column small(1000);
+    for (int i = 0; i < 5; ++i) small.push_back(i);
+    EXPECT_LE(small.capacity(), 16u);
+}
+
+TEST(HistoryStoreTest, ColumnOverfillingGrowsInsteadOfCorrupting) {
+    Column c(4);
+    for (int i = 0; i < 100; ++i) c.push_back(i);
+    ASSERT_EQ(c.size(), 100u);
+    EXPECT_DOUBLE_EQ(c[99], 99.0);
+    EXPECT_DOUBLE_EQ(c[0], 0.0);
+}
+
+TEST(HistoryStoreTest, ColumnMoveTransfersWindow) {
+    Column a(8);
+    for (int i = 0; i < 5; ++i) a.push_back(i);
+    a.pop_front();
+
+    Column b(std::move(a));
+    EXPECT_EQ(a.size(), 0u);
+    ASSERT_EQ(b.size(), 4u);
+    EXPECT_DOUBLE_EQ(b[0], 1.0);
+
+    Column c(2);
+    c = std::move(b);
+    ASSERT_EQ(c.size(), 4u);
+    EXPECT_DOUBLE_EQ(c[3], 4.0);
+}
+
+TEST(HistoryStoreTest, SeriesAreStableAndCapped) {
+    HistoryStore store(100, 2, 2);
+    auto* a = store.series("A");
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(store.series("A"), a);
+    EXPECT_NE(store.series("B"), nullptr);
+    EXPECT_EQ(store.series("C"), nullptr);        // symbol cap
+    EXPECT_EQ(store.find("C"), nullptr);
+    EXPECT_EQ(store.symbolCount(), 2u);
+
+    std::unique_lock<std::shared_mutex> lock(a->mutex());
+    auto* px = a->column("lastPrice");
+    ASSERT_NE(px, nullptr);
+    px->push_back(1.0);
+    ASSERT_NE(a->column("volume"), nullptr);
+    EXPECT_EQ(a->column("bid"), nullptr);          // column cap
+    // More columns never move existing ones.
+    EXPECT_EQ(a->find("lastPrice"), px);
+    EXPECT_DOUBLE_EQ(px->back(), 1.0);
+}
+
+TEST(HistoryStoreTest, ClaimTakesOverRawColumnOnce) {
+    HistoryStore store(100, 10, 10);
+    auto* s = store.series("A");
+    std::unique_lock<std::shared_mutex> lock(s->mutex());
+
+    auto* raw = s->column("lastPrice");
+    raw->push_back(5.0);
+    EXPECT_EQ(raw->owner(), nullptr);
+
+    int ownerA = 0, ownerB = 0;
+    auto* claimed = s->claim("lastPrice", &ownerA);
+    ASSERT_EQ(claimed, raw);
+    EXPECT_TRUE(claimed->empty());                 // raw values dropped
+    EXPECT_EQ(claimed->owner(), &ownerA);
+    EXPECT_EQ(s->claim("lastPrice", &ownerA), raw);
+    EXPECT_EQ(s->claim("lastPrice", &ownerB), nullptr);
+}
+
+TEST(HistoryStoreTest, ConcurrentSymbolCreation) {
+    HistoryStore store(10, 1000, 4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&store] {
+            for (int i = 0; i < 200; ++i) {
+                auto* s = store.series("S" + std::to_string(i));
+                std::unique_lock<std::shared_mutex> lock(s->mutex());
+                s->column("x")->push_back(i);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(store.symbolCount(), 200u);
+    auto* s = store.find("S7");
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(s->find("x")->size(), 4u);
+}
+
+TEST(HistoryStoreTest, IndicatorSpanOverloadsMatchDequeVersions) {
+    Column px(64), vol(64);
+    std::deque<double> rpx, rvol;
+    for (int i = 0; i < 200; ++i) {
+        const double p = 100.0 + (i * 37 % 11) * 0.25, v = 1.0 + (i % 7);
+        px.push_back(p);  rpx.push_back(p);
+        vol.push_back(v); rvol.push_back(v);
+        if (px.size() > 64) { px.pop_front(); vol.pop_front(); rpx.pop_front(); rvol.pop_front(); }
+    }
+    using namespace gma::ta;
+    for (std::size_t n : {1u, 2u, 7u, 20u, 64u}) {
+        EXPECT_NEAR(sma_lastN(px.values(), n),    sma_lastN(rpx, n), 1e-12) << n;
+        EXPECT_EQ(min_lastN(px.values(), n),      min_lastN(rpx, n)) << n;
+        EXPECT_EQ(max_lastN(px.values(), n),      max_lastN(rpx, n)) << n;
+        EXPECT_NEAR(stddev_lastN(px.values(), n), stddev_lastN(rpx, n), 1e-12) << n;
+        EXPECT_EQ(median_lastN(px.values(), n),   median_lastN(rpx, n)) << n;
+        EXPECT_NEAR(vwap_lastN(px.values(), vol.values(), n), vwap_lastN(rpx, rvol, n), 1e-12) << n;
+    }
+    EXPECT_TRUE(std::isnan(sma_lastN(px.values(), 65)));
+    EXPECT_TRUE(std::isnan(median_lastN(px.values(), 0)));
+}
@@ -0,0 +1,195 @@
+// Differential tests: ta::IncrementalTA against the batch
+// computeAllAtomicValues() it replaces, tick by tick over seeded tapes.
+
+#include "gma/AtomicStore.hpp"
+#include "gma/MarketTA.hpp"
+#include "gma/SymbolHistory.hpp"
+#include "gma/ta/IncrementalTA.hpp"
+#include "gma/util/Config.hpp"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace gma;
+
+namespace {
+
+// Random walk on a 0.01 tick grid: repeated prices (median ties, zero
+// diffs for RSI/OBV), occasional jumps and zero-volume prints.
+std::vector<TickEntry> makeTape(std::uint64_t seed, std::size_t n, double start = 100.0) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> step(-3, 3);
+    std::uniform_int_distribution<int> pct(0, 99);
+    std::uniform_real_distribution<double> vol(1.0, 500.0);
+
+    std::vector<TickEntry> tape;
+    tape.reserve(n);
+    long cents = static_cast<long>(start * 100);
+    for (std::size_t i = 0; i < n; ++i) {
+        const int r = pct(rng);
+        if (r < 2)       cents += 50 * step(rng);     // jump
+        else if (r > 20) cents += step(rng);          // otherwise unchanged
+        cents = std::max(1L, cents);
+        const double v = pct(rng) < 5 ? 0.0 : std::floor(vol(rng));
+        tape.push_back(TickEntry{static_cast<double>(cents) / 100.0, v});
+    }
+    return tape;
+}
+
+double asDouble(const ArgType& v) {
+    if (auto d = std::get_if<double>(&v)) return *d;
+    if (auto i = std::get_if<int>(&v))    return static_cast<double>(*i);
+    return std::nan("");
+}
+
+// Replays `tape` through both implementations and compares every key at
+// every tick. Returns the number of values compared.
+std::size_t runDifferential(const std::vector<TickEntry>& tape,
+                            const util::Config& cfg, std::size_t window) {
+    ta::IncrementalTA engine(cfg, window);
+    ta::IncrementalTA::Results got;
+    std::vector<TickEntry> hist;
+    AtomicStore store;
+    std::size_t compared = 0;
+
+    for (std::size_t t = 0; t < tape.size(); ++t) {
+        engine.push(tape[t]);
+        hist.push_back(tape[t]);
+        if (hist.size() > window) hist.erase(hist.begin());
+
+        engine.results(got);
+        auto want = computeAllAtomicValues("S", hist, store, cfg);
+
+        EXPECT_EQ(engine.size(), hist.size());
+        if (got.size() != want.size()) {
+            ADD_FAILURE() << "tick " << t << ": " << got.size() << " keys, batch has " << want.size();
+            return compared;
+        }
+        for (std::size_t i = 0; i < want.size(); ++i) {
+            if (got[i].first != want[i].first) {
+                ADD_FAILURE() << "tick " << t << ": key " << i << " is " << got[i].first
+                              << ", batch has " << want[i].first;
+                return compared;
+            }
+            const double a = asDouble(got[i].second);
+            const double b = asDouble(want[i].second);
+            if (std::isnan(a) || std::isnan(b)) {
+                EXPECT_TRUE(std::isnan(a) && std::isnan(b))
+                    << "tick " << t << " " << want[i].first << ": " << a << " vs " << b;
+            } else {
+                const double tol = 1e-9 * std::max({1.0, std::abs(a), std::abs(b)});
+                EXPECT_NEAR(a, b, tol) << "tick " << t << " " << want[i].first;
+            }
+            ++compared;
+        }
+    }
+    return compared;
+}
+
+} // namespace
+
+TEST(IncrementalTATest, MatchesBatchWithDefaultConfig) {
+    util::Config cfg;
+    const auto tape = makeTape(42, 3000);
+    EXPECT_GT(runDifferential(tape, cfg, static_cast<std::size_t>(cfg.taHistoryMax)), 0u);
+}
+
+TEST(IncrementalTATest, MatchesBatchWithSmallWindowAndSlides) {
+    // Window close to the periods: every indicator runs with a sliding
+    // seed for most of the tape, and resyncs happen every 30 ticks.
+    util::Config cfg;
+    cfg.taSMA = {3, 30, 45};          // 45 never fills
+    cfg.taEMA = {2, 30};
+    cfg.taBBands_n = 30;
+    cfg.taRSI = 29;
+    cfg.taATR = 5;
+    cfg.taVolAvg = 30;
+    cfg.taMACD_fast = 4;
+    cfg.taMACD_slow = 10;
+    cfg.taMACD_signal = 7;
+    runDifferential(makeTape(7, 2000), cfg, 30);
+}
+
+TEST(IncrementalTATest, MatchesBatchWithDegeneratePeriods) {
+    util::Config cfg;
+    cfg.taSMA = {1, 0, -3};
+    cfg.taEMA = {1};
+    cfg.taBBands_n = 1;
+    cfg.taRSI = 1;
+    cfg.taATR = 1;
+    cfg.taMomentum = 1;
+    cfg.taVolAvg = 1;
+    cfg.taMACD_fast = 1;
+    cfg.taMACD_slow = 1;
+    cfg.taMACD_signal = 1;
+    runDifferential(makeTape(9, 400), cfg, 8);
+    runDifferential(makeTape(10, 50), cfg, 1);
+}
+
+TEST(IncrementalTATest, MatchesBatchOnHighPricedVolatileTape) {
+    util::Config cfg;
+    cfg.taMACD_signal = 20;
+    runDifferential(makeTape(1234, 2500, 25000.0), cfg, 200);
+}
+
+TEST(IncrementalTATest, ConstantPricesKeepBandsAndMedianExact) {
+    util::Config cfg;
+    ta::IncrementalTA engine(cfg, 50);
+    for (int i = 0; i < 120; ++i) engine.push(TickEntry{10.0, 1.0});
+
+    ta::IncrementalTA::Results out;
+    engine.results(out);
+    auto find = [&](const std::string& k) {
+        auto it = std::find_if(out.begin(), out.end(), [&](const auto& p) { return p.first == k; });
+        EXPECT_NE(it, out.end()) << k;
+        return it == out.end() ? std::nan("") : asDouble(it->second);
+    };
+    EXPECT_DOUBLE_EQ(find("median"), 10.0);
+    EXPECT_NEAR(find("bollinger_upper"), 10.0, 1e-12);
+    EXPECT_NEAR(find("volatility_rank"), 0.0, 1e-12);
+    EXPECT_DOUBLE_EQ(find("obv"), 0.0);
+}
+
+TEST(IncrementalTATest, InvalidConfigYieldsNoIndicators) {
+    util::Config cfg;
+    cfg.taRSI = 0;
+    ta::IncrementalTA engine(cfg, 10);
+    engine.push(TickEntry{5.0, 1.0});
+    engine.push(TickEntry{7.0, 1.0});
+
+    ta::IncrementalTA::Results out;
+    engine.results(out);
+    EXPECT_TRUE(out.empty());
+    // History and range are still tracked for the non-TA path.
+    EXPECT_EQ(engine.size(), 2u);
+    EXPECT_DOUBLE_EQ(engine.open(), 5.0);
+    EXPECT_DOUBLE_EQ(engine.high(), 7.0);
+    EXPECT_DOUBLE_EQ(engine.low(), 5.0);
+}
+
+TEST(IncrementalTATest, EveryTickFieldIsKeptAsAColumn) {
+    util::Config cfg;
+    ta::IncrementalTA engine(cfg, 4);
+    const std::uint64_t t0 = 1700000000123456789ull;   // not exact as a double
+    for (int i = 0; i < 7; ++i)
+        engine.push(TickEntry{10.0 + i, 100.0 + i, 9.5 + i, 10.5 + i, t0 + i});
+
+    // Window of 4: ticks 3..6 in every column, oldest first.
+    const auto px = engine.prices(), bid = engine.bids(), ask = engine.asks();
+    const auto ts = engine.timestamps();
+    ASSERT_EQ(px.size(), 4u);
+    ASSERT_EQ(bid.size(), 4u);
+    ASSERT_EQ(ask.size(), 4u);
+    ASSERT_EQ(ts.size(), 4u);
+    for (std::size_t i = 0; i < 4; ++i) {
+        EXPECT_DOUBLE_EQ(px[i], 13.0 + i);
+        EXPECT_DOUBLE_EQ(engine.volumes()[i], 103.0 + i);
+        EXPECT_DOUBLE_EQ(bid[i], 12.5 + i);
+        EXPECT_DOUBLE_EQ(ask[i], 13.5 + i);
+        EXPECT_EQ(ts[i], t0 + 3 + i);
+    }
+}
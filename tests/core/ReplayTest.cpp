@@ -0,0 +1,290 @@
+// Tests for deterministic replay: SimulatedClock, the inline ThreadPool,
+// timer nodes driven by a simulated clock, and ReplayDriver end to end.
+// Nothing here sleeps — every timer fires because the test moves time.
+
+#include "gma/rt/Clock.hpp"
+#include "gma/rt/ReplayDriver.hpp"
+#include "gma/rt/ThreadPool.hpp"
+#include "gma/nodes/BucketTime.hpp"
+#include "gma/nodes/INode.hpp"
+#include "gma/nodes/Interval.hpp"
+#include "gma/nodes/Listener.hpp"
+#include "gma/nodes/TumblingWindow.hpp"
+#include "gma/AtomicStore.hpp"
+#include "gma/Dispatcher.hpp"
+#include "gma/StreamValue.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace gma;
+using namespace std::chrono_literals;
+using rt::SimulatedClock;
+
+namespace {
+
+SimulatedClock::time_point at(long long ms) {
+    return SimulatedClock::time_point{std::chrono::milliseconds{ms}};
+}
+
+class Recorder : public INode {
+public:
+    struct Frame { std::string symbol; std::vector<double> values; long long atMs; };
+
+    explicit Recorder(rt::Clock* clock) : clock_(clock) {}
+
+    void onValue(const StreamValue& sv) override {
+        Frame f{sv.symbol, {}, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   clock_->now().time_since_epoch()).count()};
+        if (auto* v = std::get_if<std::vector<double>>(&sv.value)) f.values = *v;
+        else if (auto* d = std::get_if<double>(&sv.value))         f.values = {*d};
+        frames.push_back(std::move(f));
+    }
+    void shutdown() noexcept override {}
+
+    std::vector<Frame> frames;
+
+private:
+    rt::Clock* clock_;
+};
+
+} // namespace
+
+// ---- SimulatedClock ----
+
+TEST(SimulatedClockTest, FiresInDueThenScheduleOrder) {
+    SimulatedClock clock(at(0));
+    std::vector<int> order;
+    clock.schedule(at(20), [&] { order.push_back(3); });
+    clock.schedule(at(10), [&] { order.push_back(1); });
+    clock.schedule(at(10), [&] { order.push_back(2); });
+    clock.schedule(at(30), [&] { order.push_back(4); });
+
+    EXPECT_EQ(clock.advanceTo(at(20)), 3u);
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(clock.now(), at(20));
+    EXPECT_EQ(clock.pending(), 1u);
+}
+
+TEST(SimulatedClockTest, NowIsDueTimeInsideCallbackAndNeverGoesBack) {
+    SimulatedClock clock(at(100));
+    SimulatedClock::time_point seen{};
+    clock.schedule(at(150), [&] { seen = clock.now(); });
+    clock.advanceTo(at(500));
+    EXPECT_EQ(seen, at(150));
+    EXPECT_EQ(clock.now(), at(500));
+
+    clock.advanceTo(at(200));
+    EXPECT_EQ(clock.now(), at(500));
+}
+
+TEST(SimulatedClockTest, RearmInsideWindowAndCancel) {
+    SimulatedClock clock(at(0));
+    int fired = 0;
+    std::function<void()> rearm = [&] {
+        ++fired;
+        clock.schedule(clock.now() + 10ms, rearm);
+    };
+    clock.schedule(at(10), rearm);
+    EXPECT_EQ(clock.advanceTo(at(55)), 5u);
+    EXPECT_EQ(fired, 5);
+
+    auto id = clock.schedule(at(56), [&] { fired = -1; });
+    clock.cancel(id);
+    clock.advanceTo(at(59));
+    EXPECT_EQ(fired, 5);
+}
+
+// ---- Inline ThreadPool ----
+
+TEST(InlineThreadPoolTest, RunsOnCallerInFifoOrder) {
+    rt::ThreadPool pool(rt::ThreadPool::Inline);
+    EXPECT_TRUE(pool.isInline());
+    std::vector<int> order;
+    pool.post([&] {
+        order.push_back(1);
+        pool.post([&] { order.push_back(3); });   // queued behind the running task
+        order.push_back(2);
+    });
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+
+    pool.post([] { throw std::runtime_error("boom"); });
+    pool.post([&] { order.push_back(4); });
+    EXPECT_EQ(order.back(), 4);
+    pool.drain();
+    pool.shutdown();
+}
+
+// ---- Timer nodes on a simulated clock ----
+
+TEST(SimulatedTimerTest, IntervalTicksOncePerPeriodOfSimulatedTime) {
+    SimulatedClock clock(at(0));
+    rt::ThreadPool pool(rt::ThreadPool::Inline);
+    auto rec = std::make_shared<Recorder>(&clock);
+    auto iv = std::make_shared<Interval>(100ms, rec, &pool, &clock);
+    iv->start();
+
+    clock.advanceTo(at(1000));
+    ASSERT_EQ(rec->frames.size(), 10u);
+    EXPECT_EQ(rec->frames.front().atMs, 100);
+    EXPECT_EQ(rec->frames.back().atMs, 1000);
+
+    iv->shutdown();
+    clock.advanceTo(at(5000));
+    EXPECT_EQ(rec->frames.size(), 10u);
+    EXPECT_EQ(clock.pending(), 0u);
+}
+
+TEST(SimulatedTimerTest, BucketTimeTicksOnAlignedBoundaries) {
+    SimulatedClock clock(at(1250));
+    rt::ThreadPool pool(rt::ThreadPool::Inline);
+    auto rec = std::make_shared<Recorder>(&clock);
+    auto bt = std::make_shared<BucketTime>(1000ms, rec, &pool, &clock);
+    bt->start();
+
+    clock.advanceTo(at(4000));
+    ASSERT_EQ(rec->frames.size(), 3u);
+    EXPECT_EQ(rec->frames[0].atMs, 2000);
+    EXPECT_EQ(rec->frames[1].atMs, 3000);
+    EXPECT_EQ(rec->frames[2].atMs, 4000);
+    bt->shutdown();
+}
+
+TEST(SimulatedTimerTest, TumblingWindowBucketsBySimulatedTime) {
+    SimulatedClock clock(at(0));
+    rt::ThreadPool pool(rt::ThreadPool::Inline);
+    auto rec = std::make_shared<Recorder>(&clock);
+    auto tw = std::make_shared<TumblingWindow>(1000ms, rec, &pool, &clock);
+    tw->start();
+
+    clock.advanceTo(at(200));
+    tw->onValue({"A", 1.0});
+    tw->onValue({"A", 2.0});
+    clock.advanceTo(at(1500));      // boundary at 1000 flushes {1,2}
+    tw->onValue({"A", 3.0});
+    clock.advanceTo(at(3000));      // 2000 flushes {3}; 3000 is empty
+
+    ASSERT_EQ(rec->frames.size(), 2u);
+    EXPECT_EQ(rec->frames[0].values, (std::vector<double>{1.0, 2.0}));
+    EXPECT_EQ(rec->frames[0].atMs, 1000);
+    EXPECT_EQ(rec->frames[1].values, (std::vector<double>{3.0}));
+    EXPECT_EQ(rec->frames[1].atMs, 2000);
+    tw->shutdown();
+}
+
+// ---- ReplayDriver ----
+
+namespace {
+
+// Listener("AAPL","price") -> TumblingWindow(1s) -> Recorder, replayed from
+// a recording whose events straddle three buckets.
+std::vector<Recorder::Frame> replayOnce(rt::ReplayDriver::Stats& stats) {
+    static const char* kRecording =
+        R"({"ts":1000100,"symbol":"AAPL","price":10.0})" "\n"
+        R"({"ts":1000400,"symbol":"AAPL","price":11.0})" "\n"
+        R"({"ts":1000900,"symbol":"MSFT","price":99.0})" "\n"
+        "\n"
+        R"(not json)" "\n"
+        R"({"ts":1001200,"symbol":"AAPL","price":12.0})" "\n"
+        R"({"symbol":"AAPL","price":13.0})" "\n"
+        R"({"ts":1003050,"symbol":"AAPL","price":14.0})" "\n";
+
+    SimulatedClock clock(at(1000000));
+    rt::ThreadPool pool(rt::ThreadPool::Inline);
+    AtomicStore store;
+    Dispatcher dispatcher(&pool, &store);
+
+    auto rec = std::make_shared<Recorder>(&clock);
+    auto tw  = std::make_shared<TumblingWindow>(1000ms, rec, &pool, &clock);
+    tw->start();
+    auto listener = nodes::Listener::Create("AAPL", "price", tw, &pool, &dispatcher);
+    EXPECT_TRUE(listener.has_value());
+
+    rt::ReplayDriver driver(dispatcher, clock);
+    std::istringstream in(kRecording);
+    EXPECT_EQ(driver.replayJsonl(in), 5u);
+    driver.finish(at(1004000));
+    stats = driver.stats();
+
+    (*listener)->shutdown();
+    tw->shutdown();
+    return rec->frames;
+}
+
+} // namespace
+
+TEST(ReplayDriverTest, TimersFollowEventTimestamps) {
+    rt::ReplayDriver::Stats stats;
+    auto frames = replayOnce(stats);
+
+    EXPECT_EQ(stats.events, 5u);
+    EXPECT_EQ(stats.rejected, 2u);
+    EXPECT_EQ(stats.timers, 4u);     // boundaries 1001..1004 s
+
+    ASSERT_EQ(frames.size(), 3u);
+    EXPECT_EQ(frames[0].atMs, 1001000);
+    EXPECT_EQ(frames[0].values, (std::vector<double>{10.0, 11.0}));
+    EXPECT_EQ(frames[1].atMs, 1002000);
+    EXPECT_EQ(frames[1].values, (std::vector<double>{12.0}));
+    EXPECT_EQ(frames[2].atMs, 1004000);
+    EXPECT_EQ(frames[2].values, (std::vector<double>{14.0}));
+}
+
+TEST(ReplayDriverTest, RepeatedRunsProduceIdenticalOutput) {
+    rt::ReplayDriver::Stats s1, s2;
+    auto a = replayOnce(s1);
+    auto b = replayOnce(s2);
+    ASSERT_EQ(a.size(), b.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].symbol, b[i].symbol);
+        EXPECT_EQ(a[i].atMs,   b[i].atMs);
+        EXPECT_EQ(a[i].values, b[i].values);
+    }
+}
+
+TEST(ReplayDriverTest, RejectsTimestampsOutsideTheClockRange) {
+    SimulatedClock clock(at(1000000));
+    rt::ThreadPool pool(rt::ThreadPool::Inline);
+    AtomicStore store;
+    Dispatcher dispatcher(&pool, &store);
+    rt::ReplayDriver driver(dispatcher, clock);
+
+    std::istringstream in(
+        R"({"ts":1e300,"symbol":"AAPL","price":1.0})" "\n"
+        R"({"ts":-1e300,"symbol":"AAPL","price":1.0})" "\n"
+        R"({"ts":9223372036854775807,"symbol":"AAPL","price":1.0})" "\n"
+        R"({"ts":18446744073709551615,"symbol":"AAPL","price":1.0})" "\n"
+        R"({"ts":1000500.5,"symbol":"AAPL","price":2.0})" "\n");
+    EXPECT_EQ(driver.replayJsonl(in), 1u);
+    EXPECT_EQ(driver.stats().rejected, 4u);
+    EXPECT_EQ(clock.now(), at(1000500));
+}
+
+TEST(ReplayDriverTest, FirstTimestampSkipsBadLinesAndRewinds) {
+    std::istringstream in(
+        "\n"
+        R"(not json)" "\n"
+        R"({"ts":1e300,"symbol":"AAPL"})" "\n"
+        R"({"ts":1000250,"symbol":"AAPL","price":1.0})" "\n"
+        R"({"ts":1000500,"symbol":"AAPL","price":2.0})" "\n");
+    auto first = rt::ReplayDriver::firstTimestamp(in);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(*first, at(1000250));
+
+    // The stream is back at its start: a replay sees every line.
+    SimulatedClock clock(*first);
+    rt::ThreadPool pool(rt::ThreadPool::Inline);
+    AtomicStore store;
+    Dispatcher dispatcher(&pool, &store);
+    rt::ReplayDriver driver(dispatcher, clock);
+    EXPECT_EQ(driver.replayJsonl(in), 2u);
+    EXPECT_EQ(driver.stats().rejected, 2u);
+
+    std::istringstream empty("\n" R"({"symbol":"AAPL"})" "\n");
+    EXPECT_FALSE(rt::ReplayDriver::firstTimestamp(empty).has_value());
+}
@@ -0,0 +1,134 @@
+// Tests for gma::util::simd — runtime-dispatched reduction kernels behind
+// the vector-consuming FunctionMap builtins. Every ISA the host supports is
+// compared against the scalar reference within the tolerance documented in
+// include/gma/util/VectorKernels.hpp.
+
+#include "gma/util/VectorKernels.hpp"
+#include "gma/FunctionMap.hpp"
+#include <gtest/gtest.h>
+
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+using namespace gma::util;
+
+namespace {
+
+// Restores the dispatch level after each test so ordering can't leak a
+// forced ISA into unrelated suites.
+class VectorKernelsTest : public ::testing::Test {
+protected:
+  void TearDown() override { simd::forceIsa(simd::detectedIsa()); }
+
+  static std::vector<simd::Isa> availableIsas() {
+    std::vector<simd::Isa> out{simd::Isa::Scalar};
+    if (static_cast<int>(simd::detectedIsa()) >= static_cast<int>(simd::Isa::Avx2))
+      out.push_back(simd::Isa::Avx2);
+    if (simd::detectedIsa() == simd::Isa::Avx512)
+      out.push_back(simd::Isa::Avx512);
+    return out;
+  }
+
+  static std::vector<double> prices(std::size_t n, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> d(90.0, 110.0);
+    std::vector<double> v(n);
+    for (auto& x : v) x = d(rng);
+    return v;
+  }
+
+  static double absSum(const std::vector<double>& v) {
+    double s = 0.0;
+    for (double x : v) s += std::abs(x);
+    return s;
+  }
+};
+
+} // namespace
+
+// Odd lengths exercise every tail path (unrolled body, single-vector loop,
+// scalar remainder) on both vector widths.
+TEST_F(VectorKernelsTest, SumMatchesScalarWithinTolerance) {
+  for (std::size_t n : {0u, 1u, 15u, 16u, 17u, 33u, 1000u, 4099u, 100003u}) {
+    auto v = prices(n, static_cast<unsigned>(n));
+    simd::forceIsa(simd::Isa::Scalar);
+    const double ref = simd::sum(v.data(), v.size());
+    const double tol = 2.0 * static_cast<double>(n) * DBL_EPSILON * absSum(v);
+    for (auto isa : availableIsas()) {
+      simd::forceIsa(isa);
+      EXPECT_NEAR(simd::sum(v.data(), v.size()), ref, tol)
+          << "isa=" << simd::isaName(isa) << " n=" << n;
+    }
+  }
+}
+
+TEST_F(VectorKernelsTest, MinMaxIsExact) {
+  for (std::size_t n : {2u, 7u, 16u, 31u, 1000u, 65537u}) {
+    auto v = prices(n, 7u + static_cast<unsigned>(n));
+    // Plant extremes at the tail so the scalar remainder must see them.
+    v.back() = 1e9;
+    v[v.size() / 3] = -1e9;
+    for (auto isa : availableIsas()) {
+      simd::forceIsa(isa);
+      auto mm = simd::minMax(v.data(), v.size());
+      EXPECT_EQ(mm.max, 1e9) << "isa=" << simd::isaName(isa) << " n=" << n;
+      EXPECT_EQ(mm.min, -1e9) << "isa=" << simd::isaName(isa) << " n=" << n;
+    }
+  }
+}
+
+TEST_F(VectorKernelsTest, SumSqDevMatchesScalarWithinTolerance) {
+  for (std::size_t n : {2u, 17u, 1000u, 250001u}) {
+    auto v = prices(n, 99u + static_cast<unsigned>(n));
+    simd::forceIsa(simd::Isa::Scalar);
+    const double mean = simd::sum(v.data(), v.size()) / static_cast<double>(n);
+    const double ref  = simd::sumSqDev(v.data(), v.size(), mean);
+    const double tol  = 2.0 * static_cast<double>(n) * DBL_EPSILON * ref;
+    for (auto isa : availableIsas()) {
+      simd::forceIsa(isa);
+      EXPECT_NEAR(simd::sumSqDev(v.data(), v.size(), mean), ref, tol)
+          << "isa=" << simd::isaName(isa) << " n=" << n;
+    }
+  }
+}
+
+TEST_F(VectorKernelsTest, ProductRelativeErrorBounded) {
+  // Values near 1.0 keep the product finite for long vectors.
+  std::mt19937_64 rng(3);
+  std::uniform_real_distribution<double> d(0.999, 1.001);
+  std::vector<double> v(5000);
+  for (auto& x : v) x = d(rng);
+
+  simd::forceIsa(simd::Isa::Scalar);
+  const double ref = simd::product(v.data(), v.size());
+  for (auto isa : availableIsas()) {
+    simd::forceIsa(isa);
+    const double got = simd::product(v.data(), v.size());
+    EXPECT_LE(std::abs(got - ref) / std::abs(ref),
+              2.0 * static_cast<double>(v.size()) * DBL_EPSILON)
+        << "isa=" << simd::isaName(isa);
+  }
+}
+
+TEST_F(VectorKernelsTest, ForceIsaClampsToDetected) {
+  auto chosen = simd::forceIsa(simd::Isa::Avx512);
+  EXPECT_EQ(chosen, simd::detectedIsa());
+  EXPECT_EQ(simd::activeIsa(), simd::detectedIsa());
+  EXPECT_EQ(simd::forceIsa(simd::Isa::Scalar), simd::Isa::Scalar);
+}
+
+// The FunctionMap builtins keep their names and semantics — variance over a
+// large bucket agrees across dispatch levels.
+TEST_F(VectorKernelsTest, BuiltinVarianceAgreesAcrossIsas) {
+  auto v = prices(1u << 16, 42u);
+  auto fn = gma::FunctionMap::instance().getFunction("variance");
+  simd::forceIsa(simd::Isa::Scalar);
+  const double ref = fn(v);
+  for (auto isa : availableIsas()) {
+    simd::forceIsa(isa);
+    EXPECT_NEAR(fn(v), ref, 1e-9 * ref) << "isa=" << simd::isaName(isa);
+  }
+}
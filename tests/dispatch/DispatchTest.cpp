@@ -3,11 +3,15 @@
 #include "gma/StreamValue.hpp"
 #include "gma/rt/ThreadPool.hpp"
 #include "gma/AtomicStore.hpp"
+#include "gma/engine/IEventComputer.hpp"
 #include "gma/nodes/INode.hpp"
 #include <gtest/gtest.h>
 #include <rapidjson/document.h>
 #include <memory>
 #include <atomic>
+#include <span>
+#include <string>
+#include <vector>
 
 using namespace gma;
 
@@ -102,3 +106,117 @@ TEST(DispatcherTest, MultipleListenersSameSymbol) {
     EXPECT_GE(l1->count.load(), 1);
     EXPECT_GE(l2->count.load(), 1);
 }
+
+namespace {
+// Records each batch it is handed; the default computeBatch isn't used.
+class BatchRecorder : public engine::IEventComputer {
+public:
+    explicit BatchRecorder(std::string type) : _type(std::move(type)) {}
+    std::string_view eventType() const override { return _type; }
+    void compute(const Event& e, engine::ComputeContext&) override { singles.push_back(e.symbol); }
+    void computeBatch(std::span<const Event> events, engine::ComputeContext&) override {
+        std::vector<std::string> syms;
+        for (const auto& e : events) syms.push_back(e.symbol);
+        batches.push_back(std::move(syms));
+    }
+    std::vector<std::vector<std::string>> batches;
+    std::vector<std::string> singles;
+private:
+    std::string _type;
+};
+
+// Only overrides compute(); exercises IEventComputer's default computeBatch.
+class PerEventCounter : public engine::IEventComputer {
+public:
+    std::string_view eventType() const override { return "quote"; }
+    void compute(const Event& e, engine::ComputeContext&) override { seen.push_back(e.symbol); }
+    std::vector<std::string> seen;
+};
+} // namespace
+
+TEST(DispatcherTest, TickBatchSplitsRunsByTypeAndSkipsInvalid) {
+    AtomicStore store;
+    Dispatcher md(nullptr, &store);
+    auto rec = std::make_unique<BatchRecorder>("quote");
+    auto* recPtr = rec.get();
+    auto counter = std::make_unique<PerEventCounter>();
+    auto* counterPtr = counter.get();
+    md.addComputer(std::move(rec));
+    md.addComputer(std::move(counter));
+
+    auto listener = std::make_shared<TestListener>();
+    md.registerListener("B", "price", listener);
+
+    auto quote = [](const std::string& sym) {
+        Event e = makeTick(sym, "price", 1.0);
+        e.type = "quote";
+        return e;
+    };
+    std::vector<Event> batch = {
+        quote("A"), quote("B"),
+        makeTick("C", "price", 2.0),          // "tick" breaks the run
+        quote("D"),
+        Event{"", nullptr, "quote"},          // invalid: skipped, breaks the run
+        quote("E"), quote("B"),
+    };
+    md.onTickBatch(batch);
+
+    ASSERT_EQ(recPtr->batches.size(), 3u);
+    EXPECT_EQ(recPtr->batches[0], (std::vector<std::string>{"A", "B"}));
+    EXPECT_EQ(recPtr->batches[1], (std::vector<std::string>{"D"}));
+    EXPECT_EQ(recPtr->batches[2], (std::vector<std::string>{"E", "B"}));
+    EXPECT_TRUE(recPtr->singles.empty());
+    EXPECT_EQ(counterPtr->seen, (std::vector<std::string>{"A", "B", "D", "E", "B"}));
+    // Raw fields still fan out per event.
+    EXPECT_EQ(listener->count.load(), 2);
+}
+
+TEST(DispatcherTest, TickBatchCutsRunWhereSymbolRepeats) {
+    AtomicStore store;
+    Dispatcher md(nullptr, &store);
+    auto rec = std::make_unique<BatchRecorder>("quote");
+    auto* recPtr = rec.get();
+    md.addComputer(std::move(rec));
+
+    auto quote = [](const std::string& sym) {
+        Event e = makeTick(sym, "price", 1.0);
+        e.type = "quote";
+        return e;
+    };
+    std::vector<Event> batch = {quote("A"), quote("B"), quote("A"), quote("C"), quote("B")};
+    // Past the linear-scan limit the cut still happens.
+    for (int i = 0; i < 20; ++i) batch.push_back(quote("S" + std::to_string(i)));
+    batch.push_back(quote("S3"));
+    md.onTickBatch(batch);
+
+    ASSERT_EQ(recPtr->batches.size(), 3u);
+    EXPECT_EQ(recPtr->batches[0], (std::vector<std::string>{"A", "B"}));
+    EXPECT_EQ(recPtr->batches[1].size(), 23u);   // A C B S0..S19
+    EXPECT_EQ(recPtr->batches[2], (std::vector<std::string>{"S3"}));
+}
+
+TEST(DispatcherTest, WantsPayloadOnlyForRawFieldListenersOrReadingComputers) {
+    AtomicStore store;
+    Dispatcher md(nullptr, &store);
+    // PerEventCounter keeps IEventComputer's readsPayload() default.
+    auto counter = std::make_unique<PerEventCounter>();
+    auto* counterPtr = counter.get();
+    md.addComputer(std::move(counter));
+
+    EXPECT_FALSE(md.wantsPayload("A", "nodomtype"));
+    EXPECT_TRUE(md.wantsPayload("A", "quote"));
+
+    auto listener = std::make_shared<TestListener>();
+    md.registerListener("A", "price", listener);
+    EXPECT_TRUE(md.wantsPayload("A", "nodomtype"));
+    EXPECT_TRUE(md.wantsPayload("A", "nodomtype", R"({"price":1})"));
+    EXPECT_FALSE(md.wantsPayload("A", "nodomtype", R"({"lastprice":1,"x":"price "})"));
+    EXPECT_FALSE(md.wantsPayload("B", "nodomtype"));
+
+    // A decoded event without a payload still reaches the computers.
+    Event e{"A", nullptr, "quote"};
+    e.decoded = std::make_shared<int>(1);
+    md.onTick(e);
+    md.onTickBatch(std::span<const Event>(&e, 1));
+    EXPECT_EQ(counterPtr->seen, (std::vector<std::string>{"A", "A"}));
+}
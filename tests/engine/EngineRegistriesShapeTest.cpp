@@ -32,6 +32,7 @@ TEST(EngineRegistriesShapeTest, AllFieldsPopulatable) {
     &engine::EventComputerRegistry::singleton(),
     &engine::NodeTypeRegistry::singleton(),
     &engine::IngressRegistry::singleton(),
+    &engine::StreamRegistry::singleton(),
     &engine::ConfigNamespaceRegistry::singleton(),
     &AtomicProviderRegistry::singleton(),
     &FunctionMap::instance(),
@@ -51,6 +52,7 @@ TEST(EngineRegistriesShapeTest, AllFieldsPopulatable) {
   EXPECT_NE(regs.computers, nullptr);
   EXPECT_NE(regs.nodes,     nullptr);
   EXPECT_NE(regs.ingress,   nullptr);
+  EXPECT_NE(regs.streams,   nullptr);
   EXPECT_NE(regs.configNs,  nullptr);
   EXPECT_NE(regs.providers, nullptr);
   EXPECT_NE(regs.functions, nullptr);
@@ -61,14 +63,15 @@ TEST(EngineRegistriesShapeTest, AllFieldsPopulatable) {
   EXPECT_EQ(&engine::EventComputerRegistry::singleton(), &engine::EventComputerRegistry::singleton());
   EXPECT_EQ(&engine::NodeTypeRegistry::singleton(),      &engine::NodeTypeRegistry::singleton());
   EXPECT_EQ(&engine::IngressRegistry::singleton(),       &engine::IngressRegistry::singleton());
+  EXPECT_EQ(&engine::StreamRegistry::singleton(),        &engine::StreamRegistry::singleton());
   EXPECT_EQ(&engine::ConfigNamespaceRegistry::singleton(),&engine::ConfigNamespaceRegistry::singleton());
   EXPECT_EQ(&AtomicProviderRegistry::singleton(),        &AtomicProviderRegistry::singleton());
 }
 
-TEST(EngineRegistriesShapeTest, FieldCountIs14) {
-  // Guard against accidental field removal: sizeof should equal 14 pointers.
-  // (Six per-instance + eight registry pointers, all 8-byte on x86_64.)
-  static_assert(sizeof(engine::EngineRegistries) == 14 * sizeof(void*),
-                "EngineRegistries must carry exactly 14 pointer-sized fields");
+TEST(EngineRegistriesShapeTest, FieldCountIs15) {
+  // Guard against accidental field removal: sizeof should equal 15 pointers.
+  // (Six per-instance + nine registry pointers, all 8-byte on x86_64.)
+  static_assert(sizeof(engine::EngineRegistries) == 15 * sizeof(void*),
+                "EngineRegistries must carry exactly 15 pointer-sized fields");
   SUCCEED();
 }
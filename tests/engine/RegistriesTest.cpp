@@ -4,6 +4,7 @@
 #include "gma/engine/IEventComputer.hpp"
 #include "gma/engine/IngressRegistry.hpp"
 #include "gma/engine/NodeTypeRegistry.hpp"
+#include "gma/engine/StreamRegistry.hpp"
 #include "gma/nodes/INode.hpp"
 #include "gma/Event.hpp"
 
@@ -188,6 +189,22 @@ TEST(IngressRegistryTest, DuplicateRejected) {
   EXPECT_FALSE(IngressRegistry::registerIngress("x", factory));
 }
 
+// ---------- StreamRegistry ----------
+// Named kinds only: the market connector's "depth" kind stays registered.
+
+TEST(StreamRegistryTest, RegisterFindAndUnregister) {
+  auto factory = [](const std::string&, std::uint32_t, const StreamParams&, StreamSink)
+      -> std::unique_ptr<IStream> {
+    return nullptr;
+  };
+  EXPECT_TRUE(StreamRegistry::registerStream("__test_kind__", factory));
+  EXPECT_FALSE(StreamRegistry::registerStream("__test_kind__", factory));
+  EXPECT_TRUE(StreamRegistry::contains("__test_kind__"));
+  EXPECT_TRUE(static_cast<bool>(StreamRegistry::find("__test_kind__")));
+  EXPECT_TRUE(StreamRegistry::unregisterStream("__test_kind__"));
+  EXPECT_FALSE(static_cast<bool>(StreamRegistry::find("__test_kind__")));
+}
+
 // ---------- ConfigNamespaceRegistry ----------
 
 TEST(ConfigNamespaceRegistryTest, DispatchRoutesByPrefix) {
@@ -486,6 +486,30 @@ TEST(ItchAdapterTest, TradePriceAsStringParsesCorrectly) {
     EXPECT_DOUBLE_EQ(trade.price, 185.25);
 }
 
+TEST(ItchAdapterTest, OnlyDirectoryAndAddOrderInternSymbols) {
+    ItchAdapter adapter;
+
+    for (int i = 0; i < 100; ++i) {
+        adapter.translate(JsonBuilder()
+            .str("type", "trade")
+            .str("stock", ("T" + std::to_string(i)).c_str())
+            .num("price", 1.0)
+            .uint("shares", 1)
+            .build());
+    }
+    EXPECT_EQ(adapter.symbolCount(), 0u);
+
+    adapter.translate(JsonBuilder()
+        .str("type", "add_order")
+        .uint("orderRef", 1)
+        .str("side", "B")
+        .uint("shares", 10)
+        .str("stock", "AAPL    ")
+        .num("price", 10.0)
+        .build());
+    EXPECT_EQ(adapter.symbolCount(), 1u);
+}
+
 // ===========================================================================
 // system_event
 // ===========================================================================
@@ -598,3 +622,73 @@ TEST(ItchAdapterTest, FullOrderLifecycle) {
         .uint("orderRef", 2)
         .build()).empty());
 }
+
+TEST(ItchAdapterTest, AddOutsideItchWidthsIsDropped) {
+    ItchAdapter adapter;
+
+    // Shares wider than ITCH's 32-bit field
+    EXPECT_TRUE(adapter.translate(JsonBuilder()
+        .str("type", "add_order")
+        .str("stock", "WIDE")
+        .uint("orderRef", 1)
+        .str("side", "B")
+        .uint("shares", 5'000'000'000ULL)
+        .num("price", 10.0)
+        .build()).empty());
+
+    // Price beyond Price(4)
+    EXPECT_TRUE(adapter.translate(JsonBuilder()
+        .str("type", "add_order")
+        .str("stock", "WIDE")
+        .uint("orderRef", 2)
+        .str("side", "S")
+        .uint("shares", 100)
+        .num("price", 500'000.0)
+        .build()).empty());
+
+    // Neither is tracked, so later messages for them do nothing.
+    EXPECT_TRUE(adapter.translate(JsonBuilder()
+        .str("type", "order_delete")
+        .uint("orderRef", 1)
+        .build()).empty());
+}
+
+TEST(ItchAdapterTest, LocateResolvedOrderKeepsSymbolAndPrice) {
+    ItchAdapter adapter;
+    adapter.translate(JsonBuilder()
+        .str("type", "stock_directory")
+        .integer("stockLocate", 300)
+        .str("stock", "LOC     ")
+        .build());
+
+    auto addEvents = adapter.translate(JsonBuilder()
+        .str("type", "add_order")
+        .integer("stockLocate", 300)
+        .uint("orderRef", 77)
+        .str("side", "S")
+        .uint("shares", 400)
+        .num("price", 12.3456)
+        .build());
+    ASSERT_EQ(countEvents<ObAddEvent>(addEvents), 1u);
+    EXPECT_EQ(getEvent<ObAddEvent>(addEvents).symbol, "LOC");
+
+    auto execEvents = adapter.translate(JsonBuilder()
+        .str("type", "order_executed")
+        .uint("orderRef", 77)
+        .uint("shares", 150)
+        .build());
+    ASSERT_EQ(countEvents<ObTradeEvent>(execEvents), 1u);
+    EXPECT_EQ(getEvent<ObTradeEvent>(execEvents).symbol, "LOC");
+    EXPECT_DOUBLE_EQ(getEvent<ObTradeEvent>(execEvents).price, 12.3456);
+    EXPECT_EQ(getEvent<ObUpdateEvent>(execEvents).newSize.value(), 250u);
+
+    // Unknown locate: nothing to resolve against.
+    EXPECT_TRUE(adapter.translate(JsonBuilder()
+        .str("type", "add_order")
+        .integer("stockLocate", 301)
+        .uint("orderRef", 78)
+        .str("side", "B")
+        .uint("shares", 1)
+        .num("price", 1.0)
+        .build()).empty());
+}
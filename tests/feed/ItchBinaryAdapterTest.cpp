@@ -0,0 +1,253 @@
+#include "gma/feed/ItchBinaryAdapter.hpp"
+#include "gma/feed/FeedEvent.hpp"
+#include "gma/book/OrderBookManager.hpp"
+#include "gma/market/MarketIngress.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gma;
+using namespace gma::feed;
+
+// ---------------------------------------------------------------------------
+// Helpers — build ITCH 5.0 messages at their wire offsets
+// ---------------------------------------------------------------------------
+namespace {
+
+class Msg {
+public:
+    Msg(char type, uint16_t locate, std::size_t len) : b_(len, 0) {
+        if (len < 3) return;            // len 0: an empty frame
+        b_[0] = static_cast<uint8_t>(type);
+        u16(1, locate);
+    }
+    Msg& u16(std::size_t off, uint16_t v) { return be(off, v, 2); }
+    Msg& u32(std::size_t off, uint32_t v) { return be(off, v, 4); }
+    Msg& u64(std::size_t off, uint64_t v) { return be(off, v, 8); }
+    Msg& ch(std::size_t off, char c) { b_[off] = static_cast<uint8_t>(c); return *this; }
+    Msg& stock(std::size_t off, const std::string& s) {
+        for (std::size_t i = 0; i < 8; ++i) b_[off + i] = i < s.size() ? s[i] : ' ';
+        return *this;
+    }
+    std::size_t size() const { return b_.size(); }
+    const std::vector<uint8_t>& bytes() const { return b_; }
+
+private:
+    Msg& be(std::size_t off, uint64_t v, int n) {
+        for (int i = n - 1; i >= 0; --i, v >>= 8) b_[off + i] = static_cast<uint8_t>(v);
+        return *this;
+    }
+    std::vector<uint8_t> b_;
+};
+
+// Length-prefixed stream of messages.
+std::string frame(const std::vector<Msg>& msgs) {
+    std::string out;
+    for (const auto& m : msgs) {
+        out.push_back(static_cast<char>(m.size() >> 8));
+        out.push_back(static_cast<char>(m.size() & 0xFF));
+        out.append(m.bytes().begin(), m.bytes().end());
+    }
+    return out;
+}
+
+Msg directory(uint16_t locate, const std::string& stock) {
+    return Msg('R', locate, 39).stock(11, stock);
+}
+Msg add(uint16_t locate, uint64_t ref, char side, uint32_t shares,
+        const std::string& stock, uint32_t price4) {
+    return Msg('A', locate, 36).u64(11, ref).ch(19, side).u32(20, shares).stock(24, stock).u32(32, price4);
+}
+Msg executed(uint16_t locate, uint64_t ref, uint32_t shares) {
+    return Msg('E', locate, 31).u64(11, ref).u32(19, shares).u64(23, 1);
+}
+Msg executedAt(uint16_t locate, uint64_t ref, uint32_t shares, char printable, uint32_t price4) {
+    return Msg('C', locate, 36).u64(11, ref).u32(19, shares).u64(23, 1).ch(31, printable).u32(32, price4);
+}
+Msg cancel(uint16_t locate, uint64_t ref, uint32_t shares) {
+    return Msg('X', locate, 23).u64(11, ref).u32(19, shares);
+}
+Msg del(uint16_t locate, uint64_t ref) {
+    return Msg('D', locate, 19).u64(11, ref);
+}
+Msg replace(uint16_t locate, uint64_t orig, uint64_t ref, uint32_t shares, uint32_t price4) {
+    return Msg('U', locate, 35).u64(11, orig).u64(19, ref).u32(27, shares).u32(31, price4);
+}
+
+template <typename T>
+size_t countEvents(const std::vector<FeedEvent>& events) {
+    size_t n = 0;
+    for (const auto& e : events) if (std::holds_alternative<T>(e)) ++n;
+    return n;
+}
+
+template <typename T>
+const T& getEvent(const std::vector<FeedEvent>& events, size_t nth = 0) {
+    size_t count = 0;
+    for (const auto& e : events) {
+        if (std::holds_alternative<T>(e)) {
+            if (count == nth) return std::get<T>(e);
+            ++count;
+        }
+    }
+    throw std::runtime_error("Event not found");
+}
+
+} // anonymous namespace
+
+// ===========================================================================
+// Order lifecycle
+// ===========================================================================
+TEST(ItchBinaryAdapterTest, FullOrderLifecycle) {
+    ItchBinaryAdapter adapter;
+
+    auto dirEvents = adapter.translate(frame({directory(7, "LIFE")}));
+    ASSERT_EQ(countEvents<ObTickSizeEvent>(dirEvents), 1u);
+    EXPECT_EQ(getEvent<ObTickSizeEvent>(dirEvents).symbol, "LIFE");
+
+    auto addEvents = adapter.translate(frame({add(7, 1, 'B', 500, "LIFE", 1'000'000)}));
+    ASSERT_EQ(countEvents<ObAddEvent>(addEvents), 1u);
+    const auto& a = getEvent<ObAddEvent>(addEvents);
+    EXPECT_EQ(a.symbol, "LIFE");
+    EXPECT_EQ(a.orderId, 1u);
+    EXPECT_EQ(a.side, Side::Bid);
+    EXPECT_DOUBLE_EQ(a.price, 100.0);
+    EXPECT_EQ(a.size, 500u);
+
+    // Partial fill: 200 of 500 at the resting price; a bid was hit
+    auto execEvents = adapter.translate(frame({executed(7, 1, 200)}));
+    EXPECT_EQ(getEvent<ObUpdateEvent>(execEvents).newSize.value(), 300u);
+    EXPECT_DOUBLE_EQ(getEvent<ObTradeEvent>(execEvents).price, 100.0);
+    EXPECT_EQ(getEvent<ObTradeEvent>(execEvents).aggressor, Aggressor::Sell);
+    EXPECT_EQ(countEvents<TickEvent>(execEvents), 1u);
+
+    auto cancelEvents = adapter.translate(frame({cancel(7, 1, 100)}));
+    EXPECT_EQ(getEvent<ObUpdateEvent>(cancelEvents).newSize.value(), 200u);
+
+    auto replaceEvents = adapter.translate(frame({replace(7, 1, 2, 200, 1'010'000)}));
+    ASSERT_EQ(countEvents<ObDeleteEvent>(replaceEvents), 1u);
+    EXPECT_EQ(getEvent<ObDeleteEvent>(replaceEvents).orderId, 1u);
+    ASSERT_EQ(countEvents<ObAddEvent>(replaceEvents), 1u);
+    EXPECT_EQ(getEvent<ObAddEvent>(replaceEvents).orderId, 2u);
+    EXPECT_EQ(getEvent<ObAddEvent>(replaceEvents).side, Side::Bid);
+    EXPECT_DOUBLE_EQ(getEvent<ObAddEvent>(replaceEvents).price, 101.0);
+
+    auto fillEvents = adapter.translate(frame({executed(7, 2, 200)}));
+    EXPECT_EQ(countEvents<ObDeleteEvent>(fillEvents), 1u);
+    EXPECT_EQ(countEvents<ObTradeEvent>(fillEvents), 1u);
+
+    EXPECT_TRUE(adapter.translate(frame({del(7, 2)})).empty());
+    EXPECT_EQ(adapter.stats().unknownRef, 1u);
+    EXPECT_EQ(adapter.stats().messages, 7u);
+}
+
+TEST(ItchBinaryAdapterTest, ExecutionWithPriceHonoursPrintable) {
+    ItchBinaryAdapter adapter;
+    adapter.translate(frame({directory(1, "PRN"), add(1, 9, 'S', 1000, "PRN", 50'000)}));
+
+    auto quiet = adapter.translate(frame({executedAt(1, 9, 100, 'N', 49'900)}));
+    EXPECT_EQ(countEvents<ObUpdateEvent>(quiet), 1u);
+    EXPECT_EQ(countEvents<ObTradeEvent>(quiet), 0u);
+    EXPECT_EQ(countEvents<TickEvent>(quiet), 0u);
+
+    auto printed = adapter.translate(frame({executedAt(1, 9, 100, 'Y', 49'900)}));
+    ASSERT_EQ(countEvents<ObTradeEvent>(printed), 1u);
+    EXPECT_DOUBLE_EQ(getEvent<ObTradeEvent>(printed).price, 4.99);
+    EXPECT_EQ(getEvent<ObTradeEvent>(printed).aggressor, Aggressor::Buy);
+    EXPECT_EQ(getEvent<ObUpdateEvent>(printed).newSize.value(), 800u);
+}
+
+TEST(ItchBinaryAdapterTest, TradesResolveUnregisteredLocateByTicker) {
+    ItchBinaryAdapter adapter;
+    Msg trade = Msg('P', 42, 44).u64(11, 0).ch(19, 'B').u32(20, 300).stock(24, "HIDN").u32(32, 123'400);
+    Msg cross = Msg('Q', 42, 40).u64(11, 5000).stock(19, "IGNORED").u32(27, 123'500).ch(39, 'O');
+
+    auto events = adapter.translate(frame({trade, cross}));
+    ASSERT_EQ(countEvents<ObTradeEvent>(events), 2u);
+    EXPECT_EQ(getEvent<ObTradeEvent>(events, 0).symbol, "HIDN");
+    EXPECT_EQ(getEvent<ObTradeEvent>(events, 0).size, 300u);
+    EXPECT_EQ(getEvent<ObTradeEvent>(events, 0).aggressor, Aggressor::Unknown);
+    // The locate is bound on first sight; the cross resolves through it.
+    EXPECT_EQ(getEvent<ObTradeEvent>(events, 1).symbol, "HIDN");
+    EXPECT_EQ(getEvent<ObTradeEvent>(events, 1).size, 5000u);
+    EXPECT_DOUBLE_EQ(getEvent<ObTradeEvent>(events, 1).price, 12.35);
+    const auto& tick = getEvent<TickEvent>(events, 1);
+    EXPECT_DOUBLE_EQ((*tick.payload)["volume"].GetDouble(), 5000.0);
+}
+
+// ===========================================================================
+// Framing
+// ===========================================================================
+TEST(ItchBinaryAdapterTest, DecodeStopsAtPartialMessage) {
+    ItchBinaryAdapter adapter;
+    const std::string wire = frame({directory(3, "SPLT"), add(3, 1, 'B', 10, "SPLT", 10'000),
+                                    add(3, 2, 'S', 20, "SPLT", 10'100)});
+    const auto* p = reinterpret_cast<const uint8_t*>(wire.data());
+
+    // Cut inside the third message: the first two decode, the rest waits.
+    std::vector<FeedEvent> out;
+    const std::size_t cut = wire.size() - 5;
+    const std::size_t used = adapter.decode(p, cut, out);
+    EXPECT_EQ(used, 2u + 39u + 2u + 36u);
+    EXPECT_EQ(countEvents<ObAddEvent>(out), 1u);
+
+    EXPECT_EQ(adapter.decode(p + used, wire.size() - used, out), wire.size() - used);
+    EXPECT_EQ(countEvents<ObAddEvent>(out), 2u);
+    EXPECT_EQ(adapter.decode(p, 1, out), 0u);
+}
+
+TEST(ItchBinaryAdapterTest, ShortAndUnknownMessagesAreCounted) {
+    ItchBinaryAdapter adapter;
+    Msg shortAdd('A', 1, 20);                    // needs 36 bytes
+    Msg halt = Msg('H', 1, 25).stock(11, "HALT");
+    Msg empty('S', 0, 0);
+    auto events = adapter.translate(frame({shortAdd, halt, empty}));
+    EXPECT_TRUE(events.empty());
+    EXPECT_EQ(adapter.stats().messages, 3u);
+    EXPECT_EQ(adapter.stats().malformed, 2u);
+    EXPECT_EQ(adapter.stats().skipped, 1u);
+}
+
+// ===========================================================================
+// File replay ingress
+// ===========================================================================
+TEST(ItchBinaryAdapterTest, ReplayIngressAppliesFileToBooks) {
+    std::vector<Msg> msgs{directory(5, "RPLY")};
+    for (uint64_t ref = 1; ref <= 2000; ++ref) {
+        const bool bid = ref % 2;
+        msgs.push_back(add(5, ref, bid ? 'B' : 'S', 100,
+                           "RPLY", bid ? 1'000'000 - uint32_t(ref) * 100 : 1'100'000 + uint32_t(ref) * 100));
+    }
+    for (uint64_t ref = 1; ref <= 1000; ++ref) msgs.push_back(del(5, ref));
+
+    const std::string path = ::testing::TempDir() + "itch_replay_test.bin";
+    {
+        std::ofstream f(path, std::ios::binary);
+        f << frame(msgs);
+    }
+
+    OrderBookManager mgr;
+    market::ItchReplayIngress replay(path, nullptr, &mgr);
+    replay.start();
+    for (int i = 0; i < 500 && !replay.finished(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    replay.stop();
+    std::remove(path.c_str());
+
+    ASSERT_TRUE(replay.finished());
+    // Refs 1..1000 are gone: best bid is ref 1001, best ask ref 1002.
+    EXPECT_DOUBLE_EQ(mgr.bestBid("RPLY").value(), (1'000'000 - 1001 * 100) / 1e4);
+    EXPECT_DOUBLE_EQ(mgr.bestAsk("RPLY").value(), (1'100'000 + 1002 * 100) / 1e4);
+}
+
+TEST(ItchBinaryAdapterTest, ReplayIngressRejectsMissingFile) {
+    OrderBookManager mgr;
+    EXPECT_THROW(market::ItchReplayIngress("/nonexistent/itch.bin", nullptr, &mgr),
+                 std::runtime_error);
+}
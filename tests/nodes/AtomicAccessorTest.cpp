@@ -1,5 +1,6 @@
 #include "gma/nodes/AtomicAccessor.hpp"
 #include "gma/AtomicStore.hpp"
+#include "gma/atomic/AtomicProviderRegistry.hpp"
 #include "gma/StreamValue.hpp"
 #include <gtest/gtest.h>
 #include <memory>
@@ -109,3 +110,31 @@ TEST(AtomicAccessorTest, NoCrashOnShutdownWithoutStore) {
     AtomicAccessor accessor("SYM", "field", nullptr, downstream);
     EXPECT_NO_THROW({ accessor.shutdown(); });
 }
+
+TEST(AtomicAccessorTest, CompilesProviderKeyOnce) {
+    int compiles = 0, resolves = 0;
+    AtomicProviderRegistry::registerNamespace("tst",
+        [&](const std::string&, const std::string&) { ++resolves; return -1.0; });
+    AtomicProviderRegistry::registerCompiler("tst",
+        [&](const std::string& key) -> AtomicProviderRegistry::CompiledFn {
+            ++compiles;
+            if (key != "tst.good") return {};
+            return [](const std::string& sym) { return sym == "SYM" ? 7.0 : 0.0; };
+        });
+
+    AtomicStore store;
+    auto downstream = std::make_shared<DownstreamStub>();
+    AtomicAccessor compiled("SYM", "tst.good", &store, downstream);
+    AtomicAccessor fallback("SYM", "tst.other", &store, downstream);
+    for (int i = 0; i < 3; ++i) {
+        compiled.onValue({"SYM", 0});
+        fallback.onValue({"SYM", 0});
+    }
+    AtomicProviderRegistry::unregisterNamespace("tst");
+
+    EXPECT_EQ(compiles, 2);
+    EXPECT_EQ(resolves, 3);                 // only the uncompilable key
+    ASSERT_EQ(downstream->received.size(), 6u);
+    EXPECT_DOUBLE_EQ(std::get<double>(downstream->received[0].value), 7.0);
+    EXPECT_DOUBLE_EQ(std::get<double>(downstream->received[1].value), -1.0);
+}
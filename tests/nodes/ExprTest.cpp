@@ -0,0 +1,232 @@
+// Tests for the multi-input Expr join node and the ExprProgram compiler
+// behind it.
+
+#include "gma/nodes/Expr.hpp"
+#include "gma/nodes/AtomicAccessor.hpp"
+#include "gma/rt/Clock.hpp"
+#include "gma/util/ExprProgram.hpp"
+#include "gma/AtomicStore.hpp"
+#include "gma/StreamValue.hpp"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace gma;
+using gma::util::ExprProgram;
+
+namespace {
+
+class Collector : public INode {
+public:
+    std::mutex mx;
+    std::vector<StreamValue> received;
+    void onValue(const StreamValue& sv) override {
+        std::lock_guard<std::mutex> lk(mx);
+        received.push_back(sv);
+    }
+    void shutdown() noexcept override {}
+};
+
+double evalWith(const std::string& src,
+                const std::vector<std::string>& names,
+                const std::vector<double>& slots) {
+    auto p = ExprProgram::compile(src, names);
+    std::vector<double> stack(p.stackDepth() + 1);
+    return p.eval(slots.data(), stack.data());
+}
+
+std::shared_ptr<Expr> makeExpr(const std::string& src,
+                               const std::vector<std::string>& names,
+                               Expr::JoinMode mode,
+                               std::shared_ptr<INode> ds,
+                               std::chrono::milliseconds tol = std::chrono::milliseconds(0),
+                               rt::Clock* clock = nullptr) {
+    return std::make_shared<Expr>("OUT", ExprProgram::compile(src, names),
+                                  names.size(), mode, tol, std::move(ds), clock);
+}
+
+} // namespace
+
+// ---- ExprProgram ----
+
+TEST(ExprProgramTest, PrecedenceAndAssociativity) {
+    EXPECT_DOUBLE_EQ(evalWith("1 + 2 * 3", {}, {}), 7.0);
+    EXPECT_DOUBLE_EQ(evalWith("(1 + 2) * 3", {}, {}), 9.0);
+    EXPECT_DOUBLE_EQ(evalWith("10 - 4 - 3", {}, {}), 3.0);
+    EXPECT_DOUBLE_EQ(evalWith("2 ^ 3 ^ 2", {}, {}), 512.0);
+    EXPECT_DOUBLE_EQ(evalWith("-2 ^ 2", {}, {}), -4.0);
+    EXPECT_DOUBLE_EQ(evalWith("1.5e2 / 3", {}, {}), 50.0);
+}
+
+TEST(ExprProgramTest, NamedSlotsAndFunctions) {
+    const std::vector<std::string> n{"bid", "ask", "mid"};
+    EXPECT_DOUBLE_EQ(evalWith("(ask - bid) / mid", n, {99.0, 101.0, 100.0}), 0.02);
+    EXPECT_DOUBLE_EQ(evalWith("max(bid, ask) - min(bid, ask)", n, {99.0, 101.0, 0.0}), 2.0);
+    EXPECT_DOUBLE_EQ(evalWith("abs(bid - ask)", n, {99.0, 101.0, 0.0}), 2.0);
+    EXPECT_DOUBLE_EQ(evalWith("sqrt(pow(mid, 2))", n, {0.0, 0.0, 7.0}), 7.0);
+}
+
+TEST(ExprProgramTest, GuardsMatchBuiltins) {
+    const std::vector<std::string> n{"x"};
+    EXPECT_DOUBLE_EQ(evalWith("1 / x", n, {0.0}), 0.0);
+    EXPECT_DOUBLE_EQ(evalWith("log(x)", n, {-1.0}), 0.0);
+    EXPECT_DOUBLE_EQ(evalWith("sqrt(x)", n, {-9.0}), 3.0);
+}
+
+TEST(ExprProgramTest, FoldsConstants) {
+    auto p = ExprProgram::compile("x * (2 + 3) - -1", {"x"});
+    // x, 5, *, 1, - after folding
+    EXPECT_EQ(p.size(), 5u);
+    EXPECT_TRUE(p.usesSlot(0));
+    auto k = ExprProgram::compile("2 * 3 + sqrt(16)", {"x"});
+    EXPECT_EQ(k.size(), 1u);
+    EXPECT_FALSE(k.usesSlot(0));
+}
+
+TEST(ExprProgramTest, RejectsBadSource) {
+    const std::vector<std::string> n{"a", "b"};
+    EXPECT_THROW(ExprProgram::compile("a + c", n), std::runtime_error);
+    EXPECT_THROW(ExprProgram::compile("a +", n), std::runtime_error);
+    EXPECT_THROW(ExprProgram::compile("(a + b", n), std::runtime_error);
+    EXPECT_THROW(ExprProgram::compile("a b", n), std::runtime_error);
+    EXPECT_THROW(ExprProgram::compile("foo(a)", n), std::runtime_error);
+    EXPECT_THROW(ExprProgram::compile("max(a)", n), std::runtime_error);
+    EXPECT_THROW(ExprProgram::compile("1.2.3", n), std::runtime_error);
+    EXPECT_THROW(ExprProgram::compile(std::string(2000, '1'), n), std::runtime_error);
+
+    try {
+        ExprProgram::compile("a + $", n);
+        FAIL() << "expected throw";
+    } catch (const std::runtime_error& ex) {
+        EXPECT_NE(std::string(ex.what()).find("column 5"), std::string::npos) << ex.what();
+    }
+}
+
+// ---- Expr node ----
+
+TEST(ExprTest, LatestWaitsForEveryInputThenEmitsOnEachPush) {
+    auto out = std::make_shared<Collector>();
+    auto e = makeExpr("a - b", {"a", "b"}, Expr::JoinMode::Latest, out);
+    auto a = e->inputSink(0, false);
+    auto b = e->inputSink(1, false);
+
+    a->onValue({"X", 10.0});
+    EXPECT_TRUE(out->received.empty());
+    b->onValue({"Y", 4});
+    ASSERT_EQ(out->received.size(), 1u);
+    EXPECT_EQ(out->received[0].symbol, "OUT");
+    EXPECT_DOUBLE_EQ(std::get<double>(out->received[0].value), 6.0);
+
+    a->onValue({"X", 11.0});
+    ASSERT_EQ(out->received.size(), 2u);
+    EXPECT_DOUBLE_EQ(std::get<double>(out->received[1].value), 7.0);
+}
+
+TEST(ExprTest, AlignedRequiresFreshValueOnEveryInput) {
+    auto out = std::make_shared<Collector>();
+    auto e = makeExpr("a + b", {"a", "b"}, Expr::JoinMode::Aligned, out);
+    auto a = e->inputSink(0, false);
+    auto b = e->inputSink(1, false);
+
+    a->onValue({"X", 1.0});
+    b->onValue({"X", 2.0});
+    ASSERT_EQ(out->received.size(), 1u);
+
+    // Only `a` refreshes — no emit until `b` does too.
+    a->onValue({"X", 5.0});
+    a->onValue({"X", 6.0});
+    EXPECT_EQ(out->received.size(), 1u);
+    b->onValue({"X", 1.0});
+    ASSERT_EQ(out->received.size(), 2u);
+    EXPECT_DOUBLE_EQ(std::get<double>(out->received[1].value), 7.0);
+}
+
+TEST(ExprTest, AlignedToleranceDiscardsStaleSide) {
+    auto out = std::make_shared<Collector>();
+    auto e = makeExpr("a + b", {"a", "b"}, Expr::JoinMode::Aligned, out,
+                      std::chrono::milliseconds(20));
+    auto a = e->inputSink(0, false);
+    auto b = e->inputSink(1, false);
+
+    a->onValue({"X", 1.0});
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    b->onValue({"X", 2.0});
+    EXPECT_TRUE(out->received.empty());
+
+    // `a` was discarded as stale; a fresh `a` inside the window completes.
+    a->onValue({"X", 3.0});
+    ASSERT_EQ(out->received.size(), 1u);
+    EXPECT_DOUBLE_EQ(std::get<double>(out->received[0].value), 5.0);
+}
+
+TEST(ExprTest, AlignedToleranceFollowsTheEngineClock) {
+    rt::SimulatedClock clock;
+    auto out = std::make_shared<Collector>();
+    auto e = makeExpr("a + b", {"a", "b"}, Expr::JoinMode::Aligned, out,
+                      std::chrono::milliseconds(20), &clock);
+    auto a = e->inputSink(0, false);
+    auto b = e->inputSink(1, false);
+
+    // No wall time passes, but the simulated clock moves past the window.
+    a->onValue({"X", 1.0});
+    clock.advanceBy(std::chrono::milliseconds(60));
+    b->onValue({"X", 2.0});
+    EXPECT_TRUE(out->received.empty());
+
+    clock.advanceBy(std::chrono::milliseconds(20));
+    a->onValue({"X", 3.0});
+    ASSERT_EQ(out->received.size(), 1u);
+    EXPECT_DOUBLE_EQ(std::get<double>(out->received[0].value), 5.0);
+}
+
+TEST(ExprTest, PullInputsRefreshOncePerUpstreamTick) {
+    AtomicStore store;
+    store.set("S", "bid", 99.0);
+    store.set("S", "ask", 101.0);
+
+    auto out = std::make_shared<Collector>();
+    auto e = makeExpr("(ask - bid) / 2", {"bid", "ask"}, Expr::JoinMode::Latest, out);
+    e->attachInput(0, std::make_shared<AtomicAccessor>("S", "bid", &store, e->inputSink(0, true)));
+    e->attachInput(1, std::make_shared<AtomicAccessor>("S", "ask", &store, e->inputSink(1, true)));
+
+    e->onValue({"S", 0.0});
+    ASSERT_EQ(out->received.size(), 1u);
+    EXPECT_DOUBLE_EQ(std::get<double>(out->received[0].value), 1.0);
+
+    store.set("S", "ask", 103.0);
+    e->onValue({"S", 0.0});
+    ASSERT_EQ(out->received.size(), 2u);
+    EXPECT_DOUBLE_EQ(std::get<double>(out->received[1].value), 2.0);
+}
+
+TEST(ExprTest, NonNumericInputIgnored) {
+    auto out = std::make_shared<Collector>();
+    auto e = makeExpr("a", {"a"}, Expr::JoinMode::Latest, out);
+    auto a = e->inputSink(0, false);
+    a->onValue({"X", std::string("nope")});
+    EXPECT_TRUE(out->received.empty());
+    a->onValue({"X", true});
+    ASSERT_EQ(out->received.size(), 1u);
+    EXPECT_DOUBLE_EQ(std::get<double>(out->received[0].value), 1.0);
+}
+
+TEST(ExprTest, ShutdownStopsEmitsAndReleasesInputs) {
+    auto out = std::make_shared<Collector>();
+    auto e = makeExpr("a", {"a"}, Expr::JoinMode::Latest, out);
+    auto a = e->inputSink(0, false);
+    e->shutdown();
+    a->onValue({"X", 1.0});
+    EXPECT_TRUE(out->received.empty());
+}
+
+TEST(ExprTest, RejectsBadInputCount) {
+    auto out = std::make_shared<Collector>();
+    EXPECT_THROW(Expr("OUT", ExprProgram::compile("1", {}), 0,
+                      Expr::JoinMode::Latest, std::chrono::milliseconds(0), out),
+                 std::invalid_argument);
+}
@@ -1,5 +1,6 @@
 #include "gma/nodes/Listener.hpp"
 #include "gma/Dispatcher.hpp"
+#include "gma/rt/CreditGate.hpp"
 #include "gma/rt/ThreadPool.hpp"
 #include "gma/AtomicStore.hpp"
 #include "gma/StreamValue.hpp"
@@ -9,6 +10,8 @@
 #include <vector>
 #include <atomic>
 #include <mutex>
+#include <stdexcept>
+#include <thread>
 
 using namespace gma;
 using namespace gma::nodes;
@@ -162,6 +165,66 @@ TEST(ListenerTest, RejectsObSpread) {
     pool.shutdown();
 }
 
+TEST(ListenerTest, AcceptsObKeyServedByObserver) {
+    rt::ThreadPool pool(1);
+    AtomicStore store;
+    Dispatcher dispatcher(&pool, &store);
+
+    std::vector<std::pair<std::string, bool>> seen;
+    dispatcher.observeSubscriptions("ob.",
+        [&](const std::string&, const std::string& field, bool on) { seen.emplace_back(field, on); },
+        [](const std::string& field) { return field != "ob.nonsense"; });
+
+    auto stub = std::make_shared<DownstreamStub>();
+    auto res = Listener::Create("NEXO", "ob.spread", stub, &pool, &dispatcher);
+    ASSERT_TRUE(res.has_value());
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(seen[0], std::make_pair(std::string("ob.spread"), true));
+
+    auto bad = Listener::Create("NEXO", "ob.nonsense", stub, &pool, &dispatcher);
+    EXPECT_FALSE(bad.has_value());
+
+    (*res)->shutdown();
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_EQ(seen[1], std::make_pair(std::string("ob.spread"), false));
+    pool.shutdown();
+}
+
+TEST(ListenerTest, ObserverSeesFirstAndLastListenerInOrder) {
+    AtomicStore store;
+    Dispatcher dispatcher(nullptr, &store);
+
+    // Each callback must flip the state; a reordered pair would repeat one.
+    std::mutex mx;
+    bool on = false;
+    int  flips = 0, repeats = 0;
+    dispatcher.observeSubscriptions("ob.",
+        [&](const std::string&, const std::string&, bool subscribed) {
+            std::this_thread::yield();
+            std::lock_guard<std::mutex> lk(mx);
+            if (subscribed == on) ++repeats;
+            on = subscribed;
+            ++flips;
+        });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            auto node = std::make_shared<DownstreamStub>();
+            for (int i = 0; i < 500; ++i) {
+                dispatcher.registerListener("NEXO", "ob.spread", node);
+                dispatcher.unregisterListener("NEXO", "ob.spread", node);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    std::lock_guard<std::mutex> lk(mx);
+    EXPECT_EQ(repeats, 0);
+    EXPECT_GT(flips, 0);
+    EXPECT_FALSE(on);
+}
+
 TEST(ListenerTest, AcceptsBareKeyAtFactory) {
     rt::ThreadPool pool(1);
     AtomicStore store;
@@ -194,3 +257,108 @@ TEST(ListenerTest, FactoryDoesNotMatchObesityFalsePositive) {
     EXPECT_TRUE(res.has_value());
     pool.shutdown();
 }
+
+// ---- Credit-based backpressure ----
+
+namespace {
+
+// Stands in for Responder + ClientSession: every value becomes a "frame"
+// holding one credit until the test releases it (i.e. the socket drains).
+class FrameSinkStub : public INode {
+public:
+    explicit FrameSinkStub(std::shared_ptr<rt::CreditGate> g) : gate(std::move(g)) {}
+    std::vector<double> values;
+    void onValue(const StreamValue& sv) override {
+        gate->acquire();
+        values.push_back(std::get<double>(sv.value));
+    }
+    void shutdown() noexcept override {}
+    std::shared_ptr<rt::CreditGate> gate;
+};
+
+} // anonymous namespace
+
+TEST(CreditGateTest, WindowBoundsTryAcquire) {
+    rt::CreditGate gate(2);
+    EXPECT_TRUE(gate.tryAcquire());
+    EXPECT_TRUE(gate.tryAcquire());
+    EXPECT_FALSE(gate.tryAcquire());
+    EXPECT_TRUE(gate.exhausted());
+    gate.acquire();                      // frames are never refused
+    EXPECT_EQ(gate.inFlight(), 3u);
+    gate.release(2);
+    EXPECT_TRUE(gate.tryAcquire());
+    EXPECT_THROW(rt::CreditGate(0), std::invalid_argument);
+}
+
+TEST(CreditGateTest, ReplenishFiresOnlyWhenWindowReopens) {
+    rt::CreditGate gate(2);
+    int fired = 0;
+    gate.onReplenish([&] { ++fired; });
+
+    gate.acquire(); gate.acquire(); gate.acquire();   // 3 in flight
+    gate.release();                                   // 2: still full
+    EXPECT_EQ(fired, 0);
+    gate.release();                                   // 1: reopened
+    EXPECT_EQ(fired, 1);
+    gate.release();                                   // 0: already open
+    EXPECT_EQ(fired, 1);
+}
+
+TEST(ListenerTest, ConflatesToLatestWhileCreditExhausted) {
+    auto gate = std::make_shared<rt::CreditGate>(2);
+    auto sink = std::make_shared<FrameSinkStub>(gate);
+    auto listener = std::make_shared<Listener>("SYM", "field", sink,
+                                               nullptr, nullptr, gate);
+    listener->start();
+
+    listener->onValue(StreamValue{"SYM", 1.0});
+    listener->onValue(StreamValue{"SYM", 2.0});      // window now full of frames
+    listener->onValue(StreamValue{"SYM", 3.0});
+    listener->onValue(StreamValue{"SYM", 4.0});
+    listener->onValue(StreamValue{"SYM", 5.0});
+    ASSERT_EQ(sink->values.size(), 2u);
+
+    gate->release();                                 // one frame written
+    ASSERT_EQ(sink->values.size(), 3u);
+    EXPECT_DOUBLE_EQ(sink->values[2], 5.0);          // only the latest survives
+
+    gate->release(2);                                // nothing left pending
+    EXPECT_EQ(sink->values.size(), 3u);
+}
+
+TEST(ListenerTest, DropsWhileCreditExhaustedInDropMode) {
+    auto gate = std::make_shared<rt::CreditGate>(1, rt::CreditGate::Overflow::Drop);
+    auto sink = std::make_shared<FrameSinkStub>(gate);
+    auto listener = std::make_shared<Listener>("SYM", "field", sink,
+                                               nullptr, nullptr, gate);
+    listener->start();
+
+    listener->onValue(StreamValue{"SYM", 1.0});
+    listener->onValue(StreamValue{"SYM", 2.0});
+    gate->release();
+    EXPECT_EQ(sink->values.size(), 1u);
+
+    listener->onValue(StreamValue{"SYM", 3.0});
+    ASSERT_EQ(sink->values.size(), 2u);
+    EXPECT_DOUBLE_EQ(sink->values[1], 3.0);
+}
+
+TEST(ListenerTest, PooledTasksHoldCreditUntilTheyRun) {
+    rt::ThreadPool pool(1);
+    auto gate = std::make_shared<rt::CreditGate>(4);
+    auto stub = std::make_shared<DownstreamStub>();
+    auto listener = std::make_shared<Listener>("SYM", "field", stub,
+                                               &pool, nullptr, gate);
+    listener->start();
+
+    for (int i = 0; i < 100; ++i)
+        listener->onValue(StreamValue{"SYM", static_cast<double>(i)});
+    pool.drain();
+
+    EXPECT_EQ(gate->inFlight(), 0u);
+    ASSERT_GE(stub->safeSize(), 1u);
+    // Whatever was conflated, the final value is never lost.
+    EXPECT_DOUBLE_EQ(std::get<double>(stub->received.back().value), 99.0);
+    pool.shutdown();
+}
@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 #include <cmath>
 #include <limits>
+#include <cstdint>
 
 using namespace gma::ob;
 
@@ -74,3 +75,132 @@ TEST(ObProviderTest, GetWithNullSourceReturnsNaN) {
     double v = p.get("SYM", "ob.spread");
     EXPECT_TRUE(std::isnan(v));
 }
+
+// Source whose version is set by the test; counts captures and records depth.
+struct VersionedSource {
+    uint64_t version = 1;
+    int captures = 0;
+    size_t lastDepth = 0;
+    std::shared_ptr<FunctionalSnapshotSource> make() {
+        return std::make_shared<FunctionalSnapshotSource>(
+            [this](const std::string&, size_t n, Mode, std::optional<std::pair<double,double>>) {
+                ++captures; lastDepth = n;
+                auto s = makeProviderSnap();
+                s.meta.seq = version;
+                return s;
+            },
+            [](const std::string&) { return 0.01; },
+            [this](const std::string&) { return version; });
+    }
+};
+
+TEST(ObProviderTest, CompiledKeysShareOneCapturePerVersion) {
+    VersionedSource vs;
+    Provider p(vs.make(), 5, 5);
+    auto spread = p.compile("ob.spread");
+    auto cum    = p.compile("ob.cum.bid.levels.3.size");
+    auto lvl    = p.compile("ob.level.ask.2.price");
+    ASSERT_TRUE(spread && cum && lvl);
+    EXPECT_FALSE(p.compile("ob.garbage.nonsense").has_value());
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_DOUBLE_EQ(p.eval("SYM", *spread), 1.0);
+        EXPECT_DOUBLE_EQ(p.eval("SYM", *cum), 60.0);
+        EXPECT_DOUBLE_EQ(p.eval("SYM", *lvl), 102.0);
+    }
+    EXPECT_EQ(vs.captures, 1);
+    EXPECT_EQ(p.captures(), 1u);
+
+    vs.version = 2;                                   // book moved
+    EXPECT_DOUBLE_EQ(p.eval("SYM", *lvl), 102.0);
+    EXPECT_DOUBLE_EQ(p.eval("SYM", *spread), 1.0);
+    EXPECT_EQ(vs.captures, 2);
+    EXPECT_DOUBLE_EQ(p.get("SYM", "ob.meta.seq"), 2.0);
+    EXPECT_EQ(vs.captures, 2);
+
+    p.eval("OTHER", *spread);                         // cached per symbol
+    EXPECT_EQ(vs.captures, 3);
+}
+
+TEST(ObProviderTest, DeeperKeyRecapturesThenServesShallowerOnes) {
+    VersionedSource vs;
+    Provider p(vs.make(), 5, 5);
+    p.get("SYM", "ob.spread");
+    EXPECT_EQ(vs.lastDepth, 5u);
+    p.get("SYM", "ob.level.bid.20.size");             // needs 20 levels
+    EXPECT_EQ(vs.captures, 2);
+    EXPECT_EQ(vs.lastDepth, 20u);
+    p.get("SYM", "ob.level.bid.7.size");
+    p.get("SYM", "ob.spread");
+    EXPECT_EQ(vs.captures, 2);
+    p.get("SYM", "ob.range.bid.price.98-99.sum.size"); // price-addressed: full book
+    EXPECT_EQ(vs.lastDepth, SIZE_MAX);
+    EXPECT_DOUBLE_EQ(p.get("SYM", "ob.range.bid.price.98-99.sum.size"), 50.0);
+    EXPECT_EQ(vs.captures, 3);
+}
+
+TEST(ObProviderTest, SourceWithoutVersionIsNeverCached) {
+    int captures = 0;
+    auto src = std::make_shared<FunctionalSnapshotSource>(
+        [&](const std::string&, size_t, Mode, std::optional<std::pair<double,double>>) {
+            ++captures; return makeProviderSnap();
+        },
+        [](const std::string&) { return 0.01; });
+    Provider p(src, 5, 5);
+    p.get("SYM", "ob.spread");
+    p.get("SYM", "ob.spread");
+    EXPECT_EQ(captures, 2);
+}
+
+// Slice totals computed from the fixed snapshot, the way a book index
+// would report them.
+static SideSums sliceOf(const Ladder& L, size_t first, size_t last, double p1, double p2, bool byPrice) {
+    SideSums s; s.orders = 0;
+    for (size_t i = 0; i < L.levels.size(); ++i) {
+        const auto& l = L.levels[i];
+        if (byPrice ? (l.price < p1 || l.price > p2) : (i + 1 < first || i + 1 > last)) continue;
+        s.levels += 1; s.size += l.size; s.orders += l.orders; s.price += l.price; s.notional += l.notional;
+    }
+    return s;
+}
+
+TEST(ObProviderTest, SliceKeysReadSourceTotalsWithoutCapture) {
+    int captures = 0;
+    auto side = [](Side s) -> const Ladder& {
+        static const Snapshot snap = makeProviderSnap();
+        return s == Side::Bid ? snap.bids : snap.asks;
+    };
+    auto src = std::make_shared<FunctionalSnapshotSource>(
+        [&](const std::string&, size_t, Mode, std::optional<std::pair<double,double>>) {
+            ++captures; return makeProviderSnap();
+        },
+        [](const std::string&) { return 0.01; },
+        FunctionalSnapshotSource::VersionFn{},
+        [&](const std::string&, Side s, Range r) {
+            return sliceOf(side(s), static_cast<size_t>(r.a), static_cast<size_t>(r.b), 0, 0, false);
+        },
+        [&](const std::string&, Side s, double p1, double p2) {
+            return sliceOf(side(s), 0, 0, p1, p2, true);
+        });
+    Provider summed(src, 5, 5);
+    Provider captured(makeSource(), 5, 5);
+
+    for (const char* key : {"ob.cum.bid.levels.2.size", "ob.cum.ask.levels.9.notional",
+                            "ob.range.bid.levels.2-3.avg.size", "ob.range.ask.levels.1-2.sum.orders",
+                            "ob.range.ask.levels.1-3.count", "ob.range.bid.price.98-99.sum.size",
+                            "ob.range.ask.price.101-102.count", "ob.at.bid.99.size",
+                            "ob.vwap.ask.levels.1-2", "ob.vwap.bid.price.98-100",
+                            "ob.imbalance.levels.1-2", "ob.imbalance.price.99-102"}) {
+        const double want = captured.get("SYM", key);
+        const auto got = summed.evalFromSums("SYM", *parseObKey(key));
+        ASSERT_TRUE(got.has_value()) << key;
+        EXPECT_DOUBLE_EQ(*got, want) << key;
+    }
+    EXPECT_EQ(captures, 0);
+    EXPECT_TRUE(std::isnan(summed.get("SYM", "ob.at.bid.97.size")));
+
+    // Keys the totals cannot answer still capture.
+    EXPECT_FALSE(summed.evalFromSums("SYM", *parseObKey("ob.range.bid.levels.1-3.max.size")).has_value());
+    EXPECT_DOUBLE_EQ(summed.get("SYM", "ob.best.bid.price"), 100.0);
+    EXPECT_EQ(captures, 1);
+}
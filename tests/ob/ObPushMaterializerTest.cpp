@@ -0,0 +1,176 @@
+#include "gma/ob/ObPushMaterializer.hpp"
+#include "gma/ob/FunctionalSnapshotSource.hpp"
+#include <gtest/gtest.h>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace gma;
+using namespace gma::ob;
+
+namespace {
+
+// Book-backed provider wired the way the market connector wires it.
+struct PushFixture {
+    std::shared_ptr<OrderBookManager> books = std::make_shared<OrderBookManager>();
+    std::shared_ptr<Provider> provider;
+    std::shared_ptr<PushMaterializer> push;
+
+    std::mutex mx;
+    std::vector<std::pair<std::string, double>> pushed;
+
+    PushFixture() {
+        auto mgr = books;
+        auto src = std::make_shared<FunctionalSnapshotSource>(
+            [mgr](const std::string& symbol, size_t n, Mode, std::optional<std::pair<double,double>>) {
+                Snapshot snap;
+                auto ds = mgr->buildSnapshot(symbol, n);
+                const double tick = mgr->getTickSize(symbol);
+                const double nan = std::numeric_limits<double>::quiet_NaN();
+                for (const auto& [px, sz] : ds.bids)
+                    snap.bids.levels.push_back({px.ticks * tick, double(sz), nan, px.ticks * tick * sz});
+                for (const auto& [px, sz] : ds.asks)
+                    snap.asks.levels.push_back({px.ticks * tick, double(sz), nan, px.ticks * tick * sz});
+                snap.meta.seq = ds.seq;
+                snap.meta.bidLevels = snap.bids.levels.size();
+                snap.meta.askLevels = snap.asks.levels.size();
+                return snap;
+            },
+            [mgr](const std::string& symbol) { return mgr->getTickSize(symbol); },
+            [mgr](const std::string& symbol) { return mgr->bookVersion(symbol); });
+        provider = std::make_shared<Provider>(src, 10, 10);
+        push = PushMaterializer::create(books, provider,
+            [this](const std::string&, const std::string& key, double v) {
+                std::lock_guard<std::mutex> lk(mx);
+                pushed.emplace_back(key, v);
+            });
+
+        books->setTickSize("S", 1.0);
+        books->onAdd("S", 1, gma::Side::Bid, 100, 10, 0);
+        books->onAdd("S", 2, gma::Side::Bid,  99, 20, 0);
+        books->onAdd("S", 3, gma::Side::Bid,  98, 30, 0);
+        books->onAdd("S", 4, gma::Side::Bid,  90,  5, 0);
+        books->onAdd("S", 5, gma::Side::Ask, 101, 15, 0);
+    }
+
+    std::vector<std::pair<std::string, double>> take() {
+        std::lock_guard<std::mutex> lk(mx);
+        auto out = std::move(pushed);
+        pushed.clear();
+        return out;
+    }
+};
+
+} // namespace
+
+TEST(ObPushMaterializerTest, PushesCurrentValueOnSubscribe) {
+    PushFixture f;
+    f.push->subscribe("S", "ob.best.bid.size");
+    auto got = f.take();
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_EQ(got[0].first, "ob.best.bid.size");
+    EXPECT_DOUBLE_EQ(got[0].second, 10.0);
+}
+
+TEST(ObPushMaterializerTest, DeepChangeSkipsTopOfBookKey) {
+    PushFixture f;
+    f.push->subscribe("S", "ob.best.bid.size");
+    f.take();
+    const auto evals = f.push->evaluations();
+
+    EXPECT_TRUE(f.books->onUpdate("S", 4, FeedScope{}, std::nullopt, 7));
+    EXPECT_TRUE(f.take().empty());
+    EXPECT_EQ(f.push->evaluations(), evals);
+
+    EXPECT_TRUE(f.books->onUpdate("S", 1, FeedScope{}, std::nullopt, 12));
+    auto got = f.take();
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_DOUBLE_EQ(got[0].second, 12.0);
+}
+
+TEST(ObPushMaterializerTest, UnchangedValueIsNotPushed) {
+    PushFixture f;
+    f.push->subscribe("S", "ob.spread");
+    f.take();
+    // Size at the touch moves; the spread does not.
+    EXPECT_TRUE(f.books->onUpdate("S", 1, FeedScope{}, std::nullopt, 11));
+    EXPECT_TRUE(f.take().empty());
+    EXPECT_TRUE(f.books->onDelete("S", 1, FeedScope{}));
+    auto got = f.take();
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_DOUBLE_EQ(got[0].second, 2.0);               // 101 - 99
+}
+
+TEST(ObPushMaterializerTest, BandKeyOnlyReactsInsideItsBand) {
+    PushFixture f;
+    f.push->subscribe("S", "ob.at.bid.98.size");
+    ASSERT_EQ(f.take().size(), 1u);
+    const auto evals = f.push->evaluations();
+
+    EXPECT_TRUE(f.books->onUpdate("S", 1, FeedScope{}, std::nullopt, 40));   // 100: outside
+    EXPECT_TRUE(f.take().empty());
+    EXPECT_EQ(f.push->evaluations(), evals);
+
+    EXPECT_TRUE(f.books->onAdd("S", 6, gma::Side::Bid, 98, 5, 0));
+    auto got = f.take();
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_DOUBLE_EQ(got[0].second, 35.0);
+}
+
+TEST(ObPushMaterializerTest, UnsubscribeAndStopEndPushes) {
+    PushFixture f;
+    f.push->subscribe("S", "ob.best.bid.size");
+    f.push->subscribe("S", "ob.best.ask.size");
+    EXPECT_EQ(f.take().size(), 2u);
+
+    f.push->unsubscribe("S", "ob.best.bid.size");
+    EXPECT_TRUE(f.books->onUpdate("S", 1, FeedScope{}, std::nullopt, 11));
+    EXPECT_TRUE(f.take().empty());
+
+    f.push->stop();
+    EXPECT_TRUE(f.books->onUpdate("S", 5, FeedScope{}, std::nullopt, 16));
+    EXPECT_TRUE(f.take().empty());
+    f.push->subscribe("S", "ob.best.ask.size");
+    EXPECT_TRUE(f.take().empty());
+}
+
+TEST(ObPushMaterializerTest, IgnoresUnparseableKeys) {
+    PushFixture f;
+    f.push->subscribe("S", "ob.nonsense");
+    EXPECT_TRUE(f.take().empty());
+}
+
+TEST(ObPushMaterializerTest, SubscribeBeforeFirstBookMessagePushes) {
+    PushFixture f;
+    f.push->subscribe("NEW", "ob.best.bid.price");
+    EXPECT_TRUE(f.take().empty());
+    EXPECT_EQ(f.push->pendingSymbols(), 1u);
+
+    f.books->onAdd("NEW", 1, gma::Side::Bid, 10, 1, 0);
+    EXPECT_EQ(f.push->pendingSymbols(), 0u);
+    auto got = f.take();
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_EQ(got[0].first, "ob.best.bid.price");
+    EXPECT_NEAR(got[0].second, 10.0, 1e-9);
+}
+
+TEST(ObPushMaterializerTest, PendingSymbolsAreCapped) {
+    PushFixture f;
+    for (std::size_t i = 0; i < PushMaterializer::kMaxPendingSymbols + 5; ++i)
+        f.push->subscribe("P" + std::to_string(i), "ob.spread");
+    EXPECT_EQ(f.push->pendingSymbols(), PushMaterializer::kMaxPendingSymbols);
+
+    // Unsubscribing the last key frees the slot; a dropped symbol that
+    // appears later pushes nothing.
+    f.push->unsubscribe("P0", "ob.spread");
+    EXPECT_EQ(f.push->pendingSymbols(), PushMaterializer::kMaxPendingSymbols - 1);
+    const std::string dropped = "P" + std::to_string(PushMaterializer::kMaxPendingSymbols);
+    f.books->setTickSize(dropped, 1.0);
+    f.books->onAdd(dropped, 1, gma::Side::Bid, 10, 1, 0);
+    f.books->onAdd(dropped, 2, gma::Side::Ask, 11, 1, 0);
+    EXPECT_TRUE(f.take().empty());
+
+    f.push->stop();
+    EXPECT_EQ(f.push->pendingSymbols(), 0u);
+}
@@ -0,0 +1,166 @@
+// Tests for the static tree cost model and AdmissionController budgets.
+
+#include "gma/CostModel.hpp"
+#include "gma/server/Admission.hpp"
+#include "gma/util/Config.hpp"
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+using gma::server::AdmissionController;
+using gma::tree::TreeCost;
+
+namespace {
+
+TreeCost costOf(const char* json) {
+    rapidjson::Document d;
+    d.Parse(json);
+    EXPECT_FALSE(d.HasParseError()) << json;
+    return gma::tree::estimateRequestCost(d);
+}
+
+TreeCost cost(double tickWork, std::uint64_t bytes, std::uint32_t timers) {
+    TreeCost c;
+    c.tickWork   = tickWork;
+    c.stateBytes = bytes;
+    c.timers     = timers;
+    return c;
+}
+
+} // namespace
+
+// ---- cost model ----
+
+TEST(CostModelTest, BareRequestIsOneListener) {
+    auto c = costOf(R"({"streamKey":"S","field":"f"})");
+    EXPECT_DOUBLE_EQ(c.tickWork, 1.0);
+    EXPECT_EQ(c.timers, 0u);
+    EXPECT_EQ(c.fanout, 1u);
+    EXPECT_GT(c.stateBytes, 0u);
+}
+
+TEST(CostModelTest, SortingReducersCostMoreThanScalarOnes) {
+    auto mean   = costOf(R"({"streamKey":"S","field":"f","pipeline":[{"type":"Worker","fn":"mean"}]})");
+    auto median = costOf(R"({"streamKey":"S","field":"f","pipeline":[{"type":"Worker","fn":"median"}]})");
+    EXPECT_GT(median.cpu(), mean.cpu());
+}
+
+TEST(CostModelTest, TimersCountAndChildWorkMovesToTimerRate) {
+    auto c = costOf(R"({"streamKey":"S","field":"f",
+                       "node":{"type":"BucketTime","ms":100,
+                               "child":{"type":"Worker","fn":"median"}}})");
+    EXPECT_EQ(c.timers, 1u);
+    EXPECT_DOUBLE_EQ(c.tickWork, 1.0);          // only the request's Listener
+    EXPECT_DOUBLE_EQ(c.timerWork, (8.0 + 1.0) * 10.0);
+}
+
+TEST(CostModelTest, GroupSplitMultipliesChildStateAndTimers) {
+    auto one   = costOf(R"({"streamKey":"S","field":"f","node":{"type":"TumblingWindow","ms":1000}})");
+    auto split = costOf(R"({"streamKey":"S","field":"f",
+                           "node":{"type":"GroupSplit","child":{"type":"TumblingWindow","ms":1000}}})");
+    EXPECT_EQ(split.fanout, TreeCost::SPLIT_FANOUT_ESTIMATE);
+    EXPECT_EQ(split.timers, TreeCost::SPLIT_FANOUT_ESTIMATE);
+    EXPECT_GT(split.stateBytes, one.stateBytes * (TreeCost::SPLIT_FANOUT_ESTIMATE / 2));
+}
+
+TEST(CostModelTest, UnknownAndMalformedSpecsDoNotThrow) {
+    EXPECT_NO_THROW(costOf(R"({"streamKey":"S","field":"f","node":{"type":"SomeConnectorNode"}})"));
+    EXPECT_NO_THROW(costOf(R"({"streamKey":"S","field":"f","pipeline":[1,"x",{"type":3}]})"));
+}
+
+// ---- admission ----
+
+TEST(AdmissionControllerTest, UnlimitedBudgetsAdmitEverything) {
+    AdmissionController adm({}, {});
+    auto r = adm.admit(1, cost(1e6, 1ull << 40, 1000));
+    EXPECT_EQ(r.decision, AdmissionController::Decision::Admit);
+    EXPECT_EQ(adm.used().timers, 1000u);
+}
+
+TEST(AdmissionControllerTest, SessionBudgetIsPerSession) {
+    AdmissionController::Budget session;
+    session.timers = 2;
+    AdmissionController adm({}, session);
+
+    EXPECT_EQ(adm.admit(1, cost(1, 0, 2)).decision, AdmissionController::Decision::Admit);
+    auto r = adm.admit(1, cost(1, 0, 1));
+    EXPECT_EQ(r.decision, AdmissionController::Decision::Reject);
+    EXPECT_EQ(r.reason, "session timer budget exceeded");
+    EXPECT_EQ(adm.admit(2, cost(1, 0, 2)).decision, AdmissionController::Decision::Admit);
+    EXPECT_EQ(adm.used().timers, 4u);
+}
+
+TEST(AdmissionControllerTest, CpuOverrunDowngradesWhenConflatedCostFits) {
+    AdmissionController::Budget global;
+    global.cpu = 1000;
+    AdmissionController adm(global, {});
+
+    // 20 units/tick at 100 ticks/s = 2000 > 1000; a quarter of it fits.
+    auto r = adm.admit(1, cost(20, 0, 0));
+    EXPECT_EQ(r.decision, AdmissionController::Decision::Downgrade);
+    EXPECT_DOUBLE_EQ(r.charged.cpu, 2000 * AdmissionController::DOWNGRADE_CPU_FACTOR);
+    EXPECT_NE(r.reason.find("global cpu budget"), std::string::npos);
+
+    // 50 units/tick stays over budget even conflated.
+    EXPECT_EQ(adm.admit(1, cost(50, 0, 0)).decision, AdmissionController::Decision::Reject);
+}
+
+TEST(AdmissionControllerTest, MemoryOverrunIsNeverDowngraded) {
+    AdmissionController::Budget global;
+    global.stateBytes = 1024;
+    AdmissionController adm(global, {});
+    auto r = adm.admit(1, cost(0.01, 4096, 0));
+    EXPECT_EQ(r.decision, AdmissionController::Decision::Reject);
+    EXPECT_EQ(r.reason, "global memory budget exceeded");
+    EXPECT_EQ(adm.used().stateBytes, 0u);
+}
+
+TEST(AdmissionControllerTest, ReleaseReturnsTheCharge) {
+    AdmissionController::Budget global;
+    global.timers = 1;
+    AdmissionController adm(global, global);
+
+    auto r = adm.admit(7, cost(1, 100, 1));
+    ASSERT_EQ(r.decision, AdmissionController::Decision::Admit);
+    EXPECT_EQ(adm.admit(8, cost(1, 100, 1)).decision, AdmissionController::Decision::Reject);
+
+    adm.release(7, r.charged);
+    EXPECT_EQ(adm.used().timers, 0u);
+    EXPECT_EQ(adm.used().stateBytes, 0u);
+    EXPECT_EQ(adm.sessionUsed(7).timers, 0u);
+    EXPECT_EQ(adm.admit(8, cost(1, 100, 1)).decision, AdmissionController::Decision::Admit);
+}
+
+TEST(AdmissionControllerTest, ForgetDropsRoundingResidue) {
+    AdmissionController adm({}, {});
+    auto a = adm.admit(7, cost(0.001, 0, 0));   // 0.1 units/s
+    auto b = adm.admit(7, cost(0.002, 0, 0));   // 0.2 units/s
+    adm.release(7, b.charged);
+    adm.release(7, a.charged);
+    // 0.1 + 0.2 - 0.2 - 0.1 is not 0 in doubles: the entry survives.
+    EXPECT_EQ(adm.sessionCount(), 1u);
+
+    adm.forget(7);
+    EXPECT_EQ(adm.sessionCount(), 0u);
+    EXPECT_EQ(adm.used().cpu, 0.0);
+    EXPECT_EQ(adm.sessionUsed(7).cpu, 0.0);
+}
+
+TEST(AdmissionControllerTest, DefaultConfigAdmitsABaselineWorkload) {
+    const gma::util::Config cfg;
+    AdmissionController adm(
+        AdmissionController::budget(cfg.admissionCpu, cfg.admissionMemoryMB, cfg.admissionTimers),
+        AdmissionController::budget(cfg.admissionSessionCpu, cfg.admissionSessionMemoryMB,
+                                    cfg.admissionSessionTimers));
+
+    // One session: per-symbol windows split by group, plus plain pipelines.
+    const auto split = costOf(R"({"streamKey":"S","field":"lastPrice",
+        "node":{"type":"GroupSplit","child":{"type":"TumblingWindow","ms":1000,
+                "child":{"type":"Worker","fn":"median"}}}})");
+    const auto plain = costOf(R"({"streamKey":"S","field":"lastPrice",
+        "pipeline":[{"type":"Worker","fn":"mean"}]})");
+    for (int i = 0; i < 32; ++i) {
+        EXPECT_EQ(adm.admit(1, split).decision, AdmissionController::Decision::Admit) << i;
+        EXPECT_EQ(adm.admit(1, plain).decision, AdmissionController::Decision::Admit) << i;
+    }
+    EXPECT_EQ(adm.sessionUsed(1).timers, 32 * TreeCost::SPLIT_FANOUT_ESTIMATE);
+}
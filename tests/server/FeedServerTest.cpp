@@ -0,0 +1,306 @@
+// LineReader framing, TickArena reuse, and FeedServer end to end over a
+// real socket: lines split across writes, CRLF, escapes and tick payloads
+// that must outlive the read buffer.
+
+#include "gma/AtomicStore.hpp"
+#include "gma/Dispatcher.hpp"
+#include "gma/Event.hpp"
+#include "gma/engine/IEventComputer.hpp"
+#include "gma/book/OrderBookManager.hpp"
+#include "gma/market/MarketFieldMap.hpp"
+#include "gma/nodes/INode.hpp"
+#include "gma/server/FeedServer.hpp"
+#include "gma/server/LineReader.hpp"
+#include "gma/server/TickArena.hpp"
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace asio = boost::asio;
+using tcp      = asio::ip::tcp;
+
+namespace {
+
+std::vector<std::string> feed(gma::LineReader& r, const std::string& bytes) {
+  auto space = r.prepare();
+  EXPECT_GE(space.size(), bytes.size());
+  std::memcpy(space.data(), bytes.data(), bytes.size());
+  r.commit(bytes.size());
+  std::vector<std::string> lines;
+  while (auto line = r.next()) {
+    EXPECT_EQ(line->data()[line->size()], '\0');
+    lines.emplace_back(line->data(), line->size());
+  }
+  return lines;
+}
+
+// Keeps a copy of every tick the dispatcher hands on.
+class RecordingComputer : public gma::engine::IEventComputer {
+public:
+  explicit RecordingComputer(bool readsPayload = true) : readsPayload_(readsPayload) {}
+  std::string_view eventType() const override { return "tick"; }
+  bool readsPayload() const override { return readsPayload_; }
+  void compute(const gma::Event& e, gma::engine::ComputeContext&) override {
+    std::lock_guard<std::mutex> lk(mu);
+    ticks.push_back(e);
+  }
+  std::size_t count() {
+    std::lock_guard<std::mutex> lk(mu);
+    return ticks.size();
+  }
+
+  std::mutex              mu;
+  std::vector<gma::Event> ticks;
+
+private:
+  bool readsPayload_;
+};
+
+class CountingNode : public gma::INode {
+public:
+  void onValue(const gma::StreamValue&) override { ++values; }
+  void shutdown() noexcept override {}
+  std::atomic<int> values{0};
+};
+
+struct FeedHarness {
+  asio::io_context                   ioc;
+  std::unique_ptr<asio::executor_work_guard<asio::io_context::executor_type>> work;
+  gma::AtomicStore                   store;
+  std::unique_ptr<gma::Dispatcher>   dispatcher;
+  RecordingComputer*                 ticks{nullptr};   // owned by dispatcher
+  gma::OrderBookManager              books;
+  std::unique_ptr<gma::FeedServer>   server;
+  std::thread                        ioThread;
+
+  // With `fieldMap`, the server decodes plain tick lines at ingress, for a
+  // computer that does not read the payload.
+  explicit FeedHarness(const gma::market::MarketFieldMap* fieldMap = nullptr) {
+    dispatcher = std::make_unique<gma::Dispatcher>(nullptr, &store);
+    auto rc = std::make_unique<RecordingComputer>(fieldMap == nullptr);
+    ticks = rc.get();
+    dispatcher->addComputer(std::move(rc));
+    server = fieldMap
+      ? std::make_unique<gma::FeedServer>(ioc, dispatcher.get(), &books, *fieldMap, 0)
+      : std::make_unique<gma::FeedServer>(ioc, dispatcher.get(), &books, 0);
+    server->run();
+    work     = std::make_unique<asio::executor_work_guard<asio::io_context::executor_type>>(
+                 ioc.get_executor());
+    ioThread = std::thread([this] { ioc.run(); });
+  }
+
+  ~FeedHarness() {
+    try { server->stop(); } catch (...) {}
+    if (work) work.reset();
+    ioc.stop();
+    if (ioThread.joinable()) ioThread.join();
+  }
+};
+
+void send(gma::FeedServer& server, const std::string& bytes) {
+  asio::io_context cioc;
+  tcp::socket sock(cioc);
+  tcp::resolver resolver(cioc);
+  asio::connect(sock, resolver.resolve("127.0.0.1", std::to_string(server.port())));
+  asio::write(sock, asio::buffer(bytes));
+}
+
+bool waitFor(const std::function<bool()>& pred) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (pred()) return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return pred();
+}
+
+} // namespace
+
+// ---- LineReader ----
+
+TEST(LineReaderTest, FramesLinesSplitAcrossReads) {
+  gma::LineReader r(256);
+  EXPECT_EQ(feed(r, "alpha\nbe"), (std::vector<std::string>{"alpha"}));
+  EXPECT_EQ(r.pending(), 2u);
+  EXPECT_EQ(feed(r, "ta\r\n\ngam"), (std::vector<std::string>{"beta", ""}));
+  EXPECT_EQ(feed(r, "ma\n"), (std::vector<std::string>{"gamma"}));
+  EXPECT_EQ(r.pending(), 0u);
+}
+
+TEST(LineReaderTest, RewindsOnceDrainedAndCompactsPartialLines) {
+  gma::LineReader r(64);
+  // Drained: the whole buffer is free again.
+  feed(r, std::string(40, 'a') + "\n");
+  EXPECT_EQ(r.prepare().size(), 64u);
+
+  // A partial line near the end is moved down when the tail runs short.
+  feed(r, std::string(30, 'b') + "\n" + std::string(30, 'c'));
+  EXPECT_EQ(r.pending(), 30u);
+  EXPECT_EQ(r.prepare().size(), 34u);
+  EXPECT_EQ(feed(r, "cc\n"), (std::vector<std::string>{std::string(32, 'c')}));
+}
+
+TEST(LineReaderTest, FullWhenOnePartialLineFillsTheBuffer) {
+  gma::LineReader r(32);
+  feed(r, std::string(20, 'x'));
+  EXPECT_FALSE(r.full());
+  EXPECT_TRUE(feed(r, std::string(12, 'x')).empty());
+  EXPECT_TRUE(r.full());
+  EXPECT_TRUE(r.prepare().empty());
+}
+
+// ---- TickArena ----
+
+TEST(TickArenaTest, KeptPayloadsOwnTheirStringsAndRecycleInPlace) {
+  auto arena = gma::TickArena::create();
+  const auto* first = arena.get();
+  std::string line = R"({"symbol":"AAPL","lastPrice":1.5})";
+  ASSERT_FALSE(arena->parse(line).HasParseError());
+  auto payload = arena->keep();
+  std::fill(line.begin(), line.end(), 'x');          // the read buffer is reused
+  EXPECT_STREQ((*payload)["symbol"].GetString(), "AAPL");
+  EXPECT_DOUBLE_EQ((*payload)["lastPrice"].GetDouble(), 1.5);
+  EXPECT_EQ(arena->kept(), 1u);
+
+  payload.reset();
+  gma::TickArena::recycle(arena);
+  EXPECT_EQ(arena.get(), first);
+  EXPECT_EQ(arena->kept(), 0u);
+}
+
+TEST(TickArenaTest, HeldPayloadKeepsItsArenaAcrossRecycle) {
+  auto arena = gma::TickArena::create();
+  const auto* first = arena.get();
+  ASSERT_FALSE(arena->parse(R"({"symbol":"A","v":[1,2,3]})").HasParseError());
+  auto held = arena->keep();
+
+  gma::TickArena::recycle(arena);
+  EXPECT_NE(arena.get(), first);
+  ASSERT_FALSE(arena->parse(R"({"symbol":"B"})").HasParseError());
+  arena->keep();
+  EXPECT_STREQ((*held)["symbol"].GetString(), "A");
+  EXPECT_EQ((*held)["v"].Size(), 3u);
+}
+
+TEST(TickArenaTest, KeptTicksShareTheArena) {
+  auto arena = gma::TickArena::create();
+  gma::TickEntry entry;
+  entry.price = 2.5;
+  auto held = arena->keep(entry);
+  EXPECT_EQ(arena->kept(), 1u);
+
+  gma::TickArena::recycle(arena);
+  EXPECT_DOUBLE_EQ(held->price, 2.5);
+  EXPECT_EQ(arena->kept(), 0u);
+}
+
+// ---- FeedServer ----
+
+TEST(FeedServerTest, RoutesLinesSplitAcrossWrites) {
+  FeedHarness h;
+  ASSERT_GT(h.server->port(), 0);
+
+  asio::io_context cioc;
+  tcp::socket sock(cioc);
+  tcp::resolver resolver(cioc);
+  asio::connect(sock, resolver.resolve("127.0.0.1", std::to_string(h.server->port())));
+
+  const std::string lines =
+      R"({"type":"ob","symbol":"ABC","action":"ticksize","tickSize":0.01})" "\r\n"
+      R"({"type":"ob","symbol":"ABC","action":"add","id":1,"side":"bid","price":10.5,"size":300})" "\n"
+      "not json\n"
+      R"({"symbol":"ABC","lastPrice":10.5,"note":"a\"quoted\" \\ note","levels":[1,"two",{"x":3}]})" "\n"
+      R"({"symbol":"ABC","lastPrice":10.75})" "\n";
+  // Dribble the bytes out so lines straddle reads.
+  for (std::size_t i = 0; i < lines.size(); i += 7) {
+    asio::write(sock, asio::buffer(lines.data() + i, std::min<std::size_t>(7, lines.size() - i)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  ASSERT_TRUE(waitFor([&] { return h.ticks->count() == 2; }));
+  EXPECT_EQ(h.books.getTickSize("ABC"), 0.01);
+  ASSERT_TRUE(h.books.bestBid("ABC").has_value());
+  EXPECT_DOUBLE_EQ(*h.books.bestBid("ABC"), 10.5);
+  EXPECT_EQ(h.books.bestBidSize("ABC"), 300u);
+
+  std::lock_guard<std::mutex> lk(h.ticks->mu);
+  const auto& first = *h.ticks->ticks[0].payload;
+  EXPECT_EQ(h.ticks->ticks[0].symbol, "ABC");
+  EXPECT_DOUBLE_EQ(first["lastPrice"].GetDouble(), 10.5);
+  EXPECT_STREQ(first["note"].GetString(), "a\"quoted\" \\ note");
+  ASSERT_TRUE(first["levels"].IsArray());
+  ASSERT_EQ(first["levels"].Size(), 3u);
+  EXPECT_STREQ(first["levels"][1].GetString(), "two");
+  EXPECT_EQ(first["levels"][2]["x"].GetInt(), 3);
+  EXPECT_DOUBLE_EQ((*h.ticks->ticks[1].payload)["lastPrice"].GetDouble(), 10.75);
+}
+
+TEST(FeedServerTest, DecodedTickSkipsTheDomUntilARawFieldIsListenedTo) {
+  gma::market::MarketFieldMap fm;
+  FeedHarness h(&fm);
+
+  // A computed-field listener does not read the payload, and neither does
+  // one on a field the line does not carry.
+  auto sma  = std::make_shared<CountingNode>();
+  auto vwap = std::make_shared<CountingNode>();
+  h.dispatcher->registerListener("ABC", "sma_5", sma);
+  h.dispatcher->registerListener("ABC", "vwap", vwap);
+  send(*h.server, R"({"symbol":"ABC","lastPrice":10.5,"volume":100})" "\n");
+  ASSERT_TRUE(waitFor([&] { return h.ticks->count() == 1; }));
+
+  auto last = std::make_shared<CountingNode>();
+  h.dispatcher->registerListener("ABC", "lastPrice", last);
+  send(*h.server, R"({"symbol":"ABC","lastPrice":10.75})" "\n"
+                  R"({"symbol":"XYZ","lastPrice":3})" "\n");
+  ASSERT_TRUE(waitFor([&] { return h.ticks->count() == 3; }));
+  EXPECT_EQ(last->values.load(), 1);
+
+  std::lock_guard<std::mutex> lk(h.ticks->mu);
+  const auto& ticks = h.ticks->ticks;
+  auto price = [](const gma::Event& e) {
+    return static_cast<const gma::TickEntry*>(e.decoded.get())->price;
+  };
+  ASSERT_TRUE(ticks[0].decoded);
+  EXPECT_FALSE(ticks[0].payload);
+  EXPECT_DOUBLE_EQ(price(ticks[0]), 10.5);
+  EXPECT_DOUBLE_EQ(static_cast<const gma::TickEntry*>(ticks[0].decoded.get())->volume, 100.0);
+
+  ASSERT_TRUE(ticks[1].decoded);
+  ASSERT_TRUE(ticks[1].payload);
+  EXPECT_DOUBLE_EQ(price(ticks[1]), 10.75);
+  EXPECT_DOUBLE_EQ((*ticks[1].payload)["lastPrice"].GetDouble(), 10.75);
+
+  EXPECT_EQ(ticks[2].symbol, "XYZ");
+  EXPECT_FALSE(ticks[2].payload);
+}
+
+TEST(FeedServerTest, LinesTheScanDefersStillArriveAsPayloads) {
+  gma::market::MarketFieldMap fm;
+  FeedHarness h(&fm);
+  send(*h.server, R"({"symbol":"A\u0042C","lastPrice":1})" "\n"
+                  R"({"symbol":"ABC","type":"tick","lastPrice":2})" "\n"
+                  R"({"symbol":"ABC","note":"no price"})" "\n");
+  ASSERT_TRUE(waitFor([&] { return h.ticks->count() == 3; }));
+
+  std::lock_guard<std::mutex> lk(h.ticks->mu);
+  for (const auto& t : h.ticks->ticks) {
+    EXPECT_EQ(t.symbol, "ABC");
+    EXPECT_TRUE(t.payload);
+    EXPECT_FALSE(t.decoded);
+  }
+}
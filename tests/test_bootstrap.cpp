@@ -64,6 +64,7 @@ public:
       &gma::engine::EventComputerRegistry::singleton(),
       &gma::engine::NodeTypeRegistry::singleton(),
       &gma::engine::IngressRegistry::singleton(),
+      &gma::engine::StreamRegistry::singleton(),
       &gma::engine::ConfigNamespaceRegistry::singleton(),
       &gma::AtomicProviderRegistry::singleton(),
       &gma::FunctionMap::instance(),
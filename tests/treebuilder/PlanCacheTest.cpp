@@ -0,0 +1,205 @@
+// Tests for compiled subscription plans: canonical request keys, the LRU
+// PlanCache, invalidation on registry changes, and plan reuse in
+// buildFromPlan().
+
+#include "gma/PlanCache.hpp"
+#include "gma/TreeBuilder.hpp"
+#include "gma/AtomicStore.hpp"
+#include "gma/Dispatcher.hpp"
+#include "gma/FunctionMap.hpp"
+#include "gma/NodeRegistry.hpp"
+#include "gma/engine/NodeTypeRegistry.hpp"
+#include "gma/nodes/INode.hpp"
+#include "gma/rt/ThreadPool.hpp"
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+using namespace gma;
+using tree::PlanCache;
+
+namespace {
+
+class Sink : public INode {
+public:
+    void onValue(const StreamValue&) override {}
+    void shutdown() noexcept override {}
+};
+
+// Forwards to downstream; counts how often its compiler runs.
+std::atomic<int> gCompiles{0};
+
+class PassNode : public INode {
+public:
+    explicit PassNode(std::shared_ptr<INode> down) : down_(std::move(down)) {}
+    void onValue(const StreamValue& sv) override { if (down_) down_->onValue(sv); }
+    void shutdown() noexcept override {}
+private:
+    std::shared_ptr<INode> down_;
+};
+
+void registerPassNode() {
+    engine::NodeTypeRegistry::registerNodeCompiler("PlanCacheTestPass",
+        [](const rapidjson::Value&) -> tree::NodeFactory {
+            ++gCompiles;
+            return [](const std::string&, const tree::Deps&,
+                      std::shared_ptr<INode> down) -> std::shared_ptr<INode> {
+                return std::make_shared<PassNode>(std::move(down));
+            };
+        });
+}
+
+std::string keyOf(const char* json) {
+    rapidjson::Document d;
+    d.Parse(json);
+    EXPECT_FALSE(d.HasParseError()) << json;
+    std::string key;
+    PlanCache::canonicalKey(d, key);
+    return key;
+}
+
+std::shared_ptr<const tree::RequestPlan> compile(const char* json) {
+    rapidjson::Document d;
+    d.Parse(json);
+    return tree::compileRequest(d);
+}
+
+} // namespace
+
+// ---- canonical key ----
+
+TEST(PlanCacheKeyTest, IgnoresMemberOrderAndNonPlanMembers) {
+    EXPECT_EQ(keyOf(R"({"id":"a","streamKey":"S","field":"f","node":{"type":"Worker","fn":"mean"}})"),
+              keyOf(R"({"node":{"fn":"mean","type":"Worker"},"field":"f","streamKey":"S","id":"b"})"));
+}
+
+TEST(PlanCacheKeyTest, DistinguishesValuesTypesAndPlacement) {
+    const auto base = keyOf(R"({"streamKey":"S","field":"f","node":{"type":"Interval","ms":1}})");
+    EXPECT_NE(base, keyOf(R"({"streamKey":"S","field":"f","node":{"type":"Interval","ms":1.0}})"));
+    EXPECT_NE(base, keyOf(R"({"streamKey":"S","field":"f","node":{"type":"Interval","ms":"1"}})"));
+    EXPECT_NE(base, keyOf(R"({"streamKey":"T","field":"f","node":{"type":"Interval","ms":1}})"));
+    EXPECT_NE(keyOf(R"({"streamKey":"S","field":"f","node":[]})"),
+              keyOf(R"({"streamKey":"S","field":"f","pipeline":[]})"));
+    // Length prefixes keep concatenations apart.
+    EXPECT_NE(keyOf(R"({"streamKey":"ab","field":"c"})"),
+              keyOf(R"({"streamKey":"a","field":"bc"})"));
+}
+
+// ---- cache ----
+
+TEST(PlanCacheTest, CountsHitsAndMissesAndEvictsLeastRecent) {
+    PlanCache cache(2);
+    auto plan = compile(R"({"streamKey":"S","field":"f"})");
+
+    EXPECT_EQ(cache.find("a"), nullptr);
+    cache.insert("a", plan);
+    cache.insert("b", plan);
+    EXPECT_EQ(cache.find("a"), plan);       // "b" is now least recent
+    cache.insert("c", plan);
+
+    EXPECT_EQ(cache.find("b"), nullptr);
+    EXPECT_NE(cache.find("a"), nullptr);
+    EXPECT_NE(cache.find("c"), nullptr);
+
+    auto s = cache.stats();
+    EXPECT_EQ(s.hits, 3u);
+    EXPECT_EQ(s.misses, 2u);
+    EXPECT_EQ(s.evictions, 1u);
+    EXPECT_EQ(s.size, 2u);
+}
+
+TEST(PlanCacheTest, DropsPlansWhenFunctionMapChanges) {
+    PlanCache cache;
+    cache.insert("k", compile(R"({"streamKey":"S","field":"f"})"));
+    ASSERT_NE(cache.find("k"), nullptr);
+
+    FunctionMap::instance().registerFunction("plan_cache_test_fn",
+        [](const std::vector<double>& xs) { return xs.empty() ? 0.0 : xs.front(); });
+    EXPECT_EQ(cache.find("k"), nullptr);
+    EXPECT_EQ(cache.stats().size, 0u);
+}
+
+TEST(PlanCacheTest, DropsPlansWhenNodeTypesChange) {
+    PlanCache cache;
+    cache.insert("k", compile(R"({"streamKey":"S","field":"f"})"));
+    ASSERT_NE(cache.find("k"), nullptr);
+
+    engine::NodeTypeRegistry::registerNodeType("PlanCacheTestBuilderOnly",
+        [](const rapidjson::Value&, const std::string&, const tree::Deps&,
+           std::shared_ptr<INode> down) -> std::shared_ptr<INode> { return down; });
+    EXPECT_EQ(cache.find("k"), nullptr);
+}
+
+// ---- plans ----
+
+class RequestPlanTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        registerBuiltinNodeTypes();
+        registerPassNode();
+        pool = std::make_unique<rt::ThreadPool>(1);
+        dispatcher = std::make_unique<Dispatcher>(pool.get(), &store);
+        deps.store = &store;
+        deps.pool = pool.get();
+        deps.dispatcher = dispatcher.get();
+    }
+    void TearDown() override {
+        dispatcher.reset();
+        pool->shutdown();
+    }
+
+    AtomicStore store;
+    std::unique_ptr<rt::ThreadPool> pool;
+    std::unique_ptr<Dispatcher> dispatcher;
+    tree::Deps deps;
+};
+
+TEST_F(RequestPlanTest, CompilesOnceAndBuildsIndependentChains) {
+    const int before = gCompiles.load();
+    auto plan = compile(R"({"streamKey":"S","field":"f",
+                           "pipeline":[{"type":"PlanCacheTestPass"},{"type":"PlanCacheTestPass"}]})");
+    ASSERT_NE(plan, nullptr);
+    EXPECT_EQ(gCompiles.load() - before, 2);
+    EXPECT_TRUE(plan->hasPipeline);
+    EXPECT_EQ(plan->pipeline.size(), 2u);
+
+    auto a = tree::buildFromPlan(*plan, deps, std::make_shared<Sink>());
+    auto b = tree::buildFromPlan(*plan, deps, std::make_shared<Sink>());
+    EXPECT_EQ(gCompiles.load() - before, 2);
+    ASSERT_NE(a.head, nullptr);
+    ASSERT_NE(b.head, nullptr);
+    EXPECT_NE(a.head, b.head);
+    EXPECT_EQ(a.keepAlive.size(), b.keepAlive.size());
+
+    a.head->shutdown();
+    b.head->shutdown();
+}
+
+TEST_F(RequestPlanTest, GroupSplitChildCompiledOnceAtPlanTime) {
+    const int before = gCompiles.load();
+    auto plan = compile(R"({"streamKey":"S","field":"f",
+                           "node":{"type":"GroupSplit","child":{"type":"PlanCacheTestPass"}}})");
+    EXPECT_EQ(gCompiles.load() - before, 1);
+
+    // Each new key instantiates the child from the compiled factory.
+    ASSERT_TRUE(plan->node);
+    auto split = plan->node("S", deps, std::make_shared<Sink>());
+    split->onValue({"AAPL", 1.0});
+    split->onValue({"MSFT", 2.0});
+    EXPECT_EQ(gCompiles.load() - before, 1);
+    split->shutdown();
+}
+
+TEST_F(RequestPlanTest, CompileErrorsMatchBuildForRequest) {
+    rapidjson::Document d;
+    d.Parse(R"({"streamKey":"S","field":"f","node":{"type":"NoSuchNode"}})");
+    auto sink = std::make_shared<Sink>();
+    std::string viaBuild, viaCompile;
+    try { tree::buildForRequest(d, deps, sink); } catch (const std::exception& e) { viaBuild = e.what(); }
+    try { tree::compileRequest(d); }            catch (const std::exception& e) { viaCompile = e.what(); }
+    EXPECT_FALSE(viaCompile.empty());
+    EXPECT_EQ(viaBuild, viaCompile);
+}
@@ -113,3 +113,55 @@ TEST_F(TreeBuilderTestFixture, BuildForRequestRejectsObSpread) {
 
     EXPECT_THROW(tree::buildForRequest(doc, deps, terminal), std::runtime_error);
 }
+
+// Expr compiles its expression at build time and pulls AtomicAccessor
+// inputs when the node itself is ticked.
+TEST_F(TreeBuilderTestFixture, BuildOneExprJoinsAtomicInputs) {
+    initDeps();
+    store.set("SYM", "bid", 99.0);
+    store.set("SYM", "ask", 101.0);
+    store.set("SYM", "mid", 100.0);
+
+    auto terminal = std::make_shared<TerminalStub>();
+    rapidjson::Document doc;
+    doc.Parse(R"({"type":"Expr","expr":"(ask - bid) / mid",
+                  "inputs":{"bid":{"type":"AtomicAccessor","field":"bid"},
+                            "ask":{"type":"AtomicAccessor","field":"ask"},
+                            "mid":{"type":"AtomicAccessor","field":"mid"}}})");
+    ASSERT_FALSE(doc.HasParseError());
+
+    auto node = tree::buildOne(doc, "SYM", deps, terminal);
+    ASSERT_NE(node, nullptr);
+    node->onValue(StreamValue{"SYM", 0.0});
+    ASSERT_EQ(terminal->received.size(), 1u);
+    EXPECT_EQ(terminal->received[0].symbol, "SYM");
+    EXPECT_DOUBLE_EQ(std::get<double>(terminal->received[0].value), 0.02);
+    node->shutdown();
+}
+
+TEST_F(TreeBuilderTestFixture, BuildOneExprRejectsUnknownInputName) {
+    initDeps();
+    auto terminal = std::make_shared<TerminalStub>();
+    rapidjson::Document doc;
+    doc.Parse(R"({"type":"Expr","expr":"a - b",
+                  "inputs":{"a":{"type":"AtomicAccessor","field":"bid"}}})");
+    ASSERT_FALSE(doc.HasParseError());
+
+    try {
+        (void)tree::buildOne(doc, "SYM", deps, terminal);
+        FAIL() << "buildOne should have thrown for unknown input 'b'";
+    } catch (const std::runtime_error& ex) {
+        EXPECT_NE(std::string(ex.what()).find("unknown input 'b'"), std::string::npos)
+            << ex.what();
+    }
+}
+
+TEST_F(TreeBuilderTestFixture, BuildOneExprRejectsBadJoinMode) {
+    initDeps();
+    auto terminal = std::make_shared<TerminalStub>();
+    rapidjson::Document doc;
+    doc.Parse(R"({"type":"Expr","expr":"a","join":"zip",
+                  "inputs":{"a":{"type":"AtomicAccessor","field":"bid"}}})");
+    ASSERT_FALSE(doc.HasParseError());
+    EXPECT_THROW(tree::buildOne(doc, "SYM", deps, terminal), std::runtime_error);
+}
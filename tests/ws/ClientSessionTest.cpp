@@ -9,7 +9,9 @@
 #include "gma/ExecutionContext.hpp"
 #include "gma/FunctionRegistry.hpp"
 #include "gma/NodeRegistry.hpp"
+#include "gma/engine/StreamRegistry.hpp"
 #include "gma/rt/ThreadPool.hpp"
+#include "gma/server/Admission.hpp"
 #include "gma/server/WebSocketServer.hpp"
 
 #include <boost/asio/connect.hpp>
@@ -23,6 +25,7 @@
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <thread>
 
@@ -43,11 +46,11 @@ struct ServerHarness {
   std::unique_ptr<gma::WebSocketServer>  server;
   std::thread                            ioThread;
 
-  ServerHarness() {
+  explicit ServerHarness(gma::server::AdmissionController* admission = nullptr) {
     pool       = std::make_unique<gma::rt::ThreadPool>(1);
     store      = std::make_unique<gma::AtomicStore>();
     dispatcher = std::make_unique<gma::Dispatcher>(pool.get(), store.get());
-    exec       = std::make_unique<gma::ExecutionContext>(store.get(), pool.get());
+    exec       = std::make_unique<gma::ExecutionContext>(store.get(), pool.get(), admission);
     server     = std::make_unique<gma::WebSocketServer>(ioc, exec.get(), dispatcher.get(), 0);
     server->run();
     work     = std::make_unique<asio::executor_work_guard<asio::io_context::executor_type>>(
@@ -500,3 +503,167 @@ TEST(ClientSessionTest, CancelByIdsRemovesStringKeyedSub) {
   beast::error_code ec;
   stream.close(ws::close_code::normal, ec);
 }
+
+TEST(ClientSessionTest, AdmissionRejectsOverBudgetTreeAndReleasesOnCancel) {
+  gma::registerBuiltinFunctions();
+  gma::registerBuiltinNodeTypes();
+
+  // One timer per session: the second BucketTime tree must be refused
+  // until the first is canceled.
+  gma::server::AdmissionController::Budget perSession;
+  perSession.timers = 1;
+  gma::server::AdmissionController admission({}, perSession);
+
+  {
+    ServerHarness srv(&admission);
+    asio::io_context clientIoc;
+    auto stream = connect(clientIoc, srv.port());
+
+    auto subscribe = [&](int key) {
+      std::string req =
+        std::string(R"({"type":"subscribe","requests":[{"key":)") + std::to_string(key) +
+        R"(,"streamKey":"ADM","field":"px","pipeline":[{"type":"BucketTime","ms":60000}]}]})";
+      stream.write(asio::buffer(req));
+      return readFrameBounded(stream, std::chrono::seconds(2));
+    };
+
+    auto first = subscribe(1);
+    EXPECT_NE(first.find("\"subscribed\""), std::string::npos) << first;
+    EXPECT_EQ(admission.used().timers, 1u);
+
+    auto err = expectErrorFrame(subscribe(2));
+    EXPECT_EQ(err.where, "admission");
+    EXPECT_NE(err.message.find("session timer budget"), std::string::npos) << err.message;
+
+    stream.write(asio::buffer(R"({"type":"cancel","keys":[1]})"));
+    auto canceled = readFrameBounded(stream, std::chrono::seconds(2));
+    EXPECT_NE(canceled.find("\"canceled\""), std::string::npos) << canceled;
+    EXPECT_EQ(admission.used().timers, 0u);
+
+    auto third = subscribe(3);
+    EXPECT_NE(third.find("\"subscribed\""), std::string::npos) << third;
+
+    // Closing the session gives back whatever it still held.
+    beast::error_code ec;
+    stream.close(ws::close_code::normal, ec);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (admission.sessionCount() != 0 && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(admission.used().timers, 0u);
+    EXPECT_EQ(admission.sessionCount(), 0u);   // no entry left behind
+  }
+}
+
+// Connector streams: {"stream": kind} subscriptions are acked as JSON, then
+// the stream's frames go out as binary; cancel stops the stream.
+TEST(ClientSessionTest, StreamSubscriptionSendsBinaryFrames) {
+  struct FakeStream : gma::engine::IStream {
+    gma::engine::StreamSink sink;
+    std::shared_ptr<std::atomic<bool>> stopped;
+    void start() override { sink(std::string("\x01\x00\xff", 3)); }
+    void stop() noexcept override { stopped->store(true); }
+  };
+  auto stopped = std::make_shared<std::atomic<bool>>(false);
+  auto params  = std::make_shared<gma::engine::StreamParams>();
+  gma::engine::StreamRegistry::registerStream("__test_stream__",
+    [stopped, params](const std::string& symbol, std::uint32_t,
+                      const gma::engine::StreamParams& p,
+                      gma::engine::StreamSink sink) -> std::unique_ptr<gma::engine::IStream> {
+      if (symbol != "S") throw std::runtime_error("bad symbol");
+      *params = p;
+      auto s = std::make_unique<FakeStream>();
+      s->sink = std::move(sink);
+      s->stopped = stopped;
+      return s;
+    });
+
+  {
+    ServerHarness srv;
+    asio::io_context clientIoc;
+    auto stream = connect(clientIoc, srv.port());
+
+    stream.write(asio::buffer(
+      R"({"type":"subscribe","requests":[{"key":5,"stream":"__test_stream__","streamKey":"S","levels":3}]})"));
+    auto ack = readFrameBounded(stream, std::chrono::seconds(2));
+    rapidjson::Document doc;
+    doc.Parse(ack.c_str());
+    ASSERT_TRUE(doc.IsObject()) << ack;
+    EXPECT_STREQ(doc["type"].GetString(), "subscribed");
+    EXPECT_EQ(doc["key"].GetInt(), 5);
+    EXPECT_TRUE(doc["streamId"].IsUint());
+    EXPECT_EQ((*params)["levels"], "3");
+
+    auto frame = readFrameBounded(stream, std::chrono::seconds(2));
+    EXPECT_TRUE(stream.got_binary());
+    EXPECT_EQ(frame, std::string("\x01\x00\xff", 3));
+
+    stream.write(asio::buffer(
+      R"({"type":"subscribe","requests":[{"key":6,"stream":"__nope__","streamKey":"S"}]})"));
+    EXPECT_EQ(expectErrorFrame(readFrameBounded(stream, std::chrono::seconds(2))).message,
+              "unknown stream: __nope__");
+    stream.write(asio::buffer(
+      R"({"type":"subscribe","requests":[{"key":7,"stream":"__test_stream__","streamKey":"T"}]})"));
+    auto err = expectErrorFrame(readFrameBounded(stream, std::chrono::seconds(2)));
+    EXPECT_EQ(err.where, "stream");
+    EXPECT_EQ(err.message, "bad symbol");
+
+    stream.write(asio::buffer(R"({"type":"cancel","keys":[5]})"));
+    auto canceled = readFrameBounded(stream, std::chrono::seconds(2));
+    EXPECT_NE(canceled.find("\"canceled\""), std::string::npos) << canceled;
+    EXPECT_TRUE(stopped->load());
+
+    beast::error_code ec;
+    stream.close(ws::close_code::normal, ec);
+  }
+  gma::engine::StreamRegistry::unregisterStream("__test_stream__");
+}
+
+// Streams are charged to admission control like trees and give the charge
+// back on cancel.
+TEST(ClientSessionTest, StreamSubscriptionIsChargedToAdmission) {
+  struct CostlyStream : gma::engine::IStream {
+    void start() override {}
+    void stop() noexcept override {}
+    gma::tree::TreeCost cost() const override {
+      gma::tree::TreeCost c;
+      c.stateBytes = 1u << 20;
+      return c;
+    }
+  };
+  gma::engine::StreamRegistry::registerStream("__costly_stream__",
+    [](const std::string&, std::uint32_t, const gma::engine::StreamParams&,
+       gma::engine::StreamSink) -> std::unique_ptr<gma::engine::IStream> {
+      return std::make_unique<CostlyStream>();
+    });
+
+  gma::server::AdmissionController::Budget perSession;
+  perSession.stateBytes = 1u << 20;
+  gma::server::AdmissionController admission({}, perSession);
+  {
+    ServerHarness srv(&admission);
+    asio::io_context clientIoc;
+    auto stream = connect(clientIoc, srv.port());
+    auto subscribe = [&](int key) {
+      stream.write(asio::buffer(std::string(R"({"type":"subscribe","requests":[{"key":)")
+                                + std::to_string(key)
+                                + R"(,"stream":"__costly_stream__","streamKey":"S"}]})"));
+      return readFrameBounded(stream, std::chrono::seconds(2));
+    };
+
+    auto first = subscribe(1);
+    EXPECT_NE(first.find("\"subscribed\""), std::string::npos) << first;
+    EXPECT_EQ(admission.used().stateBytes, 1u << 20);
+
+    auto err = expectErrorFrame(subscribe(2));
+    EXPECT_EQ(err.where, "admission");
+
+    stream.write(asio::buffer(R"({"type":"cancel","keys":[1]})"));
+    auto canceled = readFrameBounded(stream, std::chrono::seconds(2));
+    EXPECT_NE(canceled.find("\"canceled\""), std::string::npos) << canceled;
+    EXPECT_EQ(admission.used().stateBytes, 0u);
+
+    beast::error_code ec;
+    stream.close(ws::close_code::normal, ec);
+  }
+  gma::engine::StreamRegistry::unregisterStream("__costly_stream__");
+}